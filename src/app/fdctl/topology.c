@@ -18,6 +18,7 @@ fd_topo_initialize( config_t * config ) {
   ulong quic_tile_cnt   = config->layout.quic_tile_count;
   ulong verify_tile_cnt = config->layout.verify_tile_count;
   ulong resolv_tile_cnt = config->layout.resolv_tile_count;
+  ulong dedup_tile_cnt  = config->layout.dedup_tile_count;
   ulong bank_tile_cnt   = config->layout.bank_tile_count;
   ulong shred_tile_cnt  = config->layout.shred_tile_count;
 
@@ -70,7 +71,7 @@ fd_topo_initialize( config_t * config ) {
   /**/                 fd_topob_link( topo, "gossip_dedup", "gossip_dedup", 2048UL,                                   FD_TPU_MTU,             1UL );
   /* dedup_pack is large currently because pack can encounter stalls when running at very high throughput rates that would
      otherwise cause drops. */
-  /**/                 fd_topob_link( topo, "dedup_resolv", "dedup_resolv", 65536UL,                                  FD_TPU_PARSED_MTU,      1UL );
+  FOR(dedup_tile_cnt)  fd_topob_link( topo, "dedup_resolv", "dedup_resolv", 65536UL,                                  FD_TPU_PARSED_MTU,      1UL );
   FOR(resolv_tile_cnt) fd_topob_link( topo, "resolv_pack",  "resolv_pack",  65536UL,                                  FD_TPU_RESOLVED_MTU,    1UL );
   /**/                 fd_topob_link( topo, "stake_out",    "stake_out",    128UL,                                    40UL + 40200UL * 40UL,  1UL );
   /* pack_bank is shared across all banks, so if one bank stalls due to complex transactions, the buffer neeeds to be large so that
@@ -125,7 +126,7 @@ fd_topo_initialize( config_t * config ) {
   /*                                  topo, tile_name, tile_wksp, metrics_wksp, cpu_idx,                       is_agave, uses_keyswitch */
   FOR(quic_tile_cnt)   fd_topob_tile( topo, "quic",    "quic",    "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
   FOR(verify_tile_cnt) fd_topob_tile( topo, "verify",  "verify",  "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
-  /**/                 fd_topob_tile( topo, "dedup",   "dedup",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
+  FOR(dedup_tile_cnt)  fd_topob_tile( topo, "dedup",   "dedup",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
   FOR(resolv_tile_cnt) fd_topob_tile( topo, "resolv",  "resolv",  "metric_in",  tile_to_cpu[ topo->tile_cnt ], 1,        0 );
   /**/                 fd_topob_tile( topo, "pack",    "pack",    "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        config->tiles.bundle.enabled );
   FOR(bank_tile_cnt)   fd_topob_tile( topo, "bank",    "bank",    "metric_in",  tile_to_cpu[ topo->tile_cnt ], 1,        0 );
@@ -151,11 +152,15 @@ fd_topo_initialize( config_t * config ) {
                        fd_topob_tile_in(  topo, "verify",  i,            "metric_in", "quic_verify",  j,            FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* No reliable consumers, verify tiles may be overrun */
   FOR(verify_tile_cnt) fd_topob_tile_out( topo, "verify",  i,                         "verify_dedup", i                                                  );
   /* Declare the single gossip link before the variable length verify-dedup links so we could have a compile-time index to the gossip link. */
-  /**/                 fd_topob_tile_in(  topo, "dedup",   0UL,          "metric_in", "gossip_dedup", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
-  FOR(verify_tile_cnt) fd_topob_tile_in(  topo, "dedup",   0UL,          "metric_in", "verify_dedup", i,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
-  /**/                 fd_topob_tile_in(  topo, "dedup",   0UL,          "metric_in", "executed_txn", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
-  /**/                 fd_topob_tile_out( topo, "dedup",   0UL,                       "dedup_resolv", 0UL                                                );
-  FOR(resolv_tile_cnt) fd_topob_tile_in(  topo, "resolv",  i,            "metric_in", "dedup_resolv", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  /* Every dedup tile consumes every input, and drops the txns outside
+     its partition, see fd_dedup_tile.c. */
+  FOR(dedup_tile_cnt)  fd_topob_tile_in(  topo, "dedup",   i,            "metric_in", "gossip_dedup", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  FOR(dedup_tile_cnt)  for( ulong j=0UL; j<verify_tile_cnt; j++ )
+                       fd_topob_tile_in(  topo, "dedup",   i,            "metric_in", "verify_dedup", j,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  FOR(dedup_tile_cnt)  fd_topob_tile_in(  topo, "dedup",   i,            "metric_in", "executed_txn", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  FOR(dedup_tile_cnt)  fd_topob_tile_out( topo, "dedup",   i,                         "dedup_resolv", i                                                  );
+  FOR(resolv_tile_cnt) for( ulong j=0UL; j<dedup_tile_cnt; j++ )
+                       fd_topob_tile_in(  topo, "resolv",  i,            "metric_in", "dedup_resolv", j,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   FOR(resolv_tile_cnt) fd_topob_tile_in(  topo, "resolv",  i,            "metric_in", "replay_resol", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   FOR(resolv_tile_cnt) fd_topob_tile_out( topo, "resolv",  i,                         "resolv_pack",  i                                                  );
   /**/                 fd_topob_tile_in(  topo, "pack",    0UL,          "metric_in", "resolv_pack",  0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
@@ -385,6 +390,8 @@ fd_topo_initialize( config_t * config ) {
       tile->quic.idle_timeout_millis            = config->tiles.quic.idle_timeout_millis;
       tile->quic.ack_delay_millis               = config->tiles.quic.ack_delay_millis;
       tile->quic.retry                          = config->tiles.quic.retry;
+      tile->quic.txn_rate_per_connection        = config->tiles.quic.txn_rate_per_connection;
+      tile->quic.txn_burst_per_connection       = config->tiles.quic.txn_burst_per_connection;
 
     } else if( FD_UNLIKELY( !strcmp( tile->name, "bundle" ) ) ) {
       strncpy( tile->bundle.url, config->tiles.bundle.url, sizeof(tile->bundle.url) );
@@ -412,6 +419,10 @@ fd_topo_initialize( config_t * config ) {
       tile->pack.larger_shred_limits_per_block = config->development.bench.larger_shred_limits_per_block;
       tile->pack.use_consumed_cus              = config->tiles.pack.use_consumed_cus;
       tile->pack.schedule_strategy             = config->tiles.pack.schedule_strategy_enum;
+      tile->pack.sched_policy                  = config->tiles.pack.conflict_graph_scheduling ? FD_PACK_SCHED_POLICY_CONFLICT_GRAPH :
+                                                                                                FD_PACK_SCHED_POLICY_GREEDY;
+      tile->pack.cost_estimation               = config->tiles.pack.adaptive_cost_estimation;
+      if( FD_UNLIKELY( tile->pack.cost_estimation && !tile->pack.use_consumed_cus ) ) FD_LOG_ERR(( "[tiles.pack.adaptive_cost_estimation] learns from CU rebates, so it requires [tiles.pack.use_consumed_cus] to be true" ));
 
       if( FD_UNLIKELY( config->tiles.bundle.enabled ) ) {
 #define PARSE_PUBKEY( _tile, f ) \
@@ -428,6 +439,7 @@ fd_topo_initialize( config_t * config ) {
         fd_memset( &tile->pack.bundle, '\0', sizeof(tile->pack.bundle) );
       }
     } else if( FD_UNLIKELY( !strcmp( tile->name, "bank" ) ) ) {
+      tile->bank.cost_observations = config->tiles.pack.adaptive_cost_estimation;
 
     } else if( FD_UNLIKELY( !strcmp( tile->name, "poh" ) ) ) {
       strncpy( tile->poh.identity_key_path, config->paths.identity_key, sizeof(tile->poh.identity_key_path) );
@@ -294,6 +294,14 @@ backtest_topo( config_t * config ) {
       config->firedancer.runtime.limits.max_transactions_per_slot );
   fd_topob_tile_uses( topo, replay_tile, txncache_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   FD_TEST( fd_pod_insertf_ulong( topo->props, txncache_obj->id, "txncache" ) );
+
+  /* prog_cache_obj only by replay tile */
+  fd_topob_wksp( topo, "prog_cache"  );
+  fd_topo_obj_t * prog_cache_obj = setup_topo_prog_cache( topo, "prog_cache",
+      config->firedancer.runtime.limits.max_cached_programs,
+      config->firedancer.runtime.program_cache_size_mib );
+  fd_topob_tile_uses( topo, replay_tile, prog_cache_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, prog_cache_obj->id, "prog_cache" ) );
   for( ulong i=0UL; i<bank_tile_cnt; i++ ) {
     fd_topo_obj_t * busy_obj = fd_topob_obj( topo, "fseq", "bank_busy" );
     fd_topob_tile_uses( topo, replay_tile, busy_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
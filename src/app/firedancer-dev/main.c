@@ -22,6 +22,7 @@ extern fd_topo_obj_callbacks_t fd_obj_cb_runtime_pub;
 extern fd_topo_obj_callbacks_t fd_obj_cb_blockstore;
 extern fd_topo_obj_callbacks_t fd_obj_cb_fec_sets;
 extern fd_topo_obj_callbacks_t fd_obj_cb_txncache;
+extern fd_topo_obj_callbacks_t fd_obj_cb_prog_cache;
 extern fd_topo_obj_callbacks_t fd_obj_cb_exec_spad;
 extern fd_topo_obj_callbacks_t fd_obj_cb_banks;
 extern fd_topo_obj_callbacks_t fd_obj_cb_funk;
@@ -43,6 +44,7 @@ fd_topo_obj_callbacks_t * CALLBACKS[] = {
   &fd_obj_cb_blockstore,
   &fd_obj_cb_fec_sets,
   &fd_obj_cb_txncache,
+  &fd_obj_cb_prog_cache,
   &fd_obj_cb_exec_spad,
   &fd_obj_cb_banks,
   &fd_obj_cb_funk,
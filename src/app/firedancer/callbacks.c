@@ -5,6 +5,7 @@
 #include "../../flamenco/runtime/fd_blockstore.h"
 #include "../../flamenco/runtime/fd_runtime.h"
 #include "../../flamenco/runtime/fd_runtime_public.h"
+#include "../../flamenco/runtime/program/fd_bpf_program_cache.h"
 
 #define VAL(name) (__extension__({                                                             \
   ulong __x = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "obj.%lu.%s", obj->id, name );      \
@@ -202,6 +203,38 @@ fd_topo_obj_callbacks_t fd_obj_cb_txncache = {
   .new       = txncache_new,
 };
 
+static ulong
+prog_cache_footprint( fd_topo_t const *     topo,
+                      fd_topo_obj_t const * obj ) {
+  return fd_bpf_program_cache_footprint( VAL("entry_max") );
+}
+
+static ulong
+prog_cache_loose( fd_topo_t const *     topo,
+                  fd_topo_obj_t const * obj ) {
+  return VAL("byte_max");
+}
+
+static ulong
+prog_cache_align( fd_topo_t const *     topo FD_FN_UNUSED,
+                  fd_topo_obj_t const * obj  FD_FN_UNUSED ) {
+  return fd_bpf_program_cache_align();
+}
+
+static void
+prog_cache_new( fd_topo_t const *     topo,
+                fd_topo_obj_t const * obj ) {
+  FD_TEST( fd_bpf_program_cache_new( fd_topo_obj_laddr( topo, obj->id ), VAL("entry_max"), VAL("byte_max"), VAL("wksp_tag") ) );
+}
+
+fd_topo_obj_callbacks_t fd_obj_cb_prog_cache = {
+  .name      = "prog_cache",
+  .footprint = prog_cache_footprint,
+  .loose     = prog_cache_loose,
+  .align     = prog_cache_align,
+  .new       = prog_cache_new,
+};
+
 static ulong
 exec_spad_footprint( fd_topo_t const *     topo FD_FN_UNUSED,
                      fd_topo_obj_t const * obj  FD_FN_UNUSED ) {
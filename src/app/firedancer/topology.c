@@ -9,6 +9,7 @@
 #include "../../util/pod/fd_pod_format.h"
 #include "../../flamenco/runtime/fd_blockstore.h"
 #include "../../flamenco/runtime/fd_txncache.h"
+#include "../../funk/fd_funk.h"
 #include "../../flamenco/snapshot/fd_snapshot_base.h"
 #include "../../util/tile/fd_tile_private.h"
 #include "../../discof/restore/utils/fd_snapshot_messages.h"
@@ -62,6 +63,18 @@ setup_topo_banks( fd_topo_t *  topo,
   return obj;
 }
 
+fd_topo_obj_t *
+setup_topo_prog_cache( fd_topo_t *  topo,
+                       char const * wksp_name,
+                       ulong        max_programs,
+                       ulong        size_mib ) {
+  fd_topo_obj_t * obj = fd_topob_obj( topo, "prog_cache", wksp_name );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, max_programs,  "obj.%lu.entry_max", obj->id ) );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, size_mib<<20, "obj.%lu.byte_max",  obj->id ) );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, 13UL,         "obj.%lu.wksp_tag",  obj->id ) );
+  return obj;
+}
+
 static fd_topo_obj_t *
 setup_topo_fec_sets( fd_topo_t * topo, char const * wksp_name, ulong sz ) {
   fd_topo_obj_t * obj = fd_topob_obj( topo, "fec_sets", wksp_name );
@@ -208,6 +221,7 @@ fd_topo_initialize( config_t * config ) {
   ulong exec_tile_cnt   = config->firedancer.layout.exec_tile_count;
   ulong writer_tile_cnt = config->firedancer.layout.writer_tile_count;
   ulong resolv_tile_cnt = config->layout.resolv_tile_count;
+  ulong dedup_tile_cnt  = config->layout.dedup_tile_count;
 
   int enable_rpc = ( config->rpc.port != 0 );
 
@@ -283,6 +297,7 @@ fd_topo_initialize( config_t * config ) {
   fd_topob_wksp( topo, "blockstore"  );
   fd_topob_wksp( topo, "fec_sets"    );
   fd_topob_wksp( topo, "tcache"      );
+  fd_topob_wksp( topo, "prog_cache"  );
   fd_topob_wksp( topo, "poh"         );
   fd_topob_wksp( topo, "send"        );
   fd_topob_wksp( topo, "tower"       );
@@ -311,7 +326,7 @@ fd_topo_initialize( config_t * config ) {
   FOR(shred_tile_cnt)  fd_topob_link( topo, "shred_net",    "net_shred",    config->net.ingress_buffer_size,          FD_NET_MTU,                    1UL );
   FOR(quic_tile_cnt)   fd_topob_link( topo, "quic_verify",  "quic_verify",  config->tiles.verify.receive_buffer_size, FD_TPU_REASM_MTU,              config->tiles.quic.txn_reassembly_count );
   FOR(verify_tile_cnt) fd_topob_link( topo, "verify_dedup", "verify_dedup", config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             1UL );
-  /**/                 fd_topob_link( topo, "dedup_pack",   "dedup_pack",   config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             1UL );
+  FOR(dedup_tile_cnt)  fd_topob_link( topo, "dedup_pack",   "dedup_pack",   config->tiles.verify.receive_buffer_size, FD_TPU_PARSED_MTU,             1UL );
 
   /**/                 fd_topob_link( topo, "stake_out",    "stake_out",    128UL,                                    40UL + 40200UL * 40UL,         1UL );
 
@@ -417,7 +432,7 @@ fd_topo_initialize( config_t * config ) {
   /*                                              topo, tile_name, tile_wksp, metrics_wksp, cpu_idx,                       is_agave, uses_keyswitch */
   FOR(quic_tile_cnt)               fd_topob_tile( topo, "quic",    "quic",    "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
   FOR(verify_tile_cnt)             fd_topob_tile( topo, "verify",  "verify",  "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
-  /**/                             fd_topob_tile( topo, "dedup",   "dedup",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
+  FOR(dedup_tile_cnt)              fd_topob_tile( topo, "dedup",   "dedup",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        0 );
   FOR(resolv_tile_cnt)             fd_topob_tile( topo, "resolv",  "resolv",  "metric_in",  tile_to_cpu[ topo->tile_cnt ], 1,        0 );
   FOR(shred_tile_cnt)              fd_topob_tile( topo, "shred",   "shred",   "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        1 );
   /**/                             fd_topob_tile( topo, "sign",    "sign",    "metric_in",  tile_to_cpu[ topo->tile_cnt ], 0,        1 );
@@ -516,6 +531,13 @@ fd_topo_initialize( config_t * config ) {
   fd_topob_tile_uses( topo, replay_tile, txncache_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
   FD_TEST( fd_pod_insertf_ulong( topo->props, txncache_obj->id, "txncache" ) );
 
+  /* Create the node-wide program cache. */
+  fd_topo_obj_t * prog_cache_obj = setup_topo_prog_cache( topo, "prog_cache",
+      config->firedancer.runtime.limits.max_cached_programs,
+      config->firedancer.runtime.program_cache_size_mib );
+  fd_topob_tile_uses( topo, replay_tile, prog_cache_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
+  FD_TEST( fd_pod_insertf_ulong( topo->props, prog_cache_obj->id, "prog_cache" ) );
+
   for( ulong i=0UL; i<bank_tile_cnt; i++ ) {
     fd_topo_obj_t * busy_obj = fd_topob_obj( topo, "fseq", "bank_busy" );
     fd_topob_tile_uses( topo, replay_tile, busy_obj, FD_SHMEM_JOIN_MODE_READ_WRITE );
@@ -624,8 +646,9 @@ fd_topo_initialize( config_t * config ) {
   FOR(verify_tile_cnt) fd_topob_tile_in(  topo, "verify",  i,            "metric_in", "gossip_verif", 0UL,          FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED ); /* No reliable consumers of networking fragments, may be dropped or overrun */
   /**/                 fd_topob_tile_in(  topo, "gossip",  0UL,          "metric_in", "send_txns",    0UL,          FD_TOPOB_RELIABLE, FD_TOPOB_POLLED );
   /**/                 fd_topob_tile_in(  topo, "verify",  0UL,          "metric_in", "send_txns",    0UL,          FD_TOPOB_RELIABLE, FD_TOPOB_POLLED );
-  FOR(verify_tile_cnt) fd_topob_tile_in(  topo, "dedup",   0UL,          "metric_in", "verify_dedup", i,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
-  /**/                 fd_topob_tile_out( topo, "dedup",   0UL,                       "dedup_pack",   0UL                                                );
+  FOR(dedup_tile_cnt)  for( ulong j=0UL; j<verify_tile_cnt; j++ )
+                       fd_topob_tile_in(  topo, "dedup",   i,            "metric_in", "verify_dedup", j,            FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
+  FOR(dedup_tile_cnt)  fd_topob_tile_out( topo, "dedup",   i,                         "dedup_pack",   i                                                  );
 //  FOR(resolv_tile_cnt) fd_topob_tile_in(  topo, "resolv",  i,            "metric_in", "dedup_resolv", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
 //  FOR(resolv_tile_cnt) fd_topob_tile_in(  topo, "resolv",  i,            "metric_in", "replay_resol", 0UL,          FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED );
   FOR(resolv_tile_cnt) fd_topob_tile_out( topo, "resolv",  i,                         "resolv_pack",  i                                                  );
@@ -707,7 +730,7 @@ fd_topo_initialize( config_t * config ) {
   /**/                 fd_topob_tile_out( topo, "sign",   0UL,                      "sign_send",     0UL                                            );
   /**/                 fd_topob_tile_in ( topo, "send",   0UL,         "metric_in", "sign_send",     0UL,    FD_TOPOB_UNRELIABLE, FD_TOPOB_UNPOLLED );
 
-  /**/                 fd_topob_tile_in ( topo, "pack",   0UL,         "metric_in",  "dedup_pack",   0UL,    FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED   ); /* No reliable consumers of networking fragments, may be dropped or overrun */
+  FOR(dedup_tile_cnt)  fd_topob_tile_in ( topo, "pack",   0UL,         "metric_in",  "dedup_pack",   i,      FD_TOPOB_RELIABLE,   FD_TOPOB_POLLED   ); /* No reliable consumers of networking fragments, may be dropped or overrun */
   /**/                 fd_topob_tile_in ( topo, "pack",   0UL,         "metric_in",  "poh_pack",     0UL,    FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED   );
   /**/                 fd_topob_tile_out( topo, "pack",   0UL,                       "pack_replay",  0UL                                            );
   FOR(bank_tile_cnt)   fd_topob_tile_in ( topo, "poh",    0UL,         "metric_in",  "replay_poh",   i,      FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED   ); /* No reliable consumers of networking fragments, may be dropped or overrun */
@@ -741,6 +764,11 @@ fd_topo_initialize( config_t * config ) {
     fd_topob_link( topo, "feeder", "feeder", 65536UL, 4UL*FD_SHRED_STORE_MTU, 4UL+config->tiles.shred.max_pending_shred_sets );
     /**/ fd_topob_tile_out( topo, "replay", 0UL, "feeder", 0UL );
     /**/ fd_topob_tile_in(  topo, "arch_f", 0UL, "metric_in", "feeder", 0UL, FD_TOPOB_RELIABLE, FD_TOPOB_POLLED );
+    if( config->tiles.archiver.capture_pack ) {
+      /* Unreliable, so the capture never backpressures the resolv
+         tiles. */
+      FOR(resolv_tile_cnt) fd_topob_tile_in( topo, "arch_f", 0UL, "metric_in", "resolv_pack", i, FD_TOPOB_UNRELIABLE, FD_TOPOB_POLLED );
+    }
 
     fd_topob_wksp( topo, "arch_f2w" );
     fd_topob_link( topo, "arch_f2w", "arch_f2w", 128UL, 4UL*FD_SHRED_STORE_MTU, 1UL );
@@ -838,6 +866,27 @@ fd_topo_initialize( config_t * config ) {
   config->topo = *topo;
 }
 
+/* funk_reader_idx returns the funk reader slot (see
+   fd_funk_reader_enter) of a tile that reads funk while replay
+   publishes.  Slots are fixed by the topology: tower, rpcsrv, then the
+   writer and exec tiles by kind id.  The last slot is left for a
+   standalone rpcserver attached to the same funk. */
+
+static ulong
+funk_reader_idx( fd_config_t const *    config,
+                 fd_topo_tile_t const * tile ) {
+  ulong writer_cnt = config->firedancer.layout.writer_tile_count;
+  ulong idx;
+  if(      !strcmp( tile->name, "tower"  ) ) idx = 0UL;
+  else if( !strcmp( tile->name, "rpcsrv" ) ) idx = 1UL;
+  else if( !strcmp( tile->name, "writer" ) ) idx = 2UL + tile->kind_id;
+  else                                       idx = 2UL + writer_cnt + tile->kind_id;
+  if( FD_UNLIKELY( idx>=FD_FUNK_READER_MAX-1UL ) )
+    FD_LOG_ERR(( "too many tiles read funk (%lu writer and %lu exec tiles), at most %lu are supported",
+                 writer_cnt, (ulong)config->firedancer.layout.exec_tile_count, FD_FUNK_READER_MAX-3UL ));
+  return idx;
+}
+
 int
 fd_topo_configure_tile( fd_topo_tile_t * tile,
                         fd_config_t *    config ) {
@@ -865,6 +914,8 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
       tile->quic.idle_timeout_millis            = config->tiles.quic.idle_timeout_millis;
       tile->quic.ack_delay_millis               = config->tiles.quic.ack_delay_millis;
       tile->quic.retry                          = config->tiles.quic.retry;
+      tile->quic.txn_rate_per_connection        = config->tiles.quic.txn_rate_per_connection;
+      tile->quic.txn_burst_per_connection       = config->tiles.quic.txn_burst_per_connection;
 
     } else if( FD_UNLIKELY( !strcmp( tile->name, "verify" ) ) ) {
       tile->verify.tcache_depth = config->tiles.verify.signature_cache_size;
@@ -962,6 +1013,10 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
       tile->pack.larger_shred_limits_per_block = config->development.bench.larger_shred_limits_per_block;
       tile->pack.use_consumed_cus              = config->tiles.pack.use_consumed_cus;
       tile->pack.schedule_strategy             = config->tiles.pack.schedule_strategy_enum;
+      tile->pack.sched_policy                  = config->tiles.pack.conflict_graph_scheduling ? FD_PACK_SCHED_POLICY_CONFLICT_GRAPH :
+                                                                                                FD_PACK_SCHED_POLICY_GREEDY;
+      tile->pack.cost_estimation               = config->tiles.pack.adaptive_cost_estimation;
+      if( FD_UNLIKELY( tile->pack.cost_estimation ) ) FD_LOG_ERR(( "[tiles.pack.adaptive_cost_estimation] learns from CU rebates, which Firedancer does not support yet.  It must be false" ));
       if( FD_UNLIKELY( tile->pack.use_consumed_cus ) ) FD_LOG_ERR(( "Firedancer does not support CU rebating yet.  [tiles.pack.use_consumed_cus] must be false" ));
     } else if( FD_UNLIKELY( !strcmp( tile->name, "poh" ) ) ) {
       strncpy( tile->poh.identity_key_path, config->paths.identity_key, sizeof(tile->poh.identity_key_path) );
@@ -973,11 +1028,13 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
       strncpy( tile->send.identity_key_path, config->paths.identity_key, sizeof(tile->send.identity_key_path) );
     } else if( FD_UNLIKELY( !strcmp( tile->name, "tower" ) ) ) {
       tile->tower.funk_obj_id = fd_pod_query_ulong( config->topo.props, "funk", ULONG_MAX );
+      tile->tower.funk_reader_idx = funk_reader_idx( config, tile );
       strncpy( tile->tower.identity_key_path, config->paths.identity_key, sizeof(tile->tower.identity_key_path) );
       strncpy( tile->tower.vote_acc_path, config->paths.vote_account, sizeof(tile->tower.vote_acc_path) );
     } else if( FD_UNLIKELY( !strcmp( tile->name, "rpcsrv" ) ) ) {
       strncpy( tile->replay.blockstore_file, config->firedancer.blockstore.file, sizeof(tile->replay.blockstore_file) );
       tile->rpcserv.funk_obj_id = fd_pod_query_ulong( config->topo.props, "funk", ULONG_MAX );
+      tile->rpcserv.funk_reader_idx = funk_reader_idx( config, tile );
       tile->rpcserv.rpc_port = config->rpc.port;
       tile->rpcserv.tpu_port = config->tiles.quic.regular_transaction_listen_port;
       tile->rpcserv.tpu_ip_addr = config->net.ip_addr;
@@ -1002,14 +1059,19 @@ fd_topo_configure_tile( fd_topo_tile_t * tile,
 
     } else if( FD_UNLIKELY( !strcmp( tile->name, "exec" ) ) ) {
       tile->exec.funk_obj_id = fd_pod_query_ulong( config->topo.props, "funk", ULONG_MAX );
+      tile->exec.funk_reader_idx = funk_reader_idx( config, tile );
 
       tile->exec.capture_start_slot = config->capture.capture_start_slot;
       strncpy( tile->exec.dump_proto_dir, config->capture.dump_proto_dir, sizeof(tile->exec.dump_proto_dir) );
       tile->exec.dump_instr_to_pb = config->capture.dump_instr_to_pb;
       tile->exec.dump_txn_to_pb = config->capture.dump_txn_to_pb;
       tile->exec.dump_syscall_to_pb = config->capture.dump_syscall_to_pb;
+
+      tile->exec.jit  = config->tiles.exec.jit;
+      tile->exec.fuse = config->tiles.exec.fuse;
     } else if( FD_UNLIKELY( !strcmp( tile->name, "writer" ) ) ) {
       tile->writer.funk_obj_id = fd_pod_query_ulong( config->topo.props, "funk", ULONG_MAX );
+      tile->writer.funk_reader_idx = funk_reader_idx( config, tile );
     } else if( FD_UNLIKELY( !strcmp( tile->name, "snaprd" ) ) ) {
       setup_snapshots( config, tile );
     } else if( FD_UNLIKELY( !strcmp( tile->name, "snapdc" ) ) ) {
@@ -48,6 +48,12 @@ setup_topo_banks( fd_topo_t *  topo,
 fd_topo_obj_t *
 setup_topo_bank_hash_cmp( fd_topo_t * topo, char const * wksp_name );
 
+fd_topo_obj_t *
+setup_topo_prog_cache( fd_topo_t *  topo,
+                       char const * wksp_name,
+                       ulong        max_programs,
+                       ulong        size_mib );
+
 int
 fd_topo_configure_tile( fd_topo_tile_t * tile,
                         fd_config_t *    config );
@@ -90,6 +90,10 @@ struct fd_ledger_args {
                                                     value is the full runtime bound. If a value of 0 is passed
                                                     in, then a reduced bound will be used. */
   ulong                 runtime_mem_bound;       /* how much to allocate for a runtime-scoped spad */
+  int                   spec_exec;               /* execute the txns of a block speculatively across microblocks */
+  fd_runtime_spec_metrics_t spec_metrics;        /* speculative execution statistics */
+  int                   jit;                     /* run BPF programs under the jit */
+  fd_bpf_jit_cache_t *  jit_caches[ 128UL ];     /* jit cache of each tpool worker */
 
   fd_valloc_t           valloc; /* wksp valloc that should NOT be used for runtime allocations */
 
@@ -124,6 +128,26 @@ init_exec_spads( fd_ledger_args_t * args, int has_tpool ) {
   }
 }
 
+static void
+init_jit_caches( fd_ledger_args_t * args ) {
+
+  FD_LOG_NOTICE(( "setting up jit caches" ));
+
+  /* Worker 0 dispatches the transactions and never executes any. */
+
+  ulong entry_max = FD_BPF_JIT_CACHE_ENTRY_MAX_DEFAULT;
+  ulong text_max  = FD_BPF_JIT_CACHE_TEXT_MAX_DEFAULT;
+  args->jit_caches[ 0 ] = NULL;
+  for( ulong i=1UL; i<args->exec_spad_cnt; i++ ) {
+    void * mem = fd_wksp_alloc_laddr( args->wksp, fd_bpf_jit_cache_align(), fd_bpf_jit_cache_footprint( entry_max, text_max ), 999UL );
+    args->jit_caches[ i ] = fd_bpf_jit_cache_join( fd_bpf_jit_cache_new( mem, entry_max, text_max ) );
+    if( FD_UNLIKELY( !args->jit_caches[ i ] ) ) {
+      FD_LOG_ERR(( "failed to create jit cache" ));
+    }
+  }
+  args->slot_ctx->jit_caches = args->jit_caches;
+}
+
 /* Runtime Replay *************************************************************/
 static int
 init_tpool( fd_ledger_args_t * ledger_args ) {
@@ -168,6 +192,15 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
 
   fd_calculate_epoch_accounts_hash_values( ledger_args->slot_ctx );
 
+  if( ledger_args->spec_exec ) {
+    if( FD_UNLIKELY( ledger_args->capture_ctx ) ) FD_LOG_WARNING(( "speculative execution is disabled while capturing" ));
+    ledger_args->slot_ctx->spec_exec = &ledger_args->spec_metrics;
+  }
+
+  if( ledger_args->jit ) {
+    init_jit_caches( ledger_args );
+  }
+
   long              replay_time = -fd_log_wallclock();
   ulong             txn_cnt     = 0;
   ulong             slot_cnt    = 0;
@@ -430,6 +463,39 @@ runtime_replay( fd_ledger_args_t * ledger_args ) {
         tps,
         sec_per_slot ));
 
+  if( ledger_args->spec_exec ) {
+    fd_runtime_spec_metrics_t const * m = &ledger_args->spec_metrics;
+    FD_LOG_NOTICE((
+          "speculative execution - txns: %lu, execs: %lu, aborts: %lu (%.2f%%), waves: %lu, barriers: %lu",
+          m->txn_cnt,
+          m->exec_cnt,
+          m->abort_cnt,
+          m->exec_cnt ? 100.0*(double)m->abort_cnt/(double)m->exec_cnt : 0.0,
+          m->wave_cnt,
+          m->barrier_cnt ));
+  }
+
+  if( ledger_args->jit ) {
+    fd_bpf_jit_cache_metrics_t m = {0};
+    for( ulong i=1UL; i<ledger_args->exec_spad_cnt; i++ ) {
+      fd_bpf_jit_cache_metrics_t const * w = fd_bpf_jit_cache_metrics( ledger_args->jit_caches[ i ] );
+      m.hit_cnt          += w->hit_cnt;
+      m.interp_cnt       += w->interp_cnt;
+      m.compile_cnt      += w->compile_cnt;
+      m.compile_fail_cnt += w->compile_fail_cnt;
+      m.evict_cnt        += w->evict_cnt;
+      m.flush_cnt        += w->flush_cnt;
+    }
+    FD_LOG_NOTICE((
+          "jit - runs: %lu, interpreted: %lu, compiles: %lu, compile failures: %lu, evictions: %lu, flushes: %lu",
+          m.hit_cnt,
+          m.interp_cnt,
+          m.compile_cnt,
+          m.compile_fail_cnt,
+          m.evict_cnt,
+          m.flush_cnt ));
+  }
+
   if( slot_cnt == 0 ) {
     if( 0 != ledger_args->end_slot )
       FD_LOG_ERR(( "No slots replayed" ));
@@ -1182,6 +1248,8 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   double       allowed_mem_delta     = fd_env_strip_cmdline_double( &argc, &argv, "--allowed-mem-delta",     NULL, 0.1                                                );
   ulong        thread_mem_bound      = fd_env_strip_cmdline_ulong ( &argc, &argv, "--thread-mem-bound",      NULL, FD_RUNTIME_TRANSACTION_EXECUTION_FOOTPRINT_DEFAULT );
   ulong        runtime_mem_bound     = fd_env_strip_cmdline_ulong ( &argc, &argv, "--runtime-mem-bound",     NULL, (ulong)10e9                                        );
+  int          spec_exec             = fd_env_strip_cmdline_int   ( &argc, &argv, "--spec-exec",             NULL, 0                                                  );
+  int          jit                   = fd_env_strip_cmdline_int   ( &argc, &argv, "--jit",                   NULL, 0                                                  );
 
   if( FD_UNLIKELY( !verify_acc_hash ) ) {
     /* We've got full snapshots that contain all 0s for the account
@@ -1293,6 +1361,8 @@ initial_setup( int argc, char ** argv, fd_ledger_args_t * args ) {
   args->lthash                  = lthash;
   args->thread_mem_bound        = thread_mem_bound ? thread_mem_bound : FD_RUNTIME_BORROWED_ACCOUNT_FOOTPRINT;
   args->runtime_mem_bound       = runtime_mem_bound;
+  args->spec_exec               = spec_exec;
+  args->jit                     = jit;
   parse_one_off_features( args, one_off_features );
   parse_rocksdb_list( args, rocksdb_list, rocksdb_list_starts );
 
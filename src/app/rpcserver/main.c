@@ -41,6 +41,9 @@ init_args( int * argc, char *** argv, fd_rpcserver_args_t * args ) {
   fd_funk_t * funk = fd_funk_join( args->funk, funk_shmem );
   if( FD_UNLIKELY( !funk ))
     FD_LOG_ERR(( "failed to join funk" ));
+  /* The validator's tiles use the lower reader slots (see
+     funk_reader_idx in topology.c), the last one is left for us */
+  args->funk_reader_idx = fd_env_strip_cmdline_ulong( argc, argv, "--funk-reader-idx", NULL, FD_FUNK_READER_MAX-1UL );
 
   args->blockstore_fd = -1;
 
@@ -115,6 +118,9 @@ init_args_offline( int * argc, char *** argv, fd_rpcserver_args_t * args ) {
   fd_funk_t * funk = fd_funk_join( args->funk, funk_shmem );
   if( FD_UNLIKELY( !funk ))
     FD_LOG_ERR(( "failed to join funk" ));
+  /* The validator's tiles use the lower reader slots (see
+     funk_reader_idx in topology.c), the last one is left for us */
+  args->funk_reader_idx = fd_env_strip_cmdline_ulong( argc, argv, "--funk-reader-idx", NULL, FD_FUNK_READER_MAX-1UL );
 
   fd_wksp_t * wksp;
   const char * wksp_name = fd_env_strip_cmdline_cstr ( argc, argv, "--wksp-name-blockstore", NULL, NULL );
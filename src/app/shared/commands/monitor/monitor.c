@@ -465,12 +465,16 @@ run_monitor( config_t const * config,
         verify_sent += fd_mcache_seq_query( fd_mcache_seq_laddr( topo->links[ verify->out_link_id[ 0 ] ].mcache ) );
       }
 
-      fd_topo_tile_t const * dedup = &topo->tiles[ fd_topo_find_tile( topo, "dedup", 0UL ) ];
+      /* Dedup tiles filter the txns of other dedup tiles' partitions,
+         so count duplicates from the tile metrics rather than the
+         filtered frags. */
       ulong dedup_failed = 0UL;
-      for( ulong i=0UL; i<config->layout.verify_tile_count; i++) {
-        dedup_failed += fd_metrics_link_in( dedup->metrics, i )[ FD_METRICS_COUNTER_LINK_FILTERED_COUNT_OFF ];
+      ulong dedup_sent   = 0UL;
+      for( ulong i=0UL; i<config->layout.dedup_tile_count; i++ ) {
+        fd_topo_tile_t const * dedup = &topo->tiles[ fd_topo_find_tile( topo, "dedup", i ) ];
+        dedup_failed += fd_metrics_tile( dedup->metrics )[ FD_METRICS_COUNTER_DEDUP_TRANSACTION_DEDUP_FAILURE_OFF ];
+        dedup_sent   += fd_mcache_seq_query( fd_mcache_seq_laddr( topo->links[ dedup->out_link_id[ 0 ] ].mcache ) );
       }
-      ulong dedup_sent = fd_mcache_seq_query( fd_mcache_seq_laddr( topo->links[ dedup->out_link_id[ 0 ] ].mcache ) );
 
       fd_topo_tile_t const * pack = &topo->tiles[ fd_topo_find_tile( topo, "pack", 0UL ) ];
       volatile ulong * pack_metrics = fd_metrics_tile( pack->metrics );
@@ -113,7 +113,10 @@ struct fd_configf {
       ulong snapshot_grace_period_seconds;
       ulong max_vote_accounts;
       ulong max_banks;
+      ulong max_cached_programs;
     } limits;
+
+    ulong program_cache_size_mib;
   } runtime;
 
   struct {
@@ -163,6 +166,8 @@ struct fd_config_net {
   struct {
     uint receive_buffer_size;
     uint send_buffer_size;
+    int  udp_gro;
+    int  udp_gso;
   } socket;
 };
 typedef struct fd_config_net fd_config_net_t;
@@ -246,6 +251,7 @@ struct fd_config {
     uint quic_tile_count;
     uint resolv_tile_count;
     uint verify_tile_count;
+    uint dedup_tile_count;
     uint bank_tile_count;
     uint shred_tile_count;
   } layout;
@@ -334,6 +340,8 @@ struct fd_config {
       uint idle_timeout_millis;
       uint ack_delay_millis;
       int  retry;
+      uint txn_rate_per_connection;
+      uint txn_burst_per_connection;
     } quic;
 
     struct {
@@ -367,6 +375,8 @@ struct fd_config {
       int  use_consumed_cus;
       char schedule_strategy[ 16 ];
       int  schedule_strategy_enum;
+      int  conflict_graph_scheduling;
+      int  adaptive_cost_estimation;
     } pack;
 
     struct {
@@ -412,6 +422,11 @@ struct fd_config {
       char  enable_features[ 16 ][ FD_BASE58_ENCODED_32_SZ ];
     } replay;
 
+    struct {
+      int   jit;
+      int   fuse;
+    } exec;
+
     struct {
       char  slots_pending[PATH_MAX];
       char  shred_cap_archive[ PATH_MAX ];
@@ -423,6 +438,7 @@ struct fd_config {
       int   enabled;
       ulong end_slot;
       char  archiver_path[ PATH_MAX ];
+      int   capture_pack;
     } archiver;
 
     struct {
@@ -96,6 +96,8 @@ fd_config_extract_podf( uchar *        pod,
   CFG_POP      ( ulong,  runtime.limits.snapshot_grace_period_seconds     );
   CFG_POP      ( ulong,  runtime.limits.max_vote_accounts                 );
   CFG_POP      ( ulong,  runtime.limits.max_banks                         );
+  CFG_POP      ( ulong,  runtime.limits.max_cached_programs               );
+  CFG_POP      ( ulong,  runtime.program_cache_size_mib                   );
 
   CFG_POP      ( ulong,  funk.max_account_records                         );
   CFG_POP      ( ulong,  funk.heap_size_gib                               );
@@ -156,6 +158,7 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( uint,   layout.quic_tile_count                           );
   CFG_POP      ( uint,   layout.resolv_tile_count                         );
   CFG_POP      ( uint,   layout.verify_tile_count                         );
+  CFG_POP      ( uint,   layout.dedup_tile_count                          );
   CFG_POP      ( uint,   layout.bank_tile_count                           );
   CFG_POP      ( uint,   layout.shred_tile_count                          );
 
@@ -174,6 +177,8 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( uint,   net.xdp.flush_timeout_micros                     );
   CFG_POP      ( uint,   net.socket.receive_buffer_size                   );
   CFG_POP      ( uint,   net.socket.send_buffer_size                      );
+  CFG_POP      ( bool,   net.socket.udp_gro                               );
+  CFG_POP      ( bool,   net.socket.udp_gso                               );
 
   CFG_POP      ( ulong,  tiles.netlink.max_routes                         );
   CFG_POP      ( ulong,  tiles.netlink.max_neighbors                      );
@@ -186,6 +191,8 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( uint,   tiles.quic.idle_timeout_millis                   );
   CFG_POP      ( uint,   tiles.quic.ack_delay_millis                      );
   CFG_POP      ( bool,   tiles.quic.retry                                 );
+  CFG_POP      ( uint,   tiles.quic.txn_rate_per_connection               );
+  CFG_POP      ( uint,   tiles.quic.txn_burst_per_connection              );
 
   CFG_POP      ( uint,   tiles.verify.signature_cache_size                );
   CFG_POP      ( uint,   tiles.verify.receive_buffer_size                 );
@@ -206,6 +213,8 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( uint,   tiles.pack.max_pending_transactions              );
   CFG_POP      ( bool,   tiles.pack.use_consumed_cus                      );
   CFG_POP      ( cstr,   tiles.pack.schedule_strategy                     );
+  CFG_POP      ( bool,   tiles.pack.conflict_graph_scheduling             );
+  CFG_POP      ( bool,   tiles.pack.adaptive_cost_estimation              );
 
   CFG_POP      ( bool,   tiles.poh.lagged_consecutive_leader_start        );
 
@@ -245,6 +254,9 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( cstr,   tiles.replay.tower_checkpt                       );
   CFG_POP_ARRAY( cstr,   tiles.replay.enable_features                     );
 
+  CFG_POP      ( bool,   tiles.exec.jit                                   );
+  CFG_POP      ( bool,   tiles.exec.fuse                                  );
+
   CFG_POP      ( cstr,   tiles.store_int.slots_pending                    );
   CFG_POP      ( cstr,   tiles.store_int.shred_cap_archive                );
   CFG_POP      ( cstr,   tiles.store_int.shred_cap_replay                 );
@@ -255,6 +267,7 @@ fd_config_extract_pod( uchar *       pod,
   CFG_POP      ( bool,   tiles.archiver.enabled                           );
   CFG_POP      ( ulong,  tiles.archiver.end_slot                          );
   CFG_POP      ( cstr,   tiles.archiver.archiver_path                     );
+  CFG_POP      ( bool,   tiles.archiver.capture_pack                      );
 
   if( FD_UNLIKELY( config->is_firedancer ) ) {
     CFG_POP      ( bool,    tiles.shredcap.enabled                           );
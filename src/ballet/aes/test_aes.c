@@ -509,6 +509,40 @@ test_aes_128_gcm_unroll( void ) {
   }
 }
 
+/* test_aes_128_gcm_set_iv checks that re-keying the IV of an existing
+   AES-GCM state gives the same result as a fresh init with that IV. */
+
+static void
+test_aes_128_gcm_set_iv( fd_rng_t * rng ) {
+  uchar key[ 16 ]; for( ulong j=0UL; j<16UL; j++ ) key[ j ] = fd_rng_uchar( rng );
+  uchar aad[ 20 ]; for( ulong j=0UL; j<20UL; j++ ) aad[ j ] = fd_rng_uchar( rng );
+
+  fd_aes_gcm_t gcm_cached[1];
+  fd_aes_gcm_t gcm_fresh [1];
+  uchar iv0[ 12 ] = {0};
+  fd_aes_128_gcm_init( gcm_cached, key, iv0 );
+
+  uchar p[ 1500 ];  uchar c0[ 1500 ];  uchar c1[ 1500 ];  uchar d[ 1500 ];
+  for( ulong j=0UL; j<sizeof(p); j++ ) p[ j ] = fd_rng_uchar( rng );
+
+  for( ulong iter=0UL; iter<256UL; iter++ ) {
+    uchar iv[ 12 ]; for( ulong j=0UL; j<12UL; j++ ) iv[ j ] = fd_rng_uchar( rng );
+    ulong sz = fd_rng_ulong_roll( rng, sizeof(p)+1UL );
+
+    uchar tag0[ 16 ];  uchar tag1[ 16 ];
+    fd_aes_128_gcm_init( gcm_fresh, key, iv );
+    fd_aes_gcm_encrypt( gcm_fresh, c0, p, sz, aad, sizeof(aad), tag0 );
+    fd_aes_gcm_set_iv( gcm_cached, iv );
+    fd_aes_gcm_encrypt( gcm_cached, c1, p, sz, aad, sizeof(aad), tag1 );
+    FD_TEST( 0==memcmp( c0,   c1,   sz  ) );
+    FD_TEST( 0==memcmp( tag0, tag1, 16UL ) );
+
+    fd_aes_gcm_set_iv( gcm_cached, iv );
+    FD_TEST( fd_aes_gcm_decrypt( gcm_cached, c1, d, sz, aad, sizeof(aad), tag1 ) );
+    FD_TEST( 0==memcmp( d, p, sz ) );
+  }
+}
+
 /* Main ***************************************************************/
 
 int
@@ -540,6 +574,7 @@ main( int     argc,
   test_aes_128_gcm_bounds( rng );
   test_aes_128_gcm();
   test_aes_128_gcm_unroll();
+  test_aes_128_gcm_set_iv( rng );
 
   fd_rng_delete( fd_rng_leave( rng ) );
   FD_LOG_NOTICE(( "pass" ));
@@ -318,6 +318,148 @@ fd_bmtree_commit_fini( fd_bmtree_commit_t * state ) {
   return root->hash;
 }
 
+/* fd_bmtree_private_batch_t stages up to FD_SHA256_BATCH_MAX branch
+   node merges so they can be computed with the multi-lane SHA-256
+   kernels.  Since a branch node hash covers only prefix|a|b, each
+   message is assembled into its own slot of msg (the SHA-256 batch API
+   requires the message to stay valid until the batch is finished).
+   If a merge has an expected value, the result is written to chk and
+   compared against it on flush instead of being stored. */
+
+struct fd_bmtree_private_batch {
+  uchar                    msg[ FD_SHA256_BATCH_MAX ][ 96UL ] __attribute__((aligned(32)));
+  fd_bmtree_node_t         chk[ FD_SHA256_BATCH_MAX ];
+  fd_bmtree_node_t const * exp[ FD_SHA256_BATCH_MAX ];
+  ulong                    exp_sz;
+  ulong                    cnt;
+  fd_sha256_batch_t *      sha;
+  uchar                    sha_mem[ FD_SHA256_BATCH_FOOTPRINT ] __attribute__((aligned(FD_SHA256_BATCH_ALIGN)));
+};
+
+typedef struct fd_bmtree_private_batch fd_bmtree_private_batch_t;
+
+static inline fd_bmtree_private_batch_t *
+fd_bmtree_private_batch_init( fd_bmtree_private_batch_t * batch ) {
+  batch->cnt = 0UL;
+  batch->sha = fd_sha256_batch_init( batch->sha_mem );
+  return batch;
+}
+
+/* fd_bmtree_private_batch_flush finishes all the staged merges.
+   Returns 1 if all merges with an expected value matched it in the
+   first hash_sz bytes and 0 otherwise. */
+
+static int
+fd_bmtree_private_batch_flush( fd_bmtree_private_batch_t * batch ) {
+  ulong cnt = batch->cnt;
+  if( FD_UNLIKELY( !cnt ) ) return 1;
+
+  fd_sha256_batch_fini( batch->sha );
+  int ok = 1;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    if( FD_UNLIKELY( batch->exp[ i ] ) ) ok &= fd_memeq( batch->chk[ i ].hash, batch->exp[ i ]->hash, batch->exp_sz );
+  }
+  fd_bmtree_private_batch_init( batch );
+  return ok;
+}
+
+/* fd_bmtree_private_batch_add stages the merge of a and b.  The result
+   is stored in node if exp is NULL and compared to exp otherwise.
+   Flushes the batch if it becomes full and returns the result of the
+   flush (1 if it was not flushed). */
+
+static inline int
+fd_bmtree_private_batch_add( fd_bmtree_private_batch_t * batch,
+                             fd_bmtree_node_t *          node,
+                             fd_bmtree_node_t const *    exp,
+                             fd_bmtree_node_t const *    a,
+                             fd_bmtree_node_t const *    b,
+                             ulong                       hash_sz,
+                             ulong                       prefix_sz ) {
+  ulong   cnt = batch->cnt;
+  uchar * msg = batch->msg[ cnt ];
+
+  /* Same layout as fd_bmtree_private_merge.  The copies deliberately
+     overrun into the next field, which is overwritten or ignored. */
+  fd_memcpy( msg,                   fd_bmtree_node_prefix, 32UL );
+  fd_memcpy( msg+prefix_sz,         a->hash,               32UL );
+  fd_memcpy( msg+prefix_sz+hash_sz, b->hash,               32UL );
+
+  batch->exp[ cnt ] = exp;
+  batch->exp_sz     = hash_sz;
+  node = fd_ptr_if( !!exp, batch->chk+cnt, node );
+  fd_sha256_batch_add( batch->sha, msg, prefix_sz+2UL*hash_sz, node->hash );
+
+  batch->cnt = ++cnt;
+  if( FD_UNLIKELY( cnt==FD_SHA256_BATCH_MAX ) ) return fd_bmtree_private_batch_flush( batch );
+  return 1;
+}
+
+/* fd_bmtree_private_layer_idx returns the index in inclusion_proofs of
+   the idx-th node (counting from the left) of the given layer. */
+
+FD_FN_CONST static inline ulong
+fd_bmtree_private_layer_idx( ulong layer,
+                             ulong idx ) {
+  return (idx<<(layer+1UL)) + (1UL<<layer) - 1UL;
+}
+
+void
+fd_bmtree_commit_batch( fd_bmtree_commit_t *     const * state,
+                        fd_bmtree_node_t const * const * leaf,
+                        ulong const *                    leaf_cnt,
+                        uchar **                         root,
+                        ulong                            tree_cnt ) {
+
+  /* Populate the leaf layer of every tree that fits in its inclusion
+     proof storage.  The rest use the incremental path. */
+  ulong layer_cnt = 0UL;
+  for( ulong t=0UL; t<tree_cnt; t++ ) {
+    fd_bmtree_commit_t * tree = state[ t ];
+    ulong                cnt  = leaf_cnt[ t ];
+    if( FD_UNLIKELY( 2UL*fd_ulong_pow2_up( cnt )-1UL > tree->inclusion_proof_sz ) ) {
+      root[ t ] = fd_bmtree_commit_fini( fd_bmtree_commit_append( tree, leaf[ t ], cnt ) );
+      continue;
+    }
+    for( ulong i=0UL; i<cnt; i++ ) tree->inclusion_proofs[ 2UL*i ] = leaf[ t ][ i ];
+    tree->leaf_cnt = cnt;
+    layer_cnt = fd_ulong_max( layer_cnt, fd_bmtree_depth( cnt ) );
+  }
+
+  /* Derive the trees one layer at a time, so that every merge in a
+     layer (across all trees) can go through the same batch. */
+  fd_bmtree_private_batch_t batch[1];
+  fd_bmtree_private_batch_init( batch );
+
+  for( ulong layer=0UL; layer+1UL<layer_cnt; layer++ ) {
+    for( ulong t=0UL; t<tree_cnt; t++ ) {
+      fd_bmtree_commit_t * tree = state[ t ];
+      ulong                cnt  = leaf_cnt[ t ];
+      if( FD_UNLIKELY( 2UL*fd_ulong_pow2_up( cnt )-1UL > tree->inclusion_proof_sz ) ) continue;
+
+      ulong node_cnt = ((cnt-1UL)>>layer) + 1UL; /* nodes in this layer */
+      if( node_cnt<=1UL ) continue;
+
+      fd_bmtree_node_t * nodes = tree->inclusion_proofs;
+      for( ulong i=0UL; i<node_cnt; i+=2UL ) {
+        /* A node without a right sibling is merged with itself */
+        ulong l_idx = fd_bmtree_private_layer_idx( layer,     i                                   );
+        ulong r_idx = fd_bmtree_private_layer_idx( layer,     fd_ulong_min( i+1UL, node_cnt-1UL ) );
+        ulong p_idx = fd_bmtree_private_layer_idx( layer+1UL, i>>1                                );
+        fd_bmtree_private_batch_add( batch, nodes+p_idx, NULL, nodes+l_idx, nodes+r_idx, tree->hash_sz, tree->prefix_sz );
+      }
+    }
+    fd_bmtree_private_batch_flush( batch );
+  }
+
+  for( ulong t=0UL; t<tree_cnt; t++ ) {
+    fd_bmtree_commit_t * tree = state[ t ];
+    ulong                cnt  = leaf_cnt[ t ];
+    if( FD_UNLIKELY( 2UL*fd_ulong_pow2_up( cnt )-1UL > tree->inclusion_proof_sz ) ) continue;
+    root[ t ] = tree->inclusion_proofs[ fd_ulong_pow2_up( cnt )-1UL ].hash;
+  }
+}
+
 int
 fd_bmtree_get_proof( fd_bmtree_commit_t * state,
                      uchar *              dest,
@@ -549,3 +691,70 @@ fd_bmtree_commitp_fini( fd_bmtree_commit_t * state, ulong leaf_cnt ) {
   state->leaf_cnt = leaf_cnt;
   return state->inclusion_proofs[root_idx].hash;
 }
+
+uchar *
+fd_bmtree_commitp_fini_with_leaves( fd_bmtree_commit_t *     state,
+                                    ulong                    leaf_cnt,
+                                    fd_bmtree_node_t const * new_leaf,
+                                    ulong const *            new_leaf_idx,
+                                    ulong                    new_leaf_cnt ) {
+  ulong hash_sz   = state->hash_sz;
+  ulong prefix_sz = state->prefix_sz;
+  fd_bmtree_node_t * nodes = state->inclusion_proofs;
+
+  if( FD_UNLIKELY( leaf_cnt==0UL ) ) return NULL;
+  ulong root_idx = fd_ulong_pow2_up( leaf_cnt ) - 1UL;
+  if( FD_UNLIKELY( 2UL*root_idx+1UL > state->inclusion_proof_sz ) ) return NULL;
+
+  /* The valid bits are not updated until the whole tree checks out, so
+     below HAS(x) means x was known before this call.  Known nodes are
+     consistent with each other, so a branch node only needs to be
+     (re)computed if it or one of its children is not known.  If it is
+     known, the computed value is checked against it. */
+
+  ulong j = 0UL;
+  for( ulong i=0UL; i<leaf_cnt; i++ ) {
+    int provided = (j<new_leaf_cnt) && (new_leaf_idx[ j ]==i);
+    if( FD_UNLIKELY( !provided & !HAS( 2UL*i ) ) ) return NULL;
+    if( !provided ) continue;
+    if( HAS( 2UL*i ) ) {
+      if( FD_UNLIKELY( !fd_memeq( nodes[ 2UL*i ].hash, new_leaf[ j ].hash, hash_sz ) ) ) return NULL;
+    } else {
+      nodes[ 2UL*i ] = new_leaf[ j ];
+    }
+    j++;
+  }
+  /* Out of range or not strictly increasing indices */
+  if( FD_UNLIKELY( j!=new_leaf_cnt ) ) return NULL;
+
+  fd_bmtree_private_batch_t batch[1];
+  fd_bmtree_private_batch_init( batch );
+
+  ulong layer_cnt = fd_bmtree_depth( leaf_cnt );
+  for( ulong layer=0UL; layer+1UL<layer_cnt; layer++ ) {
+    ulong node_cnt = ((leaf_cnt-1UL)>>layer) + 1UL;
+    int   ok       = 1;
+    for( ulong i=0UL; i<node_cnt; i+=2UL ) {
+      ulong l_idx = fd_bmtree_private_layer_idx( layer,     i                                   );
+      ulong r_idx = fd_bmtree_private_layer_idx( layer,     fd_ulong_min( i+1UL, node_cnt-1UL ) );
+      ulong p_idx = fd_bmtree_private_layer_idx( layer+1UL, i>>1                                );
+      if( HAS( p_idx ) & HAS( l_idx ) & HAS( r_idx ) ) continue;
+      ok &= fd_bmtree_private_batch_add( batch, nodes+p_idx, fd_ptr_if( HAS( p_idx ), nodes+p_idx, NULL ),
+                                         nodes+l_idx, nodes+r_idx, hash_sz, prefix_sz );
+    }
+    ok &= fd_bmtree_private_batch_flush( batch );
+    if( FD_UNLIKELY( !ok ) ) return NULL;
+  }
+
+  /* Every node of the tree is now known */
+  for( ulong layer=0UL; layer<layer_cnt; layer++ ) {
+    ulong node_cnt = ((leaf_cnt-1UL)>>layer) + 1UL;
+    for( ulong i=0UL; i<node_cnt; i++ ) {
+      ulong inc_idx = fd_bmtree_private_layer_idx( layer, i );
+      state->inclusion_proofs_valid[ inc_idx/64UL ] |= ipfset_ele( inc_idx%64UL );
+    }
+  }
+
+  state->leaf_cnt = leaf_cnt;
+  return nodes[ root_idx ].hash;
+}
@@ -360,6 +360,30 @@ fd_bmtree_commit_append( fd_bmtree_commit_t *                 state,         /*
    initialized for a new calc. */
 uchar * fd_bmtree_commit_fini( fd_bmtree_commit_t * state );
 
+/* fd_bmtree_commit_batch computes the commitments of tree_cnt
+   independent trees at once.  For each t in [0,tree_cnt), it is
+   equivalent to
+
+     fd_bmtree_commit_append( state[t], leaf[t], leaf_cnt[t] );
+     root[t] = fd_bmtree_commit_fini( state[t] );
+
+   Each state[t] must be a valid leaf-based calc with no leaves appended
+   yet and leaf_cnt[t] must be positive.  Instead of merging one pair of
+   nodes at a time as leaves arrive, the trees are derived one layer at
+   a time, and all the branch nodes of a layer (across all the trees)
+   are hashed with the multi-lane SHA-256 batch API.  This requires the
+   whole tree to fit in the inclusion proof storage, i.e.
+   fd_bmtree_depth( leaf_cnt[t] ) <= inclusion_proof_layer_cnt; trees
+   for which that is not the case are computed with the incremental
+   method instead.  On return, all inclusion proofs are available as
+   with fd_bmtree_commit_fini. */
+void
+fd_bmtree_commit_batch( fd_bmtree_commit_t *     const * state,
+                        fd_bmtree_node_t const * const * leaf,
+                        ulong const *                    leaf_cnt,
+                        uchar **                         root,
+                        ulong                            tree_cnt );
+
 
 /* bmtree_get_proof writes an inclusion proof for the leaf
    with index leaf_idx to the memory at dest.  state must be a valid
@@ -464,5 +488,26 @@ fd_bmtree_commitp_insert_with_proof( fd_bmtree_commit_t *     state,
    otherwise. */
 uchar * fd_bmtree_commitp_fini( fd_bmtree_commit_t * state, ulong leaf_cnt );
 
+/* fd_bmtree_commitp_fini_with_leaves inserts new_leaf_cnt leaves (leaf
+   new_leaf[j] at index new_leaf_idx[j], without proofs) into a
+   proof-based calc and then finalizes it like fd_bmtree_commitp_fini.
+   new_leaf_idx must be strictly increasing.  Together with the leaves
+   already in the calc, the new leaves must cover all leaf_cnt leaves,
+   and fd_bmtree_depth( leaf_cnt ) must be <= inclusion_proof_layer_cnt.
+   Returns the root of the tree if every leaf and cached node is
+   consistent with it and NULL otherwise.
+
+   This is much cheaper than inserting the leaves one at a time when
+   many leaves are new (e.g. after erasure recovery), because every
+   branch node that is not already known is derived layer by layer with
+   the multi-lane SHA-256 batch API.  On failure, no node is marked
+   known, so the calc is left as it was before the call. */
+uchar *
+fd_bmtree_commitp_fini_with_leaves( fd_bmtree_commit_t *     state,
+                                    ulong                    leaf_cnt,
+                                    fd_bmtree_node_t const * new_leaf,
+                                    ulong const *            new_leaf_idx,
+                                    ulong                    new_leaf_cnt );
+
 FD_PROTOTYPES_END
 #endif /* HEADER_fd_src_ballet_bmtree_fd_bmtree_h */
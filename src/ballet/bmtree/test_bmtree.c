@@ -130,6 +130,147 @@ test_inclusion( ulong leaf_cnt ) {
 }
 
 
+/* Test batched construction against the incremental one */
+static void
+test_commit_batch( void ) {
+  ulong const tree_cnt = 6UL;
+  ulong const layer_cnt = 9UL;
+  ulong footprint = fd_bmtree_commit_footprint( layer_cnt );
+  FD_TEST( 2UL*tree_cnt*footprint + 512UL*sizeof(fd_bmtree_node_t)*tree_cnt < MEMORY_SZ );
+
+  fd_bmtree_commit_t *     ref  [ 6 ];
+  fd_bmtree_commit_t *     state[ 6 ];
+  fd_bmtree_node_t const * leaf [ 6 ];
+  ulong                    cnt  [ 6 ];
+  uchar *                  root [ 6 ];
+
+  fd_bmtree_node_t * leaves = (fd_bmtree_node_t *)(memory + 2UL*tree_cnt*footprint);
+  for( ulong i=0UL; i<512UL*tree_cnt; i++ ) {
+    fd_memset( leaves[ i ].hash, 0, 32UL );
+    FD_STORE( ulong, leaves[ i ].hash, i );
+  }
+
+  for( ulong iter=0UL; iter<300UL; iter++ ) {
+    ulong hash_sz   = fd_ulong_if( iter&1UL, 20UL, 32UL );
+    ulong prefix_sz = fd_ulong_if( iter&2UL, FD_BMTREE_LONG_PREFIX_SZ, FD_BMTREE_SHORT_PREFIX_SZ );
+    for( ulong t=0UL; t<tree_cnt; t++ ) {
+      /* Includes some trees that are too deep for the inclusion proof
+         storage (leaf_cnt>256), which take the incremental path. */
+      cnt  [ t ] = 1UL + ((iter*37UL + t*101UL) % 300UL);
+      leaf [ t ] = leaves + 512UL*t;
+      ref  [ t ] = fd_bmtree_commit_init( memory + (2UL*t    )*footprint, hash_sz, prefix_sz, layer_cnt );
+      state[ t ] = fd_bmtree_commit_init( memory + (2UL*t+1UL)*footprint, hash_sz, prefix_sz, layer_cnt );
+    }
+
+    fd_bmtree_commit_batch( state, leaf, cnt, root, tree_cnt );
+
+    for( ulong t=0UL; t<tree_cnt; t++ ) {
+      uchar * ref_root = fd_bmtree_commit_fini( fd_bmtree_commit_append( ref[ t ], leaf[ t ], cnt[ t ] ) );
+      FD_TEST( fd_bmtree_commit_leaf_cnt( state[ t ] )==cnt[ t ] );
+      FD_TEST( fd_memeq( root[ t ], ref_root, hash_sz ) );
+      if( cnt[ t ]>256UL ) continue;
+
+      ulong depth = fd_bmtree_depth( cnt[ t ] );
+      for( ulong i=0UL; i<cnt[ t ]; i++ ) {
+        uchar proof[ 9*32 ];
+        FD_TEST( (int)depth-1==fd_bmtree_get_proof( ref  [ t ], inc_proof, i ) );
+        FD_TEST( (int)depth-1==fd_bmtree_get_proof( state[ t ], proof,     i ) );
+        FD_TEST( fd_memeq( proof, inc_proof, (depth-1UL)*hash_sz ) );
+      }
+    }
+  }
+
+  /* Compare the cost of 4 trees of 64 leaves each (a 32:32 FEC set) */
+  ulong bench_cnt = 10000UL;
+  for( ulong t=0UL; t<4UL; t++ ) cnt[ t ] = 64UL;
+
+  long dt_ref = -fd_log_wallclock();
+  for( ulong rem=bench_cnt; rem; rem-- ) {
+    for( ulong t=0UL; t<4UL; t++ ) {
+      ref[ t ] = fd_bmtree_commit_init( memory + 2UL*t*footprint, 20UL, FD_BMTREE_LONG_PREFIX_SZ, 7UL );
+      root[ t ] = fd_bmtree_commit_fini( fd_bmtree_commit_append( ref[ t ], leaf[ t ], 64UL ) );
+    }
+    FD_COMPILER_FORGET( root[ 0 ] );
+  }
+  dt_ref += fd_log_wallclock();
+
+  long dt_batch = -fd_log_wallclock();
+  for( ulong rem=bench_cnt; rem; rem-- ) {
+    for( ulong t=0UL; t<4UL; t++ ) state[ t ] = fd_bmtree_commit_init( memory + (2UL*t+1UL)*footprint, 20UL, FD_BMTREE_LONG_PREFIX_SZ, 7UL );
+    fd_bmtree_commit_batch( state, leaf, cnt, root, 4UL );
+    FD_COMPILER_FORGET( root[ 0 ] );
+  }
+  dt_batch += fd_log_wallclock();
+
+  FD_LOG_NOTICE(( "4x64 leaf trees: incremental %.3f us, batch %.3f us",
+                  (double)dt_ref  /(1000.*(double)bench_cnt),
+                  (double)dt_batch/(1000.*(double)bench_cnt) ));
+}
+
+/* Test finishing a proof-based calc with leaves recovered in bulk */
+static void
+test_commitp_fini_with_leaves( ulong leaf_cnt ) {
+  ulong const prefix_sz = FD_BMTREE_LONG_PREFIX_SZ;
+  ulong footprint = fd_bmtree_commit_footprint( 9UL );
+  fd_bmtree_commit_t * tree  = fd_bmtree_commit_init( memory,              20UL, prefix_sz, 9UL );
+  fd_bmtree_commit_t * ptree = fd_bmtree_commit_init( memory +   footprint, 20UL, prefix_sz, 9UL );
+  fd_bmtree_commit_t * qtree = fd_bmtree_commit_init( memory + 2*footprint, 20UL, prefix_sz, 9UL );
+
+  fd_bmtree_node_t leaf[ 256 ];
+  for( ulong i=0UL; i<leaf_cnt; i++ ) {
+    fd_memset( leaf[ i ].hash, 0, 32UL );
+    FD_STORE( ulong, leaf[ i ].hash, i*7UL );
+  }
+  uchar * root = fd_bmtree_commit_fini( fd_bmtree_commit_append( tree, leaf, leaf_cnt ) );
+  ulong depth = fd_bmtree_depth( leaf_cnt );
+
+  /* Receive every third leaf with its proof, recover the rest */
+  fd_bmtree_node_t new_leaf    [ 256 ];
+  ulong            new_leaf_idx[ 256 ];
+  ulong            new_leaf_cnt = 0UL;
+  for( ulong i=0UL; i<leaf_cnt; i++ ) {
+    if( i%3UL==1UL ) {
+      FD_TEST( (int)depth-1==fd_bmtree_get_proof( tree, inc_proof, i ) );
+      FD_TEST( fd_bmtree_commitp_insert_with_proof( ptree, i, leaf+i, inc_proof, depth-1UL, NULL ) );
+      FD_TEST( fd_bmtree_commitp_insert_with_proof( qtree, i, leaf+i, inc_proof, depth-1UL, NULL ) );
+    } else {
+      new_leaf    [ new_leaf_cnt ] = leaf[ i ];
+      new_leaf_idx[ new_leaf_cnt ] = i;
+      new_leaf_cnt++;
+    }
+  }
+
+  /* Corrupt leaf.  Only detectable if a proof was received. */
+  if( leaf_cnt>1UL ) {
+    new_leaf[ new_leaf_cnt-1UL ].hash[ 1 ]++;
+    FD_TEST( !fd_bmtree_commitp_fini_with_leaves( qtree, leaf_cnt, new_leaf, new_leaf_idx, new_leaf_cnt ) );
+    new_leaf[ new_leaf_cnt-1UL ].hash[ 1 ]--;
+  }
+
+  uchar * proot = fd_bmtree_commitp_fini_with_leaves( ptree, leaf_cnt, new_leaf, new_leaf_idx, new_leaf_cnt );
+  FD_TEST( proot );
+  FD_TEST( fd_memeq( root, proot, 20UL ) );
+  /* A failed call leaves the calc untouched */
+  uchar * qroot = fd_bmtree_commitp_fini_with_leaves( qtree, leaf_cnt, new_leaf, new_leaf_idx, new_leaf_cnt );
+  FD_TEST( qroot );
+  FD_TEST( fd_memeq( root, qroot, 20UL ) );
+
+  /* Without any proof, all leaves are needed */
+  fd_bmtree_commit_t * rtree = fd_bmtree_commit_init( memory + 3*footprint, 20UL, prefix_sz, 9UL );
+  for( ulong i=0UL; i<leaf_cnt; i++ ) new_leaf_idx[ i ] = i;
+  FD_TEST( !fd_bmtree_commitp_fini_with_leaves( rtree, leaf_cnt, leaf, new_leaf_idx, leaf_cnt-1UL ) );
+  uchar * rroot = fd_bmtree_commitp_fini_with_leaves( rtree, leaf_cnt, leaf, new_leaf_idx, leaf_cnt );
+  FD_TEST( rroot );
+  FD_TEST( fd_memeq( root, rroot, 20UL ) );
+
+  for( ulong i=0UL; i<leaf_cnt; i++ ) {
+    uchar proof[ 9*32 ];
+    FD_TEST( (int)depth-1==fd_bmtree_get_proof( tree,  inc_proof, i ) );
+    FD_TEST( (int)depth-1==fd_bmtree_get_proof( ptree, proof,     i ) );
+    FD_TEST( fd_memeq( proof, inc_proof, (depth-1UL)*20UL ) );
+  }
+}
+
 
 int
 main( int     argc,
@@ -149,6 +290,8 @@ main( int     argc,
   FD_TEST( fd_bmtree_node_cnt( 1UL )==1UL );
 
   for( ulong leaf_cnt=1UL; leaf_cnt<=256UL; leaf_cnt++ ) test_inclusion( leaf_cnt );
+  for( ulong leaf_cnt=1UL; leaf_cnt<=256UL; leaf_cnt++ ) test_commitp_fini_with_leaves( leaf_cnt );
+  test_commit_batch();
 
   for( ulong leaf_cnt=2UL; leaf_cnt<10000000UL; leaf_cnt++ ) {
     ulong depth = 1UL;
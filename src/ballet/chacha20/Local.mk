@@ -5,6 +5,10 @@ ifdef FD_HAS_AVX
 $(call add-objs,fd_chacha20_avx,fd_ballet)
 endif
 
+ifdef FD_HAS_AVX512
+$(call add-objs,fd_chacha20_avx512,fd_ballet)
+endif
+
 ifdef FD_HAS_SSE
 $(call add-objs,fd_chacha20_sse,fd_ballet)
 else
@@ -105,7 +105,7 @@ fd_chacha20rng_refill_avx( fd_chacha20rng_t * rng ) {
 
   /* Update ring buffer */
 
-  uint * out = (uint *)rng->buf;
+  uint * out = (uint *)( rng->buf + (rng->buf_fill % FD_CHACHA20RNG_BUFSZ) );
   wu_st( out+0x00, c0 ); wu_st( out+0x08, c8 );
   wu_st( out+0x10, c1 ); wu_st( out+0x18, c9 );
   wu_st( out+0x20, c2 ); wu_st( out+0x28, cA );
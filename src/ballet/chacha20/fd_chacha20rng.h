@@ -26,7 +26,9 @@
 /* FD_CHACHA20RNG_BUFSZ is the internal buffer size of pre-generated
    ChaCha20 blocks.  Multiple of block size (64 bytes) and a power of 2. */
 
-#if FD_HAS_AVX
+#if FD_HAS_AVX512
+#define FD_CHACHA20RNG_BUFSZ (16*FD_CHACHA20_BLOCK_SZ)
+#elif FD_HAS_AVX
 #define FD_CHACHA20RNG_BUFSZ (8*FD_CHACHA20_BLOCK_SZ)
 #else
 #define FD_CHACHA20RNG_BUFSZ (256UL)
@@ -118,13 +120,18 @@ fd_chacha20rng_init( fd_chacha20rng_t * rng,
 
 /* The refill function .  Not part of the public API. */
 
+void
+fd_chacha20rng_refill_avx512( fd_chacha20rng_t * rng );
+
 void
 fd_chacha20rng_refill_avx( fd_chacha20rng_t * rng );
 
 void
 fd_chacha20rng_refill_seq( fd_chacha20rng_t * rng );
 
-#if FD_HAS_AVX
+#if FD_HAS_AVX512
+#define fd_chacha20rng_private_refill fd_chacha20rng_refill_avx512
+#elif FD_HAS_AVX
 #define fd_chacha20rng_private_refill fd_chacha20rng_refill_avx
 #else
 #define fd_chacha20rng_private_refill fd_chacha20rng_refill_seq
@@ -198,10 +205,17 @@ fd_chacha20rng_ulong_roll( fd_chacha20rng_t * rng,
      such that k*n >= 2^63, which is the largest power of two such that
      k*n<=2^64 unless n is a power of two.  This approach eliminates the
      mod calculation but increases the expected number of samples
-     required. */
-  ulong const zone = fd_ulong_if( rng->mode==FD_CHACHA20RNG_MODE_MOD,
-                                  ULONG_MAX - (ULONG_MAX-n+1UL)%n,
-                                  (n << (63 - fd_ulong_find_msb( n ) )) - 1UL );
+     required.
+
+     The zone is computed with a branch rather than fd_ulong_if, since
+     fd_ulong_if evaluates both arms, and MODE_SHIFT callers (e.g. the
+     Turbine tree sampling, which calls this a few hundred times per
+     shred) would otherwise pay for a 64-bit division on every roll.
+     The mode is fixed for the lifetime of the object, so the branch is
+     perfectly predicted. */
+  ulong zone;
+  if( rng->mode==FD_CHACHA20RNG_MODE_MOD ) zone = ULONG_MAX - (ULONG_MAX-n+1UL)%n;
+  else                                     zone = (n << (63 - fd_ulong_find_msb( n ) )) - 1UL;
 
   for( int i=0; 1; i++ ) {
     ulong   v   = fd_chacha20rng_ulong( rng );
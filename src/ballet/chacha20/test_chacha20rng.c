@@ -63,7 +63,7 @@ main( int     argc,
 
     /* warmup */
     for( ulong rem=100000UL; rem; rem-- ) {
-      rng->buf_off += 8*FD_CHACHA20_BLOCK_SZ;
+      rng->buf_off = rng->buf_fill;
       fd_chacha20rng_refill_avx( rng );
     }
 
@@ -71,7 +71,7 @@ main( int     argc,
     ulong iter = 1000000UL;
     long  dt   = -fd_log_wallclock();
     for( ulong rem=iter; rem; rem-- ) {
-      rng->buf_off += 8*FD_CHACHA20_BLOCK_SZ;
+      rng->buf_off = rng->buf_fill;
       fd_chacha20rng_refill_avx( rng );
     }
     dt += fd_log_wallclock();
@@ -80,6 +80,48 @@ main( int     argc,
   } while(0);
 # endif /* FD_HAS_AVX */
 
+# if FD_HAS_AVX512
+  do {
+    /* The AVX and AVX512 refills must produce the same stream */
+    fd_chacha20rng_t _rng2[1];
+    fd_chacha20rng_t * rng2 = fd_chacha20rng_join( fd_chacha20rng_new( _rng2, FD_CHACHA20RNG_MODE_MOD ) );
+    key[ 0 ]++;
+    FD_TEST( fd_chacha20rng_init( rng,  key ) );
+    FD_TEST( fd_chacha20rng_init( rng2, key ) );
+    rng2->buf_off = rng2->buf_fill = 0UL; /* regenerate from the first block with the AVX refill */
+    for( ulong i=0UL; i<100UL; i++ ) {
+      rng2->buf_off = rng2->buf_fill;
+      fd_chacha20rng_refill_avx( rng2 );
+      for( ulong j=0UL; j<8UL*FD_CHACHA20_BLOCK_SZ/sizeof(ulong); j++ ) {
+        ulong expected = FD_LOAD( ulong, rng2->buf + ((rng2->buf_fill - 8UL*FD_CHACHA20_BLOCK_SZ + j*sizeof(ulong)) % FD_CHACHA20RNG_BUFSZ) );
+        FD_TEST( fd_chacha20rng_ulong( rng )==expected );
+      }
+    }
+    fd_chacha20rng_delete( fd_chacha20rng_leave( rng2 ) );
+
+    FD_LOG_NOTICE(( "Benchmarking fd_chacha20rng_refill_avx512" ));
+    key[ 0 ]++;
+    FD_TEST( fd_chacha20rng_init( rng, key ) );
+
+    /* warmup */
+    for( ulong rem=100000UL; rem; rem-- ) {
+      rng->buf_off = rng->buf_fill;
+      fd_chacha20rng_refill_avx512( rng );
+    }
+
+    /* for real */
+    ulong iter = 1000000UL;
+    long  dt   = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      rng->buf_off = rng->buf_fill;
+      fd_chacha20rng_refill_avx512( rng );
+    }
+    dt += fd_log_wallclock();
+    double gbps  = ((double)(8UL*16UL*FD_CHACHA20_BLOCK_SZ*iter)) / ((double)dt);
+    FD_LOG_NOTICE(( "  ~%6.3f Gbps / core", gbps    ));
+  } while(0);
+# endif /* FD_HAS_AVX512 */
+
   /* Clean up */
 
   FD_TEST( (ulong)fd_chacha20rng_delete( fd_chacha20rng_leave( rng ) )==(ulong)_rng );
@@ -7,6 +7,11 @@ $(call add-objs,fd_reedsol_encode_16,fd_reedsol)
 $(call add-objs,fd_reedsol_encode_32,fd_reedsol)
 $(call add-objs,fd_reedsol_encode_64,fd_reedsol)
 $(call add-objs,fd_reedsol_encode_128,fd_reedsol)
+ifdef FD_HAS_GFNI
+ifdef FD_HAS_AVX512
+$(call add-objs,fd_reedsol_encode_32_32_x2,fd_reedsol)
+endif
+endif
 $(call add-objs,fd_reedsol_recover_16,fd_reedsol)
 $(call add-objs,fd_reedsol_recover_32,fd_reedsol)
 $(call add-objs,fd_reedsol_recover_64,fd_reedsol)
@@ -31,6 +31,38 @@ fd_reedsol_encode_fini( fd_reedsol_t * rs ) {
   rs->parity_shred_cnt = 0UL;
 }
 
+void
+fd_reedsol_encode_fini_batch( fd_reedsol_t * const * rs,
+                              ulong                  rs_cnt ) {
+
+# if FD_REEDSOL_ARITH_IMPL==3
+  /* Pair up consecutive 32:32 operations with matching shred_sz.
+     pend is an eligible operation waiting for a partner. */
+  fd_reedsol_t * pend = NULL;
+  for( ulong i=0UL; i<rs_cnt; i++ ) {
+    fd_reedsol_t * cur = rs[ i ];
+    if( FD_UNLIKELY( (cur->data_shred_cnt!=32UL) | (cur->parity_shred_cnt!=32UL) ) ) {
+      fd_reedsol_encode_fini( cur );
+      continue;
+    }
+    if( FD_UNLIKELY( !pend ) ) { pend = cur; continue; }
+    if( FD_UNLIKELY( pend->shred_sz!=cur->shred_sz ) ) {
+      fd_reedsol_encode_fini( pend );
+      pend = cur;
+      continue;
+    }
+    fd_reedsol_private_encode_32_32_x2( cur->shred_sz, pend->encode.data_shred, pend->encode.parity_shred,
+                                                       cur->encode.data_shred,  cur->encode.parity_shred );
+    fd_reedsol_encode_abort( pend );
+    fd_reedsol_encode_abort( cur  );
+    pend = NULL;
+  }
+  if( pend ) fd_reedsol_encode_fini( pend );
+# else
+  for( ulong i=0UL; i<rs_cnt; i++ ) fd_reedsol_encode_fini( rs[ i ] );
+# endif
+}
+
 int
 fd_reedsol_recover_fini( fd_reedsol_t * rs ) {
 
@@ -162,6 +162,24 @@ fd_reedsol_encode_abort( fd_reedsol_t * rs ) {
 void
 fd_reedsol_encode_fini( fd_reedsol_t * rs );
 
+/* fd_reedsol_encode_fini_batch finishes rs_cnt in-progress encoding
+   operations at once.  rs[i] for i in [0,rs_cnt) must each be
+   initialized as an encoder, and no shred may be shared between two
+   operations unless it is a data shred.  Upon return, the result is
+   identical to calling fd_reedsol_encode_fini on each of them in order
+   and none of rs[i] will be initialized.
+
+   This exists so that producers of several FEC sets in a row (e.g. the
+   shredder when making a large block) can let the encoder interleave
+   them.  When the target has GFNI and AVX-512, consecutive pairs of
+   operations with 32 data and 32 parity shreds of the same shred_sz
+   (the common Turbine case) are encoded together in one loop, using the
+   low and high halves of each 512-bit vector for the two FEC sets.  The
+   remaining operations are encoded one at a time. */
+void
+fd_reedsol_encode_fini_batch( fd_reedsol_t * const * rs,
+                              ulong                  rs_cnt );
+
 /* fd_reedsol_recover_init: starts a Reed-Solomon recover/decode
    operation that will recover shreds of size shred_sz.  mem is assumed
    to be an unused piece of memory that meets the alignment and size
@@ -85,6 +85,21 @@ fd_reedsol_private_encode_32_32( ulong                 shred_sz,
                                  uchar       *         _scratch );
 #endif
 
+#if FD_REEDSOL_ARITH_IMPL==3
+/* fd_reedsol_private_encode_32_32_x2 computes the 32 parity shreds of
+   two independent FEC sets, (data_shred0,parity_shred0) and
+   (data_shred1,parity_shred1), each with exactly 32 data shreds of size
+   shred_sz.  The result is identical to two calls to
+   fd_reedsol_private_encode_32 with data_shred_cnt==parity_shred_cnt==
+   32. */
+void
+fd_reedsol_private_encode_32_32_x2( ulong                 shred_sz,
+                                    uchar const * const * data_shred0,
+                                    uchar       * const * parity_shred0,
+                                    uchar const * const * data_shred1,
+                                    uchar       * const * parity_shred1 );
+#endif
+
 /* fd_reedsol_private_recover_var_{n}: Verifies the consistency
    of the Reed-Solomon encoded data, and recovers any missing data.
    At least data_shred_cnt of the first n shreds must be un-erased,
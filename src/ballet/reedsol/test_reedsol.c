@@ -623,6 +623,84 @@ battery_performance_base( fd_rng_t *    rng ) {
         ));
 }
 
+#define BATCH_MAX (8UL)
+uchar batch_data_shreds  [ BATCH_MAX ][ SHRED_SZ * 32UL ];
+uchar batch_parity_shreds[ BATCH_MAX ][ SHRED_SZ * 32UL ];
+uchar batch_mem[ BATCH_MAX ][ FD_REEDSOL_FOOTPRINT ] __attribute__((aligned(FD_REEDSOL_ALIGN)));
+
+static void
+test_encode_batch( fd_rng_t * rng ) {
+  for( ulong b=0UL; b<BATCH_MAX; b++ )
+    for( ulong j=0UL; j<SHRED_SZ*32UL; j++ ) batch_data_shreds[ b ][ j ] = fd_rng_uchar( rng );
+
+  uchar * r[ 32 ];
+  for( ulong j=0UL; j<32UL; j++ ) r[ j ] = recovered_shreds + SHRED_SZ*j;
+
+  for( ulong iter=0UL; iter<1000UL; iter++ ) {
+    /* Mostly 32:32 sets with a shared shred_sz, sprinkled with odd
+       shapes and sizes that must not be paired. */
+    ulong rs_cnt   = 1UL + fd_rng_ulong_roll( rng, BATCH_MAX );
+    ulong common   = 32UL + fd_rng_ulong_roll( rng, SHRED_SZ-31UL );
+    ulong d_cnt   [ BATCH_MAX ];
+    ulong p_cnt   [ BATCH_MAX ];
+    ulong shred_sz[ BATCH_MAX ];
+    fd_reedsol_t * rs[ BATCH_MAX ];
+    for( ulong b=0UL; b<rs_cnt; b++ ) {
+      int odd     = !fd_rng_uint_roll( rng, 4U );
+      d_cnt   [ b ] = odd ? 1UL+fd_rng_ulong_roll( rng, 32UL ) : 32UL;
+      p_cnt   [ b ] = odd ? 1UL+fd_rng_ulong_roll( rng, 32UL ) : 32UL;
+      shred_sz[ b ] = fd_rng_uint_roll( rng, 4U ) ? common : 32UL + fd_rng_ulong_roll( rng, SHRED_SZ-31UL );
+      fd_memset( batch_parity_shreds[ b ], 0xCC, SHRED_SZ*32UL );
+      rs[ b ] = fd_reedsol_encode_init( batch_mem[ b ], shred_sz[ b ] );
+      for( ulong i=0UL; i<d_cnt[ b ]; i++ ) fd_reedsol_encode_add_data_shred(   rs[ b ], batch_data_shreds  [ b ] + SHRED_SZ*i );
+      for( ulong j=0UL; j<p_cnt[ b ]; j++ ) fd_reedsol_encode_add_parity_shred( rs[ b ], batch_parity_shreds[ b ] + SHRED_SZ*j );
+    }
+
+    fd_reedsol_encode_fini_batch( rs, rs_cnt );
+
+    for( ulong b=0UL; b<rs_cnt; b++ ) {
+      FD_TEST( !rs[ b ]->data_shred_cnt && !rs[ b ]->parity_shred_cnt );
+      fd_reedsol_t * ref = fd_reedsol_encode_init( mem, shred_sz[ b ] );
+      for( ulong i=0UL; i<d_cnt[ b ]; i++ ) fd_reedsol_encode_add_data_shred(   ref, batch_data_shreds[ b ] + SHRED_SZ*i );
+      for( ulong j=0UL; j<p_cnt[ b ]; j++ ) fd_reedsol_encode_add_parity_shred( ref, r[ j ] );
+      fd_reedsol_encode_fini( ref );
+      for( ulong j=0UL; j<p_cnt[ b ]; j++ ) FD_TEST( !memcmp( batch_parity_shreds[ b ] + SHRED_SZ*j, r[ j ], shred_sz[ b ] ) );
+      /* Nothing past the end of each parity shred was touched */
+      if( shred_sz[ b ]<SHRED_SZ )
+        for( ulong j=0UL; j<p_cnt[ b ]; j++ ) FD_TEST( batch_parity_shreds[ b ][ SHRED_SZ*j + shred_sz[ b ] ]==0xCC );
+    }
+  }
+}
+
+static void
+battery_performance_batch( fd_rng_t * rng ) {
+  ulong const test_count = 20000UL;
+
+  for( ulong b=0UL; b<BATCH_MAX; b++ )
+    for( ulong j=0UL; j<SHRED_SZ*32UL; j++ ) FD_VOLATILE( batch_data_shreds[ b ][ j ] ) = fd_rng_uchar( rng );
+
+  fd_reedsol_t * rs[ BATCH_MAX ];
+  for( ulong batch_sz=1UL; batch_sz<=BATCH_MAX; batch_sz*=2UL ) {
+    long dt = 0L;
+    for( ulong iter=0UL; iter<test_count+1UL; iter++ ) { /* first iteration warms up the instruction cache */
+      long t = -fd_log_wallclock();
+      for( ulong b=0UL; b<batch_sz; b++ ) {
+        rs[ b ] = fd_reedsol_encode_init( batch_mem[ b ], SHRED_SZ );
+        for( ulong i=0UL; i<32UL; i++ ) {
+          fd_reedsol_encode_add_data_shred(   rs[ b ], batch_data_shreds  [ b ] + SHRED_SZ*i );
+          fd_reedsol_encode_add_parity_shred( rs[ b ], batch_parity_shreds[ b ] + SHRED_SZ*i );
+        }
+      }
+      fd_reedsol_encode_fini_batch( rs, batch_sz );
+      t += fd_log_wallclock();
+      if( iter ) dt += t;
+    }
+    ulong set_cnt = test_count*batch_sz;
+    FD_LOG_NOTICE(( "batch of %lu FEC sets: average time per 32:32 FEC set %f ns ( %f Gbps )",
+                    batch_sz, (double)dt/(double)set_cnt, (double)(set_cnt * 32UL * SHRED_SZ * 8UL) / (double)dt ));
+  }
+}
+
 char output[ FD_REEDSOL_DATA_SHREDS_MAX * FD_REEDSOL_PARITY_SHREDS_MAX * 8UL ];
 long loop_times[ FD_REEDSOL_DATA_SHREDS_MAX+1UL ][ FD_REEDSOL_PARITY_SHREDS_MAX+1UL ];
 
@@ -996,8 +1074,10 @@ main( int     argc,
 
   basic_tests();
   battery_performance_base( rng );
+  battery_performance_batch( rng );
   battery_performance_generic( rng, 32UL, 32UL, 5000UL );
   test_encode_vs_ref( rng );
+  test_encode_batch( rng );
   test_recover( rng );
   test_recover_performance( rng );
   test_pi_all( rng );
@@ -7,7 +7,12 @@
 
 #define FD_ARCHIVER_TILE_ID_SHRED  (0U)
 #define FD_ARCHIVER_TILE_ID_REPAIR (1U)
-#define FD_ARCHIVER_TILE_CNT       (2U)
+/* Resolved transactions (fd_txn_m_t) as received by the pack tile on
+   the resolv_pack links.  The feeder only captures these when
+   [tiles.archiver.capture_pack] is set.  The frag sig is the reference
+   slot of the transaction, see bench_pack_replay for a consumer. */
+#define FD_ARCHIVER_TILE_ID_PACK   (2U)
+#define FD_ARCHIVER_TILE_CNT       (3U)
 
 /* For now, feeder only needs to distinguish 2 types of input frags,
    so we use the highest bit in sig to distinguish shred and repair. */
@@ -21,6 +21,7 @@ typedef struct {
   fd_wksp_t * mem;
   ulong       chunk0;
   ulong       wmark;
+  int         is_pack; /* resolv_pack link, tile id is not in the sig */
 } fd_archiver_feeder_in_ctx_t;
 
 struct fd_archiver_feeder_tile_ctx {
@@ -94,6 +95,7 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->round_robin_cnt = fd_topo_tile_name_cnt( topo, tile->name );
   ctx->round_robin_idx = tile->kind_id;
 
+  if( FD_UNLIKELY( tile->in_cnt>FD_ARCHIVER_FEEDER_MAX_INPUT_LINKS ) ) FD_LOG_ERR(( "too many input links %lu", tile->in_cnt ));
   for( ulong i=0; i<tile->in_cnt; i++ ) {
     fd_topo_link_t * link = &topo->links[ tile->in_link_id[ i ] ];
     fd_topo_wksp_t * link_wksp = &topo->workspaces[ topo->objs[ link->dcache_obj_id ].wksp_id ];
@@ -101,6 +103,12 @@ unprivileged_init( fd_topo_t *      topo,
     ctx->in[ i ].mem    = link_wksp->wksp;
     ctx->in[ i ].chunk0 = fd_dcache_compact_chunk0( ctx->in[ i ].mem, link->dcache );
     ctx->in[ i ].wmark  = fd_dcache_compact_wmark ( ctx->in[ i ].mem, link->dcache, link->mtu );
+    ctx->in[ i ].is_pack = !strcmp( link->name, "resolv_pack" );
+
+    ulong out_mtu = topo->links[ tile->out_link_id[ 0 ] ].mtu;
+    if( FD_UNLIKELY( link->mtu+FD_ARCHIVER_FRAG_HEADER_FOOTPRINT>out_mtu ) ) {
+      FD_LOG_ERR(( "in link %s mtu %lu does not fit out link mtu %lu", link->name, link->mtu, out_mtu ));
+    }
   }
 
   ctx->out_mem    = topo->workspaces[ topo->objs[ topo->links[ tile->out_link_id[ 0 ] ].dcache_obj_id ].wksp_id ].wksp;
@@ -137,10 +145,13 @@ during_frag( fd_archiver_feeder_tile_ctx_t * ctx,
     fd_archiver_frag_header_t * header = fd_type_pun( dst );
     header->magic                      = FD_ARCHIVER_HEADER_MAGIC;
     header->version                    = FD_ARCHIVER_HEADER_VERSION;
-    header->tile_id                    = FD_ARCHIVER_SIG_TILE_ID(sig);
+    /* Frags from the resolv_pack links keep their sig (the reference
+       slot), the others carry the tile id in the high bit */
+    int is_pack                        = ctx->in[ in_idx ].is_pack;
+    header->tile_id                    = is_pack ? FD_ARCHIVER_TILE_ID_PACK : FD_ARCHIVER_SIG_TILE_ID(sig);
     /* header->ns_since_prev_fragment is set in the single writer tile, so that we have a total order */
     header->sz                         = sz;
-    header->sig                        = FD_ARCHIVER_SIG_CLEAR(sig);
+    header->sig                        = is_pack ? sig : FD_ARCHIVER_SIG_CLEAR(sig);
     header->seq                        = seq;
 
     /* Write the frag to the dst */
@@ -194,6 +194,7 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->notified                                 = 1;
   ctx->playback_cnt[FD_ARCHIVER_TILE_ID_SHRED]  = 0;
   ctx->playback_cnt[FD_ARCHIVER_TILE_ID_REPAIR] = 0;
+  ctx->playback_cnt[FD_ARCHIVER_TILE_ID_PACK]   = 0;
 
   ulong root_slot_obj_id = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "root_slot" );
   FD_TEST( root_slot_obj_id!=ULONG_MAX );
@@ -229,9 +230,10 @@ after_credit( fd_archiver_playback_tile_ctx_t *     ctx,
               int *                                 charge_busy FD_PARAM_UNUSED ) {
   if( FD_UNLIKELY( ctx->playback_done ) ) {
     if( ctx->now>ctx->done_time+1000000000UL*5UL ) {
-      FD_LOG_ERR(( "Playback is done with %lu shred frags and %lu repair frags.",
+      FD_LOG_ERR(( "Playback is done with %lu shred frags and %lu repair frags (%lu pack frags skipped).",
                    ctx->playback_cnt[FD_ARCHIVER_TILE_ID_SHRED],
-                   ctx->playback_cnt[FD_ARCHIVER_TILE_ID_REPAIR] ));
+                   ctx->playback_cnt[FD_ARCHIVER_TILE_ID_REPAIR],
+                   ctx->playback_cnt[FD_ARCHIVER_TILE_ID_PACK] ));
     }
     return;
   }
@@ -294,6 +296,18 @@ after_credit( fd_archiver_playback_tile_ctx_t *     ctx,
     out_link_idx = NET_REPAIR_OUT_IDX;
     ctx->playback_cnt[FD_ARCHIVER_TILE_ID_REPAIR]++;
     break;
+    case FD_ARCHIVER_TILE_ID_PACK:
+    /* Pack captures are for bench_pack_replay, there is no pack tile
+       to play them back to here */
+    ctx->playback_cnt[FD_ARCHIVER_TILE_ID_PACK]++;
+    if( FD_UNLIKELY( fd_io_buffered_istream_skip( &ctx->istream, header_tmp.sz ) ) ) {
+      FD_LOG_WARNING(( "failed to skip frag" ));
+      ctx->playback_done = 1;
+      ctx->done_time     = ctx->now;
+      return;
+    }
+    ctx->prev_publish_time = ctx->now;
+    return;
     default:
     FD_LOG_ERR(( "unsupported tile id" ));
   }
@@ -27,6 +27,7 @@ There should only ever be a single archiver writer tile. */
 struct fd_archiver_writer_stats {
   ulong net_shred_in_cnt;
   ulong net_repair_in_cnt;
+  ulong pack_in_cnt;
 };
 typedef struct fd_archiver_writer_stats fd_archiver_writer_stats_t;
 
@@ -216,6 +217,7 @@ during_frag( fd_archiver_writer_tile_ctx_t * ctx,
 
   ctx->stats.net_shred_in_cnt   += header->tile_id == FD_ARCHIVER_TILE_ID_SHRED;
   ctx->stats.net_repair_in_cnt  += header->tile_id == FD_ARCHIVER_TILE_ID_REPAIR;
+  ctx->stats.pack_in_cnt        += header->tile_id == FD_ARCHIVER_TILE_ID_PACK;
 }
 
 static inline void
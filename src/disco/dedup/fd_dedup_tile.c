@@ -10,7 +10,16 @@
 /* fd_dedup provides services to deduplicate multiple streams of input
    fragments and present them to a mix of reliable and unreliable
    consumers as though they were generated by a single multi-stream
-   producer. */
+   producer.
+
+   The work can be split across several dedup tiles.  Txns are then
+   partitioned by a hash of their first signature (the same one the
+   verify tiles publish as the frag sig, see fd_verify_dedup_sig), and
+   every dedup tile consumes all inputs but only handles the txns in
+   its own partition.  All copies of a txn land in the same partition,
+   so each tile can keep a private tcache and there is no shared state
+   between them.  Bundles are always handled by the first dedup tile.
+   Each dedup tile publishes to its own output link. */
 
 #define IN_KIND_GOSSIP       (0UL)
 #define IN_KIND_VERIFY       (1UL)
@@ -51,6 +60,9 @@ typedef struct {
 
   ulong       hashmap_seed;
 
+  ulong       round_robin_idx;
+  ulong       round_robin_cnt;
+
   struct {
     ulong bundle_peer_failure_cnt;
     ulong dedup_fail_cnt;
@@ -76,6 +88,27 @@ metrics_write( fd_dedup_ctx_t * ctx ) {
   FD_MCNT_SET( DEDUP, TRANSACTION_DEDUP_FAILURE,       ctx->metrics.dedup_fail_cnt );
 }
 
+/* dedup_partition returns the dedup tile that handles txns published
+   with the given sig. */
+
+FD_FN_CONST static inline ulong
+dedup_partition( fd_dedup_ctx_t const * ctx,
+                 ulong                  sig ) {
+  return sig % ctx->round_robin_cnt;
+}
+
+/* before_frag drops txns that belong to another dedup tile's partition
+   before they are copied.  The verify tiles and the PoH tile (for gossip
+   votes and executed txns) all publish with the sig partitioned on. */
+
+static inline int
+before_frag( fd_dedup_ctx_t * ctx,
+             ulong            in_idx FD_PARAM_UNUSED,
+             ulong            seq    FD_PARAM_UNUSED,
+             ulong            sig ) {
+  return dedup_partition( ctx, sig )!=ctx->round_robin_idx;
+}
+
 /* during_frag is called between pairs for sequence number checks, as
    we are reading incoming frags.  We don't actually need to copy the
    fragment here, flow control prevents it getting overrun, and
@@ -238,6 +271,9 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->bundle_id     = 0UL;
   ctx->bundle_idx    = 0UL;
 
+  ctx->round_robin_cnt = fd_topo_tile_name_cnt( topo, tile->name );
+  ctx->round_robin_idx = tile->kind_id;
+
   memset( &ctx->metrics, 0, sizeof( ctx->metrics ) );
 
   ctx->tcache_depth   = fd_tcache_depth       ( tcache );
@@ -312,6 +348,7 @@ populate_allowed_fds( fd_topo_t const *      topo,
 #define STEM_CALLBACK_CONTEXT_ALIGN alignof(fd_dedup_ctx_t)
 
 #define STEM_CALLBACK_METRICS_WRITE metrics_write
+#define STEM_CALLBACK_BEFORE_FRAG   before_frag
 #define STEM_CALLBACK_DURING_FRAG   during_frag
 #define STEM_CALLBACK_AFTER_FRAG    after_frag
 
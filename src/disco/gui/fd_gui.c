@@ -344,11 +344,18 @@ fd_gui_txn_waterfall_snap( fd_gui_t *               gui,
   }
 
 
-  fd_topo_tile_t const * dedup = &topo->tiles[ fd_topo_find_tile( topo, "dedup", 0UL ) ];
-  volatile ulong const * dedup_metrics = fd_metrics_tile( dedup->metrics );
+  cur->out.dedup_duplicate = 0UL;
+  ulong gossip_votes       = 0UL;
 
-  cur->out.dedup_duplicate = dedup_metrics[ MIDX( COUNTER, DEDUP, TRANSACTION_DEDUP_FAILURE ) ]
-                           + dedup_metrics[ MIDX( COUNTER, DEDUP, TRANSACTION_BUNDLE_PEER_FAILURE ) ];
+  ulong dedup_tile_cnt = fd_topo_tile_name_cnt( topo, "dedup" );
+  for( ulong i=0UL; i<dedup_tile_cnt; i++ ) {
+    fd_topo_tile_t const * dedup = &topo->tiles[ fd_topo_find_tile( topo, "dedup", i ) ];
+    volatile ulong const * dedup_metrics = fd_metrics_tile( dedup->metrics );
+
+    cur->out.dedup_duplicate += dedup_metrics[ MIDX( COUNTER, DEDUP, TRANSACTION_DEDUP_FAILURE ) ]
+                              + dedup_metrics[ MIDX( COUNTER, DEDUP, TRANSACTION_BUNDLE_PEER_FAILURE ) ];
+    gossip_votes             += dedup_metrics[ MIDX( COUNTER, DEDUP, GOSSIPED_VOTES_RECEIVED ) ];
+  }
 
 
   cur->out.verify_overrun   = 0UL;
@@ -393,6 +400,7 @@ fd_gui_txn_waterfall_snap( fd_gui_t *               gui,
     cur->out.tpu_quic_invalid += quic_metrics[ MIDX( COUNTER, QUIC, PKT_QUIC_HEADER_INVALID ) ];
     cur->out.quic_abandoned   += quic_metrics[ MIDX( COUNTER, QUIC, TXNS_ABANDONED          ) ];
     cur->out.quic_frag_drop   += quic_metrics[ MIDX( COUNTER, QUIC, TXNS_OVERRUN            ) ];
+    cur->out.quic_frag_drop   += quic_metrics[ MIDX( COUNTER, QUIC, TXN_THROTTLED           ) ];
 
     for( ulong j=0UL; j<gui->summary.net_tile_cnt; j++ ) {
       /* TODO: Not precise... net frags that were skipped might not have been destined for QUIC tile */
@@ -422,7 +430,7 @@ fd_gui_txn_waterfall_snap( fd_gui_t *               gui,
   }
 
   cur->in.pack_cranked = pack_metrics[ MIDX( COUNTER, PACK, BUNDLE_CRANK_STATUS_INSERTED ) ];
-  cur->in.gossip   = dedup_metrics[ MIDX( COUNTER, DEDUP, GOSSIPED_VOTES_RECEIVED ) ];
+  cur->in.gossip   = gossip_votes;
   cur->in.quic     = cur->out.tpu_quic_invalid +
                      cur->out.quic_overrun +
                      cur->out.quic_frag_drop +
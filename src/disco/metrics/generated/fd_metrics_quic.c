@@ -14,6 +14,7 @@ const fd_metrics_meta_t FD_METRICS_QUIC[FD_METRICS_QUIC_TOTAL] = {
     DECLARE_METRIC( QUIC_TXNS_ABANDONED, COUNTER ),
     DECLARE_METRIC( QUIC_TXN_UNDERSZ, COUNTER ),
     DECLARE_METRIC( QUIC_TXN_OVERSZ, COUNTER ),
+    DECLARE_METRIC( QUIC_TXN_THROTTLED, COUNTER ),
     DECLARE_METRIC( QUIC_LEGACY_TXN_UNDERSZ, COUNTER ),
     DECLARE_METRIC( QUIC_LEGACY_TXN_OVERSZ, COUNTER ),
     DECLARE_METRIC( QUIC_RECEIVED_PACKETS, COUNTER ),
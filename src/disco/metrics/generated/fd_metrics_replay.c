@@ -4,4 +4,11 @@
 const fd_metrics_meta_t FD_METRICS_REPLAY[FD_METRICS_REPLAY_TOTAL] = {
     DECLARE_METRIC( REPLAY_SLOT, GAUGE ),
     DECLARE_METRIC( REPLAY_LAST_VOTED_SLOT, GAUGE ),
+    DECLARE_METRIC( REPLAY_PROGRAM_CACHE_HIT, COUNTER ),
+    DECLARE_METRIC( REPLAY_PROGRAM_CACHE_MISS, COUNTER ),
+    DECLARE_METRIC( REPLAY_PROGRAM_CACHE_INSERT, COUNTER ),
+    DECLARE_METRIC( REPLAY_PROGRAM_CACHE_INSERT_FAIL, COUNTER ),
+    DECLARE_METRIC( REPLAY_PROGRAM_CACHE_EVICT, COUNTER ),
+    DECLARE_METRIC( REPLAY_PROGRAM_CACHE_ENTRIES, GAUGE ),
+    DECLARE_METRIC( REPLAY_PROGRAM_CACHE_SIZE_BYTES, GAUGE ),
 };
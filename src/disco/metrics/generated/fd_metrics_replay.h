@@ -15,5 +15,47 @@
 #define FD_METRICS_GAUGE_REPLAY_LAST_VOTED_SLOT_DESC ""
 #define FD_METRICS_GAUGE_REPLAY_LAST_VOTED_SLOT_CVT  (FD_METRICS_CONVERTER_NONE)
 
-#define FD_METRICS_REPLAY_TOTAL (2UL)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_HIT_OFF  (18UL)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_HIT_NAME "replay_program_cache_hit"
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_HIT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_HIT_DESC "The number of node-wide program cache queries that returned a validated program."
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_HIT_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_MISS_OFF  (19UL)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_MISS_NAME "replay_program_cache_miss"
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_MISS_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_MISS_DESC "The number of node-wide program cache queries that found no validated program."
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_MISS_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_OFF  (20UL)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_NAME "replay_program_cache_insert"
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_DESC "The number of validated programs inserted into the node-wide program cache."
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_FAIL_OFF  (21UL)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_FAIL_NAME "replay_program_cache_insert_fail"
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_FAIL_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_FAIL_DESC "The number of validated programs that could not be inserted into the node-wide program cache."
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_INSERT_FAIL_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_EVICT_OFF  (22UL)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_EVICT_NAME "replay_program_cache_evict"
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_EVICT_TYPE (FD_METRICS_TYPE_COUNTER)
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_EVICT_DESC "The number of validated programs evicted from the node-wide program cache to make room."
+#define FD_METRICS_COUNTER_REPLAY_PROGRAM_CACHE_EVICT_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_ENTRIES_OFF  (23UL)
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_ENTRIES_NAME "replay_program_cache_entries"
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_ENTRIES_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_ENTRIES_DESC "The number of validated programs in the node-wide program cache."
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_ENTRIES_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_SIZE_BYTES_OFF  (24UL)
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_SIZE_BYTES_NAME "replay_program_cache_size_bytes"
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_SIZE_BYTES_TYPE (FD_METRICS_TYPE_GAUGE)
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_SIZE_BYTES_DESC "The number of bytes held by the node-wide program cache."
+#define FD_METRICS_GAUGE_REPLAY_PROGRAM_CACHE_SIZE_BYTES_CVT  (FD_METRICS_CONVERTER_NONE)
+
+#define FD_METRICS_REPLAY_TOTAL (9UL)
 extern const fd_metrics_meta_t FD_METRICS_REPLAY[FD_METRICS_REPLAY_TOTAL];
@@ -12,6 +12,7 @@
 #include <fcntl.h> /* fcntl */
 #include <unistd.h> /* dup3, close */
 #include <netinet/in.h> /* sockaddr_in */
+#include <netinet/udp.h> /* UDP_GRO, UDP_SEGMENT */
 #include <sys/socket.h> /* socket */
 #include "generated/sock_seccomp.h"
 #include "../../metrics/fd_metrics.h"
@@ -81,8 +82,13 @@ scratch_align( void ) {
   return 4096UL;
 }
 
+FD_FN_CONST static inline ulong
+gro_scratch_footprint( fd_topo_tile_t const * tile ) {
+  return tile->sock.udp_gro ? FD_SOCK_GRO_BATCH*FD_SOCK_GRO_BUF_SZ : 0UL;
+}
+
 FD_FN_PURE static inline ulong
-scratch_footprint( fd_topo_tile_t const * tile FD_PARAM_UNUSED ) {
+scratch_footprint( fd_topo_tile_t const * tile ) {
   ulong l = FD_LAYOUT_INIT;
   l = FD_LAYOUT_APPEND( l, alignof(fd_sock_tile_t),     sizeof(fd_sock_tile_t)                );
   l = FD_LAYOUT_APPEND( l, alignof(struct iovec),       STEM_BURST*sizeof(struct iovec)       );
@@ -90,17 +96,20 @@ scratch_footprint( fd_topo_tile_t const * tile FD_PARAM_UNUSED ) {
   l = FD_LAYOUT_APPEND( l, alignof(struct sockaddr_in), STEM_BURST*sizeof(struct sockaddr_in) );
   l = FD_LAYOUT_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
   l = FD_LAYOUT_APPEND( l, FD_CHUNK_ALIGN,              tx_scratch_footprint()                );
+  l = FD_LAYOUT_APPEND( l, FD_CHUNK_ALIGN,              gro_scratch_footprint( tile )         );
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
 /* create_udp_socket creates and configures a new UDP socket for the
-   sock tile at the given file descriptor ID. */
+   sock tile at the given file descriptor ID.  If udp_gro is set, the
+   kernel may coalesce incoming datagrams of the same flow. */
 
 static void
 create_udp_socket( int    sock_fd,
                    uint   bind_addr,
                    ushort udp_port,
-                   int    so_rcvbuf ) {
+                   int    so_rcvbuf,
+                   int    udp_gro ) {
 
   if( fcntl( sock_fd, F_GETFD, 0 )!=-1 ) {
     FD_LOG_ERR(( "file descriptor %d already exists", sock_fd ));
@@ -127,6 +136,13 @@ create_udp_socket( int    sock_fd,
     FD_LOG_ERR(( "setsockopt(SOL_SOCKET,SO_RCVBUF,%i) failed (%i-%s)", so_rcvbuf, errno, fd_io_strerror( errno ) ));
   }
 
+  if( udp_gro ) {
+    int gro = 1;
+    if( FD_UNLIKELY( 0!=setsockopt( orig_fd, SOL_UDP, UDP_GRO, &gro, sizeof(int) ) ) ) {
+      FD_LOG_ERR(( "setsockopt(SOL_UDP,UDP_GRO,1) failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    }
+  }
+
   struct sockaddr_in saddr = {
     .sin_family      = AF_INET,
     .sin_addr.s_addr = bind_addr,
@@ -162,6 +178,7 @@ privileged_init( fd_topo_t *      topo,
   struct sockaddr_in * batch_sa   = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct sockaddr_in), STEM_BURST*sizeof(struct sockaddr_in) );
   struct mmsghdr *     batch_msg  = FD_SCRATCH_ALLOC_APPEND( l, alignof(struct mmsghdr),     STEM_BURST*sizeof(struct mmsghdr)     );
   uchar *              tx_scratch = FD_SCRATCH_ALLOC_APPEND( l, FD_CHUNK_ALIGN,              tx_scratch_footprint()                );
+  uchar *              gro_buf    = FD_SCRATCH_ALLOC_APPEND( l, FD_CHUNK_ALIGN,              gro_scratch_footprint( tile )         );
 
   assert( scratch==ctx );
 
@@ -178,6 +195,9 @@ privileged_init( fd_topo_t *      topo,
   ctx->tx_scratch0 = tx_scratch;
   ctx->tx_scratch1 = tx_scratch + tx_scratch_footprint();
   ctx->tx_ptr      = tx_scratch;
+  ctx->udp_gro     = !!tile->sock.udp_gro;
+  ctx->udp_gso     = !!tile->sock.udp_gso;
+  ctx->gro.buf     = ctx->udp_gro ? gro_buf : NULL;
 
   /* Create receive sockets.  Incrementally assign them to file
      descriptors starting at sock_fd_min. */
@@ -236,7 +256,7 @@ privileged_init( fd_topo_t *      topo,
     }
 
     int sock_fd = sock_fd_min + (int)sock_idx;
-    create_udp_socket( sock_fd, tile->sock.net.bind_address, port, tile->sock.so_rcvbuf );
+    create_udp_socket( sock_fd, tile->sock.net.bind_address, port, tile->sock.so_rcvbuf, ctx->udp_gro );
     ctx->pollfd[ sock_idx ].fd     = sock_fd;
     ctx->pollfd[ sock_idx ].events = POLLIN;
     ctx->sock_cnt++;
@@ -299,6 +319,70 @@ unprivileged_init( fd_topo_t *      topo,
 /* FIXME Pace RX polling and interleave it with TX jobs to reduce TX
          tail latency */
 
+/* rx_write_hdrs reconstructs Ethernet, IPv4, and UDP headers in front
+   of a received UDP payload.  Addresses and ports are in network byte
+   order.  Returns a pointer to the Ethernet header. */
+
+static inline uchar *
+rx_write_hdrs( uchar * payload,
+               ulong   payload_sz,
+               uint    saddr,
+               ushort  sport,
+               uint    daddr,
+               ushort  dport ) {
+  fd_eth_hdr_t * eth_hdr    = (fd_eth_hdr_t *)( payload-42UL );
+  fd_ip4_hdr_t * ip_hdr     = (fd_ip4_hdr_t *)( payload-28UL );
+  fd_udp_hdr_t * udp_hdr    = (fd_udp_hdr_t *)( payload- 8UL );
+  memset( eth_hdr->dst, 0, 6 );
+  memset( eth_hdr->src, 0, 6 );
+  eth_hdr->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
+  *ip_hdr = (fd_ip4_hdr_t) {
+    .verihl      = FD_IP4_VERIHL( 4, 5 ),
+    .net_tot_len = fd_ushort_bswap( (ushort)( payload_sz+28UL ) ),
+    .ttl         = 1,
+    .protocol    = FD_IP4_HDR_PROTOCOL_UDP,
+  };
+  memcpy( ip_hdr->saddr_c, &saddr, 4 );
+  memcpy( ip_hdr->daddr_c, &daddr, 4 );
+  *udp_hdr = (fd_udp_hdr_t) {
+    .net_sport = sport,
+    .net_dport = dport,
+    .net_len   = (ushort)fd_ushort_bswap( (ushort)( payload_sz+8UL ) ),
+    .check     = 0
+  };
+  return (uchar *)eth_hdr;
+}
+
+/* rx_publish publishes a received frame located in the dcache of the
+   RX link of sock_idx. */
+
+static inline void
+rx_publish( fd_sock_tile_t *    ctx,
+            fd_stem_context_t * stem,
+            uint                sock_idx,
+            uchar const *       frame,
+            ulong               frame_sz,
+            ulong               sig,
+            ulong               tspub ) {
+  uchar               rx_link = ctx->link_rx_map[ sock_idx ];
+  fd_sock_link_rx_t * link    = ctx->link_rx + rx_link;
+  ctx->metrics.rx_pkt_cnt++;
+
+  /* default for repair intake is to send to [shreds] to shred tile.
+     ping messages should be routed to the repair. */
+  if( FD_UNLIKELY( sock_idx==REPAIR_SHRED_SOCKET_ID && frame_sz==REPAIR_PING_SZ ) ) {
+    uchar repair_rx_link = ctx->link_rx_map[ REPAIR_SHRED_SOCKET_ID+1 ];
+    fd_sock_link_rx_t * repair_link = ctx->link_rx + repair_rx_link;
+    uchar * repair_buf = fd_chunk_to_laddr( repair_link->base, repair_link->chunk );
+    memcpy( repair_buf, frame, frame_sz );
+    fd_stem_publish( stem, repair_rx_link, sig, repair_link->chunk, frame_sz, 0UL, 0UL, tspub );
+    repair_link->chunk = fd_dcache_compact_next( repair_link->chunk, FD_NET_MTU, repair_link->chunk0, repair_link->wmark );
+  } else {
+    ulong chunk = fd_laddr_to_chunk( link->base, frame );
+    fd_stem_publish( stem, rx_link, sig, chunk, frame_sz, 0UL, 0UL, tspub );
+  }
+}
+
 /* poll_rx_socket does one recvmmsg batch receive on the given socket
    index.  Returns the number of packets returned by recvmmsg. */
 
@@ -382,47 +466,14 @@ poll_rx_socket( fd_sock_tile_t *    ctx,
       FD_LOG_ERR(( "Missing IP_PKTINFO on incoming packet" ));
     }
 
-    fd_eth_hdr_t * eth_hdr    = (fd_eth_hdr_t *)( payload-42UL );
-    fd_ip4_hdr_t * ip_hdr     = (fd_ip4_hdr_t *)( payload-28UL );
-    fd_udp_hdr_t * udp_hdr    = (fd_udp_hdr_t *)( payload- 8UL );
-    memset( eth_hdr->dst, 0, 6 );
-    memset( eth_hdr->src, 0, 6 );
-    eth_hdr->net_type = fd_ushort_bswap( FD_ETH_HDR_TYPE_IP );
-    *ip_hdr = (fd_ip4_hdr_t) {
-      .verihl      = FD_IP4_VERIHL( 4, 5 ),
-      .net_tot_len = fd_ushort_bswap( (ushort)( payload_sz+28UL ) ),
-      .ttl         = 1,
-      .protocol    = FD_IP4_HDR_PROTOCOL_UDP,
-    };
-    uint daddr_ = (uint)(ulong)daddr;
-    memcpy( ip_hdr->saddr_c, &sa->sin_addr.s_addr, 4 );
-    memcpy( ip_hdr->daddr_c, &daddr_,              4 );
-    *udp_hdr = (fd_udp_hdr_t) {
-      .net_sport = sa->sin_port,
-      .net_dport = (ushort)fd_ushort_bswap( (ushort)dport ),
-      .net_len   = (ushort)fd_ushort_bswap( (ushort)( payload_sz+8UL ) ),
-      .check     = 0
-    };
-
-    ctx->metrics.rx_pkt_cnt++;
-    ulong chunk = fd_laddr_to_chunk( base, eth_hdr );
+    uchar * frame = rx_write_hdrs( payload, payload_sz,
+                                   sa->sin_addr.s_addr, sa->sin_port,
+                                   (uint)(ulong)daddr, (ushort)fd_ushort_bswap( dport ) );
     ulong sig   = fd_disco_netmux_sig( sa->sin_addr.s_addr, fd_ushort_bswap( sa->sin_port ), 0U, proto, hdr_sz );
     ulong tspub = fd_frag_meta_ts_comp( ts );
+    rx_publish( ctx, stem, sock_idx, frame, frame_sz, sig, tspub );
 
-    /* default for repair intake is to send to [shreds] to shred tile.
-       ping messages should be routed to the repair. */
-    if( FD_UNLIKELY( sock_idx==REPAIR_SHRED_SOCKET_ID && frame_sz==REPAIR_PING_SZ ) ) {
-      uchar repair_rx_link = ctx->link_rx_map[ REPAIR_SHRED_SOCKET_ID+1 ];
-      fd_sock_link_rx_t * repair_link = ctx->link_rx + repair_rx_link;
-      uchar * repair_buf = fd_chunk_to_laddr( repair_link->base, repair_link->chunk );
-      memcpy( repair_buf, eth_hdr, frame_sz );
-      fd_stem_publish( stem, repair_rx_link, sig, repair_link->chunk, frame_sz, 0UL, 0UL, tspub );
-      repair_link->chunk = fd_dcache_compact_next( repair_link->chunk, FD_NET_MTU, repair_link->chunk0, repair_link->wmark );
-    } else {
-      fd_stem_publish( stem, rx_link, sig, chunk, frame_sz, 0UL, 0UL, tspub );
-    }
-
-    last_chunk = chunk;
+    last_chunk = fd_laddr_to_chunk( base, frame );
   }
 
   /* Rewind the chunk index to the first free index. */
@@ -430,6 +481,128 @@ poll_rx_socket( fd_sock_tile_t *    ctx,
   return (ulong)msg_cnt;
 }
 
+/* gro_drain publishes up to STEM_BURST segments of the datagrams
+   pending in the GRO buffers.  Each segment is copied out to the RX
+   link dcache, since coalesced datagrams are larger than an MTU.
+   Returns the number of segments published. */
+
+static ulong
+gro_drain( fd_sock_tile_t *    ctx,
+           fd_stem_context_t * stem ) {
+  ulong  hdr_sz      = sizeof(fd_eth_hdr_t) + sizeof(fd_ip4_hdr_t) + sizeof(fd_udp_hdr_t);
+  ulong  payload_max = FD_NET_MTU-hdr_sz;
+  uint   sock_idx    = ctx->gro.sock_idx;
+  ushort dport       = (ushort)fd_ushort_bswap( ctx->rx_sock_port[ sock_idx ] );
+  uchar  proto       = ctx->proto_id[ sock_idx ];
+  ulong  tspub       = fd_frag_meta_ts_comp( fd_tickcount() );
+
+  fd_sock_link_rx_t * link = ctx->link_rx + ctx->link_rx_map[ sock_idx ];
+
+  ulong pub_cnt = 0UL;
+  while( ctx->gro.msg_idx<ctx->gro.msg_cnt && pub_cnt<STEM_BURST ) {
+    uint    msg_idx = ctx->gro.msg_idx;
+    uint    msg_sz  = ctx->gro.msg_sz[ msg_idx ];
+    uint    seg_off = ctx->gro.seg_off;
+    ulong   seg_sz  = fd_ulong_min( ctx->gro.seg_sz[ msg_idx ], msg_sz-seg_off );
+    uchar * src     = ctx->gro.buf + msg_idx*FD_SOCK_GRO_BUF_SZ + seg_off;
+
+    seg_off += (uint)seg_sz;
+    if( seg_off>=msg_sz ) {
+      ctx->gro.msg_idx = msg_idx+1U;
+      ctx->gro.seg_off = 0U;
+    } else {
+      ctx->gro.seg_off = seg_off;
+    }
+
+    if( FD_UNLIKELY( seg_sz>payload_max ) ) continue; /* unreachable with a 1500 byte MTU */
+
+    uchar * payload = (uchar *)fd_chunk_to_laddr( link->base, link->chunk ) + hdr_sz;
+    fd_memcpy( payload, src, seg_sz );
+    uint    saddr = ctx->gro.saddr[ msg_idx ];
+    ushort  sport = ctx->gro.sport[ msg_idx ];
+    uchar * frame = rx_write_hdrs( payload, seg_sz, saddr, sport, ctx->gro.daddr[ msg_idx ], dport );
+    ulong   sig   = fd_disco_netmux_sig( saddr, fd_ushort_bswap( sport ), 0U, proto, hdr_sz );
+    ctx->metrics.rx_bytes_total += seg_sz+hdr_sz;
+    rx_publish( ctx, stem, sock_idx, frame, seg_sz+hdr_sz, sig, tspub );
+    link->chunk = fd_dcache_compact_next( link->chunk, FD_NET_MTU, link->chunk0, link->wmark );
+    pub_cnt++;
+  }
+  return pub_cnt;
+}
+
+/* poll_rx_socket_gro does one recvmmsg batch receive of coalesced
+   datagrams on the given UDP_GRO socket, and publishes the first burst
+   of segments.  Returns the number of segments published. */
+
+static ulong
+poll_rx_socket_gro( fd_sock_tile_t *    ctx,
+                    fd_stem_context_t * stem,
+                    uint                sock_idx,
+                    int                 sock_fd ) {
+  uchar * cmsg_next = ctx->batch_cmsg;
+  for( ulong j=0UL; j<FD_SOCK_GRO_BATCH; j++ ) {
+    ctx->batch_iov[ j ].iov_base = ctx->gro.buf + j*FD_SOCK_GRO_BUF_SZ;
+    ctx->batch_iov[ j ].iov_len  = FD_SOCK_GRO_BUF_SZ;
+    ctx->batch_msg[ j ].msg_hdr  = (struct msghdr) {
+      .msg_iov        = ctx->batch_iov+j,
+      .msg_iovlen     = 1,
+      .msg_name       = ctx->batch_sa+j,
+      .msg_namelen    = sizeof(struct sockaddr_in),
+      .msg_control    = cmsg_next,
+      .msg_controllen = FD_SOCK_CMSG_MAX,
+    };
+    cmsg_next += FD_SOCK_CMSG_MAX;
+  }
+
+  int msg_cnt = recvmmsg( sock_fd, ctx->batch_msg, FD_SOCK_GRO_BATCH, MSG_DONTWAIT, NULL );
+  if( FD_UNLIKELY( msg_cnt<0 ) ) {
+    if( FD_LIKELY( errno==EAGAIN ) ) return 0UL;
+    /* unreachable if socket is in a valid state */
+    FD_LOG_ERR(( "recvmmsg failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  }
+  ctx->metrics.sys_recvmmsg_cnt++;
+
+  for( ulong j=0; j<(ulong)msg_cnt; j++ ) {
+    struct sockaddr_in * sa     = ctx->batch_msg[ j ].msg_hdr.msg_name;
+    ulong                msg_sz = ctx->batch_msg[ j ].msg_len;
+    if( FD_UNLIKELY( sa->sin_family!=AF_INET ) ) {
+      /* unreachable */
+      FD_LOG_ERR(( "Received packet with unexpected sin_family %i", sa->sin_family ));
+    }
+
+    /* Datagrams that were not coalesced carry no UDP_GRO cmsg */
+    long daddr  = -1;
+    ulong seg_sz = msg_sz;
+    struct cmsghdr * cmsg = CMSG_FIRSTHDR( &ctx->batch_msg[ j ].msg_hdr );
+    while( cmsg ) {
+      if( (cmsg->cmsg_level==IPPROTO_IP) & (cmsg->cmsg_type==IP_PKTINFO) ) {
+        struct in_pktinfo const * pi = (struct in_pktinfo const *)CMSG_DATA( cmsg );
+        daddr = pi->ipi_addr.s_addr;
+      } else if( (cmsg->cmsg_level==SOL_UDP) & (cmsg->cmsg_type==UDP_GRO) ) {
+        seg_sz = (ulong)FD_LOAD( int, CMSG_DATA( cmsg ) );
+      }
+      cmsg = CMSG_NXTHDR( &ctx->batch_msg[ j ].msg_hdr, cmsg );
+    }
+    if( FD_UNLIKELY( daddr<0L ) ) {
+      /* unreachable because IP_PKTINFO was set */
+      FD_LOG_ERR(( "Missing IP_PKTINFO on incoming packet" ));
+    }
+    if( FD_UNLIKELY( !seg_sz ) ) seg_sz = msg_sz; /* zero-length datagram */
+
+    ctx->gro.saddr [ j ] = sa->sin_addr.s_addr;
+    ctx->gro.sport [ j ] = sa->sin_port;
+    ctx->gro.daddr [ j ] = (uint)(ulong)daddr;
+    ctx->gro.seg_sz[ j ] = (uint)seg_sz;
+    ctx->gro.msg_sz[ j ] = (uint)msg_sz;
+  }
+
+  ctx->gro.sock_idx = sock_idx;
+  ctx->gro.msg_cnt  = (uint)fd_int_max( msg_cnt, 0 );
+  ctx->gro.msg_idx  = 0U;
+  ctx->gro.seg_off  = 0U;
+  return gro_drain( ctx, stem );
+}
+
 static ulong
 poll_rx( fd_sock_tile_t *    ctx,
          fd_stem_context_t * stem ) {
@@ -443,13 +616,20 @@ poll_rx( fd_sock_tile_t *    ctx,
   }
   for( uint j=0UL; j<ctx->sock_cnt; j++ ) {
     if( ctx->pollfd[ j ].revents & (POLLIN|POLLERR) ) {
-      pkt_cnt += poll_rx_socket(
-        ctx,
-        stem,
-        j,
-        ctx->pollfd[ j ].fd,
-        ctx->proto_id[ j ]
-      );
+      if( ctx->udp_gro ) {
+        pkt_cnt += poll_rx_socket_gro( ctx, stem, j, ctx->pollfd[ j ].fd );
+        /* Leave the other sockets for the next poll if the GRO buffers
+           are still in use */
+        if( ctx->gro.msg_idx<ctx->gro.msg_cnt ) break;
+      } else {
+        pkt_cnt += poll_rx_socket(
+          ctx,
+          stem,
+          j,
+          ctx->pollfd[ j ].fd,
+          ctx->proto_id[ j ]
+        );
+      }
     }
     ctx->pollfd[ j ].revents = 0;
   }
@@ -458,11 +638,43 @@ poll_rx( fd_sock_tile_t *    ctx,
 
 /* TX PATH (tango->socket) ********************************************/
 
+/* tx_sendmmsg_err records a failed sendmmsg call in metrics. */
+
 static void
-flush_tx_batch( fd_sock_tile_t * ctx ) {
-  ulong batch_cnt = ctx->batch_cnt;
-  for( int j = 0; j < (int)batch_cnt; /* incremented in loop */ ) {
-    int remain   = (int)batch_cnt - j;
+tx_sendmmsg_err( fd_sock_tile_t * ctx,
+                 int              err ) {
+  switch( err ) {
+  case EAGAIN:
+  case ENOBUFS:
+    ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_SLOW_IDX ]++;
+    break;
+  case EPERM:
+    ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_PERM_IDX ]++;
+    break;
+  case ENETUNREACH:
+  case EHOSTUNREACH:
+    ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_UNREACH_IDX ]++;
+    break;
+  case ENONET:
+  case ENETDOWN:
+  case EHOSTDOWN:
+    ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_DOWN_IDX ]++;
+    break;
+  default:
+    ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_OTHER_IDX ]++;
+    /* log with NOTICE, since flushing has a significant negative performance impact */
+    FD_LOG_NOTICE(( "sendmmsg failed (%i-%s)", err, fd_io_strerror( err ) ));
+  }
+}
+
+/* tx_send_raw sends batch messages [j0,j1) via the SOCK_RAW socket. */
+
+static void
+tx_send_raw( fd_sock_tile_t * ctx,
+             ulong            j0,
+             ulong            j1 ) {
+  for( int j = (int)j0; j < (int)j1; /* incremented in loop */ ) {
+    int remain   = (int)j1 - j;
     int send_cnt = sendmmsg( ctx->tx_sock, ctx->batch_msg + j, (uint)remain, MSG_DONTWAIT );
     if( send_cnt>=0 ) {
       ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_NO_ERROR_IDX ]++;
@@ -470,28 +682,7 @@ flush_tx_batch( fd_sock_tile_t * ctx ) {
     if( FD_UNLIKELY( send_cnt < remain ) ) {
       ctx->metrics.tx_drop_cnt++;
       if( FD_UNLIKELY( send_cnt < 0 ) ) {
-        switch( errno ) {
-        case EAGAIN:
-        case ENOBUFS:
-          ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_SLOW_IDX ]++;
-          break;
-        case EPERM:
-          ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_PERM_IDX ]++;
-          break;
-        case ENETUNREACH:
-        case EHOSTUNREACH:
-          ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_UNREACH_IDX ]++;
-          break;
-        case ENONET:
-        case ENETDOWN:
-        case EHOSTDOWN:
-          ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_DOWN_IDX ]++;
-          break;
-        default:
-          ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_OTHER_IDX ]++;
-          /* log with NOTICE, since flushing has a significant negative performance impact */
-          FD_LOG_NOTICE(( "sendmmsg failed (%i-%s)", errno, fd_io_strerror( errno ) ));
-        }
+        tx_sendmmsg_err( ctx, errno );
 
         /* first message failed, so skip failing message and continue */
         j++;
@@ -506,10 +697,145 @@ flush_tx_batch( fd_sock_tile_t * ctx ) {
       continue;
     }
 
-    /* send_cnt == batch_cnt, so we sent everything */
+    /* send_cnt == remain, so we sent everything */
     ctx->metrics.tx_pkt_cnt += (ulong)send_cnt;
     break;
   }
+}
+
+/* TX_UDP_HDR returns the UDP header of batch message j (written to the
+   start of the message buffer by during_frag). */
+
+#define TX_UDP_HDR( ctx, j ) ((fd_udp_hdr_t const *)(ctx)->batch_iov[ (j) ].iov_base)
+#define TX_PKTINFO( ctx, j ) ((struct in_pktinfo const *)CMSG_DATA( (struct cmsghdr *)( (ulong)(ctx)->batch_cmsg + (j)*FD_SOCK_CMSG_MAX ) ))
+
+/* tx_gso_run returns the length of the run of batch messages starting
+   at j0 (and ending before j1) that can be sent as one UDP_SEGMENT
+   datagram.  A run shares source port, destination and source address.
+   All segments but the last have the same size, and the last is not
+   larger.  The source port must be bound by an RX socket, whose index
+   is written to *sock_idx.  Returns 1 if no run can be formed. */
+
+static ulong
+tx_gso_run( fd_sock_tile_t const * ctx,
+            ulong                  j0,
+            ulong                  j1,
+            uint *                 sock_idx ) {
+  fd_udp_hdr_t const *      udp0 = TX_UDP_HDR( ctx, j0 );
+  struct in_pktinfo const * pi0  = TX_PKTINFO( ctx, j0 );
+  ushort sport = fd_ushort_bswap( udp0->net_sport );
+  uint   i;
+  for( i=0U; i<ctx->sock_cnt; i++ ) {
+    if( ctx->rx_sock_port[ i ]==sport ) break;
+  }
+  if( i==ctx->sock_cnt ) return 1UL;
+  *sock_idx = i;
+
+  ulong seg_sz = ctx->batch_iov[ j0 ].iov_len - sizeof(fd_udp_hdr_t);
+  if( FD_UNLIKELY( !seg_sz ) ) return 1UL;
+  ulong tot_sz = seg_sz;
+  ulong j;
+  for( j=j0+1UL; j<j1; j++ ) {
+    fd_udp_hdr_t const *      udp = TX_UDP_HDR( ctx, j );
+    struct in_pktinfo const * pi  = TX_PKTINFO( ctx, j );
+    ulong sz = ctx->batch_iov[ j ].iov_len - sizeof(fd_udp_hdr_t);
+    if( ( udp->net_sport                 != udp0->net_sport                    ) |
+        ( udp->net_dport                 != udp0->net_dport                    ) |
+        ( ctx->batch_sa[ j ].sin_addr.s_addr != ctx->batch_sa[ j0 ].sin_addr.s_addr ) |
+        ( pi->ipi_spec_dst.s_addr        != pi0->ipi_spec_dst.s_addr           ) |
+        ( sz>seg_sz ) | ( !sz ) | ( tot_sz+sz>FD_SOCK_GSO_SZ_MAX ) ) break;
+    tot_sz += sz;
+    if( sz<seg_sz ) { j++; break; } /* short segment ends the run */
+  }
+  return j-j0;
+}
+
+/* tx_send_gso sends batch messages [j0,j1) as one UDP_SEGMENT datagram
+   via the UDP socket with index sock_idx.  The kernel (or the NIC)
+   splits it into j1-j0 datagrams.  The UDP headers staged in the batch
+   are skipped, since the UDP socket generates its own. */
+
+static void
+tx_send_gso( fd_sock_tile_t * ctx,
+             ulong            j0,
+             ulong            j1,
+             uint             sock_idx ) {
+  for( ulong j=j0; j<j1; j++ ) {
+    ctx->batch_iov[ j ].iov_base = (uchar *)ctx->batch_iov[ j ].iov_base + sizeof(fd_udp_hdr_t);
+    ctx->batch_iov[ j ].iov_len -= sizeof(fd_udp_hdr_t);
+  }
+
+  struct sockaddr_in sa = ctx->batch_sa[ j0 ];
+  sa.sin_port = ((fd_udp_hdr_t const *)ctx->batch_iov[ j0 ].iov_base - 1)->net_dport;
+
+  union {
+    uchar          buf[ CMSG_SPACE( sizeof(struct in_pktinfo) ) + CMSG_SPACE( sizeof(ushort) ) ];
+    struct cmsghdr align;
+  } cmsg_buf;
+  fd_memset( &cmsg_buf, 0, sizeof(cmsg_buf) );
+
+  struct mmsghdr msg = {
+    .msg_hdr = {
+      .msg_name       = &sa,
+      .msg_namelen    = sizeof(struct sockaddr_in),
+      .msg_iov        = ctx->batch_iov + j0,
+      .msg_iovlen     = j1-j0,
+      .msg_control    = cmsg_buf.buf,
+      .msg_controllen = sizeof(cmsg_buf.buf)
+    }
+  };
+  struct cmsghdr * cmsg = CMSG_FIRSTHDR( &msg.msg_hdr );
+  cmsg->cmsg_level = IPPROTO_IP;
+  cmsg->cmsg_type  = IP_PKTINFO;
+  cmsg->cmsg_len   = CMSG_LEN( sizeof(struct in_pktinfo) );
+  memcpy( CMSG_DATA( cmsg ), TX_PKTINFO( ctx, j0 ), sizeof(struct in_pktinfo) );
+  cmsg = CMSG_NXTHDR( &msg.msg_hdr, cmsg );
+  cmsg->cmsg_level = SOL_UDP;
+  cmsg->cmsg_type  = UDP_SEGMENT;
+  cmsg->cmsg_len   = CMSG_LEN( sizeof(ushort) );
+  FD_STORE( ushort, CMSG_DATA( cmsg ), (ushort)ctx->batch_iov[ j0 ].iov_len );
+
+  int send_cnt = sendmmsg( ctx->pollfd[ sock_idx ].fd, &msg, 1U, MSG_DONTWAIT );
+  if( FD_LIKELY( send_cnt==1 ) ) {
+    ctx->metrics.sys_sendmmsg_cnt[ FD_METRICS_ENUM_SOCK_ERR_V_NO_ERROR_IDX ]++;
+    ctx->metrics.tx_pkt_cnt += j1-j0;
+    return;
+  }
+
+  int err = errno;
+  ctx->metrics.tx_drop_cnt++;
+  tx_sendmmsg_err( ctx, err );
+  if( FD_UNLIKELY( err==EIO ) ) {
+    /* Device lacks checksum offload required for segmentation */
+    FD_LOG_WARNING(( "UDP_SEGMENT not supported by device, disabling [net.socket.udp_gso]" ));
+    ctx->udp_gso = 0;
+  }
+}
+
+#undef TX_UDP_HDR
+#undef TX_PKTINFO
+
+static void
+flush_tx_batch( fd_sock_tile_t * ctx ) {
+  ulong batch_cnt = ctx->batch_cnt;
+  if( !ctx->udp_gso ) {
+    tx_send_raw( ctx, 0UL, batch_cnt );
+  } else {
+    /* Send runs of packets with the same flow via GSO, and everything
+       else via the raw socket, without reordering */
+    ulong raw0 = 0UL;
+    ulong j    = 0UL;
+    while( j<batch_cnt ) {
+      uint  sock_idx = 0U;
+      ulong run      = tx_gso_run( ctx, j, batch_cnt, &sock_idx );
+      if( run<2UL ) { j++; continue; }
+      if( raw0<j ) tx_send_raw( ctx, raw0, j );
+      tx_send_gso( ctx, j, j+run, sock_idx );
+      j   += run;
+      raw0 = j;
+    }
+    if( raw0<batch_cnt ) tx_send_raw( ctx, raw0, batch_cnt );
+  }
 
   ctx->tx_ptr = ctx->tx_scratch0;
   ctx->batch_cnt = 0;
@@ -644,7 +970,11 @@ after_credit( fd_sock_tile_t *    ctx,
               fd_stem_context_t * stem,
               int *               poll_in FD_PARAM_UNUSED,
               int *               charge_busy ) {
-  if( ctx->tx_idle_cnt > 512 ) {
+  if( FD_UNLIKELY( ctx->gro.msg_idx<ctx->gro.msg_cnt ) ) {
+    /* Publish segments of previously received GRO datagrams first */
+    ulong pkt_cnt = gro_drain( ctx, stem );
+    *charge_busy = pkt_cnt!=0;
+  } else if( ctx->tx_idle_cnt > 512 ) {
     if( ctx->batch_cnt ) {
       flush_tx_batch( ctx );
     }
@@ -23,6 +23,19 @@
 
 #define MAX_NET_OUTS (5UL)
 
+/* FD_SOCK_GRO_BATCH is the number of coalesced datagrams received per
+   recvmmsg call if UDP_GRO is enabled.  The kernel coalesces at most 64
+   segments into one datagram, which is at most FD_SOCK_GRO_BUF_SZ
+   bytes large. */
+
+#define FD_SOCK_GRO_BATCH  (8UL)
+#define FD_SOCK_GRO_BUF_SZ (65536UL)
+
+/* FD_SOCK_GSO_SZ_MAX is the max UDP payload size of a datagram sent with
+   UDP_SEGMENT (before segmentation). */
+
+#define FD_SOCK_GSO_SZ_MAX (65507UL)
+
 /* Local metrics.  Periodically copied to the metric_in shm region. */
 
 struct fd_sock_tile_metrics {
@@ -67,6 +80,26 @@ struct fd_sock_tile {
   uint tx_idle_cnt;
   uint bind_address;
 
+  /* Segmentation offloads (see [net.socket] config) */
+  int  udp_gro;
+  int  udp_gso;
+
+  /* UDP_GRO receive buffers.  Coalesced datagrams are split up and
+     published at most STEM_BURST segments at a time.  Segments not yet
+     published are pending in [msg_idx,msg_cnt). */
+  struct {
+    uchar *            buf;     /* FD_SOCK_GRO_BATCH*FD_SOCK_GRO_BUF_SZ bytes */
+    uint               sock_idx;
+    uint               msg_cnt;
+    uint               msg_idx;
+    uint               seg_off; /* byte offset into datagram msg_idx */
+    uint               saddr   [ FD_SOCK_GRO_BATCH ];
+    uint               daddr   [ FD_SOCK_GRO_BATCH ];
+    ushort             sport   [ FD_SOCK_GRO_BATCH ]; /* net order */
+    uint               seg_sz  [ FD_SOCK_GRO_BATCH ];
+    uint               msg_sz  [ FD_SOCK_GRO_BATCH ];
+  } gro;
+
   /* RX/TX batches
      FIXME transpose arrays for better cache locality? */
   ulong                batch_cnt; /* <=STEM_BURST */
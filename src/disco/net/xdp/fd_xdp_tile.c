@@ -642,6 +642,7 @@ before_frag( fd_net_ctx_t * ctx,
   uint target_idx   = hash % net_tile_cnt;
 
   uint dst_ip = fd_disco_netmux_sig_dst_ip( sig );
+  ctx->tx_op.use_gre = 0; /* set by net_tx_route */
   if( FD_UNLIKELY( !net_tx_route( ctx, dst_ip ) ) ) {
     return 1; /* metrics incremented by net_tx_route */
   }
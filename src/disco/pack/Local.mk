@@ -19,5 +19,6 @@ ifdef FD_HAS_HOSTED
 $(call make-fuzz-test,fuzz_compute_budget_program_parse,fuzz_compute_budget_program_parse,fd_ballet fd_util)
 $(call make-unit-test,test_pack,test_pack,fd_disco fd_ballet fd_util)
 $(call run-unit-test,test_pack)
+$(call make-unit-test,bench_pack_replay,bench_pack_replay,fd_ballet fd_disco fd_tango fd_util)
 endif
 endif
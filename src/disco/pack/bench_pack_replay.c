@@ -0,0 +1,572 @@
+/* bench_pack_replay drives fd_pack offline with a recorded stream of
+   the resolved transactions the pack tile receives and a simple model
+   of bank execution time, so pack parameters (bank tile count,
+   pack_depth, block limits, pacing strategy, scheduling policy) can be
+   evaluated against real traffic instead of synthetic transactions.
+
+   The capture is in the archiver format: a sequence of frags, each an
+   fd_archiver_frag_header_t with tile_id FD_ARCHIVER_TILE_ID_PACK
+   followed by sz bytes of a resolved fd_txn_m_t (payload, fd_txn_t and
+   expanded address lookup tables), exactly as it arrives at the pack
+   tile on the resolv_pack link.  The frag sig is the reference slot of
+   the transaction, and ns_since_prev_fragment gives the arrival times.
+   Frags from other tiles are skipped, so the archive of a validator
+   running with [tiles.archiver] enabled and capture_pack set can be
+   replayed as is.
+
+   Without --capture, a synthetic capture is generated (and written to
+   --dump if given, so it can be replayed later or edited).  The
+   synthetic stream has a configurable fraction of transactions writing
+   a small set of hot accounts.
+
+   Time is simulated.  Each block lasts --slot-ns.  A bank executes a
+   microblock in cost*--ns-per-cu + --microblock-ns, and asks pack for
+   another one as soon as it is done (subject to pacing with
+   --strategy balanced).  At the end of each slot, the banks finish
+   their outstanding microblocks and then the block is ended.  Only the
+   schedule calls themselves run in real time; their latency is
+   measured with fd_tickcount.
+
+   Reported: fees captured and CU fill per block, schedule call latency
+   percentiles, and the percentiles of how long scheduled transactions
+   waited in pack (from arrival to being scheduled). */
+
+#include "fd_pack.h"
+#include "fd_pack_cost.h"
+#include <math.h> /* for fd_pack_pacing.h */
+#include "fd_pack_pacing.h"
+#include "fd_compute_budget_program.h"
+#include "../fd_txn_m_t.h"
+#include "../archiver/fd_archiver.h"
+#include "../metrics/fd_metrics.h"
+
+#if FD_HAS_HOSTED
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define SORT_NAME        sort_ulong
+#define SORT_KEY_T       ulong
+#define SORT_BEFORE(a,b) ((a)<(b))
+#include "../../util/tmpl/fd_sort.c"
+
+#define BENCH_TAG (1UL)
+
+static uchar metrics_scratch[ FD_METRICS_FOOTPRINT( 0, 0 ) ] __attribute__((aligned(FD_METRICS_ALIGN)));
+
+/* Same as the pack tile */
+#define TRANSACTION_LIFETIME_SLOTS 160UL
+
+static uchar const work_program_id[ FD_TXN_ACCT_ADDR_SZ ] = "Bench Work Program Id Does Stuff";
+
+/* Synthetic capture ***************************************************/
+
+/* synth_acct writes the address of account idx of class cls (0: fee
+   payer, 1: hot writable, 2: cold writable, 3: readonly) to p. */
+
+static void
+synth_acct( uchar * p,
+            ulong   cls,
+            ulong   idx ) {
+  fd_memset( p, 0, FD_TXN_ACCT_ADDR_SZ );
+  FD_STORE( ulong, p,      fd_ulong_hash( (cls<<56) ^ idx ) | 1UL ); /* Never all zero */
+  FD_STORE( ulong, p+8UL,  cls                                    );
+  FD_STORE( ulong, p+16UL, idx                                    );
+}
+
+/* synth_txn serializes a legacy transaction with a unique fee payer and
+   signature (from txn_idx), writable accounts chosen according to the
+   hot account parameters, a few readonly accounts, and compute budget
+   instructions requesting cu_limit CUs at a priority of cu_price
+   micro-lamports per CU.  Returns the payload size. */
+
+static ulong
+synth_txn( uchar *    payload,
+           ulong      txn_idx,
+           fd_rng_t * rng,
+           ulong      hot_cnt,
+           float      hot_frac,
+           uint       cu_limit,
+           ulong      cu_price ) {
+  ulong w_cnt = 1UL + fd_rng_ulong_roll( rng, 3UL );
+  ulong r_cnt = fd_rng_ulong_roll( rng, 4UL );
+  int   hot   = (hot_cnt>0UL) & (fd_rng_float_c0( rng )<hot_frac);
+
+  uchar * p = payload;
+  *(p++) = 1; /* signature cnt */
+  FD_STORE( ulong, p, txn_idx ); fd_memset( p+8UL, 0x5a, FD_TXN_SIGNATURE_SZ-8UL ); p += FD_TXN_SIGNATURE_SZ;
+
+  ulong acct_cnt = 1UL + w_cnt + r_cnt + 2UL;
+  *(p++) = 1;                   /* signatures required */
+  *(p++) = 0;                   /* readonly signed */
+  *(p++) = (uchar)(r_cnt+2UL);  /* readonly unsigned */
+  *(p++) = (uchar)acct_cnt;     /* < 128, so one byte compact-u16 */
+
+  synth_acct( p, 0UL, txn_idx ); p += FD_TXN_ACCT_ADDR_SZ;
+  for( ulong i=0UL; i<w_cnt; i++ ) {
+    /* The first writable account is a hot one for hot transactions.
+       The others are drawn from a large pool, so they rarely
+       conflict. */
+    if( hot & (i==0UL) ) synth_acct( p, 1UL, fd_rng_ulong_roll( rng, hot_cnt ) );
+    else                 synth_acct( p, 2UL, fd_rng_ulong( rng )                );
+    p += FD_TXN_ACCT_ADDR_SZ;
+  }
+  for( ulong i=0UL; i<r_cnt; i++ ) { synth_acct( p, 3UL, fd_rng_ulong_roll( rng, 64UL ) ); p += FD_TXN_ACCT_ADDR_SZ; }
+  ulong cb_idx   = 1UL + w_cnt + r_cnt;
+  ulong work_idx = cb_idx + 1UL;
+  fd_memcpy( p, FD_COMPUTE_BUDGET_PROGRAM_ID, FD_TXN_ACCT_ADDR_SZ ); p += FD_TXN_ACCT_ADDR_SZ;
+  fd_memcpy( p, work_program_id,              FD_TXN_ACCT_ADDR_SZ ); p += FD_TXN_ACCT_ADDR_SZ;
+
+  fd_memset( p, 0x42, 32UL ); p += 32UL; /* recent blockhash */
+
+  *(p++) = 3; /* instruction cnt */
+  /* SetComputeUnitLimit */
+  *(p++) = (uchar)cb_idx; *(p++) = 0; *(p++) = 5; *(p++) = 2; FD_STORE( uint,  p, cu_limit ); p += sizeof(uint);
+  /* SetComputeUnitPrice */
+  *(p++) = (uchar)cb_idx; *(p++) = 0; *(p++) = 9; *(p++) = 3; FD_STORE( ulong, p, cu_price ); p += sizeof(ulong);
+  /* The actual work, referencing every non-program account */
+  *(p++) = (uchar)work_idx;
+  *(p++) = (uchar)(acct_cnt-2UL);
+  for( ulong i=0UL; i<acct_cnt-2UL; i++ ) *(p++) = (uchar)i;
+  *(p++) = 0; /* data sz */
+
+  return (ulong)(p-payload);
+}
+
+/* synth_capture writes a capture of txn_cnt synthetic transactions
+   arriving at tps transactions per second to out. */
+
+static void
+synth_capture( FILE *     out,
+               fd_rng_t * rng,
+               ulong      txn_cnt,
+               ulong      tps,
+               ulong      slot_ns,
+               ulong      hot_cnt,
+               float      hot_frac ) {
+  static uchar buf[ FD_TPU_RESOLVED_MTU ] __attribute__((aligned(alignof(fd_txn_m_t))));
+  fd_txn_m_t * txnm = (fd_txn_m_t *)buf;
+
+  ulong now_ns  = 0UL;
+  ulong mean_ns = 1000000000UL/fd_ulong_max( tps, 1UL );
+  for( ulong i=0UL; i<txn_cnt; i++ ) {
+    /* Exponential interarrival times */
+    ulong gap = (ulong)(-(double)mean_ns * log( 1.0 - (double)fd_rng_double_c0( rng ) ));
+    now_ns += gap;
+
+    /* Mostly small transactions with a long tail, and priority fees
+       spread over a few orders of magnitude */
+    uint  cu_limit = (uint)fd_ulong_min( 1400000UL, 1000UL + (ulong)(-30000.0 * log( 1.0 - (double)fd_rng_double_c0( rng ) )) );
+    ulong cu_price = (ulong)pow( 10.0, 6.0*(double)fd_rng_double_c0( rng ) );
+
+    fd_memset( txnm, 0, sizeof(fd_txn_m_t) );
+    uchar * payload = fd_txn_m_payload( txnm );
+    ulong payload_sz = synth_txn( payload, i, rng, hot_cnt, hot_frac, cu_limit, cu_price );
+    txnm->payload_sz     = (ushort)payload_sz;
+    txnm->reference_slot = now_ns/slot_ns;
+    fd_txn_t * txn = fd_txn_m_txn_t( txnm );
+    ulong txn_t_sz = fd_txn_parse( payload, payload_sz, txn, NULL );
+    if( FD_UNLIKELY( !txn_t_sz ) ) FD_LOG_ERR(( "synthetic transaction %lu failed to parse", i ));
+    txnm->txn_t_sz = (ushort)txn_t_sz;
+
+    ulong sz = fd_txn_m_realized_footprint( txnm, 1, 1 );
+    fd_archiver_frag_header_t hdr = {
+      .magic                  = FD_ARCHIVER_HEADER_MAGIC,
+      .version                = FD_ARCHIVER_HEADER_VERSION,
+      .tile_id                = FD_ARCHIVER_TILE_ID_PACK,
+      .ns_since_prev_fragment = gap,
+      .sz                     = sz,
+      .sig                    = txnm->reference_slot,
+      .seq                    = i,
+    };
+    if( FD_UNLIKELY( 1UL!=fwrite( &hdr, FD_ARCHIVER_FRAG_HEADER_FOOTPRINT, 1UL, out ) ||
+                     1UL!=fwrite( txnm, sz,                                1UL, out ) ) ) {
+      FD_LOG_ERR(( "fwrite failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    }
+  }
+  FD_TEST( !fflush( out ) );
+}
+
+/* Capture reader ******************************************************/
+
+struct capture {
+  FILE * file;
+  ulong  frag_cnt;
+  ulong  skip_cnt;
+  ulong  bundle_skip_cnt;
+
+  /* The next transaction, if have_next */
+  int    have_next;
+  ulong  next_ns;  /* Arrival time */
+  ulong  next_sig;
+  uchar  next[ FD_TPU_RESOLVED_MTU ] __attribute__((aligned(alignof(fd_txn_m_t))));
+};
+typedef struct capture capture_t;
+
+/* capture_advance reads the next pack transaction from the capture.
+   Returns 1 on success and 0 at the end of the capture. */
+
+static int
+capture_advance( capture_t * cap ) {
+  cap->have_next = 0;
+  for(;;) {
+    fd_archiver_frag_header_t hdr;
+    if( FD_UNLIKELY( 1UL!=fread( &hdr, FD_ARCHIVER_FRAG_HEADER_FOOTPRINT, 1UL, cap->file ) ) ) return 0;
+    if( FD_UNLIKELY( hdr.magic!=FD_ARCHIVER_HEADER_MAGIC ) ) FD_LOG_ERR(( "capture corrupt at frag %lu (bad magic)", cap->frag_cnt ));
+    cap->frag_cnt++;
+    cap->next_ns += hdr.ns_since_prev_fragment;
+
+    if( FD_UNLIKELY( (hdr.tile_id!=FD_ARCHIVER_TILE_ID_PACK) | (hdr.sz>FD_TPU_RESOLVED_MTU) ) ) {
+      if( FD_UNLIKELY( fseek( cap->file, (long)hdr.sz, SEEK_CUR ) ) ) return 0;
+      cap->skip_cnt++;
+      continue;
+    }
+    if( FD_UNLIKELY( 1UL!=fread( cap->next, hdr.sz, 1UL, cap->file ) ) ) return 0;
+
+    fd_txn_m_t const * txnm = (fd_txn_m_t const *)cap->next;
+    if( FD_UNLIKELY( (txnm->payload_sz>FD_TPU_MTU) | (txnm->txn_t_sz>FD_TXN_MAX_SZ) ) ) {
+      FD_LOG_ERR(( "capture corrupt at frag %lu (bad txn)", cap->frag_cnt ));
+    }
+    /* Bundles need a block engine to be meaningful.  Skip them. */
+    if( FD_UNLIKELY( txnm->block_engine.bundle_id ) ) { cap->bundle_skip_cnt++; continue; }
+
+    cap->next_sig  = hdr.sig;
+    cap->have_next = 1;
+    return 1;
+  }
+}
+
+/* Simulation **********************************************************/
+
+struct bench_cfg {
+  ulong bank_cnt;
+  int   balanced;
+  ulong slot_ns;
+  ulong slot_max;
+  float ns_per_cu;
+  ulong microblock_ns;
+  ulong txn_per_microblock;
+  fd_pack_limits_t limits[1];
+};
+typedef struct bench_cfg bench_cfg_t;
+
+struct bench_stats {
+  ulong   block_cnt;
+  ulong   fees;          /* lamports, all blocks */
+  ulong   cus;           /* cost units, all blocks */
+  ulong   min_block_cus;
+  ulong   txn_cnt;
+  ulong   microblock_cnt;
+  ulong   insert_cnt;
+  ulong   insert_reject_cnt;
+  ulong   expire_cnt;
+
+  ulong * sched_lat;     /* ticks, indexed [0, sched_lat_cnt) */
+  ulong   sched_lat_cnt;
+  ulong   sched_lat_max;
+  ulong * wait;          /* ns, indexed [0, wait_cnt) */
+  ulong   wait_cnt;
+  ulong   wait_max;
+};
+typedef struct bench_stats bench_stats_t;
+
+static void
+run( bench_cfg_t const * cfg,
+     capture_t *         cap,
+     fd_pack_t *         pack,
+     bench_stats_t *     stats ) {
+  static fd_txn_p_t out[ MAX_TXN_PER_MICROBLOCK ];
+
+  ulong bank_free_at[ FD_PACK_MAX_BANK_TILES ];
+  ulong bank_fees   [ FD_PACK_MAX_BANK_TILES ];
+  int   bank_busy   [ FD_PACK_MAX_BANK_TILES ];
+  for( ulong b=0UL; b<cfg->bank_cnt; b++ ) { bank_free_at[ b ] = 0UL; bank_fees[ b ] = 0UL; bank_busy[ b ] = 0; }
+
+  fd_pack_pacing_t pacer[1];
+  fd_pack_pacing_init( pacer, 0L, (long)cfg->slot_ns, 1.0f, cfg->limits->max_cost_per_block );
+
+  ulong now           = 0UL;
+  ulong slot_end      = cfg->slot_ns;
+  int   ending        = 0;
+  ulong block_fees    = 0UL;
+  ulong highest_slot  = 0UL;
+
+  stats->min_block_cus = ULONG_MAX;
+
+  capture_advance( cap );
+
+  while( stats->block_cnt<cfg->slot_max ) {
+    /* Advance to the next event */
+    ulong next = ending ? ULONG_MAX : slot_end;
+    if( cap->have_next ) next = fd_ulong_min( next, cap->next_ns );
+    int any_busy = 0;
+    for( ulong b=0UL; b<cfg->bank_cnt; b++ ) if( bank_busy[ b ] ) { next = fd_ulong_min( next, bank_free_at[ b ] ); any_busy = 1; }
+    if( FD_UNLIKELY( !cap->have_next & !any_busy & !fd_pack_avail_txn_cnt( pack ) ) ) break; /* Nothing left to do */
+    now = fd_ulong_max( now, next );
+
+    /* Completions */
+    for( ulong b=0UL; b<cfg->bank_cnt; b++ ) {
+      if( !bank_busy[ b ] || bank_free_at[ b ]>now ) continue;
+      fd_pack_microblock_complete( pack, b );
+      block_fees     += bank_fees[ b ];
+      bank_busy[ b ]  = 0;
+    }
+    any_busy = 0;
+    for( ulong b=0UL; b<cfg->bank_cnt; b++ ) any_busy |= bank_busy[ b ];
+
+    /* Arrivals */
+    while( cap->have_next && cap->next_ns<=now ) {
+      fd_txn_m_t * txnm = (fd_txn_m_t *)cap->next;
+      if( FD_UNLIKELY( cap->next_sig>highest_slot ) ) {
+        highest_slot = cap->next_sig;
+        stats->expire_cnt += fd_pack_expire_before( pack, fd_ulong_max( highest_slot, TRANSACTION_LIFETIME_SLOTS )-TRANSACTION_LIFETIME_SLOTS );
+      }
+      fd_txn_t const * txn = fd_txn_m_txn_t( txnm );
+      fd_txn_e_t * spot = fd_pack_insert_txn_init( pack );
+      fd_memcpy( spot->txnp->payload, fd_txn_m_payload( txnm ), txnm->payload_sz );
+      fd_memcpy( TXN(spot->txnp),     txn,                      txnm->txn_t_sz   );
+      fd_memcpy( spot->alt_accts,     fd_txn_m_alut( txnm ),    32UL*txn->addr_table_adtl_cnt );
+      spot->txnp->payload_sz                   = txnm->payload_sz;
+      spot->txnp->scheduler_arrival_time_nanos = (long)cap->next_ns;
+      int result = fd_pack_insert_txn_fini( pack, spot, cap->next_sig );
+      stats->insert_cnt++;
+      stats->insert_reject_cnt += (ulong)(result<0);
+      capture_advance( cap );
+    }
+
+    /* Slot boundary: stop scheduling, and end the block once the banks
+       have drained. */
+    if( FD_UNLIKELY( !ending & (now>=slot_end) ) ) ending = 1;
+    if( FD_UNLIKELY( ending & !any_busy ) ) {
+      ulong block_cus = fd_pack_current_block_cost( pack );
+      /* Once the capture is exhausted, whatever pack could not schedule
+         in a whole block (e.g. transactions parked in penalty treaps,
+         which only get promoted as conflicting transactions complete)
+         is never going to be scheduled. */
+      if( FD_UNLIKELY( !cap->have_next & !block_cus ) ) break;
+      stats->fees         += block_fees;
+      stats->cus          += block_cus;
+      stats->min_block_cus = fd_ulong_min( stats->min_block_cus, block_cus );
+      stats->block_cnt++;
+      fd_pack_end_block( pack );
+      block_fees = 0UL;
+      ending     = 0;
+      /* The next slot started at slot_end, but if the banks were still
+         busy, we lost some time. */
+      fd_pack_pacing_init( pacer, (long)slot_end, (long)(slot_end+cfg->slot_ns), 1.0f, cfg->limits->max_cost_per_block );
+      slot_end += cfg->slot_ns;
+      now       = fd_ulong_max( now, slot_end-cfg->slot_ns );
+      continue;
+    }
+    if( ending ) continue;
+
+    /* Give work to the idle banks */
+    fd_pack_pacing_update_consumed_cus( pacer, fd_pack_current_block_cost( pack ), (long)now );
+    ulong pacing_bank_cnt = fd_pack_pacing_enabled_bank_cnt( pacer, (long)now );
+    for( ulong b=0UL; b<cfg->bank_cnt; b++ ) {
+      if( bank_busy[ b ] ) continue;
+      int flags = FD_PACK_SCHEDULE_VOTE | FD_PACK_SCHEDULE_BUNDLE;
+      if( !cfg->balanced || b<pacing_bank_cnt ) flags |= FD_PACK_SCHEDULE_TXN;
+
+      long lat = -fd_tickcount();
+      ulong txn_cnt = fd_pack_schedule_next_microblock( pack, cfg->txn_per_microblock*1600000UL, 1.0f, b, flags, out );
+      lat += fd_tickcount();
+      stats->sched_lat[ stats->sched_lat_cnt++ % stats->sched_lat_max ] = (ulong)fd_long_max( lat, 0L );
+      if( !txn_cnt ) continue;
+
+      ulong cost = 0UL;
+      ulong fees = 0UL;
+      for( ulong i=0UL; i<txn_cnt; i++ ) {
+        fd_txn_t const * txn = TXN(out+i);
+        cost += out[ i ].pack_cu.requested_exec_plus_acct_data_cus + out[ i ].pack_cu.non_execution_cus;
+        uint  txn_flags;
+        ulong priority_fee = 0UL;
+        fd_pack_compute_cost( txn, out[ i ].payload, &txn_flags, NULL, &priority_fee, NULL, NULL );
+        fees += priority_fee + FD_PACK_FEE_PER_SIGNATURE*txn->signature_cnt;
+        stats->wait[ stats->wait_cnt++ % stats->wait_max ] = now-(ulong)out[ i ].scheduler_arrival_time_nanos;
+      }
+      stats->txn_cnt        += txn_cnt;
+      stats->microblock_cnt += 1UL;
+      bank_fees   [ b ] = fees;
+      bank_busy   [ b ] = 1;
+      bank_free_at[ b ] = now + (ulong)((float)cost*cfg->ns_per_cu) + cfg->microblock_ns;
+    }
+  }
+}
+
+static ulong
+pctile( ulong const * sorted,
+        ulong         cnt,
+        double        p ) {
+  if( FD_UNLIKELY( !cnt ) ) return 0UL;
+  return sorted[ fd_ulong_min( (ulong)(p*(double)cnt), cnt-1UL ) ];
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz     = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--page-sz",      NULL,      "gigantic" );
+  ulong        page_cnt     = fd_env_strip_cmdline_ulong ( &argc, &argv, "--page-cnt",     NULL,             1UL );
+  ulong        near_cpu     = fd_env_strip_cmdline_ulong ( &argc, &argv, "--near-cpu",     NULL, fd_log_cpu_id() );
+  char const * capture_path = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--capture",      NULL,            NULL );
+  char const * dump_path    = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--dump",         NULL,            NULL );
+  ulong        bank_cnt     = fd_env_strip_cmdline_ulong ( &argc, &argv, "--bank-cnt",     NULL,             4UL );
+  ulong        pack_depth   = fd_env_strip_cmdline_ulong ( &argc, &argv, "--pack-depth",   NULL,          4096UL );
+  char const * _policy      = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--policy",       NULL,        "greedy" );
+  char const * _strategy    = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--strategy",     NULL,          "perf" );
+  ulong        slot_ns      = fd_env_strip_cmdline_ulong ( &argc, &argv, "--slot-ns",      NULL,      400000000UL );
+  ulong        slot_max     = fd_env_strip_cmdline_ulong ( &argc, &argv, "--slot-max",     NULL,       ULONG_MAX );
+  float        ns_per_cu    = fd_env_strip_cmdline_float ( &argc, &argv, "--ns-per-cu",    NULL,            9.0f );
+  ulong        mblk_ns      = fd_env_strip_cmdline_ulong ( &argc, &argv, "--microblock-ns", NULL,        20000UL );
+  ulong        txn_per_mblk = fd_env_strip_cmdline_ulong ( &argc, &argv, "--txn-per-microblock", NULL,    31UL );
+  ulong        max_cost     = fd_env_strip_cmdline_ulong ( &argc, &argv, "--max-cost-per-block", NULL, FD_PACK_MAX_COST_PER_BLOCK_LOWER_BOUND );
+  ulong        synth_cnt    = fd_env_strip_cmdline_ulong ( &argc, &argv, "--synth-txn-cnt", NULL,       400000UL );
+  ulong        synth_tps    = fd_env_strip_cmdline_ulong ( &argc, &argv, "--synth-tps",    NULL,          10000UL );
+  ulong        synth_hot    = fd_env_strip_cmdline_ulong ( &argc, &argv, "--synth-hot-cnt", NULL,           16UL );
+  float        synth_hot_f  = fd_env_strip_cmdline_float ( &argc, &argv, "--synth-hot-frac", NULL,          0.3f );
+  uint         rng_seed     = fd_env_strip_cmdline_uint  ( &argc, &argv, "--rng-seed",     NULL,           1234U );
+  ulong        sample_max   = fd_env_strip_cmdline_ulong ( &argc, &argv, "--sample-max",   NULL,      1UL<<20    );
+
+  int sched_policy;
+  if(      !strcmp( _policy, "greedy"         ) ) sched_policy = FD_PACK_SCHED_POLICY_GREEDY;
+  else if( !strcmp( _policy, "conflict_graph" ) ) sched_policy = FD_PACK_SCHED_POLICY_CONFLICT_GRAPH;
+  else FD_LOG_ERR(( "unknown --policy %s (greedy or conflict_graph)", _policy ));
+
+  int balanced;
+  if(      !strcmp( _strategy, "perf"     ) ) balanced = 0;
+  else if( !strcmp( _strategy, "balanced" ) ) balanced = 1;
+  else FD_LOG_ERR(( "unknown --strategy %s (perf or balanced)", _strategy ));
+
+  if( FD_UNLIKELY( (!bank_cnt) | (bank_cnt>FD_PACK_MAX_BANK_TILES) ) ) FD_LOG_ERR(( "--bank-cnt must be in [1,%lu]", FD_PACK_MAX_BANK_TILES ));
+  if( FD_UNLIKELY( (!txn_per_mblk) | (txn_per_mblk>MAX_TXN_PER_MICROBLOCK) ) ) FD_LOG_ERR(( "--txn-per-microblock must be in [1,%lu]", MAX_TXN_PER_MICROBLOCK ));
+  if( FD_UNLIKELY( !slot_ns ) ) FD_LOG_ERR(( "--slot-ns must be positive" ));
+
+  bench_cfg_t cfg[1] = {{
+    .bank_cnt           = bank_cnt,
+    .balanced           = balanced,
+    .slot_ns            = slot_ns,
+    .slot_max           = slot_max,
+    .ns_per_cu          = ns_per_cu,
+    .microblock_ns      = mblk_ns,
+    .txn_per_microblock = txn_per_mblk,
+    .limits             = {{
+      .max_cost_per_block        = max_cost,
+      .max_vote_cost_per_block   = FD_PACK_MAX_VOTE_COST_PER_BLOCK_LOWER_BOUND,
+      .max_write_cost_per_acct   = FD_PACK_MAX_WRITE_COST_PER_ACCT_LOWER_BOUND,
+      .max_data_bytes_per_block  = FD_PACK_MAX_DATA_PER_BLOCK,
+      .max_txn_per_microblock    = txn_per_mblk,
+      .max_microblocks_per_block = (ulong)UINT_MAX,
+    }},
+  }};
+
+  fd_metrics_register( (ulong *)fd_metrics_new( metrics_scratch, 0UL, 0UL ) );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, rng_seed, 0UL ) );
+
+  /* Open or synthesize the capture */
+
+  capture_t * cap = (capture_t *)aligned_alloc( alignof(capture_t), sizeof(capture_t) );
+  FD_TEST( cap );
+  fd_memset( cap, 0, sizeof(capture_t) );
+  if( capture_path ) {
+    cap->file = fopen( capture_path, "rb" );
+    if( FD_UNLIKELY( !cap->file ) ) FD_LOG_ERR(( "fopen(%s) failed (%i-%s)", capture_path, errno, fd_io_strerror( errno ) ));
+    FD_LOG_NOTICE(( "Replaying capture %s", capture_path ));
+  } else {
+    cap->file = dump_path ? fopen( dump_path, "w+b" ) : tmpfile();
+    if( FD_UNLIKELY( !cap->file ) ) FD_LOG_ERR(( "opening synthetic capture failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    FD_LOG_NOTICE(( "Synthesizing capture (--synth-txn-cnt %lu --synth-tps %lu --synth-hot-cnt %lu --synth-hot-frac %.2f%s%s)",
+                    synth_cnt, synth_tps, synth_hot, (double)synth_hot_f, dump_path ? " --dump " : "", dump_path ? dump_path : "" ));
+    synth_capture( cap->file, rng, synth_cnt, synth_tps, slot_ns, synth_hot, synth_hot_f );
+    rewind( cap->file );
+  }
+
+  /* Create the pack object */
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  ulong footprint = fd_pack_footprint( pack_depth, 0UL, bank_cnt, cfg->limits );
+  if( FD_UNLIKELY( !footprint ) ) FD_LOG_ERR(( "invalid pack parameters" ));
+  void * mem = fd_wksp_alloc_laddr( wksp, fd_pack_align(), footprint, BENCH_TAG );
+  if( FD_UNLIKELY( !mem ) ) FD_LOG_ERR(( "pack needs %lu bytes, increase --page-cnt", footprint ));
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( mem, pack_depth, 0UL, bank_cnt, cfg->limits, sched_policy, rng ) );
+  FD_TEST( pack );
+  fd_pack_set_initializer_bundles_ready( pack );
+
+  bench_stats_t stats[1] = {{ 0 }};
+  stats->sched_lat_max = sample_max;
+  stats->wait_max      = sample_max;
+  stats->sched_lat     = fd_wksp_alloc_laddr( wksp, alignof(ulong), sample_max*sizeof(ulong), BENCH_TAG );
+  stats->wait          = fd_wksp_alloc_laddr( wksp, alignof(ulong), sample_max*sizeof(ulong), BENCH_TAG );
+  if( FD_UNLIKELY( !stats->sched_lat || !stats->wait ) ) FD_LOG_ERR(( "sample buffers don't fit, decrease --sample-max or increase --page-cnt" ));
+
+  FD_LOG_NOTICE(( "Simulating (--bank-cnt %lu --pack-depth %lu --policy %s --strategy %s --slot-ns %lu --ns-per-cu %.1f "
+                  "--microblock-ns %lu --txn-per-microblock %lu --max-cost-per-block %lu)",
+                  bank_cnt, pack_depth, _policy, _strategy, slot_ns, (double)ns_per_cu, mblk_ns, txn_per_mblk, max_cost ));
+
+  long dt = -fd_log_wallclock();
+  run( cfg, cap, pack, stats );
+  dt += fd_log_wallclock();
+
+  /* Report */
+
+  ulong lat_cnt  = fd_ulong_min( stats->sched_lat_cnt, sample_max );
+  ulong wait_cnt = fd_ulong_min( stats->wait_cnt,      sample_max );
+  sort_ulong_inplace( stats->sched_lat, lat_cnt  );
+  sort_ulong_inplace( stats->wait,      wait_cnt );
+  double tick_per_ns = fd_tempo_tick_per_ns( NULL );
+  double blocks      = (double)fd_ulong_max( stats->block_cnt, 1UL );
+
+  FD_LOG_NOTICE(( "capture: %lu frags, %lu skipped (not pack), %lu bundle txns skipped",
+                  cap->frag_cnt, cap->skip_cnt, cap->bundle_skip_cnt ));
+  FD_LOG_NOTICE(( "inserted %lu txns (%lu rejected, %lu expired), scheduled %lu txns in %lu microblocks, %lu left unscheduled",
+                  stats->insert_cnt, stats->insert_reject_cnt, stats->expire_cnt, stats->txn_cnt, stats->microblock_cnt,
+                  fd_pack_avail_txn_cnt( pack ) ));
+  FD_LOG_NOTICE(( "blocks: %lu, fees %.0f lamports/block, CU fill %.1f%% avg %.1f%% min",
+                  stats->block_cnt, (double)stats->fees/blocks,
+                  100.0*(double)stats->cus/(blocks*(double)max_cost),
+                  100.0*(double)(stats->block_cnt ? stats->min_block_cus : 0UL)/(double)max_cost ));
+  FD_LOG_NOTICE(( "schedule call latency (ns): p50 %.0f p90 %.0f p99 %.0f p99.9 %.0f max %.0f (%lu calls%s)",
+                  (double)pctile( stats->sched_lat, lat_cnt, 0.5   )/tick_per_ns,
+                  (double)pctile( stats->sched_lat, lat_cnt, 0.9   )/tick_per_ns,
+                  (double)pctile( stats->sched_lat, lat_cnt, 0.99  )/tick_per_ns,
+                  (double)pctile( stats->sched_lat, lat_cnt, 0.999 )/tick_per_ns,
+                  (double)(lat_cnt ? stats->sched_lat[ lat_cnt-1UL ] : 0UL)/tick_per_ns,
+                  stats->sched_lat_cnt, stats->sched_lat_cnt>sample_max ? ", sampled" : "" ));
+  FD_LOG_NOTICE(( "txn wait in pack (us): p50 %.1f p90 %.1f p99 %.1f p99.9 %.1f max %.1f",
+                  (double)pctile( stats->wait, wait_cnt, 0.5   )/1e3,
+                  (double)pctile( stats->wait, wait_cnt, 0.9   )/1e3,
+                  (double)pctile( stats->wait, wait_cnt, 0.99  )/1e3,
+                  (double)pctile( stats->wait, wait_cnt, 0.999 )/1e3,
+                  (double)(wait_cnt ? stats->wait[ wait_cnt-1UL ] : 0UL)/1e3 ));
+  FD_LOG_NOTICE(( "simulation took %.2fs", (double)dt/1e9 ));
+
+  fd_wksp_free_laddr( stats->wait      );
+  fd_wksp_free_laddr( stats->sched_lat );
+  fd_wksp_free_laddr( fd_pack_delete( fd_pack_leave( pack ) ) );
+  fd_wksp_delete_anonymous( wksp );
+  FD_TEST( !fclose( cap->file ) );
+  free( cap );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
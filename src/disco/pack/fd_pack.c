@@ -84,6 +84,10 @@ struct fd_pack_private_ord_txn {
      the compressed slot reaches a new value.  skip is never 0. */
   ushort skip;
 
+  /* est_tag: fd_pack_cost_est_tag of the transaction, used to look up
+     its learned cost in cost_est_tbl. */
+  uint   est_tag;
+
   FD_PACK_BITSET_DECLARE( rw_bitset ); /* all accts this txn references */
   FD_PACK_BITSET_DECLARE(  w_bitset ); /* accts this txn write-locks    */
 
@@ -133,6 +137,14 @@ FD_STATIC_ASSERT( offsetof( fd_pack_ord_txn_t, txn_e->txnp  )==0UL, fd_pack_ord_
    writer cost map instead of only removing the elements we increased. */
 #define DEFAULT_WRITTEN_LIST_MAX 16384UL
 
+/* Parameters of the table that learns the cost transactions actually
+   consume from the rebate reports (see fd_pack_set_cost_estimation).
+   Transactions are charged the learned mean plus
+   FD_PACK_COST_EST_SIGMAS standard deviations. */
+#define FD_PACK_COST_EST_BIN_CNT 4096UL
+#define FD_PACK_COST_EST_HISTORY  256UL
+#define FD_PACK_COST_EST_SIGMAS   2.0
+
 /* fd_pack_addr_use_t: Used for three distinct purposes:
     -  to record that an address is in use and can't be used again until
          certain microblocks finish execution
@@ -481,6 +493,21 @@ typedef struct fd_pack_penalty_treap fd_pack_penalty_treap_t;
    on rebates. */
 #define FD_PACK_SKIP_CNT 5UL
 
+/* FD_PACK_CG_SCAN_MAX: How many of the highest priority pending
+   transactions the conflict graph policy examines when looking for
+   transactions on a critical chain.  Bounds the extra work per
+   microblock. */
+#define FD_PACK_CG_SCAN_MAX 128UL
+
+/* FD_PACK_SCHED_BATCH: fd_pack_schedule_impl walks the treap in blocks
+   of this many candidates and checks the whole block against the
+   in-use bitsets at once.  Most candidates in a busy treap conflict, so
+   this is where most of the scheduling time goes.  Larger blocks
+   amortize better, but the work done for candidates after the point
+   where the microblock fills up is wasted. */
+#define FD_PACK_SCHED_BATCH 16UL
+FD_STATIC_ASSERT( FD_PACK_SCHED_BATCH<=FD_PACK_BITSET_BATCH_MAX, sched_batch );
+
 /* Finally, we can now declare the main pack data structure */
 struct fd_pack_private {
   ulong      pack_depth;
@@ -496,6 +523,20 @@ struct fd_pack_private {
                                      far ? */
   fd_rng_t * rng;
 
+  /* sched_policy: one of FD_PACK_SCHED_POLICY_*.  See fd_pack.h. */
+  int        sched_policy;
+
+  /* cost_est_tbl: learns the cost that transactions with a given
+     est_tag actually consume.  cost_est is cost_est_tbl if
+     cost_est_enabled is set and NULL otherwise.  cost_est_saved is the
+     sum of cost_est_saved_by_bank, where cost_est_saved_by_bank[i] is
+     how many fewer CUs than requested we expect the outstanding
+     microblock on bank i to consume. */
+  fd_est_tbl_t * cost_est_tbl;
+  fd_est_tbl_t * cost_est;
+  int            cost_est_enabled;
+  ulong          cost_est_saved;
+
   ulong      cumulative_block_cost;
   ulong      cumulative_vote_cost;
 
@@ -639,6 +680,7 @@ struct fd_pack_private {
   fd_pack_addr_use_t * use_by_bank    [ FD_PACK_MAX_BANK_TILES ];
   ulong                use_by_bank_cnt[ FD_PACK_MAX_BANK_TILES ];
   ulong *              use_by_bank_txn[ FD_PACK_MAX_BANK_TILES ];
+  ulong                cost_est_saved_by_bank[ FD_PACK_MAX_BANK_TILES ];
 
   fd_histf_t txn_per_microblock [ 1 ];
   fd_histf_t vote_per_microblock[ 1 ];
@@ -729,6 +771,7 @@ fd_pack_footprint( ulong                    pack_depth,
   l = FD_LAYOUT_APPEND( l, 32UL,                sizeof(ulong)*max_txn_in_flight                 ); /* use_by_bank_txn*/
   l = FD_LAYOUT_APPEND( l, bitset_map_align(),  bitset_map_footprint( lg_acct_in_trp          ) ); /* acct_to_bitset */
   l = FD_LAYOUT_APPEND( l, 64UL,                (pack_depth+extra_depth)*bundle_meta_sz         ); /* bundle_meta */
+  l = FD_LAYOUT_APPEND( l, fd_est_tbl_align(),  fd_est_tbl_footprint( FD_PACK_COST_EST_BIN_CNT ) ); /* cost_est_tbl */
   return FD_LAYOUT_FINI( l, FD_PACK_ALIGN );
 }
 
@@ -738,8 +781,14 @@ fd_pack_new( void                   * mem,
              ulong                    bundle_meta_sz,
              ulong                    bank_tile_cnt,
              fd_pack_limits_t const * limits,
+             int                      sched_policy,
              fd_rng_t               * rng           ) {
 
+  if( FD_UNLIKELY( (sched_policy!=FD_PACK_SCHED_POLICY_GREEDY) & (sched_policy!=FD_PACK_SCHED_POLICY_CONFLICT_GRAPH) ) ) {
+    FD_LOG_WARNING(( "unknown sched_policy %i", sched_policy ));
+    return NULL;
+  }
+
   int enable_bundles = !!bundle_meta_sz;
   ulong extra_depth        = fd_ulong_if( enable_bundles, 1UL+2UL*FD_PACK_MAX_TXN_PER_BUNDLE, 1UL );
   ulong max_acct_in_treap  = pack_depth * FD_TXN_ACCT_ADDR_MAX;
@@ -779,6 +828,7 @@ fd_pack_new( void                   * mem,
   void * _use_by_txn  = FD_SCRATCH_ALLOC_APPEND( l,  32UL,                sizeof(ulong)*max_txn_in_flight               );
   void * _acct_bitset = FD_SCRATCH_ALLOC_APPEND( l,  bitset_map_align(),  bitset_map_footprint( lg_acct_in_trp        ) );
   void * bundle_meta  = FD_SCRATCH_ALLOC_APPEND( l,  64UL,                (pack_depth+extra_depth)*bundle_meta_sz       );
+  void * _cost_est    = FD_SCRATCH_ALLOC_APPEND( l,  fd_est_tbl_align(),  fd_est_tbl_footprint( FD_PACK_COST_EST_BIN_CNT ) );
 
   pack->pack_depth                  = pack_depth;
   pack->bundle_meta_sz              = bundle_meta_sz;
@@ -788,11 +838,18 @@ fd_pack_new( void                   * mem,
   pack->microblock_cnt              = 0UL;
   pack->data_bytes_consumed         = 0UL;
   pack->rng                         = rng;
+  pack->sched_policy                = sched_policy;
   pack->cumulative_block_cost       = 0UL;
   pack->cumulative_vote_cost        = 0UL;
   pack->expire_before               = 0UL;
   pack->outstanding_microblock_mask = 0UL;
   pack->cumulative_rebated_cus      = 0UL;
+  pack->cost_est_enabled            = 0;
+  pack->cost_est_saved              = 0UL;
+
+  /* A bin that hasn't seen any observations gives UINT_MAX, which is
+     more than the requested cost of any transaction. */
+  fd_est_tbl_new( _cost_est, FD_PACK_COST_EST_BIN_CNT, FD_PACK_COST_EST_HISTORY, UINT_MAX );
 
 
   trp_pool_new(  _pool,        pack_depth+extra_depth );
@@ -840,11 +897,13 @@ fd_pack_new( void                   * mem,
     pack->use_by_bank_cnt[i] = 0UL;
     pack->use_by_bank_txn[i] = use_by_bank_txn + i*max_txn_per_mblk;
     pack->use_by_bank_txn[i][0] = 0UL;
+    pack->cost_est_saved_by_bank[i] = 0UL;
   }
   for( ulong i=bank_tile_cnt; i<FD_PACK_MAX_BANK_TILES; i++ ) {
     pack->use_by_bank    [i] = NULL;
     pack->use_by_bank_cnt[i] = 0UL;
     pack->use_by_bank_txn[i] = NULL;
+    pack->cost_est_saved_by_bank[i] = 0UL;
   }
 
   fd_histf_new( pack->txn_per_microblock,  FD_MHIST_MIN( PACK, TOTAL_TRANSACTIONS_PER_MICROBLOCK_COUNT ),
@@ -918,6 +977,8 @@ fd_pack_join( void * mem ) {
   /* */                                  FD_SCRATCH_ALLOC_APPEND( l, 32UL,               sizeof(ulong)*max_txn_in_flight                    );
   pack->acct_to_bitset= bitset_map_join( FD_SCRATCH_ALLOC_APPEND( l, bitset_map_align(), bitset_map_footprint( lg_acct_in_trp           ) ) );
   /* */                                  FD_SCRATCH_ALLOC_APPEND( l, 64UL,               (pack_depth+extra_depth)*pack->bundle_meta_sz      );
+  pack->cost_est_tbl = fd_est_tbl_join(  FD_SCRATCH_ALLOC_APPEND( l, fd_est_tbl_align(), fd_est_tbl_footprint( FD_PACK_COST_EST_BIN_CNT ) ) );
+  pack->cost_est     = pack->cost_est_enabled ? pack->cost_est_tbl : NULL;
 
   FD_MGAUGE_SET( PACK, PENDING_TRANSACTIONS_HEAP_SIZE, pack->pack_depth );
   return pack;
@@ -945,12 +1006,7 @@ fd_pack_estimate_rewards_and_compute( fd_txn_e_t        * txne,
   sig_rewards += FD_PACK_FEE_PER_SIGNATURE * precompile_sigs;
   sig_rewards = sig_rewards * FD_PACK_TXN_FEE_BURN_PCT / 100UL;
 
-  /* No fancy CU estimation in this version of pack
-  for( ulong i=0UL; i<(ulong)txn->instr_cnt; i++ ) {
-    uchar prog_id_idx = txn->instr[ i ].program_id;
-    fd_acct_addr_t const * acct_addr = fd_txn_get_acct_addrs( txn, txnp->payload ) + (ulong)prog_id_idx;
-  }
-  */
+  out->est_tag                              = fd_pack_cost_est_tag( txn, txne->txnp->payload );
   out->rewards                              = (priority_rewards < (UINT_MAX - sig_rewards)) ? (uint)(sig_rewards + priority_rewards) : UINT_MAX;
   out->compute_est                          = (uint)cost_estimate;
   out->txn->pack_cu.requested_exec_plus_acct_data_cus = (uint)(requested_execution_cus + requested_loaded_accounts_data_cost);
@@ -1740,6 +1796,24 @@ typedef struct {
   ulong bytes_scheduled;
 } sched_return_t;
 
+/* fd_pack_cost_est_cus returns the cost we expect cur to actually
+   consume: the cost learned for its est_tag plus a margin, but no more
+   than it requested and no less than its non-execution cost.  Returns
+   the requested cost if cost estimation is disabled or cur is a simple
+   vote, which is charged a fixed cost anyway. */
+static inline ulong
+fd_pack_cost_est_cus( fd_pack_t         const * pack,
+                      fd_pack_ord_txn_t const * cur ) {
+  ulong requested = (ulong)cur->compute_est;
+  if( FD_LIKELY( !pack->cost_est ) || (cur->txn->flags & FD_TXN_P_FLAGS_IS_SIMPLE_VOTE) ) return requested;
+
+  double var;
+  double mean = fd_est_tbl_estimate( pack->cost_est, (ulong)cur->est_tag, &var );
+  double est  = ceil( mean + FD_PACK_COST_EST_SIGMAS*sqrt( var ) );
+  if( FD_UNLIKELY( !(est<(double)requested) ) ) return requested;
+  return fd_ulong_max( (ulong)est, (ulong)cur->txn->pack_cu.non_execution_cus );
+}
+
 static inline sched_return_t
 fd_pack_schedule_impl( fd_pack_t          * pack,
                        treap_t            * sched_from,
@@ -1749,6 +1823,8 @@ fd_pack_schedule_impl( fd_pack_t          * pack,
                        ulong                bank_tile,
                        fd_pack_smallest_t * smallest_in_treap,
                        ulong              * use_by_bank_txn,
+                       ulong const        * cand,
+                       ulong                cand_cnt,
                        fd_txn_p_t         * out ) {
 
   fd_pack_ord_txn_t  * pool         = pack->pool;
@@ -1787,28 +1863,78 @@ fd_pack_schedule_impl( fd_pack_t          * pack,
   ulong min_cus   = ULONG_MAX;
   ulong min_bytes = ULONG_MAX;
 
-  if( FD_UNLIKELY( (cu_limit<smallest_in_treap->cus) | (txn_limit==0UL) | (byte_limit<smallest_in_treap->bytes) ) ) {
+  /* With cost estimation, cu_limit is charged the cost we expect each
+     transaction to consume, but the block limit is still charged the
+     requested cost, since that's all we can be sure of.  blk_limit is
+     what's left of the block limit.  Otherwise, the caller made sure
+     cu_limit<=blk_limit, so checking blk_limit is a no-op.  The
+     smallest requested cost doesn't bound the smallest expected cost,
+     but every transaction is expected to cost at least
+     FD_PACK_MIN_TXN_COST. */
+  ulong est_saved    = 0UL;
+  ulong blk_limit    = fd_ulong_sat_sub( pack->lim->max_cost_per_block, pack->cumulative_block_cost );
+  ulong smallest_cus = fd_ulong_if( !!pack->cost_est, FD_PACK_MIN_TXN_COST, smallest_in_treap->cus );
+
+  if( FD_UNLIKELY( (cu_limit<smallest_cus) | (blk_limit<smallest_in_treap->cus) | (txn_limit==0UL) | (byte_limit<smallest_in_treap->bytes) ) ) {
     sched_return_t to_return = { .cus_scheduled = 0UL, .txns_scheduled = 0UL, .bytes_scheduled = 0UL };
     return to_return;
   }
 
-  treap_rev_iter_t prev = treap_idx_null();
-  for( treap_rev_iter_t _cur=treap_rev_iter_init( sched_from, pool ); !treap_rev_iter_done( _cur ); _cur=prev ) {
-    /* Capture next so that we can delete while we iterate. */
-    prev = treap_rev_iter_next( _cur, pool );
+  /* If cand is non-NULL, only consider the cand_cnt transactions (pool
+     indices of elements of sched_from) in cand, in the order given,
+     instead of walking all of sched_from.
+
+     Candidates are taken FD_PACK_SCHED_BATCH at a time into batch_idx,
+     and batch_conflict has bit i set if batch_idx[i] conflicts with the
+     in-use bitsets as of when the batch was taken.  Bits only get
+     added to the in-use bitsets as we go, except for bits that are
+     released because no pending transaction references the account any
+     more, so a transaction that conflicted then still conflicts now.
+     Ones that didn't conflict then get checked again before we take
+     them.  We only delete the transaction we are looking at, so the
+     rest of the batch and the iterator stay valid. */
+  ulong            cand_i = 0UL;
+  treap_rev_iter_t next   = cand ? fd_ulong_if( !!cand_cnt, cand[ 0 ], treap_idx_null() ) : treap_rev_iter_init( sched_from, pool );
+  ulong            batch_idx[ FD_PACK_SCHED_BATCH ];
+  ulong            batch_cnt      = 0UL;
+  ulong            batch_i        = 0UL;
+  ulong            batch_conflict = 0UL;
+  for(;;) {
+    if( FD_UNLIKELY( batch_i==batch_cnt ) ) {
+      FD_PACK_BITSET_CPTR_T batch_w [ FD_PACK_SCHED_BATCH ];
+      FD_PACK_BITSET_CPTR_T batch_rw[ FD_PACK_SCHED_BATCH ];
+      batch_cnt = 0UL;
+      batch_i   = 0UL;
+      while( (batch_cnt<FD_PACK_SCHED_BATCH) & !treap_rev_iter_done( next ) ) {
+        fd_pack_ord_txn_t const * ele = treap_rev_iter_ele_const( next, pool );
+        batch_w  [ batch_cnt ] = FD_PACK_BITSET_ADDR( ele->w_bitset  );
+        batch_rw [ batch_cnt ] = FD_PACK_BITSET_ADDR( ele->rw_bitset );
+        batch_idx[ batch_cnt ] = next;
+        batch_cnt++;
+        if( FD_UNLIKELY( cand ) ) next = (++cand_i<cand_cnt) ? cand[ cand_i ] : treap_idx_null();
+        else                      next = treap_rev_iter_next( next, pool );
+      }
+      if( FD_UNLIKELY( !batch_cnt ) ) break;
 
-#   if FD_HAS_X86
-    _mm_prefetch( &(pool[ prev ].prev),      _MM_HINT_T0 );
-#   endif
+#     if FD_HAS_X86
+      _mm_prefetch( &(pool[ next ].prev),      _MM_HINT_T0 );
+#     endif
 
-    fd_pack_ord_txn_t * cur = treap_rev_iter_ele( _cur, pool );
+      batch_conflict = FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH( bitset_rw_in_use, bitset_w_in_use, batch_w, batch_rw, batch_cnt );
+    }
+
+    treap_rev_iter_t    _cur           = batch_idx[ batch_i ];
+    int                 known_conflict = (int)((batch_conflict>>batch_i) & 1UL);
+    fd_pack_ord_txn_t * cur            = treap_rev_iter_ele( _cur, pool );
+    batch_i++;
 
     min_cus   = fd_ulong_min( min_cus,   cur->compute_est     );
     min_bytes = fd_ulong_min( min_bytes, cur->txn->payload_sz );
 
     ulong conflicts = 0UL;
+    ulong est_cus   = fd_pack_cost_est_cus( pack, cur );
 
-    if( FD_UNLIKELY( cur->compute_est>cu_limit ) ) {
+    if( FD_UNLIKELY( (est_cus>cu_limit) | (cur->compute_est>blk_limit) ) ) {
       /* Too big to be scheduled at the moment, but might be okay for
          the next microblock, so we don't want to delay it. */
       cu_limit_c++;
@@ -1816,7 +1942,8 @@ fd_pack_schedule_impl( fd_pack_t          * pack,
     }
 
     /* Likely? Unlikely? */
-    if( FD_LIKELY( !FD_PACK_BITSET_INTERSECT4_EMPTY( bitset_rw_in_use, bitset_w_in_use, cur->w_bitset, cur->rw_bitset ) ) ) {
+    if( FD_LIKELY( known_conflict ) ||
+        FD_UNLIKELY( !FD_PACK_BITSET_INTERSECT4_EMPTY( bitset_rw_in_use, bitset_w_in_use, cur->w_bitset, cur->rw_bitset ) ) ) {
       fast_path++;
       continue;
     }
@@ -2006,7 +2133,8 @@ fd_pack_schedule_impl( fd_pack_t          * pack,
     }
 
     txns_scheduled  += 1UL;                      txn_limit       -= 1UL;
-    cus_scheduled   += cur->compute_est;         cu_limit        -= cur->compute_est;
+    cus_scheduled   += cur->compute_est;         cu_limit        -= est_cus;
+    est_saved       += cur->compute_est-est_cus; blk_limit       -= cur->compute_est;
     bytes_scheduled += cur->txn->payload_sz;     byte_limit      -= cur->txn->payload_sz;
 
     *(use_by_bank_txn++) = use_by_bank_cnt;
@@ -2020,7 +2148,7 @@ fd_pack_schedule_impl( fd_pack_t          * pack,
     trp_pool_idx_release( pool, _cur );
     pack->pending_txn_cnt--;
 
-    if( FD_UNLIKELY( (cu_limit<smallest_in_treap->cus) | (txn_limit==0UL) | (byte_limit<smallest_in_treap->bytes) ) ) break;
+    if( FD_UNLIKELY( (cu_limit<smallest_cus) | (blk_limit<smallest_in_treap->cus) | (txn_limit==0UL) | (byte_limit<smallest_in_treap->bytes) ) ) break;
   }
 
   FD_MCNT_INC( PACK, TRANSACTION_SCHEDULE_TAKEN,      txns_scheduled );
@@ -2033,7 +2161,7 @@ fd_pack_schedule_impl( fd_pack_t          * pack,
 
   /* If we scanned the whole treap and didn't break early, we now have a
      better estimate of the smallest. */
-  if( FD_UNLIKELY( treap_rev_iter_done( prev ) ) ) {
+  if( FD_UNLIKELY( !cand && (batch_i==batch_cnt) && treap_rev_iter_done( next ) ) ) {
     smallest_in_treap->cus   = min_cus;
     smallest_in_treap->bytes = min_bytes;
   }
@@ -2044,10 +2172,61 @@ fd_pack_schedule_impl( fd_pack_t          * pack,
 
   pack->written_list_cnt = written_list_cnt;
 
+  pack->cost_est_saved_by_bank[ bank_tile ] += est_saved;
+  pack->cost_est_saved                      += est_saved;
+
   sched_return_t to_return = { .cus_scheduled=cus_scheduled, .txns_scheduled=txns_scheduled, .bytes_scheduled=bytes_scheduled };
   return to_return;
 }
 
+/* fd_pack_cg_critical_scan implements the candidate selection of
+   FD_PACK_SCHED_POLICY_CONFLICT_GRAPH.  It walks up to
+   FD_PACK_CG_SCAN_MAX of the highest priority transactions in
+   pack->pending and stores the pool indices of those that write to an
+   account on a critical chain (see fd_pack.h) and could plausibly be
+   scheduled now in cand, in decreasing priority order.  Stops after
+   txn_limit candidates.  Returns the number of candidates stored.  The
+   checks here are just a filter; fd_pack_schedule_impl re-checks
+   everything. */
+static ulong
+fd_pack_cg_critical_scan( fd_pack_t * pack,
+                          ulong       cu_limit,
+                          ulong       txn_limit,
+                          ulong       byte_limit,
+                          ulong       cand[ static FD_PACK_CG_SCAN_MAX ] ) {
+  fd_pack_ord_txn_t * pool = pack->pool;
+
+  ulong pending_cnt    = pack->pending_txn_cnt;
+  ulong bank_tile_cnt  = pack->bank_tile_cnt;
+  ulong cand_max       = fd_ulong_min( txn_limit, FD_PACK_CG_SCAN_MAX );
+  ulong cand_cnt       = 0UL;
+  ulong scan_cnt       = 0UL;
+
+  for( treap_rev_iter_t _cur=treap_rev_iter_init( pack->pending, pool );
+       !treap_rev_iter_done( _cur ) & (scan_cnt<FD_PACK_CG_SCAN_MAX) & (cand_cnt<cand_max);
+       _cur=treap_rev_iter_next( _cur, pool ) ) {
+    scan_cnt++;
+    fd_pack_ord_txn_t * cur = treap_rev_iter_ele( _cur, pool );
+
+    if( FD_UNLIKELY( (cur->compute_est>cu_limit) | (cur->txn->payload_sz>byte_limit) ) ) continue;
+    if( FD_UNLIKELY( cur->skip==pack->compressed_slot_number ) ) continue;
+    if( FD_LIKELY( !FD_PACK_BITSET_INTERSECT4_EMPTY( pack->bitset_rw_in_use, pack->bitset_w_in_use, cur->w_bitset, cur->rw_bitset ) ) ) continue;
+
+    fd_txn_t const * txn = TXN(cur->txn);
+    fd_acct_addr_t const * accts   = fd_txn_get_acct_addrs( txn, cur->txn->payload );
+    fd_acct_addr_t const * alt_adj = cur->txn_e->alt_accts - fd_txn_account_cnt( txn, FD_TXN_ACCT_CAT_IMM );
+    for( fd_txn_acct_iter_t iter=fd_txn_acct_iter_init( txn, FD_TXN_ACCT_CAT_WRITABLE );
+        iter!=fd_txn_acct_iter_end(); iter=fd_txn_acct_iter_next( iter ) ) {
+      fd_pack_bitset_acct_mapping_t const * q = bitset_map_query( pack->acct_to_bitset, *ACCT_ITER_TO_PTR( iter ), NULL );
+      if( FD_UNLIKELY( q && (q->ref_cnt>1UL) && (q->ref_cnt*bank_tile_cnt>pending_cnt) ) ) {
+        cand[ cand_cnt++ ] = _cur;
+        break;
+      }
+    }
+  }
+  return cand_cnt;
+}
+
 int
 fd_pack_microblock_complete( fd_pack_t * pack,
                              ulong       bank_tile ) {
@@ -2152,6 +2331,9 @@ fd_pack_microblock_complete( fd_pack_t * pack,
 
   pack->use_by_bank_cnt[bank_tile] = 0UL;
 
+  pack->cost_est_saved                      -= pack->cost_est_saved_by_bank[ bank_tile ];
+  pack->cost_est_saved_by_bank[ bank_tile ]  = 0UL;
+
   FD_PACK_BITSET_COPY( pack->bitset_rw_in_use, bitset_rw_in_use );
   FD_PACK_BITSET_COPY( pack->bitset_w_in_use,  bitset_w_in_use  );
 
@@ -2467,7 +2649,7 @@ fd_pack_schedule_next_microblock( fd_pack_t *  pack,
 
   if( FD_LIKELY( schedule_flags & FD_PACK_SCHEDULE_VOTE ) ) {
     /* Schedule vote transactions */
-    status1= fd_pack_schedule_impl( pack, pack->pending_votes, vote_cus, vote_reserved_txns, byte_limit, bank_tile, pack->pending_votes_smallest, use_by_bank_txn, out+scheduled );
+    status1= fd_pack_schedule_impl( pack, pack->pending_votes, vote_cus, vote_reserved_txns, byte_limit, bank_tile, pack->pending_votes_smallest, use_by_bank_txn, NULL, 0UL, out+scheduled );
 
     scheduled                   += status1.txns_scheduled;
     pack->cumulative_vote_cost  += status1.cus_scheduled;
@@ -2496,7 +2678,19 @@ fd_pack_schedule_next_microblock( fd_pack_t *  pack,
 
   /* Fill any remaining space with non-vote transactions */
   if( FD_LIKELY( schedule_flags & FD_PACK_SCHEDULE_TXN ) ) {
-    status = fd_pack_schedule_impl( pack, pack->pending,       cu_limit, txn_limit,          byte_limit, bank_tile, pack->pending_smallest,       use_by_bank_txn, out+scheduled );
+    /* With the conflict graph policy, transactions on a critical chain
+       get a microblock of their own.  If there aren't any that can be
+       scheduled right now, fill the microblock greedily. */
+    if( FD_UNLIKELY( pack->sched_policy==FD_PACK_SCHED_POLICY_CONFLICT_GRAPH ) ) {
+      ulong cand[ FD_PACK_CG_SCAN_MAX ];
+      ulong cand_cnt = fd_pack_cg_critical_scan( pack, cu_limit, txn_limit, byte_limit, cand );
+      if( FD_UNLIKELY( cand_cnt ) ) {
+        status = fd_pack_schedule_impl( pack, pack->pending, cu_limit, txn_limit, byte_limit, bank_tile, pack->pending_smallest, use_by_bank_txn, cand, cand_cnt, out+scheduled );
+      }
+    }
+    if( FD_LIKELY( !status.txns_scheduled ) ) {
+      status = fd_pack_schedule_impl( pack, pack->pending,     cu_limit, txn_limit,          byte_limit, bank_tile, pack->pending_smallest,       use_by_bank_txn, NULL, 0UL, out+scheduled );
+    }
 
     scheduled                   += status.txns_scheduled;
     pack->cumulative_block_cost += status.cus_scheduled;
@@ -2524,6 +2718,14 @@ fd_pack_schedule_next_microblock( fd_pack_t *  pack,
 
 ulong fd_pack_bank_tile_cnt     ( fd_pack_t const * pack ) { return pack->bank_tile_cnt;         }
 ulong fd_pack_current_block_cost( fd_pack_t const * pack ) { return pack->cumulative_block_cost; }
+ulong fd_pack_expected_block_cost( fd_pack_t const * pack ) { return fd_ulong_sat_sub( pack->cumulative_block_cost, pack->cost_est_saved ); }
+
+void
+fd_pack_set_cost_estimation( fd_pack_t * pack,
+                             int         enabled ) {
+  pack->cost_est_enabled = !!enabled;
+  pack->cost_est         = enabled ? pack->cost_est_tbl : NULL;
+}
 
 
 void
@@ -2541,7 +2743,8 @@ fd_pack_set_block_limits( fd_pack_t * pack, fd_pack_limits_t const * limits ) {
 
 void
 fd_pack_rebate_cus( fd_pack_t              * pack,
-                    fd_pack_rebate_t const * rebate ) {
+                    fd_pack_rebate_t const * rebate,
+                    ulong                    bank_tile ) {
   if( FD_UNLIKELY( (rebate->ib_result!=0) & (pack->initializer_bundle_state==FD_PACK_IB_STATE_PENDING ) ) ) {
     pack->initializer_bundle_state = fd_int_if( rebate->ib_result==1, FD_PACK_IB_STATE_READY, FD_PACK_IB_STATE_FAILED );
   }
@@ -2563,6 +2766,23 @@ fd_pack_rebate_cus( fd_pack_t              * pack,
      better to just not apply the rebate for now. */
   (void)rebate->microblock_cnt_rebate;
 
+  /* The rebate already took the unused CUs of the microblock out of
+     cumulative_block_cost, so if we kept expecting to save them,
+     expected_block_cost would count them twice.  We don't know which
+     of the microblocks this bank tile executed the report covers, so
+     forget the expected savings on the outstanding one too, which errs
+     on the side of expecting the block to be fuller than it is. */
+  if( FD_LIKELY( bank_tile<pack->bank_tile_cnt ) ) {
+    pack->cost_est_saved                      -= pack->cost_est_saved_by_bank[ bank_tile ];
+    pack->cost_est_saved_by_bank[ bank_tile ]  = 0UL;
+  }
+
+  if( FD_LIKELY( pack->cost_est_enabled ) ) {
+    for( ulong i=0UL; i<fd_ulong_min( rebate->obs_cnt, FD_PACK_REBATE_OBS_MAX ); i++ ) {
+      fd_est_tbl_update( pack->cost_est_tbl, (ulong)rebate->obs[ i ].tag, rebate->obs[ i ].cost );
+    }
+  }
+
   fd_pack_addr_use_t * writer_costs = pack->writer_costs;
   for( ulong i=0UL; i<rebate->writer_cnt; i++ ) {
     fd_pack_addr_use_t * in_wcost_table = acct_uses_query( writer_costs, rebate->writer_rebates[i].key, NULL );
@@ -2610,6 +2830,8 @@ fd_pack_end_block( fd_pack_t * pack ) {
   pack->cumulative_vote_cost        = 0UL;
   pack->cumulative_rebated_cus      = 0UL;
   pack->outstanding_microblock_mask = 0UL;
+  pack->cost_est_saved              = 0UL;
+  for( ulong i=0UL; i<pack->bank_tile_cnt; i++ ) pack->cost_est_saved_by_bank[ i ] = 0UL;
 
   pack->initializer_bundle_state = FD_PACK_IB_STATE_NOT_INITIALIZED;
 
@@ -121,6 +121,35 @@ struct fd_pack_limits {
 typedef struct fd_pack_limits fd_pack_limits_t;
 
 
+/* FD_PACK_SCHED_POLICY_{GREEDY,CONFLICT_GRAPH} select how pack chooses
+   the normal (non-vote, non-bundle) transactions that go into each
+   microblock.  The policy is fixed at fd_pack_new time.
+
+   GREEDY: walk the pending transactions in decreasing priority order
+   and take every transaction that doesn't conflict with a transaction
+   outstanding on another bank tile or earlier in the same microblock,
+   until the microblock is full.
+
+   CONFLICT_GRAPH: pack already maintains an incremental account
+   conflict graph over the pending transactions (each account address is
+   a hyperedge joining every pending transaction that references it,
+   with its degree tracked as the account's reference count).  When the
+   conflicts on some account are so dense that the transactions chained
+   on it outnumber a fair per-bank share of the pending work (i.e.
+   degree*bank_tile_cnt > pending transaction count), that chain
+   bounds how quickly the block can be executed, and under the greedy
+   policy it progresses only one transaction per (full) microblock
+   while the other bank tiles run out of work.  With this policy, pack
+   schedules the highest priority transactions on such critical chains
+   in microblocks of their own, so the contended account is released
+   after a single transaction's worth of execution and the remaining
+   banks get the independent work.  When there is no critical chain,
+   this behaves exactly like GREEDY.  With one bank tile, there is
+   never a critical chain. */
+#define FD_PACK_SCHED_POLICY_GREEDY         0
+#define FD_PACK_SCHED_POLICY_CONFLICT_GRAPH 1
+
+
 /* Forward declare opaque handle */
 struct fd_pack_private;
 typedef struct fd_pack_private fd_pack_t;
@@ -162,7 +191,8 @@ fd_pack_footprint( ulong                    pack_depth,
    pack object.  mem is a non-NULL pointer to a region of memory in the
    local address space with the required alignment and footprint.
    pack_depth, bundle_meta_sz, bank_tile_cnt, and limits are as above.
-   rng is a local join to a random number generator used to perturb
+   sched_policy is one of the FD_PACK_SCHED_POLICY_* values above.  rng
+   is a local join to a random number generator used to perturb
    estimates.
 
    Returns `mem` (which will be properly formatted as a pack object) on
@@ -173,6 +203,7 @@ void * fd_pack_new( void                   * mem,
                     ulong                    bundle_meta_sz,
                     ulong                    bank_tile_cnt,
                     fd_pack_limits_t const * limits,
+                    int                      sched_policy,
                     fd_rng_t               * rng );
 
 /* fd_pack_join joins the caller to the pack object.  Every successful
@@ -201,6 +232,15 @@ fd_pack_avail_txn_cnt( fd_pack_t const * pack ) {
    be a valid local join. */
 FD_FN_PURE ulong fd_pack_current_block_cost( fd_pack_t const * pack );
 
+/* fd_pack_expected_block_cost returns fd_pack_current_block_cost,
+   less the CUs that the outstanding microblocks are expected to rebate
+   based on the cost learned from previous rebates.  This is a better
+   measure of how far along the block is for pacing purposes, but only
+   fd_pack_current_block_cost is guaranteed to be an upper bound.  If
+   cost estimation is disabled, they are equal.  pack must be a valid
+   local join. */
+FD_FN_PURE ulong fd_pack_expected_block_cost( fd_pack_t const * pack );
+
 /* fd_pack_bank_tile_cnt: returns the value of bank_tile_cnt provided in
    pack when the pack object was initialized with fd_pack_new.  pack
    must be a valid local join.  The result will be in [1,
@@ -229,6 +269,25 @@ FD_FN_PURE ulong fd_pack_bank_tile_cnt( fd_pack_t const * pack );
    but the call is valid. */
 void fd_pack_set_block_limits( fd_pack_t * pack, fd_pack_limits_t const * limits );
 
+/* fd_pack_set_cost_estimation enables (if enabled is non-zero) or
+   disables (otherwise) charging transactions the cost they are expected
+   to consume instead of the cost they request.  While enabled, pack
+   learns the cost that transactions which invoke a given list of
+   programs actually consume from the observations in the rebate reports
+   passed to fd_pack_rebate_cus, and a transaction is expected to
+   consume the learned mean plus a couple standard deviations, but no
+   more than it requests.  What was learned is kept if cost estimation
+   is disabled and later re-enabled.
+
+   The expected cost is only charged against the total_cus budget of
+   the microblock in fd_pack_schedule_next_microblock and counted in
+   fd_pack_expected_block_cost.  The block, vote, and per-account write
+   cost limits are consensus limits, so they are always charged the
+   requested cost and only get CUs back through rebates.  Bundles are
+   always charged the requested cost.  Cost estimation is disabled by
+   default.  pack must be a valid local join. */
+void fd_pack_set_cost_estimation( fd_pack_t * pack, int enabled );
+
 /* Return values for fd_pack_insert_txn_fini:  Non-negative values
    indicate the transaction was accepted and may be returned in a future
    microblock.  Negative values indicate that the transaction was
@@ -612,7 +671,14 @@ fd_pack_schedule_next_microblock( fd_pack_t  * pack,
    they can be consumed by a different transaction in the block.
 
    pack must be a valid local join of a pack object.  rebate must point
-   to a valid rebate report produced by fd_pack_rebate_sum_t.
+   to a valid rebate report produced by fd_pack_rebate_sum_t.  bank_tile
+   is the index of the bank tile that produced the report.  If cost
+   estimation is enabled, the cost observations in the report are used
+   to learn the expected cost of transactions (see
+   fd_pack_set_cost_estimation), and they are ignored otherwise.  The
+   CUs pack expected to save on the microblock outstanding on bank_tile
+   stop counting towards fd_pack_expected_block_cost, since the rebate
+   already accounts for them.
 
    IMPORTANT: CU limits are reset at the end of each block, so this
    should not be called for transactions from a prior block.
@@ -627,7 +693,7 @@ fd_pack_schedule_next_microblock( fd_pack_t  * pack,
    constraints.  The restriction about intervening calls to end_block
    and that this must come after schedule_next_microblock are the only
    ordering constraints. */
-void fd_pack_rebate_cus( fd_pack_t * pack, fd_pack_rebate_t const * rebate );
+void fd_pack_rebate_cus( fd_pack_t * pack, fd_pack_rebate_t const * rebate, ulong bank_tile );
 
 /* fd_pack_microblock_complete signals that the bank_tile with index
    bank_tile has completed its previously scheduled microblock.  This
@@ -58,7 +58,19 @@
    with the overflow bit to conflict with any other transaction with the
    overflow bit.
 
-   All of this can be done with AVX or with fd_set. */
+   All of this can be done with AVX or with fd_set.  In every mode, the
+   bitset holds 512 accounts: the AVX-512 mode uses one register, the
+   AVX mode uses a pair of registers, and the fd_set mode uses 8 words.
+   Running out of bits sends accounts to the slow path (the hash map
+   lookups in fd_pack_schedule_impl), which is much more expensive than
+   the extra word operations, so the non-AVX-512 modes use the same
+   size rather than the size of their natural register.
+
+   Since checking a transaction against the in-use sets is just a
+   handful of independent vector operations, scheduling checks a block
+   of candidates at once with FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH,
+   which produces a conflict mask with no data-dependent branches,
+   rather than branching on each candidate in turn. */
 
 #ifndef FD_PACK_BITSET_MODE
 #  if FD_HAS_AVX512
@@ -104,23 +116,32 @@
    temporaries are a bit of a pain.  All 4 sets should be of type T.
    Does not modify any of the input sets.
 
+   FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH is a batched version of
+   !FD_PACK_BITSET_INTERSECT4_EMPTY.  y1 and y2 are arrays of cnt
+   pointers (of type FD_PACK_BITSET_CPTR_T, obtained from sets with
+   FD_PACK_BITSET_ADDR).  Returns a ulong with bit i set if
+   (x1 & *y1[i]) or (x2 & *y2[i]) is non-empty and clear otherwise.
+   cnt must be in [0, FD_PACK_BITSET_BATCH_MAX].
+
    FD_PACK_BITSET_ISNULL takes a set of type T and returns 1 if the set
    is empty/the null set and 0 if it has at least one element.
 
    FD_PACK_BITSET_COPY takes two sets of type T and resets the contents
    of dest to be equal to the contents of src. */
+
+#define FD_PACK_BITSET_BATCH_MAX 64UL
 #if FD_PACK_BITSET_MODE==0
 
 
 #  define SET_NAME addr_bitset
-/* We actually have some flexibility in this case, but for the few
-   blocks that I looked it, 256 seemed like a good number for 1024
-   transactions. */
-#  define SET_MAX  256
+/* We actually have some flexibility in this case, but we use the same
+   size as the AVX-512 mode. */
+#  define SET_MAX  512
 #  include "../../util/tmpl/fd_set.c"
 
-#  define FD_PACK_BITSET_T   addr_bitset_t * /* == ulong *   */
-#  define FD_PACK_BITSET_MAX 256UL
+#  define FD_PACK_BITSET_T      addr_bitset_t * /* == ulong *   */
+#  define FD_PACK_BITSET_CPTR_T addr_bitset_t const *
+#  define FD_PACK_BITSET_MAX    512UL
 
 #  define FD_PACK_BITSET_DECLARE(name)  addr_bitset_t name [ addr_bitset_word_cnt ]
 #  define FD_PACK_BITSET_CLEAR(set)     addr_bitset_new( set )
@@ -145,41 +166,97 @@
 
 #  define FD_PACK_BITSET_COPY(dest, src) addr_bitset_copy( dest, src )
 
+#  define FD_PACK_BITSET_ADDR(set) ((addr_bitset_t const *)(set))
+
+static inline ulong
+fd_pack_bitset_intersect4_nonempty_batch( addr_bitset_t const *         x1,
+                                          addr_bitset_t const *         x2,
+                                          addr_bitset_t const * const * y1,
+                                          addr_bitset_t const * const * y2,
+                                          ulong                         cnt ) {
+  ulong mask = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    ulong any = 0UL;
+    for( ulong j=0UL; j<addr_bitset_word_cnt; j++ ) any |= (x1[ j ] & y1[ i ][ j ]) | (x2[ j ] & y2[ i ][ j ]);
+    mask |= (ulong)(!!any)<<i;
+  }
+  return mask;
+}
+#  define FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH(x1, x2, y1, y2, cnt) fd_pack_bitset_intersect4_nonempty_batch( (x1), (x2), (y1), (y2), (cnt) )
+
 
 #elif FD_PACK_BITSET_MODE==1
 
 #  include "../../util/simd/fd_avx.h"
 
-#  define FD_PACK_BITSET_T   wv_t
-#  define FD_PACK_BITSET_MAX 256UL
-
-#  define FD_PACK_BITSET_DECLARE(name) wv_t name
-#  define FD_PACK_BITSET_CLEAR(set)    (set) = wv_zero()
-#  define FD_PACK_BITSET_SETN(set, n)    do {                                                                    \
-                                           wv_t _n           = wv_bcast( n );                                    \
-                                           wv_t shift_offset = wv( 0UL, 64UL, 128UL, 192UL );                    \
-                                           wv_t one          = wv_bcast( 1UL );                                  \
-                                           set = wv_or( set, wv_shl_vector( one, wv_sub( _n, shift_offset ) ) ); \
+/* Two AVX registers, bits [0, 256) in lo and [256, 512) in hi */
+struct fd_pack_private_wv_pair { wv_t lo; wv_t hi; };
+typedef struct fd_pack_private_wv_pair fd_pack_private_wv_pair_t;
+
+#  define FD_PACK_BITSET_T      fd_pack_private_wv_pair_t
+#  define FD_PACK_BITSET_CPTR_T fd_pack_private_wv_pair_t const *
+#  define FD_PACK_BITSET_MAX    512UL
+
+#  define FD_PACK_BITSET_DECLARE(name) fd_pack_private_wv_pair_t name
+#  define FD_PACK_BITSET_CLEAR(set)    do { (set).lo = wv_zero(); (set).hi = wv_zero(); } while( 0 )
+#  define FD_PACK_BITSET_SETN(set, n)    do {                                                                             \
+                                           wv_t _n           = wv_bcast( n );                                             \
+                                           wv_t shift_offset = wv( 0UL, 64UL, 128UL, 192UL );                             \
+                                           wv_t one          = wv_bcast( 1UL );                                           \
+                                           wv_t hi_offset    = wv_bcast( 256UL );                                         \
+                                           (set).lo = wv_or( (set).lo, wv_shl_vector( one, wv_sub( _n, shift_offset ) ) ); \
+                                           (set).hi = wv_or( (set).hi, wv_shl_vector( one, wv_sub( wv_sub( _n, hi_offset ), shift_offset ) ) ); \
                                          } while( 0 )
-#  define FD_PACK_BITSET_CLEARN(set, n)  do {                                                                      \
-                                         wv_t _n           = wv_bcast( n );                                        \
-                                         wv_t shift_offset = wv( 0UL, 64UL, 128UL, 192UL );                        \
-                                         wv_t one          = wv_bcast( 1UL );                                      \
-                                         set = wv_andnot( wv_shl_vector( one, wv_sub( _n, shift_offset ) ), set ); \
-                                       } while( 0 )
-#  define FD_PACK_BITSET_OR(srcdest, x) srcdest = wv_or( srcdest, x );
-#  define FD_PACK_BITSET_INTERSECT4_EMPTY(x1, x2, y1, y2) (__extension__({                                             \
-                                                             wv_t _temp = wv_or( wv_and( x1, y1 ), wv_and( x2, y2 ) ); \
-                                                             _mm256_testz_si256( _temp, _temp );                       \
+#  define FD_PACK_BITSET_CLEARN(set, n)  do {                                                                                 \
+                                           wv_t _n           = wv_bcast( n );                                                 \
+                                           wv_t shift_offset = wv( 0UL, 64UL, 128UL, 192UL );                                 \
+                                           wv_t one          = wv_bcast( 1UL );                                               \
+                                           wv_t hi_offset    = wv_bcast( 256UL );                                             \
+                                           (set).lo = wv_andnot( wv_shl_vector( one, wv_sub( _n, shift_offset ) ), (set).lo ); \
+                                           (set).hi = wv_andnot( wv_shl_vector( one, wv_sub( wv_sub( _n, hi_offset ), shift_offset ) ), (set).hi ); \
+                                         } while( 0 )
+#  define FD_PACK_BITSET_OR(srcdest, x) do {                                       \
+                                          fd_pack_private_wv_pair_t __x = (x);     \
+                                          (srcdest).lo = wv_or( (srcdest).lo, __x.lo ); \
+                                          (srcdest).hi = wv_or( (srcdest).hi, __x.hi ); \
+                                        } while( 0 )
+#  define FD_PACK_BITSET_INTERSECT4_EMPTY(x1, x2, y1, y2) (__extension__({                                                      \
+                                                             wv_t _temp = wv_or( wv_or( wv_and( (x1).lo, (y1).lo ),            \
+                                                                                        wv_and( (x2).lo, (y2).lo ) ),          \
+                                                                                 wv_or( wv_and( (x1).hi, (y1).hi ),            \
+                                                                                        wv_and( (x2).hi, (y2).hi ) ) );        \
+                                                             _mm256_testz_si256( _temp, _temp );                                \
                                                           }))
-#  define FD_PACK_BITSET_ISNULL(set)      _mm256_testz_si256( set, set )
+#  define FD_PACK_BITSET_ISNULL(set)      (__extension__({                                           \
+                                            wv_t _temp = wv_or( (set).lo, (set).hi );              \
+                                            _mm256_testz_si256( _temp, _temp );                    \
+                                          }))
 #  define FD_PACK_BITSET_COPY(dest, src) dest=src
 
+#  define FD_PACK_BITSET_ADDR(set) (&(set))
+
+static inline ulong
+fd_pack_bitset_intersect4_nonempty_batch( fd_pack_private_wv_pair_t const         x1,
+                                          fd_pack_private_wv_pair_t const         x2,
+                                          fd_pack_private_wv_pair_t const * const * y1,
+                                          fd_pack_private_wv_pair_t const * const * y2,
+                                          ulong                                   cnt ) {
+  ulong mask = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    wv_t t = wv_or( wv_or( wv_and( x1.lo, y1[ i ]->lo ), wv_and( x2.lo, y2[ i ]->lo ) ),
+                    wv_or( wv_and( x1.hi, y1[ i ]->hi ), wv_and( x2.hi, y2[ i ]->hi ) ) );
+    mask |= (ulong)(!_mm256_testz_si256( t, t ))<<i;
+  }
+  return mask;
+}
+#  define FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH(x1, x2, y1, y2, cnt) fd_pack_bitset_intersect4_nonempty_batch( (x1), (x2), (y1), (y2), (cnt) )
+
 #elif FD_PACK_BITSET_MODE==2
 #  include "../../util/simd/fd_avx512.h"
 
-#  define FD_PACK_BITSET_T   wwv_t
-#  define FD_PACK_BITSET_MAX 512UL
+#  define FD_PACK_BITSET_T      wwv_t
+#  define FD_PACK_BITSET_CPTR_T wwv_t const *
+#  define FD_PACK_BITSET_MAX    512UL
 
 #  define FD_PACK_BITSET_DECLARE(name) wwv_t name
 #  define FD_PACK_BITSET_CLEAR(set)    (set) = wwv_zero()
@@ -203,6 +280,23 @@
 #  define FD_PACK_BITSET_ISNULL(set) (0==_mm512_test_epi64_mask( set, set ))
 #  define FD_PACK_BITSET_COPY(dest, src) dest=src
 
+#  define FD_PACK_BITSET_ADDR(set) (&(set))
+
+static inline ulong
+fd_pack_bitset_intersect4_nonempty_batch( wwv_t                 x1,
+                                          wwv_t                 x2,
+                                          wwv_t const * const * y1,
+                                          wwv_t const * const * y2,
+                                          ulong                 cnt ) {
+  ulong mask = 0UL;
+  for( ulong i=0UL; i<cnt; i++ ) {
+    wwv_t t = wwv_or( wwv_and( x1, *y1[ i ] ), wwv_and( x2, *y2[ i ] ) );
+    mask |= (ulong)(!!_mm512_test_epi64_mask( t, t ))<<i;
+  }
+  return mask;
+}
+#  define FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH(x1, x2, y1, y2, cnt) fd_pack_bitset_intersect4_nonempty_batch( (x1), (x2), (y1), (y2), (cnt) )
+
 #else
 #  error "FD_PACK_BITSET_MODE not recognized"
 #endif
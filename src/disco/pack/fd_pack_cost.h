@@ -296,6 +296,25 @@ fd_pack_compute_cost( fd_txn_t const * txn,
   /* <= FD_PACK_MAX_COST, so no overflow concerns */
   return signature_cost + writable_cost + execution_cost + instr_data_cost + *loaded_account_data_cost;
 }
+
+/* fd_pack_cost_est_tag returns the tag under which pack learns the
+   observed cost of transactions like txn (see fd_est_tbl.h).
+   Transactions that invoke the same programs in the same order get the
+   same tag, on the theory that they cost about the same.  Both pack
+   and the bank tiles compute this, so it must only depend on txn and
+   payload.  Program ids can't come from address lookup tables, so all
+   the addresses this reads are in payload. */
+static inline uint
+fd_pack_cost_est_tag( fd_txn_t const * txn,
+                      uchar    const * payload ) {
+  fd_acct_addr_t const * addr_base = fd_txn_get_acct_addrs( txn, payload );
+  ulong tag = (ulong)txn->instr_cnt;
+  for( ulong i=0UL; i<txn->instr_cnt; i++ ) {
+    tag = fd_ulong_hash( tag ^ fd_ulong_load_8( addr_base[ txn->instr[i].program_id ].b ) );
+  }
+  return (uint)tag;
+}
+
 #undef MAP_PERFECT_HASH_PP
 #undef PERFECT_HASH
 #endif /* HEADER_fd_src_ballet_pack_fd_pack_cost_h */
@@ -1,5 +1,6 @@
 #include "fd_pack_rebate_sum.h"
 #include "fd_pack.h"
+#include "fd_pack_cost.h"
 #if FD_HAS_AVX
 #include "../../util/simd/fd_avx.h"
 #endif
@@ -35,6 +36,8 @@ fd_pack_rebate_sum_new( void * mem ) {
   s->microblock_cnt_rebate    = 0UL;
   s->ib_result                = 0;
   s->writer_cnt               = 0U;
+  s->obs_cnt                  = 0U;
+  s->obs_enabled              = 0;
 
   rmap_new( s->map );
 
@@ -52,7 +55,7 @@ fd_pack_rebate_sum_add_txn( fd_pack_rebate_sum_t         * s,
                             fd_acct_addr_t const * const * adtl_writable,
                             ulong                          txn_cnt ) {
   /* See end of function for this equation */
-  if( FD_UNLIKELY( txn_cnt==0UL ) ) return (ulong)((fd_int_max( 0, (int)s->writer_cnt - (int)HEADROOM ) + 1636) / 1637);
+  if( FD_UNLIKELY( txn_cnt==0UL ) ) return (ulong)((fd_int_max( 0, (int)s->writer_cnt - (int)HEADROOM ) + (int)FD_PACK_REBATE_WRITER_MAX-1) / (int)FD_PACK_REBATE_WRITER_MAX);
 
   int is_initializer_bundle = 1;
   int ib_success            = 1;
@@ -75,6 +78,12 @@ fd_pack_rebate_sum_add_txn( fd_pack_rebate_sum_t         * s,
     s->vote_cost_rebate  += fd_ulong_if( txn->flags & FD_TXN_P_FLAGS_IS_SIMPLE_VOTE, rebated_cus,     0UL );
     s->data_bytes_rebate += fd_ulong_if( !in_block,                                  txn->payload_sz, 0UL );
 
+    if( FD_UNLIKELY( s->obs_enabled & in_block & !(txn->flags & FD_TXN_P_FLAGS_IS_SIMPLE_VOTE) & (s->obs_cnt<FD_PACK_REBATE_OBS_MAX) ) ) {
+      s->obs[ s->obs_cnt ].tag  = fd_pack_cost_est_tag( TXN(txn), txn->payload );
+      s->obs[ s->obs_cnt ].cost = txn->bank_cu.actual_consumed_cus;
+      s->obs_cnt++;
+    }
+
     if( FD_UNLIKELY( rebated_cus==0UL ) ) continue;
 
     fd_acct_addr_t const * accts = fd_txn_get_acct_addrs( TXN(txn), txn->payload );
@@ -118,25 +127,29 @@ fd_pack_rebate_sum_add_txn( fd_pack_rebate_sum_t         * s,
   /* We want to make sure that we have enough capacity to insert 31*128
      addresses without hitting 5k.  Thus, if x is the current value of
      writer_cnt, we need to call report at least y times to ensure
-                        x-y*1637 <= 5*1024-31*128
-                               y >= (x-1152)/1637
-     but y is an integer, so y >= ceiling( (x-1152)/1637 ) */
-  return (ulong)((fd_int_max( 0, (int)s->writer_cnt - (int)HEADROOM ) + 1636) / 1637);
+                        x-y*1630 <= 5*1024-31*128
+                               y >= (x-1152)/1630
+     but y is an integer, so y >= ceiling( (x-1152)/1630 ) */
+  return (ulong)((fd_int_max( 0, (int)s->writer_cnt - (int)HEADROOM ) + (int)FD_PACK_REBATE_WRITER_MAX-1) / (int)FD_PACK_REBATE_WRITER_MAX);
 }
 
 
 ulong
 fd_pack_rebate_sum_report( fd_pack_rebate_sum_t * s,
                            fd_pack_rebate_t     * out ) {
-  if( FD_UNLIKELY( (s->ib_result==0) & (s->total_cost_rebate==0UL) & (s->writer_cnt==0U) ) ) return 0UL;
+  if( FD_UNLIKELY( (s->ib_result==0) & (s->total_cost_rebate==0UL) & (s->writer_cnt==0U) & (s->obs_cnt==0U) ) ) return 0UL;
   out->total_cost_rebate       = s->total_cost_rebate;          s->total_cost_rebate       = 0UL;
   out->vote_cost_rebate        = s->vote_cost_rebate;           s->vote_cost_rebate        = 0UL;
   out->data_bytes_rebate       = s->data_bytes_rebate;          s->data_bytes_rebate       = 0UL;
   out->microblock_cnt_rebate   = s->microblock_cnt_rebate;      s->microblock_cnt_rebate   = 0UL;
   out->ib_result               = s->ib_result;                  s->ib_result               = 0;
 
+  out->obs_cnt = s->obs_cnt;
+  for( ulong i=0UL; i<s->obs_cnt; i++ ) out->obs[ i ] = s->obs[ i ];
+  s->obs_cnt = 0U;
+
   out->writer_cnt = 0U;
-  ulong writer_cnt = fd_ulong_min( s->writer_cnt, 1637UL );
+  ulong writer_cnt = fd_ulong_min( s->writer_cnt, FD_PACK_REBATE_WRITER_MAX );
   for( ulong i=0UL; i<writer_cnt; i++ ) {
     fd_pack_rebate_entry_t * e = s->inserted[ --(s->writer_cnt) ];
     out->writer_rebates[ out->writer_cnt++ ] = *e;
@@ -153,6 +166,7 @@ fd_pack_rebate_sum_clear( fd_pack_rebate_sum_t * s ) {
   s->data_bytes_rebate       = 0UL;
   s->microblock_cnt_rebate   = 0UL;
   s->ib_result               = 0;
+  s->obs_cnt                 = 0U;
 
   ulong writer_cnt = s->writer_cnt;
   for( ulong i=0UL; i<writer_cnt; i++ ) {
@@ -14,7 +14,12 @@
    fd_pack_rebate_sum_t digests microblocks and produces 0-3
    fd_pack_rebate_t messages which summarizes what rebates are needed.
    From the bank tiles's perspective, fd_pack_rebate_t is an opaque
-   type, but pack reads its internals. */
+   type, but pack reads its internals.
+
+   The first message after a microblock also carries the cost each
+   transaction in it actually consumed, tagged with
+   fd_pack_cost_est_tag, which pack uses to learn how much transactions
+   that invoke a given set of programs typically cost. */
 
 FD_STATIC_ASSERT( MAX_TXN_PER_MICROBLOCK*FD_TXN_ACCT_ADDR_MAX<4096UL, map_size );
 
@@ -25,6 +30,16 @@ typedef struct {
   ulong rebate_cus;
 } fd_pack_rebate_entry_t;
 
+/* FD_PACK_REBATE_OBS_MAX is the maximum number of cost observations a
+   single report carries.  Transactions beyond this in between reports
+   are not observed, which is fine since they are only a sample. */
+#define FD_PACK_REBATE_OBS_MAX MAX_TXN_PER_MICROBLOCK
+
+typedef struct {
+  uint tag;  /* fd_pack_cost_est_tag of the transaction */
+  uint cost; /* actual_consumed_cus of the transaction */
+} fd_pack_rebate_obs_t;
+
 
 struct fd_pack_rebate_sum_private {
   ulong total_cost_rebate;
@@ -33,7 +48,10 @@ struct fd_pack_rebate_sum_private {
   ulong microblock_cnt_rebate;
   int   ib_result; /* -1: IB failed, 0: not an IB, 1: IB success */
   uint  writer_cnt;
+  uint  obs_cnt;
+  int   obs_enabled; /* Record cost observations only if non-zero */
 
+  fd_pack_rebate_obs_t   obs[ FD_PACK_REBATE_OBS_MAX ];
   fd_pack_rebate_entry_t map[ 8192UL ];
   fd_pack_rebate_entry_t * inserted[ FD_PACK_REBATE_SUM_CAPACITY ];
 };
@@ -47,15 +65,19 @@ struct fd_pack_rebate {
   ulong microblock_cnt_rebate;
   int   ib_result; /* -1: IB failed, 0: not an IB, 1: IB success */
   uint  writer_cnt;
+  uint  obs_cnt;
 
-  fd_pack_rebate_entry_t writer_rebates[ 1UL ]; /* Actually writer_cnt, up to 1637 */
+  fd_pack_rebate_obs_t   obs[ FD_PACK_REBATE_OBS_MAX ]; /* Only the first obs_cnt are valid */
+  fd_pack_rebate_entry_t writer_rebates[ 1UL ]; /* Actually writer_cnt, up to FD_PACK_REBATE_WRITER_MAX */
 };
 typedef struct fd_pack_rebate fd_pack_rebate_t;
 
+#define FD_PACK_REBATE_WRITER_MAX 1630UL
+
 #define FD_PACK_REBATE_MIN_SZ (sizeof(fd_pack_rebate_t)       -sizeof(fd_pack_rebate_entry_t))
-#define FD_PACK_REBATE_MAX_SZ (sizeof(fd_pack_rebate_t)+1636UL*sizeof(fd_pack_rebate_entry_t))
+#define FD_PACK_REBATE_MAX_SZ (sizeof(fd_pack_rebate_t)+(FD_PACK_REBATE_WRITER_MAX-1UL)*sizeof(fd_pack_rebate_entry_t))
 
-FD_STATIC_ASSERT( sizeof(fd_pack_rebate_t)+1636UL*sizeof(fd_pack_rebate_entry_t)<USHORT_MAX, rebate_depth );
+FD_STATIC_ASSERT( FD_PACK_REBATE_MAX_SZ<USHORT_MAX, rebate_depth );
 
 
 FD_FN_PURE static inline ulong fd_pack_rebate_sum_align    ( void ) { return alignof(fd_pack_rebate_sum_t); }
@@ -65,6 +87,16 @@ FD_FN_PURE static inline fd_pack_rebate_sum_t * fd_pack_rebate_sum_join( void *
 
 void * fd_pack_rebate_sum_new( void * mem );
 
+/* fd_pack_rebate_sum_set_cost_obs controls whether add_txn records cost
+   observations.  Observations are only useful to a pack object with
+   cost estimation enabled, so they are off after new, and the caller
+   should only turn them on if that is the case. */
+static inline void
+fd_pack_rebate_sum_set_cost_obs( fd_pack_rebate_sum_t * s,
+                                 int                    enabled ) {
+  s->obs_enabled = !!enabled;
+}
+
 /* fd_pack_rebate_sum_add_txn adds rebate information from a bundle or
    microblock to the pending summary.  This reads the EXECUTE_SUCCESS
    flag and the bank_cu field, so those must be populated in the
@@ -86,6 +118,10 @@ void * fd_pack_rebate_sum_new( void * mem );
    This function does not retain any read interest in txn or
    adtl_writable after returning.
 
+   If cost observations are enabled (see set_cost_obs above),
+   transactions that landed and aren't simple votes are also recorded as
+   cost observations for the next report.
+
    Returns the number of times fd_pack_rebate_sum_report must be called
    before the next call to add_txn with a non-zero txn_cnt. */
 ulong
@@ -117,6 +117,7 @@ typedef struct {
   fd_wksp_t * mem;
   ulong       chunk0;
   ulong       wmark;
+  ulong       bank_idx; /* For bank_pack links, the bank tile that produces it */
 } fd_pack_in_ctx_t;
 
 typedef struct {
@@ -716,7 +717,7 @@ after_credit( fd_pack_ctx_t *     ctx,
 
       ctx->bank_idle_bitset = fd_ulong_pop_lsb( ctx->bank_idle_bitset );
       ctx->skip_cnt         = (long)schedule_cnt * fd_long_if( ctx->use_consumed_cus, (long)bank_cnt/2L, 1L );
-      fd_pack_pacing_update_consumed_cus( ctx->pacer, fd_pack_current_block_cost( ctx->pack ), now2 );
+      fd_pack_pacing_update_consumed_cus( ctx->pacer, fd_pack_expected_block_cost( ctx->pack ), now2 );
 
       memcpy( ctx->last_sched_metrics->all, (ulong const *)fd_metrics_tl, sizeof(ctx->last_sched_metrics->all) );
       ctx->last_sched_metrics->time = now2;
@@ -993,7 +994,7 @@ after_frag( fd_pack_ctx_t *     ctx,
     limits->max_write_cost_per_acct = ctx->limits.slot_max_write_cost_per_acct;
     limits->max_txn_per_microblock = ULONG_MAX; /* unused */
     fd_pack_set_block_limits( ctx->pack, limits );
-    fd_pack_pacing_update_consumed_cus( ctx->pacer, fd_pack_current_block_cost( ctx->pack ), now );
+    fd_pack_pacing_update_consumed_cus( ctx->pacer, fd_pack_expected_block_cost( ctx->pack ), now );
 
     break;
   }
@@ -1001,9 +1002,9 @@ after_frag( fd_pack_ctx_t *     ctx,
     /* For a previous slot */
     if( FD_UNLIKELY( sig!=ctx->leader_slot ) ) return;
 
-    fd_pack_rebate_cus( ctx->pack, ctx->rebate->rebate );
+    fd_pack_rebate_cus( ctx->pack, ctx->rebate->rebate, ctx->in[ in_idx ].bank_idx );
     ctx->pending_rebate_sz = 0UL;
-    fd_pack_pacing_update_consumed_cus( ctx->pacer, fd_pack_current_block_cost( ctx->pack ), now );
+    fd_pack_pacing_update_consumed_cus( ctx->pacer, fd_pack_expected_block_cost( ctx->pack ), now );
     break;
   }
   case IN_KIND_RESOLV: {
@@ -1107,8 +1108,9 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->pack = fd_pack_join( fd_pack_new( FD_SCRATCH_ALLOC_APPEND( l, fd_pack_align(), pack_footprint ),
                                          tile->pack.max_pending_transactions, BUNDLE_META_SZ, tile->pack.bank_tile_count,
-                                         limits_lower, rng ) );
+                                         limits_lower, tile->pack.sched_policy, rng ) );
   if( FD_UNLIKELY( !ctx->pack ) ) FD_LOG_ERR(( "fd_pack_new failed" ));
+  fd_pack_set_cost_estimation( ctx->pack, tile->pack.cost_estimation );
 
   if( FD_UNLIKELY( tile->in_cnt>32UL ) ) FD_LOG_ERR(( "Too many input links (%lu>32) to pack tile", tile->in_cnt ));
 
@@ -1239,9 +1241,10 @@ unprivileged_init( fd_topo_t *      topo,
     fd_topo_link_t * link = &topo->links[ tile->in_link_id[ i ] ];
     fd_topo_wksp_t * link_wksp = &topo->workspaces[ topo->objs[ link->dcache_obj_id ].wksp_id ];
 
-    ctx->in[ i ].mem    = link_wksp->wksp;
-    ctx->in[ i ].chunk0 = fd_dcache_compact_chunk0( ctx->in[ i ].mem, link->dcache );
-    ctx->in[ i ].wmark  = fd_dcache_compact_wmark ( ctx->in[ i ].mem, link->dcache, link->mtu );
+    ctx->in[ i ].mem      = link_wksp->wksp;
+    ctx->in[ i ].chunk0   = fd_dcache_compact_chunk0( ctx->in[ i ].mem, link->dcache );
+    ctx->in[ i ].wmark    = fd_dcache_compact_wmark ( ctx->in[ i ].mem, link->dcache, link->mtu );
+    ctx->in[ i ].bank_idx = link->kind_id;
   }
 
   ctx->bank_out_mem    = topo->workspaces[ topo->objs[ topo->links[ tile->out_link_id[ 0 ] ].dcache_obj_id ].wksp_id ].wksp;
@@ -73,7 +73,7 @@ init_all( ulong pack_depth,
   else                         FD_LOG_NOTICE(( "Test required %lu bytes of %lu available bytes",    footprint, PACK_SCRATCH_SZ ));
 #endif
 
-  fd_pack_t * pack = fd_pack_join( fd_pack_new( pack_scratch, pack_depth, 0UL, bank_tile_cnt, limits, rng ) );
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( pack_scratch, pack_depth, 0UL, bank_tile_cnt, limits, FD_PACK_SCHED_POLICY_GREEDY, rng ) );
 #define MAX_BANKING_THREADS 64
 
   outcome->microblock_cnt = 0UL;
@@ -320,7 +320,7 @@ insert( ulong i,
   return fd_pack_insert_txn_fini( pack, slot, i );
 }
 
-static void
+static ulong
 schedule_validate_microblock( fd_pack_t * pack,
                               ulong total_cus,
                               float vote_fraction,
@@ -402,6 +402,7 @@ schedule_validate_microblock( fd_pack_t * pack,
 
   outcome->microblock_cnt++;
   if( extra_verify ) FD_TEST( !fd_pack_verify( pack, pack_verify_scratch ) );
+  return txn_cnt;
 }
 
 
@@ -669,7 +670,7 @@ performance_test2( void ) {
 #define OUTER_ROUNDS 88
   long elapsed = 0L;
 
-  fd_pack_t * pack = fd_pack_join( fd_pack_new( pack_scratch, 1024UL, 0UL, 4UL, limits, rng ) );
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( pack_scratch, 1024UL, 0UL, 4UL, limits, FD_PACK_SCHED_POLICY_GREEDY, rng ) );
 
   for( ulong outer=0UL; outer<OUTER_ROUNDS; outer++ ) {
     elapsed -= fd_log_wallclock();
@@ -745,7 +746,7 @@ void performance_test( int extra_bench ) {
     long schedule  = 0L;
 
     for( ulong iter=0UL; iter<ITER_CNT; iter++ ) {
-      fd_pack_t * pack = fd_pack_join( fd_pack_new( _mem, heap_sz, 0UL, 1UL, limits, rng ) );
+      fd_pack_t * pack = fd_pack_join( fd_pack_new( _mem, heap_sz, 0UL, 1UL, limits, FD_PACK_SCHED_POLICY_GREEDY, rng ) );
 
       FD_TEST( fd_pack_avail_txn_cnt( pack )==0UL );
 
@@ -899,7 +900,7 @@ void performance_end_block( void ) {
   make_transaction( 0UL, 800U, 500U, 4.0, "", "", NULL, NULL );
 
   FD_LOG_NOTICE(( "Writers\tTime (ms/call)" ));
-  fd_pack_t * pack = fd_pack_join( fd_pack_new( _mem, 4096UL, 0UL, 8UL, limits, rng ) );
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( _mem, 4096UL, 0UL, 8UL, limits, FD_PACK_SCHED_POLICY_GREEDY, rng ) );
   for( ulong writers_cnt=1UL; writers_cnt<=16*1024UL; writers_cnt *= 2UL ) {
     long end_block = 0L;
 
@@ -936,6 +937,136 @@ void performance_end_block( void ) {
 #undef ITER_CNT
 }
 
+/* Simulates executing one block's worth of transactions on bank_cnt
+   banks, where a third of the transactions write to the same hot
+   account, and the rest are independent.  Each bank executes a
+   microblock in time proportional to its total cost, and asks for a
+   new one as soon as it is done.  Returns the fees of the transactions
+   that finished executing within the slot, and stores the time (in cost
+   units) at which the last bank finished in *makespan and the total
+   time banks spent without a microblock in *idle.  Checks that the
+   microblocks never conflict. */
+static ulong
+simulate_block( int     sched_policy,
+                ulong   bank_cnt,
+                ulong   slot_cus,
+                ulong * makespan,
+                ulong * idle ) {
+  ulong fees[ MAX_TEST_TXNS ];
+  fd_rng_t _sim_rng[1];
+  fd_rng_t * sim_rng = fd_rng_join( fd_rng_new( _sim_rng, 1234U, 0UL ) );
+  for( ulong i=0UL; i<MAX_TEST_TXNS; i++ ) {
+    double priority = 4.0 + (double)fd_rng_uint_roll( sim_rng, 1000U )/250.0;
+    make_transaction( i, 20000U, 500U, priority, (i%3UL) ? "" : "H", "", fees+i, NULL );
+  }
+  fd_rng_delete( fd_rng_leave( sim_rng ) );
+
+  fd_pack_limits_t limits[ 1 ] = { {
+    .max_cost_per_block        = FD_PACK_TEST_MAX_COST_PER_BLOCK,
+    .max_vote_cost_per_block   = 0UL,
+    .max_write_cost_per_acct   = FD_PACK_TEST_MAX_WRITE_COST_PER_ACCT,
+    .max_data_bytes_per_block  = MAX_DATA_PER_BLOCK,
+    .max_txn_per_microblock    = 31UL,
+    .max_microblocks_per_block = MAX_TEST_TXNS,
+  } };
+  FD_TEST( fd_pack_footprint( MAX_TEST_TXNS, 0UL, bank_cnt, limits )<=PACK_SCRATCH_SZ );
+  fd_pack_t * pack = fd_pack_join( fd_pack_new( pack_scratch, MAX_TEST_TXNS, 0UL, bank_cnt, limits, sched_policy, rng ) );
+  FD_TEST( pack );
+  for( ulong i=0UL; i<MAX_TEST_TXNS; i++ ) FD_TEST( insert( i, pack )>=0 );
+
+  outcome.microblock_cnt = 0UL;
+  for( ulong i=0UL; i<FD_PACK_MAX_BANK_TILES; i++ ) {
+    outcome.r_accts_in_use[ i ] = aset_null( );
+    outcome.w_accts_in_use[ i ] = aset_null( );
+  }
+
+  ulong free_at    [ FD_PACK_MAX_BANK_TILES ] = { 0UL };
+  ulong mblk_fees  [ FD_PACK_MAX_BANK_TILES ] = { 0UL };
+  int   outstanding[ FD_PACK_MAX_BANK_TILES ] = { 0   };
+  ulong slot_fees  = 0UL;
+  ulong now        = 0UL;
+  *idle = 0UL;
+
+  for(;;) {
+    /* Complete every microblock that finishes now */
+    for( ulong b=0UL; b<bank_cnt; b++ ) {
+      if( !outstanding[ b ] || free_at[ b ]!=now ) continue;
+      fd_pack_microblock_complete( pack, b );
+      outcome.r_accts_in_use[ b ] = aset_null( );
+      outcome.w_accts_in_use[ b ] = aset_null( );
+      outstanding[ b ] = 0;
+      if( now<=slot_cus ) slot_fees += mblk_fees[ b ];
+    }
+    /* Give work to every bank that is free */
+    for( ulong b=0UL; b<bank_cnt; b++ ) {
+      if( outstanding[ b ] ) continue;
+      ulong txn_cnt = schedule_validate_microblock( pack, 31UL*30000UL, 0.0f, 0UL, 0UL, b, &outcome );
+      if( !txn_cnt ) continue;
+      ulong cost = 0UL;
+      mblk_fees[ b ] = 0UL;
+      for( ulong j=0UL; j<txn_cnt; j++ ) {
+        fd_txn_p_t * txnp = outcome.results+j;
+        cost += txnp->pack_cu.requested_exec_plus_acct_data_cus + txnp->pack_cu.non_execution_cus;
+        mblk_fees[ b ] += fees[ FD_LOAD( ulong, txnp->payload+1UL ) ];
+      }
+      outstanding[ b ] = 1;
+      free_at    [ b ] = now+cost;
+    }
+    /* Advance to the next completion.  Idle banks wait for it. */
+    ulong next = ULONG_MAX;
+    for( ulong b=0UL; b<bank_cnt; b++ ) if( outstanding[ b ] ) next = fd_ulong_min( next, free_at[ b ] );
+    if( next==ULONG_MAX ) break;
+    for( ulong b=0UL; b<bank_cnt; b++ ) {
+      if( outstanding[ b ] ) continue;
+      *idle += next-now;
+      free_at[ b ] = next;
+    }
+    now = next;
+  }
+  FD_TEST( !fd_pack_avail_txn_cnt( pack ) );
+  FD_TEST( !fd_pack_verify( pack, pack_verify_scratch ) );
+  fd_pack_end_block( pack );
+  fd_pack_delete( fd_pack_leave( pack ) );
+
+  *makespan = now;
+  return slot_fees;
+}
+
+/* Compares the fees collected in a slot and the bank idle time of the
+   greedy and conflict graph scheduling policies on a workload with one
+   long chain of transactions contending for a hot account. */
+static void
+performance_conflict_graph( void ) {
+  FD_LOG_NOTICE(( "TEST CONFLICT GRAPH SCHEDULING" ));
+  FD_LOG_NOTICE(( "Banks\tPolicy\t\tFees in slot\tMakespan (CUs)\tBank idle" ));
+  for( ulong bank_cnt=4UL; bank_cnt<=8UL; bank_cnt*=2UL ) {
+    /* The slot is 10% longer than executing everything with perfect
+       parallelism would take */
+    ulong makespan[2], idle[2], slot_fees[2];
+    ulong total_cus = 0UL;
+    for( ulong i=0UL; i<MAX_TEST_TXNS; i++ ) {
+      ulong cost;
+      make_transaction( i, 20000U, 500U, 4.0, (i%3UL) ? "" : "H", "", NULL, &cost );
+      total_cus += cost;
+    }
+    ulong slot_cus = fd_ulong_max( total_cus/bank_cnt, (MAX_TEST_TXNS/3UL+1UL)*total_cus/MAX_TEST_TXNS )*11UL/10UL;
+
+    for( int policy=FD_PACK_SCHED_POLICY_GREEDY; policy<=FD_PACK_SCHED_POLICY_CONFLICT_GRAPH; policy++ ) {
+      slot_fees[ policy ] = simulate_block( policy, bank_cnt, slot_cus, makespan+policy, idle+policy );
+      FD_LOG_NOTICE(( "%5lu\t%-14s\t%12lu\t%14lu\t%8.1f%%", bank_cnt, policy ? "conflict_graph" : "greedy", slot_fees[ policy ],
+                      makespan[ policy ], 100.0*(double)idle[ policy ]/(double)(bank_cnt*makespan[ policy ]) ));
+    }
+    FD_TEST( slot_fees[ FD_PACK_SCHED_POLICY_CONFLICT_GRAPH ]>=slot_fees[ FD_PACK_SCHED_POLICY_GREEDY ] );
+    FD_TEST( makespan [ FD_PACK_SCHED_POLICY_CONFLICT_GRAPH ]<=makespan [ FD_PACK_SCHED_POLICY_GREEDY ] );
+  }
+
+  /* With one bank, there are no critical chains, so the policies are
+     identical. */
+  ulong makespan[2], idle[2];
+  ulong fees0 = simulate_block( FD_PACK_SCHED_POLICY_GREEDY,         1UL, ULONG_MAX, makespan+0, idle+0 );
+  ulong fees1 = simulate_block( FD_PACK_SCHED_POLICY_CONFLICT_GRAPH, 1UL, ULONG_MAX, makespan+1, idle+1 );
+  FD_TEST( (fees0==fees1) & (makespan[0]==makespan[1]) & (idle[0]==0UL) & (idle[1]==0UL) );
+}
 
 void heap_overflow_test( void ) {
   FD_LOG_NOTICE(( "TEST HEAP OVERFLOW" ));
@@ -1000,6 +1131,99 @@ test_gap( void ) {
   }
 }
 
+static void
+test_cost_estimation( void ) {
+  FD_LOG_NOTICE(( "TEST COST ESTIMATION" ));
+  fd_pack_t * pack = init_all( 1024UL, 1UL, 1024UL, &outcome );
+
+  /* All these transactions invoke the same programs, so they share a
+     tag, and they each request 200k CUs. */
+  ulong cost;
+  for( ulong i=0UL; i<20UL; i++ ) {
+    char writes[2] = { (char)('0'+i), '\0' };
+    make_transaction( i, 200000U, 500U, 11.0, writes, "", NULL, &cost );
+    insert( i, pack );
+  }
+  uint tag = fd_pack_cost_est_tag( (fd_txn_t const *)txn_scratch[ 0 ], payload_scratch[ 0 ] );
+  FD_TEST( tag==fd_pack_cost_est_tag( (fd_txn_t const *)txn_scratch[ 19 ], payload_scratch[ 19 ] ) );
+
+  /* Without estimation, a microblock budget of 3 transactions' worth of
+     requested CUs fits 3 of them */
+  schedule_validate_microblock( pack, 3UL*cost, 0.0f, 3UL, 0UL, 0UL, &outcome );
+  FD_TEST( fd_pack_avail_txn_cnt( pack )==17UL );
+  FD_TEST( fd_pack_expected_block_cost( pack )==fd_pack_current_block_cost( pack ) );
+
+  /* Tell pack they actually consume a tenth of that.  Pack doesn't
+     learn from the observations while estimation is disabled. */
+  union{ fd_pack_rebate_t rebate[1]; uchar footprint[USHORT_MAX]; } report[1];
+  memset( report->rebate, 0, FD_PACK_REBATE_MIN_SZ );
+  report->rebate->obs_cnt = 10U;
+  for( ulong i=0UL; i<10UL; i++ ) report->rebate->obs[ i ] = (fd_pack_rebate_obs_t){ .tag = tag, .cost = (uint)(cost/10UL) };
+  ulong block_cost = fd_pack_current_block_cost( pack );
+  fd_pack_rebate_cus( pack, report->rebate, 0UL );
+  FD_TEST( fd_pack_current_block_cost( pack )==block_cost );
+  fd_pack_microblock_complete( pack, 0UL );
+
+  fd_pack_set_cost_estimation( pack, 1 );
+  schedule_validate_microblock( pack, 3UL*cost, 0.0f, 3UL, 0UL, 0UL, &outcome );
+  FD_TEST( fd_pack_avail_txn_cnt( pack )==14UL );
+  FD_TEST( fd_pack_expected_block_cost( pack )==fd_pack_current_block_cost( pack ) );
+
+  /* Now it learns */
+  block_cost = fd_pack_current_block_cost( pack );
+  fd_pack_rebate_cus( pack, report->rebate, 0UL );
+  FD_TEST( fd_pack_current_block_cost( pack )==block_cost );
+  fd_pack_microblock_complete( pack, 0UL );
+
+  /* With estimation, the same budget fits all the rest, but the block
+     is still charged the requested cost. */
+  schedule_validate_microblock( pack, 3UL*cost, 0.0f, 14UL, 0UL, 0UL, &outcome );
+  FD_TEST( fd_pack_avail_txn_cnt( pack )==0UL );
+  FD_TEST( fd_pack_current_block_cost( pack )==block_cost+14UL*cost );
+  /* The learned mean is subject to rounding, so allow 1 CU per txn */
+  FD_TEST( fd_pack_expected_block_cost( pack )>=block_cost+14UL*(cost/10UL)     );
+  FD_TEST( fd_pack_expected_block_cost( pack )<=block_cost+14UL*(cost/10UL+1UL) );
+
+  /* Once the rebate for the microblock comes in, its actual cost is
+     known, so it's not expected to save anything anymore, even though
+     the bank tile hasn't reported it complete yet.  Otherwise the
+     rebated CUs would count twice. */
+  report->rebate->obs_cnt           = 0U;
+  report->rebate->total_cost_rebate = 14UL*(cost - cost/10UL);
+  fd_pack_rebate_cus( pack, report->rebate, 0UL );
+  FD_TEST( fd_pack_current_block_cost ( pack )==block_cost+14UL*(cost/10UL) );
+  FD_TEST( fd_pack_expected_block_cost( pack )==fd_pack_current_block_cost( pack ) );
+  fd_pack_microblock_complete( pack, 0UL );
+  FD_TEST( fd_pack_expected_block_cost( pack )==fd_pack_current_block_cost( pack ) );
+  report->rebate->total_cost_rebate = 0UL;
+  report->rebate->obs_cnt           = 10U;
+
+  fd_pack_end_block( pack );
+  FD_TEST( fd_pack_expected_block_cost( pack )==0UL );
+
+  /* The block limit is still charged the requested cost, so even though
+     the microblock budget would fit all of these, only as many as fit
+     in the block by requested cost get scheduled. */
+  for( ulong i=0UL; i<40UL; i++ ) {
+    char writes[2] = { (char)('0'+i), '\0' };
+    make_transaction( i, 1400000U, 500U, 11.0, writes, "", NULL, &cost );
+    insert( i, pack );
+  }
+  tag = fd_pack_cost_est_tag( (fd_txn_t const *)txn_scratch[ 0 ], payload_scratch[ 0 ] );
+  for( ulong i=0UL; i<10UL; i++ ) report->rebate->obs[ i ] = (fd_pack_rebate_obs_t){ .tag = tag, .cost = (uint)(cost/10UL) };
+  fd_pack_rebate_cus( pack, report->rebate, 0UL );
+
+  ulong fit = FD_PACK_TEST_MAX_COST_PER_BLOCK/cost;
+  FD_TEST( fit<40UL );
+  schedule_validate_microblock( pack, 40UL*cost, 0.0f, fit, 0UL, 0UL, &outcome );
+  FD_TEST( fd_pack_avail_txn_cnt( pack )==40UL-fit );
+  FD_TEST( fd_pack_current_block_cost( pack )==fit*cost );
+  FD_TEST( fd_pack_current_block_cost( pack )<=FD_PACK_TEST_MAX_COST_PER_BLOCK );
+
+  fd_pack_end_block( pack );
+  fd_pack_set_cost_estimation( pack, 0 );
+}
+
 static void
 test_limits( void ) {
   FD_LOG_NOTICE(( "TEST LIMITS" ));
@@ -1093,7 +1317,7 @@ test_limits( void ) {
     outcome.results->bank_cu.rebated_cus = (uint)((total_cus + (total_cus*FD_PACK_TEST_MAX_COST_PER_BLOCK/(4*total_cus))) - FD_PACK_TEST_MAX_WRITE_COST_PER_ACCT);
     fd_pack_rebate_sum_add_txn( rebater, outcome.results, rebate_alt, 1UL );
     fd_pack_rebate_sum_report( rebater, report->rebate );
-    fd_pack_rebate_cus( pack, report->rebate );
+    fd_pack_rebate_cus( pack, report->rebate, 0UL );
     /* Now consumed CUs is 12M - total_cus, so it just fits. */
     schedule_validate_microblock( pack, FD_PACK_TEST_MAX_COST_PER_BLOCK, 0.0f, 1UL, 0UL, 0UL, &outcome );
 
@@ -1141,7 +1365,7 @@ test_limits( void ) {
     outcome.results[ 0 ].bank_cu.rebated_cus = (uint)(total_cus - (FD_PACK_TEST_MAX_COST_PER_BLOCK - almost_full_iter*8UL*total_cus - 7UL*total_cus));
     fd_pack_rebate_sum_add_txn( rebater, outcome.results, rebate_alt, 1UL );
     fd_pack_rebate_sum_report( rebater, report->rebate );
-    fd_pack_rebate_cus( pack, report->rebate );
+    fd_pack_rebate_cus( pack, report->rebate, 0UL );
     schedule_validate_microblock( pack, FD_PACK_TEST_MAX_COST_PER_BLOCK, 0.0f, 1UL, 0UL, 0UL, &outcome );
 
     fd_pack_end_block( pack );
@@ -1381,6 +1605,7 @@ main( int     argc,
   test_expiration();
   test_gap();
   test_limits();
+  test_cost_estimation();
   if( 0 ) test_vote_qos();
   test_reject_writes_to_sysvars();
   test_reject();
@@ -1389,6 +1614,7 @@ main( int     argc,
   performance_test( extra_benchmark );
   performance_test2();
   performance_end_block();
+  performance_conflict_graph();
 
   fd_rng_delete( fd_rng_leave( rng ) );
 
@@ -76,6 +76,36 @@ main( int     argc,
   }
   FD_PACK_BITSET_CLEARN( z, 0 ); FD_TEST(  FD_PACK_BITSET_ISNULL( z ) );
 
+  /* Batched intersection.  Set i of the batch has bit i in y_i and bit
+     i+1 in z_i, so it conflicts with x={i} in the first position and
+     w={i+1} in the second. */
+  static FD_PACK_BITSET_DECLARE( ys[ FD_PACK_BITSET_BATCH_MAX ] );
+  static FD_PACK_BITSET_DECLARE( zs[ FD_PACK_BITSET_BATCH_MAX ] );
+  FD_PACK_BITSET_CPTR_T yp[ FD_PACK_BITSET_BATCH_MAX ];
+  FD_PACK_BITSET_CPTR_T zp[ FD_PACK_BITSET_BATCH_MAX ];
+  for( ulong i=0UL; i<FD_PACK_BITSET_BATCH_MAX; i++ ) {
+    FD_PACK_BITSET_CLEAR( ys[ i ] ); FD_PACK_BITSET_SETN( ys[ i ], i     ); yp[ i ] = FD_PACK_BITSET_ADDR( ys[ i ] );
+    FD_PACK_BITSET_CLEAR( zs[ i ] ); FD_PACK_BITSET_SETN( zs[ i ], i+1UL ); zp[ i ] = FD_PACK_BITSET_ADDR( zs[ i ] );
+  }
+  FD_PACK_BITSET_CLEAR( x );
+  FD_PACK_BITSET_CLEAR( w );
+  for( ulong cnt=0UL; cnt<=FD_PACK_BITSET_BATCH_MAX; cnt++ ) FD_TEST( !FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH( x, w, yp, zp, cnt ) );
+  for( ulong i=0UL; i<FD_PACK_BITSET_BATCH_MAX; i++ ) {
+    FD_PACK_BITSET_CLEAR( x ); FD_PACK_BITSET_SETN( x, i     );
+    FD_PACK_BITSET_CLEAR( w );
+    FD_TEST( FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH( x, w, yp, zp, FD_PACK_BITSET_BATCH_MAX )==1UL<<i );
+    FD_TEST( FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH( x, w, yp, zp, i                        )==0UL    );
+    FD_PACK_BITSET_CLEAR( x );
+    FD_PACK_BITSET_CLEAR( w ); FD_PACK_BITSET_SETN( w, i+1UL );
+    FD_TEST( FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH( x, w, yp, zp, FD_PACK_BITSET_BATCH_MAX )==1UL<<i );
+    /* Must agree with the unbatched version */
+    FD_PACK_BITSET_SETN( x, 2UL*i );
+    ulong mask = FD_PACK_BITSET_INTERSECT4_NONEMPTY_BATCH( x, w, yp, zp, FD_PACK_BITSET_BATCH_MAX );
+    for( ulong j=0UL; j<FD_PACK_BITSET_BATCH_MAX; j++ ) {
+      FD_TEST( ((mask>>j)&1UL)==(ulong)!FD_PACK_BITSET_INTERSECT4_EMPTY( x, w, ys[ j ], zs[ j ] ) );
+    }
+  }
+
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
   return 0;
@@ -1,5 +1,6 @@
 #include "fd_pack_rebate_sum.h"
 #include "fd_pack.h"
+#include "fd_pack_cost.h"
 
 #define VOTE     FD_TXN_P_FLAGS_IS_SIMPLE_VOTE
 #define BUNDLE   FD_TXN_P_FLAGS_BUNDLE
@@ -23,6 +24,7 @@ fake_transaction( fd_txn_p_t     * txnp,
   txn->addr_table_adtl_cnt   = (uchar)strlen( alt_writable );
   txn->addr_table_adtl_writable_cnt = (uchar)strlen( alt_writable );
   txn->addr_table_lookup_cnt = (uchar)strlen( alt_writable )>0UL;
+  txn->instr_cnt             = 0;
 
   uchar * payload = txnp->payload;
   while( *writable ) {
@@ -38,6 +40,7 @@ fake_transaction( fd_txn_p_t     * txnp,
   txnp->payload_sz = 111UL;
   txnp->flags = flags;
   txnp->bank_cu.rebated_cus = (uint)rebate_cus;
+  txnp->bank_cu.actual_consumed_cus = (uint)(1400000UL-rebate_cus);
 }
 
 static inline void
@@ -79,10 +82,17 @@ main( int     argc,
   fake_transaction( microblock+1, alt[1], 1400000UL, SANITIZE,           "GH",   ""   );
   fake_transaction( microblock+2, alt[2], 1400000UL, 0,                  "JKL",  "MN" );
 
+  /* Cost observations are off by default */
+  FD_TEST(       0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 3UL ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ+40UL*11UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( report.rebate->obs_cnt              ==0U        );
+  fd_pack_rebate_sum_clear( sum );
+  fd_pack_rebate_sum_set_cost_obs( sum, 1 );
+
   /* only 11 accounts (M,N excluded because sanitize failed), so not a
      problem */
   FD_TEST(       0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 3UL ) );
-  FD_TEST( 40UL*12UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ+40UL*11UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST( report.rebate->total_cost_rebate    ==2810000UL );
   FD_TEST( report.rebate->vote_cost_rebate     ==0UL       );
   FD_TEST( report.rebate->data_bytes_rebate    ==222UL     );
@@ -92,12 +102,16 @@ main( int     argc,
   check_writer( report.rebate, "ABCDEF",   10000UL );
   check_writer( report.rebate, "GH",     1400000UL );
   check_writer( report.rebate, "JKL",    1400000UL );
+  /* Only the transaction that landed is observed */
+  FD_TEST( report.rebate->obs_cnt              ==1U        );
+  FD_TEST( report.rebate->obs[0].tag           ==fd_pack_cost_est_tag( TXN(microblock+0), microblock[0].payload ) );
+  FD_TEST( report.rebate->obs[0].cost          ==1390000U  );
 
   FD_TEST( 0UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
 
   FD_TEST(       0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 3UL ) );
   FD_TEST(       0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 3UL ) );
-  FD_TEST( 40UL*12UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ+40UL*11UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST( report.rebate->total_cost_rebate    ==5620000UL );
   FD_TEST( report.rebate->vote_cost_rebate     ==0UL       );
   FD_TEST( report.rebate->data_bytes_rebate    ==444UL     );
@@ -107,6 +121,7 @@ main( int     argc,
   check_writer( report.rebate, "ABCDEF",   20000UL );
   check_writer( report.rebate, "GH",     2800000UL );
   check_writer( report.rebate, "JKL",    2800000UL );
+  FD_TEST( report.rebate->obs_cnt              ==2U        );
 
 
 
@@ -115,13 +130,14 @@ main( int     argc,
   fake_transaction( microblock+2, alt[2], 4000UL, 0,                         "", "" );
   FD_TEST(  0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 3UL ) );
 
-  FD_TEST( 40UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST( report.rebate->total_cost_rebate    ==7100UL );
   FD_TEST( report.rebate->vote_cost_rebate     ==3100UL );
   FD_TEST( report.rebate->data_bytes_rebate    ==222UL  );
   FD_TEST( report.rebate->microblock_cnt_rebate==0UL    );
   FD_TEST( report.rebate->ib_result            ==0      );
   FD_TEST( report.rebate->writer_cnt           ==0U     );
+  FD_TEST( report.rebate->obs_cnt              ==0U     ); /* Votes aren't observed */
 
 
 
@@ -131,7 +147,7 @@ main( int     argc,
   fake_transaction( microblock+2, alt[2], 1400000UL, 0,        "", "" );
   fake_transaction( microblock+3, alt[3], 1000000UL, 0,        "", "" );
   FD_TEST(  0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 4UL ) );
-  FD_TEST( 40UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST( report.rebate->microblock_cnt_rebate==1UL    );
   FD_TEST( report.rebate->data_bytes_rebate    ==492UL  );
   FD_TEST(  0UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
@@ -142,14 +158,14 @@ main( int     argc,
   fake_transaction( microblock+2, alt[2], 1400000UL, BUNDLE,            "", "" );
   fake_transaction( microblock+3, alt[3], 1000000UL, BUNDLE,            "", "" );
   FD_TEST(  0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 4UL ) );
-  FD_TEST( 40UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST( report.rebate->microblock_cnt_rebate==4UL   );
   FD_TEST( report.rebate->data_bytes_rebate    ==636UL );
 
 
   fake_transaction( microblock+0, alt[0],   10000UL, SANITIZE | EXECUTE | BUNDLE | IB, "", "" );
   FD_TEST(  0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 1UL ) );
-  FD_TEST( 40UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST( report.rebate->microblock_cnt_rebate==0UL );
   FD_TEST( report.rebate->ib_result            ==1   );
   FD_TEST(  0UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
@@ -158,7 +174,7 @@ main( int     argc,
   fake_transaction( microblock+1, alt[1],   10000UL, SANITIZE           | BUNDLE | IB, "", "" );
   fake_transaction( microblock+2, alt[2],   10000UL, SANITIZE | EXECUTE | BUNDLE | IB, "", "" );
   FD_TEST(  0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 3UL ) );
-  FD_TEST( 40UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST( report.rebate->ib_result            ==-1  );
 
   for( ulong i=0UL; i<31UL*128UL*32UL; i++ ) alt[i>>12][(i>>5)&0x7F].b[i&0x1F] = (uchar)fd_ulong_hash( i );
@@ -172,16 +188,19 @@ main( int     argc,
     txn->addr_table_adtl_cnt   = 128;
     txn->addr_table_adtl_writable_cnt = 128;
     txn->addr_table_lookup_cnt = 1;
+    txn->instr_cnt             = 0;
     microblock[i].payload_sz   = 111UL;
     microblock[i].flags        = SANITIZE | EXECUTE;
     microblock[i].bank_cu.rebated_cus = 100U;
   }
   FD_TEST(         2UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 31UL ) );
-  FD_TEST( 40UL*1638UL==fd_pack_rebate_sum_report ( sum, report.rebate          ) );
+  FD_TEST( FD_PACK_REBATE_MAX_SZ==fd_pack_rebate_sum_report ( sum, report.rebate          ) );
+  FD_TEST( report.rebate->obs_cnt==31U );
   FD_TEST(         1UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 0UL  ) );
-  FD_TEST( 40UL*1638UL==fd_pack_rebate_sum_report ( sum, report.rebate          ) );
+  FD_TEST( FD_PACK_REBATE_MAX_SZ==fd_pack_rebate_sum_report ( sum, report.rebate          ) );
+  FD_TEST( report.rebate->obs_cnt==0U  );
   FD_TEST(         0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 0UL  ) );
-  FD_TEST( 40UL* 695UL==fd_pack_rebate_sum_report ( sum, report.rebate          ) );
+  FD_TEST( FD_PACK_REBATE_MIN_SZ+40UL*708UL==fd_pack_rebate_sum_report ( sum, report.rebate ) );
   FD_TEST(         0UL==fd_pack_rebate_sum_add_txn( sum, microblock, _alt, 0UL  ) );
 
   FD_LOG_NOTICE(( "pass" ));
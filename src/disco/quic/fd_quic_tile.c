@@ -63,6 +63,9 @@ scratch_footprint( fd_topo_tile_t const * tile ) {
   l = FD_LAYOUT_APPEND( l, alignof( fd_quic_ctx_t ), sizeof( fd_quic_ctx_t )                        );
   l = FD_LAYOUT_APPEND( l, fd_quic_align(),          fd_quic_footprint( &limits )                   );
   l = FD_LAYOUT_APPEND( l, fd_tpu_reasm_align(),     fd_tpu_reasm_footprint( out_depth, reasm_max ) );
+  if( tile->quic.txn_rate_per_connection ) {
+    l = FD_LAYOUT_APPEND( l, alignof( fd_quic_conn_quota_t ), limits.conn_cnt*sizeof( fd_quic_conn_quota_t ) );
+  }
   return FD_LAYOUT_FINI( l, scratch_align() );
 }
 
@@ -125,6 +128,7 @@ metrics_write( fd_quic_ctx_t * ctx ) {
   FD_MCNT_SET( QUIC, LEGACY_TXN_OVERSZ,  ctx->metrics.udp_pkt_too_large );
   FD_MCNT_SET( QUIC, TXN_UNDERSZ,        ctx->metrics.quic_txn_too_small );
   FD_MCNT_SET( QUIC, TXN_OVERSZ,         ctx->metrics.quic_txn_too_large );
+  FD_MCNT_SET( QUIC, TXN_THROTTLED,      ctx->metrics.quic_txn_throttled );
 
   FD_MCNT_SET(   QUIC, RECEIVED_PACKETS, ctx->quic->metrics.net_rx_pkt_cnt );
   FD_MCNT_SET(   QUIC, RECEIVED_BYTES,   ctx->quic->metrics.net_rx_byte_cnt );
@@ -180,22 +184,59 @@ before_frag( fd_quic_ctx_t * ctx,
   ulong proto = fd_disco_netmux_sig_proto( sig );
   if( FD_UNLIKELY( proto!=DST_PROTO_TPU_UDP && proto!=DST_PROTO_TPU_QUIC ) ) return 1;
 
+  /* With multiple quic tiles, QUIC packets are steered to the owning
+     tile by destination conn ID in during_frag, which needs to look at
+     the packet.  Everything else is steered by the flow hash. */
+  if( FD_LIKELY( proto==DST_PROTO_TPU_QUIC && ctx->round_robin_cnt>1UL ) ) return 0;
+
   ulong hash = fd_disco_netmux_sig_hash( sig );
   if( FD_UNLIKELY( (hash % ctx->round_robin_cnt) != ctx->round_robin_id ) ) return 1;
 
   return 0;
 }
 
+/* quic_pkt_owner returns the index of the quic tile that owns the QUIC
+   packet in the frag [pkt,pkt+pkt_sz) with netmux signature sig.
+   Every quic tile sees every frag and computes the same owner, so
+   exactly one tile handles each packet.
+
+   Packets addressed to a conn ID we chose go to the tile encoded in
+   that conn ID (see fd_quic_conn_id_shard_set), regardless of the
+   peer's current address.  Packets starting a connection (and anything
+   without a valid shard) go to the tile selected by the flow hash.  That
+   tile then picks conn IDs that carry its own index, pinning the rest
+   of the connection to it. */
+
+static inline ulong
+quic_pkt_owner( uchar const * pkt,
+                ulong         pkt_sz,
+                ulong         sig,
+                ulong         tile_cnt ) {
+  ulong hdr_sz = fd_disco_netmux_sig_hdr_sz( sig );
+  ulong shard  = ULONG_MAX;
+  if( FD_LIKELY( pkt_sz>hdr_sz ) ) shard = fd_quic_pkt_dst_shard( pkt+hdr_sz, pkt_sz-hdr_sz );
+  if( FD_UNLIKELY( shard>=tile_cnt ) ) shard = fd_disco_netmux_sig_hash( sig ) % tile_cnt;
+  return shard;
+}
+
 static void
 during_frag( fd_quic_ctx_t * ctx,
              ulong           in_idx,
              ulong           seq    FD_PARAM_UNUSED,
-             ulong           sig    FD_PARAM_UNUSED,
+             ulong           sig,
              ulong           chunk,
              ulong           sz,
              ulong           ctl ) {
   void const * src = fd_net_rx_translate_frag( &ctx->net_in_bounds[ in_idx ], chunk, ctl, sz );
 
+  ctx->skip_frag = 0;
+  if( FD_LIKELY( ctx->round_robin_cnt>1UL && fd_disco_netmux_sig_proto( sig )==DST_PROTO_TPU_QUIC ) ) {
+    if( quic_pkt_owner( src, sz, sig, ctx->round_robin_cnt )!=ctx->round_robin_id ) {
+      ctx->skip_frag = 1;
+      return;
+    }
+  }
+
   /* FIXME this copy could be eliminated by combining it with the decrypt operation */
   fd_memcpy( ctx->buffer, src, sz );
 }
@@ -215,6 +256,8 @@ after_frag( fd_quic_ctx_t *     ctx,
   (void)tspub;
   (void)stem;
 
+  if( FD_UNLIKELY( ctx->skip_frag ) ) return;
+
   ulong proto = fd_disco_netmux_sig_proto( sig );
 
   if( FD_LIKELY( proto==DST_PROTO_TPU_QUIC ) ) {
@@ -266,6 +309,35 @@ quic_conn_final( fd_quic_conn_t * conn,
   ctx->metrics.reasm_abandoned += (ulong)abandon_cnt;
 }
 
+/* quic_txn_quota_take consumes one txn from the quota of the
+   connection identified by conn_uid.  Returns 1 if the txn may proceed
+   and 0 if it should be dropped.  Always returns 1 if quotas are
+   disabled. */
+
+static inline int
+quic_txn_quota_take( fd_quic_ctx_t * ctx,
+                     ulong           conn_uid,
+                     long            now ) {
+  if( !ctx->conn_quota_cnt ) return 1;
+  uint conn_idx = fd_quic_conn_uid_idx( conn_uid );
+  if( FD_UNLIKELY( conn_idx>=ctx->conn_quota_cnt ) ) return 1;
+  fd_quic_conn_quota_t * quota = ctx->conn_quota + conn_idx;
+  if( FD_UNLIKELY( quota->conn_uid!=conn_uid ) ) {
+    quota->conn_uid = conn_uid;
+    quota->bucket   = (fd_token_bucket_t) {
+      .ts      = now,
+      .rate    = ctx->txn_rate,
+      .burst   = ctx->txn_burst,
+      .balance = ctx->txn_burst
+    };
+  }
+  if( FD_UNLIKELY( !fd_token_bucket_consume( &quota->bucket, 1.0f, now ) ) ) {
+    ctx->metrics.quic_txn_throttled++;
+    return 0;
+  }
+  return 1;
+}
+
 static int
 quic_stream_rx( fd_quic_conn_t * conn,
                 ulong            stream_id,
@@ -297,6 +369,9 @@ quic_stream_rx( fd_quic_conn_t * conn,
       ctx->metrics.quic_txn_too_large++;
       return FD_QUIC_SUCCESS; /* drop */
     }
+    if( FD_UNLIKELY( !quic_txn_quota_take( ctx, conn_uid, tspub ) ) ) {
+      return FD_QUIC_SUCCESS; /* drop */
+    }
     int err = fd_tpu_reasm_publish_fast( reasm, data, data_sz, mcache, base, seq, tspub );
     if( FD_LIKELY( err==FD_TPU_REASM_SUCCESS ) ) {
       fd_stem_advance( stem, 0UL );
@@ -319,6 +394,10 @@ quic_stream_rx( fd_quic_conn_t * conn,
       ctx->metrics.quic_txn_too_large++;
       return FD_QUIC_SUCCESS; /* drop */
     }
+    /* Charge the quota before evicting somebody else's reassembly */
+    if( FD_UNLIKELY( !quic_txn_quota_take( ctx, conn_uid, tspub ) ) ) {
+      return FD_QUIC_SUCCESS; /* drop */
+    }
 
     /* Was the reasm buffer we evicted busy? */
     fd_tpu_reasm_slot_t * victim      = fd_tpu_reasm_peek_tail( reasm );
@@ -502,6 +581,17 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->reasm       = fd_tpu_reasm_join( fd_tpu_reasm_new( reasm_mem, out_depth, reasm_max, orig, txn_dcache ) );
   if( FD_UNLIKELY( !ctx->reasm ) ) FD_LOG_ERR(( "fd_tpu_reasm_new failed" ));
 
+  if( tile->quic.txn_rate_per_connection ) {
+    if( FD_UNLIKELY( !tile->quic.txn_burst_per_connection ) ) {
+      FD_LOG_ERR(( "Invalid `txn_burst_per_connection`: must be greater than zero" ));
+    }
+    ctx->conn_quota     = FD_SCRATCH_ALLOC_APPEND( l, alignof( fd_quic_conn_quota_t ), limits.conn_cnt*sizeof( fd_quic_conn_quota_t ) );
+    ctx->conn_quota_cnt = limits.conn_cnt;
+    ctx->txn_rate       = (float)( (double)tile->quic.txn_rate_per_connection / ( fd_tempo_tick_per_ns( NULL )*1e9 ) );
+    ctx->txn_burst      = (float)tile->quic.txn_burst_per_connection;
+    for( ulong i=0UL; i<limits.conn_cnt; i++ ) ctx->conn_quota[ i ].conn_uid = ULONG_MAX;
+  }
+
   if( FD_UNLIKELY( tile->quic.ack_delay_millis == 0 ) ) {
     FD_LOG_ERR(( "Invalid `ack_delay_millis`: must be greater than zero" ));
   }
@@ -525,6 +615,19 @@ unprivileged_init( fd_topo_t *      topo,
   quic->cb.now_ctx          = ctx;
   quic->cb.quic_ctx         = ctx;
 
+  ctx->round_robin_cnt = fd_topo_tile_name_cnt( topo, tile->name );
+  ctx->round_robin_id  = tile->kind_id;
+  if( FD_UNLIKELY( ctx->round_robin_id >= ctx->round_robin_cnt ) ) {
+    FD_LOG_ERR(( "invalid round robin configuration" ));
+  }
+  if( FD_UNLIKELY( ctx->round_robin_cnt > FD_QUIC_CONN_ID_SHARD_MAX ) ) {
+    FD_LOG_ERR(( "too many quic tiles (%lu), max is %lu", ctx->round_robin_cnt, FD_QUIC_CONN_ID_SHARD_MAX ));
+  }
+
+  /* Make conn IDs chosen by this tile carry its index */
+  quic->config.shard_cnt = ctx->round_robin_cnt;
+  quic->config.shard_idx = ctx->round_robin_id;
+
   fd_quic_set_aio_net_tx( quic, quic_tx_aio );
   fd_quic_set_clock_tickcount( quic );
   if( FD_UNLIKELY( !fd_quic_init( quic ) ) ) FD_LOG_ERR(( "fd_quic_init failed" ));
@@ -542,12 +645,6 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->quic = quic;
 
-  ctx->round_robin_cnt = fd_topo_tile_name_cnt( topo, tile->name );
-  ctx->round_robin_id  = tile->kind_id;
-  if( FD_UNLIKELY( ctx->round_robin_id >= ctx->round_robin_cnt ) ) {
-    FD_LOG_ERR(( "invalid round robin configuration" ));
-  }
-
   ulong scratch_top = FD_SCRATCH_ALLOC_FINI( l, 1UL );
   if( FD_UNLIKELY( scratch_top > (ulong)scratch + scratch_footprint( tile ) ) )
     FD_LOG_ERR(( "scratch overflow %lu %lu %lu", scratch_top - (ulong)scratch - scratch_footprint( tile ), scratch_top, (ulong)scratch + scratch_footprint( tile ) ));
@@ -6,11 +6,25 @@
 #include "../topo/fd_topo.h"
 #include "../net/fd_net_tile.h"
 #include "../../waltz/quic/fd_quic.h"
+#include "../../waltz/fd_token_bucket.h"
 
 #define FD_QUIC_TILE_IN_MAX (8UL)
 
 extern fd_topo_run_tile_t fd_tile_quic;
 
+/* fd_quic_conn_quota_t limits the rate at which one connection may
+   start transactions.  There is one per connection slot, indexed by
+   the conn_idx part of the conn_uid.  A quota is reset to a full bucket
+   the first time it is used by a new connection in its slot (i.e. when
+   conn_uid does not match). */
+
+struct fd_quic_conn_quota {
+  ulong             conn_uid;
+  fd_token_bucket_t bucket;
+};
+
+typedef struct fd_quic_conn_quota fd_quic_conn_quota_t;
+
 typedef struct {
   fd_tpu_reasm_t * reasm;
 
@@ -29,6 +43,7 @@ typedef struct {
 
   ulong round_robin_cnt;
   ulong round_robin_id;
+  int   skip_frag; /* set in during_frag if another quic tile owns the frag */
 
   fd_net_rx_bounds_t net_in_bounds[ FD_QUIC_TILE_IN_MAX ];
 
@@ -39,6 +54,11 @@ typedef struct {
 
   fd_wksp_t * verify_out_mem;
 
+  fd_quic_conn_quota_t * conn_quota;     /* indexed [0,conn_cnt) */
+  ulong                  conn_quota_cnt; /* 0 if quotas are disabled */
+  float                  txn_rate;       /* txns per tick */
+  float                  txn_burst;
+
   struct {
     ulong txns_received_udp;
     ulong txns_received_quic_fast;
@@ -54,6 +74,7 @@ typedef struct {
     ulong udp_pkt_too_large;
     ulong quic_txn_too_small;
     ulong quic_txn_too_large;
+    ulong quic_txn_throttled;
   } metrics;
 } fd_quic_ctx_t;
 
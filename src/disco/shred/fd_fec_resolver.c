@@ -1,6 +1,7 @@
 #include "../../ballet/shred/fd_shred.h"
 #include "../../ballet/shred/fd_fec_set.h"
 #include "../../ballet/sha512/fd_sha512.h"
+#include "../../ballet/sha256/fd_sha256.h"
 #include "../../ballet/reedsol/fd_reedsol.h"
 #include "../metrics/fd_metrics.h"
 #include "fd_fec_resolver.h"
@@ -136,10 +137,12 @@ struct __attribute__((aligned(FD_FEC_RESOLVER_ALIGN))) fd_fec_resolver {
      */
   ulong max_shred_idx;
 
-  /* sha512 and reedsol are used for calculations while adding a shred.
-     Their state outside a call to add_shred is indeterminate. */
-  fd_sha512_t   sha512[1];
-  fd_reedsol_t  reedsol[1];
+  /* sha512, sha256 and reedsol are used for calculations while adding
+     a shred.  Their state outside a call to add_shred is
+     indeterminate. */
+  fd_sha512_t       sha512[1];
+  fd_sha256_batch_t sha256[1];
+  fd_reedsol_t      reedsol[1];
 
   /* The footprint for the objects follows the struct and is in the same
      order as the pointers, namely:
@@ -571,29 +574,32 @@ int fd_fec_resolver_add_shred( fd_fec_resolver_t    * resolver,
 
   uchar const * chained_root = fd_ptr_if( fd_shred_is_chained( shred_type ), (uchar *)shred+fd_shred_chain_off( variant ), NULL );
 
-  /* Iterate over recovered shreds, add them to the Merkle tree,
-     populate headers and signatures. */
+  /* Iterate over recovered shreds, populate headers and compute their
+     Merkle leaves.  The leaves are hashed with the batch SHA-256 API,
+     which needs the leaf prefix immediately before the hashed region.
+     Like the shredder, we put it in the last bytes of the signature
+     field (which isn't part of the hashed region), and only fill in the
+     signature once the batch is done. */
+  fd_bmtree_node_t new_leaf    [ FD_REEDSOL_DATA_SHREDS_MAX + FD_REEDSOL_PARITY_SHREDS_MAX ];
+  ulong            new_leaf_idx[ FD_REEDSOL_DATA_SHREDS_MAX + FD_REEDSOL_PARITY_SHREDS_MAX ];
+  ulong            new_leaf_cnt = 0UL;
+
+  fd_sha256_batch_t * sha256 = fd_sha256_batch_init( resolver->sha256 );
   for( ulong i=0UL; i<set->data_shred_cnt; i++ ) {
     if( !d_rcvd_test( set->data_shred_rcvd, i ) ) {
-      fd_memcpy( set->data_shreds[i], shred, sizeof(fd_ed25519_sig_t) );
       if( FD_LIKELY( fd_shred_is_chained( shred_type ) ) ) {
         fd_memcpy( set->data_shreds[i]+fd_shred_chain_off( data_variant ), chained_root, FD_SHRED_MERKLE_ROOT_SZ );
       }
-      fd_bmtree_hash_leaf( leaf, set->data_shreds[i]+sizeof(fd_ed25519_sig_t), data_merkle_protected_sz, FD_BMTREE_LONG_PREFIX_SZ );
-      if( FD_UNLIKELY( !fd_bmtree_commitp_insert_with_proof( tree, i, leaf, NULL, 0, NULL ) ) ) {
-        freelist_push_tail( free_list,        set  );
-        bmtrlist_push_tail( bmtree_free_list, tree );
-        FD_MCNT_INC( SHRED, FEC_REJECTED_FATAL, 1UL );
-        return FD_FEC_RESOLVER_SHRED_REJECTED;
-      }
-
+      uchar * leaf_data = set->data_shreds[i] + sizeof(fd_ed25519_sig_t) - FD_BMTREE_LONG_PREFIX_SZ;
+      fd_memcpy( leaf_data, fd_bmtree_leaf_prefix, FD_BMTREE_LONG_PREFIX_SZ );
+      fd_sha256_batch_add( sha256, leaf_data, data_merkle_protected_sz+FD_BMTREE_LONG_PREFIX_SZ, new_leaf[ new_leaf_cnt ].hash );
+      new_leaf_idx[ new_leaf_cnt++ ] = i;
     }
   }
 
   for( ulong i=0UL; i<set->parity_shred_cnt; i++ ) {
     if( !p_rcvd_test( set->parity_shred_rcvd, i ) ) {
       fd_shred_t * p_shred = (fd_shred_t *)set->parity_shreds[i]; /* We can't parse because we haven't populated the header */
-      fd_memcpy( p_shred->signature, shred->signature, sizeof(fd_ed25519_sig_t) );
       p_shred->variant       = parity_variant;
       p_shred->slot          = shred->slot;
       p_shred->idx           = (uint)(i + parity_idx0);
@@ -607,18 +613,25 @@ int fd_fec_resolver_add_shred( fd_fec_resolver_t    * resolver,
         fd_memcpy( set->parity_shreds[i]+fd_shred_chain_off( parity_variant ), chained_root, FD_SHRED_MERKLE_ROOT_SZ );
       }
 
-      fd_bmtree_hash_leaf( leaf, set->parity_shreds[i]+ sizeof(fd_ed25519_sig_t), parity_merkle_protected_sz, FD_BMTREE_LONG_PREFIX_SZ );
-      if( FD_UNLIKELY( !fd_bmtree_commitp_insert_with_proof( tree, set->data_shred_cnt + i, leaf, NULL, 0, NULL ) ) ) {
-        freelist_push_tail( free_list,        set  );
-        bmtrlist_push_tail( bmtree_free_list, tree );
-        FD_MCNT_INC( SHRED, FEC_REJECTED_FATAL, 1UL );
-        return FD_FEC_RESOLVER_SHRED_REJECTED;
-      }
+      uchar * leaf_data = set->parity_shreds[i] + sizeof(fd_ed25519_sig_t) - FD_BMTREE_LONG_PREFIX_SZ;
+      fd_memcpy( leaf_data, fd_bmtree_leaf_prefix, FD_BMTREE_LONG_PREFIX_SZ );
+      fd_sha256_batch_add( sha256, leaf_data, parity_merkle_protected_sz+FD_BMTREE_LONG_PREFIX_SZ, new_leaf[ new_leaf_cnt ].hash );
+      new_leaf_idx[ new_leaf_cnt++ ] = set->data_shred_cnt + i;
     }
   }
+  fd_sha256_batch_fini( sha256 );
 
-  /* Check that the whole Merkle tree is consistent. */
-  if( FD_UNLIKELY( !fd_bmtree_commitp_fini( tree, set->data_shred_cnt + set->parity_shred_cnt ) ) ) {
+  for( ulong i=0UL; i<set->data_shred_cnt; i++ ) if( !d_rcvd_test( set->data_shred_rcvd, i ) )
+    fd_memcpy( set->data_shreds[i],   shred->signature, sizeof(fd_ed25519_sig_t) );
+  for( ulong i=0UL; i<set->parity_shred_cnt; i++ ) if( !p_rcvd_test( set->parity_shred_rcvd, i ) )
+    fd_memcpy( set->parity_shreds[i], shred->signature, sizeof(fd_ed25519_sig_t) );
+
+  /* Add the recovered leaves to the Merkle tree and check that the
+     whole tree is consistent.  The branch nodes that the received
+     shreds' proofs didn't provide are derived a layer at a time with
+     the batch SHA-256 API too. */
+  if( FD_UNLIKELY( !fd_bmtree_commitp_fini_with_leaves( tree, set->data_shred_cnt + set->parity_shred_cnt,
+                                                        new_leaf, new_leaf_idx, new_leaf_cnt ) ) ) {
     freelist_push_tail( free_list,        set  );
     bmtrlist_push_tail( bmtree_free_list, tree );
     FD_MCNT_INC( SHRED, FEC_REJECTED_FATAL, 1UL );
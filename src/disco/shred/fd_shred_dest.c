@@ -128,6 +128,9 @@ fd_shred_dest_new( void                           * mem,
   sdest->excluded_stake             = excluded_stake;
   sdest->pubkey_to_idx_map          = pubkey_to_idx_map;
   sdest->source_validator_orig_idx  = query->idx;
+  sdest->leader_cache_slot          = ULONG_MAX;
+  sdest->leader_cache_leader        = NULL;
+  sdest->leader_cache_idx           = ULONG_MAX;
 
   return (void *)sdest;
 }
@@ -220,6 +223,32 @@ sample_unstaked( fd_shred_dest_t * sdest ) {
 }
 
 
+/* lookup_leader returns the leader for slot, or NULL if slot is not in
+   the leader schedule.  On a non-NULL return, *leader_idx is set to the
+   leader's index in all_destinations, or ULONG_MAX if the leader is not
+   a known destination. */
+static inline fd_pubkey_t const *
+lookup_leader( fd_shred_dest_t * sdest,
+               ulong             slot,
+               ulong           * leader_idx ) {
+  if( FD_LIKELY( slot==sdest->leader_cache_slot ) ) {
+    *leader_idx = sdest->leader_cache_idx;
+    return sdest->leader_cache_leader;
+  }
+
+  fd_pubkey_t const * leader = fd_epoch_leaders_get( sdest->lsched, slot );
+  if( FD_UNLIKELY( !leader ) ) return NULL;
+
+  pubkey_to_idx_t * query = pubkey_to_idx_query( sdest->pubkey_to_idx_map, *leader, NULL );
+
+  sdest->leader_cache_slot   = slot;
+  sdest->leader_cache_leader = leader;
+  sdest->leader_cache_idx    = query ? query->idx : ULONG_MAX;
+
+  *leader_idx = sdest->leader_cache_idx;
+  return leader;
+}
+
 /* Returns 0 on success
    https://github.com/anza-xyz/agave/blob/v2.2.1/ledger/src/shred.rs#L293 */
 static inline int
@@ -269,7 +298,8 @@ fd_shred_dest_compute_first( fd_shred_dest_t          * sdest,
   uchar dest_hash_outputs[ FD_SHRED_DEST_MAX_SHRED_CNT ][ 32 ];
 
   ulong slot = input_shreds[0]->slot;
-  fd_pubkey_t const * leader = fd_epoch_leaders_get( sdest->lsched, slot );
+  ulong leader_idx;
+  fd_pubkey_t const * leader = lookup_leader( sdest, slot, &leader_idx );
   if( FD_UNLIKELY( !leader ) ) return NULL;
 
   if( FD_UNLIKELY( compute_seeds( sdest, input_shreds, shred_cnt, leader, slot, dest_hash_outputs ) ) ) return NULL;
@@ -319,11 +349,10 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
   if( FD_UNLIKELY( (shred_cnt==0UL) | (dest_cnt==0UL) ) ) return out; /* Nothing to do */
 
   ulong               slot   = input_shreds[0]->slot;
-  fd_pubkey_t const * leader = fd_epoch_leaders_get   ( sdest->lsched, slot );
-  pubkey_to_idx_t *   query  = pubkey_to_idx_query( sdest->pubkey_to_idx_map, *leader, NULL );
-  int                 leader_is_staked = query ? (query->idx<sdest->staked_cnt): 0;
-  ulong               leader_idx       = query ?  query->idx                   : ULONG_MAX;
+  ulong               leader_idx;
+  fd_pubkey_t const * leader = lookup_leader( sdest, slot, &leader_idx );
   if( FD_UNLIKELY( !leader                 ) ) return NULL; /* Unknown slot */
+  int                 leader_is_staked = leader_idx<sdest->staked_cnt;
   if( FD_UNLIKELY( leader_idx==my_orig_idx ) ) return NULL; /* I am the leader. Use compute_first */
 
   if( FD_UNLIKELY( (sdest->cnt<=1UL) |                    /* We don't know about a single destination, so we can't send
@@ -349,7 +378,7 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
 
   for( ulong i=0UL; i<shred_cnt; i++ ) {
     /* Remove the leader. */
-    if( FD_LIKELY( query && leader_is_staked ) ) fd_wsample_remove_idx( sdest->staked, leader_idx );
+    if( FD_LIKELY( leader_is_staked ) ) fd_wsample_remove_idx( sdest->staked, leader_idx );
 
     ulong my_idx         = 0UL;
     fd_wsample_seed_rng( fd_wsample_get_rng( sdest->staked ), dest_hash_outputs[ i ] ); /* Seeds both samplers since the rng is shared */
@@ -369,7 +398,7 @@ fd_shred_dest_compute_children( fd_shred_dest_t          * sdest,
          start of the function. */
       staked_shuffle_populated_cnt = sdest->staked_cnt + 1UL;
       fd_wsample_sample_and_remove_many( sdest->staked, staked_shuffle, staked_shuffle_populated_cnt );
-      my_idx += sdest->staked_cnt - (ulong)(query && leader_is_staked);
+      my_idx += sdest->staked_cnt - (ulong)leader_is_staked;
 
       prepare_unstaked_sampling( sdest, leader_idx );
       while( my_idx <= fanout ) {
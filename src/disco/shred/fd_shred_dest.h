@@ -71,6 +71,18 @@ struct __attribute__((aligned(FD_SHRED_DEST_ALIGN))) fd_shred_dest_private {
   pubkey_to_idx_t * pubkey_to_idx_map; /* maps pubkey -> [0, staked_cnt+unstaked_cnt) */
 
   ulong source_validator_orig_idx; /* in [0, staked_cnt+unstaked_cnt) */
+
+  /* The shred tile calls compute_children once per received shred, so
+     consecutive calls almost always hit the same slot.  We cache the
+     result of the leader schedule lookup and the pubkey to index query
+     for the most recent slot.  lsched and the destination list don't
+     change over the lifetime of this object, so the cache never needs
+     to be invalidated.  leader_cache_slot==ULONG_MAX means empty, and
+     leader_cache_idx==ULONG_MAX means the leader is not in the
+     destination list. */
+  ulong               leader_cache_slot;
+  fd_pubkey_t const * leader_cache_leader;
+  ulong               leader_cache_idx;
   /* Struct followed by:
      * pubkey_to_idx map
      * all_destinations
@@ -518,21 +518,27 @@ during_frag( fd_shred_ctx_t * ctx,
 
           fd_shredder_init_batch( ctx->shredder, ctx->pending_batch.raw, batch_sz_padded, target_slot, entry_meta );
 
-          ulong pend_sz = batch_sz_padded;
-          while( pend_sz > 0UL ) {
+          /* Produce the FEC sets several at a time so the shredder can
+             generate their parity data together. */
+          ulong pend_cnt = batch_sz_padded / load_for_32_shreds;
+          while( pend_cnt > 0UL ) {
 
-            fd_fec_set_t * out = ctx->fec_sets + ctx->shredder_fec_set_idx;
+            fd_fec_set_t * out[ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+            ulong          out_cnt = fd_ulong_min( pend_cnt, FD_SHREDDER_FEC_SET_BATCH_MAX );
+            for( ulong i=0UL; i<out_cnt; i++ ) out[ i ] = ctx->fec_sets + (ctx->shredder_fec_set_idx+i)%ctx->shredder_max_fec_set_idx;
 
-            FD_TEST( fd_shredder_next_fec_set( ctx->shredder, out, chained_merkle_root ) );
+            FD_TEST( fd_shredder_next_fec_sets( ctx->shredder, out, out_cnt, chained_merkle_root )==out_cnt );
 
-            d_rcvd_join( d_rcvd_new( d_rcvd_delete( d_rcvd_leave( out->data_shred_rcvd   ) ) ) );
-            p_rcvd_join( p_rcvd_new( p_rcvd_delete( p_rcvd_leave( out->parity_shred_rcvd ) ) ) );
+            for( ulong i=0UL; i<out_cnt; i++ ) {
+              d_rcvd_join( d_rcvd_new( d_rcvd_delete( d_rcvd_leave( out[ i ]->data_shred_rcvd   ) ) ) );
+              p_rcvd_join( p_rcvd_new( p_rcvd_delete( p_rcvd_leave( out[ i ]->parity_shred_rcvd ) ) ) );
 
-            ctx->send_fec_set_idx[ ctx->send_fec_set_cnt ] = ctx->shredder_fec_set_idx;
-            ctx->send_fec_set_cnt += 1UL;
-            ctx->shredder_fec_set_idx = (ctx->shredder_fec_set_idx+1UL)%ctx->shredder_max_fec_set_idx;
+              ctx->send_fec_set_idx[ ctx->send_fec_set_cnt ] = ctx->shredder_fec_set_idx;
+              ctx->send_fec_set_cnt += 1UL;
+              ctx->shredder_fec_set_idx = (ctx->shredder_fec_set_idx+1UL)%ctx->shredder_max_fec_set_idx;
+            }
 
-            pend_sz -= load_for_32_shreds;
+            pend_cnt -= out_cnt;
           }
 
           fd_shredder_fini_batch( ctx->shredder );
@@ -133,10 +133,35 @@ fd_shredder_init_batch( fd_shredder_t *               shredder,
 }
 
 
-fd_fec_set_t *
-fd_shredder_next_fec_set( fd_shredder_t * shredder,
-                          fd_fec_set_t *  result,
-                          uchar *         chained_merkle_root ) {
+/* fd_shredder_private_fec_t holds the per FEC set state that
+   fd_shredder_private_prepare computes and fd_shredder_private_finish
+   needs after the parity data has been generated. */
+
+struct fd_shredder_private_fec {
+  ulong data_shred_cnt;
+  ulong parity_shred_cnt;
+  ulong tree_depth;
+  ulong data_merkle_sz;
+  ulong parity_merkle_sz;
+  int   is_resigned;
+};
+typedef struct fd_shredder_private_fec fd_shredder_private_fec_t;
+
+/* fd_shredder_private_prepare extracts the next FEC set from the in
+   progress batch into result: it writes all the headers, copies the
+   payload, and adds the Reed-Solomon protected region of every shred to
+   reedsol, without generating the parity data.  Advances the shredder
+   past the FEC set.  The chained Merkle root isn't part of the region
+   protected by Reed-Solomon, so it is written by
+   fd_shredder_private_finish instead, which lets several FEC sets of a
+   chain be prepared and encoded before the first root is known. */
+
+static void
+fd_shredder_private_prepare( fd_shredder_t *             shredder,
+                             fd_fec_set_t *              result,
+                             int                         is_chained,
+                             fd_reedsol_t *              reedsol,
+                             fd_shredder_private_fec_t * fec ) {
   uchar const * entry_batch = shredder->entry_batch;
   ulong         offset      = shredder->offset;
   ulong         entry_sz    = shredder->sz;
@@ -144,14 +169,9 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
   uchar * * data_shreds   = result->data_shreds;
   uchar * * parity_shreds = result->parity_shreds;
 
-  fd_ed25519_sig_t __attribute__((aligned(32UL))) root_signature;
-
-  if( FD_UNLIKELY( (offset==entry_sz) ) ) return NULL;
-
   /* Set the shred type */
 
   int   block_complete          = shredder->meta.block_complete;
-  int   is_chained              = chained_merkle_root!=NULL;
   int   is_resigned             = is_chained && block_complete; /* only chained are resigned */
 
   uchar data_type = fd_uchar_if( is_chained, fd_uchar_if(
@@ -190,7 +210,7 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
   ulong data_merkle_sz          = parity_shred_payload_sz + 32UL*(uint)is_chained;
   ulong parity_merkle_sz        = data_merkle_sz + FD_SHRED_CODE_HEADER_SZ - FD_SHRED_SIGNATURE_SZ;
 
-  fd_reedsol_t * reedsol = fd_reedsol_encode_init( shredder->reedsol, parity_shred_payload_sz );
+  reedsol = fd_reedsol_encode_init( reedsol, parity_shred_payload_sz );
 
   /* Write headers and copy the data shred payload */
   ulong flags_for_last = ((last_in_batch & (ulong)block_complete)<<7) | (last_in_batch<<6);
@@ -224,12 +244,6 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
     /* Prepare to generate parity data: data shred starts right after
        signature and goes until start of Merkle proof. */
     fd_reedsol_encode_add_data_shred( reedsol, ((uchar*)shred) + sizeof(fd_ed25519_sig_t) );
-
-    /* Optionally, set chained merkle root */
-    if( FD_LIKELY( chained_merkle_root ) ) {
-      uchar * merkle = ((uchar*)shred) + fd_shred_chain_off( shred->variant );
-      memcpy( merkle, chained_merkle_root, FD_SHRED_MERKLE_ROOT_SZ );
-    }
   }
 
   for( ulong j=0UL; j<parity_shred_cnt; j++ ) {
@@ -248,74 +262,163 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
     /* Prepare to generate parity data: parity info starts right after
        signature and goes until start of Merkle proof. */
     fd_reedsol_encode_add_parity_shred( reedsol, parity_shreds[ j ] + FD_SHRED_CODE_HEADER_SZ );
+  }
 
-    /* Optionally, set chained merkle root */
-    if( FD_LIKELY( chained_merkle_root ) ) {
-      uchar * merkle = ((uchar*)shred) + fd_shred_chain_off( shred->variant );
-      memcpy( merkle, chained_merkle_root, FD_SHRED_MERKLE_ROOT_SZ );
+  shredder->offset             = offset;
+  shredder->data_idx_offset   += data_shred_cnt;
+  shredder->parity_idx_offset += parity_shred_cnt;
+
+  fec->data_shred_cnt   = data_shred_cnt;
+  fec->parity_shred_cnt = parity_shred_cnt;
+  fec->tree_depth       = tree_depth;
+  fec->data_merkle_sz   = data_merkle_sz;
+  fec->parity_merkle_sz = parity_merkle_sz;
+  fec->is_resigned      = is_resigned;
+}
+
+/* fd_shredder_private_finish completes FEC sets result[i] for i in
+   [0,cnt) prepared by fd_shredder_private_prepare whose parity data has
+   been generated: it writes the chained Merkle root (if any), computes
+   the Merkle trees, signs the roots and writes the signatures and
+   proofs.  The leaves of all cnt FEC sets are hashed in one SHA-256
+   batch, and their trees are built together layer by layer, which keeps
+   more lanes of the batch busy.  Since the leaves cover the chained
+   Merkle root, which is the root of the previous FEC set, cnt must be 1
+   if chained_merkle_root is non-NULL, in which case it is updated with
+   the new root. */
+
+static void
+fd_shredder_private_finish( fd_shredder_t *                   shredder,
+                            fd_fec_set_t * const *            result,
+                            fd_shredder_private_fec_t const * fec,
+                            ulong                             cnt,
+                            uchar *                           chained_merkle_root ) {
+
+  /* Optionally, set chained merkle root */
+  if( FD_LIKELY( chained_merkle_root ) ) {
+    for( ulong i=0UL; i<fec->data_shred_cnt; i++ ) {
+      fd_shred_t * shred = (fd_shred_t *)result[ 0 ]->data_shreds[ i ];
+      memcpy( ((uchar*)shred) + fd_shred_chain_off( shred->variant ), chained_merkle_root, FD_SHRED_MERKLE_ROOT_SZ );
+    }
+    for( ulong j=0UL; j<fec->parity_shred_cnt; j++ ) {
+      fd_shred_t * shred = (fd_shred_t *)result[ 0 ]->parity_shreds[ j ];
+      memcpy( ((uchar*)shred) + fd_shred_chain_off( shred->variant ), chained_merkle_root, FD_SHRED_MERKLE_ROOT_SZ );
     }
   }
 
-  /* Generate parity data */
-  fd_reedsol_encode_fini( reedsol );
-
   /* Generate Merkle leaves */
   fd_sha256_batch_t * sha256 = fd_sha256_batch_init( shredder->sha256 );
-  fd_bmtree_node_t * leaves = shredder->bmtree_leaves;
-
-  for( ulong i=0UL; i<data_shred_cnt; i++ )
-    fd_sha256_batch_add( sha256, data_shreds[i]+sizeof(fd_ed25519_sig_t)-26UL,   data_merkle_sz+26UL,   leaves[i].hash );
-  for( ulong j=0UL; j<parity_shred_cnt; j++ )
-    fd_sha256_batch_add( sha256, parity_shreds[j]+sizeof(fd_ed25519_sig_t)-26UL, parity_merkle_sz+26UL, leaves[j+data_shred_cnt].hash );
+  for( ulong k=0UL; k<cnt; k++ ) {
+    uchar * * data_shreds   = result[ k ]->data_shreds;
+    uchar * * parity_shreds = result[ k ]->parity_shreds;
+    fd_bmtree_node_t * leaves = shredder->bmtree_leaves[ k ];
+    ulong data_shred_cnt = fec[ k ].data_shred_cnt;
+
+    for( ulong i=0UL; i<data_shred_cnt; i++ )
+      fd_sha256_batch_add( sha256, data_shreds[i]+sizeof(fd_ed25519_sig_t)-26UL,   fec[ k ].data_merkle_sz+26UL,   leaves[i].hash );
+    for( ulong j=0UL; j<fec[ k ].parity_shred_cnt; j++ )
+      fd_sha256_batch_add( sha256, parity_shreds[j]+sizeof(fd_ed25519_sig_t)-26UL, fec[ k ].parity_merkle_sz+26UL, leaves[j+data_shred_cnt].hash );
+  }
   fd_sha256_batch_fini( sha256 );
 
   /* Generate Merkle Proofs */
-  fd_bmtree_commit_t * bmtree = fd_bmtree_commit_init( shredder->_bmtree_footprint, FD_SHRED_MERKLE_NODE_SZ, FD_BMTREE_LONG_PREFIX_SZ, tree_depth+1UL );
-  fd_bmtree_commit_append( bmtree, leaves, data_shred_cnt+parity_shred_cnt );
-  uchar * root = fd_bmtree_commit_fini( bmtree );
+  fd_bmtree_commit_t *     bmtree[ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+  fd_bmtree_node_t const * leaves[ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+  ulong                    leaf_cnt[ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+  uchar *                  root  [ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+  for( ulong k=0UL; k<cnt; k++ ) {
+    bmtree  [ k ] = fd_bmtree_commit_init( shredder->_bmtree_footprint[ k ], FD_SHRED_MERKLE_NODE_SZ, FD_BMTREE_LONG_PREFIX_SZ, fec[ k ].tree_depth+1UL );
+    leaves  [ k ] = shredder->bmtree_leaves[ k ];
+    leaf_cnt[ k ] = fec[ k ].data_shred_cnt + fec[ k ].parity_shred_cnt;
+  }
+  fd_bmtree_commit_batch( bmtree, leaves, leaf_cnt, root, cnt );
 
-  /* Sign Merkle Root */
-  shredder->signer( shredder->signer_ctx, root_signature, root );
+  for( ulong k=0UL; k<cnt; k++ ) {
+    uchar * * data_shreds   = result[ k ]->data_shreds;
+    uchar * * parity_shreds = result[ k ]->parity_shreds;
 
-  /* Write signature and Merkle proof */
-  for( ulong i=0UL; i<data_shred_cnt; i++ ) {
-    fd_shred_t * shred = (fd_shred_t *)data_shreds[ i ];
-    fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
+    ulong data_shred_cnt   = fec[ k ].data_shred_cnt;
+    ulong parity_shred_cnt = fec[ k ].parity_shred_cnt;
+    int   is_resigned      = fec[ k ].is_resigned;
+
+    fd_ed25519_sig_t __attribute__((aligned(32UL))) root_signature;
 
-    uchar * merkle = data_shreds[ i ] + fd_shred_merkle_off( shred );
-    fd_bmtree_get_proof( bmtree, merkle, i );
+    /* Sign Merkle Root */
+    shredder->signer( shredder->signer_ctx, root_signature, root[ k ] );
 
-    /* Agave doesn't seem to set the rentransmitter signature when the shred is first created,
-       i.e. the leader sends shreds with rentransmitter signature set to 0.
-       https://github.com/anza-xyz/agave/blob/v2.2.10/ledger/src/shred/merkle.rs#L1417-L1418 */
-    if( FD_UNLIKELY( is_resigned ) ) {
-      memset( ((uchar*)shred) + fd_shred_retransmitter_sig_off( shred ), 0, 64UL );
+    /* Write signature and Merkle proof */
+    for( ulong i=0UL; i<data_shred_cnt; i++ ) {
+      fd_shred_t * shred = (fd_shred_t *)data_shreds[ i ];
+      fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
+
+      uchar * merkle = data_shreds[ i ] + fd_shred_merkle_off( shred );
+      fd_bmtree_get_proof( bmtree[ k ], merkle, i );
+
+      /* Agave doesn't seem to set the rentransmitter signature when the shred is first created,
+         i.e. the leader sends shreds with rentransmitter signature set to 0.
+         https://github.com/anza-xyz/agave/blob/v2.2.10/ledger/src/shred/merkle.rs#L1417-L1418 */
+      if( FD_UNLIKELY( is_resigned ) ) {
+        memset( ((uchar*)shred) + fd_shred_retransmitter_sig_off( shred ), 0, 64UL );
+      }
     }
-  }
 
-  for( ulong j=0UL; j<parity_shred_cnt; j++ ) {
-    fd_shred_t * shred = (fd_shred_t *)parity_shreds[ j ];
-    fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
+    for( ulong j=0UL; j<parity_shred_cnt; j++ ) {
+      fd_shred_t * shred = (fd_shred_t *)parity_shreds[ j ];
+      fd_memcpy( shred->signature, root_signature, FD_ED25519_SIG_SZ );
+
+      uchar * merkle = parity_shreds[ j ] + fd_shred_merkle_off( shred );
+      fd_bmtree_get_proof( bmtree[ k ], merkle, data_shred_cnt+j );
 
-    uchar * merkle = parity_shreds[ j ] + fd_shred_merkle_off( shred );
-    fd_bmtree_get_proof( bmtree, merkle, data_shred_cnt+j );
+      if( FD_UNLIKELY( is_resigned ) ) {
+        memset( ((uchar*)shred) + fd_shred_retransmitter_sig_off( shred ), 0, 64UL );
+      }
+    }
 
-    if( FD_UNLIKELY( is_resigned ) ) {
-      memset( ((uchar*)shred) + fd_shred_retransmitter_sig_off( shred ), 0, 64UL );
+    if( FD_LIKELY( chained_merkle_root ) ) {
+      memcpy( chained_merkle_root, root[ k ], FD_SHRED_MERKLE_ROOT_SZ );
     }
+
+    result[ k ]->data_shred_cnt   = data_shred_cnt;
+    result[ k ]->parity_shred_cnt = parity_shred_cnt;
   }
+}
 
-  shredder->offset             = offset;
-  shredder->data_idx_offset   += data_shred_cnt;
-  shredder->parity_idx_offset += parity_shred_cnt;
-  if( FD_LIKELY( chained_merkle_root ) ) {
-    memcpy( chained_merkle_root, root, FD_SHRED_MERKLE_ROOT_SZ );
+fd_fec_set_t *
+fd_shredder_next_fec_set( fd_shredder_t * shredder,
+                          fd_fec_set_t *  result,
+                          uchar *         chained_merkle_root ) {
+  return fd_shredder_next_fec_sets( shredder, &result, 1UL, chained_merkle_root ) ? result : NULL;
+}
+
+ulong
+fd_shredder_next_fec_sets( fd_shredder_t *        shredder,
+                           fd_fec_set_t * const * result,
+                           ulong                  result_cnt,
+                           uchar *                chained_merkle_root ) {
+  fd_shredder_private_fec_t fec[ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+  fd_reedsol_t *            rs [ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+
+  result_cnt = fd_ulong_min( result_cnt, FD_SHREDDER_FEC_SET_BATCH_MAX );
+  for( ulong i=0UL; i<FD_SHREDDER_FEC_SET_BATCH_MAX; i++ ) rs[ i ] = shredder->reedsol + i;
+
+  ulong cnt = 0UL;
+  for( ; (cnt<result_cnt) & (shredder->offset<shredder->sz); cnt++ ) {
+    fd_shredder_private_prepare( shredder, result[ cnt ], chained_merkle_root!=NULL, rs[ cnt ], fec+cnt );
   }
 
-  result->data_shred_cnt   = data_shred_cnt;
-  result->parity_shred_cnt = parity_shred_cnt;
+  /* Generate parity data for all the FEC sets at once */
+  fd_reedsol_encode_fini_batch( rs, cnt );
+
+  /* The Merkle root of each FEC set is chained into the next one, so
+     chained FEC sets have to be done in order, one at a time.
+     Otherwise, the Merkle trees can all be done together. */
+  if( FD_LIKELY( chained_merkle_root ) ) {
+    for( ulong i=0UL; i<cnt; i++ ) fd_shredder_private_finish( shredder, result+i, fec+i, 1UL, chained_merkle_root );
+  } else if( FD_LIKELY( cnt ) ) {
+    fd_shredder_private_finish( shredder, result, fec, cnt, NULL );
+  }
 
-  return result;
+  return cnt;
 }
 
 fd_shredder_t * fd_shredder_fini_batch( fd_shredder_t * shredder ) {
@@ -16,6 +16,11 @@
 
 #define FD_FEC_SET_MAX_BMTREE_DEPTH (9UL) /* ceil(log2(DATA_SHREDS_MAX + PARITY_SHREDS_MAX)) */
 
+/* FD_SHREDDER_FEC_SET_BATCH_MAX is the maximum number of FEC sets
+   fd_shredder_next_fec_sets will produce in one call.  Each one needs
+   its own Reed-Solomon encoder and Merkle tree in the shredder. */
+#define FD_SHREDDER_FEC_SET_BATCH_MAX (4UL)
+
 #define FD_SHREDDER_ALIGN     (  128UL)
 /* FD_SHREDDER_FOOTPRINT is not provided because it depends on the footprint
    of fd_sha256_batch_t, which is not invariant (the latter depends on the
@@ -52,12 +57,9 @@ struct __attribute__((aligned(FD_SHREDDER_ALIGN))) fd_shredder_private {
   ushort shred_version;
 
   fd_sha256_batch_t sha256 [ 1 ];
-  fd_reedsol_t      reedsol[ 1 ];
-  union __attribute__((aligned(FD_BMTREE_COMMIT_ALIGN))) {
-    fd_bmtree_commit_t bmtree;
-    uchar _bmtree_footprint[ FD_BMTREE_COMMIT_FOOTPRINT( FD_FEC_SET_MAX_BMTREE_DEPTH ) ];
-  };
-  fd_bmtree_node_t bmtree_leaves[ FD_REEDSOL_DATA_SHREDS_MAX + FD_REEDSOL_PARITY_SHREDS_MAX ];
+  fd_reedsol_t      reedsol[ FD_SHREDDER_FEC_SET_BATCH_MAX ];
+  uchar _bmtree_footprint[ FD_SHREDDER_FEC_SET_BATCH_MAX ][ FD_BMTREE_COMMIT_FOOTPRINT( FD_FEC_SET_MAX_BMTREE_DEPTH ) ] __attribute__((aligned(FD_BMTREE_COMMIT_ALIGN)));
+  fd_bmtree_node_t bmtree_leaves[ FD_SHREDDER_FEC_SET_BATCH_MAX ][ FD_REEDSOL_DATA_SHREDS_MAX + FD_REEDSOL_PARITY_SHREDS_MAX ];
 
   void const * entry_batch;
   ulong        sz;
@@ -290,6 +292,23 @@ fd_shredder_next_fec_set( fd_shredder_t * shredder,
                           fd_fec_set_t *  result,
                           uchar *         chained_merkle_root );
 
+/* fd_shredder_next_fec_sets is the multi FEC set version of
+   fd_shredder_next_fec_set.  It extracts up to
+   min(result_cnt,FD_SHREDDER_FEC_SET_BATCH_MAX) FEC sets from the in
+   progress batch, storing the i-th one in result[i], and returns the
+   number of FEC sets produced (0 if all of the entry batch's data has
+   been consumed already).  The FEC sets produced, including the
+   chaining of Merkle roots from one to the next, are identical to those
+   from the same number of consecutive calls to fd_shredder_next_fec_set.
+   The difference is that the parity data for all of them is generated
+   together with fd_reedsol_encode_fini_batch, which is faster when
+   producing several FEC sets in a row, e.g. for large blocks. */
+ulong
+fd_shredder_next_fec_sets( fd_shredder_t *        shredder,
+                           fd_fec_set_t * const * result,
+                           ulong                  result_cnt,
+                           uchar *                chained_merkle_root );
+
 /* fd_shredder_fini_batch finishes the in process batch.  shredder must
    be a valid local join that is currently in a batch.  Upon return,
    shredder will no longer be in a batch and will be ready to begin a
@@ -429,12 +429,43 @@ test_indeterminate( void ) {
   fd_rng_delete( fd_rng_leave( r ) );
 }
 
+/* bench_children measures compute_children from the perspective of the
+   validator sdest was created for.  Besides the time per shred, it
+   reports the number of destinations produced per second, which is what
+   bounds the retransmit rate of the shred tile. */
+static void
+bench_children( fd_shred_dest_t * sdest,
+                ulong             src_idx,
+                ulong             batch_cnt,
+                ulong             iter_cnt ) {
+  ulong max_dest_cnt[ 1 ];
+  fd_shred_t shred[ 16 ];
+  fd_shred_t const * shred_ptr[ 16 ];
+  fd_shred_dest_idx_t result[ 16*200 ];
+  for( ulong j=0UL; j<16UL; j++ ) {
+    shred_ptr[j] = shred+j;
+
+    shred[j].slot = 1UL;
+    shred[j].variant = j<8UL ? FD_SHRED_TYPE_MERKLE_DATA : FD_SHRED_TYPE_MERKLE_CODE;
+  }
+
+  ulong dest_cnt = 0UL;
+  long dt = -fd_log_wallclock();
+  for( ulong j=0UL; j<iter_cnt; j++ ) {
+    for( ulong k=0UL; k<batch_cnt; k++ ) shred[k].idx = (uint)(j*batch_cnt+k);
+    FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, batch_cnt, result, batch_cnt, 200UL, 200UL, max_dest_cnt ) );
+    for( ulong k=0UL; k<batch_cnt; k++ ) for( ulong l=0UL; l<*max_dest_cnt; l++ ) dest_cnt += result[ l*batch_cnt+k ]!=FD_SHRED_DEST_NO_DEST;
+  }
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "Compute children (src %2lu, %2lu shred/batch): %.2f ns/shred, %.0f dest/s",
+                  src_idx, batch_cnt, (double)dt / (double)(batch_cnt*iter_cnt), 1e9*(double)dest_cnt / (double)dt ));
+}
+
 static void
 test_performance( void ) {
   ulong cnt = testnet_dest_info_sz / sizeof(fd_shred_dest_weighted_t);
   fd_shred_dest_weighted_t const * info = (fd_shred_dest_weighted_t const *)testnet_dest_info;
 
-  fd_pubkey_t const * src_key = (fd_pubkey_t const *)(&info[18].pubkey);
   FD_TEST( cnt                                        <= TEST_MAX_VALIDATORS );
 
   ulong staked = 0UL;
@@ -447,41 +478,31 @@ test_performance( void ) {
   FD_TEST( fd_shred_dest_footprint   ( staked, cnt-staked ) <= TEST_MAX_FOOTPRINT  );
   FD_TEST( fd_epoch_leaders_footprint( cnt,       10000UL ) <= TEST_MAX_FOOTPRINT  );
 
-  long dt = -fd_log_wallclock();
   fd_epoch_leaders_t * lsched = fd_epoch_leaders_join( fd_epoch_leaders_new( _l_footprint, 0UL, 0UL, 10000UL, staked, stakes, 0UL ) );
-  fd_shred_dest_t    * sdest  = fd_shred_dest_join   ( fd_shred_dest_new   ( _sd_footprint, info, cnt, lsched, src_key, 0UL ) );
-  dt += fd_log_wallclock();
 
-  ulong max_dest_cnt[ 16 ] = { 0UL };
-  fd_shred_t shred[ 16 ];
-  fd_shred_t const * shred_ptr[ 16 ];
-  fd_shred_dest_idx_t result[ 16*200 ];
-  for( ulong j=0UL; j<16UL; j++ ) {
-    shred_ptr[j] = shred+j;
+  /* info[18] is a mid-stake validator that is almost always at the
+     bottom of the tree, the common case.  info[0] has the most stake, so
+     it often lands in the first layer and has to compute a full set of
+     destinations. */
+  ulong src_idxs[ 2 ] = { 18UL, 0UL };
+  for( ulong s=0UL; s<2UL; s++ ) {
+    fd_pubkey_t const * src_key = (fd_pubkey_t const *)(&info[ src_idxs[ s ] ].pubkey);
+    fd_shred_dest_t   * sdest   = fd_shred_dest_join( fd_shred_dest_new( _sd_footprint, info, cnt, lsched, src_key, 0UL ) );
+    FD_TEST( sdest );
+
+    /* The leader of slot 1 would be its own source */
+    if( FD_UNLIKELY( !memcmp( fd_epoch_leaders_get( lsched, 1UL ), src_key, 32UL ) ) ) {
+      fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
+      continue;
+    }
 
-    shred[j].slot = 1UL;
-    shred[j].variant = j<8UL ? FD_SHRED_TYPE_MERKLE_DATA : FD_SHRED_TYPE_MERKLE_CODE;
-  }
+    bench_children( sdest, src_idxs[ s ],  1UL, s==0UL ? 1000000UL : 100000UL );
+    bench_children( sdest, src_idxs[ s ], 16UL, 10000UL );
 
-  dt = -fd_log_wallclock();
-#define TEST_CNT 1000000
-  for( ulong j=0UL; j<TEST_CNT; j++ ) {
-    shred[0].idx = (uint)j;
-    FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 1UL, result, 1UL, 200UL, 200UL, max_dest_cnt ) );
-  }
-  dt += fd_log_wallclock();
-  FD_LOG_NOTICE(( "Compute children (1 shred/batch): %.2f ns/shred", (double)dt / (double)TEST_CNT ));
-
-  dt = -fd_log_wallclock();
-#undef TEST_CNT
-#define TEST_CNT 10000
-  for( ulong j=0UL; j<TEST_CNT; j++ ) {
-    for( ulong k=0UL; k<16UL; k++ ) shred[k].idx = (uint)(j*16UL+k);
-    FD_TEST( fd_shred_dest_compute_children( sdest, shred_ptr, 16UL, result, 16UL, 200UL, 200UL, max_dest_cnt ) );
+    fd_shred_dest_delete( fd_shred_dest_leave( sdest ) );
   }
-  dt += fd_log_wallclock();
-  FD_LOG_NOTICE(( "Compute children (16 shred/batch): %.2f ns/shred", (double)dt / (double)(16UL*TEST_CNT) ));
-#undef TEST_CNT
+
+  fd_epoch_leaders_delete( fd_epoch_leaders_leave( lsched ) );
 }
 
 int
@@ -17,6 +17,12 @@ uchar skip_test_data[ SKIP_TEST_SZ ];
 uchar fec_set_memory_1[ 2048UL * FD_REEDSOL_DATA_SHREDS_MAX   ];
 uchar fec_set_memory_2[ 2048UL * FD_REEDSOL_PARITY_SHREDS_MAX ];
 
+/* Used by test_next_fec_sets and perf_test.  Two groups of MULTI_SET_CNT
+   FEC sets with a 1280 byte stride between shreds. */
+#define MULTI_SET_CNT (6UL)
+#define MULTI_STRIDE  (1280UL)
+uchar multi_fec_set_memory[ 2UL ][ MULTI_SET_CNT ][ MULTI_STRIDE*(FD_REEDSOL_DATA_SHREDS_MAX+FD_REEDSOL_PARITY_SHREDS_MAX) ];
+
 /* First 32B of what Solana calls the private key is what we call the
    private key, second 32B are what we call the public key. */
 FD_IMPORT_BINARY( test_private_key, "src/disco/shred/fixtures/demo-shreds.key"  );
@@ -452,6 +458,84 @@ test_chained_merkle_shreds( void ) {
   FD_TEST( fd_memeq( chained_merkle_root, expected_final_chained_merkle_root, 32 ) );
 }
 
+static void
+multi_sets_init( fd_fec_set_t * sets,
+                 ulong          group ) {
+  for( ulong i=0UL; i<MULTI_SET_CNT; i++ ) {
+    uchar * mem = multi_fec_set_memory[ group ][ i ];
+    for( ulong j=0UL; j<FD_REEDSOL_DATA_SHREDS_MAX;   j++ ) sets[ i ].data_shreds  [ j ] = mem + MULTI_STRIDE*j;
+    for( ulong j=0UL; j<FD_REEDSOL_PARITY_SHREDS_MAX; j++ ) sets[ i ].parity_shreds[ j ] = mem + MULTI_STRIDE*(j+FD_REEDSOL_DATA_SHREDS_MAX);
+  }
+}
+
+static void
+test_next_fec_sets( void ) {
+  signer_ctx_t signer_ctx[ 1 ];
+  signer_ctx_init( signer_ctx, test_private_key );
+  FD_TEST( _shredder==fd_shredder_new( _shredder, test_signer, signer_ctx, (ushort)6051 ) );
+  fd_shredder_t * shredder = fd_shredder_join( _shredder );           FD_TEST( shredder );
+
+  fd_fec_set_t ref[ MULTI_SET_CNT ];  multi_sets_init( ref, 0UL );
+  fd_fec_set_t tst[ MULTI_SET_CNT ];  multi_sets_init( tst, 1UL );
+  fd_fec_set_t * tst_ptr[ MULTI_SET_CNT ];
+  for( ulong i=0UL; i<MULTI_SET_CNT; i++ ) tst_ptr[ i ] = tst+i;
+
+  for( ulong i=0UL; i<PERF_TEST_SZ; i++ ) perf_test_entry_batch[ i ] = (uchar)fd_ulong_hash( i );
+
+  fd_entry_batch_meta_t meta[1];
+  fd_memset( meta, 0, sizeof(fd_entry_batch_meta_t) );
+  meta->parent_offset = 1;
+
+  /* Unchained, chained and chained+resigned batches with a few sizes,
+     including ones where the last FEC set is not 32:32. */
+  for( ulong variant=0UL; variant<3UL; variant++ ) {
+    int   is_chained     = variant>0UL;
+    meta->block_complete = variant==2UL;
+    ulong type           = is_chained ? ( meta->block_complete ? FD_SHRED_TYPE_MERKLE_DATA_CHAINED_RESIGNED : FD_SHRED_TYPE_MERKLE_DATA_CHAINED )
+                                      : FD_SHRED_TYPE_MERKLE_DATA;
+    for( ulong sz=1000UL; sz<=200000UL; sz+=19999UL ) {
+      ulong set_cnt = fd_shredder_count_fec_sets( sz, type );
+      FD_TEST( set_cnt<=MULTI_SET_CNT );
+
+      uchar ref_root[ 32 ]; fd_memset( ref_root, 7, 32UL );
+      uchar tst_root[ 32 ]; fd_memset( tst_root, 7, 32UL );
+
+      ulong slot = 100UL+sz;
+      FD_TEST( fd_shredder_init_batch( shredder, perf_test_entry_batch, sz, slot, meta ) );
+      for( ulong i=0UL; i<set_cnt; i++ ) FD_TEST( fd_shredder_next_fec_set( shredder, ref+i, is_chained ? ref_root : NULL ) );
+      FD_TEST( !fd_shredder_next_fec_set( shredder, ref, is_chained ? ref_root : NULL ) );
+      fd_shredder_fini_batch( shredder );
+
+      /* Same slot again, so rewind the shred indices */
+      shredder->data_idx_offset   = 0UL;
+      shredder->parity_idx_offset = 0UL;
+      shredder->slot              = ULONG_MAX;
+
+      /* Ask for a varying number of sets per call */
+      FD_TEST( fd_shredder_init_batch( shredder, perf_test_entry_batch, sz, slot, meta ) );
+      ulong done = 0UL;
+      for( ulong want=1UL; done<set_cnt; want=want%(MULTI_SET_CNT+1UL)+1UL ) {
+        ulong got = fd_shredder_next_fec_sets( shredder, tst_ptr+done, fd_ulong_min( want, MULTI_SET_CNT-done ), is_chained ? tst_root : NULL );
+        FD_TEST( got==fd_ulong_min( fd_ulong_min( want, FD_SHREDDER_FEC_SET_BATCH_MAX ), set_cnt-done ) );
+        done += got;
+      }
+      FD_TEST( !fd_shredder_next_fec_sets( shredder, tst_ptr, MULTI_SET_CNT, is_chained ? tst_root : NULL ) );
+      fd_shredder_fini_batch( shredder );
+      shredder->data_idx_offset   = 0UL;
+      shredder->parity_idx_offset = 0UL;
+      shredder->slot              = ULONG_MAX;
+
+      FD_TEST( fd_memeq( ref_root, tst_root, 32UL ) );
+      for( ulong i=0UL; i<set_cnt; i++ ) {
+        FD_TEST( ref[ i ].data_shred_cnt  ==tst[ i ].data_shred_cnt   );
+        FD_TEST( ref[ i ].parity_shred_cnt==tst[ i ].parity_shred_cnt );
+        for( ulong j=0UL; j<ref[ i ].data_shred_cnt;   j++ ) FD_TEST( fd_memeq( ref[ i ].data_shreds  [ j ], tst[ i ].data_shreds  [ j ], FD_SHRED_MIN_SZ ) );
+        for( ulong j=0UL; j<ref[ i ].parity_shred_cnt; j++ ) FD_TEST( fd_memeq( ref[ i ].parity_shreds[ j ], tst[ i ].parity_shreds[ j ], FD_SHRED_MAX_SZ ) );
+      }
+    }
+  }
+}
+
 static void
 perf_test( void ) {
   for( ulong i=0UL; i<PERF_TEST_SZ; i++ )  perf_test_entry_batch[ i ] = (uchar)i;
@@ -483,6 +567,21 @@ perf_test( void ) {
   dt += fd_log_wallclock();
   FD_LOG_NOTICE(( "%li ns/10 MB entry batch = %.3f Gbps", dt/(long)iterations, (double)(8UL * iterations * PERF_TEST_SZ)/(double)dt ));
 
+  /* Same, but FD_SHREDDER_FEC_SET_BATCH_MAX FEC sets at a time */
+  fd_fec_set_t   sets[ MULTI_SET_CNT ];  multi_sets_init( sets, 0UL );
+  fd_fec_set_t * set_ptr[ MULTI_SET_CNT ];
+  for( ulong i=0UL; i<MULTI_SET_CNT; i++ ) set_ptr[ i ] = sets+i;
+
+  dt = -fd_log_wallclock();
+  for( ulong iter=0UL; iter<iterations; iter++ ) {
+    fd_shredder_init_batch( shredder, perf_test_entry_batch, PERF_TEST_SZ, 0UL, meta );
+    while( fd_shredder_next_fec_sets( shredder, set_ptr, FD_SHREDDER_FEC_SET_BATCH_MAX, /* chained */ NULL ) );
+    fd_shredder_fini_batch( shredder );
+  }
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "%li ns/10 MB entry batch = %.3f Gbps (%lu FEC sets per call)", dt/(long)iterations,
+                  (double)(8UL * iterations * PERF_TEST_SZ)/(double)dt, FD_SHREDDER_FEC_SET_BATCH_MAX ));
+
 }
 
 
@@ -546,6 +645,7 @@ main( int     argc,
   test_shredder_count_chained();
   test_shredder_count_resigned();
   test_chained_merkle_shreds();
+  test_next_fec_sets();
   perf_test();
   perf_test2();
 
@@ -137,7 +137,21 @@
       AFTER_POLL_OVERRUN
    Is called when an overrun is detected while polling for new frags.
    This callback is not called when an overrun is detected in
-   during_frag. */
+   during_frag.
+
+   A tile can also opt into a batched mode for high rate links of small
+   frags by defining STEM_BATCH to the max number of frags to handle
+   in one batch.  After finding a new frag on an in, the stem checks
+   once how many frags after it are already published
+   (fd_mcache_seq_run) and that it has the credits for, and handles up
+   to STEM_BATCH of them back to back, without checking for flow
+   control credits or calling the BEFORE_CREDIT and AFTER_CREDIT
+   callbacks in between.  Housekeeping runs once per batch (so it is
+   delayed by at most STEM_BATCH frags), and the regime ticks of the
+   batch are accounted for once when it ends, with the housekeeping and
+   prefrag ticks before its first frag and the rest as busy processing
+   frags.  This is only suitable for tiles that don't need the credit
+   callbacks to run between every frag. */
 
 #if !FD_HAS_ALLOCA
 #error "fd_stem requires alloca"
@@ -164,6 +178,10 @@
 #define STEM_LAZY (0L)
 #endif
 
+#if defined(STEM_BATCH) && !(STEM_BATCH>=1UL)
+#error "STEM_BATCH must be positive"
+#endif
+
 static inline void
 STEM_(in_update)( fd_stem_tile_in_t * in ) {
   fd_fseq_update( in->fseq, in->seq );
@@ -534,6 +552,12 @@ STEM_(run1)( ulong                        in_cnt,
     in_seq++;
     if( in_seq>=in_cnt ) in_seq = 0UL; /* cmov */
 
+#ifdef STEM_BATCH
+    ulong run_rem = 0UL; /* number of frags of this_in after the current one to handle in this batch */
+    int   run_new = 1;   /* 1 for the first frag of the batch */
+STEM_(next_frag): ;
+#endif
+
     /* Check if this in has any new fragments to mux */
 
     ulong                  this_in_seq   = this_in->seq;
@@ -569,6 +593,13 @@ STEM_(run1)( ulong                        in_cnt,
         STEM_CALLBACK_AFTER_POLL_OVERRUN( ctx );
 #endif
       }
+#ifdef STEM_BATCH
+      if( FD_UNLIKELY( !run_new ) ) { /* Ended a batch early, the ticks so far were spent on its frags */
+        housekeeping_regime = &metric_regime_ticks[1];
+        prefrag_regime = &metric_regime_ticks[4];
+        finish_regime = &metric_regime_ticks[7];
+      }
+#endif
 
       /* Don't bother with spin as polling multiple locations */
       *housekeeping_regime += housekeeping_ticks;
@@ -579,6 +610,16 @@ STEM_(run1)( ulong                        in_cnt,
       continue;
     }
 
+#ifdef STEM_BATCH
+    /* Size the batch once, to the frags that are already published and
+       that we have the credits to handle. */
+    if( FD_UNLIKELY( run_new ) ) {
+      ulong run_max = fd_ulong_min( STEM_BATCH, cr_avail/burst ) - 1UL;
+      run_rem = fd_mcache_seq_run( this_in->mcache, this_in->depth, fd_seq_inc( this_in_seq, 1UL ), run_max );
+      run_new = 0;
+    }
+#endif
+
 #ifdef STEM_CALLBACK_BEFORE_FRAG
     int filter = STEM_CALLBACK_BEFORE_FRAG( ctx, (ulong)this_in->idx, seq_found, sig );
     if( FD_UNLIKELY( filter<0 ) ) {
@@ -596,6 +637,12 @@ STEM_(run1)( ulong                        in_cnt,
       this_in->seq   = this_in_seq;
       this_in->mline = this_in->mcache + fd_mcache_line_idx( this_in_seq, this_in->depth );
 
+#ifdef STEM_BATCH
+      if( FD_LIKELY( run_rem ) ) {
+        run_rem--;
+        goto STEM_(next_frag);
+      }
+#endif
       metric_regime_ticks[1] += housekeeping_ticks;
       metric_regime_ticks[4] += prefrag_ticks;
       long next = fd_tickcount();
@@ -654,6 +701,14 @@ STEM_(run1)( ulong                        in_cnt,
     this_in->accum[ FD_METRICS_COUNTER_LINK_CONSUMED_COUNT_OFF ]++;
     this_in->accum[ FD_METRICS_COUNTER_LINK_CONSUMED_SIZE_BYTES_OFF ] += (uint)sz;
 
+#ifdef STEM_BATCH
+    /* The ticks of the whole batch are accounted for once it is done,
+       on whichever path it ends. */
+    if( FD_LIKELY( run_rem ) ) {
+      run_rem--;
+      goto STEM_(next_frag);
+    }
+#endif
     metric_regime_ticks[1] += housekeeping_ticks;
     metric_regime_ticks[4] += prefrag_ticks;
     long next = fd_tickcount();
@@ -732,6 +787,7 @@ STEM_(run)( fd_topo_t *      topo,
 #undef STEM_NAME
 #undef STEM_
 #undef STEM_BURST
+#undef STEM_BATCH
 #undef STEM_CALLBACK_CONTEXT_TYPE
 #undef STEM_LAZY
 #undef STEM_CALLBACK_SHOULD_SHUTDOWN
@@ -171,6 +171,8 @@ struct fd_topo_tile {
       /* sock specific options */
       int so_sndbuf;
       int so_rcvbuf;
+      int udp_gro;
+      int udp_gso;
     } sock;
 
     struct {
@@ -191,6 +193,8 @@ struct fd_topo_tile {
       ulong  idle_timeout_millis;
       uint   ack_delay_millis;
       int    retry;
+      uint   txn_rate_per_connection;
+      uint   txn_burst_per_connection;
     } quic;
 
     struct {
@@ -221,6 +225,8 @@ struct fd_topo_tile {
       int   larger_shred_limits_per_block;
       int   use_consumed_cus;
       int   schedule_strategy;
+      int   sched_policy;
+      int   cost_estimation;
       struct {
         int   enabled;
         uchar tip_distribution_program_addr[ 32 ];
@@ -232,6 +238,10 @@ struct fd_topo_tile {
       } bundle;
     } pack;
 
+    struct {
+      int   cost_observations;
+    } bank;
+
     struct {
       int   lagged_consecutive_leader_start;
       int   plugins_enabled;
@@ -326,16 +336,21 @@ struct fd_topo_tile {
 
     struct {
       ulong funk_obj_id;
+      ulong funk_reader_idx;
 
       ulong capture_start_slot;
       char  dump_proto_dir[ PATH_MAX ];
       int   dump_instr_to_pb;
       int   dump_txn_to_pb;
       int   dump_syscall_to_pb;
+
+      int   jit;
+      int   fuse;
     } exec;
 
     struct {
       ulong funk_obj_id;
+      ulong funk_reader_idx;
     } writer;
 
     struct {
@@ -412,6 +427,7 @@ struct fd_topo_tile {
 
     struct {
       ulong   funk_obj_id;
+      ulong   funk_reader_idx;
       ushort  rpc_port;
       ushort  tpu_port;
       uint    tpu_ip_addr;
@@ -436,6 +452,7 @@ struct fd_topo_tile {
 
     struct {
       ulong funk_obj_id;
+      ulong funk_reader_idx;
       char  identity_key_path[ PATH_MAX ];
       char  vote_acc_path[ PATH_MAX ];
     } tower;
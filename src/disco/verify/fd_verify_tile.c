@@ -148,8 +148,9 @@ after_frag( fd_verify_ctx_t *   ctx,
   }
 
   ulong realized_sz = fd_txn_m_realized_footprint( txnm, 1, 0 );
-  ulong tspub = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
-  fd_stem_publish( stem, 0UL, 0UL, ctx->out_chunk, realized_sz, 0UL, tsorig, tspub );
+  ulong sig_out     = is_bundle ? 0UL : fd_verify_dedup_sig( fd_txn_m_payload( txnm )+txnt->signature_off );
+  ulong tspub       = (ulong)fd_frag_meta_ts_comp( fd_tickcount() );
+  fd_stem_publish( stem, 0UL, sig_out, ctx->out_chunk, realized_sz, 0UL, tsorig, tspub );
   ctx->out_chunk = fd_dcache_compact_next( ctx->out_chunk, realized_sz, ctx->out_chunk0, ctx->out_wmark );
 }
 
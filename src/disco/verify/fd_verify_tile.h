@@ -13,6 +13,18 @@
 
 extern fd_topo_run_tile_t fd_tile_verify;
 
+/* fd_verify_dedup_sig returns the frag sig that a verify tile publishes
+   a txn with.  signature points to the first signature of the txn.
+   Dedup tiles partition txns by this value, so it must not depend on
+   which verify tile saw the txn (it is not seeded like the HA dedup
+   tag).  Bundle txns are published with sig 0 instead, so that all
+   txns of a bundle go to the same dedup tile. */
+
+FD_FN_PURE static inline ulong
+fd_verify_dedup_sig( uchar const * signature ) {
+  return fd_ulong_hash( FD_LOAD( ulong, signature ) );
+}
+
 /* fd_verify_in_ctx_t is a context object for each in (producer) mcache
    connected to the verify tile. */
 
@@ -209,6 +209,13 @@ fd_app_verify_task( int     argc,
   uint  dup_seq = 0U;
   ulong ha_tag  = fd_rng_ulong( rng );
 
+  /* Sigverify throughput is reported about once a second as verifies
+     per second of time spent verifying, i.e. per core. */
+
+  ulong accum_sv_cnt   = 0UL;
+  long  accum_sv_ticks = 0L;
+  long  report_next    = then + (long)(1e9f*tick_per_ns);
+
 # endif
 
   fd_cnc_signal( cnc, FD_CNC_SIGNAL_RUN );
@@ -253,6 +260,18 @@ fd_app_verify_task( int     argc,
         }
       }
 
+#     if SYNTH_LOAD
+      if( FD_UNLIKELY( (now-report_next)>=0L ) ) {
+        if( FD_LIKELY( accum_sv_ticks>0L ) ) {
+          double sv_ns = (double)accum_sv_ticks / (double)tick_per_ns;
+          FD_LOG_NOTICE(( "verify.%s %.3e verifies/sec/core (%lu verifies)", verify_name, 1e9*(double)accum_sv_cnt/sv_ns, accum_sv_cnt ));
+        }
+        accum_sv_cnt   = 0UL;
+        accum_sv_ticks = 0L;
+        report_next    = now + (long)(1e9f*tick_per_ns);
+      }
+#     endif
+
       /* Reload housekeeping timer */
       then = now + (long)fd_tempo_async_reload( rng, async_min );
     }
@@ -373,7 +392,10 @@ fd_app_verify_task( int     argc,
          expensively get the same effect by corrupting the udp_payload
          region before the verify.) */
 
-      int err = fd_ed25519_verify( msg, msg_sz, sig, public_key, sha );
+      long sv_start = fd_tickcount();
+      int  err      = fd_ed25519_verify( msg, msg_sz, sig, public_key, sha );
+      accum_sv_ticks += fd_tickcount() - sv_start;
+      accum_sv_cnt++;
 
       FD_TEST( !err ); /* These should always pass here */
       if( FD_UNLIKELY( fd_rng_uint( rng )<=errsv_thresh ) ) { /* And model random failures at some low rate */
@@ -10,6 +10,8 @@
 
 #include "../../funk/fd_funk.h"
 
+#include <sys/mman.h> /* PROT_* */
+
 struct fd_exec_tile_out_ctx {
   ulong       idx;
   fd_wksp_t * mem;
@@ -45,6 +47,7 @@ struct fd_exec_tile_ctx {
   fd_wksp_t *           exec_spad_wksp;
 
   fd_funk_t             funk[1];
+  ulong                 funk_reader_idx; /* See fd_funk_reader_init */
 
   /* Data structures related to managing and executing the transaction.
      The fd_txn_p_t is refreshed with every transaction and is sent
@@ -78,6 +81,14 @@ struct fd_exec_tile_ctx {
   fd_bank_t *           bank;
 
   fd_capture_ctx_t *    capture_ctx;
+
+  /* Native code for the BPF programs this tile runs, NULL if the jit
+     is disabled ([tiles.exec.jit]). */
+  fd_bpf_jit_cache_t *  jit_cache;
+
+  /* 1 if the interpreter dispatches superinstructions
+     ([tiles.exec.fuse]). */
+  int                   vm_fuse;
 };
 typedef struct fd_exec_tile_ctx fd_exec_tile_ctx_t;
 
@@ -87,11 +98,18 @@ scratch_align( void ) {
 }
 
 FD_FN_PURE static inline ulong
-scratch_footprint( fd_topo_tile_t const * tile FD_PARAM_UNUSED ) {
+jit_cache_footprint( fd_topo_tile_t const * tile ) {
+  if( !tile->exec.jit ) return 0UL;
+  return fd_bpf_jit_cache_footprint( FD_BPF_JIT_CACHE_ENTRY_MAX_DEFAULT, FD_BPF_JIT_CACHE_TEXT_MAX_DEFAULT );
+}
+
+FD_FN_PURE static inline ulong
+scratch_footprint( fd_topo_tile_t const * tile ) {
   /* clang-format off */
   ulong l = FD_LAYOUT_INIT;
   l       = FD_LAYOUT_APPEND( l, alignof(fd_exec_tile_ctx_t),  sizeof(fd_exec_tile_ctx_t) );
   l       = FD_LAYOUT_APPEND( l, FD_CAPTURE_CTX_ALIGN, FD_CAPTURE_CTX_FOOTPRINT );
+  l       = FD_LAYOUT_APPEND( l, fd_bpf_jit_cache_align(), jit_cache_footprint( tile ) );
   return FD_LAYOUT_FINI( l, scratch_align() );
   /* clang-format on */
 }
@@ -142,6 +160,8 @@ execute_txn( fd_exec_tile_ctx_t * ctx ) {
 
   fd_exec_txn_ctx_setup( ctx->txn_ctx, txn_descriptor, &raw_txn );
   ctx->txn_ctx->capture_ctx = ctx->capture_ctx;
+  ctx->txn_ctx->jit_cache   = ctx->jit_cache;
+  ctx->txn_ctx->vm_fuse     = ctx->vm_fuse;
 
   /* Set up the core account keys. These are the account keys directly
      passed in via the serialized transaction, represented as an array.
@@ -149,6 +169,10 @@ execute_txn( fd_exec_tile_ctx_t * ctx ) {
      address lookup tables. */
   fd_executor_setup_txn_account_keys( ctx->txn_ctx );
 
+  /* Start pulling the accounts into cache so their funk lookups
+     overlap with signature verification. */
+  fd_acc_mgr_prefetch( ctx->funk, ctx->txn_ctx->account_keys, ctx->txn_ctx->accounts_cnt );
+
   if( FD_UNLIKELY( fd_executor_txn_verify( ctx->txn_ctx )!=0 ) ) {
     FD_LOG_WARNING(( "sigverify failed: %s", FD_BASE58_ENC_64_ALLOCA( (uchar *)ctx->txn_ctx->_txn_raw->raw+ctx->txn_ctx->txn_descriptor->signature_off ) ));
     task_info.txn->flags = 0U;
@@ -271,17 +295,20 @@ during_frag( fd_exec_tile_ctx_t * ctx,
                     ctx->replay_in_wmark ));
     }
 
+    /* The replay tile publishes rooted slots while we read, so keep the
+       records it replaces from being recycled under us until we are
+       done with this message. */
+    fd_funk_reader_enter( ctx->funk, ctx->funk_reader_idx );
+
     if( FD_LIKELY( sig==EXEC_NEW_TXN_SIG ) ) {
       fd_runtime_public_txn_msg_t * txn = (fd_runtime_public_txn_msg_t *)fd_chunk_to_laddr( ctx->replay_in_mem, chunk );
       ctx->txn  = txn->txn;
       ctx->slot = txn->slot;
       execute_txn( ctx );
-      return;
     } else if( sig==EXEC_HASH_ACCS_SIG ) {
       fd_runtime_public_hash_bank_msg_t * msg = fd_chunk_to_laddr( ctx->replay_in_mem, chunk );
       FD_LOG_DEBUG(( "hash accs=%lu msg recvd", msg->end_idx - msg->start_idx ));
       hash_accounts( ctx, msg );
-      return;
     } else if( sig==EXEC_SNAP_HASH_ACCS_CNT_SIG ) {
       FD_LOG_DEBUG(( "snap hash count msg recvd" ));
       snap_hash_count( ctx );
@@ -292,6 +319,8 @@ during_frag( fd_exec_tile_ctx_t * ctx,
     } else {
       FD_LOG_ERR(( "Unknown signature" ));
     }
+
+    fd_funk_reader_leave( ctx->funk, ctx->funk_reader_idx );
   }
 }
 
@@ -350,8 +379,26 @@ after_frag( fd_exec_tile_ctx_t * ctx,
 }
 
 static void
-privileged_init( fd_topo_t *      topo FD_PARAM_UNUSED,
-                 fd_topo_tile_t * tile FD_PARAM_UNUSED ) {
+privileged_init( fd_topo_t *      topo,
+                 fd_topo_tile_t * tile ) {
+
+  void * scratch = fd_topo_obj_laddr( topo, tile->tile_obj_id );
+
+  FD_SCRATCH_ALLOC_INIT( l, scratch );
+  fd_exec_tile_ctx_t * ctx           = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_exec_tile_ctx_t), sizeof(fd_exec_tile_ctx_t) );
+  /**/                                 FD_SCRATCH_ALLOC_APPEND( l, FD_CAPTURE_CTX_ALIGN, FD_CAPTURE_CTX_FOOTPRINT );
+  void *               jit_cache_mem = FD_SCRATCH_ALLOC_APPEND( l, fd_bpf_jit_cache_align(), jit_cache_footprint( tile ) );
+
+  /* The jit cache maps the code pages of its jits, which is not
+     possible once sandboxed. */
+
+  ctx->jit_cache = NULL;
+  if( tile->exec.jit ) {
+    ctx->jit_cache = fd_bpf_jit_cache_join( fd_bpf_jit_cache_new( jit_cache_mem, FD_BPF_JIT_CACHE_ENTRY_MAX_DEFAULT, FD_BPF_JIT_CACHE_TEXT_MAX_DEFAULT ) );
+    if( FD_UNLIKELY( !ctx->jit_cache ) ) {
+      FD_LOG_ERR(( "Failed to create jit cache" ));
+    }
+  }
 }
 
 static void
@@ -367,6 +414,7 @@ unprivileged_init( fd_topo_t *      topo,
   FD_SCRATCH_ALLOC_INIT( l, scratch );
   fd_exec_tile_ctx_t * ctx               = FD_SCRATCH_ALLOC_APPEND( l, alignof(fd_exec_tile_ctx_t), sizeof(fd_exec_tile_ctx_t) );
   void *               capture_ctx_mem   = FD_SCRATCH_ALLOC_APPEND( l, FD_CAPTURE_CTX_ALIGN, FD_CAPTURE_CTX_FOOTPRINT );
+  /* jit cache, set up in privileged_init */ FD_SCRATCH_ALLOC_APPEND( l, fd_bpf_jit_cache_align(), jit_cache_footprint( tile ) );
   ulong                scratch_alloc_mem = FD_SCRATCH_ALLOC_FINI( l, scratch_align() );
   if( FD_UNLIKELY( scratch_alloc_mem - (ulong)scratch  - scratch_footprint( tile ) ) ) {
     FD_LOG_ERR( ( "Scratch_alloc_mem did not match scratch_footprint diff: %lu alloc: %lu footprint: %lu",
@@ -381,6 +429,7 @@ unprivileged_init( fd_topo_t *      topo,
 
   ctx->tile_cnt = fd_topo_tile_name_cnt( topo, tile->name );
   ctx->tile_idx = tile->kind_id;
+  ctx->vm_fuse  = tile->exec.fuse;
 
   /* First find and setup the in-link from replay to exec. */
   ctx->replay_exec_in_idx = fd_topo_find_tile_in_link( topo, tile, "replay_exec", ctx->tile_idx );
@@ -489,6 +538,8 @@ unprivileged_init( fd_topo_t *      topo,
   if( FD_UNLIKELY( !fd_funk_join( ctx->funk, fd_topo_obj_laddr( topo, tile->exec.funk_obj_id ) ) ) ) {
     FD_LOG_ERR(( "Failed to join database cache" ));
   }
+  ctx->funk_reader_idx = tile->exec.funk_reader_idx;
+  fd_funk_reader_init( ctx->funk, ctx->funk_reader_idx );
 
   /********************************************************************/
   /* setup txncache                                                   */
@@ -604,9 +655,13 @@ populate_allowed_seccomp( fd_topo_t const *      topo,
                           ulong                  out_cnt,
                           struct sock_filter *   out ) {
   (void)topo;
-  (void)tile;
 
-  populate_sock_filter_policy_fd_exec_tile( out_cnt, out, (uint)fd_log_private_logfile_fd() );
+  /* Compiling a program flips the code pages of a jit between writable
+     and executable.  Without the jit, no mprotect is allowed. */
+  uint jit_prot_rw = tile->exec.jit ? (uint)(PROT_READ|PROT_WRITE) : UINT_MAX;
+  uint jit_prot_rx = tile->exec.jit ? (uint)(PROT_READ|PROT_EXEC ) : UINT_MAX;
+
+  populate_sock_filter_policy_fd_exec_tile( out_cnt, out, (uint)fd_log_private_logfile_fd(), jit_prot_rw, jit_prot_rx );
   return sock_filter_policy_fd_exec_tile_instr_cnt;
 }
 
@@ -1,6 +1,9 @@
 ifdef FD_HAS_INT128
-$(call add-hdrs,fd_replay_notif.h)
+$(call add-hdrs,fd_replay_notif.h fd_exec_dag.h)
 $(call add-objs,fd_exec,fd_discof)
+$(call add-objs,fd_exec_dag,fd_discof)
+$(call make-unit-test,test_exec_dag,test_exec_dag,fd_discof fd_disco fd_flamenco fd_tango fd_ballet fd_util)
+$(call run-unit-test,test_exec_dag)
 ifdef FD_HAS_ZSTD # required to load snapshot
 $(call add-objs,fd_replay_tile,fd_discof)
 else
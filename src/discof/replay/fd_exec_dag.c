@@ -0,0 +1,375 @@
+#include "fd_exec_dag.h"
+
+/* A wait queue link identifies the account at index slot of the dag
+   transaction txn_idx, packed as txn_idx*256+slot. */
+
+#define LINK(txn_idx,slot) (((txn_idx)<<8) | (ulong)(slot))
+#define LINK_TXN(link)     ((link)>>8)
+#define LINK_SLOT(link)    ((link) & 255UL)
+
+FD_STATIC_ASSERT( FD_EXEC_DAG_TXN_ACCT_MAX<256UL, link );
+
+struct fd_exec_dag_txn {
+  fd_txn_p_t txn;
+  ulong      next;        /* pool free list, ready list */
+  ulong      seq;         /* insertion sequence number */
+  ulong      blocked_cnt; /* number of accounts not held yet */
+  ulong      acct_cnt;
+  uint       acct     [ FD_EXEC_DAG_TXN_ACCT_MAX ]; /* acct pool idx */
+  ulong      wait_next[ FD_EXEC_DAG_TXN_ACCT_MAX ]; /* next link in the account's wait queue */
+  uchar      writable [ FD_EXEC_DAG_TXN_ACCT_MAX ];
+};
+typedef struct fd_exec_dag_txn fd_exec_dag_txn_t;
+
+struct fd_exec_dag_acct {
+  fd_acct_addr_t key;
+  ulong          next;       /* pool free list, map chain */
+  ulong          ref_cnt;    /* number of pending txns referencing it */
+  ulong          reader_cnt; /* number of txns holding it readonly */
+  ulong          writer;     /* 1 if a txn holds it writable */
+  ulong          wait_head;  /* FIFO of txns waiting for it */
+  ulong          wait_tail;
+  ulong          tag;        /* seq of the last txn that referenced it */
+  ulong          tag_slot;   /* and its index in that txn */
+};
+typedef struct fd_exec_dag_acct fd_exec_dag_acct_t;
+
+#define POOL_NAME fd_exec_dag_txn_pool
+#define POOL_T    fd_exec_dag_txn_t
+#include "../../util/tmpl/fd_pool.c"
+
+#define POOL_NAME fd_exec_dag_acct_pool
+#define POOL_T    fd_exec_dag_acct_t
+#include "../../util/tmpl/fd_pool.c"
+
+#define MAP_NAME          fd_exec_dag_acct_map
+#define MAP_ELE_T         fd_exec_dag_acct_t
+#define MAP_KEY_T         fd_acct_addr_t
+#define MAP_KEY_EQ(k0,k1) (!memcmp( (k0)->b, (k1)->b, FD_TXN_ACCT_ADDR_SZ ))
+#define MAP_KEY_HASH(k,s) fd_hash( (s), (k)->b, FD_TXN_ACCT_ADDR_SZ )
+#include "../../util/tmpl/fd_map_chain.c"
+
+struct __attribute__((aligned(FD_EXEC_DAG_ALIGN))) fd_exec_dag {
+  ulong txn_max;
+  ulong acct_max;
+  ulong seed;
+  ulong seq;
+  ulong pending_cnt;
+  ulong ready_cnt;
+  ulong ready_head;
+  ulong ready_tail;
+
+  /* Local join */
+  fd_exec_dag_txn_t *      txn_pool;
+  fd_exec_dag_acct_t *     acct_pool;
+  fd_exec_dag_acct_map_t * acct_map;
+};
+
+FD_FN_CONST ulong
+fd_exec_dag_align( void ) {
+  return FD_EXEC_DAG_ALIGN;
+}
+
+FD_FN_CONST ulong
+fd_exec_dag_footprint( ulong txn_max,
+                       ulong acct_max ) {
+  if( FD_UNLIKELY( !txn_max || txn_max>(ULONG_MAX>>9) || acct_max<FD_EXEC_DAG_TXN_ACCT_MAX || acct_max>UINT_MAX ) ) return 0UL;
+  ulong chain_cnt = fd_exec_dag_acct_map_chain_cnt_est( acct_max );
+  return FD_LAYOUT_FINI(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_APPEND(
+    FD_LAYOUT_INIT,
+      FD_EXEC_DAG_ALIGN,                 sizeof(fd_exec_dag_t)                              ),
+      fd_exec_dag_txn_pool_align(),      fd_exec_dag_txn_pool_footprint ( txn_max )         ),
+      fd_exec_dag_acct_pool_align(),     fd_exec_dag_acct_pool_footprint( acct_max )        ),
+      fd_exec_dag_acct_map_align(),      fd_exec_dag_acct_map_footprint ( chain_cnt )       ),
+    FD_EXEC_DAG_ALIGN );
+}
+
+/* fd_exec_dag_private_format formats the pools and the account map of
+   dag as empty and empties the ready list.  Assumes the dag header is
+   initialized. */
+
+static void
+fd_exec_dag_private_format( fd_exec_dag_t * dag ) {
+  ulong chain_cnt = fd_exec_dag_acct_map_chain_cnt_est( dag->acct_max );
+
+  FD_SCRATCH_ALLOC_INIT( l, dag );
+  /*               */ FD_SCRATCH_ALLOC_APPEND( l, FD_EXEC_DAG_ALIGN,             sizeof(fd_exec_dag_t)                             );
+  void * txn_pool   = FD_SCRATCH_ALLOC_APPEND( l, fd_exec_dag_txn_pool_align(),  fd_exec_dag_txn_pool_footprint ( dag->txn_max  ) );
+  void * acct_pool  = FD_SCRATCH_ALLOC_APPEND( l, fd_exec_dag_acct_pool_align(), fd_exec_dag_acct_pool_footprint( dag->acct_max ) );
+  void * acct_map   = FD_SCRATCH_ALLOC_APPEND( l, fd_exec_dag_acct_map_align(),  fd_exec_dag_acct_map_footprint ( chain_cnt     ) );
+  FD_TEST( FD_SCRATCH_ALLOC_FINI( l, FD_EXEC_DAG_ALIGN )==(ulong)dag + fd_exec_dag_footprint( dag->txn_max, dag->acct_max ) );
+
+  FD_TEST( fd_exec_dag_txn_pool_new ( txn_pool,  dag->txn_max             ) );
+  FD_TEST( fd_exec_dag_acct_pool_new( acct_pool, dag->acct_max            ) );
+  FD_TEST( fd_exec_dag_acct_map_new ( acct_map,  chain_cnt, dag->seed     ) );
+
+  dag->pending_cnt = 0UL;
+  dag->ready_cnt   = 0UL;
+  dag->ready_head  = FD_EXEC_DAG_IDX_NULL;
+  dag->ready_tail  = FD_EXEC_DAG_IDX_NULL;
+}
+
+void *
+fd_exec_dag_new( void * shmem,
+                 ulong  txn_max,
+                 ulong  acct_max,
+                 ulong  seed ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL mem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_exec_dag_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned mem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_exec_dag_footprint( txn_max, acct_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad txn_max (%lu) or acct_max (%lu)", txn_max, acct_max ));
+    return NULL;
+  }
+
+  fd_exec_dag_t * dag = (fd_exec_dag_t *)shmem;
+  fd_memset( dag, 0, sizeof(fd_exec_dag_t) );
+  dag->txn_max  = txn_max;
+  dag->acct_max = acct_max;
+  dag->seed     = seed;
+
+  fd_exec_dag_private_format( dag );
+
+  return shmem;
+}
+
+fd_exec_dag_t *
+fd_exec_dag_join( void * shdag ) {
+
+  if( FD_UNLIKELY( !shdag ) ) {
+    FD_LOG_WARNING(( "NULL dag" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shdag, fd_exec_dag_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned dag" ));
+    return NULL;
+  }
+
+  fd_exec_dag_t * dag       = (fd_exec_dag_t *)shdag;
+  ulong           chain_cnt = fd_exec_dag_acct_map_chain_cnt_est( dag->acct_max );
+
+  FD_SCRATCH_ALLOC_INIT( l, shdag );
+  /*                  */ FD_SCRATCH_ALLOC_APPEND( l, FD_EXEC_DAG_ALIGN,             sizeof(fd_exec_dag_t)                             );
+  void * txn_pool      = FD_SCRATCH_ALLOC_APPEND( l, fd_exec_dag_txn_pool_align(),  fd_exec_dag_txn_pool_footprint ( dag->txn_max  ) );
+  void * acct_pool     = FD_SCRATCH_ALLOC_APPEND( l, fd_exec_dag_acct_pool_align(), fd_exec_dag_acct_pool_footprint( dag->acct_max ) );
+  void * acct_map      = FD_SCRATCH_ALLOC_APPEND( l, fd_exec_dag_acct_map_align(),  fd_exec_dag_acct_map_footprint ( chain_cnt     ) );
+
+  dag->txn_pool  = fd_exec_dag_txn_pool_join ( txn_pool  );
+  dag->acct_pool = fd_exec_dag_acct_pool_join( acct_pool );
+  dag->acct_map  = fd_exec_dag_acct_map_join ( acct_map  );
+
+  return dag;
+}
+
+void *
+fd_exec_dag_leave( fd_exec_dag_t * dag ) {
+
+  if( FD_UNLIKELY( !dag ) ) {
+    FD_LOG_WARNING(( "NULL dag" ));
+    return NULL;
+  }
+
+  return (void *)dag;
+}
+
+void *
+fd_exec_dag_delete( void * shdag ) {
+
+  if( FD_UNLIKELY( !shdag ) ) {
+    FD_LOG_WARNING(( "NULL dag" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shdag, fd_exec_dag_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned dag" ));
+    return NULL;
+  }
+
+  return shdag;
+}
+
+void
+fd_exec_dag_reset( fd_exec_dag_t * dag ) {
+  fd_exec_dag_private_format( dag );
+  FD_TEST( fd_exec_dag_join( dag )==dag );
+}
+
+int
+fd_exec_dag_full( fd_exec_dag_t const * dag ) {
+  return ( !fd_exec_dag_txn_pool_free( dag->txn_pool ) ) |
+         ( fd_exec_dag_acct_pool_free( dag->acct_pool )<FD_EXEC_DAG_TXN_ACCT_MAX );
+}
+
+ulong
+fd_exec_dag_pending_cnt( fd_exec_dag_t const * dag ) {
+  return dag->pending_cnt;
+}
+
+ulong
+fd_exec_dag_ready_cnt( fd_exec_dag_t const * dag ) {
+  return dag->ready_cnt;
+}
+
+fd_txn_p_t *
+fd_exec_dag_txn( fd_exec_dag_t * dag,
+                 ulong           txn_idx ) {
+  return &dag->txn_pool[ txn_idx ].txn;
+}
+
+static void
+fd_exec_dag_ready_push( fd_exec_dag_t * dag,
+                        ulong           txn_idx ) {
+  dag->txn_pool[ txn_idx ].next = FD_EXEC_DAG_IDX_NULL;
+  if( dag->ready_tail==FD_EXEC_DAG_IDX_NULL ) dag->ready_head                        = txn_idx;
+  else                                        dag->txn_pool[ dag->ready_tail ].next = txn_idx;
+  dag->ready_tail = txn_idx;
+  dag->ready_cnt++;
+}
+
+ulong
+fd_exec_dag_pop( fd_exec_dag_t * dag ) {
+  ulong txn_idx = dag->ready_head;
+  if( FD_UNLIKELY( txn_idx==FD_EXEC_DAG_IDX_NULL ) ) return FD_EXEC_DAG_IDX_NULL;
+  dag->ready_head = dag->txn_pool[ txn_idx ].next;
+  if( dag->ready_head==FD_EXEC_DAG_IDX_NULL ) dag->ready_tail = FD_EXEC_DAG_IDX_NULL;
+  dag->ready_cnt--;
+  return txn_idx;
+}
+
+/* fd_exec_dag_acct_add adds the account key to the account set of the
+   txn being inserted, merging duplicate references. */
+
+static void
+fd_exec_dag_acct_add( fd_exec_dag_t *        dag,
+                      fd_exec_dag_txn_t *    txn,
+                      fd_acct_addr_t const * addr,
+                      int                    writable ) {
+  fd_exec_dag_acct_t * acct = fd_exec_dag_acct_map_ele_query( dag->acct_map, addr, NULL, dag->acct_pool );
+  if( FD_UNLIKELY( !acct ) ) {
+    acct = fd_exec_dag_acct_pool_ele_acquire( dag->acct_pool );
+    acct->key        = *addr;
+    acct->ref_cnt    = 0UL;
+    acct->reader_cnt = 0UL;
+    acct->writer     = 0UL;
+    acct->wait_head  = FD_EXEC_DAG_IDX_NULL;
+    acct->wait_tail  = FD_EXEC_DAG_IDX_NULL;
+    acct->tag        = ULONG_MAX;
+    fd_exec_dag_acct_map_ele_insert( dag->acct_map, acct, dag->acct_pool );
+  } else if( FD_UNLIKELY( acct->tag==txn->seq ) ) {
+    txn->writable[ acct->tag_slot ] = (uchar)( txn->writable[ acct->tag_slot ] | !!writable );
+    return;
+  }
+
+  ulong slot = txn->acct_cnt++;
+  acct->tag      = txn->seq;
+  acct->tag_slot = slot;
+  acct->ref_cnt++;
+  txn->acct     [ slot ] = (uint)fd_exec_dag_acct_pool_idx( dag->acct_pool, acct );
+  txn->wait_next[ slot ] = FD_EXEC_DAG_IDX_NULL;
+  txn->writable [ slot ] = (uchar)!!writable;
+}
+
+ulong
+fd_exec_dag_insert( fd_exec_dag_t *        dag,
+                    fd_txn_p_t const *     txn_p,
+                    fd_acct_addr_t const * alt_accts ) {
+  ulong               txn_idx = fd_exec_dag_txn_pool_idx_acquire( dag->txn_pool );
+  fd_exec_dag_txn_t * txn     = &dag->txn_pool[ txn_idx ];
+
+  fd_memcpy( &txn->txn, txn_p, sizeof(fd_txn_p_t) );
+  txn->seq         = dag->seq++;
+  txn->blocked_cnt = 0UL;
+  txn->acct_cnt    = 0UL;
+
+  fd_txn_t const * desc    = TXN( &txn->txn );
+  uchar const *    payload = txn->txn.payload;
+
+  fd_acct_addr_t const * imm     = fd_txn_get_acct_addrs( desc, payload );
+  ulong                  imm_cnt = fd_txn_account_cnt( desc, FD_TXN_ACCT_CAT_IMM );
+  for( ulong i=0UL; i<imm_cnt; i++ ) {
+    fd_exec_dag_acct_add( dag, txn, &imm[ i ], fd_txn_is_writable( desc, (ushort)i ) );
+  }
+  if( desc->transaction_version==FD_TXN_V0 ) {
+    if( alt_accts ) {
+      for( ulong i=0UL; i<desc->addr_table_adtl_cnt; i++ ) {
+        fd_exec_dag_acct_add( dag, txn, &alt_accts[ i ], fd_txn_is_writable( desc, (ushort)(imm_cnt+i) ) );
+      }
+    }
+    fd_txn_acct_addr_lut_t const * luts = fd_txn_get_address_tables_const( desc );
+    for( ulong i=0UL; i<desc->addr_table_lookup_cnt; i++ ) {
+      fd_exec_dag_acct_add( dag, txn, (fd_acct_addr_t const *)( payload+luts[ i ].addr_off ), 0 );
+    }
+  }
+
+  /* Acquire the accounts, or wait behind the transactions already
+     holding or waiting for them. */
+
+  for( ulong slot=0UL; slot<txn->acct_cnt; slot++ ) {
+    fd_exec_dag_acct_t * acct     = &dag->acct_pool[ txn->acct[ slot ] ];
+    int                  writable = txn->writable[ slot ];
+    if( acct->wait_head==FD_EXEC_DAG_IDX_NULL && !acct->writer && ( !writable || !acct->reader_cnt ) ) {
+      if( writable ) acct->writer = 1UL;
+      else           acct->reader_cnt++;
+      continue;
+    }
+    ulong link = LINK( txn_idx, slot );
+    if( acct->wait_tail==FD_EXEC_DAG_IDX_NULL ) acct->wait_head = link;
+    else dag->txn_pool[ LINK_TXN( acct->wait_tail ) ].wait_next[ LINK_SLOT( acct->wait_tail ) ] = link;
+    acct->wait_tail = link;
+    txn->blocked_cnt++;
+  }
+
+  dag->pending_cnt++;
+  if( !txn->blocked_cnt ) fd_exec_dag_ready_push( dag, txn_idx );
+  return txn_idx;
+}
+
+void
+fd_exec_dag_complete( fd_exec_dag_t * dag,
+                      ulong           txn_idx ) {
+  fd_exec_dag_txn_t * txn = &dag->txn_pool[ txn_idx ];
+
+  for( ulong slot=0UL; slot<txn->acct_cnt; slot++ ) {
+    fd_exec_dag_acct_t * acct = &dag->acct_pool[ txn->acct[ slot ] ];
+    if( txn->writable[ slot ] ) acct->writer = 0UL;
+    else                        acct->reader_cnt--;
+
+    /* Hand the account over to the transactions at the head of its
+       wait queue: either one writer or a run of readers. */
+
+    while( acct->wait_head!=FD_EXEC_DAG_IDX_NULL ) {
+      ulong               link     = acct->wait_head;
+      fd_exec_dag_txn_t * waiter   = &dag->txn_pool[ LINK_TXN( link ) ];
+      int                 writable = waiter->writable[ LINK_SLOT( link ) ];
+      if( acct->writer || ( writable && acct->reader_cnt ) ) break;
+      if( writable ) acct->writer = 1UL;
+      else           acct->reader_cnt++;
+
+      acct->wait_head = waiter->wait_next[ LINK_SLOT( link ) ];
+      if( acct->wait_head==FD_EXEC_DAG_IDX_NULL ) acct->wait_tail = FD_EXEC_DAG_IDX_NULL;
+      if( !--waiter->blocked_cnt ) fd_exec_dag_ready_push( dag, LINK_TXN( link ) );
+    }
+
+    if( !--acct->ref_cnt ) {
+      fd_exec_dag_acct_map_ele_remove( dag->acct_map, &acct->key, NULL, dag->acct_pool );
+      fd_exec_dag_acct_pool_ele_release( dag->acct_pool, acct );
+    }
+  }
+
+  fd_exec_dag_txn_pool_idx_release( dag->txn_pool, txn_idx );
+  dag->pending_cnt--;
+}
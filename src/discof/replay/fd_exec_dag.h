@@ -0,0 +1,139 @@
+#ifndef HEADER_fd_src_discof_replay_fd_exec_dag_h
+#define HEADER_fd_src_discof_replay_fd_exec_dag_h
+
+/* fd_exec_dag schedules the transactions of a block for parallel
+   execution.  Transactions are inserted in block order and the dag
+   tracks, for every account referenced by a pending transaction, which
+   transactions currently hold it (any number of readers or a single
+   writer) and a FIFO of the transactions waiting for it.  A transaction
+   becomes ready once it holds all of its accounts, i.e. once all the
+   earlier transactions it conflicts with have completed.  Any ready
+   transaction can be dispatched to any idle exec tile, so independent
+   transactions are never stuck behind a conflicting one, regardless of
+   microblock boundaries.
+
+   This is the same ordering as the account locks held by a transaction
+   in serial replay: two transactions that write the same account, or
+   where one writes an account the other reads, complete in block
+   order.  The edges of the dependency dag are implicit in the per
+   account wait queues.
+
+   The account set of a transaction is its static account keys, its
+   address lookup table resolved keys (if provided by the caller) and
+   the address lookup tables themselves (as readonly).  Writable
+   accounts that the runtime would demote to readonly are conservatively
+   treated as writable.
+
+   The dag has room for txn_max pending (inserted and not completed)
+   transactions, which together hold at most acct_max account
+   references.  It is not concurrency safe and is meant to be owned by
+   the replay tile. */
+
+#include "../../disco/pack/fd_microblock.h"
+
+#define FD_EXEC_DAG_ALIGN (128UL)
+
+/* FD_EXEC_DAG_TXN_ACCT_MAX is the max number of accounts a transaction
+   can reference: its resolved accounts plus the address lookup tables
+   they are loaded from. */
+
+#define FD_EXEC_DAG_TXN_ACCT_MAX (FD_TXN_ACCT_ADDR_MAX+FD_TXN_ADDR_TABLE_LOOKUP_MAX)
+
+#define FD_EXEC_DAG_IDX_NULL (ULONG_MAX)
+
+struct fd_exec_dag;
+typedef struct fd_exec_dag fd_exec_dag_t;
+
+FD_PROTOTYPES_BEGIN
+
+FD_FN_CONST ulong
+fd_exec_dag_align( void );
+
+FD_FN_CONST ulong
+fd_exec_dag_footprint( ulong txn_max,
+                       ulong acct_max );
+
+/* fd_exec_dag_new formats an unused memory region for use as a dag.
+   txn_max is the max number of pending transactions and acct_max the
+   max number of distinct (per transaction) account references they can
+   hold, acct_max must be at least FD_EXEC_DAG_TXN_ACCT_MAX.  seed is an
+   arbitrary value used to seed the account map hash. */
+
+void *
+fd_exec_dag_new( void * shmem,
+                 ulong  txn_max,
+                 ulong  acct_max,
+                 ulong  seed );
+
+fd_exec_dag_t *
+fd_exec_dag_join( void * shdag );
+
+void *
+fd_exec_dag_leave( fd_exec_dag_t * dag );
+
+void *
+fd_exec_dag_delete( void * shdag );
+
+/* fd_exec_dag_reset removes all transactions from the dag, e.g. when
+   replay abandons a block midway. */
+
+void
+fd_exec_dag_reset( fd_exec_dag_t * dag );
+
+/* fd_exec_dag_full returns 1 if the dag might not have room for one
+   more transaction and 0 otherwise. */
+
+int
+fd_exec_dag_full( fd_exec_dag_t const * dag );
+
+/* fd_exec_dag_{pending,ready}_cnt return the number of transactions
+   inserted and not completed yet, and the number of those that are
+   ready to be dispatched. */
+
+ulong
+fd_exec_dag_pending_cnt( fd_exec_dag_t const * dag );
+
+ulong
+fd_exec_dag_ready_cnt( fd_exec_dag_t const * dag );
+
+/* fd_exec_dag_insert appends txn to the dag, after all the transactions
+   inserted before.  alt_accts points to the txn's
+   addr_table_adtl_cnt accounts resolved from its address lookup tables
+   (in txn order) or is NULL if they are not known (e.g. resolution
+   failed, in which case execution will fail without touching them).
+   The dag keeps a copy of txn.  Returns the transaction's dag index,
+   valid until the transaction completes.  Assumes the dag is not
+   full. */
+
+ulong
+fd_exec_dag_insert( fd_exec_dag_t *        dag,
+                    fd_txn_p_t const *     txn,
+                    fd_acct_addr_t const * alt_accts );
+
+/* fd_exec_dag_pop returns the dag index of a ready transaction and
+   removes it from the ready set, or FD_EXEC_DAG_IDX_NULL if no
+   transaction is ready.  Transactions are popped in the order they
+   became ready.  The transaction stays pending (holding its accounts)
+   until it is completed. */
+
+ulong
+fd_exec_dag_pop( fd_exec_dag_t * dag );
+
+/* fd_exec_dag_txn returns the copy of the transaction at dag index
+   txn_idx. */
+
+fd_txn_p_t *
+fd_exec_dag_txn( fd_exec_dag_t * dag,
+                 ulong           txn_idx );
+
+/* fd_exec_dag_complete marks the popped transaction txn_idx as done.
+   Its accounts are released, which can make later transactions ready.
+   txn_idx is invalid on return. */
+
+void
+fd_exec_dag_complete( fd_exec_dag_t * dag,
+                      ulong           txn_idx );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_discof_replay_fd_exec_dag_h */
@@ -10,6 +10,7 @@
 #include "../../flamenco/runtime/context/fd_capture_ctx.h"
 #include "../../flamenco/runtime/context/fd_exec_slot_ctx.h"
 #include "../../flamenco/runtime/program/fd_bpf_program_util.h"
+#include "../../flamenco/runtime/sysvar/fd_sysvar_slot_hashes.h"
 #include "../../flamenco/runtime/sysvar/fd_sysvar_slot_history.h"
 #include "../../flamenco/runtime/fd_hashes.h"
 #include "../../flamenco/runtime/fd_runtime_init.h"
@@ -22,6 +23,7 @@
 #include "../../choreo/fd_choreo.h"
 #include "../../disco/plugin/fd_plugin.h"
 #include "fd_exec.h"
+#include "fd_exec_dag.h"
 #include "../../discof/restore/utils/fd_snapshot_messages.h"
 
 #include <arpa/inet.h>
@@ -54,8 +56,16 @@
 #define EXEC_TXN_BUSY   (0xA)
 #define EXEC_TXN_READY  (0xB)
 
+/* Max number of transactions parsed ahead of execution into the exec
+   dag and the max number of account references they can hold. */
+#define EXEC_DAG_TXN_MAX  (512UL)
+#define EXEC_DAG_ACCT_MAX (EXEC_DAG_TXN_MAX*32UL)
+
 #define BANK_HASH_CMP_LG_MAX (16UL)
 
+/* Max number of records moved per funk publish step */
+#define FUNK_PUBLISH_BATCH_MAX (4096UL)
+
 struct fd_replay_out_link {
   ulong            idx;
 
@@ -197,6 +207,12 @@ struct fd_replay_tile_ctx {
                   the fork-aware structures need to maintain information
                   through both of those slots. */
 
+  /* Funk publish in progress (see funk_publish).  funk_publish_txn is
+     NULL if there is none. */
+  fd_funk_txn_t * funk_publish_txn;
+  ulong           funk_publish_wmk;
+  fd_bank_t *     funk_publish_bank; /* Bank of funk_publish_wmk */
+
   ulong * poh;  /* proof-of-history slot */
   uint poh_init_done;
   int  snapshot_init_done;
@@ -207,6 +223,9 @@ struct fd_replay_tile_ctx {
   fd_pubkey_t validator_identity_pubkey[ 1 ];
 
   fd_txncache_t * status_cache;
+
+  fd_bpf_program_cache_t * prog_cache;
+
   void * bmtree[ FD_PACK_MAX_BANK_TILES ];
 
   /* The spad allocators used by the executor tiles are NOT the same as the
@@ -233,7 +252,12 @@ struct fd_replay_tile_ctx {
                     validator could otherwise equivocate a previous vote
                     or block. */
 
-  int blocked_on_mblock; /* Flag used for synchronizing on mblock boundaries. */
+  /* Orders the transactions of the slot being replayed by the accounts
+     they lock, see fd_exec_dag.h.  exec_dag_idx is the dag index of the
+     transaction in flight on each exec tile. */
+
+  fd_exec_dag_t * exec_dag;
+  ulong           exec_dag_idx[ FD_PACK_MAX_BANK_TILES ];
 
   /* Metrics */
   fd_replay_tile_metrics_t metrics;
@@ -274,6 +298,7 @@ scratch_footprint( fd_topo_tile_t const * tile FD_PARAM_UNUSED ) {
     l = FD_LAYOUT_APPEND( l, FD_BMTREE_COMMIT_ALIGN, FD_BMTREE_COMMIT_FOOTPRINT(0) );
   }
   l = FD_LAYOUT_APPEND( l, 128UL, FD_SLICE_MAX );
+  l = FD_LAYOUT_APPEND( l, fd_exec_dag_align(), fd_exec_dag_footprint( EXEC_DAG_TXN_MAX, EXEC_DAG_ACCT_MAX ) );
   l = FD_LAYOUT_FINI  ( l, scratch_align() );
   return l;
 }
@@ -535,57 +560,62 @@ funk_cancel( fd_replay_tile_ctx_t * ctx, ulong mismatch_slot ) {
 
 static void
 txncache_publish( fd_replay_tile_ctx_t * ctx,
-                  fd_funk_txn_t *        to_root_txn,
-                  fd_funk_txn_t *        rooted_txn ) {
+                  fd_bank_t const *      to_root_bank ) {
 
 
   /* For the status cache, we stop rooting until the status cache has been
      written out to the current snapshot. We also need to iterate up the
-     funk transaction tree up until the current "root" to figure out what slots
-     should be registered. This root can correspond to the latest false root if
-     one exists.  */
+     bank tree up until the current root bank to figure out what slots
+     should be registered.  This is called right before the banks are
+     published, so the current root bank is the previous watermark. */
 
 
-  if( FD_UNLIKELY( !ctx->slot_ctx->status_cache ) ) {
+  if( FD_UNLIKELY( !ctx->slot_ctx->status_cache || !to_root_bank ) ) {
     return;
   }
 
-  fd_funk_txn_start_read( ctx->funk );
-
-  fd_funk_txn_t * txn = to_root_txn;
-  fd_funk_txn_pool_t * txn_pool = fd_funk_txn_pool( ctx->funk );
-  while( txn!=rooted_txn ) {
-    ulong slot = txn->xid.ul[0];
-
-    FD_LOG_INFO(( "Registering slot %lu", slot ));
-    fd_txncache_register_root_slot( ctx->slot_ctx->status_cache, slot );
-
-    txn = fd_funk_txn_parent( txn, txn_pool );
+  fd_bank_t const * root_bank = fd_banks_root( ctx->banks );
+  fd_bank_t const * bank_pool = fd_banks_get_bank_pool( ctx->banks );
+  for( fd_bank_t const * bank=to_root_bank; bank && bank!=root_bank; bank=fd_banks_pool_ele_const( bank_pool, bank->parent_idx ) ) {
+    FD_LOG_INFO(( "Registering slot %lu", bank->slot ));
+    fd_txncache_register_root_slot( ctx->slot_ctx->status_cache, bank->slot );
   }
-
-  fd_funk_txn_end_read( ctx->funk );
 }
 
+/* funk_publish starts publishing all funk transactions up to and
+   including to_root_txn (the watermark wmk).  The records are moved a
+   bounded batch at a time by funk_publish_step, one step per
+   after_credit, so replay keeps executing while a large slot is
+   published.  The bank of the watermark is captured here, everything
+   that is derived from it (the epoch accounts hash, the txncache
+   roots, the banks publish and the watermark fseq) happens at once
+   when the last step completes.  Only one publish is in progress at a
+   time, a root that arrives meanwhile is published next (see
+   after_frag). */
+
 static void
 funk_publish( fd_replay_tile_ctx_t * ctx,
               fd_funk_txn_t *        to_root_txn,
               ulong                  wmk ) {
 
-  fd_funk_txn_start_write( ctx->funk );
   FD_LOG_DEBUG(( "Publishing slot=%lu xid=%lu", wmk, to_root_txn->xid.ul[0] ));
 
-  /* This is the standard case. Publish all transactions up to and
-      including the watermark. This will publish any in-prep ancestors
-      of root_txn as well. */
-  if( FD_UNLIKELY( !fd_funk_txn_publish( ctx->funk, to_root_txn, 1 ) ) ) {
-    FD_LOG_ERR(( "failed to funk publish slot %lu", wmk ));
-  }
-  fd_funk_txn_end_write( ctx->funk );
+  ctx->funk_publish_txn  = to_root_txn;
+  ctx->funk_publish_wmk  = wmk;
+  ctx->funk_publish_bank = ctx->banks ? fd_banks_get_bank( ctx->banks, wmk ) : NULL;
+  if( FD_UNLIKELY( ctx->banks && !ctx->funk_publish_bank ) ) FD_LOG_ERR(( "Unable to find bank for slot %lu", wmk ));
+}
 
-  if( FD_LIKELY( FD_FEATURE_ACTIVE_BANK( ctx->slot_ctx->bank, epoch_accounts_hash ) &&
-                 !FD_FEATURE_ACTIVE_BANK( ctx->slot_ctx->bank, accounts_lt_hash ) ) ) {
+static void
+funk_publish_fini( fd_replay_tile_ctx_t * ctx ) {
+  ulong       wmk  = ctx->funk_publish_wmk;
+  fd_bank_t * bank = ctx->funk_publish_bank;
 
-    if( wmk>=fd_bank_eah_start_slot_get( ctx->slot_ctx->bank ) ) {
+  if( FD_LIKELY( bank &&
+                 FD_FEATURE_ACTIVE_BANK( bank, epoch_accounts_hash ) &&
+                 !FD_FEATURE_ACTIVE_BANK( bank, accounts_lt_hash ) ) ) {
+
+    if( wmk>=fd_bank_eah_start_slot_get( bank ) ) {
       fd_exec_para_cb_ctx_t exec_para_ctx = {
         .func       = fd_accounts_hash_counter_and_gather_tpool_cb,
         .para_arg_1 = NULL,
@@ -593,21 +623,39 @@ funk_publish( fd_replay_tile_ctx_t * ctx,
       };
 
       fd_hash_t out_hash = {0};
-      fd_accounts_hash( ctx->slot_ctx->funk,
-                        fd_bank_slot_get( ctx->slot_ctx->bank ),
+      fd_accounts_hash( ctx->funk,
+                        fd_bank_slot_get( bank ),
                         &out_hash,
                         ctx->runtime_spad,
-                        fd_bank_features_query( ctx->slot_ctx->bank ),
+                        fd_bank_features_query( bank ),
                         &exec_para_ctx,
                         NULL );
       FD_LOG_NOTICE(( "Done computing epoch account hash (%s)", FD_BASE58_ENC_32_ALLOCA( &out_hash ) ));
 
-      fd_bank_epoch_account_hash_set( ctx->slot_ctx->bank, out_hash );
+      /* Banks cloned from now on inherit it from the watermark bank,
+         the bank being executed gets it directly */
 
-      fd_bank_eah_start_slot_set( ctx->slot_ctx->bank, FD_SLOT_NULL );
+      fd_bank_epoch_account_hash_set( bank, out_hash );
+      fd_bank_eah_start_slot_set( bank, FD_SLOT_NULL );
+      if( ctx->slot_ctx->bank!=bank ) {
+        fd_bank_epoch_account_hash_set( ctx->slot_ctx->bank, out_hash );
+        fd_bank_eah_start_slot_set( ctx->slot_ctx->bank, FD_SLOT_NULL );
+      }
     }
   }
 
+  if( FD_UNLIKELY( ctx->capture_ctx ) ) {
+    fd_runtime_checkpt( ctx->capture_ctx, ctx->slot_ctx, wmk );
+  }
+
+  /* Only now is everything up to wmk in the funk root */
+
+  txncache_publish( ctx, bank );
+  if( FD_LIKELY( bank ) ) fd_banks_publish( ctx->banks, wmk );
+  fd_fseq_update( ctx->published_wmark, wmk );
+
+  ctx->funk_publish_txn  = NULL;
+  ctx->funk_publish_bank = NULL;
 }
 
 static void
@@ -619,7 +667,8 @@ funk_and_txncache_publish( fd_replay_tile_ctx_t * ctx, ulong wmk, fd_funk_txn_xi
     FD_LOG_CRIT(( "Invariant violation: xid->ul[0] != wmk %lu %lu", xid->ul[0], wmk ));
   }
 
-  /* Handle updates to funk and the status cache. */
+  /* Handle updates to funk and the status cache (the latter once funk
+     is done, see funk_publish_fini). */
 
   fd_funk_txn_start_read( ctx->funk );
   fd_funk_txn_map_t * txn_map     = fd_funk_txn_map( ctx->funk );
@@ -627,17 +676,34 @@ funk_and_txncache_publish( fd_replay_tile_ctx_t * ctx, ulong wmk, fd_funk_txn_xi
   if( FD_UNLIKELY( !to_root_txn ) ) {
     FD_LOG_ERR(( "Unable to find funk transaction for xid %lu", xid->ul[0] ));
   }
-  fd_funk_txn_t *   rooted_txn  = NULL;
   fd_funk_txn_end_read( ctx->funk );
 
-  txncache_publish( ctx, to_root_txn, rooted_txn );
-
   funk_publish( ctx, to_root_txn, wmk );
+}
 
-  if( FD_UNLIKELY( ctx->capture_ctx ) ) {
-    fd_runtime_checkpt( ctx->capture_ctx, ctx->slot_ctx, wmk );
-  }
+static void
+funk_publish_step( fd_replay_tile_ctx_t * ctx ) {
+  fd_funk_txn_t * to_root_txn = ctx->funk_publish_txn;
+  ulong           wmk         = ctx->funk_publish_wmk;
+  if( FD_LIKELY( !to_root_txn ) ) return;
+
+  /* This is the standard case. Publish all transactions up to and
+      including the watermark. This will publish any in-prep ancestors
+      of root_txn as well.  The records are moved without the txn write
+      lock so the exec tiles are only excluded for the short
+      bookkeeping at the start and end of each published slot. */
+  int err = fd_funk_txn_publish_step( ctx->funk, to_root_txn, FUNK_PUBLISH_BATCH_MAX, 1 );
+  if( FD_UNLIKELY( err<0 ) ) FD_LOG_ERR(( "failed to funk publish slot %lu", wmk ));
+  if( FD_LIKELY( err ) ) return; /* More steps needed */
+
+  funk_publish_fini( ctx );
+
+  /* Start on the latest root if it advanced while publishing */
 
+  if( FD_UNLIKELY( ctx->root>wmk ) ) {
+    fd_funk_txn_xid_t xid = { .ul = { ctx->root, ctx->root } };
+    funk_and_txncache_publish( ctx, ctx->root, &xid );
+  }
 }
 
 static void
@@ -653,6 +719,7 @@ restore_slot_ctx( fd_replay_tile_ctx_t * ctx,
 
   ctx->slot_ctx->funk         = ctx->funk;
   ctx->slot_ctx->status_cache = ctx->status_cache;
+  ctx->slot_ctx->prog_cache   = ctx->prog_cache;
 
   fd_solana_manifest_global_t * manifest_global
     = (fd_solana_manifest_global_t *)fd_chunk_to_laddr( fd_wksp_containing( ctx->manifest_dcache ), chunk );
@@ -1035,15 +1102,22 @@ after_frag( fd_replay_tile_ctx_t *   ctx,
     ulong root = sig;
 
     if( FD_LIKELY( root <= fd_fseq_query( ctx->published_wmark ) ) ) return;
+    if( FD_UNLIKELY( root <= ctx->root ) ) return; /* Already being published */
     FD_LOG_NOTICE(( "advancing root %lu => %lu", fd_fseq_query( ctx->published_wmark ), root ));
 
     ctx->root = root;
     if( FD_LIKELY( ctx->blockstore ) ) fd_blockstore_publish( ctx->blockstore, ctx->blockstore_fd, root );
     if( FD_LIKELY( ctx->forks ) ) fd_forks_publish( ctx->forks, root );
-    if( FD_LIKELY( ctx->funk ) ) { fd_funk_txn_xid_t xid = { .ul = { root, root } }; funk_and_txncache_publish( ctx, root, &xid ); }
-    if( FD_LIKELY( ctx->banks ) ) fd_banks_publish( ctx->banks, root );
 
-    fd_fseq_update( ctx->published_wmark, root );
+    /* With funk, the banks, the txncache and the watermark advance once
+       the funk publish finishes.  If one is in progress, it picks up
+       the new root when done (see funk_publish_step). */
+    if( FD_LIKELY( ctx->funk ) ) {
+      if( FD_LIKELY( !ctx->funk_publish_txn ) ) { fd_funk_txn_xid_t xid = { .ul = { root, root } }; funk_and_txncache_publish( ctx, root, &xid ); }
+    } else {
+      if( FD_LIKELY( ctx->banks ) ) fd_banks_publish( ctx->banks, root );
+      fd_fseq_update( ctx->published_wmark, root );
+    }
   } else if( in_idx==SNAP_IN_IDX ) {
     on_snapshot_message( ctx, stem, ctx->_snap_out_chunk, sig );
   }
@@ -1263,100 +1337,143 @@ prepare_first_batch_execution( fd_replay_tile_ctx_t * ctx,
 
 }
 
-static void
-exec_slice( fd_replay_tile_ctx_t * ctx, fd_stem_context_t * stem ) {
+/* exec_dag_reset drops whatever is left in the exec dag and in the
+   slice being parsed, e.g. when replay switches to another slot or
+   abandons the block it was executing.  Transactions still running on
+   exec tiles are forgotten, so their completions won't touch the dag
+   (see handle_writer_state_updates). */
 
-  /* Assumes that the slice exec ctx has buffered at least one slice.
-     Then, for each microblock, round robin dispatch the transactions in
-     that microblock to the exec tile. Once exec tile signifies with a
-     retcode, we can continue dispatching transactions. Replay has to
-     synchronize at the boundary of every microblock. After we dispatch
-     one to each exec tile, we watermark where we are, and then continue
-     on the following after_credit. If we still have txns to execute,
-     start from wmark, pausing everytime we hit the microblock
-     boundaries. */
+static void
+exec_dag_reset( fd_replay_tile_ctx_t * ctx ) {
+  if( FD_UNLIKELY( fd_exec_dag_pending_cnt( ctx->exec_dag ) ) ) {
+    FD_LOG_WARNING(( "abandoning %lu pending transactions of slot %lu",
+                     fd_exec_dag_pending_cnt( ctx->exec_dag ), fd_bank_slot_get( ctx->slot_ctx->bank ) ));
+  }
+  fd_exec_dag_reset( ctx->exec_dag );
+  for( ulong i=0UL; i<ctx->exec_cnt; i++ ) ctx->exec_dag_idx[ i ] = FD_EXEC_DAG_IDX_NULL;
+  fd_slice_exec_reset( &ctx->slice_exec_ctx );
+}
 
-  ulong slot = fd_bank_slot_get( ctx->slot_ctx->bank );
+/* exec_dag_insert_txn appends txn_p to the exec dag, resolving its
+   address lookup tables against the current slot so that the accounts
+   loaded through them are ordered like the static ones. */
 
-  uchar to_exec[ FD_PACK_MAX_BANK_TILES ] = {0};
-  uchar num_free_exec_tiles = 0UL;
-  for( uchar i=0; i<ctx->exec_cnt; i++ ) {
-    if( ctx->exec_ready[ i ]==EXEC_TXN_READY ) {
-      to_exec[ num_free_exec_tiles++ ] = i;
-    }
+static void
+exec_dag_insert_txn( fd_replay_tile_ctx_t * ctx,
+                     fd_txn_p_t const *     txn_p ) {
+  fd_txn_t const * txn_descriptor = TXN( txn_p );
+  if( txn_descriptor->transaction_version!=FD_TXN_V0 || !txn_descriptor->addr_table_adtl_cnt ) {
+    fd_exec_dag_insert( ctx->exec_dag, txn_p, NULL );
+    return;
   }
 
-  if( ctx->blocked_on_mblock ) {
-    if( num_free_exec_tiles==ctx->exec_cnt ) {
-      ctx->blocked_on_mblock = 0;
-    } else {
-      return;
+  FD_SPAD_FRAME_BEGIN( ctx->runtime_spad ) {
+    fd_acct_addr_t                  alt_accts[ FD_TXN_ACCT_ADDR_MAX ];
+    fd_acct_addr_t const *          alt_accts_opt      = NULL;
+    fd_slot_hashes_global_t const * slot_hashes_global = fd_sysvar_slot_hashes_read( ctx->slot_ctx->funk, ctx->slot_ctx->funk_txn, ctx->runtime_spad );
+    if( FD_LIKELY( slot_hashes_global ) ) {
+      fd_slot_hash_t * slot_hash = deq_fd_slot_hash_t_join( (uchar *)slot_hashes_global + slot_hashes_global->hashes_offset );
+      int err = fd_runtime_load_txn_address_lookup_tables( txn_descriptor,
+                                                           txn_p->payload,
+                                                           ctx->slot_ctx->funk,
+                                                           ctx->slot_ctx->funk_txn,
+                                                           fd_bank_slot_get( ctx->slot_ctx->bank ),
+                                                           slot_hash,
+                                                           alt_accts );
+      /* On failure the txn fails to load without touching the accounts
+         behind its lookup tables. */
+      if( FD_LIKELY( !err ) ) alt_accts_opt = alt_accts;
     }
-  }
+    fd_exec_dag_insert( ctx->exec_dag, txn_p, alt_accts_opt );
+  } FD_SPAD_FRAME_END;
+}
 
-  uchar start_num_free_exec_tiles = (uchar)ctx->exec_cnt;
-  while( num_free_exec_tiles>0 ) {
+static void
+exec_slice( fd_replay_tile_ctx_t * ctx, fd_stem_context_t * stem ) {
 
-    if( fd_slice_exec_txn_ready( &ctx->slice_exec_ctx ) ) {
-      ulong tsorig = fd_frag_meta_ts_comp( fd_tickcount() );
+  /* Assumes that the slice exec ctx has buffered at least one slice.
+     Transactions are parsed out of the slice into the exec dag, which
+     orders them by the accounts they lock, and any transaction whose
+     conflicting predecessors have completed is dispatched to a free
+     exec tile.  Unlike synchronizing at every microblock boundary, an
+     exec tile never idles while a transaction that does not conflict
+     with the ones in flight is pending, whichever microblock or slice
+     (of the same slot) it came from. */
+
+  ulong slot = fd_bank_slot_get( ctx->slot_ctx->bank );
 
-      uchar                  exec_idx = to_exec[ num_free_exec_tiles-1 ];
-      fd_replay_out_link_t * exec_out = &ctx->exec_out[ exec_idx ];
-      num_free_exec_tiles--;
+  /* Parse as much of the slice as fits into the dag */
 
+  while( !fd_exec_dag_full( ctx->exec_dag ) ) {
+    if( fd_slice_exec_txn_ready( &ctx->slice_exec_ctx ) ) {
       fd_txn_p_t txn_p;
       fd_slice_exec_txn_parse( &ctx->slice_exec_ctx, &txn_p );
+      exec_dag_insert_txn( ctx, &txn_p );
+      continue;
+    }
+    if( fd_slice_exec_microblock_ready( &ctx->slice_exec_ctx ) ) {
+      fd_slice_exec_microblock_parse( &ctx->slice_exec_ctx );
+      continue;
+    }
+    break;
+  }
 
-      /* Insert or reverify invoked programs for this epoch, if needed
-         FIXME: this should be done during txn parsing so that we don't have to loop
-         over all accounts a second time. */
-      fd_runtime_update_program_cache( ctx->slot_ctx, &txn_p, ctx->runtime_spad );
+  /* Dispatch ready transactions to the free exec tiles */
 
-      fd_fork_t * fork = fd_fork_frontier_ele_query( ctx->forks->frontier,
-                                                     &slot,
-                                                     NULL,
-                                                     ctx->forks->pool );
+  for( ulong exec_idx=0UL; exec_idx<ctx->exec_cnt; exec_idx++ ) {
+    if( ctx->exec_ready[ exec_idx ]!=EXEC_TXN_READY ) continue;
 
-      if( FD_UNLIKELY( !fork ) ) FD_LOG_ERR(( "Unable to select a fork" ));
+    ulong dag_idx = fd_exec_dag_pop( ctx->exec_dag );
+    if( dag_idx==FD_EXEC_DAG_IDX_NULL ) break;
 
-      fd_bank_txn_count_set( ctx->slot_ctx->bank, fd_bank_txn_count_get( ctx->slot_ctx->bank ) + 1 );
+    ulong                  tsorig   = fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_replay_out_link_t * exec_out = &ctx->exec_out[ exec_idx ];
+    fd_txn_p_t *           txn_p    = fd_exec_dag_txn( ctx->exec_dag, dag_idx );
 
-      /* dispatch dcache */
-      fd_runtime_public_txn_msg_t * exec_msg = (fd_runtime_public_txn_msg_t *)fd_chunk_to_laddr( exec_out->mem, exec_out->chunk );
-      memcpy( &exec_msg->txn, &txn_p, sizeof(fd_txn_p_t) );
-      exec_msg->slot = fd_bank_slot_get( ctx->slot_ctx->bank );
+    /* Insert or reverify invoked programs for this epoch, if needed
+       FIXME: this should be done during txn parsing so that we don't have to loop
+       over all accounts a second time. */
+    fd_runtime_update_program_cache( ctx->slot_ctx, txn_p, ctx->runtime_spad );
 
-      ctx->exec_ready[ exec_idx ] = EXEC_TXN_BUSY;
-      ulong tspub = fd_frag_meta_ts_comp( fd_tickcount() );
-      fd_stem_publish( stem, exec_out->idx, EXEC_NEW_TXN_SIG, exec_out->chunk, sizeof(fd_runtime_public_txn_msg_t), 0UL, tsorig, tspub );
-      exec_out->chunk = fd_dcache_compact_next( exec_out->chunk, sizeof(fd_runtime_public_txn_msg_t), exec_out->chunk0, exec_out->wmark );
+    fd_fork_t * fork = fd_fork_frontier_ele_query( ctx->forks->frontier,
+                                                   &slot,
+                                                   NULL,
+                                                   ctx->forks->pool );
 
-      continue;
-    }
+    if( FD_UNLIKELY( !fork ) ) FD_LOG_ERR(( "Unable to select a fork" ));
 
-    /* If the current microblock is complete, and we still have mblks
-       to read, then advance to the next microblock */
+    fd_bank_txn_count_set( ctx->slot_ctx->bank, fd_bank_txn_count_get( ctx->slot_ctx->bank ) + 1 );
 
-    if( fd_slice_exec_microblock_ready( &ctx->slice_exec_ctx ) ) {
-      ctx->blocked_on_mblock = 1;
-      fd_slice_exec_microblock_parse( &ctx->slice_exec_ctx );
-    }
+    /* dispatch dcache */
+    fd_runtime_public_txn_msg_t * exec_msg = (fd_runtime_public_txn_msg_t *)fd_chunk_to_laddr( exec_out->mem, exec_out->chunk );
+    memcpy( &exec_msg->txn, txn_p, sizeof(fd_txn_p_t) );
+    exec_msg->slot = fd_bank_slot_get( ctx->slot_ctx->bank );
 
-    /* Under this condition, we have finished executing all the
-       microblocks in the slice, and are ready to load another slice.
-       However, if just completed the last batch in the slot, we want
-       to be sure to finalize block execution (below). */
+    ctx->exec_ready  [ exec_idx ] = EXEC_TXN_BUSY;
+    ctx->exec_dag_idx[ exec_idx ] = dag_idx;
+    ulong tspub = fd_frag_meta_ts_comp( fd_tickcount() );
+    fd_stem_publish( stem, exec_out->idx, EXEC_NEW_TXN_SIG, exec_out->chunk, sizeof(fd_runtime_public_txn_msg_t), 0UL, tsorig, tspub );
+    exec_out->chunk = fd_dcache_compact_next( exec_out->chunk, sizeof(fd_runtime_public_txn_msg_t), exec_out->chunk0, exec_out->wmark );
+  }
 
-    if( fd_slice_exec_slice_ready( &ctx->slice_exec_ctx )
-        && !ctx->slice_exec_ctx.last_batch ){
-      ctx->flags = EXEC_FLAG_READY_NEW;
-    }
-    break; /* block on microblock / batch */
+  /* Under this condition, we have parsed all the microblocks in the
+     slice, and are ready to load another slice.  The next slice can
+     overlap with the transactions still pending in the dag as long as
+     it belongs to the same slot, otherwise replay has to drain the dag
+     before switching execution contexts.  However, if we just parsed
+     the last batch in the slot, we want to be sure to finalize block
+     execution (below). */
+
+  if( fd_slice_exec_slice_ready( &ctx->slice_exec_ctx ) && !ctx->slice_exec_ctx.last_batch ) {
+    int drained    = !fd_exec_dag_pending_cnt( ctx->exec_dag );
+    int same_slot  = fd_exec_slice_cnt( ctx->exec_slice_deque ) &&
+                     fd_disco_repair_replay_sig_slot( *fd_exec_slice_peek_head( ctx->exec_slice_deque ) )==slot;
+    if( drained || same_slot ) ctx->flags = EXEC_FLAG_READY_NEW;
   }
 
   if( fd_slice_exec_slot_complete( &ctx->slice_exec_ctx ) ) {
 
-    if( num_free_exec_tiles != start_num_free_exec_tiles ) {
+    if( fd_exec_dag_pending_cnt( ctx->exec_dag ) ) {
       FD_LOG_DEBUG(( "blocked on exec tiles completing" ));
       return;
     }
@@ -1413,18 +1530,28 @@ handle_slice( fd_replay_tile_ctx_t * ctx,
   int    slot_complete = fd_disco_repair_replay_sig_slot_complete( sig );
   ulong  parent_slot   = slot - parent_off;
 
+  /* If the slice is ignored while the dag still holds transactions of
+     the same slot (see exec_slice), the rest of that block is never
+     going to be executed, so drop them. */
+
   if( FD_UNLIKELY( slot < fd_fseq_query( ctx->published_wmark ) ) ) {
     FD_LOG_WARNING(( "ignoring replay of slot %lu (parent: %lu). earlier than our watermark %lu.", slot, parent_slot, fd_fseq_query( ctx->published_wmark ) ));
+    exec_dag_reset( ctx );
     return;
   }
 
   if( FD_UNLIKELY( parent_slot < fd_fseq_query( ctx->published_wmark ) ) ) {
     FD_LOG_WARNING(( "ignoring replay of slot %lu (parent: %lu). parent slot is earlier than our watermark %lu.", slot, parent_slot, fd_fseq_query( ctx->published_wmark ) ) );
+    exec_dag_reset( ctx );
     return;
   }
 
   if( FD_UNLIKELY( slot != fd_bank_slot_get( ctx->slot_ctx->bank ) ) ) {
 
+    /* Whatever is left of the previous slot's block is abandoned */
+
+    exec_dag_reset( ctx );
+
     /* We need to switch forks and execution contexts. Either we
        completed execution of the previous slot and are now executing
        a new slot or we are interleaving batches from different slots.
@@ -1592,6 +1719,10 @@ handle_writer_state_updates( fd_replay_tile_ctx_t * ctx ) {
           FD_LOG_DEBUG(( "Ack that exec tile idx=%lu txn id=%u has been finalized by writer tile %lu", exec_tile_id, txn_id, i ));
           ctx->exec_ready[ exec_tile_id ] = EXEC_TXN_READY;
           ctx->prev_ids[ exec_tile_id ]   = txn_id;
+          if( FD_LIKELY( ctx->exec_dag_idx[ exec_tile_id ]!=FD_EXEC_DAG_IDX_NULL ) ) {
+            fd_exec_dag_complete( ctx->exec_dag, ctx->exec_dag_idx[ exec_tile_id ] );
+            ctx->exec_dag_idx[ exec_tile_id ] = FD_EXEC_DAG_IDX_NULL;
+          }
           fd_fseq_update( ctx->writer_fseq[ i ], FD_WRITER_STATE_READY );
         }
         break;
@@ -1669,6 +1800,14 @@ after_credit( fd_replay_tile_ctx_t * ctx,
 
   /* TODO: Consider moving state management to during_housekeeping */
 
+  /* Advance the funk publish, if any, by one bounded step */
+  funk_publish_step( ctx );
+
+  /* Unlike the exec tiles, replay does not take a funk reader slot
+     around the reads below.  Retired records are only recycled by
+     fd_funk_txn_reclaim, which runs inside the publish calls above and
+     thus in this thread while it holds no records. */
+
   /* Check all the writer link fseqs. */
   handle_writer_state_updates( ctx );
 
@@ -1833,7 +1972,6 @@ after_credit( fd_replay_tile_ctx_t * ctx,
     ctx->last_plugin_push_time = now;
     publish_votes_to_plugin( ctx, stem );
   }
-
 }
 
 static void
@@ -1902,6 +2040,7 @@ unprivileged_init( fd_topo_t *      topo,
     ctx->bmtree[i]           = FD_SCRATCH_ALLOC_APPEND( l, FD_BMTREE_COMMIT_ALIGN, FD_BMTREE_COMMIT_FOOTPRINT(0) );
   }
   void * slice_buf                    = FD_SCRATCH_ALLOC_APPEND( l, 128UL, FD_SLICE_MAX );
+  void * exec_dag_mem                 = FD_SCRATCH_ALLOC_APPEND( l, fd_exec_dag_align(), fd_exec_dag_footprint( EXEC_DAG_TXN_MAX, EXEC_DAG_ACCT_MAX ) );
   ulong  scratch_alloc_mem            = FD_SCRATCH_ALLOC_FINI  ( l, scratch_align() );
 
   if( FD_UNLIKELY( scratch_alloc_mem != ( (ulong)scratch + scratch_footprint( tile ) ) ) ) {
@@ -1935,6 +2074,22 @@ unprivileged_init( fd_topo_t *      topo,
     FD_LOG_ERR(( "no status cache wksp" ));
   }
 
+  /**********************************************************************/
+  /* program cache                                                      */
+  /**********************************************************************/
+
+  /* The program cache is optional.  Without it, every fork validates
+     the programs it executes on its own. */
+  ulong prog_cache_obj_id = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "prog_cache" );
+  if( FD_LIKELY( prog_cache_obj_id!=ULONG_MAX ) ) {
+    ctx->prog_cache = fd_bpf_program_cache_join( fd_topo_obj_laddr( topo, prog_cache_obj_id ) );
+    if( FD_UNLIKELY( !ctx->prog_cache ) ) {
+      FD_LOG_ERR(( "failed to join program cache" ));
+    }
+  } else {
+    ctx->prog_cache = NULL;
+  }
+
   /**********************************************************************/
   /* banks                                                              */
   /**********************************************************************/
@@ -1960,6 +2115,9 @@ unprivileged_init( fd_topo_t *      topo,
   if( FD_UNLIKELY( !fd_funk_join( ctx->funk, fd_topo_obj_laddr( topo, tile->replay.funk_obj_id ) ) ) ) {
     FD_LOG_ERR(( "Failed to join database cache" ));
   }
+  ctx->funk_publish_txn = NULL;
+  ctx->funk_publish_wmk  = 0UL;
+  ctx->funk_publish_bank = NULL;
 
   /**********************************************************************/
   /* root_slot fseq                                                     */
@@ -2105,6 +2263,11 @@ unprivileged_init( fd_topo_t *      topo,
   fd_slice_exec_join( &ctx->slice_exec_ctx );
   ctx->slice_exec_ctx.buf = slice_buf;
 
+  ctx->exec_dag = fd_exec_dag_join( fd_exec_dag_new( exec_dag_mem, EXEC_DAG_TXN_MAX, EXEC_DAG_ACCT_MAX, ctx->funk_seed ) );
+  if( FD_UNLIKELY( !ctx->exec_dag ) ) {
+    FD_LOG_ERR(( "failed to create exec dag" ));
+  }
+
   /**********************************************************************/
   /* capture                                                            */
   /**********************************************************************/
@@ -2176,6 +2339,7 @@ unprivileged_init( fd_topo_t *      topo,
     /* Mark all initial state as not being ready. */
     ctx->exec_ready[ i ]    = EXEC_TXN_BUSY;
     ctx->prev_ids[ i ]      = FD_EXEC_ID_SENTINEL;
+    ctx->exec_dag_idx[ i ]  = FD_EXEC_DAG_IDX_NULL;
 
     ulong exec_fseq_id = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "exec_fseq.%lu", i );
     if( FD_UNLIKELY( exec_fseq_id==ULONG_MAX ) ) {
@@ -2376,6 +2540,17 @@ static inline void
 metrics_write( fd_replay_tile_ctx_t * ctx ) {
   FD_MGAUGE_SET( REPLAY, LAST_VOTED_SLOT, ctx->metrics.last_voted_slot );
   FD_MGAUGE_SET( REPLAY, SLOT, ctx->metrics.slot );
+
+  if( FD_LIKELY( ctx->prog_cache ) ) {
+    fd_bpf_program_cache_metrics_t const * prog_cache_metrics = fd_bpf_program_cache_metrics( ctx->prog_cache );
+    FD_MCNT_SET  ( REPLAY, PROGRAM_CACHE_HIT,         prog_cache_metrics->hit_cnt         );
+    FD_MCNT_SET  ( REPLAY, PROGRAM_CACHE_MISS,        prog_cache_metrics->miss_cnt        );
+    FD_MCNT_SET  ( REPLAY, PROGRAM_CACHE_INSERT,      prog_cache_metrics->insert_cnt      );
+    FD_MCNT_SET  ( REPLAY, PROGRAM_CACHE_INSERT_FAIL, prog_cache_metrics->insert_fail_cnt );
+    FD_MCNT_SET  ( REPLAY, PROGRAM_CACHE_EVICT,       prog_cache_metrics->evict_cnt       );
+    FD_MGAUGE_SET( REPLAY, PROGRAM_CACHE_ENTRIES,     fd_bpf_program_cache_entry_cnt( ctx->prog_cache ) );
+    FD_MGAUGE_SET( REPLAY, PROGRAM_CACHE_SIZE_BYTES,  fd_bpf_program_cache_byte_cnt ( ctx->prog_cache ) );
+  }
 }
 
 /* TODO: This needs to get sized out correctly. */
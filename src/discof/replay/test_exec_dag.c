@@ -0,0 +1,436 @@
+#include "fd_exec_dag.h"
+
+#define TXN_MAX   (1024UL)
+#define ACCT_MAX  (TXN_MAX*16UL+FD_EXEC_DAG_TXN_ACCT_MAX)
+#define MEM_SZ    (16UL<<20)
+
+static uchar mem[ MEM_SZ ] __attribute__((aligned(FD_EXEC_DAG_ALIGN)));
+
+/* Synthetic workload.  Transaction i is a legacy transaction with one
+   writable signer, some writable accounts and some readonly accounts,
+   picked from a universe of UNIVERSE_CNT accounts where a few of them
+   are hot (picked much more often than the others), mimicking popular
+   programs and markets on mainnet. */
+
+#define WL_TXN_CNT      (8192UL)
+#define WL_ACCT_MAX     (12UL)
+#define UNIVERSE_CNT    (4096UL)
+#define HOT_CNT         (16UL)
+
+struct wl_txn {
+  ulong acct_cnt;
+  ulong writable_cnt;      /* the first writable_cnt accounts are writable */
+  ulong acct[ WL_ACCT_MAX ];
+  ulong dur;               /* simulated execution time */
+};
+typedef struct wl_txn wl_txn_t;
+
+static wl_txn_t   wl[ WL_TXN_CNT ];
+static fd_txn_p_t wl_txn_p[ WL_TXN_CNT ];
+
+static ulong
+wl_pick( fd_rng_t * rng,
+         float      hot_frac ) {
+  if( fd_rng_float_c0( rng )<hot_frac ) return fd_rng_ulong_roll( rng, HOT_CNT );
+  return HOT_CNT + fd_rng_ulong_roll( rng, UNIVERSE_CNT-HOT_CNT );
+}
+
+static void
+wl_gen( fd_rng_t * rng,
+        float      hot_frac ) {
+  for( ulong i=0UL; i<WL_TXN_CNT; i++ ) {
+    wl_txn_t * t = &wl[ i ];
+    t->acct_cnt     = 2UL + fd_rng_ulong_roll( rng, WL_ACCT_MAX-1UL );
+    t->writable_cnt = 1UL + fd_rng_ulong_roll( rng, t->acct_cnt );
+    for( ulong j=0UL; j<t->acct_cnt; j++ ) {
+      ulong a;
+      int   dup;
+      do {
+        /* The fee payer is never hot */
+        a   = j ? wl_pick( rng, hot_frac ) : HOT_CNT + fd_rng_ulong_roll( rng, UNIVERSE_CNT-HOT_CNT );
+        dup = 0;
+        for( ulong k=0UL; k<j; k++ ) dup |= t->acct[ k ]==a;
+      } while( dup );
+      t->acct[ j ] = a;
+    }
+    t->dur = 1UL + fd_rng_ulong_roll( rng, 8UL );
+
+    /* Build the matching legacy transaction: the payload is just the
+       account addresses. */
+
+    fd_txn_p_t * p    = &wl_txn_p[ i ];
+    fd_txn_t *   desc = TXN( p );
+    fd_memset( p,    0, sizeof(fd_txn_p_t) );
+    desc->transaction_version   = FD_TXN_VLEGACY;
+    desc->signature_cnt         = 1;
+    desc->readonly_signed_cnt   = 0;
+    desc->readonly_unsigned_cnt = (uchar)( t->acct_cnt - t->writable_cnt );
+    desc->acct_addr_cnt         = (ushort)t->acct_cnt;
+    desc->acct_addr_off         = 0;
+    for( ulong j=0UL; j<t->acct_cnt; j++ ) {
+      fd_memset( p->payload+j*FD_TXN_ACCT_ADDR_SZ, 0, FD_TXN_ACCT_ADDR_SZ );
+      FD_STORE( ulong, p->payload+j*FD_TXN_ACCT_ADDR_SZ, t->acct[ j ] );
+    }
+    p->payload_sz = t->acct_cnt*FD_TXN_ACCT_ADDR_SZ;
+  }
+}
+
+static int
+wl_writable( wl_txn_t const * t,
+             ulong            acct ) {
+  for( ulong j=0UL; j<t->acct_cnt; j++ ) if( t->acct[ j ]==acct ) return j<t->writable_cnt;
+  return -1;
+}
+
+static int
+wl_conflict( wl_txn_t const * t0,
+             wl_txn_t const * t1 ) {
+  for( ulong j=0UL; j<t0->acct_cnt; j++ ) {
+    int w = wl_writable( t1, t0->acct[ j ] );
+    if( w>=0 && ( w || j<t0->writable_cnt ) ) return 1;
+  }
+  return 0;
+}
+
+/* Per account list of the transactions referencing it, in block order,
+   used to check the schedule. */
+
+static ulong acct_ref_cnt[ UNIVERSE_CNT ];
+static ulong acct_ref_off[ UNIVERSE_CNT+1UL ];
+static ulong acct_ref    [ WL_TXN_CNT*WL_ACCT_MAX ];
+
+static void
+wl_index( void ) {
+  fd_memset( acct_ref_cnt, 0, sizeof(acct_ref_cnt) );
+  for( ulong i=0UL; i<WL_TXN_CNT; i++ ) for( ulong j=0UL; j<wl[ i ].acct_cnt; j++ ) acct_ref_cnt[ wl[ i ].acct[ j ] ]++;
+  acct_ref_off[ 0 ] = 0UL;
+  for( ulong a=0UL; a<UNIVERSE_CNT; a++ ) acct_ref_off[ a+1UL ] = acct_ref_off[ a ] + acct_ref_cnt[ a ];
+  fd_memset( acct_ref_cnt, 0, sizeof(acct_ref_cnt) );
+  for( ulong i=0UL; i<WL_TXN_CNT; i++ ) {
+    for( ulong j=0UL; j<wl[ i ].acct_cnt; j++ ) {
+      ulong a = wl[ i ].acct[ j ];
+      acct_ref[ acct_ref_off[ a ] + acct_ref_cnt[ a ]++ ] = i;
+    }
+  }
+}
+
+static uchar done[ WL_TXN_CNT ];
+
+/* check_dispatch verifies that every transaction before i conflicting
+   with it has completed. */
+
+static void
+check_dispatch( ulong i ) {
+  wl_txn_t const * t = &wl[ i ];
+  for( ulong j=0UL; j<t->acct_cnt; j++ ) {
+    ulong a = t->acct[ j ];
+    for( ulong r=acct_ref_off[ a ]; r<acct_ref_off[ a+1UL ]; r++ ) {
+      ulong k = acct_ref[ r ];
+      if( k>=i ) break;
+      if( !done[ k ] && ( j<t->writable_cnt || wl_writable( &wl[ k ], a )==1 ) ) {
+        FD_LOG_ERR(( "txn %lu dispatched before conflicting txn %lu completed", i, k ));
+      }
+    }
+  }
+}
+
+/* Recover the workload index of a dag transaction from its fee payer. */
+
+static ulong dag_seq[ TXN_MAX ];
+
+static void
+test_schedule( fd_exec_dag_t * dag,
+               fd_rng_t *      rng,
+               ulong           exec_cnt ) {
+  fd_memset( done, 0, sizeof(done) );
+
+  ulong running[ 64 ];
+  ulong running_cnt = 0UL;
+  ulong inserted    = 0UL;
+  ulong completed   = 0UL;
+
+  FD_TEST( exec_cnt<=64UL );
+
+  while( completed<WL_TXN_CNT ) {
+    while( inserted<WL_TXN_CNT && !fd_exec_dag_full( dag ) && fd_rng_uint_roll( rng, 4U ) ) {
+      ulong idx = fd_exec_dag_insert( dag, &wl_txn_p[ inserted ], NULL );
+      FD_TEST( idx<TXN_MAX );
+      dag_seq[ idx ] = inserted++;
+    }
+    FD_TEST( fd_exec_dag_pending_cnt( dag )==inserted-completed );
+
+    /* Dispatch to idle exec tiles */
+
+    while( running_cnt<exec_cnt ) {
+      ulong idx = fd_exec_dag_pop( dag );
+      if( idx==FD_EXEC_DAG_IDX_NULL ) break;
+      ulong i = dag_seq[ idx ];
+      FD_TEST( !memcmp( fd_exec_dag_txn( dag, idx ), &wl_txn_p[ i ], sizeof(fd_txn_p_t) ) );
+      check_dispatch( i );
+      running[ running_cnt++ ] = idx;
+    }
+
+    /* A transaction is always runnable unless everything inserted so
+       far is done. */
+
+    FD_TEST( running_cnt || inserted<WL_TXN_CNT );
+    if( !running_cnt ) {
+      FD_TEST( !fd_exec_dag_pending_cnt( dag ) );
+      continue;
+    }
+
+    /* Complete a random running transaction */
+
+    ulong r   = fd_rng_ulong_roll( rng, running_cnt );
+    ulong idx = running[ r ];
+    running[ r ] = running[ --running_cnt ];
+    done[ dag_seq[ idx ] ] = 1;
+    fd_exec_dag_complete( dag, idx );
+    completed++;
+  }
+
+  FD_TEST( !fd_exec_dag_pending_cnt( dag ) );
+  FD_TEST( !fd_exec_dag_ready_cnt  ( dag ) );
+  FD_TEST( fd_exec_dag_pop( dag )==FD_EXEC_DAG_IDX_NULL );
+  FD_TEST( !fd_exec_dag_full( dag ) );
+}
+
+static void
+test_basic( fd_exec_dag_t * dag ) {
+  /* txn 0 writes acct 1, txn 1 reads acct 1, txn 2 reads acct 1, txn 3
+     writes acct 2 */
+
+  fd_txn_p_t txn[ 4 ];
+  ulong      acct[ 4 ][ 2 ]     = { { 100UL, 1UL }, { 101UL, 1UL }, { 102UL, 1UL }, { 103UL, 2UL } };
+  uchar      ro_cnt[ 4 ]        = { 0, 1, 1, 0 };
+  for( ulong i=0UL; i<4UL; i++ ) {
+    fd_txn_t * desc = TXN( &txn[ i ] );
+    fd_memset( &txn[ i ], 0, sizeof(fd_txn_p_t) );
+    desc->transaction_version   = FD_TXN_VLEGACY;
+    desc->signature_cnt         = 1;
+    desc->readonly_unsigned_cnt = ro_cnt[ i ];
+    desc->acct_addr_cnt         = 2;
+    desc->acct_addr_off         = 0;
+    FD_STORE( ulong, txn[ i ].payload,                     acct[ i ][ 0 ] );
+    FD_STORE( ulong, txn[ i ].payload+FD_TXN_ACCT_ADDR_SZ, acct[ i ][ 1 ] );
+  }
+
+  ulong idx[ 4 ];
+  for( ulong i=0UL; i<4UL; i++ ) idx[ i ] = fd_exec_dag_insert( dag, &txn[ i ], NULL );
+  FD_TEST( fd_exec_dag_pending_cnt( dag )==4UL );
+  FD_TEST( fd_exec_dag_ready_cnt  ( dag )==2UL );
+
+  FD_TEST( fd_exec_dag_pop( dag )==idx[ 0 ] );
+  FD_TEST( fd_exec_dag_pop( dag )==idx[ 3 ] );
+  FD_TEST( fd_exec_dag_pop( dag )==FD_EXEC_DAG_IDX_NULL );
+
+  fd_exec_dag_complete( dag, idx[ 3 ] );
+  FD_TEST( fd_exec_dag_ready_cnt( dag )==0UL );
+
+  /* Both readers become ready at once */
+
+  fd_exec_dag_complete( dag, idx[ 0 ] );
+  FD_TEST( fd_exec_dag_ready_cnt( dag )==2UL );
+  FD_TEST( fd_exec_dag_pop( dag )==idx[ 1 ] );
+  FD_TEST( fd_exec_dag_pop( dag )==idx[ 2 ] );
+
+  /* A writer queued behind the readers waits for both */
+
+  ulong w = fd_exec_dag_insert( dag, &txn[ 0 ], NULL );
+  FD_TEST( fd_exec_dag_ready_cnt( dag )==0UL );
+  fd_exec_dag_complete( dag, idx[ 2 ] );
+  FD_TEST( fd_exec_dag_ready_cnt( dag )==0UL );
+  fd_exec_dag_complete( dag, idx[ 1 ] );
+  FD_TEST( fd_exec_dag_pop( dag )==w );
+  fd_exec_dag_complete( dag, w );
+  FD_TEST( !fd_exec_dag_pending_cnt( dag ) );
+
+  /* Reset drops pending transactions */
+
+  for( ulong i=0UL; i<4UL; i++ ) fd_exec_dag_insert( dag, &txn[ i ], NULL );
+  fd_exec_dag_reset( dag );
+  FD_TEST( !fd_exec_dag_pending_cnt( dag ) );
+  FD_TEST( !fd_exec_dag_ready_cnt  ( dag ) );
+  FD_TEST( fd_exec_dag_pop( dag )==FD_EXEC_DAG_IDX_NULL );
+}
+
+/* test_abandon abandons a block midway, with transactions still
+   running and others waiting on them, like replay does when it
+   switches slots or drops a slot below the published watermark.  After
+   the reset the dag must schedule the next block from scratch, without
+   any account still held or waited on by the abandoned one. */
+
+static void
+test_abandon( fd_exec_dag_t * dag,
+              fd_rng_t *      rng ) {
+  for( ulong i=0UL; i<WL_TXN_CNT && !fd_exec_dag_full( dag ); i++ ) fd_exec_dag_insert( dag, &wl_txn_p[ i ], NULL );
+  FD_TEST( fd_exec_dag_pending_cnt( dag ) );
+  for( ulong i=0UL; i<4UL; i++ ) fd_exec_dag_pop( dag );
+
+  fd_exec_dag_reset( dag );
+  FD_TEST( !fd_exec_dag_pending_cnt( dag ) );
+  FD_TEST( !fd_exec_dag_ready_cnt  ( dag ) );
+  FD_TEST( !fd_exec_dag_full       ( dag ) );
+
+  /* Every account of the first transactions was held or waited on, so
+     a conflicting transaction is only ready if the reset dropped them */
+
+  ulong idx = fd_exec_dag_insert( dag, &wl_txn_p[ 0 ], NULL );
+  FD_TEST( fd_exec_dag_pop( dag )==idx );
+  fd_exec_dag_complete( dag, idx );
+  FD_TEST( !fd_exec_dag_pending_cnt( dag ) );
+
+  test_schedule( dag, rng, 4UL );
+}
+
+/* Simulated replay of the workload on exec_cnt exec tiles, in units of
+   the transactions' dur.  The barrier policy dispatches the
+   transactions of a microblock to any idle exec tile but waits for all
+   of them to complete before starting the next microblock.  Microblocks
+   are cut from the workload like pack would: a microblock holds at most
+   mblk_max non conflicting transactions.  The dag policy dispatches any
+   ready transaction to any idle exec tile.  Returns the makespan. */
+
+static ulong
+sim_barrier( ulong exec_cnt,
+             ulong mblk_max,
+             ulong * mblk_cnt_out ) {
+  ulong t        = 0UL;
+  ulong mblk_cnt = 0UL;
+  ulong i        = 0UL;
+  while( i<WL_TXN_CNT ) {
+    ulong end = i+1UL;
+    while( end<WL_TXN_CNT && end-i<mblk_max ) {
+      int conflict = 0;
+      for( ulong k=i; k<end && !conflict; k++ ) conflict = wl_conflict( &wl[ end ], &wl[ k ] );
+      if( conflict ) break;
+      end++;
+    }
+
+    /* List schedule the microblock */
+
+    ulong tile_free[ 64 ] = {0};
+    ulong span            = 0UL;
+    for( ulong k=i; k<end; k++ ) {
+      ulong m = 0UL;
+      for( ulong e=1UL; e<exec_cnt; e++ ) if( tile_free[ e ]<tile_free[ m ] ) m = e;
+      tile_free[ m ] += wl[ k ].dur;
+      span = fd_ulong_max( span, tile_free[ m ] );
+    }
+    t += span;
+    mblk_cnt++;
+    i = end;
+  }
+  *mblk_cnt_out = mblk_cnt;
+  return t;
+}
+
+static ulong
+sim_dag( fd_exec_dag_t * dag,
+         ulong           exec_cnt ) {
+  ulong run_idx[ 64 ];
+  ulong run_end[ 64 ];
+  ulong run_cnt  = 0UL;
+  ulong t        = 0UL;
+  ulong inserted = 0UL;
+  ulong left     = WL_TXN_CNT;
+  while( left ) {
+    while( inserted<WL_TXN_CNT && !fd_exec_dag_full( dag ) ) {
+      dag_seq[ fd_exec_dag_insert( dag, &wl_txn_p[ inserted ], NULL ) ] = inserted;
+      inserted++;
+    }
+    while( run_cnt<exec_cnt ) {
+      ulong idx = fd_exec_dag_pop( dag );
+      if( idx==FD_EXEC_DAG_IDX_NULL ) break;
+      run_idx[ run_cnt ] = idx;
+      run_end[ run_cnt ] = t + wl[ dag_seq[ idx ] ].dur;
+      run_cnt++;
+    }
+    FD_TEST( run_cnt );
+
+    /* Advance to the next completion */
+
+    ulong r = 0UL;
+    for( ulong k=1UL; k<run_cnt; k++ ) if( run_end[ k ]<run_end[ r ] ) r = k;
+    t = run_end[ r ];
+    fd_exec_dag_complete( dag, run_idx[ r ] );
+    run_cnt--;
+    run_idx[ r ] = run_idx[ run_cnt ];
+    run_end[ r ] = run_end[ run_cnt ];
+    left--;
+  }
+  return t;
+}
+
+static void
+bench( fd_exec_dag_t * dag ) {
+  ulong work = 0UL;
+  for( ulong i=0UL; i<WL_TXN_CNT; i++ ) work += wl[ i ].dur;
+
+  ulong exec_cnts[ 4 ] = { 4UL, 8UL, 16UL, 32UL };
+  for( ulong k=0UL; k<4UL; k++ ) {
+    ulong exec_cnt = exec_cnts[ k ];
+    ulong mblk_cnt;
+    ulong t_barrier = sim_barrier( exec_cnt, 64UL, &mblk_cnt );
+    ulong t_dag     = sim_dag( dag, exec_cnt );
+    FD_LOG_NOTICE(( "exec_cnt %2lu  mblk_cnt %5lu  barrier: span %7lu util %5.1f%%  dag: span %7lu util %5.1f%%",
+                    exec_cnt, mblk_cnt,
+                    t_barrier, 100.*(double)work/((double)exec_cnt*(double)t_barrier),
+                    t_dag,     100.*(double)work/((double)exec_cnt*(double)t_dag    ) ));
+    FD_TEST( t_dag*(ulong)exec_cnt>=work );
+  }
+
+  /* Raw scheduling throughput */
+
+  ulong iter = 16UL;
+  long  dt   = -fd_log_wallclock();
+  for( ulong r=0UL; r<iter; r++ ) sim_dag( dag, 16UL );
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "insert+pop+complete: %.1f ns/txn", (double)dt/((double)iter*(double)WL_TXN_CNT) ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  float hot_frac = fd_env_strip_cmdline_float( &argc, &argv, "--hot-frac", NULL, 0.1f );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+
+  FD_TEST( fd_exec_dag_align()==FD_EXEC_DAG_ALIGN );
+  FD_TEST( !fd_exec_dag_footprint( 0UL,     ACCT_MAX                     ) );
+  FD_TEST( !fd_exec_dag_footprint( TXN_MAX, FD_EXEC_DAG_TXN_ACCT_MAX-1UL ) );
+  ulong footprint = fd_exec_dag_footprint( TXN_MAX, ACCT_MAX );
+  FD_TEST( footprint && footprint<=MEM_SZ );
+
+  FD_TEST( !fd_exec_dag_new( NULL,  TXN_MAX, ACCT_MAX, 0UL ) );
+  FD_TEST( !fd_exec_dag_new( mem+1, TXN_MAX, ACCT_MAX, 0UL ) );
+  FD_TEST( !fd_exec_dag_new( mem,   0UL,     ACCT_MAX, 0UL ) );
+  fd_exec_dag_t * dag = fd_exec_dag_join( fd_exec_dag_new( mem, TXN_MAX, ACCT_MAX, 5678UL ) );
+  FD_TEST( dag );
+
+  test_basic( dag );
+
+  wl_gen( rng, hot_frac );
+  wl_index();
+  for( ulong exec_cnt=1UL; exec_cnt<=16UL; exec_cnt*=2UL ) test_schedule( dag, rng, exec_cnt );
+  test_abandon( dag, rng );
+
+  /* A small dag is full often */
+
+  fd_exec_dag_t * small = fd_exec_dag_join( fd_exec_dag_new( mem, 8UL, 3UL*FD_EXEC_DAG_TXN_ACCT_MAX, 5678UL ) );
+  FD_TEST( small );
+  test_schedule( small, rng, 4UL );
+  FD_TEST( fd_exec_dag_delete( fd_exec_dag_leave( small ) )==mem );
+
+  dag = fd_exec_dag_join( fd_exec_dag_new( mem, TXN_MAX, ACCT_MAX, 5678UL ) );
+  bench( dag );
+
+  FD_TEST( fd_exec_dag_delete( fd_exec_dag_leave( dag ) )==mem );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -66,6 +66,7 @@ struct fd_rpc_global_ctx {
   fd_spad_t * spad;
   fd_webserver_t ws;
   fd_funk_t * funk;
+  ulong funk_reader_idx; /* See fd_funk_reader_init */
   fd_blockstore_t blockstore[1];
   int blockstore_fd;
   struct fd_ws_subscription sub_list[FD_WS_MAX_SUBS];
@@ -106,16 +107,27 @@ fd_method_error( fd_rpc_ctx_t * ctx, int errcode, const char* format, ... ) {
   fd_method_simple_error(ctx, errcode, text);
 }
 
+/* The replay tile publishes rooted slots while we copy accounts out of
+   funk, so the copies are done inside a funk reader region. */
+
 static const void *
 read_account_with_xid( fd_rpc_ctx_t * ctx, fd_funk_rec_key_t * recid, fd_funk_txn_xid_t * xid, ulong * result_len ) {
-  fd_funk_txn_map_t * txn_map = fd_funk_txn_map( ctx->global->funk );
+  fd_rpc_global_ctx_t * gctx = ctx->global;
+  fd_funk_reader_enter( gctx->funk, gctx->funk_reader_idx );
+  fd_funk_txn_map_t * txn_map = fd_funk_txn_map( gctx->funk );
   fd_funk_txn_t *     txn     = fd_funk_txn_query( xid, txn_map );
-  return fd_funk_rec_query_copy( ctx->global->funk, txn, recid, fd_spad_virtual(ctx->global->spad), result_len );
+  const void *        val     = fd_funk_rec_query_copy( gctx->funk, txn, recid, fd_spad_virtual(gctx->spad), result_len );
+  fd_funk_reader_leave( gctx->funk, gctx->funk_reader_idx );
+  return val;
 }
 
 static const void *
 read_account( fd_rpc_ctx_t * ctx, fd_funk_rec_key_t * recid, ulong * result_len ) {
-  return fd_funk_rec_query_copy( ctx->global->funk, NULL, recid, fd_spad_virtual(ctx->global->spad), result_len );
+  fd_rpc_global_ctx_t * gctx = ctx->global;
+  fd_funk_reader_enter( gctx->funk, gctx->funk_reader_idx );
+  const void * val = fd_funk_rec_query_copy( gctx->funk, NULL, recid, fd_spad_virtual(gctx->spad), result_len );
+  fd_funk_reader_leave( gctx->funk, gctx->funk_reader_idx );
+  return val;
 }
 
 static ulong
@@ -2322,6 +2334,9 @@ fd_rpc_start_service(fd_rpcserver_args_t * args, fd_rpc_ctx_t * ctx) {
   fd_rpc_global_ctx_t * gctx = ctx->global;
 
   gctx->funk = args->funk;
+  gctx->funk_reader_idx = args->funk_reader_idx;
+  if( FD_UNLIKELY( gctx->funk_reader_idx>=FD_FUNK_READER_MAX ) ) FD_LOG_ERR(( "bad funk reader slot %lu", gctx->funk_reader_idx ));
+  fd_funk_reader_init( gctx->funk, gctx->funk_reader_idx );
   memcpy( gctx->blockstore, args->blockstore, sizeof(fd_blockstore_t) );
   gctx->blockstore_fd = args->blockstore_fd;
 }
@@ -16,6 +16,7 @@ typedef struct fd_rpc_ctx fd_rpc_ctx_t;
 struct fd_rpcserver_args {
   int                        offline;
   fd_funk_t                  funk[1];
+  ulong                      funk_reader_idx; /* See fd_funk_reader_init */
   fd_blockstore_t            blockstore_ljoin;
   fd_blockstore_t          * blockstore;
   int                        blockstore_fd;
@@ -230,6 +230,7 @@ unprivileged_init( fd_topo_t *      topo,
   if( FD_UNLIKELY( !fd_funk_join( args->funk, fd_topo_obj_laddr( topo, tile->rpcserv.funk_obj_id ) ) ) ) {
     FD_LOG_ERR(( "Failed to join database cache" ));
   }
+  args->funk_reader_idx = tile->rpcserv.funk_reader_idx;
   fd_rpc_start_service( args, ctx->ctx );
 }
 
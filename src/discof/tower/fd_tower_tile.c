@@ -57,6 +57,7 @@ typedef struct {
   uchar *                     epoch_voters_buf;
   char                        funk_file[PATH_MAX];
   fd_funk_t                   funk[1];
+  ulong                       funk_reader_idx; /* See fd_funk_reader_init */
   fd_gossip_vote_t            gossip_vote;
   fd_lockout_offset_t         lockouts[FD_TOWER_VOTE_MAX];
   fd_tower_t *                scratch;
@@ -286,6 +287,11 @@ after_frag( ctx_t *             ctx,
   if( FD_UNLIKELY( !funk_txn ) ) FD_LOG_ERR(( "Could not find valid funk transaction" ));
   fd_funk_txn_end_read( ctx->funk );
 
+  /* The vote accounts are read from funk while the replay tile might
+     be publishing rooted slots. */
+
+  fd_funk_reader_enter( ctx->funk, ctx->funk_reader_idx );
+
   /* Initialize the tower */
 
   if( FD_UNLIKELY( fd_tower_votes_empty( ctx->tower ) ) ) fd_tower_from_vote_acc( ctx->tower, ctx->funk, funk_txn, &ctx->funk_key );
@@ -295,6 +301,8 @@ after_frag( ctx_t *             ctx,
   update_ghost( ctx, funk_txn );
 
   ulong vote_slot = fd_tower_vote_slot( ctx->tower, ctx->epoch, ctx->funk, funk_txn, ctx->ghost, ctx->scratch );
+
+  fd_funk_reader_leave( ctx->funk, ctx->funk_reader_idx );
   if( FD_UNLIKELY( vote_slot == FD_SLOT_NULL ) ) return; /* nothing to vote on */
 
   ulong root = fd_tower_vote( ctx->tower, vote_slot );
@@ -339,6 +347,8 @@ unprivileged_init( fd_topo_t *      topo,
   if( FD_UNLIKELY( !fd_funk_join( ctx->funk, fd_topo_obj_laddr( topo, tile->tower.funk_obj_id ) ) ) ) {
     FD_LOG_ERR(( "Failed to join database cache" ));
   }
+  ctx->funk_reader_idx = tile->tower.funk_reader_idx;
+  fd_funk_reader_init( ctx->funk, ctx->funk_reader_idx );
 
   ctx->epoch_voters_buf = voter_mem;
 
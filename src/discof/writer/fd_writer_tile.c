@@ -30,6 +30,7 @@ struct fd_writer_tile_ctx {
   /* Local join of Funk.  R/W. */
   fd_funk_t                   funk[1];
   fd_funk_txn_t *             funk_txn;
+  ulong                       funk_reader_idx; /* See fd_funk_reader_init */
 
   /* Link management. */
   fd_writer_tile_in_ctx_t     exec_writer_in[ FD_PACK_MAX_BANK_TILES ];
@@ -196,7 +197,9 @@ during_frag( fd_writer_tile_ctx_t * ctx,
           FD_LOG_CRIT(( "No bank for slot %lu", info.txn_ctx->slot ));
         }
 
+        fd_funk_reader_enter( ctx->funk, ctx->funk_reader_idx );
         fd_runtime_finalize_txn( ctx->funk, ctx->funk_txn, &info, ctx->spad, ctx->bank );
+        fd_funk_reader_leave( ctx->funk, ctx->funk_reader_idx );
       } FD_SPAD_FRAME_END;
     }
     /* Notify the replay tile. */
@@ -320,6 +323,8 @@ unprivileged_init( fd_topo_t *      topo,
   if( FD_UNLIKELY( !fd_funk_join( ctx->funk, fd_topo_obj_laddr( topo, tile->writer.funk_obj_id ) ) ) ) {
     FD_LOG_ERR(( "Failed to join database cache" ));
   }
+  ctx->funk_reader_idx = tile->writer.funk_reader_idx;
+  fd_funk_reader_init( ctx->funk, ctx->funk_reader_idx );
 
   /********************************************************************/
   /* Setup fseq                                                       */
@@ -563,6 +563,7 @@ unprivileged_init( fd_topo_t *      topo,
   ctx->bmtree = NONNULL( bmtree );
 
   NONNULL( fd_pack_rebate_sum_join( fd_pack_rebate_sum_new( ctx->rebater ) ) );
+  fd_pack_rebate_sum_set_cost_obs( ctx->rebater, tile->bank.cost_observations );
   ctx->rebates_for_slot  = 0UL;
 
   ulong busy_obj_id = fd_pod_queryf_ulong( topo->props, ULONG_MAX, "bank_busy.%lu", tile->kind_id );
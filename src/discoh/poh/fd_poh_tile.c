@@ -317,7 +317,9 @@
 #include "../../disco/keyguard/fd_keyswitch.h"
 #include "../../disco/metrics/generated/fd_metrics_poh.h"
 #include "../../disco/plugin/fd_plugin.h"
+#include "../../disco/verify/fd_verify_tile.h"
 #include "../../flamenco/leaders/fd_multi_epoch_leaders.h"
+#include "../../ballet/txn/fd_compact_u16.h"
 
 #include <string.h>
 
@@ -2082,10 +2084,18 @@ fd_ext_shred_set_shred_version( ulong shred_version ) {
   *fd_shred_version = shred_version;
 }
 
+/* Gossip votes and executed txns are published with the same frag sig
+   the verify tiles use (see fd_verify_dedup_sig), so that each dedup
+   tile can skip the ones outside of its partition without copying or
+   parsing them.  The first signature of a txn follows the compact-u16
+   signature count. */
+
 void
 fd_ext_poh_publish_gossip_vote( uchar * data,
                                 ulong   data_len ) {
-  poh_link_publish( &gossip_dedup, 1UL, data, data_len );
+  ulong sig_off = fd_cu16_dec_sz( data, data_len );
+  ulong sig     = (sig_off && data_len>=sig_off+64UL) ? fd_verify_dedup_sig( data+sig_off ) : 0UL;
+  poh_link_publish( &gossip_dedup, sig, data, data_len );
 }
 
 void
@@ -2112,7 +2122,7 @@ fd_ext_poh_publish_executed_txn( uchar const * data  ) {
   }
 
   FD_COMPILER_MFENCE();
-  poh_link_publish( &executed_txn, 0UL, data, 64UL );
+  poh_link_publish( &executed_txn, fd_verify_dedup_sig( data ), data, 64UL );
   FD_COMPILER_MFENCE();
 
   FD_VOLATILE(lock) = 0;
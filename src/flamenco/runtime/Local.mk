@@ -1,6 +1,9 @@
 ifdef FD_HAS_INT128
 $(call add-hdrs,fd_acc_mgr.h)
 $(call add-objs,fd_acc_mgr,fd_flamenco)
+ifdef FD_HAS_HOSTED
+$(call make-unit-test,bench_acc_mgr_prefetch,bench_acc_mgr_prefetch,fd_flamenco fd_funk fd_ballet fd_util)
+endif
 
 $(call add-hdrs,fd_txn_account.h)
 $(call add-objs,fd_txn_account,fd_flamenco)
@@ -52,6 +55,12 @@ endif
 ifdef FD_HAS_ATOMIC
 $(call add-hdrs,fd_runtime.h fd_runtime_init.h fd_runtime_err.h)
 $(call add-objs,fd_runtime fd_runtime_init ,fd_flamenco)
+ifdef FD_HAS_SECP256K1
+$(call make-unit-test,test_spec_exec,test_spec_exec,fd_flamenco fd_funk fd_ballet fd_util,$(SECP256K1_LIBS))
+ifdef FD_HAS_X86
+$(call make-unit-test,test_jit_exec,test_jit_exec,fd_flamenco fd_funk fd_ballet fd_util,$(SECP256K1_LIBS))
+endif
+endif
 endif
 
 endif
@@ -0,0 +1,173 @@
+/* bench_acc_mgr_prefetch measures the time to load the accounts of a
+   transaction from a large funk with and without fd_acc_mgr_prefetch.
+
+   Accounts are loaded with fd_funk_get_acc_meta_readonly like the
+   executor does and the metadata and first data bytes are touched.
+   The modes are:
+
+     serial     load the accounts one after the other
+     prefetch   fd_acc_mgr_prefetch the txn's accounts, then load them
+     lookahead  additionally prefetch the accounts of the next
+                --lookahead txns before loading a txn, like an exec
+                tile that knows its upcoming txns would */
+
+#include "fd_acc_mgr.h"
+#include "../../funk/fd_funk.h"
+
+#define FUNK_TAG 1UL
+
+static void
+acc_pubkey( fd_pubkey_t * pubkey,
+            ulong         idx ) {
+  fd_memset( pubkey, 0, sizeof(fd_pubkey_t) );
+  pubkey->ul[ 0 ] = idx;
+  pubkey->ul[ 1 ] = fd_ulong_hash( idx );
+}
+
+__attribute__((noinline)) static void
+populate( fd_funk_t * funk,
+          ulong       acc_cnt,
+          ulong       data_sz ) {
+  fd_wksp_t * wksp = fd_funk_wksp( funk );
+  for( ulong i=0UL; i<acc_cnt; i++ ) {
+    fd_pubkey_t       pubkey; acc_pubkey( &pubkey, i );
+    fd_funk_rec_key_t key = fd_funk_acc_key( &pubkey );
+
+    fd_funk_rec_prepare_t prepare[1];
+    fd_funk_rec_t * rec = fd_funk_rec_prepare( funk, NULL, &key, prepare, NULL );
+    FD_TEST( rec );
+    fd_account_meta_t * meta = fd_funk_val_truncate( rec, fd_funk_alloc( funk ), wksp, 0UL, sizeof(fd_account_meta_t)+data_sz, NULL );
+    FD_TEST( meta );
+    fd_account_meta_init( meta );
+    meta->dlen          = data_sz;
+    meta->info.lamports = i+1UL;
+    fd_funk_rec_publish( funk, prepare );
+
+    if( FD_UNLIKELY( !((i+1UL) % 10000000UL) ) ) FD_LOG_NOTICE(( "inserted %lu accounts", i+1UL ));
+  }
+}
+
+/* load touches the accounts of txn like the executor setting up a
+   transaction would. */
+
+static inline ulong
+load( fd_funk_t const *   funk,
+      fd_pubkey_t const * txn,
+      ulong               acct_cnt ) {
+  ulong sum = 0UL;
+  for( ulong j=0UL; j<acct_cnt; j++ ) {
+    fd_account_meta_t const * meta = fd_funk_get_acc_meta_readonly( funk, NULL, txn+j, NULL, NULL, NULL );
+    if( FD_UNLIKELY( !meta ) ) FD_LOG_ERR(( "account not found" ));
+    uchar const * data = fd_account_meta_get_data_const( meta );
+    sum += meta->info.lamports + data[ 0 ] + data[ meta->dlen ? meta->dlen-1UL : 0UL ];
+  }
+  return sum;
+}
+
+#define MODE_SERIAL    (0)
+#define MODE_PREFETCH  (1)
+#define MODE_LOOKAHEAD (2)
+
+__attribute__((noinline)) static double
+run( fd_funk_t const *   funk,
+     fd_pubkey_t const * txns,
+     ulong               txn_cnt,
+     ulong               acct_cnt,
+     ulong               lookahead,
+     int                 mode,
+     ulong *             sum ) {
+  long dt = -fd_log_wallclock();
+  if( mode==MODE_LOOKAHEAD ) {
+    for( ulong t=0UL; t<fd_ulong_min( lookahead, txn_cnt ); t++ ) fd_acc_mgr_prefetch( funk, txns+t*acct_cnt, acct_cnt );
+  }
+  for( ulong t=0UL; t<txn_cnt; t++ ) {
+    fd_pubkey_t const * txn = txns + t*acct_cnt;
+    switch( mode ) {
+    case MODE_PREFETCH:
+      fd_acc_mgr_prefetch( funk, txn, acct_cnt );
+      break;
+    case MODE_LOOKAHEAD:
+      if( t+lookahead<txn_cnt ) fd_acc_mgr_prefetch( funk, txns+(t+lookahead)*acct_cnt, acct_cnt );
+      break;
+    default:
+      break;
+    }
+    *sum += load( funk, txn, acct_cnt );
+  }
+  dt += fd_log_wallclock();
+  return (double)dt/(double)txn_cnt;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * name      = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--wksp",      NULL,            NULL );
+  char const * _page_sz  = fd_env_strip_cmdline_cstr  ( &argc, &argv, "--page-sz",   NULL,      "gigantic" );
+  ulong        page_cnt  = fd_env_strip_cmdline_ulong ( &argc, &argv, "--page-cnt",  NULL,            64UL );
+  ulong        near_cpu  = fd_env_strip_cmdline_ulong ( &argc, &argv, "--near-cpu",  NULL, fd_log_cpu_id() );
+  double       acc_cnt_d = fd_env_strip_cmdline_double( &argc, &argv, "--accounts",  NULL,             1e8 );
+  ulong        data_sz   = fd_env_strip_cmdline_ulong ( &argc, &argv, "--data-sz",   NULL,           128UL );
+  ulong        txn_cnt   = fd_env_strip_cmdline_ulong ( &argc, &argv, "--txn-cnt",   NULL,        100000UL );
+  ulong        acct_cnt  = fd_env_strip_cmdline_ulong ( &argc, &argv, "--txn-accts", NULL,            32UL );
+  ulong        lookahead = fd_env_strip_cmdline_ulong ( &argc, &argv, "--lookahead", NULL,             1UL );
+  uint         rng_seed  = fd_env_strip_cmdline_uint  ( &argc, &argv, "--rng-seed",  NULL,          1234UL );
+
+  ulong const acc_cnt = (ulong)acc_cnt_d;
+  if( FD_UNLIKELY( !acc_cnt || !txn_cnt || !acct_cnt || acct_cnt>FD_TXN_ACCT_ADDR_MAX ) ) FD_LOG_ERR(( "invalid arguments" ));
+
+  fd_rng_t rng_[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( rng_, rng_seed, 0UL ) );
+
+  fd_wksp_t * wksp;
+  if( name ) {
+    FD_LOG_NOTICE(( "Attaching to --wksp %s", name ));
+    wksp = fd_wksp_attach( name );
+  } else {
+    FD_LOG_NOTICE(( "--wksp not specified, using an anonymous local workspace, --page-sz %s, --page-cnt %lu, --near-cpu %lu",
+                    _page_sz, page_cnt, near_cpu ));
+    wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  }
+  FD_TEST( wksp );
+
+  void * funk_mem = fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint( 16UL, acc_cnt ), FUNK_TAG );
+  if( FD_UNLIKELY( !funk_mem ) ) FD_LOG_ERR(( "failed to allocate funk" ));
+  fd_funk_t funk_[1];
+  fd_funk_t * funk = fd_funk_join( funk_, fd_funk_new( funk_mem, FUNK_TAG, (ulong)rng_seed, 16UL, acc_cnt ) );
+  FD_TEST( funk );
+
+  FD_LOG_NOTICE(( "Inserting %lu accounts (data_sz %lu)", acc_cnt, data_sz ));
+  long dt = -fd_log_wallclock();
+  populate( funk, acc_cnt, data_sz );
+  dt += fd_log_wallclock();
+  FD_LOG_NOTICE(( "Inserted in %.2fs", (double)dt/1e9 ));
+
+  /* Uniformly random accounts, so nearly every load misses the cache
+     on a funk much larger than the cache */
+
+  fd_pubkey_t * txns = fd_wksp_alloc_laddr( wksp, alignof(fd_pubkey_t), txn_cnt*acct_cnt*sizeof(fd_pubkey_t), FUNK_TAG );
+  if( FD_UNLIKELY( !txns ) ) FD_LOG_ERR(( "failed to allocate txns" ));
+  for( ulong i=0UL; i<txn_cnt*acct_cnt; i++ ) acc_pubkey( txns+i, fd_rng_ulong_roll( rng, acc_cnt ) );
+
+  ulong sum = 0UL;
+  char const * mode_name[3] = { "serial", "prefetch", "lookahead" };
+  for( int rep=0; rep<2; rep++ ) {
+    for( int mode=MODE_SERIAL; mode<=MODE_LOOKAHEAD; mode++ ) {
+      double ns = run( funk, txns, txn_cnt, acct_cnt, lookahead, mode, &sum );
+      FD_LOG_NOTICE(( "%-9s %lu accts/txn: %8.1f ns/txn (%6.1f ns/acct)", mode_name[ mode ], acct_cnt, ns, ns/(double)acct_cnt ));
+    }
+  }
+  FD_LOG_NOTICE(( "checksum %lu", sum ));
+
+  fd_wksp_free_laddr( txns );
+  fd_funk_leave( funk, NULL );
+  fd_funk_delete_fast( funk_mem );
+  if( name ) fd_wksp_detach( wksp );
+  else       fd_wksp_delete_anonymous( wksp );
+  fd_rng_delete( fd_rng_leave( rng ) );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
@@ -11,6 +11,8 @@
 #include "../fd_acc_mgr.h"
 #include "../fd_bank_hash_cmp.h"
 #include "../fd_bank.h"
+#include "../program/fd_bpf_program_cache.h"
+#include "../program/fd_bpf_jit_cache.h"
 
 /* fd_exec_slot_ctx_t is the context that stays constant during all
    transactions in a block. */
@@ -29,6 +31,24 @@ struct fd_exec_slot_ctx {
   fd_funk_txn_t * funk_txn;
 
   fd_txncache_t * status_cache;
+
+  /* Node-wide cache of validated programs shared across forks and
+     tiles.  Optional (NULL means every fork validates programs on its
+     own). */
+  fd_bpf_program_cache_t * prog_cache;
+
+  /* Speculative execution of the transactions of a block across
+     microblocks (see fd_runtime_process_txns_speculative), statistics
+     are accumulated into it.  Optional (NULL means transactions are
+     executed microblock by microblock).  Only set by offline replay
+     (fd_ledger --spec-exec), the replay tile leaves it NULL. */
+  struct fd_runtime_spec_metrics * spec_exec;
+
+  /* Jit caches of the threads executing transactions, indexed by tpool
+     worker (see fd_bpf_jit_cache).  Optional (NULL means BPF programs
+     run on the interpreter).  Only set by offline replay (fd_ledger
+     --jit), exec tiles have their own. */
+  fd_bpf_jit_cache_t ** jit_caches;
 };
 
 #define FD_EXEC_SLOT_CTX_ALIGN     (alignof(fd_exec_slot_ctx_t))
@@ -199,6 +199,8 @@ fd_exec_txn_ctx_setup_basic( fd_exec_txn_ctx_t * ctx ) {
   ctx->failed_instr    = NULL;
   ctx->instr_err_idx   = INT_MAX;
   ctx->capture_ctx     = NULL;
+  ctx->jit_cache       = NULL;
+  ctx->vm_fuse         = 1;
 
   ctx->instr_info_cnt     = 0UL;
   ctx->cpi_instr_info_cnt = 0UL;
@@ -9,6 +9,7 @@
 #include "../fd_bank_hash_cmp.h"
 #include "../fd_bank.h"
 #include "../../../funk/fd_funk.h"
+#include "../program/fd_bpf_jit_cache.h"
 
 /* Return data for syscalls */
 
@@ -138,6 +139,17 @@ struct fd_exec_txn_ctx {
 
   fd_capture_ctx_t * capture_ctx;
 
+  /* Native code for the BPF programs run by the thread executing this
+     transaction (see fd_bpf_execute).  Optional (NULL means programs
+     run on the interpreter). */
+  fd_bpf_jit_cache_t * jit_cache;
+
+  /* 1 if BPF programs run on the interpreter dispatch the
+     superinstructions found when they were validated (see
+     fd_vm_fuse_build) and 0 if every instruction runs on the plain
+     interpreter. */
+  int                  vm_fuse;
+
   /* The instr_infos for the entire transaction are allocated at the start of
      the transaction. However, this must preserve a different counter because
      the top level instructions must get set up at once. The instruction
@@ -121,6 +121,25 @@ fd_funk_get_acc_meta_mutable( fd_funk_t *             funk,
   return meta;
 }
 
+void
+fd_acc_mgr_prefetch( fd_funk_t const *   funk,
+                     fd_pubkey_t const * pubkeys,
+                     ulong               cnt ) {
+  ulong hash[ FD_TXN_ACCT_ADDR_MAX ];
+
+  /* Batches of FD_TXN_ACCT_ADDR_MAX, which covers a txn in one pass */
+
+  for( ulong off=0UL; off<cnt; off+=FD_TXN_ACCT_ADDR_MAX ) {
+    ulong batch_cnt = fd_ulong_min( cnt-off, FD_TXN_ACCT_ADDR_MAX );
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      fd_funk_rec_key_t key = fd_funk_acc_key( pubkeys+off+i );
+      hash[ i ] = fd_funk_rec_prefetch_chain( funk, &key );
+    }
+    for( ulong i=0UL; i<batch_cnt; i++ ) fd_funk_rec_prefetch_ele( funk, hash[ i ] );
+    for( ulong i=0UL; i<batch_cnt; i++ ) fd_funk_rec_prefetch_val( funk, hash[ i ], sizeof(fd_account_meta_t)+FD_ACC_MGR_PREFETCH_DATA_SZ );
+  }
+}
+
 FD_FN_CONST char const *
 fd_acc_mgr_strerror( int err ) {
   switch( err ) {
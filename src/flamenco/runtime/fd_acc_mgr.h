@@ -207,6 +207,22 @@ fd_funk_get_acc_meta_mutable( fd_funk_t *             funk,
                               fd_funk_rec_prepare_t * out_prepare,
                               int *                   opt_err );
 
+/* fd_acc_mgr_prefetch warms the cache for a later load of the cnt
+   accounts at pubkeys (e.g. by fd_funk_get_acc_meta_readonly).  The
+   funk index lookups of all the accounts are pipelined (see
+   fd_funk_rec_prefetch_chain) so their cache misses overlap instead of
+   being taken one account at a time, and the account metadata and the
+   first FD_ACC_MGR_PREFETCH_DATA_SZ bytes of data are prefetched.  It
+   is only a hint and does not wait for the account data, so callers
+   should issue it as early as the account keys are known. */
+
+#define FD_ACC_MGR_PREFETCH_DATA_SZ (128UL)
+
+void
+fd_acc_mgr_prefetch( fd_funk_t const *   funk,
+                     fd_pubkey_t const * pubkeys,
+                     ulong               cnt );
+
 /* fd_acc_mgr_strerror converts an fd_acc_mgr error code into a human
    readable cstr.  The lifetime of the returned pointer is infinite and
    the call itself is thread safe.  The returned pointer is always to a
@@ -1341,6 +1341,10 @@ fd_executor_setup_accounts_for_txn( fd_exec_txn_ctx_t * txn_ctx ) {
   ushort j = 0UL;
   fd_memset( txn_ctx->accounts, 0, sizeof(fd_txn_account_t) * txn_ctx->accounts_cnt );
 
+  /* Overlap the funk lookups of all the accounts instead of missing
+     the cache once per account in the loop below. */
+  fd_acc_mgr_prefetch( txn_ctx->funk, txn_ctx->account_keys, txn_ctx->accounts_cnt );
+
   for( ushort i=0; i<txn_ctx->accounts_cnt; i++ ) {
 
     fd_txn_account_t * txn_account = fd_executor_setup_txn_account( txn_ctx, i );
@@ -1450,6 +1450,7 @@ fd_runtime_prepare_and_execute_txn( fd_exec_slot_ctx_t const *   slot_ctx,
   }
 
   task_info->txn_ctx->capture_ctx = capture_ctx;
+  task_info->txn_ctx->jit_cache   = task_info->jit_cache;
 
   if( FD_UNLIKELY( fd_executor_txn_verify( txn_ctx )!=0 ) ) {
     FD_LOG_WARNING(( "sigverify failed: %s", FD_BASE58_ENC_64_ALLOCA( (uchar *)txn_ctx->_txn_raw->raw+txn_ctx->txn_descriptor->signature_off ) ));
@@ -1579,8 +1580,9 @@ fd_runtime_process_txns_in_microblock_stream( fd_exec_slot_ctx_t * slot_ctx,
         continue;
       }
 
-      task_infos[ curr_exec_idx ].spad    = exec_spads[ worker_idx ];
-      task_infos[ curr_exec_idx ].txn     = &txns[ curr_exec_idx ];
+      task_infos[ curr_exec_idx ].spad      = exec_spads[ worker_idx ];
+      task_infos[ curr_exec_idx ].jit_cache = slot_ctx->jit_caches ? slot_ctx->jit_caches[ worker_idx ] : NULL;
+      task_infos[ curr_exec_idx ].txn       = &txns[ curr_exec_idx ];
       task_infos[ curr_exec_idx ].txn_ctx = fd_spad_alloc( task_infos[ curr_exec_idx ].spad,
                                                            FD_EXEC_TXN_CTX_ALIGN,
                                                            FD_EXEC_TXN_CTX_FOOTPRINT );
@@ -1596,6 +1598,16 @@ fd_runtime_process_txns_in_microblock_stream( fd_exec_slot_ctx_t * slot_ctx,
       curr_exec_idx++;
     }
 
+    /* While the workers are busy, start pulling the accounts of the
+       transactions dispatched next into the shared cache. */
+    ulong prefetch_end = fd_ulong_min( curr_exec_idx+exec_spad_cnt-1UL, txn_cnt );
+    for( ulong i=curr_exec_idx; i<prefetch_end; i++ ) {
+      fd_txn_t const * txn_descriptor = TXN( &txns[ i ] );
+      fd_acc_mgr_prefetch( slot_ctx->funk,
+                           fd_type_pun_const( fd_txn_get_acct_addrs( txn_descriptor, txns[ i ].payload ) ),
+                           txn_descriptor->acct_addr_cnt );
+    }
+
     /* Wait for the workers to finish before we try to dispatch them a new task */
     for( ulong worker_idx=1UL; worker_idx<exec_spad_cnt; worker_idx++ ) {
       fd_tpool_wait( tpool, worker_idx );
@@ -1636,6 +1648,384 @@ fd_runtime_process_txns_in_microblock_stream( fd_exec_slot_ctx_t * slot_ctx,
 
 }
 
+/* Speculative execution *****************************************************/
+
+/* fd_runtime_spec_acct_t tracks how the accounts touched by the current
+   wave of speculatively executed transactions have been used by the
+   transactions already validated in that wave. */
+
+#define FD_RUNTIME_SPEC_COMMIT_WRITE (1) /* modified by a committed txn */
+#define FD_RUNTIME_SPEC_ABORT_READ   (2) /* referenced by an aborted txn */
+#define FD_RUNTIME_SPEC_ABORT_WRITE  (4) /* writable in an aborted txn */
+
+/* Max number of addresses a transaction references: resolved accounts
+   plus the address lookup tables they were resolved from. */
+#define FD_RUNTIME_SPEC_ACCT_MAX (FD_TXN_ACCT_ADDR_MAX+FD_TXN_ADDR_TABLE_LOOKUP_MAX)
+
+struct fd_runtime_spec_acct {
+  fd_acct_addr_t key;
+  uchar          flags;
+};
+typedef struct fd_runtime_spec_acct fd_runtime_spec_acct_t;
+
+#define MAP_NAME              fd_runtime_spec_map
+#define MAP_KEY_T             fd_acct_addr_t
+#define MAP_T                 fd_runtime_spec_acct_t
+#define MAP_HASH_T            ulong
+#define MAP_KEY_NULL          (fd_acct_addr_null)
+#define MAP_KEY_EQUAL(k0,k1)  (0==memcmp((k0).b,(k1).b,32))
+#define MAP_KEY_HASH(key)     fd_hash( FD_TXN_CONFLICT_MAP_SEED, key.b, 32 )
+#define MAP_KEY_INVAL(k)      (0==memcmp(&fd_acct_addr_null, (k).b, 32))
+#define MAP_KEY_EQUAL_IS_SLOW 0
+#define MAP_MEMOIZE           0
+
+#include "../../util/tmpl/fd_map_dynamic.c"
+
+/* fd_runtime_spec_txn_t is the per wave slot state of a speculatively
+   executed transaction.  accts[0,resolved_cnt) are the transaction's
+   accounts in txn order and accts[resolved_cnt,acct_cnt) the address
+   lookup tables.  If the lookup tables could not be resolved,
+   resolved_cnt only covers the static account keys. */
+
+struct fd_runtime_spec_txn {
+  ulong          txn_idx;
+  ulong          acct_cnt;
+  ulong          resolved_cnt;
+  fd_acct_addr_t accts[ FD_RUNTIME_SPEC_ACCT_MAX ];
+};
+typedef struct fd_runtime_spec_txn fd_runtime_spec_txn_t;
+
+static uchar *
+fd_runtime_spec_flags( fd_runtime_spec_acct_t * map,
+                       uchar *                  sentinel_flags,
+                       fd_acct_addr_t           key,
+                       int                      create ) {
+  if( FD_UNLIKELY( fd_runtime_spec_map_key_inval( key ) ) ) return sentinel_flags;
+  fd_runtime_spec_acct_t * ele = fd_runtime_spec_map_query( map, key, NULL );
+  if( !ele ) {
+    if( !create ) return NULL;
+    ele        = fd_runtime_spec_map_insert( map, key );
+    ele->flags = 0;
+  }
+  return &ele->flags;
+}
+
+/* fd_runtime_spec_txn_load gathers the addresses referenced by txn as
+   of the current funk state.  Returns 1 if the transaction may deploy
+   or upgrade programs (it references a loader that does so) and must
+   be executed without any concurrent transaction, 0 otherwise. */
+
+static int
+fd_runtime_spec_txn_load( fd_runtime_spec_txn_t * spec,
+                          fd_txn_p_t const *      txn,
+                          fd_funk_t *             funk,
+                          fd_funk_txn_t *         funk_txn,
+                          ulong                   slot,
+                          fd_slot_hash_t *        slot_hashes ) {
+  fd_txn_t const * txn_descriptor = TXN(txn);
+
+  ulong imm_cnt = fd_txn_account_cnt( txn_descriptor, FD_TXN_ACCT_CAT_IMM );
+  fd_memcpy( spec->accts, fd_txn_get_acct_addrs( txn_descriptor, txn->payload ), imm_cnt*sizeof(fd_acct_addr_t) );
+  spec->resolved_cnt = imm_cnt;
+
+  if( txn_descriptor->transaction_version==FD_TXN_V0 ) {
+    int err = fd_runtime_load_txn_address_lookup_tables( txn_descriptor,
+                                                         txn->payload,
+                                                         funk,
+                                                         funk_txn,
+                                                         slot,
+                                                         slot_hashes,
+                                                         spec->accts+imm_cnt );
+    if( FD_LIKELY( err==FD_RUNTIME_EXECUTE_SUCCESS ) ) spec->resolved_cnt += txn_descriptor->addr_table_adtl_cnt;
+  }
+
+  spec->acct_cnt = spec->resolved_cnt;
+  fd_txn_acct_addr_lut_t const * luts = fd_txn_get_address_tables_const( txn_descriptor );
+  for( ulong i=0UL; i<txn_descriptor->addr_table_lookup_cnt; i++ ) {
+    fd_memcpy( spec->accts+spec->acct_cnt, txn->payload+luts[ i ].addr_off, sizeof(fd_acct_addr_t) );
+    spec->acct_cnt++;
+  }
+
+  for( ulong i=0UL; i<spec->resolved_cnt; i++ ) {
+    if( FD_UNLIKELY( !memcmp( spec->accts[ i ].b, fd_solana_bpf_loader_upgradeable_program_id.key, sizeof(fd_pubkey_t) ) ||
+                     !memcmp( spec->accts[ i ].b, fd_solana_bpf_loader_v4_program_id.key,          sizeof(fd_pubkey_t) ) ) ) {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/* fd_runtime_spec_acct_modified returns 1 if saving acct into funk
+   would change what a later transaction observes when loading it, 0
+   otherwise.  The last modified slot is not observable by transactions
+   and is the same for all transactions of the block, so it is not
+   compared.  Accounts without lamports are indistinguishable from
+   accounts that do not exist. */
+
+static int
+fd_runtime_spec_acct_modified( fd_txn_account_t const * acct,
+                               fd_funk_t *              funk,
+                               fd_funk_txn_t *          funk_txn,
+                               fd_wksp_t *              acc_data_wksp ) {
+  fd_account_meta_t const * meta = fd_wksp_laddr( acc_data_wksp, acct->private_state.meta_gaddr );
+  if( FD_UNLIKELY( !meta ) ) return 0; /* not writable, will not be saved */
+  uchar const * data = fd_wksp_laddr( acc_data_wksp, acct->private_state.data_gaddr );
+
+  FD_TXN_ACCOUNT_DECL( prev );
+  if( fd_txn_account_init_from_funk_readonly( prev, acct->pubkey, funk, funk_txn )!=FD_ACC_MGR_SUCCESS ) {
+    return meta->info.lamports!=0UL;
+  }
+
+  fd_account_meta_t const * prev_meta = prev->vt->get_meta( prev );
+  if( (!meta->info.lamports) & (!prev_meta->info.lamports) ) return 0;
+  if( meta->dlen!=prev_meta->dlen ) return 1;
+  if( memcmp( &meta->info, &prev_meta->info, sizeof(fd_solana_account_meta_t) ) ) return 1;
+  return meta->dlen && memcmp( data, prev->vt->get_data( prev ), meta->dlen );
+}
+
+static void
+fd_runtime_prepare_execute_txn_task( void * tpool,
+                                     ulong  t0,
+                                     ulong  t1,
+                                     void * args,
+                                     void * reduce,
+                                     ulong  stride FD_PARAM_UNUSED,
+                                     ulong  l0     FD_PARAM_UNUSED,
+                                     ulong  l1     FD_PARAM_UNUSED,
+                                     ulong  m0     FD_PARAM_UNUSED,
+                                     ulong  m1     FD_PARAM_UNUSED,
+                                     ulong  n0     FD_PARAM_UNUSED,
+                                     ulong  n1     FD_PARAM_UNUSED ) {
+
+  fd_exec_slot_ctx_t *         slot_ctx     = (fd_exec_slot_ctx_t *)tpool;
+  fd_capture_ctx_t *           capture_ctx  = (fd_capture_ctx_t *)t0;
+  fd_txn_p_t *                 txn          = (fd_txn_p_t *)t1;
+  fd_execute_txn_task_info_t * task_info    = (fd_execute_txn_task_info_t *)args;
+  fd_spad_t *                  exec_spad    = (fd_spad_t *)reduce;
+
+  fd_runtime_prepare_and_execute_txn( slot_ctx,
+                                      txn,
+                                      task_info,
+                                      exec_spad,
+                                      capture_ctx );
+}
+
+int
+fd_runtime_process_txns_speculative( fd_exec_slot_ctx_t *        slot_ctx,
+                                     fd_txn_p_t *                txns,
+                                     ulong                       txn_cnt,
+                                     fd_tpool_t *                tpool,
+                                     fd_spad_t * *               exec_spads,
+                                     ulong                       exec_spad_cnt,
+                                     fd_spad_t *                 runtime_spad,
+                                     fd_cost_tracker_t *         cost_tracker_opt,
+                                     fd_runtime_spec_metrics_t * metrics ) {
+
+  if( FD_UNLIKELY( exec_spad_cnt<2UL ) ) {
+    FD_LOG_WARNING(( "speculative execution requires at least one exec worker" ));
+    return -1;
+  }
+
+  int   res      = 0;
+  ulong wave_max = exec_spad_cnt-1UL;
+  ulong slot     = fd_bank_slot_get( slot_ctx->bank );
+
+  for( ulong i=0UL; i<txn_cnt; i++ ) {
+    txns[i].flags = FD_TXN_P_FLAGS_SANITIZE_SUCCESS;
+  }
+
+  fd_execute_txn_task_info_t * task_infos = fd_spad_alloc( runtime_spad,
+                                                           alignof(fd_execute_txn_task_info_t),
+                                                           txn_cnt * sizeof(fd_execute_txn_task_info_t) );
+  fd_runtime_spec_txn_t *      wave       = fd_spad_alloc( runtime_spad, alignof(fd_runtime_spec_txn_t), wave_max*sizeof(fd_runtime_spec_txn_t) );
+  ulong *                      retry      = fd_spad_alloc( runtime_spad, alignof(ulong), 2UL*wave_max*sizeof(ulong) );
+  ulong *                      retry_nxt  = retry + wave_max;
+
+  int    lg_slot_cnt = fd_ulong_find_msb( fd_ulong_pow2_up( 2UL*wave_max*FD_RUNTIME_SPEC_ACCT_MAX ) );
+  void * map_mem     = fd_spad_alloc( runtime_spad, fd_runtime_spec_map_align(), fd_runtime_spec_map_footprint( lg_slot_cnt ) );
+  fd_runtime_spec_acct_t * map = fd_runtime_spec_map_join( fd_runtime_spec_map_new( map_mem, lg_slot_cnt ) );
+
+  fd_slot_hash_t * slot_hashes = NULL;
+  fd_slot_hashes_global_t const * slot_hashes_global = fd_sysvar_slot_hashes_read( slot_ctx->funk, slot_ctx->funk_txn, runtime_spad );
+  if( FD_LIKELY( slot_hashes_global ) ) {
+    slot_hashes = deq_fd_slot_hash_t_join( (uchar *)slot_hashes_global + slot_hashes_global->hashes_offset );
+  }
+
+  /* Every wave is made of the (up to wave_max) lowest indexed
+     transactions not committed yet, such that transactions that were
+     aborted in the previous wave come first.  A wave is cut short at a
+     barrier transaction, which is always executed on its own. */
+
+  ulong next_idx  = 0UL;
+  ulong retry_cnt = 0UL;
+  while( retry_cnt || next_idx<txn_cnt ) {
+
+    ulong wave_cnt = 0UL;
+    ulong carry    = 0UL;
+    int   stop     = 0;
+    for( ulong r=0UL; r<retry_cnt; r++ ) {
+      if( !stop ) {
+        fd_runtime_spec_txn_t * spec = &wave[ wave_cnt ];
+        int barrier = fd_runtime_spec_txn_load( spec, &txns[ retry[ r ] ], slot_ctx->funk, slot_ctx->funk_txn, slot, slot_hashes );
+        stop = barrier;
+        if( !( barrier && wave_cnt ) ) {
+          spec->txn_idx = retry[ r ];
+          wave_cnt++;
+          metrics->barrier_cnt += (ulong)barrier;
+          continue;
+        }
+      }
+      retry[ carry++ ] = retry[ r ];
+    }
+    retry_cnt = carry;
+
+    while( !stop && wave_cnt<wave_max && next_idx<txn_cnt ) {
+      fd_runtime_spec_txn_t * spec = &wave[ wave_cnt ];
+      int barrier = fd_runtime_spec_txn_load( spec, &txns[ next_idx ], slot_ctx->funk, slot_ctx->funk_txn, slot, slot_hashes );
+      if( barrier && wave_cnt ) break;
+
+      /* Reverify programs for this epoch if needed.  Programs can only
+         change by barrier transactions, which are committed before any
+         later transaction is scheduled. */
+      fd_runtime_update_program_cache( slot_ctx, &txns[ next_idx ], runtime_spad );
+
+      spec->txn_idx = next_idx++;
+      wave_cnt++;
+      metrics->barrier_cnt += (ulong)barrier;
+      stop = barrier;
+    }
+
+    /* Execute the wave */
+
+    for( ulong worker_idx=1UL; worker_idx<exec_spad_cnt; worker_idx++ ) {
+      fd_spad_push( exec_spads[ worker_idx ] );
+    }
+
+    for( ulong s=0UL; s<wave_cnt; s++ ) {
+      ulong                        worker_idx = s+1UL;
+      ulong                        txn_idx    = wave[ s ].txn_idx;
+      fd_execute_txn_task_info_t * task_info  = &task_infos[ txn_idx ];
+
+      txns[ txn_idx ].flags = FD_TXN_P_FLAGS_SANITIZE_SUCCESS;
+      task_info->spad       = exec_spads[ worker_idx ];
+      task_info->jit_cache  = slot_ctx->jit_caches ? slot_ctx->jit_caches[ worker_idx ] : NULL;
+      task_info->txn        = &txns[ txn_idx ];
+      task_info->txn_ctx    = fd_spad_alloc( task_info->spad, FD_EXEC_TXN_CTX_ALIGN, FD_EXEC_TXN_CTX_FOOTPRINT );
+      if( FD_UNLIKELY( !task_info->txn_ctx ) ) {
+        FD_LOG_ERR(( "failed to allocate txn ctx" ));
+      }
+
+      fd_tpool_exec( tpool, worker_idx, fd_runtime_prepare_execute_txn_task,
+                     slot_ctx, 0UL, (ulong)task_info->txn,
+                     task_info, exec_spads[ worker_idx ], 0UL,
+                     0UL, 0UL, 0UL, 0UL, 0UL, 0UL );
+    }
+
+    for( ulong s=0UL; s<wave_cnt; s++ ) {
+      fd_tpool_wait( tpool, s+1UL );
+    }
+
+    metrics->wave_cnt++;
+    metrics->exec_cnt += wave_cnt;
+
+    /* Validate and commit in block order.  A transaction is aborted if
+       it referenced an account modified by a transaction committed
+       earlier in this wave, if it referenced an account writable in an
+       aborted earlier transaction, or if it modified an account
+       referenced by an aborted earlier transaction.  Otherwise it
+       observed the same state as in serial execution. */
+
+    uchar sentinel_flags = 0;
+    ulong abort_cnt      = 0UL;
+    for( ulong s=0UL; s<wave_cnt; s++ ) {
+      fd_runtime_spec_txn_t *      spec      = &wave[ s ];
+      fd_execute_txn_task_info_t * task_info = &task_infos[ spec->txn_idx ];
+      fd_exec_txn_ctx_t *          txn_ctx   = task_info->txn_ctx;
+      int                          executed  = !!( task_info->txn->flags & FD_TXN_P_FLAGS_EXECUTE_SUCCESS );
+
+      int conflict = 0;
+      for( ulong i=0UL; i<spec->acct_cnt && !conflict; i++ ) {
+        uchar * flags = fd_runtime_spec_flags( map, &sentinel_flags, spec->accts[ i ], 0 );
+        conflict = flags && ( *flags & (FD_RUNTIME_SPEC_COMMIT_WRITE|FD_RUNTIME_SPEC_ABORT_WRITE) );
+      }
+
+      /* Gather the accounts fd_runtime_finalize_txn would modify */
+      fd_txn_account_t * saved[ FD_TXN_ACCT_ADDR_MAX ];
+      ulong              saved_cnt = 0UL;
+      if( executed && !task_info->exec_res ) {
+        for( ushort i=0; i<txn_ctx->accounts_cnt; i++ ) {
+          if( !fd_exec_txn_ctx_account_is_writable_idx( txn_ctx, i ) && i!=FD_FEE_PAYER_TXN_IDX ) continue;
+          saved[ saved_cnt++ ] = &txn_ctx->accounts[ i ];
+        }
+      } else if( executed ) {
+        if( txn_ctx->nonce_account_idx_in_txn!=ULONG_MAX           ) saved[ saved_cnt++ ] = txn_ctx->rollback_nonce_account;
+        if( txn_ctx->nonce_account_idx_in_txn!=FD_FEE_PAYER_TXN_IDX ) saved[ saved_cnt++ ] = txn_ctx->rollback_fee_payer_account;
+      }
+
+      ulong modified_cnt = 0UL;
+      for( ulong i=0UL; i<saved_cnt && !conflict; i++ ) {
+        if( !fd_runtime_spec_acct_modified( saved[ i ], slot_ctx->funk, slot_ctx->funk_txn, txn_ctx->spad_wksp ) ) continue;
+        fd_acct_addr_t const * key   = fd_type_pun_const( saved[ i ]->pubkey );
+        uchar *                flags = fd_runtime_spec_flags( map, &sentinel_flags, *key, 0 );
+        conflict = flags && ( *flags & FD_RUNTIME_SPEC_ABORT_READ );
+        saved[ modified_cnt++ ] = saved[ i ];
+      }
+
+      if( FD_UNLIKELY( conflict ) ) {
+        for( ulong i=0UL; i<spec->acct_cnt; i++ ) {
+          uchar * flags = fd_runtime_spec_flags( map, &sentinel_flags, spec->accts[ i ], 1 );
+          *flags = (uchar)( *flags | FD_RUNTIME_SPEC_ABORT_READ );
+          if( i<spec->resolved_cnt && fd_txn_is_writable( TXN(task_info->txn), (ushort)i ) ) {
+            *flags = (uchar)( *flags | FD_RUNTIME_SPEC_ABORT_WRITE );
+          }
+        }
+        retry_nxt[ abort_cnt++ ] = spec->txn_idx;
+        continue;
+      }
+
+      for( ulong i=0UL; i<modified_cnt; i++ ) {
+        fd_acct_addr_t const * key   = fd_type_pun_const( saved[ i ]->pubkey );
+        uchar *                flags = fd_runtime_spec_flags( map, &sentinel_flags, *key, 1 );
+        *flags = (uchar)( *flags | FD_RUNTIME_SPEC_COMMIT_WRITE );
+      }
+
+      metrics->txn_cnt++;
+      if( FD_UNLIKELY( !executed ) ) continue;
+
+      fd_runtime_finalize_txn( slot_ctx->funk, slot_ctx->funk_txn, task_info, txn_ctx->spad, slot_ctx->bank );
+
+      /* Verify cost tracker limits (only for offline replay).  Limits
+         are on sums over the block, so the commit order does not
+         affect the outcome. */
+      if( cost_tracker_opt!=NULL ) {
+        fd_transaction_cost_t transaction_cost = fd_calculate_cost_for_executed_transaction( txn_ctx, runtime_spad );
+        res = fd_cost_tracker_try_add( cost_tracker_opt, txn_ctx, &transaction_cost );
+        if( FD_UNLIKELY( res ) ) {
+          FD_LOG_WARNING(( "Block cost limits exceeded for slot %lu", slot ));
+          break;
+        }
+      }
+    }
+
+    metrics->abort_cnt += abort_cnt;
+
+    /* Aborted transactions precede any carried over retries */
+    fd_memcpy( retry_nxt+abort_cnt, retry, retry_cnt*sizeof(ulong) );
+    retry_cnt += abort_cnt;
+    ulong * tmp = retry; retry = retry_nxt; retry_nxt = tmp;
+
+    fd_runtime_spec_map_clear( map );
+
+    for( ulong worker_idx=1UL; worker_idx<exec_spad_cnt; worker_idx++ ) {
+      fd_spad_pop( exec_spads[ worker_idx ] );
+    }
+
+    if( FD_UNLIKELY( res ) ) return res;
+  }
+
+  return 0;
+}
+
 /******************************************************************************/
 /* Epoch Boundary                                                             */
 /******************************************************************************/
@@ -3571,6 +3961,32 @@ fd_runtime_block_execute_tpool( fd_exec_slot_ctx_t *            slot_ctx,
   fd_cost_tracker_t * cost_tracker = fd_spad_alloc( runtime_spad, FD_COST_TRACKER_ALIGN, sizeof(fd_cost_tracker_t) );
   fd_cost_tracker_init( cost_tracker, runtime_spad );
 
+  if( slot_ctx->spec_exec && !capture_ctx ) {
+    fd_runtime_spec_metrics_t * metrics  = slot_ctx->spec_exec;
+    ulong                       abort_cnt = metrics->abort_cnt;
+    ulong                       exec_cnt  = metrics->exec_cnt;
+
+    res = fd_runtime_process_txns_speculative( slot_ctx,
+                                               txn_ptrs,
+                                               txn_cnt,
+                                               tpool,
+                                               exec_spads,
+                                               exec_spad_cnt,
+                                               runtime_spad,
+                                               cost_tracker,
+                                               metrics );
+    if( FD_UNLIKELY( res!=FD_RUNTIME_EXECUTE_SUCCESS ) ) {
+      return res;
+    }
+
+    abort_cnt = metrics->abort_cnt - abort_cnt;
+    exec_cnt  = metrics->exec_cnt  - exec_cnt;
+    FD_LOG_INFO(( "speculative execution - slot: %lu, txns: %lu, aborts: %lu (%.2f%%)",
+                  fd_bank_slot_get( slot_ctx->bank ), txn_cnt, abort_cnt,
+                  exec_cnt ? 100.0*(double)abort_cnt/(double)exec_cnt : 0.0 ));
+    goto finalize;
+  }
+
   /* We want to emulate microblock-by-microblock execution */
   ulong to_exec_idx = 0UL;
   for( ulong i=0UL; i<block_info->microblock_batch_cnt; i++ ) {
@@ -3604,6 +4020,7 @@ fd_runtime_block_execute_tpool( fd_exec_slot_ctx_t *            slot_ctx,
     }
   }
 
+finalize:;
   long block_finalize_time = -fd_log_wallclock();
 
   fd_exec_para_cb_ctx_t exec_para_ctx = {
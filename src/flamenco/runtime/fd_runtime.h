@@ -62,11 +62,12 @@ block_finalize_tpool_wrapper( void * para_arg_1,
                               void * arg_4 );
 
 struct fd_execute_txn_task_info {
-  fd_spad_t * *       spads;
-  fd_spad_t *         spad;
-  fd_exec_txn_ctx_t * txn_ctx;
-  fd_txn_p_t *        txn;
-  int                 exec_res;
+  fd_spad_t * *        spads;
+  fd_spad_t *          spad;
+  fd_bpf_jit_cache_t * jit_cache; /* jit cache of the executing thread, NULL if none */
+  fd_exec_txn_ctx_t *  txn_ctx;
+  fd_txn_p_t *         txn;
+  int                  exec_res;
 };
 typedef struct fd_execute_txn_task_info fd_execute_txn_task_info_t;
 
@@ -560,6 +561,50 @@ fd_runtime_process_txns_in_microblock_stream( fd_exec_slot_ctx_t * slot_ctx,
                                               fd_spad_t *          runtime_spad,
                                               fd_cost_tracker_t *  cost_tracker_opt );
 
+/* fd_runtime_spec_metrics_t accumulates statistics about speculative
+   transaction execution. */
+
+struct fd_runtime_spec_metrics {
+  ulong txn_cnt;     /* Transactions committed */
+  ulong exec_cnt;    /* Transaction executions, including aborted ones */
+  ulong abort_cnt;   /* Executions discarded at commit validation */
+  ulong wave_cnt;    /* Rounds of concurrent execution */
+  ulong barrier_cnt; /* Transactions executed without concurrency */
+};
+typedef struct fd_runtime_spec_metrics fd_runtime_spec_metrics_t;
+
+/* fd_runtime_process_txns_speculative prepares, executes and finalizes
+   txns[0,txn_cnt), which need not be conflict-free (e.g. all the
+   transactions of a block across microblocks).  Transactions are
+   executed optimistically in waves of up to exec_spad_cnt-1 concurrent
+   transactions against the state left by the previous waves.  The
+   results are then validated and committed in block order: an
+   execution is discarded and retried in the next wave if it may have
+   observed a state different from serial execution, i.e. it referenced
+   an account actually modified by a transaction committed before it in
+   the wave, or it interacts with a transaction aborted before it.
+   Transactions referencing a program deploying loader are executed
+   alone.  The committed state is the same as with serial execution.
+   Statistics are accumulated into metrics.  Instruction capture is not
+   supported.
+
+   Only offline replay (fd_ledger --spec-exec, through
+   fd_runtime_block_execute_tpool) executes blocks this way.  Live
+   replay dispatches transactions to the exec tiles as the exec dag
+   releases them and never calls this.  test_spec_exec checks the
+   committed state against serial execution. */
+
+int
+fd_runtime_process_txns_speculative( fd_exec_slot_ctx_t *        slot_ctx,
+                                     fd_txn_p_t *                txns,
+                                     ulong                       txn_cnt,
+                                     fd_tpool_t *                tpool,
+                                     fd_spad_t * *               exec_spads,
+                                     ulong                       exec_spad_cnt,
+                                     fd_spad_t *                 runtime_spad,
+                                     fd_cost_tracker_t *         cost_tracker_opt,
+                                     fd_runtime_spec_metrics_t * metrics );
+
 void
 fd_runtime_finalize_txn( fd_funk_t *                  funk,
                          fd_funk_txn_t *              funk_txn,
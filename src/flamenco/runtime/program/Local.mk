@@ -11,6 +11,12 @@ $(call add-objs,fd_bpf_loader_serialization,fd_flamenco)
 $(call add-hdrs,fd_bpf_program_util.h)
 $(call add-objs,fd_bpf_program_util,fd_flamenco)
 
+$(call add-hdrs,fd_bpf_program_cache.h)
+$(call add-objs,fd_bpf_program_cache,fd_flamenco)
+
+$(call add-hdrs,fd_bpf_jit_cache.h)
+$(call add-objs,fd_bpf_jit_cache,fd_flamenco)
+
 ### Precompiles
 
 $(call add-hdrs,fd_precompiles.h)
@@ -50,6 +56,8 @@ $(call add-objs,fd_native_cpi,fd_flamenco)
 
 ### Tests
 ifdef FD_HAS_HOSTED
+$(call make-unit-test,test_bpf_program_cache,test_bpf_program_cache,fd_flamenco fd_ballet fd_util)
+$(call run-unit-test,test_bpf_program_cache)
 ifdef FD_HAS_SECP256K1
 $(call make-unit-test,test_program_cache,test_program_cache,fd_flamenco fd_ballet fd_util fd_funk)
 $(call run-unit-test,test_program_cache)
@@ -0,0 +1,334 @@
+#include "fd_bpf_jit_cache.h"
+#include "../../vm/fd_vm_jit.h"
+
+/* An entry's state is one of: */
+
+#define FD_BPF_JIT_CACHE_ENTRY_FREE     (0) /* holds no program */
+#define FD_BPF_JIT_CACHE_ENTRY_COMPILED (1) /* holds a program runnable under the jit */
+#define FD_BPF_JIT_CACHE_ENTRY_FAILED   (2) /* remembers a program that does not compile */
+
+/* The identity of the program an entry holds is everything the
+   generated code depends on (see fd_vm_jit_is_compiled) plus the
+   validated program hash, such that the content at text and calldests
+   is known to be the one the program was compiled from. */
+
+struct fd_bpf_jit_cache_entry {
+  int           state;
+  int           direct_mapping;
+  ulong         ref;       /* number of runs of this program in progress */
+  ulong         last_use;  /* cache clock of last run */
+  ulong         prog_hash;
+  ulong const * text;
+  ulong         text_cnt;
+  ulong         entry_pc;
+  ulong const * calldests;
+  ulong         sbpf_version;
+  fd_vm_jit_t * jit;
+};
+
+typedef struct fd_bpf_jit_cache_entry fd_bpf_jit_cache_entry_t;
+
+struct __attribute__((aligned(FD_BPF_JIT_CACHE_ALIGN))) fd_bpf_jit_cache_private {
+  ulong magic;         /* ==FD_BPF_JIT_CACHE_MAGIC */
+  ulong entry_max;
+  ulong text_max;
+  ulong clock;
+  int   syscalls_valid; /* 1 if the syscalls table has been filled in */
+
+  fd_bpf_jit_cache_metrics_t metrics;
+
+  /* entry_max fd_bpf_jit_cache_entry_t follow, then the syscalls
+     table, then entry_max jits */
+};
+
+FD_FN_CONST static inline ulong
+fd_bpf_jit_cache_entries_off( void ) {
+  return fd_ulong_align_up( sizeof(fd_bpf_jit_cache_t), alignof(fd_bpf_jit_cache_entry_t) );
+}
+
+FD_FN_CONST static inline ulong
+fd_bpf_jit_cache_syscalls_off( ulong entry_max ) {
+  return fd_ulong_align_up( fd_bpf_jit_cache_entries_off() + entry_max*sizeof(fd_bpf_jit_cache_entry_t), FD_SBPF_SYSCALLS_ALIGN );
+}
+
+FD_FN_CONST static inline ulong
+fd_bpf_jit_cache_jit_off( ulong entry_max ) {
+  return fd_ulong_align_up( fd_bpf_jit_cache_syscalls_off( entry_max ) + FD_SBPF_SYSCALLS_FOOTPRINT, FD_VM_JIT_ALIGN );
+}
+
+static inline fd_bpf_jit_cache_entry_t *
+fd_bpf_jit_cache_entries( fd_bpf_jit_cache_t const * cache ) {
+  return (fd_bpf_jit_cache_entry_t *)( (ulong)cache + fd_bpf_jit_cache_entries_off() );
+}
+
+static inline fd_sbpf_syscalls_t *
+fd_bpf_jit_cache_syscalls_tbl( fd_bpf_jit_cache_t const * cache ) {
+  return (fd_sbpf_syscalls_t *)( (ulong)cache + fd_bpf_jit_cache_syscalls_off( cache->entry_max ) );
+}
+
+FD_FN_CONST ulong
+fd_bpf_jit_cache_align( void ) {
+  return FD_BPF_JIT_CACHE_ALIGN;
+}
+
+FD_FN_CONST ulong
+fd_bpf_jit_cache_footprint( ulong entry_max,
+                            ulong text_max ) {
+  if( FD_UNLIKELY( (!entry_max) | (entry_max>(1UL<<16)) ) ) return 0UL;
+  if( FD_UNLIKELY( (!text_max) | (text_max>FD_VM_JIT_TEXT_MAX) ) ) return 0UL;
+  return fd_ulong_align_up( fd_bpf_jit_cache_jit_off( entry_max ) + entry_max*FD_VM_JIT_FOOTPRINT( text_max ), FD_BPF_JIT_CACHE_ALIGN );
+}
+
+void *
+fd_bpf_jit_cache_new( void * shmem,
+                      ulong  entry_max,
+                      ulong  text_max ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_bpf_jit_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_bpf_jit_cache_footprint( entry_max, text_max ) ) ) {
+    FD_LOG_WARNING(( "bad entry_max or text_max" ));
+    return NULL;
+  }
+
+# if FD_HAS_X86
+  fd_bpf_jit_cache_t * cache = (fd_bpf_jit_cache_t *)shmem;
+  fd_memset( cache, 0, sizeof(fd_bpf_jit_cache_t) );
+  cache->entry_max = entry_max;
+  cache->text_max  = text_max;
+
+  fd_sbpf_syscalls_new( fd_bpf_jit_cache_syscalls_tbl( cache ) );
+
+  fd_bpf_jit_cache_entry_t * entry = fd_bpf_jit_cache_entries( cache );
+  ulong                      jit0  = (ulong)shmem + fd_bpf_jit_cache_jit_off( entry_max );
+  ulong                      jit_sz = FD_VM_JIT_FOOTPRINT( text_max );
+  for( ulong i=0UL; i<entry_max; i++ ) {
+    fd_memset( entry+i, 0, sizeof(fd_bpf_jit_cache_entry_t) );
+    entry[ i ].jit = fd_vm_jit_join( fd_vm_jit_new( (void *)( jit0 + i*jit_sz ), text_max ) );
+    if( FD_UNLIKELY( !entry[ i ].jit ) ) {
+      for( ulong j=0UL; j<i; j++ ) fd_vm_jit_delete( fd_vm_jit_leave( entry[ j ].jit ) );
+      FD_LOG_WARNING(( "fd_vm_jit_new failed" ));
+      return NULL;
+    }
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = FD_BPF_JIT_CACHE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+# else
+  FD_LOG_WARNING(( "the jit is not supported on this target" ));
+  return NULL;
+# endif
+}
+
+fd_bpf_jit_cache_t *
+fd_bpf_jit_cache_join( void * shcache ) {
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_bpf_jit_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  fd_bpf_jit_cache_t * cache = (fd_bpf_jit_cache_t *)shcache;
+
+  if( FD_UNLIKELY( cache->magic!=FD_BPF_JIT_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return cache;
+}
+
+void *
+fd_bpf_jit_cache_leave( fd_bpf_jit_cache_t * cache ) {
+
+  if( FD_UNLIKELY( !cache ) ) {
+    FD_LOG_WARNING(( "NULL cache" ));
+    return NULL;
+  }
+
+  return (void *)cache;
+}
+
+void *
+fd_bpf_jit_cache_delete( void * shcache ) {
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_bpf_jit_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  fd_bpf_jit_cache_t * cache = (fd_bpf_jit_cache_t *)shcache;
+
+  if( FD_UNLIKELY( cache->magic!=FD_BPF_JIT_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+# if FD_HAS_X86
+  fd_bpf_jit_cache_entry_t * entry = fd_bpf_jit_cache_entries( cache );
+  for( ulong i=0UL; i<cache->entry_max; i++ ) fd_vm_jit_delete( fd_vm_jit_leave( entry[ i ].jit ) );
+# endif
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shcache;
+}
+
+/* fd_bpf_jit_cache_syscalls_eq returns 1 if the syscalls tables a and b
+   register the same syscalls in the same slots.  Only the keys of empty
+   slots are initialized, so this can not just be a memcmp. */
+
+static int
+fd_bpf_jit_cache_syscalls_eq( fd_sbpf_syscalls_t const * a,
+                              fd_sbpf_syscalls_t const * b ) {
+  for( ulong i=0UL; i<FD_SBPF_SYSCALLS_SLOT_CNT; i++ ) {
+    if( a[ i ].key!=b[ i ].key ) return 0;
+    if( fd_sbpf_syscalls_key_inval( a[ i ].key ) ) continue;
+    if( (a[ i ].func!=b[ i ].func) | (a[ i ].name!=b[ i ].name) ) return 0;
+  }
+  return 1;
+}
+
+fd_sbpf_syscalls_t *
+fd_bpf_jit_cache_syscalls( fd_bpf_jit_cache_t * cache,
+                           fd_sbpf_syscalls_t * syscalls ) {
+  fd_sbpf_syscalls_t * tbl = fd_bpf_jit_cache_syscalls_tbl( cache );
+  if( FD_LIKELY( cache->syscalls_valid && fd_bpf_jit_cache_syscalls_eq( tbl, syscalls ) ) ) return tbl;
+
+  /* The running programs were compiled against the current table */
+
+  fd_bpf_jit_cache_entry_t * entry = fd_bpf_jit_cache_entries( cache );
+  for( ulong i=0UL; i<cache->entry_max; i++ ) {
+    if( FD_UNLIKELY( entry[ i ].ref ) ) return syscalls;
+  }
+
+  for( ulong i=0UL; i<cache->entry_max; i++ ) entry[ i ].state = FD_BPF_JIT_CACHE_ENTRY_FREE;
+  cache->metrics.flush_cnt += (ulong)cache->syscalls_valid;
+
+  fd_memcpy( tbl, syscalls, FD_SBPF_SYSCALLS_FOOTPRINT );
+  cache->syscalls_valid = 1;
+  return tbl;
+}
+
+static inline int
+fd_bpf_jit_cache_entry_match( fd_bpf_jit_cache_entry_t const * entry,
+                              ulong                            prog_hash,
+                              fd_vm_t const *                  vm ) {
+  return (entry->prog_hash   ==prog_hash        ) & (entry->text        ==vm->text        ) &
+         (entry->text_cnt    ==vm->text_cnt     ) & (entry->entry_pc    ==vm->entry_pc    ) &
+         (entry->calldests   ==vm->calldests    ) & (entry->sbpf_version==vm->sbpf_version) &
+         (entry->direct_mapping==!!vm->direct_mapping);
+}
+
+/* fd_bpf_jit_cache_acquire returns the entry holding the compiled code
+   for the program vm is set up for (compiling it into the least
+   recently used idle entry if needed) with a reference held, or NULL if
+   the program can not be run under the jit. */
+
+static fd_bpf_jit_cache_entry_t *
+fd_bpf_jit_cache_acquire( fd_bpf_jit_cache_t * cache,
+                          ulong                prog_hash,
+                          fd_vm_t const *      vm ) {
+  if( FD_UNLIKELY( vm->trace || !cache->syscalls_valid ||
+                   vm->syscalls!=fd_bpf_jit_cache_syscalls_tbl( cache ) ) ) return NULL;
+
+  ulong now = ++cache->clock;
+
+  fd_bpf_jit_cache_entry_t * entry  = fd_bpf_jit_cache_entries( cache );
+  fd_bpf_jit_cache_entry_t * victim = NULL;
+  for( ulong i=0UL; i<cache->entry_max; i++ ) {
+    fd_bpf_jit_cache_entry_t * e = entry + i;
+    if( e->state==FD_BPF_JIT_CACHE_ENTRY_FREE ) {
+      if( !victim || victim->state!=FD_BPF_JIT_CACHE_ENTRY_FREE ) victim = e;
+      continue;
+    }
+    if( fd_bpf_jit_cache_entry_match( e, prog_hash, vm ) ) {
+      e->last_use = now;
+      if( FD_UNLIKELY( e->state==FD_BPF_JIT_CACHE_ENTRY_FAILED ) ) return NULL;
+      e->ref++;
+      return e;
+    }
+    if( e->ref ) continue;
+    if( !victim || ( victim->state!=FD_BPF_JIT_CACHE_ENTRY_FREE && e->last_use<victim->last_use ) ) victim = e;
+  }
+
+  /* Not in the cache.  Every entry is running if there is no victim
+     (only possible with fewer entries than the CPI depth). */
+
+  if( FD_UNLIKELY( !victim ) ) return NULL;
+  cache->metrics.evict_cnt += (ulong)( victim->state!=FD_BPF_JIT_CACHE_ENTRY_FREE );
+
+# if FD_HAS_X86
+  int err = fd_vm_jit_compile( victim->jit, vm );
+# else
+  int err = FD_VM_ERR_INVAL;
+# endif
+
+  victim->state          = err ? FD_BPF_JIT_CACHE_ENTRY_FAILED : FD_BPF_JIT_CACHE_ENTRY_COMPILED;
+  victim->last_use       = now;
+  victim->prog_hash      = prog_hash;
+  victim->text           = vm->text;
+  victim->text_cnt       = vm->text_cnt;
+  victim->entry_pc       = vm->entry_pc;
+  victim->calldests      = vm->calldests;
+  victim->sbpf_version   = vm->sbpf_version;
+  victim->direct_mapping = !!vm->direct_mapping;
+
+  if( FD_UNLIKELY( err ) ) {
+    FD_LOG_DEBUG(( "fd_vm_jit_compile failed (%i-%s), running on the interpreter", err, fd_vm_strerror( err ) ));
+    cache->metrics.compile_fail_cnt++;
+    return NULL;
+  }
+
+  cache->metrics.compile_cnt++;
+  victim->ref++;
+  return victim;
+}
+
+int
+fd_bpf_jit_cache_exec( fd_bpf_jit_cache_t * cache,
+                       ulong                prog_hash,
+                       fd_vm_t *            vm ) {
+  fd_bpf_jit_cache_entry_t * entry = fd_bpf_jit_cache_acquire( cache, prog_hash, vm );
+  if( FD_UNLIKELY( !entry ) ) {
+    cache->metrics.interp_cnt++;
+    return FD_VM_ERR_EBPF_JIT_NOT_COMPILED;
+  }
+
+  cache->metrics.hit_cnt++;
+# if FD_HAS_X86
+  int err = fd_vm_jit_exec( entry->jit, vm );
+# else
+  int err = FD_VM_ERR_EBPF_JIT_NOT_COMPILED;
+# endif
+  entry->ref--;
+  return err;
+}
+
+FD_FN_CONST fd_bpf_jit_cache_metrics_t const *
+fd_bpf_jit_cache_metrics( fd_bpf_jit_cache_t const * cache ) {
+  return &cache->metrics;
+}
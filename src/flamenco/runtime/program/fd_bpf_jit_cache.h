@@ -0,0 +1,143 @@
+#ifndef HEADER_fd_src_flamenco_runtime_program_fd_bpf_jit_cache_h
+#define HEADER_fd_src_flamenco_runtime_program_fd_bpf_jit_cache_h
+
+/* fd_bpf_jit_cache holds native code for the sBPF programs an
+   execution thread runs most, such that fd_bpf_execute can run them
+   with fd_vm_jit instead of the interpreter.
+
+   The cache has entry_max fd_vm_jit_t, each able to hold a program of
+   up to text_max words.  A program is compiled the first time it is run
+   and then reused for as long as it is not evicted.  Programs are
+   identified by the address of their validated program (text,
+   calldests, ...) together with fd_sbpf_validated_program_t hash, such
+   that a program that is revalidated in place or replaced by another
+   program at the same address is never run with stale code.  Programs
+   that can not be compiled (e.g. they are larger than text_max) are
+   remembered as such and always run on the interpreter.  When the
+   cache is full, the least recently used program not currently running
+   (e.g. below a CPI) is evicted.
+
+   Compiled code resolves syscalls at compile time, so the vm must be
+   set up with a syscalls table that outlives it.  The cache keeps one
+   such table (see fd_bpf_jit_cache_syscalls) and flushes all programs
+   whenever the set of registered syscalls changes (e.g. a feature
+   activation).
+
+   Like fd_vm_jit, a cache holds pointers into the local address space
+   and thus is not shareable between processes.  It is not safe for
+   concurrent use, each execution thread needs its own.  Creating a cache
+   maps the code pages of its jits and running a program that is not
+   compiled yet requires mprotect, so a sandboxed caller should create
+   the cache before entering the sandbox and allow mprotect of
+   (PROT_READ|PROT_WRITE) and (PROT_READ|PROT_EXEC).  The jit is only
+   available on x86 targets, fd_bpf_jit_cache_new fails elsewhere. */
+
+#include "../../vm/fd_vm.h"
+
+/* FD_BPF_JIT_CACHE_ALIGN is the alignment of a jit cache. */
+
+#define FD_BPF_JIT_CACHE_ALIGN (128UL)
+
+#define FD_BPF_JIT_CACHE_MAGIC (0xf17eda2cebf1ca00UL) /* FIREDANCE BPF JIT CACHE V0 */
+
+/* FD_BPF_JIT_CACHE_{ENTRY_MAX,TEXT_MAX}_DEFAULT size the jit cache of
+   an execution thread.  The hot programs of a mainnet block fit easily
+   and programs with up to 4 MiB of text compile.  The footprint is
+   about 128 MiB (the code pages are mapped separately and only touched
+   as needed). */
+
+#define FD_BPF_JIT_CACHE_ENTRY_MAX_DEFAULT (16UL)
+#define FD_BPF_JIT_CACHE_TEXT_MAX_DEFAULT  (1UL<<19)
+
+/* fd_bpf_jit_cache_metrics_t holds the cumulative event counts of a
+   jit cache. */
+
+struct fd_bpf_jit_cache_metrics {
+  ulong hit_cnt;          /* runs with a compiled program */
+  ulong compile_cnt;      /* programs compiled */
+  ulong compile_fail_cnt; /* programs that could not be compiled */
+  ulong evict_cnt;        /* programs evicted to make room */
+  ulong flush_cnt;        /* flushes due to a syscall table change */
+  ulong interp_cnt;       /* runs that fell back to the interpreter */
+};
+
+typedef struct fd_bpf_jit_cache_metrics fd_bpf_jit_cache_metrics_t;
+
+struct fd_bpf_jit_cache_private;
+typedef struct fd_bpf_jit_cache_private fd_bpf_jit_cache_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_bpf_jit_cache_{align,footprint} return the alignment and footprint
+   of a memory region suitable for holding a jit cache with entry_max
+   programs of up to text_max words each.  footprint returns 0 if
+   entry_max is zero or text_max is not in [1,FD_VM_JIT_TEXT_MAX]. */
+
+FD_FN_CONST ulong
+fd_bpf_jit_cache_align( void );
+
+FD_FN_CONST ulong
+fd_bpf_jit_cache_footprint( ulong entry_max,
+                            ulong text_max );
+
+/* fd_bpf_jit_cache_new formats a memory region with suitable alignment
+   and footprint for holding a jit cache.  Maps the code pages of all
+   entry_max jits.  Returns shmem on success and NULL on failure (logs
+   details).  The caller is not joined on return. */
+
+void *
+fd_bpf_jit_cache_new( void * shmem,
+                      ulong  entry_max,
+                      ulong  text_max );
+
+/* fd_bpf_jit_cache_{join,leave} are the usual join / leave semantics.
+   fd_bpf_jit_cache_delete unformats a memory region holding a jit cache
+   and unmaps the code pages of its jits.  Assumes nobody is joined.
+   Returns shcache on success and NULL on failure (logs details). */
+
+fd_bpf_jit_cache_t *
+fd_bpf_jit_cache_join( void * shcache );
+
+void *
+fd_bpf_jit_cache_leave( fd_bpf_jit_cache_t * cache );
+
+void *
+fd_bpf_jit_cache_delete( void * shcache );
+
+/* fd_bpf_jit_cache_syscalls returns a syscalls table with the same
+   contents as syscalls that lives as long as the cache, for setting up
+   a vm whose program should run under the jit.  If the contents differ
+   from what the cache held so far, all programs in the cache are
+   flushed.  If that is not possible because a program is running, the
+   cache is left untouched and syscalls is returned instead (such that
+   the vm simply runs on the interpreter). */
+
+fd_sbpf_syscalls_t *
+fd_bpf_jit_cache_syscalls( fd_bpf_jit_cache_t * cache,
+                           fd_sbpf_syscalls_t * syscalls );
+
+/* fd_bpf_jit_cache_exec runs the program vm is set up for with the
+   code compiled for it, compiling it first if it is not in the cache.
+   prog_hash is the hash of the program's fd_sbpf_validated_program_t.
+   Has the exact same semantics as fd_vm_exec_notrace.  Returns
+   FD_VM_ERR_EBPF_JIT_NOT_COMPILED without touching vm if the program
+   can not be run under the jit (e.g. vm is tracing, vm's syscalls
+   table is not the one from fd_bpf_jit_cache_syscalls, the program does
+   not compile or every entry is running), in which case the caller
+   should fall back to fd_vm_exec.  Reentrant (e.g. from a CPI syscall)
+   as programs are pinned while they run. */
+
+int
+fd_bpf_jit_cache_exec( fd_bpf_jit_cache_t * cache,
+                       ulong                prog_hash,
+                       fd_vm_t *            vm );
+
+/* fd_bpf_jit_cache_metrics returns the location of the cache's event
+   counters. */
+
+FD_FN_CONST fd_bpf_jit_cache_metrics_t const *
+fd_bpf_jit_cache_metrics( fd_bpf_jit_cache_t const * cache );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_runtime_program_fd_bpf_jit_cache_h */
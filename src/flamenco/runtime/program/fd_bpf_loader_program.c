@@ -12,6 +12,7 @@
 #include "../fd_executor.h"
 #include "fd_bpf_loader_serialization.h"
 #include "fd_native_cpi.h"
+#include "fd_bpf_jit_cache.h"
 #include "../fd_borrowed_account.h"
 
 #include <stdlib.h>
@@ -414,6 +415,11 @@ fd_bpf_execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t con
                                &instr_ctx->txn_ctx->features,
                                0 );
 
+  /* Programs run under the jit need a syscalls table that outlives the
+     compiled code (the jit cache flushes itself if the table changes). */
+  fd_bpf_jit_cache_t * jit_cache = instr_ctx->txn_ctx->jit_cache;
+  if( jit_cache ) syscalls = fd_bpf_jit_cache_syscalls( jit_cache, syscalls );
+
   /* https://github.com/anza-xyz/agave/blob/574bae8fefc0ed256b55340b9d87b7689bcdf222/programs/bpf_loader/src/lib.rs#L1362-L1368 */
   ulong                   input_sz                                = 0UL;
   ulong                   pre_lens[256]                           = {0};
@@ -483,6 +489,10 @@ fd_bpf_execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t con
     return FD_EXECUTOR_INSTR_ERR_PROGRAM_ENVIRONMENT_SETUP_FAILURE;
   }
 
+  /* Dispatch the superinstructions found when the program was validated
+     unless disabled for this thread */
+  if( instr_ctx->txn_ctx->vm_fuse ) vm->fuse = prog->fuse;
+
 #ifdef FD_DEBUG_SBPF_TRACES
   uchar * signature = (uchar*)vm->instr_ctx->txn_ctx->_txn_raw->raw + vm->instr_ctx->txn_ctx->txn_descriptor->signature_off;
   uchar sig[64];
@@ -508,7 +518,11 @@ fd_bpf_execute( fd_exec_instr_ctx_t * instr_ctx, fd_sbpf_validated_program_t con
 
   vm->cu -= heap_cost_result;
 
-  int exec_err = fd_vm_exec( vm );
+  /* Run the program under the jit if this thread has a jit cache,
+     falling back to the interpreter for programs the jit can not run. */
+  int exec_err = FD_VM_ERR_EBPF_JIT_NOT_COMPILED;
+  if( jit_cache ) exec_err = fd_bpf_jit_cache_exec( jit_cache, prog->hash, vm );
+  if( exec_err==FD_VM_ERR_EBPF_JIT_NOT_COMPILED ) exec_err = fd_vm_exec( vm );
   instr_ctx->txn_ctx->compute_meter = vm->cu;
 
   if( FD_UNLIKELY( vm->trace ) ) {
@@ -0,0 +1,452 @@
+#include "fd_bpf_program_cache.h"
+
+/* An entry's ref field encodes its state:
+
+     0                     free
+     FD_BPF_PROGRAM_CACHE_REF_LOCKED  being filled or freed by the writer
+     otherwise             live, held by ref-1 readers
+
+   Readers only ever move a live entry from r to r+1 and back.  The
+   writer (holding the cache lock) moves free entries to LOCKED and
+   live entries without readers (ref==1) to LOCKED and back to free.
+   Everything but ref and last_use is only written while the entry is
+   LOCKED, except for epoch which invalidate may overwrite with
+   FD_BPF_PROGRAM_CACHE_EPOCH_STALE at any time. */
+
+#define FD_BPF_PROGRAM_CACHE_REF_LOCKED  (ULONG_MAX)
+#define FD_BPF_PROGRAM_CACHE_EPOCH_STALE (ULONG_MAX)
+
+#define FD_BPF_PROGRAM_CACHE_VAL_ALIGN   (128UL)
+#define FD_BPF_PROGRAM_CACHE_ENTRY_MAX   (1UL<<32)
+
+struct fd_bpf_program_cache_entry {
+  ulong                      ref;
+  ulong                      epoch;
+  ulong                      last_use;  /* tickcount of last insert or hit */
+  ulong                      val_gaddr;
+  ulong                      val_sz;
+  fd_bpf_program_cache_key_t key;
+};
+
+typedef struct fd_bpf_program_cache_entry fd_bpf_program_cache_entry_t;
+
+struct __attribute__((aligned(FD_BPF_PROGRAM_CACHE_ALIGN))) fd_bpf_program_cache_private {
+  ulong magic;       /* ==FD_BPF_PROGRAM_CACHE_MAGIC */
+  ulong cache_gaddr; /* wksp gaddr of this cache, used to find the wksp from any join */
+  ulong entry_max;
+  ulong set_mask;    /* entry_max/WAY_CNT - 1 */
+  ulong byte_max;
+  ulong wksp_tag;
+
+  /* Writer state (only modified while holding lock) */
+
+  ulong lock __attribute__((aligned(FD_BPF_PROGRAM_CACHE_ALIGN)));
+  ulong byte_cnt;
+  ulong entry_cnt;
+
+  fd_bpf_program_cache_metrics_t metrics __attribute__((aligned(FD_BPF_PROGRAM_CACHE_ALIGN)));
+
+  /* entry_max fd_bpf_program_cache_entry_t follow */
+};
+
+static inline ulong
+fd_bpf_program_cache_entry_max_fixup( ulong entry_max ) {
+  return fd_ulong_pow2_up( fd_ulong_max( entry_max, FD_BPF_PROGRAM_CACHE_WAY_CNT ) );
+}
+
+static inline fd_bpf_program_cache_entry_t *
+fd_bpf_program_cache_entries( fd_bpf_program_cache_t const * cache ) {
+  return (fd_bpf_program_cache_entry_t *)( (ulong)cache + sizeof(fd_bpf_program_cache_t) );
+}
+
+static inline fd_wksp_t *
+fd_bpf_program_cache_wksp( fd_bpf_program_cache_t const * cache ) {
+  return (fd_wksp_t *)( (ulong)cache - cache->cache_gaddr );
+}
+
+static inline int
+fd_bpf_program_cache_key_eq( fd_bpf_program_cache_key_t const * a,
+                             fd_bpf_program_cache_key_t const * b ) {
+  return ( a->deploy_slot ==b->deploy_slot  ) &
+         ( a->feature_hash==b->feature_hash ) &
+         ( a->data_hash   ==b->data_hash    ) &
+         fd_memeq( a->pubkey.uc, b->pubkey.uc, sizeof(fd_pubkey_t) );
+}
+
+static inline ulong
+fd_bpf_program_cache_key_set( fd_bpf_program_cache_t const *     cache,
+                              fd_bpf_program_cache_key_t const * key ) {
+  return fd_hash( key->deploy_slot ^ key->data_hash, key->pubkey.uc, sizeof(fd_pubkey_t) ) & cache->set_mask;
+}
+
+static inline int
+fd_bpf_program_cache_ref_is_live( ulong ref ) {
+  return (ref!=0UL) & (ref!=FD_BPF_PROGRAM_CACHE_REF_LOCKED);
+}
+
+static inline void
+fd_bpf_program_cache_lock( fd_bpf_program_cache_t * cache ) {
+  while( FD_UNLIKELY( FD_ATOMIC_CAS( &cache->lock, 0UL, 1UL ) ) ) FD_SPIN_PAUSE();
+  FD_COMPILER_MFENCE();
+}
+
+static inline void
+fd_bpf_program_cache_unlock( fd_bpf_program_cache_t * cache ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->lock ) = 0UL;
+}
+
+/* fd_bpf_program_cache_entry_free frees a live entry that has no
+   readers.  Returns 1 on success and 0 if the entry has readers (in
+   which case it is left untouched).  Assumes the caller holds the
+   cache lock. */
+
+static int
+fd_bpf_program_cache_entry_free( fd_bpf_program_cache_t *       cache,
+                                 fd_bpf_program_cache_entry_t * entry ) {
+  if( FD_UNLIKELY( FD_ATOMIC_CAS( &entry->ref, 1UL, FD_BPF_PROGRAM_CACHE_REF_LOCKED )!=1UL ) ) return 0;
+  fd_wksp_free( fd_bpf_program_cache_wksp( cache ), entry->val_gaddr );
+  cache->byte_cnt  -= entry->val_sz;
+  cache->entry_cnt -= 1UL;
+  entry->val_gaddr  = 0UL;
+  entry->val_sz     = 0UL;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( entry->ref ) = 0UL;
+  return 1;
+}
+
+/* fd_bpf_program_cache_evict_lru frees the least recently used live
+   entry without readers in [entry0,entry0+cnt).  Stale entries are
+   always evicted first.  Returns 1 if an entry was freed and 0 if no
+   entry in the range could be. */
+
+static int
+fd_bpf_program_cache_evict_lru( fd_bpf_program_cache_t *       cache,
+                                fd_bpf_program_cache_entry_t * entry0,
+                                ulong                          cnt ) {
+  for(;;) {
+    fd_bpf_program_cache_entry_t * lru      = NULL;
+    ulong                          lru_used = ULONG_MAX;
+    for( ulong i=0UL; i<cnt; i++ ) {
+      fd_bpf_program_cache_entry_t * entry = entry0 + i;
+      if( FD_VOLATILE_CONST( entry->ref )!=1UL ) continue;
+      ulong used = FD_VOLATILE_CONST( entry->epoch )==FD_BPF_PROGRAM_CACHE_EPOCH_STALE ? 0UL : FD_VOLATILE_CONST( entry->last_use );
+      if( used<lru_used ) { lru = entry; lru_used = used; }
+    }
+    if( FD_UNLIKELY( !lru ) ) return 0;
+
+    /* A reader might have grabbed lru since the scan.  Just rescan in
+       that case. */
+    if( FD_LIKELY( fd_bpf_program_cache_entry_free( cache, lru ) ) ) {
+      FD_ATOMIC_FETCH_AND_ADD( &cache->metrics.evict_cnt, 1UL );
+      return 1;
+    }
+  }
+}
+
+ulong
+fd_bpf_program_cache_align( void ) {
+  return FD_BPF_PROGRAM_CACHE_ALIGN;
+}
+
+ulong
+fd_bpf_program_cache_footprint( ulong entry_max ) {
+  if( FD_UNLIKELY( !entry_max || entry_max>FD_BPF_PROGRAM_CACHE_ENTRY_MAX ) ) return 0UL;
+  entry_max = fd_bpf_program_cache_entry_max_fixup( entry_max );
+  ulong l = FD_LAYOUT_INIT;
+  l = FD_LAYOUT_APPEND( l, FD_BPF_PROGRAM_CACHE_ALIGN,             sizeof(fd_bpf_program_cache_t)                 );
+  l = FD_LAYOUT_APPEND( l, alignof(fd_bpf_program_cache_entry_t), entry_max*sizeof(fd_bpf_program_cache_entry_t) );
+  return FD_LAYOUT_FINI( l, FD_BPF_PROGRAM_CACHE_ALIGN );
+}
+
+void *
+fd_bpf_program_cache_new( void * shmem,
+                          ulong  entry_max,
+                          ulong  byte_max,
+                          ulong  wksp_tag ) {
+  fd_bpf_program_cache_t * cache = (fd_bpf_program_cache_t *)shmem;
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_bpf_program_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_bpf_program_cache_footprint( entry_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad entry_max" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !byte_max ) ) {
+    FD_LOG_WARNING(( "zero byte_max" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !wksp_tag ) ) {
+    FD_LOG_WARNING(( "zero wksp_tag" ));
+    return NULL;
+  }
+
+  fd_wksp_t * wksp = fd_wksp_containing( shmem );
+  if( FD_UNLIKELY( !wksp ) ) {
+    FD_LOG_WARNING(( "shmem must be part of a workspace" ));
+    return NULL;
+  }
+
+  fd_memset( shmem, 0, footprint );
+
+  entry_max = fd_bpf_program_cache_entry_max_fixup( entry_max );
+
+  cache->cache_gaddr = fd_wksp_gaddr_fast( wksp, shmem );
+  cache->entry_max   = entry_max;
+  cache->set_mask    = entry_max/FD_BPF_PROGRAM_CACHE_WAY_CNT - 1UL;
+  cache->byte_max    = byte_max;
+  cache->wksp_tag    = wksp_tag;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = FD_BPF_PROGRAM_CACHE_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_bpf_program_cache_t *
+fd_bpf_program_cache_join( void * shcache ) {
+  fd_bpf_program_cache_t * cache = (fd_bpf_program_cache_t *)shcache;
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_bpf_program_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( cache->magic!=FD_BPF_PROGRAM_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return cache;
+}
+
+void *
+fd_bpf_program_cache_leave( fd_bpf_program_cache_t * cache ) {
+  if( FD_UNLIKELY( !cache ) ) {
+    FD_LOG_WARNING(( "NULL cache" ));
+    return NULL;
+  }
+  return (void *)cache;
+}
+
+void *
+fd_bpf_program_cache_delete( void * shcache ) {
+  fd_bpf_program_cache_t * cache = (fd_bpf_program_cache_t *)shcache;
+
+  if( FD_UNLIKELY( !shcache ) ) {
+    FD_LOG_WARNING(( "NULL shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shcache, fd_bpf_program_cache_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shcache" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( cache->magic!=FD_BPF_PROGRAM_CACHE_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  fd_wksp_t *                    wksp    = fd_bpf_program_cache_wksp( cache );
+  fd_bpf_program_cache_entry_t * entries = fd_bpf_program_cache_entries( cache );
+  for( ulong i=0UL; i<cache->entry_max; i++ ) {
+    if( entries[ i ].val_gaddr ) fd_wksp_free( wksp, entries[ i ].val_gaddr );
+  }
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( cache->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shcache;
+}
+
+int
+fd_bpf_program_cache_query( fd_bpf_program_cache_t *           cache,
+                            fd_bpf_program_cache_key_t const * key,
+                            ulong                              epoch,
+                            void *                             out,
+                            ulong                              out_max,
+                            ulong *                            out_sz ) {
+  fd_bpf_program_cache_entry_t * set = fd_bpf_program_cache_entries( cache ) +
+                                       fd_bpf_program_cache_key_set( cache, key )*FD_BPF_PROGRAM_CACHE_WAY_CNT;
+
+  for( ulong way=0UL; way<FD_BPF_PROGRAM_CACHE_WAY_CNT; way++ ) {
+    fd_bpf_program_cache_entry_t * entry = set + way;
+
+    /* Pin the entry if it looks like a match.  The key compare before
+       the pin is speculative (the entry might be recycled under us) and
+       is redone once the entry is pinned. */
+
+    int pinned = 0;
+    for(;;) {
+      ulong ref = FD_VOLATILE_CONST( entry->ref );
+      if( !fd_bpf_program_cache_ref_is_live( ref ) ) break;
+      if( !fd_bpf_program_cache_key_eq( &entry->key, key ) ) break;
+      if( FD_LIKELY( FD_ATOMIC_CAS( &entry->ref, ref, ref+1UL )==ref ) ) { pinned = 1; break; }
+      FD_SPIN_PAUSE();
+    }
+    if( !pinned ) continue;
+
+    FD_COMPILER_MFENCE();
+    int   hit    = 0;
+    ulong val_sz = entry->val_sz;
+    if( FD_LIKELY( fd_bpf_program_cache_key_eq( &entry->key, key ) &&
+                   FD_VOLATILE_CONST( entry->epoch )==epoch        &&
+                   val_sz<=out_max ) ) {
+      fd_memcpy( out, fd_wksp_laddr_fast( fd_bpf_program_cache_wksp( cache ), entry->val_gaddr ), val_sz );
+      FD_VOLATILE( entry->last_use ) = (ulong)fd_tickcount();
+      hit = 1;
+    }
+    FD_COMPILER_MFENCE();
+    FD_ATOMIC_FETCH_AND_SUB( &entry->ref, 1UL );
+
+    if( hit ) {
+      *out_sz = val_sz;
+      FD_ATOMIC_FETCH_AND_ADD( &cache->metrics.hit_cnt, 1UL );
+      return FD_BPF_PROGRAM_CACHE_SUCCESS;
+    }
+  }
+
+  FD_ATOMIC_FETCH_AND_ADD( &cache->metrics.miss_cnt, 1UL );
+  return FD_BPF_PROGRAM_CACHE_ERR_KEY;
+}
+
+int
+fd_bpf_program_cache_insert( fd_bpf_program_cache_t *           cache,
+                             fd_bpf_program_cache_key_t const * key,
+                             ulong                              epoch,
+                             void const *                       val,
+                             ulong                              val_sz ) {
+  if( FD_UNLIKELY( val_sz>cache->byte_max ) ) {
+    FD_ATOMIC_FETCH_AND_ADD( &cache->metrics.insert_fail_cnt, 1UL );
+    return FD_BPF_PROGRAM_CACHE_ERR_FULL;
+  }
+
+  fd_wksp_t *                    wksp    = fd_bpf_program_cache_wksp( cache );
+  fd_bpf_program_cache_entry_t * entries = fd_bpf_program_cache_entries( cache );
+  fd_bpf_program_cache_entry_t * set     = entries + fd_bpf_program_cache_key_set( cache, key )*FD_BPF_PROGRAM_CACHE_WAY_CNT;
+
+  fd_bpf_program_cache_lock( cache );
+
+  /* Retire any existing value for key.  If it is being read, mark it
+     stale such that it never matches again and gets evicted first. */
+
+  for( ulong way=0UL; way<FD_BPF_PROGRAM_CACHE_WAY_CNT; way++ ) {
+    fd_bpf_program_cache_entry_t * entry = set + way;
+    if( !fd_bpf_program_cache_ref_is_live( FD_VOLATILE_CONST( entry->ref ) ) ) continue;
+    if( !fd_bpf_program_cache_key_eq( &entry->key, key ) ) continue;
+    if( !fd_bpf_program_cache_entry_free( cache, entry ) ) FD_VOLATILE( entry->epoch ) = FD_BPF_PROGRAM_CACHE_EPOCH_STALE;
+  }
+
+  /* Make room in the byte budget, then find a way in the set. */
+
+  int err = FD_BPF_PROGRAM_CACHE_ERR_FULL;
+
+  while( cache->byte_cnt+val_sz>cache->byte_max ) {
+    if( FD_UNLIKELY( !fd_bpf_program_cache_evict_lru( cache, entries, cache->entry_max ) ) ) goto done;
+  }
+
+  fd_bpf_program_cache_entry_t * entry = NULL;
+  for( ulong way=0UL; way<FD_BPF_PROGRAM_CACHE_WAY_CNT; way++ ) {
+    if( !FD_VOLATILE_CONST( set[ way ].ref ) ) { entry = set + way; break; }
+  }
+  if( !entry ) {
+    if( FD_UNLIKELY( !fd_bpf_program_cache_evict_lru( cache, set, FD_BPF_PROGRAM_CACHE_WAY_CNT ) ) ) goto done;
+    for( ulong way=0UL; way<FD_BPF_PROGRAM_CACHE_WAY_CNT; way++ ) {
+      if( !FD_VOLATILE_CONST( set[ way ].ref ) ) { entry = set + way; break; }
+    }
+  }
+
+  ulong val_gaddr = fd_wksp_alloc( wksp, FD_BPF_PROGRAM_CACHE_VAL_ALIGN, fd_ulong_max( val_sz, 1UL ), cache->wksp_tag );
+  if( FD_UNLIKELY( !val_gaddr ) ) goto done;
+
+  FD_VOLATILE( entry->ref ) = FD_BPF_PROGRAM_CACHE_REF_LOCKED;
+  FD_COMPILER_MFENCE();
+  entry->key       = *key;
+  entry->epoch     = epoch;
+  entry->last_use  = (ulong)fd_tickcount();
+  entry->val_gaddr = val_gaddr;
+  entry->val_sz    = val_sz;
+  fd_memcpy( fd_wksp_laddr_fast( wksp, val_gaddr ), val, val_sz );
+  cache->byte_cnt  += val_sz;
+  cache->entry_cnt += 1UL;
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( entry->ref ) = 1UL;
+
+  err = FD_BPF_PROGRAM_CACHE_SUCCESS;
+
+done:
+  fd_bpf_program_cache_unlock( cache );
+  FD_ATOMIC_FETCH_AND_ADD( err ? &cache->metrics.insert_fail_cnt : &cache->metrics.insert_cnt, 1UL );
+  return err;
+}
+
+ulong
+fd_bpf_program_cache_invalidate( fd_bpf_program_cache_t * cache,
+                                 fd_pubkey_t const *      pubkey ) {
+  fd_bpf_program_cache_entry_t * entries = fd_bpf_program_cache_entries( cache );
+  ulong                          cnt     = 0UL;
+
+  fd_bpf_program_cache_lock( cache );
+
+  for( ulong i=0UL; i<cache->entry_max; i++ ) {
+    fd_bpf_program_cache_entry_t * entry = entries + i;
+    if( !fd_bpf_program_cache_ref_is_live( FD_VOLATILE_CONST( entry->ref ) ) ) continue;
+    if( !fd_memeq( entry->key.pubkey.uc, pubkey->uc, sizeof(fd_pubkey_t) ) ) continue;
+    if( FD_VOLATILE_CONST( entry->epoch )==FD_BPF_PROGRAM_CACHE_EPOCH_STALE ) continue;
+    if( !fd_bpf_program_cache_entry_free( cache, entry ) ) FD_VOLATILE( entry->epoch ) = FD_BPF_PROGRAM_CACHE_EPOCH_STALE;
+    cnt++;
+  }
+
+  fd_bpf_program_cache_unlock( cache );
+
+  FD_ATOMIC_FETCH_AND_ADD( &cache->metrics.invalidate_cnt, cnt );
+  return cnt;
+}
+
+ulong fd_bpf_program_cache_entry_max( fd_bpf_program_cache_t const * cache ) { return cache->entry_max; }
+ulong fd_bpf_program_cache_byte_max ( fd_bpf_program_cache_t const * cache ) { return cache->byte_max;  }
+ulong fd_bpf_program_cache_byte_cnt ( fd_bpf_program_cache_t const * cache ) { return FD_VOLATILE_CONST( cache->byte_cnt  ); }
+ulong fd_bpf_program_cache_entry_cnt( fd_bpf_program_cache_t const * cache ) { return FD_VOLATILE_CONST( cache->entry_cnt ); }
+
+fd_bpf_program_cache_metrics_t const *
+fd_bpf_program_cache_metrics( fd_bpf_program_cache_t const * cache ) {
+  return &cache->metrics;
+}
+
+ulong
+fd_bpf_program_cache_feature_hash( ulong                 slot,
+                                   fd_features_t const * features ) {
+  /* Pack the active flags 64 at a time and fold them into the hash.
+     Feature activation slots that are not yet reached hash the same as
+     disabled features, which is what makes entries shareable across
+     slots (and forks) with the same effective feature set. */
+  ulong hash = 0x8c3d9b8a2f6e1d47UL;
+  ulong word = 0UL;
+  for( ulong i=0UL; i<FD_FEATURE_ID_CNT; i++ ) {
+    word |= ((ulong)(slot>=features->f[ i ]))<<(i&63UL);
+    if( (i&63UL)==63UL || i==FD_FEATURE_ID_CNT-1UL ) {
+      hash = fd_ulong_hash( hash ^ word ) + i;
+      word = 0UL;
+    }
+  }
+  return hash;
+}
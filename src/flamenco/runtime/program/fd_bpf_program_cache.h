@@ -0,0 +1,206 @@
+#ifndef HEADER_fd_src_flamenco_runtime_program_fd_bpf_program_cache_h
+#define HEADER_fd_src_flamenco_runtime_program_fd_bpf_program_cache_h
+
+/* fd_bpf_program_cache is a workspace resident cache of validated sBPF
+   programs that is shared by all the tiles that join it.
+
+   The per-fork program cache in funk (see fd_bpf_program_util.h) keeps
+   one fd_sbpf_validated_program_t per program per fork, and each fork
+   separately loads, relocates and validates every program it touches
+   the first time it does so in an epoch.  With many forks in flight (or
+   many tiles building program cache entries) the same program is
+   validated over and over even though the result only depends on the
+   program bytes and the feature set in effect.
+
+   fd_bpf_program_cache memoizes that work node wide.  Entries are keyed
+   by (program pubkey, deployment slot, feature set hash) and carry a
+   hash identifying the programdata so that a lookup can never return a
+   program built from different bytes.  As the key changes whenever a
+   program is redeployed, entries for old versions are never
+   invalidated eagerly (forks that still run them keep hitting), they
+   just age out.  Values are position independent copies
+   of a fd_sbpf_validated_program_t (header, calldests and rodata as laid
+   out by fd_sbpf_validated_program_new) that the caller copies back
+   into its own funk record.  Entries are tagged with the epoch they
+   were validated in and only match queries for that same epoch, such
+   that a hot program is validated at most once per epoch node wide.
+
+   The cache is organized as a set associative table of entry_max
+   entries (FD_BPF_PROGRAM_CACHE_WAY_CNT ways per set).  Values are
+   allocated from the workspace holding the cache and the total bytes
+   held is bounded by byte_max.  When an insert needs room, the least
+   recently used entries (first within the set, then globally by byte
+   budget) are evicted.
+
+   Queries are lock free: an entry is pinned with an atomic reference
+   count while its value is being copied out, so any number of tiles
+   can query concurrently with each other and with a writer.  Inserts
+   and invalidations are serialized by a spin lock.  These are expected
+   to be rare (once per program per epoch, and on program upgrades).
+
+   Hit, miss, insert, eviction and invalidation counts are kept in the
+   cache itself and can be read by any joiner (the replay tile reports
+   them as its program cache metrics). */
+
+#include "../../fd_flamenco_base.h"
+#include "../../features/fd_features.h"
+
+/* FD_BPF_PROGRAM_CACHE_ALIGN is the alignment of a program cache.
+   FD_BPF_PROGRAM_CACHE_WAY_CNT is the associativity of the cache. */
+
+#define FD_BPF_PROGRAM_CACHE_ALIGN   (128UL)
+#define FD_BPF_PROGRAM_CACHE_WAY_CNT (8UL)
+
+#define FD_BPF_PROGRAM_CACHE_MAGIC (0xf17eda2ce5bfcac0UL) /* FIREDANCE SBPF CACHE V0 */
+
+/* FD_BPF_PROGRAM_CACHE_{SUCCESS,ERR_*} are the return codes of the
+   program cache APIs. */
+
+#define FD_BPF_PROGRAM_CACHE_SUCCESS  (0)
+#define FD_BPF_PROGRAM_CACHE_ERR_KEY  (-1) /* no matching entry */
+#define FD_BPF_PROGRAM_CACHE_ERR_FULL (-2) /* no room for the value */
+
+/* fd_bpf_program_cache_key_t identifies a validated program.
+   deploy_slot is the slot the program was last deployed (or upgraded)
+   at (0 for programs owned by the v1/v2 loaders).  feature_hash is
+   fd_bpf_program_cache_feature_hash of the feature set the program was
+   validated against.  data_hash identifies the programdata (e.g. the
+   account hash of the account holding it) and guards against two forks
+   deploying different bytes in the same slot. */
+
+struct fd_bpf_program_cache_key {
+  fd_pubkey_t pubkey;
+  ulong       deploy_slot;
+  ulong       feature_hash;
+  ulong       data_hash;
+};
+
+typedef struct fd_bpf_program_cache_key fd_bpf_program_cache_key_t;
+
+/* fd_bpf_program_cache_metrics_t holds the cumulative event counts of a
+   program cache. */
+
+struct fd_bpf_program_cache_metrics {
+  ulong hit_cnt;         /* queries that returned a value */
+  ulong miss_cnt;        /* queries that did not */
+  ulong insert_cnt;      /* values inserted */
+  ulong insert_fail_cnt; /* inserts that failed (full or busy) */
+  ulong evict_cnt;       /* values evicted to make room */
+  ulong invalidate_cnt;  /* values removed by invalidation */
+};
+
+typedef struct fd_bpf_program_cache_metrics fd_bpf_program_cache_metrics_t;
+
+struct fd_bpf_program_cache_private;
+typedef struct fd_bpf_program_cache_private fd_bpf_program_cache_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_bpf_program_cache_{align,footprint} return the alignment and
+   footprint of a memory region suitable for holding a program cache
+   with entry_max entries.  entry_max is rounded up to a power of two
+   that is at least FD_BPF_PROGRAM_CACHE_WAY_CNT.  footprint returns 0
+   for an unreasonable entry_max.  The values themselves are allocated
+   separately from the workspace the cache is in (up to byte_max bytes
+   of them, see below), so that workspace should have at least that
+   much free space beyond the footprint. */
+
+FD_FN_CONST ulong
+fd_bpf_program_cache_align( void );
+
+FD_FN_CONST ulong
+fd_bpf_program_cache_footprint( ulong entry_max );
+
+/* fd_bpf_program_cache_new formats an unused workspace memory region
+   with the required footprint and alignment to be a program cache.
+   byte_max is the budget for the total size of values held by the
+   cache.  Values are allocated from the workspace with the given tag
+   (should be non-zero).  Returns shmem on success and NULL on failure
+   (logs details). */
+
+void *
+fd_bpf_program_cache_new( void * shmem,
+                          ulong  entry_max,
+                          ulong  byte_max,
+                          ulong  wksp_tag );
+
+/* fd_bpf_program_cache_{join,leave,delete} are the usual shared memory
+   object semantics.  The cache must be in a workspace.  delete frees
+   all values held by the cache and assumes nobody is joined. */
+
+fd_bpf_program_cache_t *
+fd_bpf_program_cache_join( void * shcache );
+
+void *
+fd_bpf_program_cache_leave( fd_bpf_program_cache_t * cache );
+
+void *
+fd_bpf_program_cache_delete( void * shcache );
+
+/* fd_bpf_program_cache_query looks up the value for key that was
+   validated in the given epoch.  On success, copies the value into
+   [out,out+*out_sz), updates the entry's recency and returns SUCCESS.
+   Returns ERR_KEY (and leaves out untouched) if there is no such value
+   or if it is larger than out_max.  Lock free and safe to call
+   concurrently from any number of joiners. */
+
+int
+fd_bpf_program_cache_query( fd_bpf_program_cache_t *           cache,
+                            fd_bpf_program_cache_key_t const * key,
+                            ulong                              epoch,
+                            void *                             out,
+                            ulong                              out_max,
+                            ulong *                            out_sz );
+
+/* fd_bpf_program_cache_insert inserts a copy of [val,val+val_sz) as the
+   value for key validated in the given epoch, replacing any existing
+   value for key.  Evicts least recently used values as necessary to
+   stay within entry_max and byte_max.  Returns SUCCESS on success and
+   ERR_FULL if the value could not be made to fit (e.g. it is larger
+   than byte_max or every candidate entry is currently being read).
+   Failure is benign (the value is simply not cached). */
+
+int
+fd_bpf_program_cache_insert( fd_bpf_program_cache_t *           cache,
+                             fd_bpf_program_cache_key_t const * key,
+                             ulong                              epoch,
+                             void const *                       val,
+                             ulong                              val_sz );
+
+/* fd_bpf_program_cache_invalidate removes all values for the program
+   at pubkey (e.g. because it was upgraded, retracted or closed).
+   Entries that are being read at the time of the call are marked
+   stale instead and will never match a query again.  Returns the
+   number of entries affected. */
+
+ulong
+fd_bpf_program_cache_invalidate( fd_bpf_program_cache_t * cache,
+                                 fd_pubkey_t const *      pubkey );
+
+/* fd_bpf_program_cache_{entry_max,byte_max,byte_cnt,entry_cnt} return
+   the capacity and current usage of the cache.  byte_cnt and entry_cnt
+   are a snapshot that may be stale by the time they are returned.
+   fd_bpf_program_cache_metrics returns the location of the cache's
+   event counters.  These are updated atomically by all joiners and can
+   be read at any time. */
+
+FD_FN_PURE ulong fd_bpf_program_cache_entry_max( fd_bpf_program_cache_t const * cache );
+FD_FN_PURE ulong fd_bpf_program_cache_byte_max ( fd_bpf_program_cache_t const * cache );
+ulong            fd_bpf_program_cache_byte_cnt ( fd_bpf_program_cache_t const * cache );
+ulong            fd_bpf_program_cache_entry_cnt( fd_bpf_program_cache_t const * cache );
+
+FD_FN_CONST fd_bpf_program_cache_metrics_t const *
+fd_bpf_program_cache_metrics( fd_bpf_program_cache_t const * cache );
+
+/* fd_bpf_program_cache_feature_hash returns a hash of the set of
+   features that are active at slot.  Two (slot,features) pairs with the
+   same set of active features hash the same, such that programs
+   validated under either are interchangeable. */
+
+FD_FN_PURE ulong
+fd_bpf_program_cache_feature_hash( ulong                 slot,
+                                   fd_features_t const * features );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_runtime_program_fd_bpf_program_cache_h */
@@ -1,4 +1,5 @@
 #include "fd_bpf_program_util.h"
+#include "fd_bpf_program_cache.h"
 #include "fd_bpf_loader_program.h"
 #include "fd_loader_v4_program.h"
 #include "../sysvar/fd_sysvar_epoch_schedule.h"
@@ -26,6 +27,10 @@ fd_sbpf_validated_program_new( void * mem, fd_sbpf_elf_info_t const * elf_info )
   l = FD_LAYOUT_APPEND( l, fd_sbpf_calldests_align(), fd_sbpf_calldests_footprint(elf_info->rodata_sz/8UL) );
   validated_prog->rodata = (uchar *)mem + l;
 
+  /* superinstruction table backing memory (the text is inside the rodata) */
+  l = FD_LAYOUT_APPEND( l, 8UL, elf_info->rodata_footprint );
+  validated_prog->fuse = (uchar *)mem + l;
+
   /* SBPF version */
   validated_prog->sbpf_version = elf_info->sbpf_version;
 
@@ -43,6 +48,7 @@ fd_sbpf_validated_program_footprint( fd_sbpf_elf_info_t const * elf_info ) {
   l = FD_LAYOUT_APPEND( l, alignof(fd_sbpf_validated_program_t), sizeof(fd_sbpf_validated_program_t) );
   l = FD_LAYOUT_APPEND( l, fd_sbpf_calldests_align(), fd_sbpf_calldests_footprint(elf_info->rodata_sz/8UL) );
   l = FD_LAYOUT_APPEND( l, 8UL, elf_info->rodata_footprint );
+  l = FD_LAYOUT_APPEND( l, 1UL, fd_vm_fuse_footprint( elf_info->rodata_sz/8UL ) );
   l = FD_LAYOUT_FINI( l, 128UL );
   return l;
 }
@@ -64,10 +70,15 @@ fd_acc_mgr_cache_key( fd_pubkey_t const * pubkey ) {
    and NULL on failure.
 
    Reasons for failure include:
-   - The program state cannot be read from the account data or is in the `retracted` state. */
+   - The program state cannot be read from the account data or is in the `retracted` state.
+
+   On success, `deploy_slot` is set to the slot the program was last deployed at and `programdata_meta`
+   to the metadata of the program account. */
 static uchar const *
-fd_bpf_get_executable_program_content_for_v4_loader( fd_txn_account_t const * program_acc,
-                                                     ulong *                  program_data_len ) {
+fd_bpf_get_executable_program_content_for_v4_loader( fd_txn_account_t const *   program_acc,
+                                                     ulong *                    program_data_len,
+                                                     ulong *                    deploy_slot,
+                                                     fd_account_meta_t const ** programdata_meta ) {
   int err;
 
   /* Get the current loader v4 state. This implicitly also checks the dlen. */
@@ -81,6 +92,8 @@ fd_bpf_get_executable_program_content_for_v4_loader( fd_txn_account_t const * pr
     return NULL;
   }
 
+  *deploy_slot      = state->slot;
+  *programdata_meta = program_acc->vt->get_meta( program_acc );
   *program_data_len = program_acc->vt->get_data_len( program_acc ) - LOADER_V4_PROGRAM_DATA_OFFSET;
   return program_acc->vt->get_data( program_acc ) + LOADER_V4_PROGRAM_DATA_OFFSET;
 }
@@ -91,13 +104,19 @@ fd_bpf_get_executable_program_content_for_v4_loader( fd_txn_account_t const * pr
 
    Reasons for failure include:
    - The program account data cannot be decoded or is not in the `program` state.
-   - The programdata account is not large enough to hold at least `PROGRAMDATA_METADATA_SIZE` bytes. */
+   - The programdata account is not large enough to hold at least `PROGRAMDATA_METADATA_SIZE` bytes.
+
+   On success, `deploy_slot` is set to the slot recorded in the programdata account (ULONG_MAX if
+   the programdata account is not in the `program_data` state) and `programdata_meta` to the metadata
+   of the programdata account. */
 static uchar const *
-fd_bpf_get_executable_program_content_for_upgradeable_loader( fd_funk_t const *        funk,
-                                                              fd_funk_txn_t const *    funk_txn,
-                                                              fd_txn_account_t const * program_acc,
-                                                              ulong *                  program_data_len,
-                                                              fd_spad_t *              runtime_spad ) {
+fd_bpf_get_executable_program_content_for_upgradeable_loader( fd_funk_t const *          funk,
+                                                              fd_funk_txn_t const *      funk_txn,
+                                                              fd_txn_account_t const *   program_acc,
+                                                              ulong *                    program_data_len,
+                                                              ulong *                    deploy_slot,
+                                                              fd_account_meta_t const ** programdata_meta,
+                                                              fd_spad_t *                runtime_spad ) {
   FD_TXN_ACCOUNT_DECL( programdata_acc );
 
   fd_bpf_upgradeable_loader_state_t * program_account_state =
@@ -119,15 +138,15 @@ fd_bpf_get_executable_program_content_for_upgradeable_loader( fd_funk_t const *
     return NULL;
   }
 
-  /* We don't actually need to decode here, just make sure that the account
-     can be decoded successfully. */
-  fd_bincode_decode_ctx_t ctx_programdata = {
-    .data    = programdata_acc->vt->get_data( programdata_acc ),
-    .dataend = programdata_acc->vt->get_data( programdata_acc ) + programdata_acc->vt->get_data_len( programdata_acc ),
-  };
-
-  ulong total_sz = 0UL;
-  if( FD_UNLIKELY( fd_bpf_upgradeable_loader_state_decode_footprint( &ctx_programdata, &total_sz ) ) ) {
+  /* Make sure that the account can be decoded successfully.  The only
+     thing we need from it is the deployment slot. */
+  fd_bpf_upgradeable_loader_state_t * programdata_state =
+    fd_bincode_decode_spad(
+      bpf_upgradeable_loader_state, runtime_spad,
+      programdata_acc->vt->get_data( programdata_acc ),
+      programdata_acc->vt->get_data_len( programdata_acc ),
+      NULL );
+  if( FD_UNLIKELY( !programdata_state ) ) {
     return NULL;
   }
 
@@ -135,6 +154,9 @@ fd_bpf_get_executable_program_content_for_upgradeable_loader( fd_funk_t const *
     return NULL;
   }
 
+  *deploy_slot      = fd_bpf_upgradeable_loader_state_is_program_data( programdata_state ) ?
+                      programdata_state->inner.program_data.slot : ULONG_MAX;
+  *programdata_meta = programdata_acc->vt->get_meta( programdata_acc );
   *program_data_len = programdata_acc->vt->get_data_len( programdata_acc ) - PROGRAMDATA_METADATA_SIZE;
   return programdata_acc->vt->get_data( programdata_acc ) + PROGRAMDATA_METADATA_SIZE;
 }
@@ -142,10 +164,16 @@ fd_bpf_get_executable_program_content_for_upgradeable_loader( fd_funk_t const *
 /* Gets the programdata for a v1/v2 loader-owned account by returning a pointer to the account data.
    Returns a pointer to the programdata on success. Given the txn account API always returns a handle
    to the account data, this function should NEVER return NULL (since the programdata of v1 and v2 loader)
-   accounts start at the beginning of the data. */
+   accounts start at the beginning of the data. These loaders have no notion of a deployment
+   slot, so `deploy_slot` is always set to 0. `programdata_meta` is set to the metadata of the
+   program account. */
 static uchar const *
-fd_bpf_get_executable_program_content_for_v1_v2_loaders( fd_txn_account_t const * program_acc,
-                                                         ulong *                  program_data_len ) {
+fd_bpf_get_executable_program_content_for_v1_v2_loaders( fd_txn_account_t const *   program_acc,
+                                                         ulong *                    program_data_len,
+                                                         ulong *                    deploy_slot,
+                                                         fd_account_meta_t const ** programdata_meta ) {
+  *deploy_slot      = 0UL;
+  *programdata_meta = program_acc->vt->get_meta( program_acc );
   *program_data_len = program_acc->vt->get_data_len( program_acc );
   return program_acc->vt->get_data( program_acc );
 }
@@ -174,27 +202,40 @@ fd_bpf_get_sbpf_versions( uint *                sbpf_min_version,
   }
 }
 
-uchar const *
-fd_bpf_get_programdata_from_account( fd_funk_t const *        funk,
-                                     fd_funk_txn_t const *    funk_txn,
-                                     fd_txn_account_t const * program_acc,
-                                     ulong *                  out_program_data_len,
-                                     fd_spad_t *              runtime_spad ) {
+static uchar const *
+fd_bpf_get_programdata_and_deploy_slot( fd_funk_t const *          funk,
+                                        fd_funk_txn_t const *      funk_txn,
+                                        fd_txn_account_t const *   program_acc,
+                                        ulong *                    out_program_data_len,
+                                        ulong *                    out_deploy_slot,
+                                        fd_account_meta_t const ** out_programdata_meta,
+                                        fd_spad_t *                runtime_spad ) {
   /* v1/v2 loaders: Programdata is just the account data.
      v3 loader: Programdata lives in a separate account. Deserialize the program account
                 and lookup the programdata account. Deserialize the programdata account.
      v4 loader: Programdata lives in the program account, offset by LOADER_V4_PROGRAM_DATA_OFFSET. */
   if( !memcmp( program_acc->vt->get_owner( program_acc ), fd_solana_bpf_loader_upgradeable_program_id.key, sizeof(fd_pubkey_t) ) ) {
-    return fd_bpf_get_executable_program_content_for_upgradeable_loader( funk, funk_txn, program_acc, out_program_data_len, runtime_spad );
+    return fd_bpf_get_executable_program_content_for_upgradeable_loader( funk, funk_txn, program_acc, out_program_data_len, out_deploy_slot, out_programdata_meta, runtime_spad );
   } else if( !memcmp( program_acc->vt->get_owner( program_acc ), fd_solana_bpf_loader_v4_program_id.key, sizeof(fd_pubkey_t) ) ) {
-    return fd_bpf_get_executable_program_content_for_v4_loader( program_acc, out_program_data_len );
+    return fd_bpf_get_executable_program_content_for_v4_loader( program_acc, out_program_data_len, out_deploy_slot, out_programdata_meta );
   } else if( !memcmp( program_acc->vt->get_owner( program_acc ), fd_solana_bpf_loader_program_id.key, sizeof(fd_pubkey_t) ) ||
              !memcmp( program_acc->vt->get_owner( program_acc ), fd_solana_bpf_loader_deprecated_program_id.key, sizeof(fd_pubkey_t) ) ) {
-    return fd_bpf_get_executable_program_content_for_v1_v2_loaders( program_acc, out_program_data_len );
+    return fd_bpf_get_executable_program_content_for_v1_v2_loaders( program_acc, out_program_data_len, out_deploy_slot, out_programdata_meta );
   }
   return NULL;
 }
 
+uchar const *
+fd_bpf_get_programdata_from_account( fd_funk_t const *        funk,
+                                     fd_funk_txn_t const *    funk_txn,
+                                     fd_txn_account_t const * program_acc,
+                                     ulong *                  out_program_data_len,
+                                     fd_spad_t *              runtime_spad ) {
+  ulong                     deploy_slot;
+  fd_account_meta_t const * programdata_meta;
+  return fd_bpf_get_programdata_and_deploy_slot( funk, funk_txn, program_acc, out_program_data_len, &deploy_slot, &programdata_meta, runtime_spad );
+}
+
 /* Parse ELF info from programdata. */
 static int
 fd_bpf_parse_elf_info( fd_sbpf_elf_info_t *       elf_info,
@@ -315,6 +356,11 @@ fd_bpf_validate_sbpf_program( fd_exec_slot_ctx_t const *    slot_ctx,
   /* FIXME: Super expensive memcpy. */
   fd_memcpy( validated_prog->calldests_shmem, prog->calldests_shmem, fd_sbpf_calldests_footprint( prog->rodata_sz/8UL ) );
 
+  fd_vm_fuse_build( validated_prog->fuse, prog->text, prog->text_cnt, elf_info->sbpf_version );
+
+  validated_prog->hash = fd_hash( fd_hash( elf_info->sbpf_version, prog->rodata, prog->rodata_sz ),
+                                  validated_prog->calldests_shmem, fd_sbpf_calldests_footprint( prog->rodata_sz/8UL ) );
+
   validated_prog->calldests           = fd_sbpf_calldests_join( validated_prog->calldests_shmem );
   validated_prog->entry_pc            = prog->entry_pc;
   validated_prog->text_off            = prog->text_off;
@@ -326,6 +372,86 @@ fd_bpf_validate_sbpf_program( fd_exec_slot_ctx_t const *    slot_ctx,
   return 0;
 }
 
+/* Returns the program cache data_hash of the programdata in the account described by `programdata_meta`.
+   The account hash and modification slot identify the account contents without rehashing the
+   programdata, but only once the account was hashed at the end of the slot it was modified in. An
+   account modified in the current slot (e.g. a program deployed or upgraded in this block) still
+   carries its previous hash, so its programdata is hashed instead. */
+static ulong
+fd_bpf_program_cache_data_hash( fd_account_meta_t const * programdata_meta,
+                                ulong                     slot,
+                                uchar const *             program_data,
+                                ulong                     program_data_len ) {
+  if( FD_UNLIKELY( programdata_meta->slot>=slot ) ) {
+    return fd_hash( 0UL, program_data, program_data_len );
+  }
+  return fd_hash( programdata_meta->slot ^ programdata_meta->dlen, programdata_meta->hash, sizeof(programdata_meta->hash) );
+}
+
+/* Same as `fd_bpf_validate_sbpf_program()`, but backed by the node-wide program cache (if the slot ctx
+   has one). If a program with the same pubkey, deployment slot, feature set and programdata was already
+   validated this epoch (on any fork, by any tile), the result is copied into `validated_prog` instead of
+   loading and validating the program again. Otherwise the program is validated and the outcome (including
+   a verification failure) is published to the program cache for others to reuse.
+
+   `deploy_slot` is ULONG_MAX if the program's deployment slot is unknown, in which case the program cache
+   is bypassed. `programdata_meta` is the metadata of the account holding the programdata. */
+static int
+fd_bpf_validate_sbpf_program_cached( fd_exec_slot_ctx_t const *    slot_ctx,
+                                     fd_pubkey_t const *           program_pubkey,
+                                     ulong                         deploy_slot,
+                                     fd_account_meta_t const *     programdata_meta,
+                                     fd_sbpf_elf_info_t const *    elf_info,
+                                     uchar const *                 program_data,
+                                     ulong                         program_data_len,
+                                     fd_spad_t *                   runtime_spad,
+                                     fd_sbpf_validated_program_t * validated_prog /* out */ ) {
+  fd_bpf_program_cache_t * prog_cache = slot_ctx->prog_cache;
+  if( !prog_cache || deploy_slot==ULONG_MAX ) {
+    return fd_bpf_validate_sbpf_program( slot_ctx, elf_info, program_data, program_data_len, runtime_spad, validated_prog );
+  }
+
+  ulong slot  = fd_bank_slot_get( slot_ctx->bank );
+  ulong epoch = fd_slot_to_epoch( fd_bank_epoch_schedule_query( slot_ctx->bank ), slot, NULL );
+
+  fd_bpf_program_cache_key_t key = {
+    .pubkey       = *program_pubkey,
+    .deploy_slot  = deploy_slot,
+    .feature_hash = fd_bpf_program_cache_feature_hash( slot, fd_bank_features_query( slot_ctx->bank ) ),
+    .data_hash    = fd_bpf_program_cache_data_hash( programdata_meta, slot, program_data, program_data_len )
+  };
+
+  /* The cached copy is a verbatim image of the validated program in whichever record it was validated into.
+     Its internal pointers refer to that record, so point them back into `validated_prog`. */
+  void *  calldests_shmem = validated_prog->calldests_shmem;
+  uchar * rodata          = validated_prog->rodata;
+  uchar * fuse            = validated_prog->fuse;
+  ulong   val_sz          = fd_sbpf_validated_program_footprint( elf_info );
+  ulong   cached_sz       = 0UL;
+  if( !fd_bpf_program_cache_query( prog_cache, &key, epoch, validated_prog, val_sz, &cached_sz ) ) {
+    validated_prog->calldests_shmem             = calldests_shmem;
+    validated_prog->rodata                      = rodata;
+    validated_prog->fuse                        = fuse;
+    validated_prog->last_epoch_verification_ran = epoch;
+    if( validated_prog->failed_verification ) {
+      validated_prog->calldests = NULL;
+      return -1;
+    }
+    if( FD_LIKELY( cached_sz==val_sz ) ) {
+      validated_prog->calldests = fd_sbpf_calldests_join( calldests_shmem );
+      return 0;
+    }
+    /* Should not happen as the elf info is a function of the key. Just validate from scratch. */
+    fd_sbpf_validated_program_new( validated_prog, elf_info );
+  }
+
+  int res = fd_bpf_validate_sbpf_program( slot_ctx, elf_info, program_data, program_data_len, runtime_spad, validated_prog );
+
+  /* When verification failed, only the header is meaningful. */
+  fd_bpf_program_cache_insert( prog_cache, &key, epoch, validated_prog, res ? sizeof(fd_sbpf_validated_program_t) : val_sz );
+  return res;
+}
+
 /* Publishes an in-prepare funk record for a program that failed verification. Creates a default
    sBPF validated program with the `failed_verification` flag set to 1. The passed-in funk record
    is expected to be in a prepare. */
@@ -376,8 +502,10 @@ fd_bpf_create_bpf_program_cache_entry( fd_exec_slot_ctx_t *     slot_ctx,
       FD_LOG_CRIT(( "fd_funk_rec_prepare() failed: %i-%s", funk_err, fd_funk_strerror( funk_err ) ));
     }
 
-    ulong         program_data_len = 0UL;
-    uchar const * program_data     = fd_bpf_get_programdata_from_account( funk, funk_txn, program_acc, &program_data_len, runtime_spad );
+    ulong                     program_data_len = 0UL;
+    ulong                     deploy_slot      = ULONG_MAX;
+    fd_account_meta_t const * programdata_meta = NULL;
+    uchar const *             program_data     = fd_bpf_get_programdata_and_deploy_slot( funk, funk_txn, program_acc, &program_data_len, &deploy_slot, &programdata_meta, runtime_spad );
 
     if( FD_UNLIKELY( program_data==NULL ) ) {
       fd_publish_failed_verification_rec( funk, prepare, rec );
@@ -404,7 +532,7 @@ fd_bpf_create_bpf_program_cache_entry( fd_exec_slot_ctx_t *     slot_ctx,
 
     /* Note that the validated program points to the funk record data and writes into the record directly to avoid an expensive memcpy. */
     fd_sbpf_validated_program_t * validated_prog = fd_sbpf_validated_program_new( val, &elf_info );
-    int res = fd_bpf_validate_sbpf_program( slot_ctx, &elf_info, program_data, program_data_len, runtime_spad, validated_prog );
+    int res = fd_bpf_validate_sbpf_program_cached( slot_ctx, program_pubkey, deploy_slot, programdata_meta, &elf_info, program_data, program_data_len, runtime_spad, validated_prog );
     if( FD_UNLIKELY( res ) ) {
       fd_publish_failed_verification_rec( funk, prepare, rec );
       return;
@@ -427,6 +555,10 @@ fd_bpf_check_and_create_bpf_program_cache_entry( fd_exec_slot_ctx_t * slot_ctx,
     return -1;
   }
 
+  /* Nothing is invalidated in the node-wide program cache here. Its entries are keyed by deployment slot
+     and programdata, so a modified program simply misses, while other forks that still run the previous
+     version keep hitting. Dead entries age out. */
+
   fd_bpf_create_bpf_program_cache_entry( slot_ctx, exec_rec, runtime_spad );
 
   return 0;
@@ -580,12 +712,16 @@ FD_SPAD_FRAME_BEGIN( runtime_spad ) {
   fd_sbpf_validated_program_t * modified_prog = (fd_sbpf_validated_program_t *)data;
 
   /* Get the program data from the account */
-  ulong         program_data_len = 0UL;
-  uchar const * program_data     = fd_bpf_get_programdata_from_account( slot_ctx->funk,
-                                                                        slot_ctx->funk_txn,
-                                                                        exec_rec,
-                                                                        &program_data_len,
-                                                                        runtime_spad );
+  ulong                     program_data_len = 0UL;
+  ulong                     deploy_slot      = ULONG_MAX;
+  fd_account_meta_t const * programdata_meta = NULL;
+  uchar const *             program_data     = fd_bpf_get_programdata_and_deploy_slot( slot_ctx->funk,
+                                                                                       slot_ctx->funk_txn,
+                                                                                       exec_rec,
+                                                                                       &program_data_len,
+                                                                                       &deploy_slot,
+                                                                                       &programdata_meta,
+                                                                                       runtime_spad );
   if( FD_UNLIKELY( program_data==NULL ) ) {
     modified_prog->failed_verification = 1;
     fd_funk_rec_modify_publish( query );
@@ -602,7 +738,7 @@ FD_SPAD_FRAME_BEGIN( runtime_spad ) {
   /* Validate the sBPF program. This will set the program's flags accordingly. The return code does not matter here because we publish
      regardless of the return code. */
   modified_prog = fd_sbpf_validated_program_new( data, &elf_info );
-  fd_bpf_validate_sbpf_program( slot_ctx, &elf_info, program_data, program_data_len, runtime_spad, modified_prog );
+  fd_bpf_validate_sbpf_program_cached( slot_ctx, program_pubkey, deploy_slot, programdata_meta, &elf_info, program_data, program_data_len, runtime_spad, modified_prog );
 
   if( modified_prog->failed_verification ) {
     FD_LOG_ERR(("program fialed veriifecation;"));
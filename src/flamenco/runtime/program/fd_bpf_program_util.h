@@ -36,6 +36,16 @@ struct fd_sbpf_validated_program {
    fd_sbpf_calldests_t * calldests;
    uchar *               rodata;
 
+   /* Superinstruction table of the text, indexed [0,text_cnt) (see
+      fd_vm_fuse_build).  Built once when the program is validated. */
+   uchar *               fuse;
+
+   /* Hash of the rodata (which includes the text) and calldests.  Tells
+      apart programs that end up at the same address (e.g. when a record
+      is revalidated in place) for fd_bpf_jit_cache.  Computed once when
+      the program is validated. */
+   ulong                 hash;
+
    /* SBPF version, SIMD-0161 */
    ulong sbpf_version;
 };
@@ -0,0 +1,258 @@
+#include "fd_bpf_program_cache.h"
+
+#define TEST_WKSP_TAG 1234UL
+
+static fd_bpf_program_cache_key_t
+test_key( uchar pubkey_byte,
+          ulong deploy_slot ) {
+  fd_bpf_program_cache_key_t key = {
+    .deploy_slot  = deploy_slot,
+    .feature_hash = 0x1234UL,
+    .data_hash    = 0x5678UL
+  };
+  memset( key.pubkey.uc, pubkey_byte, sizeof(fd_pubkey_t) );
+  return key;
+}
+
+static void
+test_val( uchar * val,
+          ulong   val_sz,
+          ulong   seed ) {
+  for( ulong i=0UL; i<val_sz; i++ ) val[ i ] = (uchar)fd_ulong_hash( seed+i );
+}
+
+static void
+test_basic( fd_bpf_program_cache_t * cache ) {
+  static uchar val[ 4096 ];
+  static uchar out[ 4096 ];
+  ulong        out_sz;
+
+  fd_bpf_program_cache_metrics_t const * metrics = fd_bpf_program_cache_metrics( cache );
+  ulong hit_cnt0  = metrics->hit_cnt;
+  ulong miss_cnt0 = metrics->miss_cnt;
+
+  fd_bpf_program_cache_key_t key = test_key( 1, 100UL );
+
+  /* Miss on an empty cache */
+  FD_TEST( fd_bpf_program_cache_query( cache, &key, 7UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+
+  /* Insert then hit */
+  test_val( val, 1000UL, 1UL );
+  FD_TEST( !fd_bpf_program_cache_insert( cache, &key, 7UL, val, 1000UL ) );
+  FD_TEST( fd_bpf_program_cache_entry_cnt( cache )==1UL    );
+  FD_TEST( fd_bpf_program_cache_byte_cnt ( cache )==1000UL );
+  out_sz = 0UL;
+  FD_TEST( !fd_bpf_program_cache_query( cache, &key, 7UL, out, sizeof(out), &out_sz ) );
+  FD_TEST( out_sz==1000UL );
+  FD_TEST( fd_memeq( out, val, 1000UL ) );
+
+  /* Wrong epoch, wrong deploy slot, wrong feature set, wrong data and
+     too small a buffer all miss */
+  FD_TEST( fd_bpf_program_cache_query( cache, &key, 8UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  fd_bpf_program_cache_key_t other = test_key( 1, 101UL );
+  FD_TEST( fd_bpf_program_cache_query( cache, &other, 7UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  other = key; other.feature_hash++;
+  FD_TEST( fd_bpf_program_cache_query( cache, &other, 7UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  other = key; other.data_hash++;
+  FD_TEST( fd_bpf_program_cache_query( cache, &other, 7UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  FD_TEST( fd_bpf_program_cache_query( cache, &key, 7UL, out, 999UL, &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+
+  FD_TEST( metrics->hit_cnt -hit_cnt0 ==1UL );
+  FD_TEST( metrics->miss_cnt-miss_cnt0==6UL );
+
+  /* Re-inserting replaces the value */
+  test_val( val, 2000UL, 2UL );
+  FD_TEST( !fd_bpf_program_cache_insert( cache, &key, 8UL, val, 2000UL ) );
+  FD_TEST( fd_bpf_program_cache_entry_cnt( cache )==1UL    );
+  FD_TEST( fd_bpf_program_cache_byte_cnt ( cache )==2000UL );
+  FD_TEST( fd_bpf_program_cache_query( cache, &key, 7UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  FD_TEST( !fd_bpf_program_cache_query( cache, &key, 8UL, out, sizeof(out), &out_sz ) );
+  FD_TEST( out_sz==2000UL );
+  FD_TEST( fd_memeq( out, val, 2000UL ) );
+
+  /* Invalidation drops every deployment of the program, and nothing
+     else */
+  fd_bpf_program_cache_key_t key2 = test_key( 1, 200UL );
+  fd_bpf_program_cache_key_t key3 = test_key( 2, 100UL );
+  FD_TEST( !fd_bpf_program_cache_insert( cache, &key2, 8UL, val, 100UL ) );
+  FD_TEST( !fd_bpf_program_cache_insert( cache, &key3, 8UL, val, 100UL ) );
+  FD_TEST( fd_bpf_program_cache_entry_cnt( cache )==3UL );
+  FD_TEST( fd_bpf_program_cache_invalidate( cache, &key.pubkey )==2UL );
+  FD_TEST( fd_bpf_program_cache_entry_cnt( cache )==1UL   );
+  FD_TEST( fd_bpf_program_cache_byte_cnt ( cache )==100UL );
+  FD_TEST( fd_bpf_program_cache_query( cache, &key,  8UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  FD_TEST( fd_bpf_program_cache_query( cache, &key2, 8UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  FD_TEST( !fd_bpf_program_cache_query( cache, &key3, 8UL, out, sizeof(out), &out_sz ) );
+  FD_TEST( fd_bpf_program_cache_invalidate( cache, &key.pubkey )==0UL );
+  FD_TEST( fd_bpf_program_cache_invalidate( cache, &key3.pubkey )==1UL );
+  FD_TEST( !fd_bpf_program_cache_entry_cnt( cache ) );
+  FD_TEST( !fd_bpf_program_cache_byte_cnt ( cache ) );
+
+  /* Too large to ever fit */
+  FD_TEST( fd_bpf_program_cache_insert( cache, &key, 8UL, val, fd_bpf_program_cache_byte_max( cache )+1UL )==FD_BPF_PROGRAM_CACHE_ERR_FULL );
+}
+
+/* test_lru fills the cache past its byte budget and checks that the
+   least recently used values are the ones that get evicted. */
+
+static void
+test_lru( fd_bpf_program_cache_t * cache ) {
+  static uchar val[ 4096 ];
+  static uchar out[ 4096 ];
+  ulong        out_sz;
+
+  ulong byte_max = fd_bpf_program_cache_byte_max( cache );
+  ulong val_sz   = 4096UL;
+  ulong fit_cnt  = byte_max / val_sz;
+  FD_TEST( fit_cnt>=4UL && fit_cnt<=fd_bpf_program_cache_entry_max( cache ) );
+
+  fd_bpf_program_cache_metrics_t const * metrics = fd_bpf_program_cache_metrics( cache );
+  ulong evict_cnt0 = metrics->evict_cnt;
+
+  for( ulong i=0UL; i<fit_cnt; i++ ) {
+    fd_bpf_program_cache_key_t key = test_key( 0x10, i );
+    test_val( val, val_sz, i );
+    FD_TEST( !fd_bpf_program_cache_insert( cache, &key, 1UL, val, val_sz ) );
+  }
+  FD_TEST( fd_bpf_program_cache_entry_cnt( cache )==fit_cnt );
+  FD_TEST( metrics->evict_cnt==evict_cnt0 );
+
+  /* Touch everything but the first value, then insert one more.  The
+     first value is the only candidate for eviction. */
+  for( ulong i=1UL; i<fit_cnt; i++ ) {
+    fd_bpf_program_cache_key_t key = test_key( 0x10, i );
+    FD_TEST( !fd_bpf_program_cache_query( cache, &key, 1UL, out, sizeof(out), &out_sz ) );
+    test_val( val, val_sz, i );
+    FD_TEST( fd_memeq( out, val, val_sz ) );
+  }
+  fd_bpf_program_cache_key_t key = test_key( 0x10, fit_cnt );
+  FD_TEST( !fd_bpf_program_cache_insert( cache, &key, 1UL, val, val_sz ) );
+  FD_TEST( metrics->evict_cnt==evict_cnt0+1UL );
+  FD_TEST( fd_bpf_program_cache_entry_cnt( cache )==fit_cnt );
+  FD_TEST( fd_bpf_program_cache_byte_cnt ( cache )<=byte_max );
+
+  key = test_key( 0x10, 0UL );
+  FD_TEST( fd_bpf_program_cache_query( cache, &key, 1UL, out, sizeof(out), &out_sz )==FD_BPF_PROGRAM_CACHE_ERR_KEY );
+  for( ulong i=1UL; i<=fit_cnt; i++ ) {
+    key = test_key( 0x10, i );
+    FD_TEST( !fd_bpf_program_cache_query( cache, &key, 1UL, out, sizeof(out), &out_sz ) );
+  }
+
+  FD_TEST( fd_bpf_program_cache_invalidate( cache, &key.pubkey )==fit_cnt );
+  FD_TEST( !fd_bpf_program_cache_byte_cnt( cache ) );
+}
+
+/* test_sets inserts many more small values than the cache has entries
+   and checks the entry count never exceeds the capacity and that the
+   most recent insert is always retrievable. */
+
+static void
+test_sets( fd_bpf_program_cache_t * cache ) {
+  uchar val[ 64 ];
+  uchar out[ 64 ];
+  ulong out_sz;
+
+  ulong entry_max = fd_bpf_program_cache_entry_max( cache );
+  for( ulong i=0UL; i<8UL*entry_max; i++ ) {
+    fd_bpf_program_cache_key_t key = test_key( (uchar)i, i );
+    test_val( val, sizeof(val), i );
+    FD_TEST( !fd_bpf_program_cache_insert( cache, &key, 3UL, val, sizeof(val) ) );
+    FD_TEST( !fd_bpf_program_cache_query( cache, &key, 3UL, out, sizeof(out), &out_sz ) );
+    FD_TEST( out_sz==sizeof(val) && fd_memeq( out, val, sizeof(val) ) );
+    FD_TEST( fd_bpf_program_cache_entry_cnt( cache )<=entry_max );
+    FD_TEST( fd_bpf_program_cache_byte_cnt ( cache )==fd_bpf_program_cache_entry_cnt( cache )*sizeof(val) );
+  }
+  FD_TEST( fd_bpf_program_cache_entry_cnt( cache )>entry_max/2UL );
+}
+
+static void
+test_feature_hash( void ) {
+  fd_features_t features[1];
+  fd_features_disable_all( features );
+
+  ulong h0 = fd_bpf_program_cache_feature_hash( 1000UL, features );
+  FD_TEST( fd_bpf_program_cache_feature_hash( 0UL, features )==h0 );
+
+  /* Activating a feature in the future does not change the hash until
+     the feature is active */
+  features->f[ 3 ] = 500UL;
+  FD_TEST( fd_bpf_program_cache_feature_hash(  499UL, features )==h0 );
+  ulong h1 = fd_bpf_program_cache_feature_hash( 500UL, features );
+  FD_TEST( h1!=h0 );
+  FD_TEST( fd_bpf_program_cache_feature_hash( 1000UL, features )==h1 );
+
+  /* Every feature matters */
+  for( ulong i=0UL; i<FD_FEATURE_ID_CNT; i++ ) {
+    fd_features_disable_all( features );
+    features->f[ i ] = 0UL;
+    FD_TEST( fd_bpf_program_cache_feature_hash( 1000UL, features )!=h0 );
+  }
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL, "gigantic"                   );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL, 1UL                          );
+  ulong        numa_idx = fd_env_strip_cmdline_ulong( &argc, &argv, "--numa-idx", NULL, fd_shmem_numa_idx( 0 )       );
+
+  ulong page_sz = fd_cstr_to_shmem_page_sz( _page_sz );
+  if( FD_UNLIKELY( !page_sz ) ) FD_LOG_ERR(( "unsupported --page-sz" ));
+
+  FD_LOG_NOTICE(( "Creating workspace (--page-cnt %lu, --page-sz %s, --numa-idx %lu)", page_cnt, _page_sz, numa_idx ));
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( page_sz, page_cnt, fd_shmem_cpu_idx( numa_idx ), "wksp", 4096UL );
+  FD_TEST( wksp );
+
+  ulong entry_max = 1024UL;
+  ulong byte_max  = 16UL*4096UL;
+
+  FD_TEST( fd_bpf_program_cache_align()==FD_BPF_PROGRAM_CACHE_ALIGN );
+  FD_TEST( !fd_bpf_program_cache_footprint( 0UL ) );
+  FD_TEST( fd_bpf_program_cache_footprint( 1UL )==fd_bpf_program_cache_footprint( FD_BPF_PROGRAM_CACHE_WAY_CNT ) );
+  ulong footprint = fd_bpf_program_cache_footprint( entry_max );
+  FD_TEST( footprint );
+
+  void * shmem = fd_wksp_alloc_laddr( wksp, fd_bpf_program_cache_align(), footprint, TEST_WKSP_TAG );
+  FD_TEST( shmem );
+
+  FD_TEST( !fd_bpf_program_cache_new( NULL,        entry_max, byte_max, TEST_WKSP_TAG+1UL ) );
+  FD_TEST( !fd_bpf_program_cache_new( shmem,       0UL,       byte_max, TEST_WKSP_TAG+1UL ) );
+  FD_TEST( !fd_bpf_program_cache_new( shmem,       entry_max, 0UL,      TEST_WKSP_TAG+1UL ) );
+  FD_TEST( !fd_bpf_program_cache_new( shmem,       entry_max, byte_max, 0UL               ) );
+  FD_TEST( !fd_bpf_program_cache_join( shmem ) );
+
+  fd_bpf_program_cache_t * cache = fd_bpf_program_cache_join( fd_bpf_program_cache_new( shmem, entry_max, byte_max, TEST_WKSP_TAG+1UL ) );
+  FD_TEST( cache );
+  FD_TEST( fd_bpf_program_cache_entry_max( cache )==entry_max );
+  FD_TEST( fd_bpf_program_cache_byte_max ( cache )==byte_max  );
+
+  test_basic( cache );
+  test_lru( cache );
+  test_sets( cache );
+  test_feature_hash();
+
+  fd_bpf_program_cache_metrics_t const * metrics = fd_bpf_program_cache_metrics( cache );
+  FD_LOG_NOTICE(( "hit %lu miss %lu insert %lu insert_fail %lu evict %lu invalidate %lu",
+                  metrics->hit_cnt, metrics->miss_cnt, metrics->insert_cnt, metrics->insert_fail_cnt,
+                  metrics->evict_cnt, metrics->invalidate_cnt ));
+
+  /* delete frees the values */
+  FD_TEST( fd_bpf_program_cache_leave( cache )==shmem );
+  FD_TEST( fd_bpf_program_cache_delete( shmem )==shmem );
+  FD_TEST( !fd_bpf_program_cache_join( shmem ) );
+  fd_wksp_usage_t usage[1];
+  ulong tag = TEST_WKSP_TAG+1UL;
+  fd_wksp_usage( wksp, &tag, 1UL, usage );
+  FD_TEST( !usage->used_cnt );
+
+  fd_wksp_free_laddr( shmem );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#undef TEST_WKSP_TAG
@@ -1,4 +1,5 @@
 #include "fd_bpf_program_util.h"
+#include "fd_bpf_program_cache.h"
 #include "../../../util/fd_util.h"
 
 #if FD_HAS_HOSTED
@@ -242,6 +243,89 @@ test_program_in_cache_needs_reverification( void ) {
   fd_funk_txn_cancel( test_funk, funk_txn, 0 );
 }
 
+/* Test 6: Programs validated on one fork are reused by other forks through the shared program cache */
+static void
+test_shared_program_cache_across_forks( void ) {
+  FD_LOG_NOTICE(( "Testing: Programs validated on one fork are reused by other forks through the shared program cache" ));
+
+  ulong  prog_cache_footprint = fd_bpf_program_cache_footprint( 64UL );
+  void * prog_cache_mem       = fd_wksp_alloc_laddr( test_wksp, fd_bpf_program_cache_align(), prog_cache_footprint, TEST_WKSP_TAG );
+  FD_TEST( prog_cache_mem );
+  fd_bpf_program_cache_t * prog_cache = fd_bpf_program_cache_join( fd_bpf_program_cache_new( prog_cache_mem, 64UL, 64UL<<20, TEST_WKSP_TAG+1UL ) );
+  FD_TEST( prog_cache );
+  test_slot_ctx->prog_cache = prog_cache;
+
+  fd_bpf_program_cache_metrics_t const * metrics = fd_bpf_program_cache_metrics( prog_cache );
+
+  /* The first fork validates the program and publishes it */
+  fd_funk_txn_t * funk_txn0 = create_test_funk_txn();
+  test_slot_ctx->funk_txn = funk_txn0;
+  create_test_account( &test_program_pubkey,
+                       &fd_solana_bpf_loader_program_id,
+                       valid_program_data,
+                       valid_program_data_sz,
+                       1 );
+  fd_bpf_program_update_program_cache( test_slot_ctx, &test_program_pubkey, test_spad );
+  FD_TEST( metrics->hit_cnt==0UL && metrics->insert_cnt==1UL );
+
+  /* A sibling fork with the same program picks up the validated program
+     from the shared cache instead of validating it again */
+  fd_funk_txn_t * funk_txn1 = create_test_funk_txn();
+  test_slot_ctx->funk_txn = funk_txn1;
+  create_test_account( &test_program_pubkey,
+                       &fd_solana_bpf_loader_program_id,
+                       valid_program_data,
+                       valid_program_data_sz,
+                       1 );
+  fd_bpf_program_update_program_cache( test_slot_ctx, &test_program_pubkey, test_spad );
+  FD_TEST( metrics->hit_cnt==1UL && metrics->insert_cnt==1UL );
+
+  fd_sbpf_validated_program_t const * prog0 = NULL;
+  fd_sbpf_validated_program_t const * prog1 = NULL;
+  FD_TEST( !fd_bpf_load_cache_entry( test_funk, funk_txn0, &test_program_pubkey, &prog0 ) );
+  FD_TEST( !fd_bpf_load_cache_entry( test_funk, funk_txn1, &test_program_pubkey, &prog1 ) );
+  FD_TEST( prog0!=prog1 );
+  FD_TEST( !prog1->failed_verification );
+  FD_TEST( prog1->last_epoch_verification_ran==prog0->last_epoch_verification_ran );
+  FD_TEST( prog1->entry_pc    ==prog0->entry_pc     );
+  FD_TEST( prog1->text_cnt    ==prog0->text_cnt     );
+  FD_TEST( prog1->text_off    ==prog0->text_off     );
+  FD_TEST( prog1->text_sz     ==prog0->text_sz      );
+  FD_TEST( prog1->rodata_sz   ==prog0->rodata_sz    );
+  FD_TEST( prog1->sbpf_version==prog0->sbpf_version );
+  FD_TEST( fd_memeq( prog1->rodata, prog0->rodata, prog0->rodata_sz ) );
+
+  /* The copy must point into its own record */
+  FD_TEST( (ulong)prog1->rodata         >(ulong)prog1 );
+  FD_TEST( (ulong)prog1->calldests_shmem>(ulong)prog1 );
+  for( ulong i=0UL; i<prog0->text_cnt; i++ ) {
+    FD_TEST( fd_sbpf_calldests_test( prog1->calldests, i )==fd_sbpf_calldests_test( prog0->calldests, i ) );
+  }
+
+  /* A different program at the same address (e.g. after an upgrade)
+     never matches */
+  fd_funk_txn_t * funk_txn2 = create_test_funk_txn();
+  test_slot_ctx->funk_txn = funk_txn2;
+  create_test_account( &test_program_pubkey,
+                       &fd_solana_bpf_loader_program_id,
+                       invalid_program_data,
+                       sizeof(invalid_program_data),
+                       1 );
+  fd_bpf_program_update_program_cache( test_slot_ctx, &test_program_pubkey, test_spad );
+  FD_TEST( metrics->hit_cnt==1UL );
+
+  /* Invalidation drops the program */
+  FD_TEST( fd_bpf_program_cache_invalidate( prog_cache, &test_program_pubkey )==1UL );
+  FD_TEST( !fd_bpf_program_cache_entry_cnt( prog_cache ) );
+
+  fd_funk_txn_cancel( test_funk, funk_txn2, 0 );
+  fd_funk_txn_cancel( test_funk, funk_txn1, 0 );
+  fd_funk_txn_cancel( test_funk, funk_txn0, 0 );
+
+  test_slot_ctx->prog_cache = NULL;
+  fd_wksp_free_laddr( fd_bpf_program_cache_delete( fd_bpf_program_cache_leave( prog_cache ) ) );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -314,6 +398,7 @@ main( int     argc,
     test_invalid_program_not_in_cache_first_time();
     test_valid_program_not_in_cache_first_time();
     test_program_in_cache_needs_reverification();
+    test_shared_program_cache_across_forks();
   } FD_SPAD_FRAME_END;
 
   test_teardown();
@@ -0,0 +1,312 @@
+/* test_jit_exec checks that replaying a block with sBPF programs run
+   under the jit (slot_ctx->jit_caches) commits the same state as
+   running them on the interpreter.  The same workload of signed
+   transactions invoking a deployed program is executed against
+   identical freshly created slot states, on the interpreter, under the
+   jit one transaction per microblock, and under the jit speculatively
+   (fd_runtime_process_txns_speculative), and the resulting bank
+   hashes, bank fee and signature counters, transaction outcomes and
+   account states are compared.
+
+   Every program invocation is followed by a transfer in the same
+   transaction, such that the outcome of the invocation shows up in the
+   committed state.  A sweep of transactions with compute unit limits
+   around the cost of the invocation checks that the jit meters compute
+   units exactly like the interpreter: the sweep transfers 2^k lamports
+   to a sink iff transaction k succeeded, such that the sink balance is
+   the bitmask of the successful transactions.
+
+   Needs at least 3 tiles (e.g. --tile-cpus f5). */
+
+#define PAYER_CNT      (8UL)
+#define ROUND_CNT      (4UL)
+#define SWEEP_CNT      (32UL)
+#define SWEEP_CU0      (12084UL) /* sweep transactions cost 12100 compute units */
+#define SWEEP_CU       (1UL)
+#define TXN_MAX        (128UL)
+#define STATE_ACCT_CNT (2UL*PAYER_CNT+1UL)
+
+#include "test_runtime_common.h"
+#include "program/fd_bpf_jit_cache.h"
+#include "program/fd_system_program.h"
+#include "../txn/fd_txn_generate.h"
+
+FD_IMPORT_BINARY( program_elf, "src/ballet/sbpf/fixtures/hello_solana_program.so" );
+
+#define JIT_ENTRY_MAX   (2UL)
+#define JIT_TEXT_MAX    (1UL<<14)
+
+/* Accounts of the workload */
+
+static test_key_t payer[ PAYER_CNT ];  /* well funded fee payers */
+static test_key_t recv [ PAYER_CNT ];  /* transfer destinations */
+static test_key_t sink;                /* destination of the sweep */
+static test_key_t program;             /* the deployed program */
+
+static fd_hash_t blockhash;            /* only entry of the blockhash queue */
+
+static fd_txn_p_t txns_ref[ TXN_MAX ];
+static ulong      txn_cnt;
+static ulong      invoke_cnt;          /* program instructions of the workload */
+
+static fd_pubkey_t state_accts[ STATE_ACCT_CNT ]; /* compared after a run */
+
+/* test_accts_create creates the program, deployed with the (non
+   upgradeable) BPF loader v2, and the accounts of the workload in
+   env. */
+
+static void
+test_accts_create( test_env_t * env ) {
+  test_acct_create( env, &program.pub, &fd_solana_bpf_loader_program_id, 1, 1000000000UL, program_elf, program_elf_sz );
+  for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+    test_acct_create( env, &payer[ i ].pub, &fd_solana_system_program_id, 0, 10000000000UL, NULL, 0UL );
+    test_acct_create( env, &recv [ i ].pub, &fd_solana_system_program_id, 0,  1000000000UL, NULL, 0UL );
+  }
+  test_acct_create( env, &sink.pub, &fd_solana_system_program_id, 0, 1000000000UL, NULL, 0UL );
+}
+
+/* Workload **********************************************************/
+
+/* test_invoke adds a transaction of fee payer key that sets the compute
+   unit limit to cu_limit (if non-zero), invokes the program instr_cnt
+   times and then transfers lamports from key to dst. */
+
+static void
+test_invoke( test_key_t const *  key,
+             ulong               cu_limit,
+             ulong               instr_cnt,
+             fd_pubkey_t const * dst,
+             ulong               lamports,
+             fd_sha512_t *       sha ) {
+  FD_TEST( txn_cnt<TXN_MAX );
+  fd_txn_p_t * txn = &txns_ref[ txn_cnt ];
+  memset( txn, 0, sizeof(fd_txn_p_t) );
+
+  /* 0: key, 1: dst, 2: program, 3: system program, 4: compute budget */
+
+  fd_pubkey_t signer[1] = { key->pub };
+  fd_pubkey_t w[1]      = { *dst };
+  fd_pubkey_t r[3]      = { program.pub, fd_solana_system_program_id, fd_solana_compute_budget_program_id };
+  fd_txn_accounts_t accts = {
+    .signature_cnt         = 1,
+    .readonly_signed_cnt   = 0,
+    .readonly_unsigned_cnt = 3,
+    .acct_cnt              = 5,
+    .signers_w             = signer,
+    .signers_r             = NULL,
+    .non_signers_w         = w,
+    .non_signers_r         = r
+  };
+  txn->payload_sz = fd_txn_base_generate( txn->_, txn->payload, 1UL, &accts, blockhash.uc );
+  FD_TEST( txn->payload_sz );
+
+  if( cu_limit ) {
+    uchar set_cu_limit[5] = { 2 }; /* SetComputeUnitLimit */
+    FD_STORE( uint, set_cu_limit+1, (uint)cu_limit );
+    txn->payload_sz = fd_txn_add_instr( txn->_, txn->payload, 4, NULL, 0UL, set_cu_limit, sizeof(set_cu_limit) );
+  }
+
+  for( ulong i=0UL; i<instr_cnt; i++ ) {
+    uchar data[1] = { (uchar)i };
+    txn->payload_sz = fd_txn_add_instr( txn->_, txn->payload, 2, NULL, 0UL, data, sizeof(data) );
+  }
+  invoke_cnt += instr_cnt;
+
+  fd_system_program_instruction_t instr = { .discriminant = fd_system_program_instruction_enum_transfer, .inner = { .transfer = lamports } };
+  uchar                   buf[ 64 ];
+  fd_bincode_encode_ctx_t encode = { .data = buf, .dataend = buf+sizeof(buf) };
+  FD_TEST( !fd_system_program_instruction_encode( &instr, &encode ) );
+  uchar acct_idx[2] = { 0, 1 };
+  txn->payload_sz = fd_txn_add_instr( txn->_, txn->payload, 3, acct_idx, 2UL, buf, (ulong)encode.data-(ulong)buf );
+
+  test_txn_sign( txn, key, sha );
+  txn_cnt++;
+}
+
+static void
+test_workload( fd_sha512_t * sha ) {
+  txn_cnt    = 0UL;
+  invoke_cnt = 0UL;
+  for( ulong r=0UL; r<ROUND_CNT; r++ ) {
+    for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+      test_invoke( &payer[ i ], 0UL, 1UL+(i+r)%3UL, &recv[ i ].pub, 1000UL*(r+1UL)+i, sha );
+    }
+  }
+
+  /* Compute unit limit sweep */
+  for( ulong k=0UL; k<SWEEP_CNT; k++ ) {
+    test_invoke( &payer[ k%PAYER_CNT ], SWEEP_CU0+SWEEP_CU*k, 1UL, &sink.pub, 1UL<<k, sha );
+  }
+}
+
+/* Execution *********************************************************/
+
+/* test_run executes the workload in a fresh slot state, one
+   transaction per microblock if metrics_opt is NULL and speculatively
+   otherwise, under the jit if jit, and records the outcome into result
+   and the jit cache counters (summed over the workers) into
+   jit_metrics. */
+
+static void
+test_run( fd_wksp_t *                  wksp,
+          fd_tpool_t *                 tpool,
+          ulong                        exec_spad_cnt,
+          int                          jit,
+          fd_runtime_spec_metrics_t *  metrics_opt,
+          test_result_t *              result,
+          fd_bpf_jit_cache_metrics_t * jit_metrics ) {
+  test_env_t env[1] = {{ .wksp = wksp }};
+  test_env_init( env, &blockhash );
+  test_accts_create( env );
+  test_env_fork( env );
+
+  /* Worker 0 dispatches the transactions and never executes any */
+
+  fd_bpf_jit_cache_t * jit_caches[ EXEC_SPAD_MAX ] = {0};
+  if( jit ) {
+    for( ulong i=1UL; i<exec_spad_cnt; i++ ) {
+      void * mem = fd_wksp_alloc_laddr( wksp, fd_bpf_jit_cache_align(), fd_bpf_jit_cache_footprint( JIT_ENTRY_MAX, JIT_TEXT_MAX ), WKSP_TAG );
+      jit_caches[ i ] = fd_bpf_jit_cache_join( fd_bpf_jit_cache_new( mem, JIT_ENTRY_MAX, JIT_TEXT_MAX ) );
+      FD_TEST( jit_caches[ i ] );
+    }
+    env->slot_ctx->jit_caches = jit_caches;
+  }
+
+  static fd_txn_p_t txns[ TXN_MAX ];
+  memcpy( txns, txns_ref, txn_cnt*sizeof(fd_txn_p_t) );
+
+  test_exec( env, txns, txn_cnt, tpool, exec_spad_cnt, metrics_opt );
+  test_result_fill( env, txns, txn_cnt, state_accts, tpool, result );
+
+  memset( jit_metrics, 0, sizeof(fd_bpf_jit_cache_metrics_t) );
+  for( ulong i=0UL; i<EXEC_SPAD_MAX; i++ ) {
+    if( !jit_caches[ i ] ) continue;
+    fd_bpf_jit_cache_metrics_t const * m = fd_bpf_jit_cache_metrics( jit_caches[ i ] );
+    jit_metrics->hit_cnt          += m->hit_cnt;
+    jit_metrics->compile_cnt      += m->compile_cnt;
+    jit_metrics->compile_fail_cnt += m->compile_fail_cnt;
+    jit_metrics->evict_cnt        += m->evict_cnt;
+    jit_metrics->flush_cnt        += m->flush_cnt;
+    jit_metrics->interp_cnt       += m->interp_cnt;
+    FD_TEST( fd_bpf_jit_cache_delete( fd_bpf_jit_cache_leave( jit_caches[ i ] ) ) );
+  }
+
+  test_env_fini( env );
+}
+
+static void
+test_log_jit( char const *                       name,
+              fd_bpf_jit_cache_metrics_t const * m ) {
+  FD_LOG_NOTICE(( "%s: runs %lu interpreted %lu compiles %lu compile failures %lu evictions %lu flushes %lu", name,
+                  m->hit_cnt, m->interp_cnt, m->compile_cnt, m->compile_fail_cnt, m->evict_cnt, m->flush_cnt ));
+}
+
+static uchar tpool_mem[ FD_TPOOL_FOOTPRINT( EXEC_SPAD_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  fd_flamenco_boot( &argc, &argv );
+
+  ulong exec_spad_cnt = fd_ulong_min( fd_tile_cnt(), EXEC_SPAD_MAX );
+  if( FD_UNLIKELY( exec_spad_cnt<3UL ) ) {
+    FD_LOG_WARNING(( "skip: unit test requires at least 3 tiles" ));
+    fd_flamenco_halt();
+    fd_halt();
+    return 0;
+  }
+
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, exec_spad_cnt, 0UL );
+  FD_TEST( tpool );
+  for( ulong i=1UL; i<exec_spad_cnt; i++ ) FD_TEST( fd_tpool_worker_push( tpool, i ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+  ulong page_cnt = fd_ulong_align_up( test_wksp_footprint( EXEC_SPAD_MAX*( fd_bpf_jit_cache_footprint( JIT_ENTRY_MAX, JIT_TEXT_MAX ) + fd_bpf_jit_cache_align() ) ), FD_SHMEM_NORMAL_PAGE_SZ ) / FD_SHMEM_NORMAL_PAGE_SZ;
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( FD_SHMEM_NORMAL_PAGE_SZ, page_cnt, fd_shmem_cpu_idx( fd_shmem_numa_idx( cpu_idx ) ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  fd_rng_t    _rng[1]; fd_rng_t    * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+  fd_sha512_t _sha[1]; fd_sha512_t * sha = fd_sha512_join( fd_sha512_new( _sha ) );
+
+  for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+    test_key_init( &payer[ i ], rng, sha );
+    test_key_init( &recv [ i ], rng, sha );
+  }
+  test_key_init( &sink,    rng, sha );
+  test_key_init( &program, rng, sha );
+  for( ulong i=0UL; i<32UL; i++ ) blockhash.uc[ i ] = fd_rng_uchar( rng );
+
+  ulong j = 0UL;
+  for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+    state_accts[ j++ ] = payer[ i ].pub;
+    state_accts[ j++ ] = recv [ i ].pub;
+  }
+  state_accts[ j++ ] = sink.pub;
+  FD_TEST( j==STATE_ACCT_CNT );
+
+  test_workload( sha );
+  FD_LOG_NOTICE(( "%lu txns, %lu program instructions, %lu exec spads", txn_cnt, invoke_cnt, exec_spad_cnt ));
+
+  static test_result_t       interp    [1];
+  static test_result_t       jit_serial[1];
+  static test_result_t       jit_spec  [1];
+  fd_bpf_jit_cache_metrics_t interp_jit[1];
+  fd_bpf_jit_cache_metrics_t serial_jit[1];
+  fd_bpf_jit_cache_metrics_t spec_jit  [1];
+  fd_runtime_spec_metrics_t  metrics   [1] = {{0}};
+
+  test_run( wksp, tpool, 2UL,           0, NULL,    interp,     interp_jit );
+  test_run( wksp, tpool, 2UL,           1, NULL,    jit_serial, serial_jit );
+  test_run( wksp, tpool, exec_spad_cnt, 1, metrics, jit_spec,   spec_jit   );
+
+  test_log_jit( "serial",      serial_jit );
+  test_log_jit( "speculative", spec_jit   );
+
+  /* The jit committed the same state as the interpreter */
+
+  test_result_eq( interp, jit_serial, txn_cnt );
+  test_result_eq( interp, jit_spec,   txn_cnt );
+
+  /* The workload exercised what it is meant to.  All transactions
+     executed and the sweep succeeded iff its compute unit limit was
+     large enough. */
+
+  ulong executed_cnt = 0UL;
+  for( ulong i=0UL; i<txn_cnt; i++ ) executed_cnt += !!( interp->flags[ i ] & FD_TXN_P_FLAGS_EXECUTE_SUCCESS );
+  FD_TEST( executed_cnt==txn_cnt );
+  FD_TEST( interp->execution_fees==5000UL*txn_cnt );
+
+  for( ulong i=0UL; i<PAYER_CNT; i++ ) FD_TEST( interp->acct[ 2UL*i+1UL ].lamports!=1000000000UL );
+
+  ulong sweep_mask = interp->acct[ 2UL*PAYER_CNT ].lamports - 1000000000UL;
+  FD_LOG_NOTICE(( "sweep mask %016lx", sweep_mask ));
+  FD_TEST( sweep_mask && sweep_mask<(1UL<<SWEEP_CNT)-1UL );
+  FD_TEST( fd_ulong_is_pow2( (1UL<<SWEEP_CNT)-sweep_mask ) ); /* the transactions k>=some b */
+
+  /* Every program instruction ran under the jit, compiled once per
+     worker */
+
+  FD_TEST( !serial_jit->interp_cnt && !serial_jit->compile_fail_cnt );
+  FD_TEST( !serial_jit->evict_cnt  && !serial_jit->flush_cnt        );
+  FD_TEST( serial_jit->compile_cnt==1UL        );
+  FD_TEST( serial_jit->hit_cnt    ==invoke_cnt );
+
+  FD_TEST( !spec_jit->interp_cnt && !spec_jit->compile_fail_cnt );
+  FD_TEST( !spec_jit->evict_cnt  && !spec_jit->flush_cnt        );
+  FD_TEST( spec_jit->compile_cnt>=1UL && spec_jit->compile_cnt<exec_spad_cnt );
+  FD_TEST( spec_jit->hit_cnt    >=invoke_cnt );
+
+  FD_LOG_NOTICE(( "bank hash %s", FD_BASE58_ENC_32_ALLOCA( interp->bank_hash.uc ) ));
+
+  fd_sha512_delete( fd_sha512_leave( sha ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_wksp_delete_anonymous( wksp );
+  fd_tpool_fini( tpool );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_flamenco_halt();
+  fd_halt();
+  return 0;
+}
@@ -0,0 +1,363 @@
+#ifndef HEADER_fd_src_flamenco_runtime_test_runtime_common_h
+#define HEADER_fd_src_flamenco_runtime_test_runtime_common_h
+
+/* test_runtime_common.h provides the slot state for runtime unit tests
+   that execute blocks of signed transactions and compare the committed
+   state of different runs.  A run goes like:
+
+     test_env_init( env, &blockhash );       bank, funk, sysvars, ...
+     test_acct_create( env, ... );           accounts of the workload
+     test_env_fork( env );                   slot the workload runs in
+     test_exec( env, txns, txn_cnt, ... );
+     test_result_fill( env, txns, txn_cnt, accts, tpool, result );
+     test_env_fini( env );
+
+   The including test defines TXN_MAX (largest workload) and
+   STATE_ACCT_CNT (accounts compared after a run) first. */
+
+#include "fd_runtime.h"
+#include "fd_hashes.h"
+#include "fd_system_ids.h"
+#include "../fd_flamenco.h"
+#include "context/fd_exec_slot_ctx.h"
+#include "program/fd_builtin_programs.h"
+#include "sysvar/fd_sysvar_clock.h"
+#include "sysvar/fd_sysvar_epoch_schedule.h"
+#include "sysvar/fd_sysvar_last_restart_slot.h"
+#include "sysvar/fd_sysvar_recent_hashes.h"
+#include "sysvar/fd_sysvar_rent.h"
+#include "sysvar/fd_sysvar_slot_hashes.h"
+#include "../../ballet/ed25519/fd_ed25519.h"
+#include "../../disco/pack/fd_pack.h"
+
+#define SLOT            (10UL)
+#define EXEC_SPAD_MAX   (5UL)
+#define EXEC_SPAD_SZ    (256UL<<20)
+#define RUNTIME_SPAD_SZ (128UL<<20)
+#define FUNK_TXN_MAX    (4UL)
+#define FUNK_REC_MAX    (4096UL)
+#define WKSP_TAG        (1UL)
+
+struct test_key {
+  uchar       priv[ 32 ];
+  fd_pubkey_t pub;
+};
+typedef struct test_key test_key_t;
+
+/* State observed after a run */
+
+struct test_acct_state {
+  ulong lamports;
+  uchar digest[ 32 ]; /* sha256 of owner, data */
+};
+typedef struct test_acct_state test_acct_state_t;
+
+struct test_result {
+  fd_hash_t         bank_hash;
+  ulong             execution_fees;
+  ulong             priority_fees;
+  ulong             signature_cnt;
+  uint              flags[ TXN_MAX ];
+  test_acct_state_t acct [ STATE_ACCT_CNT ];
+};
+typedef struct test_result test_result_t;
+
+/* Slot state */
+
+struct test_env {
+  fd_wksp_t *          wksp;
+  fd_funk_t            funk[1];
+  fd_funk_txn_t *      setup_txn;
+  fd_exec_slot_ctx_t * slot_ctx;
+  fd_spad_t *          runtime_spad;
+  fd_spad_t *          exec_spads[ EXEC_SPAD_MAX ];
+};
+typedef struct test_env test_env_t;
+
+/* test_wksp_footprint returns the wksp size a test_env_t needs, plus
+   extra_sz for whatever else the test allocates from it. */
+
+static ulong
+test_wksp_footprint( ulong extra_sz ) {
+  return fd_banks_footprint( 1UL ) + fd_banks_align()
+       + fd_funk_footprint( FUNK_TXN_MAX, FUNK_REC_MAX ) + fd_funk_align()
+       + FD_EXEC_SLOT_CTX_FOOTPRINT + FD_EXEC_SLOT_CTX_ALIGN
+       + FD_SPAD_FOOTPRINT( RUNTIME_SPAD_SZ ) + FD_SPAD_ALIGN
+       + EXEC_SPAD_MAX*( FD_SPAD_FOOTPRINT( EXEC_SPAD_SZ ) + FD_SPAD_ALIGN )
+       + extra_sz
+       + (64UL<<20); /* funk records and wksp overhead */
+}
+
+static void
+test_key_init( test_key_t *  key,
+               fd_rng_t *    rng,
+               fd_sha512_t * sha ) {
+  for( ulong i=0UL; i<32UL; i++ ) key->priv[ i ] = fd_rng_uchar( rng );
+  fd_ed25519_public_from_private( key->pub.uc, key->priv, sha );
+}
+
+static void
+test_acct_create( test_env_t *        env,
+                  fd_pubkey_t const * pubkey,
+                  fd_pubkey_t const * owner,
+                  int                 executable,
+                  ulong               lamports,
+                  uchar const *       data,
+                  ulong               data_sz ) {
+  fd_exec_slot_ctx_t * slot_ctx = env->slot_ctx;
+  FD_TXN_ACCOUNT_DECL( acc );
+  FD_TEST( fd_txn_account_init_from_funk_mutable( acc, pubkey, slot_ctx->funk, slot_ctx->funk_txn, 1, data_sz )==FD_ACC_MGR_SUCCESS );
+  if( data_sz ) acc->vt->set_data( acc, data, data_sz );
+  acc->starting_lamports = lamports;
+  acc->starting_dlen     = data_sz;
+  acc->vt->set_lamports  ( acc, lamports );
+  acc->vt->set_executable( acc, executable );
+  acc->vt->set_rent_epoch( acc, ULONG_MAX );
+  acc->vt->set_owner     ( acc, owner );
+  acc->vt->set_readonly  ( acc );
+  fd_txn_account_mutable_fini( acc, slot_ctx->funk, slot_ctx->funk_txn );
+}
+
+/* test_env_init creates the state of slot SLOT in env->wksp (which
+   should be empty): a bank and a funk transaction holding the builtins
+   and sysvars, with blockhash as the only entry of the blockhash queue.
+   Accounts created with test_acct_create until test_env_fork go into
+   that funk transaction. */
+
+static void
+test_env_init( test_env_t *      env,
+               fd_hash_t const * blockhash ) {
+  fd_wksp_t * wksp = env->wksp;
+
+  void *       banks_mem = fd_wksp_alloc_laddr( wksp, fd_banks_align(), fd_banks_footprint( 1UL ), WKSP_TAG );
+  fd_banks_t * banks     = fd_banks_join( fd_banks_new( banks_mem, 1UL ) );
+  FD_TEST( banks );
+  fd_bank_t *  bank      = fd_banks_init_bank( banks, SLOT );
+  FD_TEST( bank );
+
+  void * funk_mem = fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint( FUNK_TXN_MAX, FUNK_REC_MAX ), WKSP_TAG );
+  FD_TEST( fd_funk_join( env->funk, fd_funk_new( funk_mem, WKSP_TAG, 1234UL, FUNK_TXN_MAX, FUNK_REC_MAX ) ) );
+
+  void * runtime_spad_mem = fd_wksp_alloc_laddr( wksp, FD_SPAD_ALIGN, FD_SPAD_FOOTPRINT( RUNTIME_SPAD_SZ ), WKSP_TAG );
+  env->runtime_spad = fd_spad_join( fd_spad_new( runtime_spad_mem, RUNTIME_SPAD_SZ ) );
+  FD_TEST( env->runtime_spad );
+  for( ulong i=0UL; i<EXEC_SPAD_MAX; i++ ) {
+    void * exec_spad_mem = fd_wksp_alloc_laddr( wksp, FD_SPAD_ALIGN, FD_SPAD_FOOTPRINT( EXEC_SPAD_SZ ), WKSP_TAG );
+    env->exec_spads[ i ] = fd_spad_join( fd_spad_new( exec_spad_mem, EXEC_SPAD_SZ ) );
+    FD_TEST( env->exec_spads[ i ] );
+  }
+
+  void * slot_ctx_mem = fd_wksp_alloc_laddr( wksp, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT, WKSP_TAG );
+  fd_exec_slot_ctx_t * slot_ctx = fd_exec_slot_ctx_join( fd_exec_slot_ctx_new( slot_ctx_mem ) );
+  FD_TEST( slot_ctx );
+  env->slot_ctx = slot_ctx;
+
+  fd_funk_txn_xid_t setup_xid = { .ul = { SLOT-1UL, SLOT-1UL } };
+  fd_funk_txn_start_write( env->funk );
+  env->setup_txn = fd_funk_txn_prepare( env->funk, NULL, &setup_xid, 1 );
+  fd_funk_txn_end_write( env->funk );
+  FD_TEST( env->setup_txn );
+
+  slot_ctx->funk     = env->funk;
+  slot_ctx->funk_txn = env->setup_txn;
+  slot_ctx->bank     = bank;
+
+  /* Features active on all clusters */
+
+  fd_features_t * features = fd_bank_features_modify( bank );
+  fd_features_disable_all( features );
+  for( fd_feature_id_t const * id = fd_feature_iter_init(); !fd_feature_iter_done( id ); id = fd_feature_iter_next( id ) ) {
+    if( id->reverted || !id->activated_on_all_clusters ) continue;
+    fd_features_set( features, id, 0UL );
+  }
+
+  /* Bank fields (defaults of GenesisConfig::default() in Agave) */
+
+  fd_bank_parent_slot_set                ( bank, SLOT-1UL );
+  fd_bank_lamports_per_signature_set     ( bank, 5000UL   );
+  fd_bank_prev_lamports_per_signature_set( bank, 5000UL   );
+  fd_bank_ticks_per_slot_set             ( bank, 64UL     );
+
+  fd_fee_rate_governor_t * fee_rate_governor = fd_bank_fee_rate_governor_modify( bank );
+  fee_rate_governor->burn_percent                  = 50;
+  fee_rate_governor->min_lamports_per_signature    = 0;
+  fee_rate_governor->max_lamports_per_signature    = 0;
+  fee_rate_governor->target_lamports_per_signature = 10000;
+  fee_rate_governor->target_signatures_per_slot    = 20000;
+
+  fd_epoch_schedule_t epoch_schedule = {
+    .slots_per_epoch             = 432000,
+    .leader_schedule_slot_offset = 432000,
+    .warmup                      = 1,
+    .first_normal_epoch          = 14,
+    .first_normal_slot           = 524256
+  };
+  fd_bank_epoch_schedule_set( bank, epoch_schedule );
+
+  fd_rent_t rent = {
+    .lamports_per_uint8_year = 3480,
+    .exemption_threshold     = 2.0,
+    .burn_percent            = 50
+  };
+  fd_bank_rent_set( bank, rent );
+  fd_bank_slots_per_year_set( bank, SECONDS_PER_YEAR * (1000000000.0 / (double)6250000) / (double)fd_bank_ticks_per_slot_get( bank ) );
+
+  fd_builtin_programs_init( slot_ctx );
+
+  /* Sysvars */
+
+  FD_SPAD_FRAME_BEGIN( env->runtime_spad ) {
+    fd_slot_hash_t *          slot_hashes = NULL;
+    void *                    mem         = fd_spad_alloc( env->runtime_spad, FD_SYSVAR_SLOT_HASHES_ALIGN, fd_sysvar_slot_hashes_footprint( 1UL ) );
+    fd_slot_hashes_global_t * slot_hashes_global = fd_sysvar_slot_hashes_join( fd_sysvar_slot_hashes_new( mem, 1UL ), &slot_hashes );
+    fd_slot_hash_t *          elem        = deq_fd_slot_hash_t_push_tail_nocopy( slot_hashes );
+    memset( elem, 0, sizeof(fd_slot_hash_t) );
+    elem->slot = SLOT-1UL;
+    fd_sysvar_slot_hashes_write( slot_ctx, slot_hashes_global );
+    fd_sysvar_slot_hashes_delete( fd_sysvar_slot_hashes_leave( slot_hashes_global, slot_hashes ) );
+  } FD_SPAD_FRAME_END;
+
+  fd_sysvar_last_restart_slot_init( slot_ctx );
+  fd_sysvar_clock_init( bank, slot_ctx->funk, slot_ctx->funk_txn );
+  fd_sysvar_clock_update( bank, slot_ctx->funk, slot_ctx->funk_txn, env->runtime_spad );
+  fd_sysvar_epoch_schedule_init( slot_ctx );
+  fd_sysvar_rent_init( slot_ctx );
+
+  /* Blockhash queue and recent blockhashes hold blockhash */
+
+  fd_block_hash_queue_global_t * block_hash_queue = fd_bank_block_hash_queue_modify( bank );
+  uchar * last_hash_mem = (uchar *)fd_ulong_align_up( (ulong)block_hash_queue + sizeof(fd_block_hash_queue_global_t), alignof(fd_hash_t) );
+  uchar * ages_pool_mem = (uchar *)fd_ulong_align_up( (ulong)last_hash_mem + sizeof(fd_hash_t), fd_hash_hash_age_pair_t_map_align() );
+  fd_hash_hash_age_pair_t_mapnode_t * ages_pool = fd_hash_hash_age_pair_t_map_join( fd_hash_hash_age_pair_t_map_new( ages_pool_mem, 400 ) );
+  block_hash_queue->max_age          = FD_BLOCKHASH_QUEUE_MAX_ENTRIES;
+  block_hash_queue->ages_root_offset = 0UL;
+  fd_block_hash_queue_ages_pool_update( block_hash_queue, ages_pool );
+  block_hash_queue->last_hash_index  = 0UL;
+  block_hash_queue->last_hash_offset = (ulong)last_hash_mem - (ulong)block_hash_queue;
+
+  *fd_bank_genesis_hash_modify( bank ) = *blockhash;
+  fd_bank_poh_set( bank, *blockhash );
+  fd_sysvar_recent_hashes_update( slot_ctx, env->runtime_spad );
+}
+
+/* test_env_fork starts the slot the workload is executed in, a child
+   of the setup transaction (so the bank hash only covers the accounts
+   the workload modified). */
+
+static void
+test_env_fork( test_env_t * env ) {
+  fd_funk_txn_xid_t xid = { .ul = { SLOT, SLOT } };
+  fd_funk_txn_start_write( env->funk );
+  env->slot_ctx->funk_txn = fd_funk_txn_prepare( env->funk, env->setup_txn, &xid, 1 );
+  fd_funk_txn_end_write( env->funk );
+  FD_TEST( env->slot_ctx->funk_txn );
+}
+
+static void
+test_env_fini( test_env_t * env ) {
+  fd_funk_leave( env->funk, NULL );
+  fd_wksp_reset( env->wksp, 0U );
+}
+
+/* test_txn_sign signs txn (generated by fd_txn_base_generate with
+   key as the fee payer and only signer) and replaces the generator's
+   descriptor with a parsed one. */
+
+static void
+test_txn_sign( fd_txn_p_t *       txn,
+               test_key_t const * key,
+               fd_sha512_t *      sha ) {
+  fd_txn_t const * desc = TXN( txn );
+  fd_ed25519_sign( txn->payload+desc->signature_off, txn->payload+desc->message_off, txn->payload_sz-desc->message_off,
+                   key->pub.uc, key->priv, sha );
+
+  uchar buf[ FD_TXN_MAX_SZ ];
+  FD_TEST( fd_txn_parse( txn->payload, txn->payload_sz, buf, NULL ) );
+  memcpy( txn->_, buf, FD_TXN_MAX_SZ );
+}
+
+/* test_exec executes txns[0,txn_cnt) in the slot of env, one
+   transaction per microblock (as replayed) if metrics_opt is NULL and
+   with fd_runtime_process_txns_speculative otherwise. */
+
+static void
+test_exec( test_env_t *                env,
+           fd_txn_p_t *                txns,
+           ulong                       txn_cnt,
+           fd_tpool_t *                tpool,
+           ulong                       exec_spad_cnt,
+           fd_runtime_spec_metrics_t * metrics_opt ) {
+  fd_exec_slot_ctx_t * slot_ctx = env->slot_ctx;
+  FD_SPAD_FRAME_BEGIN( env->runtime_spad ) {
+    if( metrics_opt ) {
+      FD_TEST( !fd_runtime_process_txns_speculative( slot_ctx, txns, txn_cnt, tpool, env->exec_spads, exec_spad_cnt,
+                                                     env->runtime_spad, NULL, metrics_opt ) );
+    } else {
+      for( ulong i=0UL; i<txn_cnt; i++ ) {
+        fd_runtime_update_program_cache( slot_ctx, &txns[ i ], env->runtime_spad );
+        FD_TEST( !fd_runtime_process_txns_in_microblock_stream( slot_ctx, NULL, &txns[ i ], 1UL, tpool, env->exec_spads, exec_spad_cnt,
+                                                                env->runtime_spad, NULL ) );
+      }
+    }
+  } FD_SPAD_FRAME_END;
+}
+
+static void
+test_acct_state( test_env_t *        env,
+                 fd_pubkey_t const * pubkey,
+                 test_acct_state_t * state ) {
+  int err = FD_ACC_MGR_SUCCESS;
+  fd_account_meta_t const * meta = fd_funk_get_acc_meta_readonly( env->funk, env->slot_ctx->funk_txn, pubkey, NULL, &err, NULL );
+  FD_TEST( meta && err==FD_ACC_MGR_SUCCESS );
+  state->lamports = meta->info.lamports;
+  fd_sha256_t sha[1];
+  fd_sha256_init( sha );
+  fd_sha256_append( sha, meta->info.owner, sizeof(fd_pubkey_t) );
+  fd_sha256_append( sha, (uchar const *)meta + meta->hlen, meta->dlen );
+  fd_sha256_fini( sha, state->digest );
+}
+
+/* test_result_fill records into result the outcome of executing
+   txns[0,txn_cnt) in the slot of env: the bank counters, transaction
+   flags, the state of accounts accts[0,STATE_ACCT_CNT) and the bank
+   hash. */
+
+static void
+test_result_fill( test_env_t *       env,
+                  fd_txn_p_t const * txns,
+                  ulong              txn_cnt,
+                  fd_pubkey_t const  accts[ STATE_ACCT_CNT ],
+                  fd_tpool_t *       tpool,
+                  test_result_t *    result ) {
+  fd_exec_slot_ctx_t * slot_ctx = env->slot_ctx;
+
+  result->execution_fees = fd_bank_execution_fees_get( slot_ctx->bank );
+  result->priority_fees  = fd_bank_priority_fees_get ( slot_ctx->bank );
+  result->signature_cnt  = fd_bank_signature_count_get( slot_ctx->bank );
+  for( ulong i=0UL; i<txn_cnt;        i++ ) result->flags[ i ] = txns[ i ].flags;
+  for( ulong i=0UL; i<STATE_ACCT_CNT; i++ ) test_acct_state( env, &accts[ i ], &result->acct[ i ] );
+
+  FD_SPAD_FRAME_BEGIN( env->runtime_spad ) {
+    FD_TEST( !fd_update_hash_bank_tpool( slot_ctx, NULL, &result->bank_hash, result->signature_cnt, tpool, env->runtime_spad ) );
+  } FD_SPAD_FRAME_END;
+}
+
+/* test_result_eq checks that two runs of the same txn_cnt transactions
+   committed the same state. */
+
+static void
+test_result_eq( test_result_t const * ref,
+                test_result_t const * res,
+                ulong                 txn_cnt ) {
+  for( ulong i=0UL; i<txn_cnt; i++ ) FD_TEST( ref->flags[ i ]==res->flags[ i ] );
+  FD_TEST( ref->execution_fees==res->execution_fees );
+  FD_TEST( ref->priority_fees ==res->priority_fees  );
+  FD_TEST( ref->signature_cnt ==res->signature_cnt  );
+  for( ulong i=0UL; i<STATE_ACCT_CNT; i++ ) {
+    FD_TEST( ref->acct[ i ].lamports==res->acct[ i ].lamports );
+    FD_TEST( !memcmp( ref->acct[ i ].digest, res->acct[ i ].digest, 32UL ) );
+  }
+  FD_TEST( !memcmp( ref->bank_hash.uc, res->bank_hash.uc, sizeof(fd_hash_t) ) );
+}
+
+#endif /* HEADER_fd_src_flamenco_runtime_test_runtime_common_h */
@@ -0,0 +1,321 @@
+/* test_spec_exec checks that speculative execution of the transactions
+   of a block (fd_runtime_process_txns_speculative) commits the same
+   state as executing them one by one.  The same workload of signed
+   system program transactions is executed twice against identical
+   freshly created slot states and the resulting bank hashes, bank fee
+   and signature counters, transaction outcomes and account states are
+   compared.  The workload contains transactions that conflict through
+   a hot account (so waves abort), failed transfers (fee payer
+   rollback), a failed durable nonce transaction (nonce rollback), a
+   fee payer that cannot pay, and transactions referencing a program
+   deploying loader (barriers).
+
+   Needs at least 3 tiles (e.g. --tile-cpus f5). */
+
+#define PAYER_CNT      (8UL)
+#define ROUND_CNT      (4UL)
+#define TXN_MAX        (128UL)
+#define STATE_ACCT_CNT (2UL*PAYER_CNT+4UL)
+
+#include "test_runtime_common.h"
+#include "program/fd_system_program.h"
+#include "../txn/fd_txn_generate.h"
+
+/* Accounts of the workload */
+
+static test_key_t payer[ PAYER_CNT ];  /* well funded fee payers */
+static test_key_t recv [ PAYER_CNT ];  /* transfer destinations */
+static test_key_t hot;                 /* destination of every payer */
+static test_key_t auth;                /* nonce authority */
+static test_key_t nonce;               /* durable nonce account */
+static test_key_t poor;                /* cannot pay the fee */
+
+static fd_hash_t blockhash;            /* only entry of the blockhash queue */
+static fd_hash_t durable_nonce;        /* initial value of nonce */
+static uchar     nonce_digest[ 32 ];   /* initial digest of nonce */
+
+static fd_txn_p_t txns_ref[ TXN_MAX ];
+static ulong      txn_cnt;
+
+static fd_pubkey_t state_accts[ STATE_ACCT_CNT ]; /* compared after a run */
+
+/* test_accts_create creates the accounts of the workload in env. */
+
+static void
+test_accts_create( test_env_t * env ) {
+  for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+    test_acct_create( env, &payer[ i ].pub, &fd_solana_system_program_id, 0, 10000000000UL, NULL, 0UL );
+    test_acct_create( env, &recv [ i ].pub, &fd_solana_system_program_id, 0,  1000000000UL, NULL, 0UL );
+  }
+  test_acct_create( env, &hot.pub,  &fd_solana_system_program_id, 0,  1000000000UL, NULL, 0UL );
+  test_acct_create( env, &auth.pub, &fd_solana_system_program_id, 0, 10000000000UL, NULL, 0UL );
+  test_acct_create( env, &poor.pub, &fd_solana_system_program_id, 0,         1000UL, NULL, 0UL );
+
+  fd_nonce_state_versions_t nonce_state = {
+    .discriminant = fd_nonce_state_versions_enum_current,
+    .inner = { .current = {
+      .discriminant = fd_nonce_state_enum_initialized,
+      .inner = { .initialized = {
+        .authority      = auth.pub,
+        .durable_nonce  = durable_nonce,
+        .fee_calculator = { .lamports_per_signature = 5000UL }
+      } }
+    } }
+  };
+  uchar nonce_data[ FD_SYSTEM_PROGRAM_NONCE_DLEN ] = {0};
+  fd_bincode_encode_ctx_t encode = { .data = nonce_data, .dataend = nonce_data+sizeof(nonce_data) };
+  FD_TEST( !fd_nonce_state_versions_encode( &nonce_state, &encode ) );
+  test_acct_create( env, &nonce.pub, &fd_solana_system_program_id, 0, 2000000UL, nonce_data, sizeof(nonce_data) );
+
+  fd_sha256_t sha[1];
+  fd_sha256_init( sha );
+  fd_sha256_append( sha, fd_solana_system_program_id.uc, sizeof(fd_pubkey_t) );
+  fd_sha256_append( sha, nonce_data, sizeof(nonce_data) );
+  fd_sha256_fini( sha, nonce_digest );
+}
+
+/* Workload **********************************************************/
+
+/* test_txn_new starts txns_ref[txn_cnt], a transaction with fee payer
+   and only signer key, the writable accounts w[0,w_cnt) followed by
+   the readonly accounts r[0,r_cnt).  The instructions are added with
+   test_txn_instr and the transaction is completed by test_txn_sign
+   (see test_runtime_common.h). */
+
+static fd_txn_p_t *
+test_txn_new( test_key_t const *  key,
+              fd_pubkey_t const * w,
+              ulong               w_cnt,
+              fd_pubkey_t const * r,
+              ulong               r_cnt,
+              fd_hash_t const *   recent_blockhash ) {
+  FD_TEST( txn_cnt<TXN_MAX );
+  fd_txn_p_t * txn = &txns_ref[ txn_cnt ];
+  memset( txn, 0, sizeof(fd_txn_p_t) );
+
+  fd_pubkey_t signer[1] = { key->pub };
+  fd_txn_accounts_t accts = {
+    .signature_cnt         = 1,
+    .readonly_signed_cnt   = 0,
+    .readonly_unsigned_cnt = (uchar)r_cnt,
+    .acct_cnt              = (ushort)(1UL+w_cnt+r_cnt),
+    .signers_w             = signer,
+    .signers_r             = NULL,
+    .non_signers_w         = w,
+    .non_signers_r         = r
+  };
+  txn->payload_sz = fd_txn_base_generate( txn->_, txn->payload, 1UL, &accts, recent_blockhash->uc );
+  FD_TEST( txn->payload_sz );
+  return txn;
+}
+
+static void
+test_txn_instr( fd_txn_p_t *                            txn,
+                uchar                                   program_idx,
+                uchar const *                           acct_idx,
+                ulong                                   acct_cnt,
+                fd_system_program_instruction_t const * instr ) {
+  uchar                   buf[ 64 ];
+  fd_bincode_encode_ctx_t encode = { .data = buf, .dataend = buf+sizeof(buf) };
+  FD_TEST( !fd_system_program_instruction_encode( instr, &encode ) );
+  txn->payload_sz = fd_txn_add_instr( txn->_, txn->payload, program_idx, acct_idx, acct_cnt, buf, (ulong)encode.data-(ulong)buf );
+}
+
+/* test_transfer adds a transaction transferring lamports from key to
+   dst.  If barrier, the program deploying loader is referenced. */
+
+static void
+test_transfer( test_key_t const *  key,
+               fd_pubkey_t const * dst,
+               ulong               lamports,
+               int                 barrier,
+               fd_sha512_t *       sha ) {
+  fd_pubkey_t w[1] = { *dst };
+  fd_pubkey_t r[2] = { fd_solana_system_program_id, fd_solana_bpf_loader_upgradeable_program_id };
+  fd_txn_p_t * txn = test_txn_new( key, w, 1UL, r, barrier ? 2UL : 1UL, &blockhash );
+
+  fd_system_program_instruction_t instr = { .discriminant = fd_system_program_instruction_enum_transfer, .inner = { .transfer = lamports } };
+  uchar acct_idx[2] = { 0, 1 };
+  test_txn_instr( txn, 2, acct_idx, 2UL, &instr );
+  test_txn_sign( txn, key, sha );
+  txn_cnt++;
+}
+
+/* test_nonce_transfer adds a durable nonce transaction advancing nonce
+   and transferring lamports from auth to dst. */
+
+static void
+test_nonce_transfer( fd_pubkey_t const * dst,
+                     ulong               lamports,
+                     fd_sha512_t *       sha ) {
+  fd_pubkey_t w[2] = { nonce.pub, *dst };
+  fd_pubkey_t r[2] = { fd_sysvar_recent_block_hashes_id, fd_solana_system_program_id };
+  fd_txn_p_t * txn = test_txn_new( &auth, w, 2UL, r, 2UL, &durable_nonce );
+
+  fd_system_program_instruction_t advance = { .discriminant = fd_system_program_instruction_enum_advance_nonce_account };
+  uchar advance_idx[3] = { 1, 3, 0 };
+  test_txn_instr( txn, 4, advance_idx, 3UL, &advance );
+
+  fd_system_program_instruction_t transfer = { .discriminant = fd_system_program_instruction_enum_transfer, .inner = { .transfer = lamports } };
+  uchar transfer_idx[2] = { 0, 2 };
+  test_txn_instr( txn, 4, transfer_idx, 2UL, &transfer );
+  test_txn_sign( txn, &auth, sha );
+  txn_cnt++;
+}
+
+static void
+test_workload( fd_sha512_t * sha ) {
+  txn_cnt = 0UL;
+  for( ulong r=0UL; r<ROUND_CNT; r++ ) {
+    for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+      test_transfer( &payer[ i ], &hot.pub, 1000UL*(r+1UL)+i, 0, sha );
+      test_transfer( &payer[ (i+r)%PAYER_CNT ], &recv[ i ].pub, 500UL*(r+1UL)+i, 0, sha );
+    }
+
+    /* Fails after paying the fee */
+    test_transfer( &payer[ r ], &recv[ r ].pub, 1UL<<60, 0, sha );
+
+    switch( r ) {
+    case 0UL:
+      /* Fails after paying the fee and advancing the nonce, followed by
+         a transaction of the same fee payer */
+      test_nonce_transfer( &recv[ 6 ].pub, 1UL<<60, sha );
+      test_transfer( &auth, &recv[ 7 ].pub, 777UL, 0, sha );
+      break;
+    case 1UL:
+      /* Not executed */
+      test_transfer( &poor, &recv[ 0 ].pub, 1UL, 0, sha );
+      break;
+    default:
+      break;
+    }
+
+    test_transfer( &payer[ (r+4UL)%PAYER_CNT ], &recv[ (r+5UL)%PAYER_CNT ].pub, 4242UL+r, 1, sha );
+    test_transfer( &payer[ (r+5UL)%PAYER_CNT ], &hot.pub, 4343UL+r, 0, sha );
+  }
+}
+
+/* Execution *********************************************************/
+
+/* test_run executes the workload in a fresh slot state, one
+   transaction per microblock if metrics_opt is NULL and speculatively
+   otherwise, and records the outcome into result. */
+
+static void
+test_run( fd_wksp_t *                 wksp,
+          fd_tpool_t *                tpool,
+          ulong                       exec_spad_cnt,
+          fd_runtime_spec_metrics_t * metrics_opt,
+          test_result_t *             result ) {
+  test_env_t env[1] = {{ .wksp = wksp }};
+  test_env_init( env, &blockhash );
+  test_accts_create( env );
+  test_env_fork( env );
+
+  static fd_txn_p_t txns[ TXN_MAX ];
+  memcpy( txns, txns_ref, txn_cnt*sizeof(fd_txn_p_t) );
+
+  test_exec( env, txns, txn_cnt, tpool, exec_spad_cnt, metrics_opt );
+  test_result_fill( env, txns, txn_cnt, state_accts, tpool, result );
+
+  test_env_fini( env );
+}
+
+static uchar tpool_mem[ FD_TPOOL_FOOTPRINT( EXEC_SPAD_MAX ) ] __attribute__((aligned(FD_TPOOL_ALIGN)));
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  fd_flamenco_boot( &argc, &argv );
+
+  ulong exec_spad_cnt = fd_ulong_min( fd_tile_cnt(), EXEC_SPAD_MAX );
+  if( FD_UNLIKELY( exec_spad_cnt<3UL ) ) {
+    FD_LOG_WARNING(( "skip: unit test requires at least 3 tiles" ));
+    fd_flamenco_halt();
+    fd_halt();
+    return 0;
+  }
+
+  fd_tpool_t * tpool = fd_tpool_init( tpool_mem, exec_spad_cnt, 0UL );
+  FD_TEST( tpool );
+  for( ulong i=1UL; i<exec_spad_cnt; i++ ) FD_TEST( fd_tpool_worker_push( tpool, i ) );
+
+  ulong cpu_idx = fd_tile_cpu_id( fd_tile_idx() );
+  if( cpu_idx>=fd_shmem_cpu_cnt() ) cpu_idx = 0UL;
+  ulong page_cnt = fd_ulong_align_up( test_wksp_footprint( 0UL ), FD_SHMEM_NORMAL_PAGE_SZ ) / FD_SHMEM_NORMAL_PAGE_SZ;
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( FD_SHMEM_NORMAL_PAGE_SZ, page_cnt, fd_shmem_cpu_idx( fd_shmem_numa_idx( cpu_idx ) ), "wksp", 0UL );
+  FD_TEST( wksp );
+
+  fd_rng_t    _rng[1]; fd_rng_t    * rng = fd_rng_join( fd_rng_new( _rng, 1234U, 0UL ) );
+  fd_sha512_t _sha[1]; fd_sha512_t * sha = fd_sha512_join( fd_sha512_new( _sha ) );
+
+  for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+    test_key_init( &payer[ i ], rng, sha );
+    test_key_init( &recv [ i ], rng, sha );
+  }
+  test_key_init( &hot,   rng, sha );
+  test_key_init( &auth,  rng, sha );
+  test_key_init( &nonce, rng, sha );
+  test_key_init( &poor,  rng, sha );
+  for( ulong i=0UL; i<32UL; i++ ) blockhash.uc    [ i ] = fd_rng_uchar( rng );
+  for( ulong i=0UL; i<32UL; i++ ) durable_nonce.uc[ i ] = fd_rng_uchar( rng );
+
+  ulong j = 0UL;
+  for( ulong i=0UL; i<PAYER_CNT; i++ ) {
+    state_accts[ j++ ] = payer[ i ].pub;
+    state_accts[ j++ ] = recv [ i ].pub;
+  }
+  state_accts[ j++ ] = hot.pub;
+  state_accts[ j++ ] = auth.pub;
+  state_accts[ j++ ] = nonce.pub;
+  state_accts[ j++ ] = poor.pub;
+  FD_TEST( j==STATE_ACCT_CNT );
+
+  test_workload( sha );
+  FD_LOG_NOTICE(( "%lu txns, %lu exec spads", txn_cnt, exec_spad_cnt ));
+
+  static test_result_t serial[1];
+  static test_result_t spec  [1];
+  fd_runtime_spec_metrics_t metrics[1] = {{0}};
+
+  test_run( wksp, tpool, 2UL,           NULL,    serial );
+  test_run( wksp, tpool, exec_spad_cnt, metrics, spec   );
+
+  FD_LOG_NOTICE(( "txns %lu execs %lu aborts %lu waves %lu barriers %lu",
+                  metrics->txn_cnt, metrics->exec_cnt, metrics->abort_cnt, metrics->wave_cnt, metrics->barrier_cnt ));
+
+  /* Speculative execution committed the same state */
+
+  test_result_eq( serial, spec, txn_cnt );
+
+  /* The workload exercised what it is meant to */
+
+  FD_TEST( metrics->txn_cnt==txn_cnt );
+  FD_TEST( metrics->exec_cnt==txn_cnt+metrics->abort_cnt );
+  FD_TEST( metrics->abort_cnt>0UL );
+  FD_TEST( metrics->barrier_cnt==ROUND_CNT );
+
+  ulong executed_cnt = 0UL;
+  for( ulong i=0UL; i<txn_cnt; i++ ) executed_cnt += !!( serial->flags[ i ] & FD_TXN_P_FLAGS_EXECUTE_SUCCESS );
+  FD_TEST( executed_cnt==txn_cnt-1UL ); /* all but the poor fee payer */
+  FD_TEST( serial->execution_fees==5000UL*executed_cnt );
+
+  test_acct_state_t const * nonce_state = &serial->acct[ 2UL*PAYER_CNT+2UL ];
+  test_acct_state_t const * poor_state  = &serial->acct[ 2UL*PAYER_CNT+3UL ];
+  FD_TEST( nonce_state->lamports==2000000UL );
+  FD_TEST( memcmp( nonce_state->digest, nonce_digest, 32UL ) ); /* advanced */
+  FD_TEST( poor_state->lamports==1000UL );
+
+  FD_LOG_NOTICE(( "bank hash %s", FD_BASE58_ENC_32_ALLOCA( serial->bank_hash.uc ) ));
+
+  fd_sha512_delete( fd_sha512_leave( sha ) );
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_wksp_delete_anonymous( wksp );
+  fd_tpool_fini( tpool );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_flamenco_halt();
+  fd_halt();
+  return 0;
+}
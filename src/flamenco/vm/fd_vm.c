@@ -650,6 +650,7 @@ fd_vm_init(
   vm->text_sz               = text_sz;
   vm->entry_pc              = entry_pc;
   vm->calldests             = calldests;
+  vm->fuse                  = NULL;
   vm->sbpf_version          = sbpf_version;
   vm->syscalls              = syscalls;
   vm->trace                 = trace;
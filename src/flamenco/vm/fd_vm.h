@@ -221,6 +221,9 @@ struct __attribute__((aligned(FD_VM_HOST_REGION_ALIGN))) fd_vm {
   ulong sbpf_version;     /* SBPF version, SIMD-0161 */
 
   int dump_syscall_to_pb; /* If true, syscalls will be dumped to the specified output directory */
+
+  uchar const * fuse; /* Superinstruction table of text (see fd_vm_fuse_build), indexed [0,text_cnt), NULL if none.
+                         Reset by fd_vm_init, set by the user afterwards. */
 };
 
 /* FIXME: MOVE ABOVE INTO PRIVATE WHEN CONSTRUCTORS READY */
@@ -235,7 +238,7 @@ FD_PROTOTYPES_BEGIN
    integer power of 2.  FOOTPRINT is a multiple of align.
    These are provided to facilitate compile time declarations. */
 #define FD_VM_ALIGN     FD_VM_HOST_REGION_ALIGN
-#define FD_VM_FOOTPRINT (527824UL)
+#define FD_VM_FOOTPRINT (527840UL)
 
 /* fd_vm_{align,footprint} give the needed alignment and footprint
    of a memory region suitable to hold an fd_vm_t.
@@ -328,6 +331,34 @@ fd_vm_delete( void * shmem );
 FD_FN_PURE int
 fd_vm_validate( fd_vm_t const * vm );
 
+/* fd_vm_fuse_build pre-decodes the text of a validated sBPF program
+   into a superinstruction table for the interpreter.  fuse has room
+   for text_cnt bytes (fd_vm_fuse_footprint).  On return, fuse[pc] is
+   non-zero if a common compiler idiom (sign / zero extension, a
+   load / add / store of a counter, a pair of LDQs, or an ALU op
+   feeding a conditional branch) starts at pc, in which case the
+   interpreter executes the whole idiom with a single dispatch.
+   Branch targets inside an idiom are still executed correctly (the
+   table is indexed by pc, not by basic block) and the results,
+   including faults and compute unit accounting, are bit-for-bit the
+   same as without fusion.  Returns the number of fused sites.  text
+   should have passed fd_vm_validate for sbpf_version.
+
+   The table is only valid for the text and sbpf_version it was built
+   from.  Users attach it to a vm by setting vm->fuse after fd_vm_init
+   and before fd_vm_exec. */
+
+FD_FN_CONST static inline ulong
+fd_vm_fuse_footprint( ulong text_cnt ) {
+  return text_cnt;
+}
+
+ulong
+fd_vm_fuse_build( uchar *       fuse,
+                  ulong const * text,
+                  ulong         text_cnt,
+                  ulong         sbpf_version );
+
 /* fd_vm_is_check_align_enabled returns 1 if the vm should check alignment
    when doing memory translation. */
 FD_FN_PURE static inline int
@@ -449,7 +480,10 @@ fd_vm_setup_state_for_execution( fd_vm_t * vm ) ;
 
    fd_vm_exec_trace runs with tracing and requires vm to be attached to
    a trace.  fd_vm_exec_notrace runs without without tracing even if vm
-   is attached to a trace. */
+   is attached to a trace.  fd_vm_exec_fuse is fd_vm_exec_notrace that
+   dispatches the superinstructions in vm->fuse and requires vm->fuse
+   to be non-NULL (see fd_vm_fuse_build).  fd_vm_exec picks the
+   fastest of these that is applicable. */
 
 int
 fd_vm_exec_trace( fd_vm_t * vm );
@@ -457,10 +491,14 @@ fd_vm_exec_trace( fd_vm_t * vm );
 int
 fd_vm_exec_notrace( fd_vm_t * vm );
 
+int
+fd_vm_exec_fuse( fd_vm_t * vm );
+
 static inline int
 fd_vm_exec( fd_vm_t * vm ) {
-  if( FD_UNLIKELY( vm->trace ) ) return fd_vm_exec_trace  ( vm );
-  else                           return fd_vm_exec_notrace( vm );
+  if     ( FD_UNLIKELY( vm->trace ) ) return fd_vm_exec_trace  ( vm );
+  else if( FD_LIKELY  ( vm->fuse  ) ) return fd_vm_exec_fuse   ( vm );
+  else                                return fd_vm_exec_notrace( vm );
 }
 
 FD_PROTOTYPES_END
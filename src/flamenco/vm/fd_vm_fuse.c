@@ -0,0 +1,86 @@
+#include "fd_vm_private.h"
+
+/* fd_vm_fuse_match returns the superinstruction (an FD_VM_FUSE_OP_*)
+   that starts at text[0], given rem>0 text words are available from
+   there.  Only opcodes that have the same meaning as the fused
+   implementation in fd_vm_interp_core for sbpf_version are matched. */
+
+static int
+fd_vm_fuse_match( ulong const * text,
+                  ulong         rem,
+                  ulong         sbpf_version ) {
+  ulong i0 = text[0];
+  ulong o0 = fd_vm_instr_opcode( i0 );
+  ulong d0 = fd_vm_instr_dst   ( i0 );
+
+  ulong ldxq_op = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( sbpf_version ) ? 0x9cUL : 0x79UL;
+  ulong stxq_op = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( sbpf_version ) ? 0x9fUL : 0x7bUL;
+
+  if( FD_UNLIKELY( rem<2UL ) ) return FD_VM_FUSE_OP_NONE;
+  ulong i1 = text[1];
+  ulong o1 = fd_vm_instr_opcode( i1 );
+  int   d1 = fd_vm_instr_dst( i1 )==d0;
+
+  switch( o0 ) {
+
+  case 0x67UL: /* LSH64_IMM */
+    if( (fd_vm_instr_imm( i0 )!=32U) | !d1 | (fd_vm_instr_imm( i1 )!=32U) ) break;
+    if( o1==0xc7UL ) return FD_VM_FUSE_OP_SEXT32;
+    if( o1==0x77UL ) return FD_VM_FUSE_OP_ZEXT32;
+    break;
+
+  case 0xbfUL: { /* MOV64_REG */
+    if( (rem<3UL) | (o1!=0x67UL) | !d1 | (fd_vm_instr_imm( i1 )!=32U) ) break;
+    ulong i2 = text[2];
+    if( (fd_vm_instr_dst( i2 )!=d0) | (fd_vm_instr_imm( i2 )!=32U) ) break;
+    if( fd_vm_instr_opcode( i2 )==0xc7UL ) return FD_VM_FUSE_OP_MOV_SEXT32;
+    if( fd_vm_instr_opcode( i2 )==0x77UL ) return FD_VM_FUSE_OP_MOV_ZEXT32;
+    break;
+  }
+
+  case 0x18UL: /* LDQ */
+    if( (!FD_VM_SBPF_ENABLE_LDDW( sbpf_version )) | (rem<4UL) ) break;
+    if( fd_vm_instr_opcode( text[2] )==0x18UL ) return FD_VM_FUSE_OP_LDQ_LDQ;
+    break;
+
+  case 0x07UL: /* ADD64_IMM */
+    if( !d1 ) break;
+    if( o1==0x5dUL ) return FD_VM_FUSE_OP_ADD64_JNE_REG;
+    if( o1==0xadUL ) return FD_VM_FUSE_OP_ADD64_JLT_REG;
+    break;
+
+  case 0x57UL: /* AND64_IMM */
+    if( !d1 ) break;
+    if( o1==0x15UL ) return FD_VM_FUSE_OP_AND64_JEQ_IMM;
+    if( o1==0x55UL ) return FD_VM_FUSE_OP_AND64_JNE_IMM;
+    break;
+
+  default:
+    if( o0==ldxq_op ) {
+      ulong b0 = fd_vm_instr_src( i0 );
+      if( (rem<3UL) | (d0==b0) | (o1!=0x07UL) | !d1 ) break;
+      ulong i2 = text[2];
+      if( (fd_vm_instr_opcode( i2 )==stxq_op)          &
+          (fd_vm_instr_dst   ( i2 )==b0     )          &
+          (fd_vm_instr_src   ( i2 )==d0     )          &
+          (fd_vm_instr_offset( i2 )==fd_vm_instr_offset( i0 )) ) return FD_VM_FUSE_OP_LDXQ_ADD64_STXQ;
+    }
+    break;
+  }
+
+  return FD_VM_FUSE_OP_NONE;
+}
+
+ulong
+fd_vm_fuse_build( uchar *       fuse,
+                  ulong const * text,
+                  ulong         text_cnt,
+                  ulong         sbpf_version ) {
+  ulong fuse_cnt = 0UL;
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    int op = fd_vm_fuse_match( text + pc, text_cnt - pc, sbpf_version );
+    fuse[ pc ] = (uchar)op;
+    fuse_cnt += (ulong)(op!=FD_VM_FUSE_OP_NONE);
+  }
+  return fuse_cnt;
+}
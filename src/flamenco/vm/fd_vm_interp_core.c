@@ -23,6 +23,22 @@
 
 # include "fd_vm_interp_jump_table.c"
 
+# ifdef FD_VM_INTERP_FUSE_ENABLED
+  static void const * interp_fuse_jump_table[ FD_VM_FUSE_OP_CNT ] = {
+    [ FD_VM_FUSE_OP_NONE            ] = &&sigill, /* Never dispatched */
+    [ FD_VM_FUSE_OP_SEXT32          ] = &&interp_fuse_SEXT32,
+    [ FD_VM_FUSE_OP_ZEXT32          ] = &&interp_fuse_ZEXT32,
+    [ FD_VM_FUSE_OP_MOV_SEXT32      ] = &&interp_fuse_MOV_SEXT32,
+    [ FD_VM_FUSE_OP_MOV_ZEXT32      ] = &&interp_fuse_MOV_ZEXT32,
+    [ FD_VM_FUSE_OP_LDQ_LDQ         ] = &&interp_fuse_LDQ_LDQ,
+    [ FD_VM_FUSE_OP_LDXQ_ADD64_STXQ ] = &&interp_fuse_LDXQ_ADD64_STXQ,
+    [ FD_VM_FUSE_OP_ADD64_JNE_REG   ] = &&interp_fuse_ADD64_JNE_REG,
+    [ FD_VM_FUSE_OP_ADD64_JLT_REG   ] = &&interp_fuse_ADD64_JLT_REG,
+    [ FD_VM_FUSE_OP_AND64_JEQ_IMM   ] = &&interp_fuse_AND64_JEQ_IMM,
+    [ FD_VM_FUSE_OP_AND64_JNE_IMM   ] = &&interp_fuse_AND64_JNE_IMM
+  };
+# endif
+
   /* Update the jump table based on SBPF version */
 
   ulong sbpf_version = vm->sbpf_version;
@@ -175,6 +191,14 @@
 #define FD_RUST_UINT_WRAPPING_SHR( a, b ) (a >> ( b & ( 31 ) ))
 
 
+# ifndef FD_VM_INTERP_FUSE_ENABLED
+# define FD_VM_INTERP_INSTR_DISPATCH goto *interp_jump_table[ sbpf_version ][ opcode ] /* Guaranteed in-bounds */
+# else /* A superinstruction starting at pc takes over the whole idiom, see fd_vm_fuse_build */
+# define FD_VM_INTERP_INSTR_DISPATCH                                                             \
+  goto *( fuse[ pc ] ? interp_fuse_jump_table[ fuse[ pc ] ] /* Guaranteed in-bounds */           \
+                     : interp_jump_table[ sbpf_version ][ opcode ] )
+# endif
+
 # define FD_VM_INTERP_INSTR_EXEC                                                                 \
   if( FD_UNLIKELY( pc>=text_cnt ) ) goto sigtext; /* Note: untaken branches don't consume BTB */ \
   instr   = text[ pc ];                  /* Guaranteed in-bounds */                              \
@@ -185,7 +209,7 @@
   imm     = fd_vm_instr_imm   ( instr ); /* in [0,2^32) even if malformed */                     \
   reg_dst = reg[ dst ];                  /* Guaranteed in-bounds */                              \
   reg_src = reg[ src ];                  /* Guaranteed in-bounds */                              \
-  goto *interp_jump_table[ sbpf_version ][ opcode ]      /* Guaranteed in-bounds */
+  FD_VM_INTERP_INSTR_DISPATCH
 
 /* FD_VM_INTERP_SYSCALL_EXEC
    (macro to handle the logic of 0x85 pre- and post- SIMD-0178: static syscalls)
@@ -309,8 +333,7 @@
   ulong pc0           = pc;
   ulong ic_correction = 0UL;
 
-# define FD_VM_INTERP_BRANCH_BEGIN(opcode)                                                              \
-  interp_##opcode:                                                                                      \
+# define FD_VM_INTERP_BRANCH_BILL                                                                       \
     /* Bill linear text segment and this branch instruction as per the above */                         \
     ic_correction = pc - pc0 + 1UL - ic_correction;                                                     \
     ic += ic_correction;                                                                                \
@@ -319,6 +342,10 @@
     /* At this point, cu>=0 */                                                                          \
     ic_correction = 0UL;
 
+# define FD_VM_INTERP_BRANCH_BEGIN(opcode)                                                              \
+  interp_##opcode:                                                                                      \
+    FD_VM_INTERP_BRANCH_BILL
+
   /* FIXME: debatable if it is better to do pc++ here or have the
      instruction implementations do it in their code path. */
 
@@ -1212,6 +1239,119 @@ interp_exec:
     reg[ dst ] = (ulong)( (long)reg_dst % (long)reg_src );
   FD_VM_INTERP_INSTR_END;
 
+# ifdef FD_VM_INTERP_FUSE_ENABLED
+
+  /* Superinstructions **********************************************/
+
+  /* A superinstruction executes a whole idiom found by
+     fd_vm_fuse_build with a single dispatch.  On entry, the first
+     instruction of the idiom has been unpacked as usual and the builder
+     guarantees the rest of the idiom is in the text.  The idiom is
+     executed one instruction after the other, advancing pc as it goes,
+     such that the linear segment accounting above (and thus the fault
+     diagnostics and the compute units billed) is unchanged.  An idiom
+     ending in a branch bills at the branch exactly like the branch
+     would on its own. */
+
+# define FD_VM_INTERP_FUSE_BEGIN(op) interp_fuse_##op:
+
+  FD_VM_INTERP_FUSE_BEGIN(SEXT32) /* LSH64_IMM d,32 ; ARSH64_IMM d,32 */
+    reg[ dst ] = (ulong)(long)(int)reg_dst;
+    pc++;
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(ZEXT32) /* LSH64_IMM d,32 ; RSH64_IMM d,32 */
+    reg[ dst ] = (ulong)(uint)reg_dst;
+    pc++;
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(MOV_SEXT32) /* MOV64_REG d,s ; LSH64_IMM d,32 ; ARSH64_IMM d,32 */
+    reg[ dst ] = (ulong)(long)(int)reg_src;
+    pc += 2UL;
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(MOV_ZEXT32) /* MOV64_REG d,s ; LSH64_IMM d,32 ; RSH64_IMM d,32 */
+    reg[ dst ] = (ulong)(uint)reg_src;
+    pc += 2UL;
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(LDQ_LDQ) /* LDQ ; LDQ */
+    reg[ dst ] = (ulong)((ulong)imm | ((ulong)fd_vm_instr_imm( text[ pc+1UL ] ) << 32));
+    instr = text[ pc+2UL ];
+    reg[ fd_vm_instr_dst( instr ) ] = (ulong)((ulong)fd_vm_instr_imm( instr ) | ((ulong)fd_vm_instr_imm( text[ pc+3UL ] ) << 32));
+    pc += 3UL;
+    ic_correction += 2UL;
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(LDXQ_ADD64_STXQ) { /* LDXQ d,[b+o] ; ADD64_IMM d,i ; STXQ [b+o],d */
+    uchar is_multi_region = 0;
+    ulong vaddr           = reg_src + offset;
+    ulong haddr           = fd_vm_mem_haddr( vm, vaddr, sizeof(ulong), region_haddr, region_ld_sz, 0, 0UL, &is_multi_region );
+    if( FD_UNLIKELY( !haddr ) ) {
+      vm->segv_vaddr       = vaddr;
+      vm->segv_access_type = FD_VM_ACCESS_TYPE_LD;
+      goto sigsegv; /* Note: untaken branches don't consume BTB */ /* FIXME: sigbus */
+    }
+    ulong val = fd_vm_mem_ld_8( vm, vaddr, haddr, is_multi_region ) + (ulong)(long)(int)fd_vm_instr_imm( text[ pc+1UL ] );
+    reg[ dst ] = val;
+    pc += 2UL;
+    is_multi_region = 0;
+    haddr           = fd_vm_mem_haddr( vm, vaddr, sizeof(ulong), region_haddr, region_st_sz, 1, 0UL, &is_multi_region );
+    if( FD_UNLIKELY( !haddr ) ) {
+      vm->segv_vaddr       = vaddr;
+      vm->segv_access_type = FD_VM_ACCESS_TYPE_ST;
+
+      if( vm->direct_mapping ) {
+        /* See FD_SBPF_OP_STH for details */
+        fd_vm_mem_st_try( vm, vaddr, sizeof(ulong), (uchar*)&val );
+      }
+
+      goto sigsegv;
+    } /* Note: untaken branches don't consume BTB */ /* FIXME: sigbus */
+    fd_vm_mem_st_8( vm, vaddr, haddr, val, is_multi_region );
+  }
+  FD_VM_INTERP_INSTR_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(ADD64_JNE_REG) /* ADD64_IMM d,i ; JNE_REG d,s */
+    reg_dst    = reg_dst + (ulong)(long)(int)imm;
+    reg[ dst ] = reg_dst;
+    pc++;
+    FD_VM_INTERP_BRANCH_BILL
+    instr = text[ pc ];
+    pc += fd_ulong_if( reg_dst!=reg[ fd_vm_instr_src( instr ) ], fd_vm_instr_offset( instr ), 0UL );
+  FD_VM_INTERP_BRANCH_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(ADD64_JLT_REG) /* ADD64_IMM d,i ; JLT_REG d,s */
+    reg_dst    = reg_dst + (ulong)(long)(int)imm;
+    reg[ dst ] = reg_dst;
+    pc++;
+    FD_VM_INTERP_BRANCH_BILL
+    instr = text[ pc ];
+    pc += fd_ulong_if( reg_dst<reg[ fd_vm_instr_src( instr ) ], fd_vm_instr_offset( instr ), 0UL );
+  FD_VM_INTERP_BRANCH_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(AND64_JEQ_IMM) /* AND64_IMM d,i ; JEQ_IMM d,j */
+    reg_dst    = reg_dst & (ulong)(long)(int)imm;
+    reg[ dst ] = reg_dst;
+    pc++;
+    FD_VM_INTERP_BRANCH_BILL
+    instr = text[ pc ];
+    pc += fd_ulong_if( reg_dst==(ulong)(long)(int)fd_vm_instr_imm( instr ), fd_vm_instr_offset( instr ), 0UL );
+  FD_VM_INTERP_BRANCH_END;
+
+  FD_VM_INTERP_FUSE_BEGIN(AND64_JNE_IMM) /* AND64_IMM d,i ; JNE_IMM d,j */
+    reg_dst    = reg_dst & (ulong)(long)(int)imm;
+    reg[ dst ] = reg_dst;
+    pc++;
+    FD_VM_INTERP_BRANCH_BILL
+    instr = text[ pc ];
+    pc += fd_ulong_if( reg_dst!=(ulong)(long)(int)fd_vm_instr_imm( instr ), fd_vm_instr_offset( instr ), 0UL );
+  FD_VM_INTERP_BRANCH_END;
+
+# undef FD_VM_INTERP_FUSE_BEGIN
+
+# endif /* FD_VM_INTERP_FUSE_ENABLED */
+
   /* FIXME: sigbus/sigrdonly are mapped to sigsegv for simplicity
      currently but could be enabled if desired. */
 
@@ -1272,10 +1412,12 @@ interp_halt:
 
 # undef FD_VM_INTERP_BRANCH_END
 # undef FD_VM_INTERP_BRANCH_BEGIN
+# undef FD_VM_INTERP_BRANCH_BILL
 
 # undef FD_VM_INTERP_INSTR_END
 # undef FD_VM_INTERP_INSTR_BEGIN
 # undef FD_VM_INTERP_INSTR_EXEC
+# undef FD_VM_INTERP_INSTR_DISPATCH
 
 # if defined(__clang__)
 # pragma clang diagnostic pop
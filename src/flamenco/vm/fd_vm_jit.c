@@ -0,0 +1,1691 @@
+#define _DEFAULT_SOURCE /* MAP_ANONYMOUS, MAP_NORESERVE */
+#include "fd_vm_jit.h"
+#include "fd_vm_private.h"
+
+#include <errno.h>
+#include <stddef.h>
+#include <sys/mman.h>
+
+/* Code generation overview ********************************************
+
+   Every text word gets an entry in pc_tbl holding the native address
+   where execution of that word starts.  Code for each word is emitted
+   into a "hot" area in text order such that straight line sBPF code is
+   straight line native code.  Rarely executed code (fault exits, the
+   out of line memory translation, branches out of the text) is emitted
+   into a "cold" area after the hot area.  A small common area in front
+   of both holds the entry trampoline and the exit path.
+
+   Host register usage while running generated code:
+
+     rbx - fd_vm_t * vm
+     r12 - pc0 + ic_correction (i.e. the first pc not yet billed minus
+           the number of extra words of multiword instructions seen in
+           the current linear segment)
+     r13 - pc_tbl
+     r14 - ic
+     r15 - cu
+
+   All of these are callee saved under the SysV ABI such that the
+   generated code can call plain C helpers.  rax, rcx, rdx, rsi, rdi,
+   r8-r11 are scratch.  The sBPF registers live in vm->reg.
+
+   When a branch at pc is reached, the number of instructions to bill
+   is pc + 1 - r12 (compare with FD_VM_INTERP_BRANCH_BEGIN).  When a
+   non-branch instruction at pc faults, the same expression gives the
+   instructions not yet billed (compare with FD_VM_INTERP_FAULT).  All
+   exits go through fd_vm_jit_fault which reproduces the interpreter's
+   fault labels exactly given the fault kind, pc and r12. */
+
+/* Fault kinds (mirror the interpreter's exit labels) */
+
+#define FD_VM_JIT_SIGTEXT    (1UL)
+#define FD_VM_JIT_SIGTEXTBR  (2UL)
+#define FD_VM_JIT_SIGSTACK   (3UL)
+#define FD_VM_JIT_SIGILL     (4UL)
+#define FD_VM_JIT_SIGILLBR   (5UL)
+#define FD_VM_JIT_SIGINV     (6UL)
+#define FD_VM_JIT_SIGSEGV    (7UL)
+#define FD_VM_JIT_SIGCOST    (8UL)
+#define FD_VM_JIT_SIGSYSCALL (9UL)
+#define FD_VM_JIT_SIGFPE     (10UL)
+#define FD_VM_JIT_SIGFPEOF   (11UL)
+#define FD_VM_JIT_SIGEXIT    (12UL)
+
+/* Worst case number of bytes of generated code per text word in the
+   hot and cold areas and for the common area.  Checked during code
+   generation (a program that would exceed them fails to compile). */
+
+#define FD_VM_JIT_COMMON_MAX (256UL)
+#define FD_VM_JIT_HOT_MAX    (128UL)
+#define FD_VM_JIT_COLD_MAX   (64UL)
+
+typedef int (*fd_vm_jit_entry_t)( fd_vm_t * vm, ulong const * pc_tbl, ulong pc );
+
+struct fd_vm_jit_fixup {
+  uint rel; /* offset of a rel32 field from the start of code */
+  uint pc;  /* text word that rel32 should jump to */
+};
+
+typedef struct fd_vm_jit_fixup fd_vm_jit_fixup_t;
+
+struct __attribute__((aligned(FD_VM_JIT_ALIGN))) fd_vm_jit {
+  ulong   magic;    /* ==FD_VM_JIT_MAGIC */
+  ulong   text_max;
+  uchar * code;     /* Code pages, only writable while fd_vm_jit_compile runs */
+  ulong   code_sz;
+
+  /* The compiled program (only valid if compiled is set) */
+
+  int                        compiled;
+  int                        direct_mapping;
+  fd_vm_jit_entry_t          entry;
+  ulong const *              text;
+  ulong                      text_cnt;
+  ulong                      sbpf_version;
+  ulong                      entry_pc;
+  ulong const *              calldests;
+  fd_sbpf_syscalls_t const * syscalls;
+
+  /* pc_tbl and fixups follow */
+};
+
+FD_STATIC_ASSERT( sizeof(fd_vm_jit_t)<=256UL, fd_vm_jit );
+
+static inline ulong *
+fd_vm_jit_pc_tbl( fd_vm_jit_t * jit ) {
+  return (ulong *)fd_ulong_align_up( (ulong)jit + 256UL, 8UL );
+}
+
+static inline ulong const *
+fd_vm_jit_pc_tbl_const( fd_vm_jit_t const * jit ) {
+  return (ulong const *)fd_ulong_align_up( (ulong)jit + 256UL, 8UL );
+}
+
+static inline fd_vm_jit_fixup_t *
+fd_vm_jit_fixup( fd_vm_jit_t * jit ) {
+  return (fd_vm_jit_fixup_t *)(fd_vm_jit_pc_tbl( jit ) + jit->text_max + 1UL);
+}
+
+static inline ulong
+fd_vm_jit_code_sz( ulong text_max ) {
+  return fd_ulong_align_up( FD_VM_JIT_COMMON_MAX + (text_max+1UL)*FD_VM_JIT_HOT_MAX + text_max*FD_VM_JIT_COLD_MAX, 4096UL );
+}
+
+/* Runtime helpers *****************************************************
+
+   These are called from generated code.  They implement the parts of
+   the interpreter that are not worth inlining and are written to
+   mirror the corresponding interpreter code as closely as possible. */
+
+static int
+fd_vm_jit_fault( fd_vm_t * vm,
+                 ulong     kind,
+                 ulong     pc,
+                 ulong     pc0 ) {
+  ulong ic    = vm->ic;
+  ulong cu    = vm->cu;
+  int   err   = FD_VM_SUCCESS;
+  int   fault = 0;
+
+  switch( kind ) {
+  case FD_VM_JIT_SIGTEXT:    err = FD_VM_ERR_EBPF_EXECUTION_OVERRUN;                                  fault = 1; break;
+  case FD_VM_JIT_SIGTEXTBR:  err = FD_VM_ERR_EBPF_CALL_OUTSIDE_TEXT_SEGMENT;                                     break;
+  case FD_VM_JIT_SIGSTACK:   err = FD_VM_ERR_EBPF_CALL_DEPTH_EXCEEDED;                                           break;
+  case FD_VM_JIT_SIGILL:     err = FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION;                            fault = 1; break;
+  case FD_VM_JIT_SIGILLBR:   err = FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION;                                       break;
+  case FD_VM_JIT_SIGINV:     err = FD_VM_ERR_EBPF_INVALID_INSTRUCTION;                                           break;
+  case FD_VM_JIT_SIGSEGV:    err = fd_vm_generate_access_violation( vm->segv_vaddr, vm->sbpf_version ); fault = 1; break;
+  case FD_VM_JIT_SIGCOST:    err = FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS; cu = 0UL;                           break;
+  case FD_VM_JIT_SIGSYSCALL: err = FD_VM_ERR_EBPF_SYSCALL_ERROR;                                                 break;
+  case FD_VM_JIT_SIGFPE:     err = FD_VM_ERR_EBPF_DIVIDE_BY_ZERO;                                     fault = 1; break;
+  case FD_VM_JIT_SIGFPEOF:   err = FD_VM_ERR_EBPF_DIVIDE_OVERFLOW;                                    fault = 1; break;
+  case FD_VM_JIT_SIGEXIT:    /* err current */                                                                   break;
+  default: FD_LOG_CRIT(( "unexpected jit fault kind %lu", kind ));
+  }
+
+  if( fault ) { /* See FD_VM_INTERP_FAULT */
+    ulong n = pc - pc0 + 1UL;
+    ic += n;
+    if( FD_UNLIKELY( n>cu ) ) err = FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS;
+    cu -= fd_ulong_min( n, cu );
+  }
+
+  vm->pc = pc;
+  vm->ic = ic;
+  vm->cu = cu;
+  return err;
+}
+
+static int
+fd_vm_jit_ld( fd_vm_t * vm,
+              ulong     vaddr,
+              ulong     sz,
+              ulong *   dst ) {
+  uchar is_multi_region = 0;
+  ulong haddr           = fd_vm_mem_haddr( vm, vaddr, sz, vm->region_haddr, vm->region_ld_sz, 0, 0UL, &is_multi_region );
+  if( FD_UNLIKELY( !haddr ) ) {
+    vm->segv_vaddr       = vaddr;
+    vm->segv_access_type = FD_VM_ACCESS_TYPE_LD;
+    return 1;
+  }
+  switch( sz ) {
+  case 1UL: *dst = fd_vm_mem_ld_1( haddr );                         break;
+  case 2UL: *dst = fd_vm_mem_ld_2( vm, vaddr, haddr, is_multi_region ); break;
+  case 4UL: *dst = fd_vm_mem_ld_4( vm, vaddr, haddr, is_multi_region ); break;
+  default:  *dst = fd_vm_mem_ld_8( vm, vaddr, haddr, is_multi_region ); break;
+  }
+  return 0;
+}
+
+static int
+fd_vm_jit_st( fd_vm_t * vm,
+              ulong     vaddr,
+              ulong     sz,
+              ulong     val ) {
+  uchar is_multi_region = 0;
+  ulong haddr           = fd_vm_mem_haddr( vm, vaddr, sz, vm->region_haddr, vm->region_st_sz, 1, 0UL, &is_multi_region );
+  if( FD_UNLIKELY( !haddr ) ) {
+    vm->segv_vaddr       = vaddr;
+    vm->segv_access_type = FD_VM_ACCESS_TYPE_ST;
+    /* See FD_SBPF_OP_STH in the interpreter for details.  val is
+       stored little endian such that its first sz bytes are the value
+       being stored. */
+    if( sz>1UL && vm->direct_mapping ) fd_vm_mem_st_try( vm, vaddr, sz, (uchar *)&val );
+    return 1;
+  }
+  switch( sz ) {
+  case 1UL: fd_vm_mem_st_1( haddr, (uchar)val );                                 break;
+  case 2UL: fd_vm_mem_st_2( vm, vaddr, haddr, (ushort)val, is_multi_region );    break;
+  case 4UL: fd_vm_mem_st_4( vm, vaddr, haddr, (uint)val, is_multi_region );      break;
+  default:  fd_vm_mem_st_8( vm, vaddr, haddr, val, is_multi_region );            break;
+  }
+  return 0;
+}
+
+/* fd_vm_jit_push is FD_VM_INTERP_STACK_PUSH.  Returns non-zero if the
+   push overflowed the shadow stack (sigstack). */
+
+static int
+fd_vm_jit_push( fd_vm_t * vm,
+                ulong     pc ) {
+  ulong            frame_cnt = vm->frame_cnt;
+  fd_vm_shadow_t * shadow    = vm->shadow + frame_cnt;
+  shadow->r6  = vm->reg[6];
+  shadow->r7  = vm->reg[7];
+  shadow->r8  = vm->reg[8];
+  shadow->r9  = vm->reg[9];
+  shadow->r10 = vm->reg[10];
+  shadow->pc  = pc;
+  vm->frame_cnt = ++frame_cnt;
+  if( FD_UNLIKELY( frame_cnt>=FD_VM_STACK_FRAME_MAX ) ) return 1;
+  if( !FD_VM_SBPF_DYNAMIC_STACK_FRAMES( vm->sbpf_version ) ) vm->reg[10] += vm->stack_frame_size;
+  return 0;
+}
+
+/* fd_vm_jit_callx does FD_SBPF_OP_CALL_REG (both the SIMD-0178 and
+   the deprecated variants) after billing.  reg_src is the value of the
+   src register before the push.  Returns the pc to continue at or a
+   negated fault kind. */
+
+static long
+fd_vm_jit_callx( fd_vm_t * vm,
+                 ulong     pc,
+                 ulong     reg_src,
+                 ulong     imm ) {
+  if( FD_UNLIKELY( fd_vm_jit_push( vm, pc ) ) ) return -(long)FD_VM_JIT_SIGSTACK;
+  ulong text_cnt = vm->text_cnt;
+  if( FD_VM_SBPF_STATIC_SYSCALLS( vm->sbpf_version ) ) {
+    ulong target_pc = (reg_src - vm->text_off) / 8UL;
+    if( FD_UNLIKELY( target_pc>=text_cnt ) ) return -(long)FD_VM_JIT_SIGTEXTBR;
+    if( FD_UNLIKELY( !fd_sbpf_calldests_test( vm->calldests, target_pc ) ) ) return -(long)FD_VM_JIT_SIGILLBR;
+    return (long)target_pc;
+  }
+  ulong vaddr     = FD_VM_SBPF_CALLX_USES_SRC_REG( vm->sbpf_version ) ? reg_src : vm->reg[ imm & 15UL ];
+  ulong region    = vaddr >> 32;
+  ulong target_pc = ((vaddr & FD_VM_OFFSET_MASK) - vm->text_off) / 8UL;
+  if( FD_UNLIKELY( (region!=1UL) | (target_pc>=text_cnt) ) ) return -(long)FD_VM_JIT_SIGTEXTBR;
+  return (long)target_pc;
+}
+
+/* fd_vm_jit_ret does FD_SBPF_OP_EXIT after billing.  Returns the pc to
+   continue at or a negated fault kind. */
+
+static long
+fd_vm_jit_ret( fd_vm_t * vm ) {
+  ulong frame_cnt = vm->frame_cnt;
+  if( FD_UNLIKELY( !frame_cnt ) ) return -(long)FD_VM_JIT_SIGEXIT;
+  frame_cnt--;
+  fd_vm_shadow_t const * shadow = vm->shadow + frame_cnt;
+  vm->reg[6]    = shadow->r6;
+  vm->reg[7]    = shadow->r7;
+  vm->reg[8]    = shadow->r8;
+  vm->reg[9]    = shadow->r9;
+  vm->reg[10]   = shadow->r10;
+  vm->frame_cnt = frame_cnt;
+  return (long)(shadow->pc + 1UL);
+}
+
+/* fd_vm_jit_syscall is FD_VM_INTERP_SYSCALL_EXEC.  The caller has
+   already stored the current ic and cu into vm.  Returns non-zero if
+   the syscall failed (sigsyscall).  Either way, vm->cu holds the cu
+   to continue with. */
+
+static int
+fd_vm_jit_syscall( fd_vm_t *                  vm,
+                   fd_sbpf_syscalls_t const * syscall,
+                   ulong                      pc ) {
+  ulong cu = vm->cu;
+  vm->pc = pc;
+  if( FD_UNLIKELY( vm->dump_syscall_to_pb ) ) {
+    fd_dump_vm_syscall_to_protobuf( vm, syscall->name );
+  }
+  ulong * reg = vm->reg;
+  ulong   ret[1];
+  int     err = syscall->func( vm, reg[1], reg[2], reg[3], reg[4], reg[5], ret );
+  reg[0] = ret[0];
+  ulong cu_req = vm->cu;
+  cu = fd_ulong_min( cu_req, cu );
+  if( FD_UNLIKELY( err ) ) {
+    if( err==FD_VM_SYSCALL_ERR_COMPUTE_BUDGET_EXCEEDED ) cu = 0UL; /* cmov */
+    vm->cu = cu;
+    FD_VM_TEST_ERR_EXISTS( vm );
+    return 1;
+  }
+  vm->cu = cu;
+  return 0;
+}
+
+/* x86-64 encoding *****************************************************/
+
+#define RAX (0UL)
+#define RCX (1UL)
+#define RDX (2UL)
+#define RBX (3UL)
+#define RSP (4UL)
+#define RBP (5UL)
+#define RSI (6UL)
+#define RDI (7UL)
+#define R12 (12UL)
+#define R13 (13UL)
+#define R14 (14UL)
+#define R15 (15UL)
+
+#define CC_B   (0x2UL)
+#define CC_AE  (0x3UL)
+#define CC_E   (0x4UL)
+#define CC_NE  (0x5UL)
+#define CC_BE  (0x6UL)
+#define CC_A   (0x7UL)
+#define CC_S   (0x8UL)
+#define CC_L   (0xcUL)
+#define CC_GE  (0xdUL)
+#define CC_LE  (0xeUL)
+#define CC_G   (0xfUL)
+
+#define OFF_REG(r) (offsetof( fd_vm_t, reg ) + 8UL*(r))
+#define OFF_IC     (offsetof( fd_vm_t, ic  ))
+#define OFF_CU     (offsetof( fd_vm_t, cu  ))
+
+static inline void
+emit_u8( uchar ** p,
+         ulong    x ) {
+  **p = (uchar)x; (*p)++;
+}
+
+static inline void
+emit_u32( uchar ** p,
+          ulong    x ) {
+  FD_STORE( uint, *p, (uint)x ); *p += 4;
+}
+
+static inline void
+emit_u64( uchar ** p,
+          ulong    x ) {
+  FD_STORE( ulong, *p, x ); *p += 8;
+}
+
+static inline void
+emit_rex( uchar ** p,
+          ulong    w,
+          ulong    r,
+          ulong    x,
+          ulong    b ) {
+  ulong rex = 0x40UL | (w<<3) | ((r>>3)<<2) | ((x>>3)<<1) | (b>>3);
+  if( rex!=0x40UL ) emit_u8( p, rex );
+}
+
+/* op is a one byte opcode or a 0x0fxx two byte opcode */
+
+static inline void
+emit_op( uchar ** p,
+         ulong    op ) {
+  if( op>0xffUL ) emit_u8( p, op>>8 );
+  emit_u8( p, op & 0xffUL );
+}
+
+/* emit_rr emits "op rm, reg" (or "op reg, rm") with a register rm */
+
+static inline void
+emit_rr( uchar ** p,
+         ulong    w,
+         ulong    op,
+         ulong    reg,
+         ulong    rm ) {
+  emit_rex( p, w, reg, 0UL, rm );
+  emit_op ( p, op );
+  emit_u8 ( p, 0xc0UL | ((reg&7UL)<<3) | (rm&7UL) );
+}
+
+/* emit_rm emits "op [base+disp32], reg" (or "op reg, [base+disp32]").
+   base cannot be rsp or r12. */
+
+static inline void
+emit_rm( uchar ** p,
+         ulong    w,
+         ulong    op,
+         ulong    reg,
+         ulong    base,
+         ulong    disp ) {
+  emit_rex( p, w, reg, 0UL, base );
+  emit_op ( p, op );
+  emit_u8 ( p, 0x80UL | ((reg&7UL)<<3) | (base&7UL) );
+  emit_u32( p, disp );
+}
+
+/* emit_rm0 emits "op [base], reg" (or "op reg, [base]").  base cannot
+   be rsp, rbp, r12 or r13. */
+
+static inline void
+emit_rm0( uchar ** p,
+          ulong    w,
+          ulong    op,
+          ulong    reg,
+          ulong    base ) {
+  emit_rex( p, w, reg, 0UL, base );
+  emit_op ( p, op );
+  emit_u8 ( p, ((reg&7UL)<<3) | (base&7UL) );
+}
+
+/* emit_sib emits "op [base+index*(1<<scale)+disp32], reg" */
+
+static inline void
+emit_sib( uchar ** p,
+          ulong    w,
+          ulong    op,
+          ulong    reg,
+          ulong    base,
+          ulong    index,
+          ulong    scale,
+          ulong    disp ) {
+  emit_rex( p, w, reg, index, base );
+  emit_op ( p, op );
+  emit_u8 ( p, 0x80UL | ((reg&7UL)<<3) | 4UL );
+  emit_u8 ( p, (scale<<6) | ((index&7UL)<<3) | (base&7UL) );
+  emit_u32( p, disp );
+}
+
+/* mov r32, imm32 (zero extends) */
+
+static inline void
+emit_mov32( uchar ** p,
+            ulong    r,
+            ulong    imm ) {
+  emit_rex( p, 0UL, 0UL, 0UL, r );
+  emit_u8 ( p, 0xb8UL + (r&7UL) );
+  emit_u32( p, imm );
+}
+
+/* mov r64, imm64 */
+
+static inline void
+emit_mov64( uchar ** p,
+            ulong    r,
+            ulong    imm ) {
+  emit_rex( p, 1UL, 0UL, 0UL, r );
+  emit_u8 ( p, 0xb8UL + (r&7UL) );
+  emit_u64( p, imm );
+}
+
+/* mov r64, simm32 (sign extends) */
+
+static inline void
+emit_movs32( uchar ** p,
+             ulong    r,
+             ulong    imm ) {
+  emit_rr ( p, 1UL, 0xc7UL, 0UL, r );
+  emit_u32( p, imm );
+}
+
+static inline void
+emit_call( uchar ** p,
+           ulong    fn ) {
+  emit_mov64( p, RAX, fn );
+  emit_rr   ( p, 0UL, 0xffUL, 2UL, RAX ); /* call rax */
+}
+
+/* emit_{jcc,jmp} emit a jump with a rel32 to be patched and return the
+   location of the rel32 */
+
+static inline uchar *
+emit_jcc( uchar ** p,
+          ulong    cc ) {
+  emit_u8( p, 0x0fUL );
+  emit_u8( p, 0x80UL | cc );
+  uchar * rel = *p;
+  emit_u32( p, 0UL );
+  return rel;
+}
+
+static inline uchar *
+emit_jmp( uchar ** p ) {
+  emit_u8( p, 0xe9UL );
+  uchar * rel = *p;
+  emit_u32( p, 0UL );
+  return rel;
+}
+
+static inline void
+patch_rel32( uchar *       rel,
+             uchar const * target ) {
+  FD_STORE( uint, rel, (uint)(int)((long)target - (long)(rel+4)) );
+}
+
+/* Code generation *****************************************************/
+
+struct fd_vm_jit_asm {
+  uchar *             code;     /* start of code */
+  uchar *             hot;      /* hot area cursor */
+  uchar *             cold;     /* cold area cursor */
+  uchar *             l_fault;   /* exit with rsi: kind, rdx: pc */
+  uchar *             l_textdyn; /* exit with sigtext at pc rax */
+  ulong               text_cnt;
+  fd_vm_jit_fixup_t * fixup;
+  ulong               fixup_cnt;
+};
+
+typedef struct fd_vm_jit_asm fd_vm_jit_asm_t;
+
+/* emit_fault_stub emits a cold stub that exits with kind at pc and
+   returns its location */
+
+static uchar *
+emit_fault_stub( fd_vm_jit_asm_t * a,
+                 ulong             kind,
+                 ulong             pc ) {
+  uchar * stub = a->cold;
+  emit_mov32 ( &a->cold, RSI, kind );
+  emit_mov32 ( &a->cold, RDX, pc   );
+  patch_rel32( emit_jmp( &a->cold ), a->l_fault );
+  return stub;
+}
+
+/* emit_fault emits an inline hot exit with kind at pc */
+
+static void
+emit_fault( fd_vm_jit_asm_t * a,
+            ulong             kind,
+            ulong             pc ) {
+  emit_mov32 ( &a->hot, RSI, kind );
+  emit_mov32 ( &a->hot, RDX, pc   );
+  patch_rel32( emit_jmp( &a->hot ), a->l_fault );
+}
+
+static void
+emit_fault_cc( fd_vm_jit_asm_t * a,
+               ulong             cc,
+               ulong             kind,
+               ulong             pc ) {
+  uchar * rel = emit_jcc( &a->hot, cc );
+  patch_rel32( rel, emit_fault_stub( a, kind, pc ) );
+}
+
+static void
+emit_fixup( fd_vm_jit_asm_t * a,
+            uchar *           rel,
+            ulong             target_pc ) {
+  fd_vm_jit_fixup_t * fixup = a->fixup + (a->fixup_cnt++);
+  fixup->rel = (uint)(ulong)(rel - a->code);
+  fixup->pc  = (uint)target_pc;
+}
+
+/* emit_charge is FD_VM_INTERP_BRANCH_BEGIN for a branch at pc */
+
+static void
+emit_charge( fd_vm_jit_asm_t * a,
+             ulong             pc ) {
+  emit_mov32   ( &a->hot, RAX, pc+1UL );
+  emit_rr      ( &a->hot, 1UL, 0x29UL, R12, RAX ); /* sub rax, r12 */
+  emit_rr      ( &a->hot, 1UL, 0x01UL, RAX, R14 ); /* add r14, rax */
+  emit_rr      ( &a->hot, 1UL, 0x39UL, R15, RAX ); /* cmp rax, r15 */
+  emit_fault_cc( a, CC_A, FD_VM_JIT_SIGCOST, pc );
+  emit_rr      ( &a->hot, 1UL, 0x29UL, RAX, R15 ); /* sub r15, rax */
+}
+
+/* emit_goto starts a new linear segment at target_pc and continues
+   execution there (FD_VM_INTERP_BRANCH_END).  If cc is not ULONG_MAX,
+   this is done only if the flags satisfy cc (the flags are preserved)
+   and r12 is set to pc+1 otherwise. */
+
+static void
+emit_goto( fd_vm_jit_asm_t * a,
+           ulong             cc,
+           ulong             pc,
+           ulong             target_pc,
+           ulong             text_cnt ) {
+  if( cc!=ULONG_MAX ) emit_mov32( &a->hot, R12, pc+1UL );
+  if( FD_LIKELY( target_pc<text_cnt ) ) {
+    if( cc==ULONG_MAX ) {
+      emit_mov32( &a->hot, R12, target_pc );
+      emit_fixup( a, emit_jmp( &a->hot ), target_pc );
+    } else {
+      emit_mov32( &a->hot, RDX, target_pc );
+      emit_rr   ( &a->hot, 0UL, 0x0f40UL | cc, R12, RDX ); /* cmovcc r12d, edx */
+      emit_fixup( a, emit_jcc( &a->hot, cc ), target_pc );
+    }
+    return;
+  }
+  /* The target is outside the text.  The interpreter would start a new
+     segment at target_pc and immediately sigtext there. */
+  uchar * stub = a->cold;
+  emit_mov64 ( &a->cold, R12, target_pc );
+  emit_rr    ( &a->cold, 1UL, 0x89UL, R12, RDX ); /* mov rdx, r12 */
+  emit_mov32 ( &a->cold, RSI, FD_VM_JIT_SIGTEXT );
+  patch_rel32( emit_jmp( &a->cold ), a->l_fault );
+  patch_rel32( cc==ULONG_MAX ? emit_jmp( &a->hot ) : emit_jcc( &a->hot, cc ), stub );
+}
+
+
+/* emit_dispatch continues execution at the pc returned in rax by a
+   helper called from the branch at pc (or exits with the fault kind
+   in -rax if negative). */
+
+static void
+emit_dispatch( fd_vm_jit_asm_t * a,
+               ulong             pc ) {
+  emit_rr    ( &a->hot, 1UL, 0x85UL, RAX, RAX ); /* test rax, rax */
+  patch_rel32( emit_jcc( &a->hot, CC_S ), a->cold );
+  emit_rr    ( &a->cold, 0UL, 0x89UL, RAX, RSI ); /* mov esi, eax */
+  emit_rr    ( &a->cold, 0UL, 0xf7UL, 3UL, RSI ); /* neg esi */
+  emit_mov32 ( &a->cold, RDX, pc );
+  patch_rel32( emit_jmp( &a->cold ), a->l_fault );
+
+  emit_rr    ( &a->hot, 1UL, 0x89UL, RAX, R12 ); /* mov r12, rax */
+  emit_rr    ( &a->hot, 1UL, 0x81UL, 7UL, RAX ); /* cmp rax, text_cnt */
+  emit_u32   ( &a->hot, a->text_cnt );
+  patch_rel32( emit_jcc( &a->hot, CC_AE ), a->l_textdyn );
+  emit_sib   ( &a->hot, 0UL, 0xffUL, 4UL, R13, RAX, 3UL, 0UL ); /* jmp [r13+rax*8] */
+}
+
+/* Register file access */
+
+static inline void
+emit_ld_reg( fd_vm_jit_asm_t * a,
+             ulong             w,
+             ulong             r,
+             ulong             src ) {
+  emit_rm( &a->hot, w, 0x8bUL, r, RBX, OFF_REG( src ) ); /* mov r, [vm->reg+src] */
+}
+
+static inline void
+emit_st_reg( fd_vm_jit_asm_t * a,
+             ulong             r,
+             ulong             dst ) {
+  emit_rm( &a->hot, 1UL, 0x89UL, r, RBX, OFF_REG( dst ) ); /* mov [vm->reg+dst], r */
+}
+
+static inline void
+emit_movsxd( fd_vm_jit_asm_t * a ) {
+  emit_rr( &a->hot, 1UL, 0x63UL, RAX, RAX ); /* movsxd rax, eax */
+}
+
+/* emit_mem emits a load (st==0) or a store (st==1) of sz bytes at the
+   sBPF address reg[base]+offset.  For loads, the result goes to
+   reg[dst].  For stores, the value is reg[val] if val_is_reg and the
+   sign extended imm val otherwise.  This is the fd_vm_mem_haddr /
+   fd_vm_mem_{ld,st}_N sequence of the interpreter with the program,
+   stack (if no gaps) and heap regions handled inline. */
+
+static void
+emit_mem( fd_vm_jit_asm_t * a,
+          ulong             pc,
+          int               st,
+          ulong             sz,
+          ulong             base,
+          ulong             offset,
+          ulong             dst,
+          int               val_is_reg,
+          ulong             val,
+          int               stack_gaps ) {
+
+  /* rax = vaddr, ecx = region */
+
+  emit_ld_reg( a, 1UL, RAX, base );
+  if( offset ) {
+    emit_rr ( &a->hot, 1UL, 0x81UL, 0UL, RAX ); /* add rax, offset */
+    emit_u32( &a->hot, offset );
+  }
+  emit_rr ( &a->hot, 1UL, 0x89UL, RAX, RCX ); /* mov rcx, rax */
+  emit_rr ( &a->hot, 1UL, 0xc1UL, 5UL, RCX ); /* shr rcx, 32 */
+  emit_u8 ( &a->hot, 32UL );
+
+  /* Regions 1-3 (program, stack, heap) are translated inline.  Region
+     0 always faults and everything else needs the full translation. */
+
+  emit_u8 ( &a->hot, 0x8dUL ); emit_u8( &a->hot, 0x51UL ); emit_u8( &a->hot, 0xffUL ); /* lea edx, [rcx-1] */
+  emit_rr ( &a->hot, 0UL, 0x83UL, 7UL, RDX ); emit_u8( &a->hot, 2UL );              /* cmp edx, 2 */
+  uchar * slow0 = emit_jcc( &a->hot, CC_A );
+  uchar * slow1 = NULL;
+  if( stack_gaps ) {
+    emit_rr( &a->hot, 0UL, 0x83UL, 7UL, RCX ); emit_u8( &a->hot, FD_VM_STACK_REGION ); /* cmp ecx, 2 */
+    slow1 = emit_jcc( &a->hot, CC_E );
+  }
+
+  /* haddr = region_haddr[region] + offset if offset+sz<=region_sz */
+
+  ulong off_sz = st ? offsetof( fd_vm_t, region_st_sz ) : offsetof( fd_vm_t, region_ld_sz );
+  emit_rr ( &a->hot, 0UL, 0x89UL, RAX, RDX );                           /* mov edx, eax */
+  emit_u8 ( &a->hot, 0x48UL ); emit_u8( &a->hot, 0x8dUL ); emit_u8( &a->hot, 0x72UL ); emit_u8( &a->hot, sz ); /* lea rsi, [rdx+sz] */
+  emit_sib( &a->hot, 0UL, 0x8bUL, RDI, RBX, RCX, 2UL, off_sz );          /* mov edi, [vm->region_sz+4*region] */
+  emit_rr ( &a->hot, 1UL, 0x39UL, RDI, RSI );                           /* cmp rsi, rdi */
+  uchar * slow2 = emit_jcc( &a->hot, CC_A );
+  emit_sib( &a->hot, 1UL, 0x03UL, RDX, RBX, RCX, 3UL, offsetof( fd_vm_t, region_haddr ) ); /* add rdx, [vm->region_haddr+8*region] */
+
+  if( !st ) {
+    switch( sz ) {
+    case 1UL: emit_rm0( &a->hot, 0UL, 0x0fb6UL, RAX, RDX ); break; /* movzx eax, byte  [rdx] */
+    case 2UL: emit_rm0( &a->hot, 0UL, 0x0fb7UL, RAX, RDX ); break; /* movzx eax, word  [rdx] */
+    case 4UL: emit_rm0( &a->hot, 0UL, 0x8bUL,   RAX, RDX ); break; /* mov   eax, dword [rdx] */
+    default:  emit_rm0( &a->hot, 1UL, 0x8bUL,   RAX, RDX ); break; /* mov   rax, qword [rdx] */
+    }
+    emit_st_reg( a, RAX, dst );
+  } else {
+    if( val_is_reg ) emit_ld_reg( a, 1UL, RCX, val );
+    else             { emit_rr( &a->hot, 1UL, 0xc7UL, 0UL, RCX ); emit_u32( &a->hot, val ); } /* mov rcx, simm32 */
+    switch( sz ) {
+    case 1UL:                               emit_rm0( &a->hot, 0UL, 0x88UL, RCX, RDX ); break; /* mov [rdx], cl  */
+    case 2UL: emit_u8( &a->hot, 0x66UL );   emit_rm0( &a->hot, 0UL, 0x89UL, RCX, RDX ); break; /* mov [rdx], cx  */
+    case 4UL:                               emit_rm0( &a->hot, 0UL, 0x89UL, RCX, RDX ); break; /* mov [rdx], ecx */
+    default:                                emit_rm0( &a->hot, 1UL, 0x89UL, RCX, RDX ); break; /* mov [rdx], rcx */
+    }
+  }
+  uchar * done = a->hot;
+
+  /* Out of line translation (rax still holds vaddr) */
+
+  uchar * slow = a->cold;
+  patch_rel32( slow0, slow );
+  if( slow1 ) patch_rel32( slow1, slow );
+  patch_rel32( slow2, slow );
+
+  emit_rr   ( &a->cold, 1UL, 0x89UL, RBX, RDI ); /* mov rdi, rbx */
+  emit_rr   ( &a->cold, 1UL, 0x89UL, RAX, RSI ); /* mov rsi, rax */
+  emit_mov32( &a->cold, RDX, sz );
+  if( !st ) {
+    emit_rm  ( &a->cold, 1UL, 0x8dUL, RCX, RBX, OFF_REG( dst ) ); /* lea rcx, [vm->reg+dst] */
+    emit_call( &a->cold, (ulong)fd_vm_jit_ld );
+  } else {
+    if( val_is_reg ) emit_rm( &a->cold, 1UL, 0x8bUL, RCX, RBX, OFF_REG( val ) );   /* mov rcx, [vm->reg+val] */
+    else             { emit_rr( &a->cold, 1UL, 0xc7UL, 0UL, RCX ); emit_u32( &a->cold, val ); } /* mov rcx, simm32 */
+    emit_call( &a->cold, (ulong)fd_vm_jit_st );
+  }
+  emit_rr    ( &a->cold, 0UL, 0x85UL, RAX, RAX ); /* test eax, eax */
+  patch_rel32( emit_jcc( &a->cold, CC_E ), done );
+  emit_mov32 ( &a->cold, RSI, FD_VM_JIT_SIGSEGV );
+  emit_mov32 ( &a->cold, RDX, pc );
+  patch_rel32( emit_jmp( &a->cold ), a->l_fault );
+}
+
+/* emit_div emits unsigned (sgn==0) or signed (sgn==1) division of
+   reg[dst] (w==0: as 32-bit, w==1: as 64-bit) by reg[src] (src_is_reg)
+   or by the imm (zero extended if w==0 or zx, sign extended otherwise)
+   and stores the quotient (rem==0) or remainder (rem==1) zero extended
+   into reg[dst].  Division by zero and signed overflow are checked
+   exactly like the interpreter does.  Division by an imm zero is
+   rejected by fd_vm_validate. */
+
+static void
+emit_div( fd_vm_jit_asm_t * a,
+          ulong             pc,
+          ulong             w,
+          int               sgn,
+          int               rem,
+          ulong             dst,
+          int               src_is_reg,
+          ulong             src,
+          uint              imm,
+          int               zx ) {
+  emit_ld_reg( a, w, RAX, dst );
+  if( src_is_reg ) {
+    emit_ld_reg  ( a, w, RCX, src );
+    emit_rr      ( &a->hot, w, 0x85UL, RCX, RCX ); /* test rcx, rcx */
+    emit_fault_cc( a, CC_E, FD_VM_JIT_SIGFPE, pc );
+  } else {
+    if( w && !zx ) emit_movs32( &a->hot, RCX, (ulong)imm );
+    else           emit_mov32 ( &a->hot, RCX, (ulong)imm );
+  }
+
+  if( sgn && ( src_is_reg || (int)imm==-1 ) ) {
+    uchar * skip = NULL;
+    if( src_is_reg ) {
+      emit_rr( &a->hot, w, 0x83UL, 7UL, RCX ); emit_u8( &a->hot, 0xffUL ); /* cmp rcx, -1 */
+      emit_u8( &a->hot, 0x70UL | CC_NE ); skip = a->hot; emit_u8( &a->hot, 0UL ); /* jne skip */
+    }
+    if( w ) {
+      emit_mov64( &a->hot, RDX, (ulong)LONG_MIN );
+      emit_rr   ( &a->hot, 1UL, 0x39UL, RDX, RAX ); /* cmp rax, rdx */
+    } else {
+      emit_u8   ( &a->hot, 0x3dUL ); emit_u32( &a->hot, (ulong)(uint)INT_MIN ); /* cmp eax, INT_MIN */
+    }
+    emit_fault_cc( a, CC_E, FD_VM_JIT_SIGFPEOF, pc );
+    if( skip ) *skip = (uchar)(a->hot - (skip+1));
+  }
+
+  if( sgn ) {
+    if( w ) emit_u8( &a->hot, 0x48UL );
+    emit_u8( &a->hot, 0x99UL );                   /* cdq / cqo */
+    emit_rr( &a->hot, w, 0xf7UL, 7UL, RCX );      /* idiv rcx */
+  } else {
+    emit_rr( &a->hot, 0UL, 0x31UL, RDX, RDX );    /* xor edx, edx */
+    emit_rr( &a->hot, w, 0xf7UL, 6UL, RCX );      /* div rcx */
+  }
+  emit_st_reg( a, rem ? RDX : RAX, dst );
+}
+
+/* fd_vm_jit_label returns the interpreter label (see
+   fd_vm_interp_core.c) that executes opcode under sbpf_version.
+   Labels are the opcode, the opcode | FD_VM_JIT_DEPR for the "depr"
+   labels and FD_VM_JIT_LABEL_SIGILL for sigill.  This mirrors the
+   jump table and the SBPF version specific updates done at the top of
+   the interpreter core. */
+
+#define FD_VM_JIT_DEPR         (0x100UL)
+#define FD_VM_JIT_LABEL_SIGILL (ULONG_MAX)
+
+static ulong
+fd_vm_jit_label( ulong sbpf_version,
+                 ulong opcode ) {
+
+  /* The jump table is the same for all SBPF versions before the SBPF
+     version specific updates below */
+
+  static uchar const valid[ 256 ] = {
+    [0x04]=1, [0x05]=1, [0x07]=1, [0x0c]=1, [0x0f]=1, [0x14]=1, [0x15]=1, [0x17]=1,
+    [0x1c]=1, [0x1d]=1, [0x1f]=1, [0x25]=1, [0x2d]=1, [0x35]=1, [0x36]=1, [0x3d]=1,
+    [0x3e]=1, [0x44]=1, [0x45]=1, [0x46]=1, [0x47]=1, [0x4c]=1, [0x4d]=1, [0x4e]=1,
+    [0x4f]=1, [0x54]=1, [0x55]=1, [0x56]=1, [0x57]=1, [0x5c]=1, [0x5d]=1, [0x5e]=1,
+    [0x5f]=1, [0x64]=1, [0x65]=1, [0x66]=1, [0x67]=1, [0x6c]=1, [0x6d]=1, [0x6e]=1,
+    [0x6f]=1, [0x74]=1, [0x75]=1, [0x76]=1, [0x77]=1, [0x7c]=1, [0x7d]=1, [0x7e]=1,
+    [0x7f]=1, [0x85]=1, [0x86]=1, [0x8c]=1, [0x8d]=1, [0x8e]=1, [0x8f]=1, [0x95]=1,
+    [0x96]=1, [0x9e]=1, [0xa4]=1, [0xa5]=1, [0xa7]=1, [0xac]=1, [0xad]=1, [0xaf]=1,
+    [0xb4]=1, [0xb5]=1, [0xb6]=1, [0xb7]=1, [0xbc]=1, [0xbd]=1, [0xbe]=1, [0xbf]=1,
+    [0xc4]=1, [0xc5]=1, [0xc6]=1, [0xc7]=1, [0xcc]=1, [0xcd]=1, [0xce]=1, [0xcf]=1,
+    [0xd5]=1, [0xd6]=1, [0xdc]=1, [0xdd]=1, [0xde]=1, [0xe6]=1, [0xee]=1, [0xf6]=1,
+    [0xf7]=1, [0xfe]=1
+  };
+
+  ulong v     = sbpf_version;
+  int   mm    = !!FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( v );
+  int   pqr   = !!FD_VM_SBPF_ENABLE_PQR( v );
+  ulong ill   = FD_VM_JIT_LABEL_SIGILL;
+  ulong depr  = FD_VM_JIT_DEPR;
+
+  switch( opcode ) {
+  /* SIMD-0173: LDDW */
+  case 0x18: return FD_VM_SBPF_ENABLE_LDDW( v ) ? 0x18UL : ill;
+  case 0xf7: return FD_VM_SBPF_ENABLE_LDDW( v ) ? ill    : 0xf7UL; /* HOR64 */
+
+  /* SIMD-0173: LE */
+  case 0xd4: return FD_VM_SBPF_ENABLE_LE( v ) ? 0xd4UL : ill;
+
+  /* SIMD-0173: LDXW, STW, STXW */
+  case 0x61: return mm ? ill    : 0x8cUL;
+  case 0x62: return mm ? ill    : 0x87UL;
+  case 0x63: return mm ? ill    : 0x8fUL;
+  case 0x8c: return mm ? 0x8cUL : ill;
+  case 0x87: return mm ? 0x87UL : (0x87UL|depr);
+  case 0x8f: return mm ? 0x8fUL : ill;
+
+  /* SIMD-0173: LDXH, STH, STXH */
+  case 0x69: return mm ? ill    : 0x3cUL;
+  case 0x6a: return mm ? ill    : 0x37UL;
+  case 0x6b: return mm ? ill    : 0x3fUL;
+  case 0x3c: return mm ? 0x3cUL : (0x3cUL|depr);
+  case 0x37: return mm ? 0x37UL : (0x37UL|depr);
+  case 0x3f: return mm ? 0x3fUL : (0x3fUL|depr);
+
+  /* SIMD-0173: LDXB, STB, STXB */
+  case 0x71: return mm ? ill    : 0x2cUL;
+  case 0x72: return mm ? ill    : 0x27UL;
+  case 0x73: return mm ? ill    : 0x2fUL;
+  case 0x2c: return mm ? 0x2cUL : (0x2cUL|depr);
+  case 0x27: return mm ? 0x27UL : (0x27UL|depr);
+  case 0x2f: return mm ? 0x2fUL : (0x2fUL|depr);
+
+  /* SIMD-0173: LDXDW, STDW, STXDW */
+  case 0x79: return mm ? ill    : 0x9cUL;
+  case 0x7a: return mm ? ill    : 0x97UL;
+  case 0x7b: return mm ? ill    : 0x9fUL;
+  case 0x9c: return mm ? 0x9cUL : (0x9cUL|depr);
+  case 0x97: return mm ? 0x97UL : (0x97UL|depr);
+  case 0x9f: return mm ? 0x9fUL : (0x9fUL|depr);
+
+  /* SIMD-0174: PQR */
+  case 0x36: case 0x3e: case 0x46: case 0x4e: case 0x56: case 0x5e: case 0x66: case 0x6e:
+  case 0x76: case 0x7e: case 0x86: case 0x8e: case 0x96: case 0x9e: case 0xb6: case 0xbe:
+  case 0xc6: case 0xce: case 0xd6: case 0xde: case 0xe6: case 0xee: case 0xf6: case 0xfe:
+    return pqr ? opcode : ill;
+
+  /* SIMD-0174: disable MUL, DIV, MOD */
+  case 0x24: case 0x34: case 0x94: return pqr ? ill : opcode;
+
+  /* SIMD-0174: NEG */
+  case 0x84: return FD_VM_SBPF_ENABLE_NEG( v ) ? 0x84UL : ill;
+
+  /* SIMD-0174: Explicit Sign Extension + Register Immediate Subtraction */
+  case 0x04: case 0x0c: case 0x1c: case 0xbc:
+    return FD_VM_SBPF_EXPLICIT_SIGN_EXT( v ) ? opcode : (opcode|depr);
+  case 0x14: case 0x17:
+    return FD_VM_SBPF_SWAP_SUB_REG_IMM_OPERANDS( v ) ? opcode : (opcode|depr);
+
+  /* SIMD-0178: static syscalls */
+  case 0x85: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? 0x85UL : (0x85UL|depr);
+  case 0x95: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? 0x95UL : 0x9dUL;
+  case 0x9d: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? 0x9dUL : ill;
+
+  /* SIMD-0173 + SIMD-0179: CALLX */
+  case 0x8d: return FD_VM_SBPF_STATIC_SYSCALLS( v ) ? 0x8dUL : (0x8dUL|depr);
+
+  default: return valid[ opcode ] ? opcode : ill;
+  }
+}
+
+/* emit_syscall emits a call to syscall for the branch at pc
+   (FD_VM_INTERP_SYSCALL_EXEC after billing). */
+
+static void
+emit_syscall( fd_vm_jit_asm_t *          a,
+              ulong                      pc,
+              fd_sbpf_syscalls_t const * syscall ) {
+  emit_rm      ( &a->hot, 1UL, 0x89UL, R14, RBX, OFF_IC ); /* mov [vm->ic], r14 */
+  emit_rm      ( &a->hot, 1UL, 0x89UL, R15, RBX, OFF_CU ); /* mov [vm->cu], r15 */
+  emit_rr      ( &a->hot, 1UL, 0x89UL, RBX, RDI );         /* mov rdi, rbx */
+  emit_mov64   ( &a->hot, RSI, (ulong)syscall );
+  emit_mov32   ( &a->hot, RDX, pc );
+  emit_call    ( &a->hot, (ulong)fd_vm_jit_syscall );
+  emit_rm      ( &a->hot, 1UL, 0x8bUL, R15, RBX, OFF_CU ); /* mov r15, [vm->cu] */
+  emit_rr      ( &a->hot, 0UL, 0x85UL, RAX, RAX );         /* test eax, eax */
+  emit_fault_cc( a, CC_NE, FD_VM_JIT_SIGSYSCALL, pc );
+  emit_mov32   ( &a->hot, R12, pc+1UL );
+}
+
+/* emit_call_local emits FD_VM_INTERP_STACK_PUSH followed by a jump to
+   target_pc for the branch at pc */
+
+static void
+emit_call_local( fd_vm_jit_asm_t * a,
+                 ulong             pc,
+                 ulong             target_pc ) {
+  emit_rr      ( &a->hot, 1UL, 0x89UL, RBX, RDI ); /* mov rdi, rbx */
+  emit_mov32   ( &a->hot, RSI, pc );
+  emit_call    ( &a->hot, (ulong)fd_vm_jit_push );
+  emit_rr      ( &a->hot, 0UL, 0x85UL, RAX, RAX ); /* test eax, eax */
+  emit_fault_cc( a, CC_NE, FD_VM_JIT_SIGSTACK, pc );
+  emit_goto    ( a, ULONG_MAX, pc, target_pc, a->text_cnt );
+}
+
+/* emit_instr emits the code for the instruction at pc.  Returns 1 if
+   the instruction consumed the next text word too, 0 if not and -1 if
+   the program is malformed (cannot happen for validated programs). */
+
+static int
+emit_instr( fd_vm_jit_asm_t * a,
+            fd_vm_t const *   vm,
+            ulong             pc ) {
+  ulong const * text     = vm->text;
+  ulong         text_cnt = vm->text_cnt;
+  ulong         instr    = text[ pc ];
+  ulong         opcode   = fd_vm_instr_opcode( instr );
+  ulong         dst      = fd_vm_instr_dst   ( instr );
+  ulong         src      = fd_vm_instr_src   ( instr );
+  ulong         offset   = fd_vm_instr_offset( instr );
+  uint          imm      = fd_vm_instr_imm   ( instr );
+  ulong         simm     = (ulong)(long)(int)imm;
+  ulong         label    = fd_vm_jit_label( vm->sbpf_version, opcode );
+  ulong         jmp_pc   = pc + offset + 1UL; /* branch target */
+  int           gaps     = !vm->direct_mapping && !FD_VM_SBPF_DYNAMIC_STACK_FRAMES( vm->sbpf_version );
+  uchar **      h        = &a->hot;
+
+  /* ALU op (ext for imm forms, rm,reg form opcode) */
+
+# define ALU32_IMM( ext, sx ) do {                                       \
+    emit_ld_reg( a, 0UL, RAX, dst );                                     \
+    emit_rr( h, 0UL, 0x81UL, (ext), RAX ); emit_u32( h, (ulong)imm );    \
+    if( sx ) emit_movsxd( a );                                           \
+    emit_st_reg( a, RAX, dst );                                          \
+  } while(0)
+
+# define ALU32_REG( op, sx ) do {                                        \
+    emit_ld_reg( a, 0UL, RAX, dst );                                     \
+    emit_rm( h, 0UL, (op), RAX, RBX, OFF_REG( src ) );                   \
+    if( sx ) emit_movsxd( a );                                           \
+    emit_st_reg( a, RAX, dst );                                          \
+  } while(0)
+
+# define ALU64_IMM( ext ) do {                                           \
+    emit_rm( h, 1UL, 0x81UL, (ext), RBX, OFF_REG( dst ) );               \
+    emit_u32( h, (ulong)imm );                                           \
+  } while(0)
+
+# define ALU64_REG( op ) do {                                            \
+    emit_ld_reg( a, 1UL, RAX, src );                                     \
+    emit_rm( h, 1UL, (op), RAX, RBX, OFF_REG( dst ) );                   \
+  } while(0)
+
+# define SHIFT32_IMM( ext ) do {                                         \
+    emit_ld_reg( a, 0UL, RAX, dst );                                     \
+    emit_rr( h, 0UL, 0xc1UL, (ext), RAX ); emit_u8( h, imm & 31U );      \
+    emit_st_reg( a, RAX, dst );                                          \
+  } while(0)
+
+# define SHIFT64_IMM( ext ) do {                                         \
+    emit_rm( h, 1UL, 0xc1UL, (ext), RBX, OFF_REG( dst ) );               \
+    emit_u8( h, imm & 63U );                                             \
+  } while(0)
+
+# define SHIFT32_REG( ext ) do {                                         \
+    emit_ld_reg( a, 0UL, RAX, dst );                                     \
+    emit_ld_reg( a, 0UL, RCX, src );                                     \
+    emit_rr( h, 0UL, 0xd3UL, (ext), RAX );                               \
+    emit_st_reg( a, RAX, dst );                                          \
+  } while(0)
+
+# define SHIFT64_REG( ext ) do {                                         \
+    emit_ld_reg( a, 1UL, RCX, src );                                     \
+    emit_rm( h, 1UL, 0xd3UL, (ext), RBX, OFF_REG( dst ) );               \
+  } while(0)
+
+  /* Conditional jumps (FD_VM_INTERP_BRANCH_BEGIN/END) */
+
+# define JMP_IMM( cc ) do {                                              \
+    emit_charge( a, pc );                                                \
+    emit_rm( h, 1UL, 0x81UL, 7UL, RBX, OFF_REG( dst ) ); /* cmp */       \
+    emit_u32( h, (ulong)imm );                                           \
+    emit_goto( a, (cc), pc, jmp_pc, text_cnt );                          \
+  } while(0)
+
+# define JMP_REG( cc ) do {                                              \
+    emit_charge( a, pc );                                                \
+    emit_ld_reg( a, 1UL, RAX, dst );                                     \
+    emit_rm( h, 1UL, 0x3bUL, RAX, RBX, OFF_REG( src ) ); /* cmp */       \
+    emit_goto( a, (cc), pc, jmp_pc, text_cnt );                          \
+  } while(0)
+
+  switch( label ) {
+
+  /* 0x00 - 0x0f ******************************************************/
+
+  case 0x04:           ALU32_IMM( 0UL, 0 ); break; /* ADD_IMM */
+  case 0x04|FD_VM_JIT_DEPR: ALU32_IMM( 0UL, 1 ); break;
+  case 0x05: /* JA */
+    emit_charge( a, pc );
+    emit_goto  ( a, ULONG_MAX, pc, jmp_pc, text_cnt );
+    break;
+  case 0x07:           ALU64_IMM( 0UL );    break; /* ADD64_IMM */
+  case 0x0c:           ALU32_REG( 0x03UL, 0 ); break; /* ADD_REG */
+  case 0x0c|FD_VM_JIT_DEPR: ALU32_REG( 0x03UL, 1 ); break;
+  case 0x0f:           ALU64_REG( 0x01UL ); break; /* ADD64_REG */
+
+  /* 0x10 - 0x1f ******************************************************/
+
+  case 0x14: /* SUB_IMM */
+    emit_mov32 ( h, RAX, (ulong)imm );
+    emit_rm    ( h, 0UL, 0x2bUL, RAX, RBX, OFF_REG( dst ) ); /* sub eax, [dst] */
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0x14|FD_VM_JIT_DEPR: ALU32_IMM( 5UL, 1 ); break;
+  case 0x15: JMP_IMM( CC_E ); break; /* JEQ_IMM */
+  case 0x17: /* SUB64_IMM */
+    emit_movs32( h, RAX, (ulong)imm );
+    emit_rm    ( h, 1UL, 0x2bUL, RAX, RBX, OFF_REG( dst ) ); /* sub rax, [dst] */
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0x17|FD_VM_JIT_DEPR: ALU64_IMM( 5UL ); break;
+  case 0x18: { /* LDQ */
+    if( FD_UNLIKELY( pc+1UL>=text_cnt ) ) return -1; /* rejected by validation */
+    emit_mov64 ( h, RAX, (ulong)imm | ((ulong)fd_vm_instr_imm( text[ pc+1UL ] ) << 32) );
+    emit_st_reg( a, RAX, dst );
+    emit_rr    ( h, 1UL, 0xffUL, 0UL, R12 ); /* inc r12 (ic_correction++) */
+    return 1;
+  }
+  case 0x1c:           ALU32_REG( 0x2bUL, 0 ); break; /* SUB_REG */
+  case 0x1c|FD_VM_JIT_DEPR: ALU32_REG( 0x2bUL, 1 ); break;
+  case 0x1d: JMP_REG( CC_E ); break; /* JEQ_REG */
+  case 0x1f:           ALU64_REG( 0x29UL ); break; /* SUB64_REG */
+
+  /* 0x20 - 0x2f ******************************************************/
+
+  case 0x24: /* MUL_IMM */
+    emit_ld_reg( a, 0UL, RAX, dst );
+    emit_rr    ( h, 0UL, 0x69UL, RAX, RAX ); emit_u32( h, (ulong)imm ); /* imul eax, eax, imm */
+    emit_movsxd( a );
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0x25: JMP_IMM( CC_A ); break; /* JGT_IMM */
+  case 0x27: emit_mem( a, pc, 1, 1UL, dst, offset, 0UL, 0, simm, gaps ); break; /* STB */
+  case 0x27|FD_VM_JIT_DEPR: /* MUL64_IMM */
+  case 0x96:                /* LMUL64_IMM */
+    emit_ld_reg( a, 1UL, RAX, dst );
+    emit_rr    ( h, 1UL, 0x69UL, RAX, RAX ); emit_u32( h, (ulong)imm ); /* imul rax, rax, imm */
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0x2c: emit_mem( a, pc, 0, 1UL, src, offset, dst, 0, 0UL, gaps ); break; /* LDXB */
+  case 0x2c|FD_VM_JIT_DEPR: ALU32_REG( 0x0fafUL, 1 ); break; /* MUL_REG */
+  case 0x2d: JMP_REG( CC_A ); break; /* JGT_REG */
+  case 0x2f: emit_mem( a, pc, 1, 1UL, dst, offset, 0UL, 1, src, gaps ); break; /* STXB */
+  case 0x2f|FD_VM_JIT_DEPR: /* MUL64_REG */
+  case 0x9e:                /* LMUL64_REG */
+    emit_ld_reg( a, 1UL, RAX, dst );
+    emit_rm    ( h, 1UL, 0x0fafUL, RAX, RBX, OFF_REG( src ) ); /* imul rax, [src] */
+    emit_st_reg( a, RAX, dst );
+    break;
+
+  /* 0x30 - 0x3f ******************************************************/
+
+  case 0x34: /* DIV_IMM */
+  case 0x46: /* UDIV32_IMM */
+    emit_div( a, pc, 0UL, 0, 0, dst, 0, 0UL, imm, 1 ); break;
+  case 0x35: JMP_IMM( CC_AE ); break; /* JGE_IMM */
+  case 0x36: /* UHMUL64_IMM */
+    emit_ld_reg( a, 1UL, RAX, dst );
+    emit_mov32 ( h, RCX, (ulong)imm );
+    emit_rr    ( h, 1UL, 0xf7UL, 4UL, RCX ); /* mul rcx */
+    emit_st_reg( a, RDX, dst );
+    break;
+  case 0x37: emit_mem( a, pc, 1, 2UL, dst, offset, 0UL, 0, simm, gaps ); break; /* STH */
+  case 0x37|FD_VM_JIT_DEPR: emit_div( a, pc, 1UL, 0, 0, dst, 0, 0UL, imm, 0 ); break; /* DIV64_IMM */
+  case 0x3c: emit_mem( a, pc, 0, 2UL, src, offset, dst, 0, 0UL, gaps ); break; /* LDXH */
+  case 0x3c|FD_VM_JIT_DEPR: /* DIV_REG */
+  case 0x4e:                /* UDIV32_REG */
+    emit_div( a, pc, 0UL, 0, 0, dst, 1, src, 0U, 0 ); break;
+  case 0x3d: JMP_REG( CC_AE ); break; /* JGE_REG */
+  case 0x3e: /* UHMUL64_REG */
+    emit_ld_reg( a, 1UL, RAX, dst );
+    emit_rm    ( h, 1UL, 0xf7UL, 4UL, RBX, OFF_REG( src ) ); /* mul qword [src] */
+    emit_st_reg( a, RDX, dst );
+    break;
+  case 0x3f: emit_mem( a, pc, 1, 2UL, dst, offset, 0UL, 1, src, gaps ); break; /* STXH */
+  case 0x3f|FD_VM_JIT_DEPR: /* DIV64_REG */
+  case 0x5e:                /* UDIV64_REG */
+    emit_div( a, pc, 1UL, 0, 0, dst, 1, src, 0U, 0 ); break;
+
+  /* 0x40 - 0x4f ******************************************************/
+
+  case 0x44: ALU32_IMM( 1UL, 0 ); break; /* OR_IMM */
+  case 0x45: /* JSET_IMM */
+    emit_charge( a, pc );
+    emit_rm    ( h, 1UL, 0xf7UL, 0UL, RBX, OFF_REG( dst ) ); emit_u32( h, (ulong)imm ); /* test [dst], imm */
+    emit_goto  ( a, CC_NE, pc, jmp_pc, text_cnt );
+    break;
+  case 0x47: ALU64_IMM( 1UL ); break; /* OR64_IMM */
+  case 0x4c: ALU32_REG( 0x0bUL, 0 ); break; /* OR_REG */
+  case 0x4d: /* JSET_REG */
+    emit_charge( a, pc );
+    emit_ld_reg( a, 1UL, RAX, dst );
+    emit_rm    ( h, 1UL, 0x85UL, RAX, RBX, OFF_REG( src ) ); /* test [src], rax */
+    emit_goto  ( a, CC_NE, pc, jmp_pc, text_cnt );
+    break;
+  case 0x4f: ALU64_REG( 0x09UL ); break; /* OR64_REG */
+
+  /* 0x50 - 0x5f ******************************************************/
+
+  case 0x54: ALU32_IMM( 4UL, 0 ); break; /* AND_IMM */
+  case 0x55: JMP_IMM( CC_NE ); break; /* JNE_IMM */
+  case 0x56: emit_div( a, pc, 1UL, 0, 0, dst, 0, 0UL, imm, 1 ); break; /* UDIV64_IMM */
+  case 0x57: ALU64_IMM( 4UL ); break; /* AND64_IMM */
+  case 0x5c: ALU32_REG( 0x23UL, 0 ); break; /* AND_REG */
+  case 0x5d: JMP_REG( CC_NE ); break; /* JNE_REG */
+  case 0x5f: ALU64_REG( 0x21UL ); break; /* AND64_REG */
+
+  /* 0x60 - 0x6f ******************************************************/
+
+  case 0x64: SHIFT32_IMM( 4UL ); break; /* LSH_IMM */
+  case 0x65: JMP_IMM( CC_G ); break; /* JSGT_IMM */
+  case 0x66: emit_div( a, pc, 0UL, 0, 1, dst, 0, 0UL, imm, 1 ); break; /* UREM32_IMM */
+  case 0x67: SHIFT64_IMM( 4UL ); break; /* LSH64_IMM */
+  case 0x6c: SHIFT32_REG( 4UL ); break; /* LSH_REG */
+  case 0x6d: JMP_REG( CC_G ); break; /* JSGT_REG */
+  case 0x6e: emit_div( a, pc, 0UL, 0, 1, dst, 1, src, 0U, 0 ); break; /* UREM32_REG */
+  case 0x6f: SHIFT64_REG( 4UL ); break; /* LSH64_REG */
+
+  /* 0x70 - 0x7f ******************************************************/
+
+  case 0x74: SHIFT32_IMM( 5UL ); break; /* RSH_IMM */
+  case 0x75: JMP_IMM( CC_GE ); break; /* JSGE_IMM */
+  case 0x76: emit_div( a, pc, 1UL, 0, 1, dst, 0, 0UL, imm, 1 ); break; /* UREM64_IMM */
+  case 0x77: SHIFT64_IMM( 5UL ); break; /* RSH64_IMM */
+  case 0x7c: SHIFT32_REG( 5UL ); break; /* RSH_REG */
+  case 0x7d: JMP_REG( CC_GE ); break; /* JSGE_REG */
+  case 0x7e: emit_div( a, pc, 1UL, 0, 1, dst, 1, src, 0U, 0 ); break; /* UREM64_REG */
+  case 0x7f: SHIFT64_REG( 5UL ); break; /* RSH64_REG */
+
+  /* 0x80 - 0x8f ******************************************************/
+
+  case 0x84: /* NEG */
+    emit_ld_reg( a, 0UL, RAX, dst );
+    emit_rr    ( h, 0UL, 0xf7UL, 3UL, RAX ); /* neg eax */
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0x85: /* CALL_IMM */
+    emit_charge    ( a, pc );
+    emit_call_local( a, pc, pc + simm + 1UL );
+    break;
+  case 0x85|FD_VM_JIT_DEPR: { /* CALL_IMM */
+    emit_charge( a, pc );
+    fd_sbpf_syscalls_t const * syscall = imm!=fd_sbpf_syscalls_key_null() ? fd_sbpf_syscalls_query_const( vm->syscalls, (ulong)imm, NULL ) : NULL;
+    if( syscall ) {
+      emit_syscall( a, pc, syscall );
+    } else if( imm==0x71e3cf81U ) { /* See interpreter */
+      emit_call_local( a, pc, vm->entry_pc );
+    } else {
+      ulong target_pc = (ulong)fd_pchash_inverse( imm );
+      if( FD_UNLIKELY( (target_pc>=text_cnt) || !vm->calldests || !fd_sbpf_calldests_test( vm->calldests, target_pc ) ) ) {
+        emit_fault( a, FD_VM_JIT_SIGILLBR, pc );
+      } else {
+        emit_call_local( a, pc, target_pc );
+      }
+    }
+    break;
+  }
+  case 0x86: /* LMUL32_IMM */
+    emit_ld_reg( a, 0UL, RAX, dst );
+    emit_rr    ( h, 0UL, 0x69UL, RAX, RAX ); emit_u32( h, (ulong)imm ); /* imul eax, eax, imm */
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0x87: emit_mem( a, pc, 1, 4UL, dst, offset, 0UL, 0, simm, gaps ); break; /* STW */
+  case 0x87|FD_VM_JIT_DEPR: /* NEG64 */
+    emit_rm( h, 1UL, 0xf7UL, 3UL, RBX, OFF_REG( dst ) ); /* neg qword [dst] */
+    break;
+  case 0x8c: emit_mem( a, pc, 0, 4UL, src, offset, dst, 0, 0UL, gaps ); break; /* LDXW */
+  case 0x8d: /* CALL_REG */
+  case 0x8d|FD_VM_JIT_DEPR:
+    emit_charge  ( a, pc );
+    emit_rr      ( h, 1UL, 0x89UL, RBX, RDI ); /* mov rdi, rbx */
+    emit_mov32   ( h, RSI, pc );
+    emit_ld_reg  ( a, 1UL, RDX, src );
+    emit_mov32   ( h, RCX, (ulong)(imm & 15U) );
+    emit_call    ( h, (ulong)fd_vm_jit_callx );
+    emit_dispatch( a, pc );
+    break;
+  case 0x8e: ALU32_REG( 0x0fafUL, 0 ); break; /* LMUL32_REG */
+  case 0x8f: emit_mem( a, pc, 1, 4UL, dst, offset, 0UL, 1, src, gaps ); break; /* STXW */
+
+  /* 0x90 - 0x9f ******************************************************/
+
+  case 0x94: emit_div( a, pc, 0UL, 0, 1, dst, 0, 0UL, imm, 1 ); break; /* MOD_IMM */
+  case 0x95: { /* SYSCALL */
+    emit_charge( a, pc );
+    fd_sbpf_syscalls_t const * syscall = fd_sbpf_syscalls_query_const( vm->syscalls, (ulong)imm, NULL );
+    if( FD_UNLIKELY( !syscall ) ) emit_fault( a, FD_VM_JIT_SIGILLBR, pc );
+    else                          emit_syscall( a, pc, syscall );
+    break;
+  }
+  case 0x97: emit_mem( a, pc, 1, 8UL, dst, offset, 0UL, 0, simm, gaps ); break; /* STQ */
+  case 0x97|FD_VM_JIT_DEPR: emit_div( a, pc, 1UL, 0, 1, dst, 0, 0UL, imm, 0 ); break; /* MOD64_IMM */
+  case 0x9c: emit_mem( a, pc, 0, 8UL, src, offset, dst, 0, 0UL, gaps ); break; /* LDXQ */
+  case 0x9c|FD_VM_JIT_DEPR: emit_div( a, pc, 0UL, 0, 1, dst, 1, src, 0U, 0 ); break; /* MOD_REG */
+  case 0x9d: /* EXIT */
+    emit_charge  ( a, pc );
+    emit_rr      ( h, 1UL, 0x89UL, RBX, RDI ); /* mov rdi, rbx */
+    emit_call    ( h, (ulong)fd_vm_jit_ret );
+    emit_dispatch( a, pc );
+    break;
+  case 0x9f: emit_mem( a, pc, 1, 8UL, dst, offset, 0UL, 1, src, gaps ); break; /* STXQ */
+  case 0x9f|FD_VM_JIT_DEPR: emit_div( a, pc, 1UL, 0, 1, dst, 1, src, 0U, 0 ); break; /* MOD64_REG */
+
+  /* 0xa0 - 0xaf ******************************************************/
+
+  case 0xa4: ALU32_IMM( 6UL, 0 ); break; /* XOR_IMM */
+  case 0xa5: JMP_IMM( CC_B ); break; /* JLT_IMM */
+  case 0xa7: ALU64_IMM( 6UL ); break; /* XOR64_IMM */
+  case 0xac: ALU32_REG( 0x33UL, 0 ); break; /* XOR_REG */
+  case 0xad: JMP_REG( CC_B ); break; /* JLT_REG */
+  case 0xaf: ALU64_REG( 0x31UL ); break; /* XOR64_REG */
+
+  /* 0xb0 - 0xbf ******************************************************/
+
+  case 0xb4: /* MOV_IMM */
+    emit_mov32 ( h, RAX, (ulong)imm );
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0xb5: JMP_IMM( CC_BE ); break; /* JLE_IMM */
+  case 0xb6: /* SHMUL64_IMM */
+    emit_ld_reg( a, 1UL, RAX, dst );
+    emit_movs32( h, RCX, (ulong)imm );
+    emit_rr    ( h, 1UL, 0xf7UL, 5UL, RCX ); /* imul rcx */
+    emit_st_reg( a, RDX, dst );
+    break;
+  case 0xb7: /* MOV64_IMM */
+    emit_rm ( h, 1UL, 0xc7UL, 0UL, RBX, OFF_REG( dst ) ); /* mov qword [dst], simm32 */
+    emit_u32( h, (ulong)imm );
+    break;
+  case 0xbc: /* MOV_REG */
+    emit_rm    ( h, 1UL, 0x63UL, RAX, RBX, OFF_REG( src ) ); /* movsxd rax, dword [src] */
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0xbc|FD_VM_JIT_DEPR: /* MOV_REG */
+    emit_ld_reg( a, 0UL, RAX, src );
+    emit_st_reg( a, RAX, dst );
+    break;
+  case 0xbd: JMP_REG( CC_BE ); break; /* JLE_REG */
+  case 0xbe: /* SHMUL64_REG */
+    emit_ld_reg( a, 1UL, RAX, dst );
+    emit_rm    ( h, 1UL, 0xf7UL, 5UL, RBX, OFF_REG( src ) ); /* imul qword [src] */
+    emit_st_reg( a, RDX, dst );
+    break;
+  case 0xbf: /* MOV64_REG */
+    emit_ld_reg( a, 1UL, RAX, src );
+    emit_st_reg( a, RAX, dst );
+    break;
+
+  /* 0xc0 - 0xcf ******************************************************/
+
+  case 0xc4: SHIFT32_IMM( 7UL ); break; /* ARSH_IMM */
+  case 0xc5: JMP_IMM( CC_L ); break; /* JSLT_IMM */
+  case 0xc6: emit_div( a, pc, 0UL, 1, 0, dst, 0, 0UL, imm, 0 ); break; /* SDIV32_IMM */
+  case 0xc7: SHIFT64_IMM( 7UL ); break; /* ARSH64_IMM */
+  case 0xcc: SHIFT32_REG( 7UL ); break; /* ARSH_REG */
+  case 0xcd: JMP_REG( CC_L ); break; /* JSLT_REG */
+  case 0xce: emit_div( a, pc, 0UL, 1, 0, dst, 1, src, 0U, 0 ); break; /* SDIV32_REG */
+  case 0xcf: SHIFT64_REG( 7UL ); break; /* ARSH64_REG */
+
+  /* 0xd0 - 0xdf ******************************************************/
+
+  case 0xd4: /* END_LE */
+    switch( imm ) {
+    case 16U: emit_rm( h, 0UL, 0x0fb7UL, RAX, RBX, OFF_REG( dst ) ); emit_st_reg( a, RAX, dst ); break; /* movzx eax, word [dst] */
+    case 32U: emit_ld_reg( a, 0UL, RAX, dst );                       emit_st_reg( a, RAX, dst ); break;
+    case 64U:                                                                                    break;
+    default:  emit_fault( a, FD_VM_JIT_SIGINV, pc );                                             break;
+    }
+    break;
+  case 0xd5: JMP_IMM( CC_LE ); break; /* JSLE_IMM */
+  case 0xd6: emit_div( a, pc, 1UL, 1, 0, dst, 0, 0UL, imm, 0 ); break; /* SDIV64_IMM */
+  case 0xdc: /* END_BE */
+    switch( imm ) {
+    case 16U:
+      emit_rm ( h, 0UL, 0x0fb7UL, RAX, RBX, OFF_REG( dst ) );                /* movzx eax, word [dst] */
+      emit_u8 ( h, 0x66UL ); emit_rr( h, 0UL, 0xc1UL, 0UL, RAX ); emit_u8( h, 8UL ); /* rol ax, 8 */
+      emit_rr ( h, 0UL, 0x0fb7UL, RAX, RAX );                               /* movzx eax, ax */
+      emit_st_reg( a, RAX, dst );
+      break;
+    case 32U:
+      emit_ld_reg( a, 0UL, RAX, dst );
+      emit_u8    ( h, 0x0fUL ); emit_u8( h, 0xc8UL ); /* bswap eax */
+      emit_st_reg( a, RAX, dst );
+      break;
+    case 64U:
+      emit_ld_reg( a, 1UL, RAX, dst );
+      emit_u8    ( h, 0x48UL ); emit_u8( h, 0x0fUL ); emit_u8( h, 0xc8UL ); /* bswap rax */
+      emit_st_reg( a, RAX, dst );
+      break;
+    default:
+      emit_fault( a, FD_VM_JIT_SIGINV, pc );
+      break;
+    }
+    break;
+  case 0xdd: JMP_REG( CC_LE ); break; /* JSLE_REG */
+  case 0xde: emit_div( a, pc, 1UL, 1, 0, dst, 1, src, 0U, 0 ); break; /* SDIV64_REG */
+
+  /* 0xe0 - 0xff ******************************************************/
+
+  case 0xe6: emit_div( a, pc, 0UL, 1, 1, dst, 0, 0UL, imm, 0 ); break; /* SREM32_IMM */
+  case 0xee: emit_div( a, pc, 0UL, 1, 1, dst, 1, src, 0U, 0 ); break; /* SREM32_REG */
+  case 0xf6: emit_div( a, pc, 1UL, 1, 1, dst, 0, 0UL, imm, 0 ); break; /* SREM64_IMM */
+  case 0xf7: /* HOR64 */
+    emit_charge( a, pc );
+    emit_mov32 ( h, RAX, (ulong)imm );
+    emit_rr    ( h, 1UL, 0xc1UL, 4UL, RAX ); emit_u8( h, 32UL );  /* shl rax, 32 */
+    emit_rm    ( h, 1UL, 0x09UL, RAX, RBX, OFF_REG( dst ) );      /* or [dst], rax */
+    emit_mov32 ( h, R12, pc+1UL );
+    break;
+  case 0xfe: emit_div( a, pc, 1UL, 1, 1, dst, 1, src, 0U, 0 ); break; /* SREM64_REG */
+
+  default: /* sigill */
+    emit_fault( a, FD_VM_JIT_SIGILL, pc );
+    break;
+  }
+
+# undef JMP_REG
+# undef JMP_IMM
+# undef SHIFT64_REG
+# undef SHIFT32_REG
+# undef SHIFT64_IMM
+# undef SHIFT32_IMM
+# undef ALU64_REG
+# undef ALU64_IMM
+# undef ALU32_REG
+# undef ALU32_IMM
+
+  return 0;
+}
+
+/* emit_common emits the entry trampoline and the shared exit paths */
+
+static void
+emit_common( fd_vm_jit_asm_t * a ) {
+  uchar ** h = &a->hot;
+
+  /* entry( vm, pc_tbl, pc ) */
+
+  emit_u8( h, 0x55UL );                                   /* push rbp */
+  emit_u8( h, 0x53UL );                                   /* push rbx */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x54UL );             /* push r12 */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x55UL );             /* push r13 */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x56UL );             /* push r14 */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x57UL );             /* push r15 */
+  emit_rr( h, 1UL, 0x83UL, 5UL, RSP ); emit_u8( h, 8UL ); /* sub rsp, 8 (align stack for helper calls) */
+  emit_rr( h, 1UL, 0x89UL, RDI, RBX );                    /* mov rbx, rdi */
+  emit_rr( h, 1UL, 0x89UL, RSI, R13 );                    /* mov r13, rsi */
+  emit_rr( h, 1UL, 0x89UL, RDX, R12 );                    /* mov r12, rdx */
+  emit_rm( h, 1UL, 0x8bUL, R14, RBX, OFF_IC );            /* mov r14, [vm->ic] */
+  emit_rm( h, 1UL, 0x8bUL, R15, RBX, OFF_CU );            /* mov r15, [vm->cu] */
+  emit_sib( h, 0UL, 0xffUL, 4UL, R13, RDX, 3UL, 0UL );    /* jmp [r13+rdx*8] */
+
+  /* l_textdyn: sigtext at pc rax (r12 already rax) */
+
+  a->l_textdyn = a->hot;
+  emit_rr   ( h, 1UL, 0x89UL, RAX, RDX ); /* mov rdx, rax */
+  emit_mov32( h, RSI, FD_VM_JIT_SIGTEXT );
+
+  /* l_fault: halt with fault kind rsi at pc rdx */
+
+  a->l_fault = a->hot;
+  emit_rm  ( h, 1UL, 0x89UL, R14, RBX, OFF_IC ); /* mov [vm->ic], r14 */
+  emit_rm  ( h, 1UL, 0x89UL, R15, RBX, OFF_CU ); /* mov [vm->cu], r15 */
+  emit_rr  ( h, 1UL, 0x89UL, RBX, RDI );         /* mov rdi, rbx */
+  emit_rr  ( h, 1UL, 0x89UL, R12, RCX );         /* mov rcx, r12 */
+  emit_call( h, (ulong)fd_vm_jit_fault );
+
+  emit_rr( h, 1UL, 0x83UL, 0UL, RSP ); emit_u8( h, 8UL ); /* add rsp, 8 */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x5fUL );             /* pop r15 */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x5eUL );             /* pop r14 */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x5dUL );             /* pop r13 */
+  emit_u8( h, 0x41UL ); emit_u8( h, 0x5cUL );             /* pop r12 */
+  emit_u8( h, 0x5bUL );                                   /* pop rbx */
+  emit_u8( h, 0x5dUL );                                   /* pop rbp */
+  emit_u8( h, 0xc3UL );                                   /* ret */
+}
+
+/* Public API **********************************************************/
+
+FD_FN_CONST ulong
+fd_vm_jit_align( void ) {
+  return FD_VM_JIT_ALIGN;
+}
+
+FD_FN_CONST ulong
+fd_vm_jit_footprint( ulong text_max ) {
+  if( FD_UNLIKELY( (!text_max) | (text_max>FD_VM_JIT_TEXT_MAX) ) ) return 0UL;
+  return FD_VM_JIT_FOOTPRINT( text_max );
+}
+
+void *
+fd_vm_jit_new( void * shmem,
+               ulong  text_max ) {
+
+  if( FD_UNLIKELY( !shmem ) ) {
+    FD_LOG_WARNING(( "NULL shmem" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shmem, fd_vm_jit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shmem" ));
+    return NULL;
+  }
+
+  ulong footprint = fd_vm_jit_footprint( text_max );
+  if( FD_UNLIKELY( !footprint ) ) {
+    FD_LOG_WARNING(( "bad text_max" ));
+    return NULL;
+  }
+
+  ulong code_sz = fd_vm_jit_code_sz( text_max );
+  void * code = mmap( NULL, code_sz, PROT_READ | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 );
+  if( FD_UNLIKELY( code==MAP_FAILED ) ) {
+    FD_LOG_WARNING(( "mmap(%lu KiB) failed (%i-%s)", code_sz>>10, errno, fd_io_strerror( errno ) ));
+    return NULL;
+  }
+
+  fd_vm_jit_t * jit = (fd_vm_jit_t *)shmem;
+  fd_memset( jit, 0, sizeof(fd_vm_jit_t) );
+
+  jit->text_max = text_max;
+  jit->code     = (uchar *)code;
+  jit->code_sz  = code_sz;
+  jit->compiled = 0;
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( jit->magic ) = FD_VM_JIT_MAGIC;
+  FD_COMPILER_MFENCE();
+
+  return shmem;
+}
+
+fd_vm_jit_t *
+fd_vm_jit_join( void * shjit ) {
+
+  if( FD_UNLIKELY( !shjit ) ) {
+    FD_LOG_WARNING(( "NULL shjit" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shjit, fd_vm_jit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shjit" ));
+    return NULL;
+  }
+
+  fd_vm_jit_t * jit = (fd_vm_jit_t *)shjit;
+
+  if( FD_UNLIKELY( jit->magic!=FD_VM_JIT_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  return jit;
+}
+
+void *
+fd_vm_jit_leave( fd_vm_jit_t * jit ) {
+
+  if( FD_UNLIKELY( !jit ) ) {
+    FD_LOG_WARNING(( "NULL jit" ));
+    return NULL;
+  }
+
+  return (void *)jit;
+}
+
+void *
+fd_vm_jit_delete( void * shjit ) {
+
+  if( FD_UNLIKELY( !shjit ) ) {
+    FD_LOG_WARNING(( "NULL shjit" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( !fd_ulong_is_aligned( (ulong)shjit, fd_vm_jit_align() ) ) ) {
+    FD_LOG_WARNING(( "misaligned shjit" ));
+    return NULL;
+  }
+
+  fd_vm_jit_t * jit = (fd_vm_jit_t *)shjit;
+
+  if( FD_UNLIKELY( jit->magic!=FD_VM_JIT_MAGIC ) ) {
+    FD_LOG_WARNING(( "bad magic" ));
+    return NULL;
+  }
+
+  if( FD_UNLIKELY( munmap( jit->code, jit->code_sz ) ) )
+    FD_LOG_WARNING(( "munmap failed (%i-%s); attempting to continue", errno, fd_io_strerror( errno ) ));
+
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( jit->magic ) = 0UL;
+  FD_COMPILER_MFENCE();
+
+  return shjit;
+}
+
+int
+fd_vm_jit_compile( fd_vm_jit_t *   jit,
+                   fd_vm_t const * vm ) {
+
+  if( FD_UNLIKELY( !jit ) ) {
+    FD_LOG_WARNING(( "NULL jit" ));
+    return FD_VM_ERR_INVAL;
+  }
+
+  if( FD_UNLIKELY( !vm ) ) {
+    FD_LOG_WARNING(( "NULL vm" ));
+    return FD_VM_ERR_INVAL;
+  }
+
+  jit->compiled = 0;
+
+  ulong text_cnt = vm->text_cnt;
+  if( FD_UNLIKELY( text_cnt>jit->text_max ) ) return FD_VM_ERR_FULL;
+
+  int err = fd_vm_validate( vm );
+  if( FD_UNLIKELY( err ) ) return err;
+
+  if( FD_UNLIKELY( mprotect( jit->code, jit->code_sz, PROT_READ | PROT_WRITE ) ) ) {
+    FD_LOG_WARNING(( "mprotect failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return FD_VM_ERR_INVAL;
+  }
+
+  /* From here on, every exit has to make the code pages executable
+     again (and thus not writable), whether the compile succeeded or
+     not. */
+
+  uchar * hot_end  = jit->code + FD_VM_JIT_COMMON_MAX + (text_cnt+1UL)*FD_VM_JIT_HOT_MAX;
+  uchar * cold_end = jit->code + jit->code_sz;
+
+  fd_vm_jit_asm_t a[1];
+  a->code      = jit->code;
+  a->hot       = jit->code;
+  a->cold      = hot_end;
+  a->text_cnt  = text_cnt;
+  a->fixup     = fd_vm_jit_fixup( jit );
+  a->fixup_cnt = 0UL;
+
+  ulong * pc_tbl = fd_vm_jit_pc_tbl( jit );
+
+  emit_common( a );
+  if( FD_UNLIKELY( a->hot > a->code + FD_VM_JIT_COMMON_MAX ) ) {
+    FD_LOG_WARNING(( "jit common area exceeds its budget" ));
+    err = FD_VM_ERR_FULL;
+    goto fail;
+  }
+  a->hot = a->code + FD_VM_JIT_COMMON_MAX;
+
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) {
+    uchar * hot0  = a->hot;
+    uchar * cold0 = a->cold;
+
+    /* Each text word gets at most HOT_MAX hot and COLD_MAX cold bytes
+       (test_vm_jit checks this for all instructions with worst case
+       operands), so the areas were sized to never run out.  Check
+       anyway before emitting anything such that a budget violation is
+       a failed compile (which callers handle by running the program on
+       the interpreter) rather than a write past the code pages. */
+
+    if( FD_UNLIKELY( ((ulong)(hot_end -hot0 )<FD_VM_JIT_HOT_MAX ) |
+                     ((ulong)(cold_end-cold0)<FD_VM_JIT_COLD_MAX) ) ) {
+      err = FD_VM_ERR_FULL;
+      goto fail;
+    }
+
+    pc_tbl[ pc ] = (ulong)hot0;
+    int skip = emit_instr( a, vm, pc );
+    if( FD_UNLIKELY( skip<0 ) ) {
+      err = FD_VM_ERR_INVAL;
+      goto fail;
+    }
+    if( skip ) {
+      /* The second word of a LDQ is consumed by the LDQ but branching
+         to it executes it as an instruction.  fd_vm_validate requires
+         its opcode to be zero, so that is always a sigill.  The stub
+         lives out of line such that the LDQ falls through to the word
+         after. */
+      pc++;
+      pc_tbl[ pc ] = (ulong)emit_fault_stub( a, FD_VM_JIT_SIGILL, pc );
+    }
+
+    ulong word_cnt = 1UL + (ulong)skip;
+    if( FD_UNLIKELY( ((ulong)(a->hot -hot0 )>word_cnt*FD_VM_JIT_HOT_MAX ) |
+                     ((ulong)(a->cold-cold0)>word_cnt*FD_VM_JIT_COLD_MAX) ) ) {
+      FD_LOG_WARNING(( "jit code at pc %lu exceeds its budget", pc ));
+      err = FD_VM_ERR_FULL;
+      goto fail;
+    }
+  }
+
+  /* Falling off the end of the text */
+
+  if( FD_UNLIKELY( (ulong)(hot_end-a->hot)<FD_VM_JIT_HOT_MAX ) ) {
+    err = FD_VM_ERR_FULL;
+    goto fail;
+  }
+  pc_tbl[ text_cnt ] = (ulong)a->hot;
+  emit_fault( a, FD_VM_JIT_SIGTEXT, text_cnt );
+
+  for( ulong i=0UL; i<a->fixup_cnt; i++ ) {
+    fd_vm_jit_fixup_t const * fixup = a->fixup + i;
+    patch_rel32( a->code + fixup->rel, (uchar const *)pc_tbl[ fixup->pc ] );
+  }
+
+  if( FD_UNLIKELY( mprotect( jit->code, jit->code_sz, PROT_READ | PROT_EXEC ) ) ) {
+    FD_LOG_WARNING(( "mprotect failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+    return FD_VM_ERR_INVAL;
+  }
+
+  uchar * entry = jit->code;
+  memcpy( &jit->entry, &entry, sizeof(fd_vm_jit_entry_t) ); /* ISO C does not allow casting object to function pointers */
+
+  jit->text           = vm->text;
+  jit->text_cnt       = text_cnt;
+  jit->sbpf_version   = vm->sbpf_version;
+  jit->entry_pc       = vm->entry_pc;
+  jit->calldests      = vm->calldests;
+  jit->syscalls       = vm->syscalls;
+  jit->direct_mapping = !!vm->direct_mapping;
+  jit->compiled       = 1;
+
+  return FD_VM_SUCCESS;
+
+fail:
+  if( FD_UNLIKELY( mprotect( jit->code, jit->code_sz, PROT_READ | PROT_EXEC ) ) )
+    FD_LOG_WARNING(( "mprotect failed (%i-%s)", errno, fd_io_strerror( errno ) ));
+  return err;
+}
+
+FD_FN_PURE int
+fd_vm_jit_is_compiled( fd_vm_jit_t const * jit,
+                       fd_vm_t const *     vm ) {
+  return jit && vm && jit->compiled && !vm->trace &&
+         (jit->text==vm->text)                 & (jit->text_cnt==vm->text_cnt)   &
+         (jit->sbpf_version==vm->sbpf_version) & (jit->entry_pc==vm->entry_pc)   &
+         (jit->calldests==vm->calldests)       & (jit->syscalls==vm->syscalls)   &
+         (jit->direct_mapping==!!vm->direct_mapping);
+}
+
+int
+fd_vm_jit_exec( fd_vm_jit_t const * jit,
+                fd_vm_t *           vm ) {
+  if( FD_UNLIKELY( !fd_vm_jit_is_compiled( jit, vm ) ) ) return FD_VM_ERR_EBPF_JIT_NOT_COMPILED;
+
+  ulong pc = vm->pc;
+  if( FD_UNLIKELY( pc>=jit->text_cnt ) ) return fd_vm_jit_fault( vm, FD_VM_JIT_SIGTEXT, pc, pc );
+
+  return jit->entry( vm, fd_vm_jit_pc_tbl_const( jit ), pc );
+}
@@ -0,0 +1,150 @@
+#ifndef HEADER_fd_src_flamenco_vm_fd_vm_jit_h
+#define HEADER_fd_src_flamenco_vm_fd_vm_jit_h
+
+/* fd_vm_jit provides an x86-64 native code generator for validated
+   sBPF programs.  A program is compiled once into executable pages and
+   can then be run any number of times against fd_vm_t instances that
+   were set up for that same program (same text, sbpf_version,
+   calldests, syscalls and direct mapping mode).
+
+   The generated code is a drop in replacement for fd_vm_exec_notrace.
+   It is required to be bit-for-bit indistinguishable from the
+   interpreter in fd_vm_interp_core.c from the point of view of the
+   caller: the same err, the same final pc, ic, cu and frame_cnt, the
+   same register file, shadow stack, stack, heap and input region
+   contents and the same segv diagnostics.  In particular:
+
+   - CU metering uses the exact same linear segment accounting as the
+     interpreter (see FD_VM_INTERP_BRANCH_BEGIN and FD_VM_INTERP_FAULT).
+     The segment start (pc0 + ic_correction) lives in a host register
+     and each branch bills pc - pc0 + 1 - ic_correction in a handful of
+     instructions.
+
+   - Memory translation has an inline fast path for the program,
+     stack and heap regions (stack only when it has no gaps) that is
+     equivalent to fd_vm_mem_haddr for those regions.  Everything else
+     (the input region, stack gaps, faults and partial stores under
+     direct mapping) goes out of line to the same fd_vm_mem_* helpers
+     the interpreter uses.
+
+   - Syscalls are resolved at compile time and invoked with the same vm
+     state updates and error handling as FD_VM_INTERP_SYSCALL_EXEC.
+
+   The sBPF register file, frame_cnt and the shadow stack live in the
+   fd_vm_t during execution (only pc0, ic and cu are kept in host
+   registers) such that syscalls and the out of line helpers see a
+   consistent vm.
+
+   A fd_vm_jit_t holds pointers into the local address space (the code
+   pages and the program it was compiled for) and thus is not
+   shareable between processes.  Creating one requires mmap and
+   compiling requires mprotect, so both should be done before the
+   caller is sandboxed. */
+
+#include "fd_vm.h"
+
+/* FD_VM_JIT_{ALIGN,FOOTPRINT} give the alignment and footprint of a
+   memory region suitable for holding a jit that can compile programs
+   with up to text_max words.  ALIGN is an integer power of 2.
+   FOOTPRINT is a multiple of ALIGN. */
+
+#define FD_VM_JIT_ALIGN (128UL)
+#define FD_VM_JIT_FOOTPRINT( text_max )                                      \
+  FD_LAYOUT_FINI( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND( FD_LAYOUT_APPEND(      \
+    FD_LAYOUT_INIT,                                                          \
+    FD_VM_JIT_ALIGN, 256UL                  ), /* fd_vm_jit_t */             \
+    8UL,             8UL*((text_max)+1UL)   ), /* pc_tbl */                  \
+    8UL,             8UL*(text_max)         ), /* fixups */                  \
+    FD_VM_JIT_ALIGN )
+
+/* FD_VM_JIT_TEXT_MAX is the largest program (in words) the jit can
+   compile.  This is well beyond anything the loader will accept and
+   keeps all generated code within rel32 reach. */
+
+#define FD_VM_JIT_TEXT_MAX (1UL<<22)
+
+#define FD_VM_JIT_MAGIC (0xF17EDA2CE717UL) /* FIREDANCE JIT V0 */
+
+struct fd_vm_jit;
+typedef struct fd_vm_jit fd_vm_jit_t;
+
+FD_PROTOTYPES_BEGIN
+
+/* fd_vm_jit_{align,footprint} return FD_VM_JIT_{ALIGN,FOOTPRINT}.
+   fd_vm_jit_footprint returns 0 if text_max is not in
+   [1,FD_VM_JIT_TEXT_MAX]. */
+
+FD_FN_CONST ulong
+fd_vm_jit_align( void );
+
+FD_FN_CONST ulong
+fd_vm_jit_footprint( ulong text_max );
+
+/* fd_vm_jit_new formats a memory region with suitable alignment and
+   footprint for holding a jit that can compile programs of up to
+   text_max words.  This maps the pages the generated code will live
+   in (read-only and executable, they are only writable while
+   fd_vm_jit_compile runs).  Returns shmem on success and
+   NULL on failure (logs details).  The caller is not joined on
+   return. */
+
+void *
+fd_vm_jit_new( void * shmem,
+               ulong  text_max );
+
+/* fd_vm_jit_{join,leave} are the usual join / leave semantics. */
+
+fd_vm_jit_t *
+fd_vm_jit_join( void * shjit );
+
+void *
+fd_vm_jit_leave( fd_vm_jit_t * jit );
+
+/* fd_vm_jit_delete unformats a memory region holding a jit and unmaps
+   its code pages.  Assumes nobody is joined.  Returns shjit on success
+   and NULL on failure (logs details). */
+
+void *
+fd_vm_jit_delete( void * shjit );
+
+/* fd_vm_jit_compile compiles the program vm is set up to run into
+   jit, discarding whatever jit held previously.  The program is
+   validated with fd_vm_validate first.  Returns FD_VM_SUCCESS on
+   success and a FD_VM_ERR code on failure (the error from
+   fd_vm_validate if the program is not valid, FD_VM_ERR_FULL if the
+   program is larger than the jit's text_max or its code would not fit
+   the code pages and FD_VM_ERR_INVAL otherwise).  On failure, jit holds
+   no program.  Either way, the code pages are not writable on return.
+
+   The compiled code references vm->text, vm->calldests and
+   vm->syscalls (and the syscall functions it resolved from them).
+   These must be unchanged and remain valid for as long as the
+   compiled program is in use. */
+
+int
+fd_vm_jit_compile( fd_vm_jit_t *   jit,
+                   fd_vm_t const * vm );
+
+/* fd_vm_jit_is_compiled returns 1 if the program in jit can be run
+   with vm and 0 if not.  Tracing vms are never runnable under the jit
+   as the generated code does not emit trace events. */
+
+FD_FN_PURE int
+fd_vm_jit_is_compiled( fd_vm_jit_t const * jit,
+                       fd_vm_t const *     vm );
+
+/* fd_vm_jit_exec runs the program in vm starting from vm's current
+   state (pc, ic, cu, frame_cnt, registers, memory) using the code
+   compiled in jit.  Has the exact same semantics as
+   fd_vm_exec_notrace.  Returns FD_VM_ERR_EBPF_JIT_NOT_COMPILED without
+   touching vm if jit does not hold a program runnable with vm (see
+   fd_vm_jit_is_compiled), in which case the caller should fall back
+   to fd_vm_exec. */
+
+int
+fd_vm_jit_exec( fd_vm_jit_t const * jit,
+                fd_vm_t *           vm );
+
+FD_PROTOTYPES_END
+
+#endif /* HEADER_fd_src_flamenco_vm_fd_vm_jit_h */
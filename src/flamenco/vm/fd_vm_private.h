@@ -111,6 +111,24 @@ typedef struct fd_vm_vec fd_vm_vec_t;
 
 #define FD_VM_SBPF_DYNAMIC_STACK_FRAMES_ALIGN      (64U)
 
+/* FD_VM_FUSE_OP_* are the superinstructions that fd_vm_fuse_build can
+   place in a fuse table (0 means the instruction at pc is dispatched
+   by itself).  In the comments, the registers and offsets of an idiom
+   must match as written for the idiom to fuse. */
+
+#define FD_VM_FUSE_OP_NONE             (0)
+#define FD_VM_FUSE_OP_SEXT32           (1)  /* LSH64_IMM d,32 ; ARSH64_IMM d,32 */
+#define FD_VM_FUSE_OP_ZEXT32           (2)  /* LSH64_IMM d,32 ; RSH64_IMM d,32 */
+#define FD_VM_FUSE_OP_MOV_SEXT32       (3)  /* MOV64_REG d,s ; LSH64_IMM d,32 ; ARSH64_IMM d,32 */
+#define FD_VM_FUSE_OP_MOV_ZEXT32       (4)  /* MOV64_REG d,s ; LSH64_IMM d,32 ; RSH64_IMM d,32 */
+#define FD_VM_FUSE_OP_LDQ_LDQ          (5)  /* LDQ ; LDQ (4 text words) */
+#define FD_VM_FUSE_OP_LDXQ_ADD64_STXQ  (6)  /* LDXQ d,[b+o] ; ADD64_IMM d,i ; STXQ [b+o],d (d!=b) */
+#define FD_VM_FUSE_OP_ADD64_JNE_REG    (7)  /* ADD64_IMM d,i ; JNE_REG d,s */
+#define FD_VM_FUSE_OP_ADD64_JLT_REG    (8)  /* ADD64_IMM d,i ; JLT_REG d,s */
+#define FD_VM_FUSE_OP_AND64_JEQ_IMM    (9)  /* AND64_IMM d,i ; JEQ_IMM d,j */
+#define FD_VM_FUSE_OP_AND64_JNE_IMM    (10) /* AND64_IMM d,i ; JNE_IMM d,j */
+#define FD_VM_FUSE_OP_CNT              (11)
+
 #define FD_VM_OFFSET_MASK (0xffffffffUL)
 
 FD_PROTOTYPES_BEGIN
@@ -0,0 +1,221 @@
+#ifndef HEADER_fd_src_flamenco_vm_test_vm_common_h
+#define HEADER_fd_src_flamenco_vm_test_vm_common_h
+
+/* test_vm_common.h provides the vm state, setup and random program
+   generators shared by the differential vm tests (test_vm_jit,
+   test_vm_fuse and test_vm_cu).  Those run the same program from the
+   same initial state through two vms (_vm[0] and _vm[1]) and compare
+   the results.  The including test defines TEXT_MAX (largest program in
+   words) first. */
+
+#include "fd_vm_private.h"
+#include "test_vm_util.h"
+
+static fd_vm_t _vm[2];
+
+static fd_sbpf_syscalls_t _syscalls[ FD_SBPF_SYSCALLS_SLOT_CNT ];
+
+static ulong calldests_mem[ 64UL ] __attribute__((aligned(8)));
+
+/* accumulator_syscall returns the sum of its arguments and consumes no
+   compute units.  Tests register it as "accumulator" and keep its
+   murmur3 key in accumulator_key. */
+
+FD_FN_UNUSED static int
+accumulator_syscall( FD_PARAM_UNUSED void *  _vm,
+                     /**/            ulong   arg0,
+                     /**/            ulong   arg1,
+                     /**/            ulong   arg2,
+                     /**/            ulong   arg3,
+                     /**/            ulong   arg4,
+                     /**/            ulong * ret ) {
+  *ret = arg0 + arg1 + arg2 + arg3 + arg4;
+  return 0;
+}
+
+FD_FN_UNUSED static uint accumulator_key;
+
+/* vm_setup joins vm and initializes it to run text (which doubles as
+   rodata) from pc 0.  If reg_init is non-NULL, the register file is
+   set to reg_init[0,10).  trace is optional.  Returns vm. */
+
+static fd_vm_t *
+vm_setup( fd_vm_t *             vm,
+          ulong const *         text,
+          ulong                 text_cnt,
+          ulong                 sbpf_version,
+          ulong                 entry_cu,
+          int                   direct_mapping,
+          ulong const *         reg_init,
+          fd_sbpf_calldests_t * calldests,
+          fd_vm_trace_t *       trace,
+          fd_sha256_t *         sha,
+          fd_sbpf_syscalls_t *  syscalls,
+          fd_exec_instr_ctx_t * instr_ctx ) {
+  FD_TEST( fd_vm_join( fd_vm_new( vm ) )==vm );
+  FD_TEST( fd_vm_init(
+    /* vm                 */ vm,
+    /* instr_ctx          */ instr_ctx,
+    /* heap_max           */ FD_VM_HEAP_DEFAULT,
+    /* entry_cu           */ entry_cu,
+    /* rodata             */ (uchar const *)text,
+    /* rodata_sz          */ 8UL*text_cnt,
+    /* text               */ text,
+    /* text_cnt           */ text_cnt,
+    /* text_off           */ 0UL,
+    /* text_sz            */ 8UL*text_cnt,
+    /* entry_pc           */ 0UL,
+    /* calldests          */ calldests,
+    /* sbpf_version       */ sbpf_version,
+    /* syscalls           */ syscalls,
+    /* trace              */ trace,
+    /* sha                */ sha,
+    /* mem_regions        */ NULL,
+    /* mem_regions_cnt    */ 0U,
+    /* mem_regions_accs   */ NULL,
+    /* is_deprecated      */ 0,
+    /* direct mapping     */ direct_mapping,
+    /* dump_syscall_to_pb */ 0 ) );
+  if( reg_init ) for( ulong j=0UL; j<10UL; j++ ) vm->reg[j] = reg_init[j];
+  return vm;
+}
+
+/* random_instr returns a random instruction word for the instruction
+   at pc of a text_cnt word program that is likely to pass validation
+   under sbpf_version.  The second word of a LDQ is returned in *next
+   (*next is not touched otherwise).  Syscalls are picked from the
+   syscall_cnt murmur3 keys in syscall_key. */
+
+FD_FN_UNUSED static ulong
+random_instr( fd_rng_t *   rng,
+              ulong        sbpf_version,
+              ulong        pc,
+              ulong        text_cnt,
+              uint const * syscall_key,
+              ulong        syscall_cnt,
+              ulong *      next ) {
+  ulong dst = fd_rng_ulong_roll( rng, 10UL );
+  ulong src = fd_rng_ulong_roll( rng, 11UL );
+
+  uint imm;
+  switch( fd_rng_uint_roll( rng, 5U ) ) {
+  case 0U:  imm = fd_rng_uint( rng );                      break;
+  case 1U:  imm = fd_rng_uint_roll( rng, 64U );            break;
+  case 2U:  imm = (uint)-(int)fd_rng_uint_roll( rng, 4U ); break;
+  case 3U:  imm = 0x80000000U;                             break;
+  default:  imm = fd_rng_uint_roll( rng, 0x10000U );       break;
+  }
+
+  /* Jump offsets stay within the text.  Memory offsets are biased
+     toward the current stack frame. */
+
+  long  jmp_lo = -(long)pc - 1L;
+  long  jmp_hi = (long)text_cnt - (long)pc - 2L;
+  long  jmp    = jmp_lo + (long)fd_rng_ulong_roll( rng, (ulong)(jmp_hi - jmp_lo + 1L) );
+  short off    = (short)( fd_rng_uint_roll( rng, 2U ) ? -(int)fd_rng_uint_roll( rng, 0x1100U ) : (int)fd_rng_uint_roll( rng, 0x80U ) );
+
+  switch( fd_rng_uint_roll( rng, 16U ) ) {
+
+  case 0U: case 1U: case 2U: case 3U: case 4U: case 5U: { /* ALU */
+    ulong opcode = (ulong)fd_rng_uint_roll( rng, 256U );
+    opcode = (opcode & 0xf0UL) | ( (opcode & 1UL) ? 0x7UL : 0x4UL ) | (opcode & 8UL); /* ALU / ALU64 class */
+    if( (opcode & 0xf0UL)==0xd0UL ) imm = fd_uint_if( fd_rng_uint_roll( rng, 8U )!=0U, 16U<<fd_rng_uint_roll( rng, 3U ), imm ); /* END */
+    if( (opcode & 0x07UL)==0x04UL && ((opcode>>4)==0x6UL || (opcode>>4)==0x7UL || (opcode>>4)==0xcUL) ) imm &= 31U; /* shifts */
+    if( (opcode & 0x07UL)==0x07UL && ((opcode>>4)==0x6UL || (opcode>>4)==0x7UL || (opcode>>4)==0xcUL) ) imm &= 63U;
+    if( !imm ) imm = 1U; /* avoid imm division by zero */
+    if( fd_rng_uint_roll( rng, 4U )==0U ) { /* PQR class ops */
+      opcode = ( ( (ulong)fd_rng_uint_roll( rng, 16U ) ) << 4 ) | ( fd_rng_uint_roll( rng, 2U ) ? 0x6UL : 0xeUL );
+    }
+    return fd_vm_instr( opcode, dst, src, 0, imm );
+  }
+
+  case 6U: { /* LDQ */
+    if( pc+2UL>=text_cnt || !FD_VM_SBPF_ENABLE_LDDW( sbpf_version ) ) return fd_vm_instr( 0xf7UL, dst, 0UL, 0, imm ); /* HOR64 */
+    *next = fd_vm_instr( 0x00UL, 0UL, 0UL, 0, fd_rng_uint( rng ) );
+    return fd_vm_instr( 0x18UL, dst, 0UL, 0, imm );
+  }
+
+  case 7U: case 8U: case 9U: { /* Conditional / unconditional jumps */
+    static uchar const jmp_op[] = { 0x05, 0x15, 0x1d, 0x25, 0x2d, 0x35, 0x3d, 0x45, 0x4d, 0x55, 0x5d, 0x65, 0x6d,
+                                    0x75, 0x7d, 0xa5, 0xad, 0xb5, 0xbd, 0xc5, 0xcd, 0xd5, 0xdd };
+    return fd_vm_instr( jmp_op[ fd_rng_uint_roll( rng, (uint)sizeof(jmp_op) ) ], dst, src, (short)jmp, imm );
+  }
+
+  case 10U: case 11U: case 12U: { /* Memory (both the legacy and SIMD-0173 encodings) */
+    static uchar const mem_op[] = { 0x61, 0x62, 0x63, 0x69, 0x6a, 0x6b, 0x71, 0x72, 0x73, 0x79, 0x7a, 0x7b,
+                                    0x8c, 0x87, 0x8f, 0x3c, 0x37, 0x3f, 0x2c, 0x27, 0x2f, 0x9c, 0x97, 0x9f };
+    ulong opcode = mem_op[ fd_rng_uint_roll( rng, (uint)sizeof(mem_op) ) ];
+    ulong base   = fd_rng_uint_roll( rng, 2U ) ? 10UL : (ulong)fd_rng_uint_roll( rng, 10U );
+    int   is_ld  = (opcode & 0x7UL)==0x1UL || (opcode & 0xfUL)==0xcUL;
+    if( is_ld ) return fd_vm_instr( opcode, dst,  base, off, imm );
+    else        return fd_vm_instr( opcode, base, src,  off, imm );
+  }
+
+  case 13U: { /* Calls */
+    ulong target = fd_rng_ulong_roll( rng, (text_cnt+2UL)/3UL ) * 3UL; /* calldests (see random_text) */
+    uint  key    = syscall_key[ fd_rng_ulong_roll( rng, syscall_cnt ) ];
+    switch( fd_rng_uint_roll( rng, 4U ) ) {
+    case 0U:  return fd_vm_instr( 0x85UL, 0UL, 0UL, 0, key );
+    case 1U:  return fd_vm_instr( FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ) ? 0x95UL : 0x85UL, 0UL, 0UL, 0, key );
+    case 2U:  return fd_vm_instr( 0x8dUL, 0UL, src, 0, (uint)src );
+    default:
+      if( FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ) ) return fd_vm_instr( 0x85UL, 0UL, 1UL, 0, (uint)(int)( (long)target - (long)pc - 1L ) );
+      return fd_vm_instr( 0x85UL, 0UL, 0UL, 0, fd_pchash( (uint)target ) );
+    }
+  }
+
+  default: /* Exit */
+    return fd_vm_instr( FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ) ? 0x9dUL : 0x95UL, 0UL, 0UL, 0, 0U );
+  }
+}
+
+/* random_text fills text with a random program of text_cnt words
+   that passes validation under sbpf_version.  Instructions that fail
+   validation in context are replaced until they pass.  Functions
+   start at every third word (the calldests vm_setup users should
+   pass).  Clobbers _vm[0] and calldests_mem. */
+
+FD_FN_UNUSED static void
+random_text( fd_rng_t *           rng,
+             ulong *              text,
+             ulong                text_cnt,
+             ulong                sbpf_version,
+             fd_sbpf_syscalls_t * syscalls,
+             uint const *         syscall_key,
+             ulong                syscall_cnt ) {
+  ulong exit_op = FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ) ? 0x9dUL : 0x95UL;
+  for( ulong pc=0UL; pc<text_cnt; pc++ ) text[pc] = fd_vm_instr( exit_op, 0UL, 0UL, 0, 0U );
+
+  /* fd_vm_validate only looks at the text, text_cnt, sbpf_version,
+     syscalls and calldests */
+
+  fd_vm_t * vm = fd_vm_join( fd_vm_new( _vm ) );
+  fd_sbpf_calldests_t * calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( calldests_mem, TEXT_MAX ) );
+  for( ulong pc=0UL; pc<text_cnt; pc+=3UL ) fd_sbpf_calldests_insert( calldests, pc );
+  vm->sbpf_version = sbpf_version;
+  vm->calldests    = calldests;
+  vm->syscalls     = syscalls;
+  vm->rodata       = (uchar const *)text;
+  vm->rodata_sz    = 8UL*text_cnt;
+  vm->text         = text;
+  vm->text_cnt     = text_cnt;
+  vm->text_sz      = 8UL*text_cnt;
+
+  for( ulong pc=0UL; pc<text_cnt-1UL; pc++ ) {
+    for( ulong attempt=0UL; attempt<64UL; attempt++ ) {
+      ulong save0 = text[pc  ];
+      ulong save1 = text[pc+1UL];
+      ulong next  = save1;
+      text[pc]     = random_instr( rng, sbpf_version, pc, text_cnt, syscall_key, syscall_cnt, &next );
+      text[pc+1UL] = next;
+      if( !fd_vm_validate( vm ) ) { pc += (ulong)(next!=save1); break; }
+      text[pc    ] = save0;
+      text[pc+1UL] = save1;
+    }
+  }
+
+  fd_sbpf_calldests_delete( fd_sbpf_calldests_leave( calldests ) );
+  fd_vm_delete( fd_vm_leave( vm ) );
+}
+
+#endif /* HEADER_fd_src_flamenco_vm_test_vm_common_h */
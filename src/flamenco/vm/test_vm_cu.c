@@ -0,0 +1,255 @@
+#include "../runtime/context/fd_exec_slot_ctx.h"
+#include "../../ballet/murmur3/fd_murmur3.h"
+
+/* test_vm_cu checks the compute unit metering of the interpreter
+   against a straightforward per-instruction model.
+
+   The interpreter does not touch the meter per instruction.  It bills
+   a whole linear run of instructions at the branch that ends it (or at
+   the fault that ends it early, see FD_VM_INTERP_FAULT).  This is
+   meant to be indistinguishable from metering every instruction: for
+   any compute budget, the error and the remaining compute units must
+   be exactly what per-instruction metering would give.
+
+   For each random program, an unmetered (large budget) run is traced
+   to get the sequence of executed instructions.  Per-instruction
+   metering of that sequence under a budget B predicts:
+
+     n<=B: the same result as the unmetered run with B-n cu left
+     n> B: EXCEEDED_MAX_INSTRUCTIONS with 0 cu left
+
+   where n is the number of instructions executed (an execution overrun
+   is billed as one more instruction).  The prediction is checked for
+   a sweep of budgets around every interesting point (0, n and a random
+   sample in between) for the plain, superinstruction and tracing
+   interpreters. */
+
+#define TEXT_MAX  (256UL)
+#define CU_CAP    (8192UL)         /* Budget for the unmetered run */
+#define TRACE_MAX (4UL<<20)        /* Enough for CU_CAP exe and mem events */
+
+#include "test_vm_common.h" /* _vm[0] reference (unmetered) run, _vm[1] metered runs */
+
+static uchar fuse[ TEXT_MAX ];
+
+static uchar trace_mem[ sizeof(fd_vm_trace_t) + TRACE_MAX ] __attribute__((aligned(8))); /* event_data_max 0 */
+
+/* trace_instr_cnt returns the number of instructions executed in the
+   given trace (a LDQ is one instruction). */
+
+static ulong
+trace_instr_cnt( fd_vm_trace_t const * trace ) {
+  uchar const * ptr = (uchar const *)fd_vm_trace_event( trace );
+  ulong         rem = fd_vm_trace_event_sz( trace );
+  ulong         cnt = 0UL;
+  while( rem ) {
+    ulong info = *(ulong const *)ptr;
+    ulong event_footprint;
+    if( fd_vm_trace_event_info_type( info )==FD_VM_TRACE_EVENT_TYPE_EXE ) {
+      event_footprint = sizeof(fd_vm_trace_event_exe_t) - fd_ulong_if( !fd_vm_trace_event_info_valid( info ), 8UL, 0UL );
+      cnt++;
+    } else {
+      event_footprint = sizeof(fd_vm_trace_event_mem_t); /* event_data_max is 0 */
+    }
+    FD_TEST( event_footprint<=rem );
+    ptr += event_footprint;
+    rem -= event_footprint;
+  }
+  return cnt;
+}
+
+/* test_sweep runs text unmetered and then for a sweep of budgets with
+   each interpreter, checking each run against the per-instruction
+   model.  Returns the unmetered error (or 1 if the program did not pass
+   validation). */
+
+static int
+test_sweep( char const *          name,
+            ulong const *         text,
+            ulong                 text_cnt,
+            ulong                 sbpf_version,
+            int                   direct_mapping,
+            fd_rng_t *            rng,
+            fd_vm_trace_t *       trace,
+            fd_sbpf_syscalls_t *  syscalls,
+            fd_exec_instr_ctx_t * instr_ctx,
+            ulong *               _run_cnt ) {
+
+  fd_sha256_t _sha[1];
+  fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+
+  fd_sbpf_calldests_t * calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( calldests_mem, TEXT_MAX ) );
+  for( ulong pc=0UL; pc<text_cnt; pc+=3UL ) fd_sbpf_calldests_insert( calldests, pc );
+
+  ulong reg_init[ 10 ];
+  for( ulong i=0UL; i<10UL; i++ ) {
+    switch( fd_rng_uint_roll( rng, 5U ) ) {
+    case 0U:  reg_init[i] = fd_rng_ulong( rng );                                                    break;
+    case 1U:  reg_init[i] = (ulong)fd_rng_uint_roll( rng, 64U );                                    break;
+    case 2U:  reg_init[i] = FD_VM_MEM_MAP_STACK_REGION_START + fd_rng_ulong_roll( rng, 0x2000UL ); break;
+    case 3U:  reg_init[i] = FD_VM_MEM_MAP_HEAP_REGION_START  + fd_rng_ulong_roll( rng, 0x1000UL ); break;
+    default:  reg_init[i] = FD_VM_MEM_MAP_INPUT_REGION_START + fd_rng_ulong_roll( rng, 64UL );     break;
+    }
+  }
+
+# define SETUP( vm, entry_cu, trace ) \
+  vm_setup( (vm), text, text_cnt, sbpf_version, (entry_cu), direct_mapping, reg_init, calldests, (trace), sha, syscalls, instr_ctx )
+
+  /* Unmetered reference run */
+
+  fd_vm_trace_reset( trace );
+  fd_vm_t * ref = SETUP( _vm, CU_CAP, trace );
+
+  int err = fd_vm_validate( ref );
+  if( err ) {
+    err = 1;
+    goto done;
+  }
+
+  fd_vm_fuse_build( fuse, text, text_cnt, sbpf_version );
+
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+  int   ref_err = fd_vm_exec( ref );
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+  FD_TEST( fd_vm_trace_event_sz( trace ) < TRACE_MAX - 256UL ); /* Nothing dropped */
+
+  /* If the program did not finish within the cap, we only know every
+     budget below the cap runs out */
+
+  int   capped = ref_err==FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS;
+  ulong n      = trace_instr_cnt( trace ) + (ulong)(ref_err==FD_VM_ERR_EBPF_EXECUTION_OVERRUN);
+  if( !capped ) {
+    if( FD_UNLIKELY( (ref->ic!=n) | (ref->cu!=CU_CAP-n) ) )
+      FD_LOG_ERR(( "%s: unmetered run executed %lu instructions but billed ic %lu cu %lu", name, n, ref->ic, CU_CAP-ref->cu ));
+  }
+  ulong b_max = capped ? CU_CAP-1UL : n+1UL;
+
+  /* Budgets: every budget near the ends and a random sample inside */
+
+  ulong budget[ 24 ];
+  ulong budget_cnt = 0UL;
+  for( ulong b=0UL; b<4UL; b++ ) budget[ budget_cnt++ ] = fd_ulong_min( b, b_max );
+  for( ulong b=0UL; b<4UL; b++ ) budget[ budget_cnt++ ] = b_max - fd_ulong_min( b, b_max );
+  while( budget_cnt<24UL ) budget[ budget_cnt++ ] = fd_rng_ulong_roll( rng, b_max+1UL );
+
+  for( ulong i=0UL; i<budget_cnt; i++ ) {
+    ulong b = budget[ i ];
+
+    int   exp_err = (capped | (n>b)) ? FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS : ref_err;
+    ulong exp_cu  = (capped | (n>b)) ? 0UL                                     : b - n;
+
+    for( ulong mode=0UL; mode<3UL; mode++ ) {
+      fd_vm_trace_reset( trace );
+      fd_vm_t * vm = SETUP( _vm+1, b, mode==2UL ? trace : NULL );
+      vm->fuse = mode==1UL ? fuse : NULL;
+
+      test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+      int vm_err = fd_vm_exec( vm );
+      test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+      (*_run_cnt)++;
+
+      int ok = (vm_err==exp_err) & (vm->cu==exp_cu);
+      if( exp_err==FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS ) {
+        /* Billing stops at the end of the linear run that overran */
+        ok &= (vm->ic>b) & (capped | (vm->ic<=n));
+      } else {
+        ok &= (vm->ic==ref->ic) & (vm->pc==ref->pc) & (vm->frame_cnt==ref->frame_cnt);
+        ok &= !memcmp( vm->reg,   ref->reg,   sizeof(vm->reg)    );
+        ok &= !memcmp( vm->stack, ref->stack, FD_VM_STACK_MAX    );
+        ok &= !memcmp( vm->heap,  ref->heap,  FD_VM_HEAP_DEFAULT );
+      }
+
+      if( FD_UNLIKELY( !ok ) ) {
+        for( ulong pc=0UL; pc<text_cnt; pc++ ) FD_LOG_WARNING(( "text[%3lu] %016lx", pc, text[pc] ));
+        FD_LOG_WARNING(( "unmetered err %i, %lu instr%s", ref_err, n, capped ? " (capped)" : "" ));
+        FD_LOG_WARNING(( "budget %lu: err %i (expected %i) cu %lu (expected %lu) ic %lu", b, vm_err, exp_err, vm->cu, exp_cu, vm->ic ));
+        FD_LOG_ERR(( "%s: metering mismatch (mode %lu, sbpf_version %lu, direct_mapping %i)", name, mode, sbpf_version, direct_mapping ));
+      }
+
+      fd_vm_delete( fd_vm_leave( vm ) );
+    }
+  }
+
+  err = ref_err;
+
+# undef SETUP
+
+done:
+  fd_vm_delete( fd_vm_leave( ref ) );
+  fd_sbpf_calldests_delete( fd_sbpf_calldests_leave( calldests ) );
+  fd_sha256_delete( fd_sha256_leave( sha ) );
+  return err;
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 2000UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _syscalls ) ); FD_TEST( syscalls );
+  FD_TEST( fd_vm_syscall_register( syscalls, "accumulator", accumulator_syscall )==FD_VM_SUCCESS );
+  accumulator_key = fd_murmur3_32( "accumulator", 11UL, 0U );
+
+  FD_TEST( fd_vm_trace_footprint( TRACE_MAX, 0UL )<=sizeof(trace_mem) );
+  fd_vm_trace_t * trace = fd_vm_trace_join( fd_vm_trace_new( trace_mem, TRACE_MAX, 0UL ) ); FD_TEST( trace );
+
+  fd_valloc_t valloc = fd_libc_alloc_virtual();
+  fd_exec_slot_ctx_t  * slot_ctx  = fd_valloc_malloc( valloc, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT );
+  fd_exec_instr_ctx_t * instr_ctx = test_vm_minimal_exec_instr_ctx( valloc, slot_ctx );
+
+  /* A hand written case: a loop whose linear runs straddle every budget
+     (including a LDQ, which is two words but one instruction) followed
+     by a fault in the middle of a linear run */
+
+  do {
+    ulong text[] = {
+      fd_vm_instr( 0xb7UL, 1UL, 0UL,  0, 0U  ), /* mov64 r1, 0       */
+      fd_vm_instr( 0x18UL, 2UL, 0UL,  0, 7U  ), /* lddw r2, 7        */
+      fd_vm_instr( 0x00UL, 0UL, 0UL,  0, 0U  ),
+      fd_vm_instr( 0x07UL, 1UL, 0UL,  0, 1U  ), /* add64 r1, 1       */
+      fd_vm_instr( 0x0fUL, 3UL, 1UL,  0, 0U  ), /* add64 r3, r1      */
+      fd_vm_instr( 0x2dUL, 2UL, 1UL, -3, 0U  ), /* jgt r2, r1, -3    */
+      fd_vm_instr( 0xb7UL, 4UL, 0UL,  0, 0U  ), /* mov64 r4, 0       */
+      fd_vm_instr( 0x79UL, 5UL, 4UL,  0, 0U  ), /* ldxdw r5, [r4]    */
+      fd_vm_instr( 0x95UL, 0UL, 0UL,  0, 0U  )  /* exit              */
+    };
+    ulong run_cnt = 0UL;
+    for( int dm=0; dm<2; dm++ ) {
+      for( ulong iter=0UL; iter<16UL; iter++ ) {
+        int err = test_sweep( "loop", text, sizeof(text)/sizeof(ulong), FD_SBPF_V0, dm, rng, trace, syscalls, instr_ctx, &run_cnt );
+        FD_TEST( err==FD_VM_ERR_EBPF_ACCESS_VIOLATION );
+      }
+    }
+  } while(0);
+
+  static ulong text[ TEXT_MAX ];
+
+  ulong err_cnt[ 64 ] = {0};
+  ulong run_cnt       = 0UL;
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong sbpf_version   = fd_rng_ulong_roll( rng, FD_SBPF_VERSION_COUNT );
+    int   direct_mapping = (int)fd_rng_uint_roll( rng, 2U );
+    ulong text_cnt       = 2UL + fd_rng_ulong_roll( rng, 48UL );
+    random_text( rng, text, text_cnt, sbpf_version, syscalls, &accumulator_key, 1UL );
+    int err = test_sweep( "random", text, text_cnt, sbpf_version, direct_mapping, rng, trace, syscalls, instr_ctx, &run_cnt );
+    err_cnt[ (ulong)(-err) & 63UL ]++;
+  }
+
+  FD_LOG_NOTICE(( "metered runs: %lu", run_cnt ));
+  FD_LOG_NOTICE(( "invalid: %lu", err_cnt[63] ));
+  for( ulong i=0UL; i<63UL; i++ ) if( err_cnt[i] ) FD_LOG_NOTICE(( "err %3i: %lu", -(int)i, err_cnt[i] ));
+
+  fd_vm_trace_delete( fd_vm_trace_leave( trace ) );
+  fd_sbpf_syscalls_delete( fd_sbpf_syscalls_leave( syscalls ) );
+  fd_valloc_free( valloc, slot_ctx );
+  test_vm_exec_instr_ctx_delete( instr_ctx, valloc );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_halt();
+  return 0;
+}
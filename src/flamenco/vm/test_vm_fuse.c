@@ -0,0 +1,384 @@
+#include "../runtime/context/fd_exec_slot_ctx.h"
+
+/* test_vm_fuse runs programs through the interpreter with and without
+   the superinstruction table from identical initial vm states and
+   checks that they end in identical states.  Random programs are
+   biased heavily toward the idioms fd_vm_fuse_build recognizes (and
+   near misses of them) so that every superinstruction gets exercised
+   with faults, compute budget exhaustion and branches into the middle
+   of an idiom. */
+
+#define TEXT_MAX (256UL)
+
+#include "test_vm_common.h" /* _vm[0] plain, _vm[1] fused */
+
+static uchar fuse[ TEXT_MAX ];
+
+#define I( op, dst, src, off, imm ) fd_vm_instr( (ulong)(op), (ulong)(dst), (ulong)(src), (short)(off), (uint)(imm) )
+
+/* test_diff runs text with and without fusion from the same random
+   initial state and checks the results match.  Returns the error (or
+   1 if the program did not pass validation). */
+
+static int
+test_diff( char const *          name,
+           ulong const *         text,
+           ulong                 text_cnt,
+           ulong                 sbpf_version,
+           ulong                 entry_cu,
+           int                   direct_mapping,
+           fd_rng_t *            rng,
+           fd_sbpf_syscalls_t *  syscalls,
+           fd_exec_instr_ctx_t * instr_ctx ) {
+
+  fd_sha256_t _sha[1];
+  fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+
+  /* Programs are a single function (needed for SBPF v3 validation) */
+
+  fd_sbpf_calldests_t * calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( calldests_mem, TEXT_MAX ) );
+  fd_sbpf_calldests_insert( calldests, 0UL );
+
+  ulong reg_init[ 10 ];
+  for( ulong i=0UL; i<10UL; i++ ) {
+    switch( fd_rng_uint_roll( rng, 4U ) ) {
+    case 0U:  reg_init[i] = fd_rng_ulong( rng );                                                    break;
+    case 1U:  reg_init[i] = (ulong)fd_rng_uint_roll( rng, 64U );                                    break;
+    case 2U:  reg_init[i] = FD_VM_MEM_MAP_STACK_REGION_START + fd_rng_ulong_roll( rng, 0x2000UL ); break;
+    default:  reg_init[i] = FD_VM_MEM_MAP_HEAP_REGION_START  + fd_rng_ulong_roll( rng, 0x1000UL ); break;
+    }
+  }
+  uint mem_seed = fd_rng_uint( rng );
+
+  for( ulong i=0UL; i<2UL; i++ ) {
+    fd_vm_t * vm = vm_setup( _vm+i, text, text_cnt, sbpf_version, entry_cu, direct_mapping, reg_init, calldests, NULL, sha, syscalls, instr_ctx );
+    fd_rng_t _mrng[1]; fd_rng_t * mrng = fd_rng_join( fd_rng_new( _mrng, mem_seed, 0UL ) );
+    for( ulong j=0UL; j<FD_VM_STACK_MAX;    j+=8UL ) FD_STORE( ulong, vm->stack+j, fd_rng_ulong( mrng ) );
+    for( ulong j=0UL; j<FD_VM_HEAP_DEFAULT; j+=8UL ) FD_STORE( ulong, vm->heap +j, fd_rng_ulong( mrng ) );
+    fd_rng_delete( fd_rng_leave( mrng ) );
+  }
+
+  fd_vm_t * vm0 = _vm;
+  fd_vm_t * vm1 = _vm + 1;
+
+  int err = fd_vm_validate( vm0 );
+  if( err ) {
+    err = 1;
+    goto done;
+  }
+
+  fd_vm_fuse_build( fuse, text, text_cnt, sbpf_version );
+  vm1->fuse = fuse;
+
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+  int err0 = fd_vm_exec( vm0 );
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+  int err1 = fd_vm_exec( vm1 );
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+
+  int ok = (err0==err1) & (vm0->pc==vm1->pc) & (vm0->ic==vm1->ic) & (vm0->cu==vm1->cu) &
+           (vm0->frame_cnt==vm1->frame_cnt) & (vm0->segv_vaddr==vm1->segv_vaddr) &
+           (vm0->segv_access_type==vm1->segv_access_type);
+  ok &= !memcmp( vm0->reg,   vm1->reg,   sizeof(vm0->reg)   );
+  ok &= !memcmp( vm0->stack, vm1->stack, FD_VM_STACK_MAX    );
+  ok &= !memcmp( vm0->heap,  vm1->heap,  FD_VM_HEAP_DEFAULT );
+
+  if( FD_UNLIKELY( !ok ) ) {
+    for( ulong pc=0UL; pc<text_cnt; pc++ ) FD_LOG_WARNING(( "text[%3lu] %016lx fuse %u", pc, text[pc], (uint)fuse[pc] ));
+    FD_LOG_WARNING(( "err       %i %i",   err0, err1 ));
+    FD_LOG_WARNING(( "pc        %lu %lu", vm0->pc, vm1->pc ));
+    FD_LOG_WARNING(( "ic        %lu %lu", vm0->ic, vm1->ic ));
+    FD_LOG_WARNING(( "cu        %lu %lu", vm0->cu, vm1->cu ));
+    FD_LOG_WARNING(( "segv      %lx %lx", vm0->segv_vaddr, vm1->segv_vaddr ));
+    for( ulong j=0UL; j<FD_VM_REG_CNT; j++ ) FD_LOG_WARNING(( "r%-2lu %016lx %016lx", j, vm0->reg[j], vm1->reg[j] ));
+    FD_LOG_ERR(( "%s: fused / plain mismatch (sbpf_version %lu, direct_mapping %i)", name, sbpf_version, direct_mapping ));
+  }
+  err = err0;
+
+done:
+  fd_vm_delete( fd_vm_leave( vm1 ) );
+  fd_vm_delete( fd_vm_leave( vm0 ) );
+  fd_sbpf_calldests_delete( fd_sbpf_calldests_leave( calldests ) );
+  fd_sha256_delete( fd_sha256_leave( sha ) );
+  return err;
+}
+
+/* random_idiom writes a random (possibly slightly broken) fusable
+   idiom at text[pc] and returns the number of words written (0 if
+   there is no room). */
+
+static ulong
+random_idiom( fd_rng_t * rng,
+              ulong *    text,
+              ulong      pc,
+              ulong      text_cnt,
+              ulong      sbpf_version ) {
+  ulong rem = text_cnt - pc - 1UL; /* Keep the final exit */
+  ulong d   = fd_rng_ulong_roll( rng, 10UL );
+  ulong s   = fd_rng_ulong_roll( rng, 11UL );
+  ulong b   = fd_rng_uint_roll( rng, 2U ) ? 10UL : fd_rng_ulong_roll( rng, 10UL );
+  ulong d2  = fd_rng_uint_roll( rng, 8U ) ? d : fd_rng_ulong_roll( rng, 10UL ); /* near misses */
+  uint  sh  = fd_rng_uint_roll( rng, 8U ) ? 32U : fd_rng_uint_roll( rng, 64U );
+  uint  imm = fd_rng_uint_roll( rng, 2U ) ? fd_rng_uint_roll( rng, 16U ) : fd_rng_uint( rng );
+  short off = (short)( -8 * (int)fd_rng_uint_roll( rng, 0x200U ) );
+  long  jmp = -(long)pc - 1L + (long)fd_rng_ulong_roll( rng, text_cnt );
+
+  ulong ldxq_op = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( sbpf_version ) ? 0x9cUL : 0x79UL;
+  ulong stxq_op = FD_VM_SBPF_MOVE_MEMORY_IX_CLASSES( sbpf_version ) ? 0x9fUL : 0x7bUL;
+
+  switch( fd_rng_uint_roll( rng, 7U ) ) {
+  case 0U: /* SEXT32 / ZEXT32 */
+    if( rem<2UL ) return 0UL;
+    text[pc    ] = I( 0x67, d,  0, 0, 32 );
+    text[pc+1UL] = I( fd_rng_uint_roll( rng, 2U ) ? 0xc7 : 0x77, d2, 0, 0, sh );
+    return 2UL;
+  case 1U: /* MOV_SEXT32 / MOV_ZEXT32 */
+    if( rem<3UL ) return 0UL;
+    text[pc    ] = I( 0xbf, d,  s, 0, 0  );
+    text[pc+1UL] = I( 0x67, d,  0, 0, sh );
+    text[pc+2UL] = I( fd_rng_uint_roll( rng, 2U ) ? 0xc7 : 0x77, d2, 0, 0, 32 );
+    return 3UL;
+  case 2U: /* LDQ_LDQ */
+    if( rem<4UL || !FD_VM_SBPF_ENABLE_LDDW( sbpf_version ) ) return 0UL;
+    text[pc    ] = I( 0x18, d,  0, 0, fd_rng_uint( rng ) );
+    text[pc+1UL] = I( 0x00, 0,  0, 0, fd_rng_uint( rng ) );
+    text[pc+2UL] = I( 0x18, d2, 0, 0, fd_rng_uint( rng ) );
+    text[pc+3UL] = I( 0x00, 0,  0, 0, fd_rng_uint( rng ) );
+    return 4UL;
+  case 3U: case 4U: /* LDXQ_ADD64_STXQ (occasionally out of bounds or into the program) */
+    if( rem<3UL ) return 0UL;
+    if( !fd_rng_uint_roll( rng, 8U ) ) off = (short)fd_rng_uint( rng );
+    text[pc    ] = I( ldxq_op, d,  b, off, 0   );
+    text[pc+1UL] = I( 0x07,    d2, 0, 0,   imm );
+    text[pc+2UL] = I( stxq_op, b,  d, off, 0   );
+    return 3UL;
+  case 5U: /* ADD64_JNE_REG / ADD64_JLT_REG */
+    if( rem<2UL ) return 0UL;
+    text[pc    ] = I( 0x07, d,  0, 0, imm );
+    text[pc+1UL] = I( fd_rng_uint_roll( rng, 2U ) ? 0x5d : 0xad, d2, s, jmp, 0 );
+    return 2UL;
+  default: /* AND64_JEQ_IMM / AND64_JNE_IMM */
+    if( rem<2UL ) return 0UL;
+    text[pc    ] = I( 0x57, d,  0, 0, fd_rng_uint_roll( rng, 2U ) ? 1U : imm );
+    text[pc+1UL] = I( fd_rng_uint_roll( rng, 2U ) ? 0x15 : 0x55, d2, 0, jmp, fd_rng_uint_roll( rng, 2U ) );
+    return 2UL;
+  }
+}
+
+static void
+test_random( fd_rng_t *            rng,
+             fd_sbpf_syscalls_t *  syscalls,
+             fd_exec_instr_ctx_t * instr_ctx,
+             ulong                 iter_cnt ) {
+  static ulong text[ TEXT_MAX ];
+
+  static uchar const filler_op[] = { 0x07, 0x0f, 0x17, 0x1f, 0xb7, 0xbf, 0x57, 0x5f, 0xa7, 0xaf, 0x67, 0x77, 0xc7, 0x05 };
+
+  ulong err_cnt[ 64 ] = {0};
+  ulong fuse_cnt      = 0UL;
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong sbpf_version   = fd_rng_ulong_roll( rng, FD_SBPF_VERSION_COUNT );
+    int   direct_mapping = (int)fd_rng_uint_roll( rng, 2U );
+    ulong text_cnt       = 2UL + fd_rng_ulong_roll( rng, 48UL );
+    ulong entry_cu       = fd_rng_uint_roll( rng, 4U ) ? 10000UL : fd_rng_ulong_roll( rng, 100UL );
+    ulong exit_op        = FD_VM_SBPF_STATIC_SYSCALLS( sbpf_version ) ? 0x9dUL : 0x95UL;
+
+    ulong pc = 0UL;
+    while( pc<text_cnt-1UL ) {
+      ulong n = fd_rng_uint_roll( rng, 3U ) ? random_idiom( rng, text, pc, text_cnt, sbpf_version ) : 0UL;
+      if( !n ) {
+        ulong op  = filler_op[ fd_rng_uint_roll( rng, (uint)sizeof(filler_op) ) ];
+        long  jmp = -(long)pc - 1L + (long)fd_rng_ulong_roll( rng, text_cnt );
+        text[pc] = I( op, fd_rng_ulong_roll( rng, 10UL ), fd_rng_ulong_roll( rng, 10UL ), op==0x05 ? jmp : 0, fd_rng_uint_roll( rng, 64U ) );
+        n = 1UL;
+      }
+      pc += n;
+    }
+    text[ text_cnt-1UL ] = I( exit_op, 0, 0, 0, 0 );
+
+    int err = test_diff( "random", text, text_cnt, sbpf_version, entry_cu, direct_mapping, rng, syscalls, instr_ctx );
+    err_cnt[ (ulong)(-err) & 63UL ]++;
+    if( err!=1 ) fuse_cnt += fd_vm_fuse_build( fuse, text, text_cnt, sbpf_version );
+  }
+
+  FD_LOG_NOTICE(( "fused sites: %lu", fuse_cnt ));
+  FD_LOG_NOTICE(( "invalid: %lu", err_cnt[63] ));
+  for( ulong i=0UL; i<63UL; i++ ) if( err_cnt[i] ) FD_LOG_NOTICE(( "err %3i: %lu", -(int)i, err_cnt[i] ));
+}
+
+static void
+test_bench( fd_sbpf_syscalls_t *  syscalls,
+            fd_exec_instr_ctx_t * instr_ctx ) {
+
+  /* A loop made of common compiler idioms: bump a counter in memory,
+     sign extend and accumulate, test a flag bit and loop */
+
+  ulong const text[ 13 ] = {
+    I( 0xb7, 0, 0,   0, 0       ), /* mov64 r0, 0          */
+    I( 0xb7, 1, 0,   0, 0       ), /* mov64 r1, 0          */
+    I( 0xb7, 2, 0,   0, 1000000 ), /* mov64 r2, 1000000    */
+    I( 0x7a, 10,0,  -8, 0       ), /* stdw [r10-8], 0      */
+    I( 0x79, 3, 10, -8, 0       ), /* ldxdw r3, [r10-8]    */
+    I( 0x07, 3, 0,   0, 3       ), /* add64 r3, 3          */
+    I( 0x7b, 10,3,  -8, 0       ), /* stxdw [r10-8], r3    */
+    I( 0xbf, 4, 3,   0, 0       ), /* mov64 r4, r3         */
+    I( 0x67, 4, 0,   0, 32      ), /* lsh64 r4, 32         */
+    I( 0xc7, 4, 0,   0, 32      ), /* arsh64 r4, 32        */
+    I( 0x0f, 0, 4,   0, 0       ), /* add64 r0, r4         */
+    I( 0x07, 1, 0,   0, 1       ), /* add64 r1, 1          */
+    I( 0xad, 1, 2,  -9, 0       )  /* jlt r1, r2, -9       */
+  };
+  ulong text_ex[ 14 ];
+  memcpy( text_ex, text, sizeof(text) );
+  text_ex[ 13 ] = I( 0x95, 0, 0, 0, 0 );
+
+  FD_TEST( fd_vm_fuse_build( fuse, text_ex, 14UL, FD_SBPF_V0 )==4UL );
+
+  ulong ic = 0UL;
+  long  dt[2];
+  for( ulong i=0UL; i<2UL; i++ ) {
+    fd_sha256_t _sha[1];
+    fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+    fd_vm_t * vm = vm_setup( _vm, text_ex, 14UL, FD_SBPF_V0, 100000000UL, 0, NULL, NULL, NULL, sha, syscalls, instr_ctx );
+    if( i ) vm->fuse = fuse;
+    dt[i] = -fd_log_wallclock();
+    FD_TEST( !fd_vm_exec( vm ) );
+    dt[i] += fd_log_wallclock();
+    FD_TEST( vm->reg[0]==3UL*1000000UL*1000001UL/2UL );
+    FD_TEST( !i || vm->ic==ic );
+    ic = vm->ic;
+    FD_LOG_NOTICE(( "%-6s %lu instr in %11li ns (%.3f ns/instr)", i ? "fused" : "plain", vm->ic, dt[i], (double)dt[i]/(double)vm->ic ));
+    fd_vm_delete( fd_vm_leave( vm ) );
+    fd_sha256_delete( fd_sha256_leave( sha ) );
+  }
+  FD_LOG_NOTICE(( "speedup %.2fx", (double)dt[0]/(double)dt[1] ));
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 50000UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _syscalls ) ); FD_TEST( syscalls );
+
+  fd_valloc_t valloc = fd_libc_alloc_virtual();
+  fd_exec_slot_ctx_t  * slot_ctx  = fd_valloc_malloc( valloc, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT );
+  fd_exec_instr_ctx_t * instr_ctx = test_vm_minimal_exec_instr_ctx( valloc, slot_ctx );
+
+  /* Idiom recognition */
+
+  do {
+    ulong text[ 14 ] = {
+      I( 0x67, 1, 0, 0, 32 ), I( 0xc7, 1, 0, 0, 32 ), /* SEXT32 at 0 */
+      I( 0xbf, 2, 3, 0, 0  ), I( 0x67, 2, 0, 0, 32 ), I( 0x77, 2, 0, 0, 32 ), /* MOV_ZEXT32 at 2, ZEXT32 at 3 */
+      I( 0x67, 4, 0, 0, 32 ), I( 0xc7, 5, 0, 0, 32 ), /* register mismatch */
+      I( 0x18, 1, 0, 0, 1  ), I( 0x00, 0, 0, 0, 2  ), I( 0x18, 2, 0, 0, 3 ), I( 0x00, 0, 0, 0, 4 ), /* LDQ_LDQ at 7 */
+      I( 0x57, 1, 0, 0, 1  ), I( 0x55, 1, 0, 1, 0  ), /* AND64_JNE_IMM at 11 */
+      I( 0x95, 0, 0, 0, 0  )
+    };
+    FD_TEST( fd_vm_fuse_build( fuse, text, 14UL, FD_SBPF_V0 )==5UL );
+    FD_TEST( fuse[ 0]==FD_VM_FUSE_OP_SEXT32        );
+    FD_TEST( fuse[ 2]==FD_VM_FUSE_OP_MOV_ZEXT32    );
+    FD_TEST( fuse[ 3]==FD_VM_FUSE_OP_ZEXT32        );
+    FD_TEST( fuse[ 5]==FD_VM_FUSE_OP_NONE          );
+    FD_TEST( fuse[ 7]==FD_VM_FUSE_OP_LDQ_LDQ       );
+    FD_TEST( fuse[ 9]==FD_VM_FUSE_OP_NONE          ); /* no LDQ after it */
+    FD_TEST( fuse[11]==FD_VM_FUSE_OP_AND64_JNE_IMM );
+
+    /* LDQ is gone and the memory opcodes moved in SBPF v2 */
+    FD_TEST( fd_vm_fuse_build( fuse, text, 14UL, FD_SBPF_V2 )==4UL );
+    FD_TEST( fuse[ 7]==FD_VM_FUSE_OP_NONE );
+
+    ulong mem[ 3 ] = { I( 0x79, 1, 10, -8, 0 ), I( 0x07, 1, 0, 0, 1 ), I( 0x7b, 10, 1, -8, 0 ) };
+    FD_TEST( fd_vm_fuse_build( fuse, mem, 3UL, FD_SBPF_V0 )==1UL && fuse[0]==FD_VM_FUSE_OP_LDXQ_ADD64_STXQ );
+    FD_TEST( fd_vm_fuse_build( fuse, mem, 3UL, FD_SBPF_V2 )==0UL );
+    FD_TEST( fd_vm_fuse_build( fuse, mem, 2UL, FD_SBPF_V0 )==0UL ); /* idiom must be complete */
+    mem[2] = I( 0x7b, 10, 1, -16, 0 );
+    FD_TEST( fd_vm_fuse_build( fuse, mem, 3UL, FD_SBPF_V0 )==0UL ); /* offset mismatch */
+  } while(0);
+
+# define TEST_DIFF( name, expected_err, sbpf_version, entry_cu, ... ) do {                                  \
+    ulong _text[] = { __VA_ARGS__ };                                                                        \
+    for( int _dm=0; _dm<2; _dm++ ) {                                                                        \
+      int _err = test_diff( (name), _text, sizeof(_text)/sizeof(ulong), (sbpf_version), (entry_cu), _dm,    \
+                            rng, syscalls, instr_ctx );                                                     \
+      if( FD_UNLIKELY( _err!=(expected_err) ) ) FD_LOG_ERR(( "%s: got err %i, expected %i", (name), _err, (expected_err) )); \
+    }                                                                                                       \
+  } while(0)
+
+  TEST_DIFF( "counter", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0x79, 1, 10, -8, 0 ),
+    I( 0x07, 1, 0,   0, 5 ),
+    I( 0x7b, 10, 1, -8, 0 ),
+    I( 0x95, 0, 0,   0, 0 ) );
+
+  TEST_DIFF( "counter ld segv", FD_VM_ERR_EBPF_ACCESS_VIOLATION, FD_SBPF_V2, 100UL,
+    I( 0xb7, 2, 0,   0, 0 ),
+    I( 0x9c, 1, 2,   8, 0 ),
+    I( 0x07, 1, 0,   0, 5 ),
+    I( 0x9f, 2, 1,   8, 0 ),
+    I( 0x95, 0, 0,   0, 0 ) );
+
+  TEST_DIFF( "counter st segv", FD_VM_ERR_EBPF_ACCESS_VIOLATION, FD_SBPF_V0, 100UL,
+    I( 0x18, 2, 0,   0, 0 ),
+    I( 0x00, 0, 0,   0, 1 ),
+    I( 0x79, 1, 2,   0, 0 ),
+    I( 0x07, 1, 0,   0, 5 ),
+    I( 0x7b, 2, 1,   0, 0 ),
+    I( 0x95, 0, 0,   0, 0 ) );
+
+  TEST_DIFF( "jump into idiom", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0xb7, 1, 0,   0, -1 ),
+    I( 0x05, 0, 0,   1, 0  ),
+    I( 0x67, 1, 0,   0, 32 ),
+    I( 0xc7, 1, 0,   0, 32 ),
+    I( 0xbf, 0, 1,   0, 0  ),
+    I( 0x95, 0, 0,   0, 0  ) );
+
+  TEST_DIFF( "loop sigcost", FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS, FD_SBPF_V0, 1000UL,
+    I( 0xb7, 2, 0,   0, 100000 ),
+    I( 0x67, 1, 0,   0, 32 ),
+    I( 0x77, 1, 0,   0, 32 ),
+    I( 0x07, 1, 0,   0, 1  ),
+    I( 0xad, 1, 2,  -4, 0  ),
+    I( 0x95, 0, 0,   0, 0  ) );
+
+  TEST_DIFF( "flag loop", FD_VM_SUCCESS, FD_SBPF_V0, 1000UL,
+    I( 0xb7, 1, 0,   0, 37 ),
+    I( 0x07, 0, 0,   0, 1  ),
+    I( 0x77, 1, 0,   0, 1  ),
+    I( 0xbf, 3, 1,   0, 0  ),
+    I( 0x57, 3, 0,   0, 1  ),
+    I( 0x15, 3, 0,  -5, 0  ),
+    I( 0xbf, 3, 1,   0, 0  ),
+    I( 0x57, 3, 0,   0, 2  ),
+    I( 0x55, 3, 0,  -8, 0  ),
+    I( 0x95, 0, 0,   0, 0  ) );
+
+  TEST_DIFF( "ldq ldq", FD_VM_SUCCESS, FD_SBPF_V1, 100UL,
+    I( 0x18, 0, 0, 0, 0x89abcdef ),
+    I( 0x00, 0, 0, 0, 0x01234567 ),
+    I( 0x18, 0, 0, 0, 1 ),
+    I( 0x00, 0, 0, 0, 2 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+# undef TEST_DIFF
+
+  test_random( rng, syscalls, instr_ctx, iter_cnt );
+  test_bench ( syscalls, instr_ctx );
+
+  fd_sbpf_syscalls_delete( fd_sbpf_syscalls_leave( syscalls ) );
+  fd_valloc_free( valloc, slot_ctx );
+  test_vm_exec_instr_ctx_delete( instr_ctx, valloc );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_halt();
+  return 0;
+}
+
+#undef I
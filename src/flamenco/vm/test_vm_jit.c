@@ -0,0 +1,461 @@
+#include "fd_vm_jit.h"
+#include "../runtime/context/fd_exec_slot_ctx.h"
+#include "../runtime/context/fd_exec_txn_ctx.h"
+#include "../../ballet/murmur3/fd_murmur3.h"
+
+/* test_vm_jit runs programs through both the interpreter and the jit
+   from identical initial vm states and checks that they end in
+   identical states.  This is the differential test mode for the jit:
+   it is meant to be cheap to extend with hand written programs and
+   runs a large number of random programs covering ALU, memory,
+   branch, call and syscall instructions for every SBPF version. */
+
+#define TEXT_MAX (256UL)
+
+#include "test_vm_common.h" /* _vm[0] interpreter, _vm[1] jit */
+
+static uchar jit_mem[ FD_VM_JIT_FOOTPRINT( TEXT_MAX ) ] __attribute__((aligned(FD_VM_JIT_ALIGN)));
+
+/* burn_syscall consumes arg0 & 63 cu and fails if arg1 & 7 is zero,
+   reporting the failure as a budget overrun if arg1 & 8 is set. */
+
+static int
+burn_syscall( void *  _vm,
+              ulong   arg0,
+              ulong   arg1,
+              FD_PARAM_UNUSED ulong arg2,
+              FD_PARAM_UNUSED ulong arg3,
+              FD_PARAM_UNUSED ulong arg4,
+              ulong * ret ) {
+  fd_vm_t * vm = (fd_vm_t *)_vm;
+  ulong     cu = arg0 & 63UL;
+  vm->cu -= fd_ulong_min( cu, vm->cu );
+  *ret = vm->cu;
+  if( FD_LIKELY( arg1 & 7UL ) ) return FD_VM_SUCCESS;
+  vm->instr_ctx->txn_ctx->exec_err      = FD_VM_ERR_INVAL;
+  vm->instr_ctx->txn_ctx->exec_err_kind = FD_EXECUTOR_ERR_KIND_SYSCALL;
+  return (arg1 & 8UL) ? FD_VM_SYSCALL_ERR_COMPUTE_BUDGET_EXCEEDED : FD_VM_ERR_INVAL;
+}
+
+static uint burn_key;
+
+/* test_diff runs text through the interpreter and the jit from the
+   same initial state and checks the results match.  Returns the error
+   (or 1 if the program did not pass validation). */
+
+static int
+test_diff( char const *          name,
+           ulong const *         text,
+           ulong                 text_cnt,
+           ulong                 sbpf_version,
+           ulong                 entry_cu,
+           int                   direct_mapping,
+           fd_rng_t *            rng,
+           fd_vm_jit_t *         jit,
+           fd_sbpf_syscalls_t *  syscalls,
+           fd_exec_instr_ctx_t * instr_ctx ) {
+
+  fd_sha256_t _sha[1];
+  fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+
+  /* Random but identical initial register file and memory */
+
+  ulong reg_init[ 10 ];
+  for( ulong i=0UL; i<10UL; i++ ) {
+    switch( fd_rng_uint_roll( rng, 6U ) ) {
+    case 0U:  reg_init[i] = fd_rng_ulong( rng );                                                      break;
+    case 1U:  reg_init[i] = (ulong)fd_rng_uint_roll( rng, 64U );                                      break;
+    case 2U:  reg_init[i] = FD_VM_MEM_MAP_STACK_REGION_START + fd_rng_ulong_roll( rng, 0x2000UL );   break;
+    case 3U:  reg_init[i] = FD_VM_MEM_MAP_HEAP_REGION_START  + fd_rng_ulong_roll( rng, 0x1000UL );   break;
+    case 4U:  reg_init[i] = FD_VM_MEM_MAP_PROGRAM_REGION_START + fd_rng_ulong_roll( rng, 8UL*text_cnt ); break;
+    default:  reg_init[i] = FD_VM_MEM_MAP_INPUT_REGION_START + fd_rng_ulong_roll( rng, 64UL );      break;
+    }
+  }
+  uint mem_seed = fd_rng_uint( rng );
+
+  fd_sbpf_calldests_t * calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( calldests_mem, TEXT_MAX ) );
+  for( ulong pc=0UL; pc<text_cnt; pc+=3UL ) fd_sbpf_calldests_insert( calldests, pc );
+
+  for( ulong i=0UL; i<2UL; i++ ) {
+    fd_vm_t * vm = vm_setup( _vm+i, text, text_cnt, sbpf_version, entry_cu, direct_mapping, reg_init, calldests, NULL, sha, syscalls, instr_ctx );
+    fd_rng_t _mrng[1]; fd_rng_t * mrng = fd_rng_join( fd_rng_new( _mrng, mem_seed, 0UL ) );
+    for( ulong j=0UL; j<FD_VM_STACK_MAX;    j+=8UL ) FD_STORE( ulong, vm->stack+j, fd_rng_ulong( mrng ) );
+    for( ulong j=0UL; j<FD_VM_HEAP_DEFAULT; j+=8UL ) FD_STORE( ulong, vm->heap +j, fd_rng_ulong( mrng ) );
+    fd_rng_delete( fd_rng_leave( mrng ) );
+  }
+
+  fd_vm_t * vm0 = _vm;
+  fd_vm_t * vm1 = _vm + 1;
+
+  int err = fd_vm_validate( vm0 );
+  if( err ) {
+    FD_TEST( fd_vm_jit_compile( jit, vm1 )==err );
+    FD_TEST( !fd_vm_jit_is_compiled( jit, vm1 ) );
+    FD_TEST( fd_vm_jit_exec( jit, vm1 )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+    err = 1;
+    goto done;
+  }
+
+  FD_TEST( fd_vm_jit_compile( jit, vm1 )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_jit_is_compiled( jit, vm1 ) );
+
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+  int err0 = fd_vm_exec( vm0 );
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+  int err1 = fd_vm_jit_exec( jit, vm1 );
+  test_vm_clear_txn_ctx_err( instr_ctx->txn_ctx );
+
+  int ok = (err0==err1) & (vm0->pc==vm1->pc) & (vm0->ic==vm1->ic) & (vm0->cu==vm1->cu) &
+           (vm0->frame_cnt==vm1->frame_cnt) & (vm0->segv_vaddr==vm1->segv_vaddr) &
+           (vm0->segv_access_type==vm1->segv_access_type);
+  ok &= !memcmp( vm0->reg,    vm1->reg,    sizeof(vm0->reg)                      );
+  ok &= !memcmp( vm0->shadow, vm1->shadow, vm0->frame_cnt*sizeof(fd_vm_shadow_t) );
+  ok &= !memcmp( vm0->stack,  vm1->stack,  FD_VM_STACK_MAX                       );
+  ok &= !memcmp( vm0->heap,   vm1->heap,   FD_VM_HEAP_DEFAULT                    );
+
+  if( FD_UNLIKELY( !ok ) ) {
+    for( ulong pc=0UL; pc<text_cnt; pc++ ) FD_LOG_WARNING(( "text[%3lu] %016lx", pc, text[pc] ));
+    FD_LOG_WARNING(( "err       %i %i",   err0, err1 ));
+    FD_LOG_WARNING(( "pc        %lu %lu", vm0->pc, vm1->pc ));
+    FD_LOG_WARNING(( "ic        %lu %lu", vm0->ic, vm1->ic ));
+    FD_LOG_WARNING(( "cu        %lu %lu", vm0->cu, vm1->cu ));
+    FD_LOG_WARNING(( "frame_cnt %lu %lu", vm0->frame_cnt, vm1->frame_cnt ));
+    FD_LOG_WARNING(( "segv      %lx %lx", vm0->segv_vaddr, vm1->segv_vaddr ));
+    for( ulong j=0UL; j<FD_VM_REG_CNT; j++ ) FD_LOG_WARNING(( "r%-2lu %016lx %016lx", j, vm0->reg[j], vm1->reg[j] ));
+    FD_LOG_ERR(( "%s: interpreter / jit mismatch (sbpf_version %lu, direct_mapping %i)", name, sbpf_version, direct_mapping ));
+  }
+  err = err0;
+
+done:
+  fd_sbpf_calldests_delete( fd_sbpf_calldests_leave( calldests ) );
+  fd_vm_delete( fd_vm_leave( vm1 ) );
+  fd_vm_delete( fd_vm_leave( vm0 ) );
+  fd_sha256_delete( fd_sha256_leave( sha ) );
+  return err;
+}
+
+static void
+test_random( fd_rng_t *            rng,
+             fd_vm_jit_t *         jit,
+             fd_sbpf_syscalls_t *  syscalls,
+             fd_exec_instr_ctx_t * instr_ctx,
+             ulong                 iter_cnt ) {
+  static ulong text[ TEXT_MAX ];
+
+  uint const syscall_key[2] = { accumulator_key, burn_key };
+
+  ulong err_cnt[ 64 ] = {0};
+  for( ulong iter=0UL; iter<iter_cnt; iter++ ) {
+    ulong sbpf_version   = fd_rng_ulong_roll( rng, FD_SBPF_VERSION_COUNT );
+    int   direct_mapping = (int)fd_rng_uint_roll( rng, 2U );
+    ulong text_cnt       = 2UL + fd_rng_ulong_roll( rng, 48UL );
+    ulong entry_cu       = fd_rng_uint_roll( rng, 4U ) ? 100000UL : fd_rng_ulong_roll( rng, 200UL );
+
+    random_text( rng, text, text_cnt, sbpf_version, syscalls, syscall_key, 2UL );
+
+    int err = test_diff( "random", text, text_cnt, sbpf_version, entry_cu, direct_mapping, rng, jit, syscalls, instr_ctx );
+    err_cnt[ (ulong)(-err) & 63UL ]++;
+  }
+
+  for( ulong i=0UL; i<64UL; i++ )
+    if( err_cnt[i] ) FD_LOG_NOTICE(( "%-7s %3i: %lu", i==63UL ? "invalid" : "err", -(int)i, err_cnt[i] ));
+}
+
+/* test_code_budget compiles every opcode with worst case operands
+   (registers furthest into fd_vm_t, offsets and immediates that need
+   the widest encodings, both memory mappings and all SBPF versions)
+   and checks that every program that validates also compiles.  As
+   fd_vm_jit_compile fails a program if any instruction exceeds the per
+   word code budget, this checks that the budget is large enough for any
+   valid program. */
+
+static void
+test_code_budget( fd_vm_jit_t *        jit,
+                  fd_sbpf_syscalls_t * syscalls ) {
+  static ulong text[ 16 ];
+  ulong const text_cnt = 16UL;
+
+  ulong const dst_reg[3] = { 0UL, 9UL, 10UL };
+  ulong const src_reg[2] = { 0UL, 10UL };
+  short const off    [3] = { (short)-1, (short)1, (short)-0x8000 };
+  uint  const imm    [9] = { 0U, 1U, 16U, 32U, 64U, 0x80000000U, 0xffffffffU, fd_pchash( 0U ), accumulator_key };
+
+  fd_sbpf_calldests_t * calldests = fd_sbpf_calldests_join( fd_sbpf_calldests_new( calldests_mem, TEXT_MAX ) );
+  fd_sbpf_calldests_insert( calldests, 0UL );
+
+  ulong ok_cnt = 0UL;
+  for( ulong sbpf_version=0UL; sbpf_version<FD_SBPF_VERSION_COUNT; sbpf_version++ ) {
+    for( int direct_mapping=0; direct_mapping<2; direct_mapping++ ) {
+      for( ulong op=0UL; op<256UL; op++ ) {
+        for( ulong d=0UL; d<3UL; d++ ) for( ulong r=0UL; r<2UL; r++ ) for( ulong o=0UL; o<3UL; o++ ) for( ulong i=0UL; i<9UL; i++ ) {
+          /* Functions have to end with a ja or return from SBPF v3 on */
+
+          for( ulong pc=0UL; pc<text_cnt-2UL; pc++ )
+            text[ pc ] = (op==0x18UL && (pc&1UL)) ? fd_vm_instr( 0x00UL, 0UL, 0UL, 0, imm[i] )
+                                                  : fd_vm_instr( op, dst_reg[d], src_reg[r], off[o], imm[i] );
+          text[ text_cnt-2UL ] = fd_vm_instr( 0x05UL, 0UL, 0UL, -1, 0U );
+          text[ text_cnt-1UL ] = fd_vm_instr( 0x05UL, 0UL, 0UL, -1, 0U );
+
+          fd_vm_t * vm = fd_vm_join( fd_vm_new( _vm ) );
+          vm->sbpf_version   = sbpf_version;
+          vm->calldests      = calldests;
+          vm->syscalls       = syscalls;
+          vm->text           = text;
+          vm->text_cnt       = text_cnt;
+          vm->text_sz        = 8UL*text_cnt;
+          vm->rodata         = (uchar const *)text;
+          vm->rodata_sz      = 8UL*text_cnt;
+          vm->direct_mapping = direct_mapping;
+          int err = fd_vm_validate( vm );
+          int res = fd_vm_jit_compile( jit, vm );
+          if( FD_UNLIKELY( res!=err ) )
+            FD_LOG_ERR(( "op %02lx dst %lu src %lu off %i imm %08x (sbpf_version %lu direct_mapping %i): compile err %i, validate err %i",
+                         op, dst_reg[d], src_reg[r], (int)off[o], imm[i], sbpf_version, direct_mapping, res, err ));
+          ok_cnt += (ulong)!err;
+          fd_vm_delete( fd_vm_leave( vm ) );
+        }
+      }
+    }
+  }
+  FD_TEST( ok_cnt );
+  FD_LOG_NOTICE(( "code budget: %lu programs compiled", ok_cnt ));
+
+  fd_sbpf_calldests_delete( fd_sbpf_calldests_leave( calldests ) );
+}
+
+static void
+test_bench( fd_rng_t *            rng,
+            fd_vm_jit_t *         jit,
+            fd_sbpf_syscalls_t *  syscalls,
+            fd_exec_instr_ctx_t * instr_ctx ) {
+  (void)rng;
+
+  /* A tight counting loop: r0 = sum_{i<n} i, exits with r0 */
+
+  ulong const text[ 8 ] = {
+    fd_vm_instr( 0xb7UL, 0UL, 0UL,  0, 0U       ), /* mov64 r0, 0        */
+    fd_vm_instr( 0xb7UL, 1UL, 0UL,  0, 0U       ), /* mov64 r1, 0        */
+    fd_vm_instr( 0x0fUL, 0UL, 1UL,  0, 0U       ), /* add64 r0, r1       */
+    fd_vm_instr( 0x07UL, 1UL, 0UL,  0, 1U       ), /* add64 r1, 1        */
+    fd_vm_instr( 0x7bUL, 10UL,0UL, -8, 0U       ), /* stxdw [r10-8], r0  */
+    fd_vm_instr( 0x79UL, 0UL, 10UL,-8, 0U       ), /* ldxdw r0, [r10-8]  */
+    fd_vm_instr( 0xa5UL, 1UL, 0UL, -5, 1000000U ), /* jlt r1, 1000000, 2 */
+    fd_vm_instr( 0x95UL, 0UL, 0UL,  0, 0U       )  /* exit               */
+  };
+
+  for( ulong i=0UL; i<2UL; i++ ) {
+    fd_sha256_t _sha[1];
+    fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+    fd_vm_t * vm = fd_vm_join( fd_vm_new( _vm ) );
+    FD_TEST( fd_vm_init( vm, instr_ctx, FD_VM_HEAP_DEFAULT, 100000000UL, (uchar const *)text, 64UL, text, 8UL, 0UL, 64UL, 0UL,
+                         NULL, FD_SBPF_V0, syscalls, NULL, sha, NULL, 0U, NULL, 0, 0, 0 ) );
+    if( i ) FD_TEST( !fd_vm_jit_compile( jit, vm ) );
+    long dt = -fd_log_wallclock();
+    int err = i ? fd_vm_jit_exec( jit, vm ) : fd_vm_exec( vm );
+    dt += fd_log_wallclock();
+    FD_TEST( !err );
+    FD_TEST( vm->reg[0]==999999UL*1000000UL/2UL );
+    FD_LOG_NOTICE(( "%-6s %lu instr in %11li ns (%.3f ns/instr)", i ? "jit" : "interp", vm->ic, dt, (double)dt/(double)vm->ic ));
+    fd_vm_delete( fd_vm_leave( vm ) );
+    fd_sha256_delete( fd_sha256_leave( sha ) );
+  }
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  ulong iter_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--iter-cnt", NULL, 20000UL );
+
+  fd_rng_t _rng[1]; fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, 0U, 0UL ) );
+
+  fd_sbpf_syscalls_t * syscalls = fd_sbpf_syscalls_join( fd_sbpf_syscalls_new( _syscalls ) ); FD_TEST( syscalls );
+  FD_TEST( fd_vm_syscall_register( syscalls, "accumulator", accumulator_syscall )==FD_VM_SUCCESS );
+  FD_TEST( fd_vm_syscall_register( syscalls, "burn",        burn_syscall        )==FD_VM_SUCCESS );
+  accumulator_key = fd_murmur3_32( "accumulator", 11UL, 0U );
+  burn_key        = fd_murmur3_32( "burn",         4UL, 0U );
+
+  fd_valloc_t valloc = fd_libc_alloc_virtual();
+  fd_exec_slot_ctx_t  * slot_ctx  = fd_valloc_malloc( valloc, FD_EXEC_SLOT_CTX_ALIGN, FD_EXEC_SLOT_CTX_FOOTPRINT );
+  fd_exec_instr_ctx_t * instr_ctx = test_vm_minimal_exec_instr_ctx( valloc, slot_ctx );
+
+  FD_TEST( fd_vm_jit_align()==FD_VM_JIT_ALIGN );
+  FD_TEST( fd_vm_jit_footprint( TEXT_MAX )==FD_VM_JIT_FOOTPRINT( TEXT_MAX ) );
+  FD_TEST( !fd_vm_jit_footprint( 0UL ) );
+  FD_TEST( !fd_vm_jit_footprint( FD_VM_JIT_TEXT_MAX+1UL ) );
+
+  FD_TEST( !fd_vm_jit_new( NULL,        TEXT_MAX ) );
+  FD_TEST( !fd_vm_jit_new( jit_mem+1UL, TEXT_MAX ) );
+  FD_TEST( !fd_vm_jit_new( jit_mem,     0UL      ) );
+  fd_vm_jit_t * jit = fd_vm_jit_join( fd_vm_jit_new( jit_mem, TEXT_MAX ) ); FD_TEST( jit );
+
+# define TEST_DIFF( name, expected_err, sbpf_version, entry_cu, ... ) do {                                  \
+    ulong _text[] = { __VA_ARGS__ };                                                                        \
+    for( int _dm=0; _dm<2; _dm++ ) {                                                                        \
+      int _err = test_diff( (name), _text, sizeof(_text)/sizeof(ulong), (sbpf_version), (entry_cu), _dm,    \
+                            rng, jit, syscalls, instr_ctx );                                                \
+      if( FD_UNLIKELY( _err!=(expected_err) ) ) FD_LOG_ERR(( "%s: got err %i, expected %i", (name), _err, (expected_err) )); \
+    }                                                                                                       \
+  } while(0)
+
+# define I( op, dst, src, off, imm ) fd_vm_instr( (op), (dst), (src), (short)(off), (uint)(imm) )
+
+  TEST_DIFF( "exit", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0xb7, 0, 0, 0, 42 ),
+    I( 0x95, 0, 0, 0, 0  ) );
+
+  TEST_DIFF( "0cu exit", FD_VM_SUCCESS, FD_SBPF_V0, 2UL,
+    I( 0xaf, 0, 0, 0, 0 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "sigcost", FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS, FD_SBPF_V0, 1UL,
+    I( 0xaf, 0, 0, 0, 0 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "sigcost loop", FD_VM_ERR_EBPF_EXCEEDED_MAX_INSTRUCTIONS, FD_SBPF_V0, 1000UL,
+    I( 0x07, 0, 0, 0, 1 ),
+    I( 0x05, 0, 0, -2, 0 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "ldq", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0x18, 0, 0, 0, 0x89abcdef ),
+    I( 0x00, 0, 0, 0, 0x01234567 ),
+    I( 0x18, 1, 0, 0, 1 ),
+    I( 0x00, 0, 0, 0, 0 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "ldq sigill", FD_VM_ERR_EBPF_UNSUPPORTED_INSTRUCTION, FD_SBPF_V0, 100UL,
+    I( 0x18, 1, 0, 0, 32 ),
+    I( 0x00, 0, 0, 0, 1 ),
+    I( 0x8d, 0, 1, 0, 1 ),
+    I( 0x18, 0, 0, 0, 1 ),
+    I( 0x00, 0, 0, 0, 2 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "div0", FD_VM_ERR_EBPF_DIVIDE_BY_ZERO, FD_SBPF_V0, 100UL,
+    I( 0xb7, 1, 0, 0, 0 ),
+    I( 0x07, 0, 0, 0, 1 ),
+    I( 0x3f, 0, 1, 0, 0 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "sdiv overflow", FD_VM_ERR_EBPF_DIVIDE_OVERFLOW, FD_SBPF_V2, 100UL,
+    I( 0xb7, 0, 0, 0, 1 ),
+    I( 0x67, 0, 0, 0, 63 ),
+    I( 0xd6, 0, 0, 0, -1 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "segv", FD_VM_ERR_EBPF_ACCESS_VIOLATION, FD_SBPF_V0, 100UL,
+    I( 0xb7, 1, 0, 0, 0 ),
+    I( 0x79, 0, 1, 8, 0 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  /* The stack has gaps between frames only without direct mapping */
+
+  do {
+    ulong text[2] = { fd_vm_instr( 0x7aUL, 10UL, 0UL, 8, 1U ), fd_vm_instr( 0x95UL, 0UL, 0UL, 0, 0U ) };
+    FD_TEST( test_diff( "stack gap", text, 2UL, FD_SBPF_V0, 100UL, 0, rng, jit, syscalls, instr_ctx )==FD_VM_ERR_EBPF_STACK_ACCESS_VIOLATION );
+    FD_TEST( test_diff( "stack gap", text, 2UL, FD_SBPF_V0, 100UL, 1, rng, jit, syscalls, instr_ctx )==FD_VM_SUCCESS                        );
+  } while(0);
+
+  TEST_DIFF( "store to program", FD_VM_ERR_EBPF_ACCESS_VIOLATION, FD_SBPF_V0, 100UL,
+    I( 0x18, 1, 0, 0, 0 ),
+    I( 0x00, 0, 0, 0, 1 ),
+    I( 0x62, 1, 0, 0, 7 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "call exit", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0x85, 0, 0, 0, fd_pchash( 3U ) ),
+    I( 0x07, 0, 0, 0, 1 ),
+    I( 0x95, 0, 0, 0, 0 ),
+    I( 0xb7, 0, 0, 0, 7 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "call depth", FD_VM_ERR_EBPF_CALL_DEPTH_EXCEEDED, FD_SBPF_V0, 100000UL,
+    I( 0x85, 0, 0, 0, fd_pchash( 0U ) ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "syscall", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0xb7, 1, 0, 0, 1 ),
+    I( 0xb7, 2, 0, 0, 2 ),
+    I( 0x85, 0, 0, 0, accumulator_key ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "syscall err", FD_VM_ERR_EBPF_SYSCALL_ERROR, FD_SBPF_V0, 100UL,
+    I( 0xb7, 1, 0, 0, 5 ),
+    I( 0xb7, 2, 0, 0, 8 ),
+    I( 0x85, 0, 0, 0, burn_key ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "callx", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0x18, 1, 0, 0, 32 ),
+    I( 0x00, 0, 0, 0, 1 ),
+    I( 0x8d, 0, 1, 0, 1 ),
+    I( 0x95, 0, 0, 0, 0 ),
+    I( 0xb7, 0, 0, 0, 3 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "callx outside text", FD_VM_ERR_EBPF_CALL_OUTSIDE_TEXT_SEGMENT, FD_SBPF_V0, 100UL,
+    I( 0xb7, 1, 0, 0, 0 ),
+    I( 0x8d, 0, 1, 0, 1 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "end", FD_VM_SUCCESS, FD_SBPF_V0, 100UL,
+    I( 0x18, 0, 0, 0, 0x89abcdef ),
+    I( 0x00, 0, 0, 0, 0x01234567 ),
+    I( 0xdc, 0, 0, 0, 16 ),
+    I( 0x18, 1, 0, 0, 0x89abcdef ),
+    I( 0x00, 0, 0, 0, 0x01234567 ),
+    I( 0xdc, 1, 0, 0, 32 ),
+    I( 0xd4, 1, 0, 0, 16 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "v3 call", FD_VM_SUCCESS, FD_SBPF_V3, 100UL,
+    I( 0x85, 0, 1, 0, 2 ),
+    I( 0x07, 0, 0, 0, 1 ),
+    I( 0x9d, 0, 0, 0, 0 ),
+    I( 0xb7, 0, 0, 0, 9 ),
+    I( 0x9d, 0, 0, 0, 0 ) );
+
+  TEST_DIFF( "invalid", 1, FD_SBPF_V0, 100UL,
+    I( 0xff, 0, 0, 0, 0 ),
+    I( 0x95, 0, 0, 0, 0 ) );
+
+# undef I
+# undef TEST_DIFF
+
+  /* Running a different program than the one compiled falls back */
+
+  do {
+    ulong text[2] = { fd_vm_instr( 0xb7UL, 0UL, 0UL, 0, 1U ), fd_vm_instr( 0x95UL, 0UL, 0UL, 0, 0U ) };
+    fd_sha256_t _sha[1];
+    fd_sha256_t * sha = fd_sha256_join( fd_sha256_new( _sha ) );
+    fd_vm_t * vm = fd_vm_join( fd_vm_new( _vm ) );
+    FD_TEST( fd_vm_init( vm, instr_ctx, FD_VM_HEAP_DEFAULT, 100UL, (uchar const *)text, 16UL, text, 2UL, 0UL, 16UL, 0UL,
+                         NULL, FD_SBPF_V0, syscalls, NULL, sha, NULL, 0U, NULL, 0, 0, 0 ) );
+    FD_TEST( !fd_vm_jit_compile( jit, vm ) );
+    FD_TEST( fd_vm_jit_is_compiled( jit, vm ) );
+    vm->text_cnt = 1UL;
+    FD_TEST( !fd_vm_jit_is_compiled( jit, vm ) );
+    FD_TEST( fd_vm_jit_exec( jit, vm )==FD_VM_ERR_EBPF_JIT_NOT_COMPILED );
+    vm->text_cnt = 2UL;
+    FD_TEST( !fd_vm_jit_exec( jit, vm ) && vm->reg[0]==1UL );
+    fd_vm_delete( fd_vm_leave( vm ) );
+    fd_sha256_delete( fd_sha256_leave( sha ) );
+  } while(0);
+
+  test_code_budget( jit, syscalls );
+  test_random( rng, jit, syscalls, instr_ctx, iter_cnt );
+  test_bench ( rng, jit, syscalls, instr_ctx );
+
+  FD_TEST( fd_vm_jit_delete( fd_vm_jit_leave( jit ) )==jit_mem );
+
+  fd_sbpf_syscalls_delete( fd_sbpf_syscalls_leave( syscalls ) );
+  fd_valloc_free( valloc, slot_ctx );
+  test_vm_exec_instr_ctx_delete( instr_ctx, valloc );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_rng_delete( fd_rng_leave( rng ) );
+  fd_halt();
+  return 0;
+}
@@ -19,5 +19,7 @@ ifdef FD_HAS_HOSTED
 $(call make-unit-test,test_funk_txn2,test_funk_txn2,fd_funk fd_util)
 $(call run-unit-test,test_funk_txn2,)
 $(call make-unit-test,bench_funk_index,bench_funk_index,fd_funk fd_util)
+$(call make-unit-test,test_funk_publish_concur,test_funk_publish_concur,fd_funk fd_util)
+$(call run-unit-test,test_funk_publish_concur,)
 endif
 endif
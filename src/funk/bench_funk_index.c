@@ -11,7 +11,7 @@ run_benchmark( fd_funk_t * funk,
   fd_wksp_t * funk_wksp = fd_funk_wksp( funk );
   ulong acc_rem=acc_cnt;
   while( acc_rem-- ) {
-    fd_funk_rec_key_t key;
+    fd_funk_rec_key_t key = {0};
     key.ul[ 0 ] = fd_rng_ulong( rng );
     fd_funk_rec_prepare_t prepare[1];
     fd_funk_rec_t * rec = fd_funk_rec_prepare( funk, NULL, &key, prepare, NULL );
@@ -26,6 +26,47 @@ run_benchmark( fd_funk_t * funk,
   }
 }
 
+/* query_key sets key to the key of the acc_idx-th account inserted by
+   run_benchmark.  The insert loop consumes 2 rng slots per key. */
+
+static void
+query_key( fd_funk_rec_key_t * key,
+           uint                rng_seed,
+           ulong               acc_idx ) {
+  fd_rng_t rng_[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( rng_, rng_seed, 2UL*acc_idx ) );
+  memset( key, 0, sizeof(fd_funk_rec_key_t) );
+  key->ul[ 0 ] = fd_rng_ulong( rng );
+  fd_rng_delete( fd_rng_leave( rng ) );
+}
+
+/* run_query looks up the query_cnt keys at key one at a time (batch_sz
+   0) or with fd_funk_rec_query_batch in batch_sz calls.  Returns the
+   time taken in ns. */
+
+__attribute__((noinline)) static long
+run_query( fd_funk_t const *         funk,
+           fd_funk_rec_key_t const * key,
+           ulong                     query_cnt,
+           ulong                     batch_sz,
+           fd_funk_rec_t const **    rec,
+           fd_funk_rec_query_t *     query ) {
+  ulong found_cnt = 0UL;
+  long dt = -fd_log_wallclock();
+  if( !batch_sz ) {
+    for( ulong i=0UL; i<query_cnt; i++ ) {
+      found_cnt += !!fd_funk_rec_query_try_global( funk, NULL, key+i, NULL, query );
+    }
+  } else {
+    for( ulong i=0UL; i<query_cnt; i+=batch_sz ) {
+      found_cnt += fd_funk_rec_query_batch( funk, NULL, key+i, fd_ulong_min( batch_sz, query_cnt-i ), rec, query );
+    }
+  }
+  dt += fd_log_wallclock();
+  if( FD_UNLIKELY( found_cnt!=query_cnt ) ) FD_LOG_ERR(( "found %lu of %lu keys", found_cnt, query_cnt ));
+  return dt;
+}
+
 static void
 stat_chains( fd_funk_t * funk ) {
   fd_funk_rec_map_t * rec_map = fd_funk_rec_map( funk );
@@ -66,10 +107,14 @@ main( int     argc,
   uint         rng_seed   = fd_env_strip_cmdline_uint  ( &argc, &argv, "--rng-seed",   NULL,          1234UL );
   ulong        funk_seed  = fd_env_strip_cmdline_ulong ( &argc, &argv, "--funk-seed",  NULL,          1234UL );
   int          fast_clean = fd_env_strip_cmdline_int   ( &argc, &argv, "--fast-clean", NULL,               1 );
+  double       queries_d  = fd_env_strip_cmdline_double( &argc, &argv, "--queries",    NULL,             1e6 );
+  ulong        batch_sz   = fd_env_strip_cmdline_ulong ( &argc, &argv, "--batch",      NULL,           256UL );
 
   ulong const txn_max = 16UL;
   ulong const acc_cnt = (ulong)acc_cnt_d;
   ulong const rec_max = (ulong)rec_max_d;
+  ulong const query_cnt = (ulong)queries_d;
+  if( FD_UNLIKELY( !batch_sz ) ) FD_LOG_ERR(( "--batch must be positive" ));
 
   fd_rng_t rng_[1];
   fd_rng_t * rng = fd_rng_join( fd_rng_new( rng_, rng_seed, 0UL ) );
@@ -113,6 +158,35 @@ main( int     argc,
 
   stat_chains( funk );
 
+  if( query_cnt && acc_cnt ) {
+
+    /* Look up uniformly random inserted keys.  The keys are generated
+       up front so the timed loops only measure the index. */
+
+    fd_funk_rec_key_t *     key   = fd_wksp_alloc_laddr( wksp, alignof(fd_funk_rec_key_t), query_cnt*sizeof(fd_funk_rec_key_t), FUNK_TAG );
+    fd_funk_rec_t const **  rec   = fd_wksp_alloc_laddr( wksp, alignof(fd_funk_rec_t const *), batch_sz*sizeof(fd_funk_rec_t const *), FUNK_TAG );
+    fd_funk_rec_query_t *   query = fd_wksp_alloc_laddr( wksp, alignof(fd_funk_rec_query_t), batch_sz*sizeof(fd_funk_rec_query_t), FUNK_TAG );
+    if( FD_UNLIKELY( !key || !rec || !query ) ) FD_LOG_ERR(( "failed to allocate queries" ));
+
+    fd_rng_t qrng_[1];
+    fd_rng_t * qrng = fd_rng_join( fd_rng_new( qrng_, rng_seed+1U, 0UL ) );
+    for( ulong i=0UL; i<query_cnt; i++ ) query_key( key+i, rng_seed, fd_rng_ulong_roll( qrng, acc_cnt ) );
+    fd_rng_delete( fd_rng_leave( qrng ) );
+
+    FD_LOG_NOTICE(( "Starting query loop (--queries %lu --batch %lu)", query_cnt, batch_sz ));
+    for( ulong rep=0UL; rep<2UL; rep++ ) {
+      long dt_single = run_query( funk, key, query_cnt, 0UL,      rec, query );
+      long dt_batch  = run_query( funk, key, query_cnt, batch_sz, rec, query );
+      FD_LOG_NOTICE(( "query_try_global %.1fns/key, query_batch %.1fns/key (%.2fx)",
+                      (double)dt_single/(double)query_cnt, (double)dt_batch/(double)query_cnt,
+                      (double)dt_single/(double)dt_batch ));
+    }
+
+    fd_wksp_free_laddr( query );
+    fd_wksp_free_laddr( rec   );
+    fd_wksp_free_laddr( key   );
+  }
+
   dt = -fd_log_wallclock();
   fd_funk_leave( funk, NULL );
   if( fast_clean ) {
@@ -2,6 +2,11 @@
 #include "fd_funk_base.h"
 #include <stdio.h>
 
+/* Funk fields added in what used to be padding keep the shmem layout
+   (and thus the footprint of existing funks) unchanged */
+
+FD_STATIC_ASSERT( sizeof(fd_funk_shmem_t)==FD_FUNK_ALIGN, layout );
+
 ulong
 fd_funk_align( void ) {
   return FD_FUNK_ALIGN;
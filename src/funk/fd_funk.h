@@ -160,6 +160,15 @@
 
 #define FD_FUNK_MAGIC (0xf17eda2ce7fc2c02UL) /* firedancer funk version 2 */
 
+/* FD_FUNK_READER_MAX is the number of reader slots available for
+   deferred record reclamation (see fd_funk_reader_enter).
+   FD_FUNK_READER_STUCK_EPOCH_CNT is the number of reclamation epochs
+   after which fd_funk_txn_reclaim reports a reader that is still
+   inside the region it entered. */
+
+#define FD_FUNK_READER_MAX             (64UL)
+#define FD_FUNK_READER_STUCK_EPOCH_CNT (1UL<<16)
+
 struct __attribute__((aligned(FD_FUNK_ALIGN))) fd_funk_shmem_private {
 
   /* Metadata */
@@ -255,6 +264,21 @@ struct __attribute__((aligned(FD_FUNK_ALIGN))) fd_funk_shmem_private {
   ulong alloc_gaddr; /* Non-zero wksp gaddr with tag wksp tag */
   uchar lock;        /* lock for synchronizing modifications to funk object */
 
+  /* Records replaced or removed by a publish are not freed immediately
+     as concurrent readers might still be looking at them.  They are
+     put on the retire list (linked through next_idx, oldest first,
+     with the retire epoch stashed in txn_cidx) and freed once every
+     reader in reader_epoch has moved past the epoch they were retired
+     in.  See fd_funk_reader_enter for details.  These
+     live in what used to be padding so a zero initialized region is a
+     valid empty state (retire_cnt is authoritative for the list). */
+
+  ulong retire_epoch;    /* Current reclamation epoch */
+  ulong retire_cnt;      /* Number of records on the retire list */
+  uint  retire_head_idx; /* Record pool index of the oldest retired record, ignored if retire_cnt is 0 */
+  uint  retire_tail_idx; /* "                         youngest          " */
+  ulong reader_epoch[ FD_FUNK_READER_MAX ]; /* 2*epoch+1 if inside a region since epoch, 0 otherwise */
+
   /* Padding to FD_FUNK_ALIGN here */
 };
 
@@ -504,6 +528,64 @@ fd_end_crit(fd_funk_t * funk) {
    funk->shmem->magic = FD_FUNK_MAGIC;
 }
 
+/* fd_funk_reader_init prepares reader slot reader_idx in
+   [0,FD_FUNK_READER_MAX) for use by a thread that reads funk
+   concurrently with publishes (e.g. an exec tile).  Slots are not
+   allocated at run time, each reader is assigned a fixed slot up front
+   (e.g. one per tile by the topology).  A reader that restarts (or its
+   replacement) inits its slot again, which releases whatever region a
+   crashed predecessor left open. */
+
+static inline void
+fd_funk_reader_init( fd_funk_t * funk,
+                     ulong       reader_idx ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( funk->shmem->reader_epoch[ reader_idx ] ) = 0UL;
+  FD_COMPILER_MFENCE();
+}
+
+/* fd_funk_reader_{enter,leave} bracket a region in which the caller
+   might hold pointers to records (and their values) of transactions
+   that are concurrently being published with fd_funk_txn_publish_step
+   (or fd_funk_txn_publish).  Records that a publish replaces are
+   retired instead of freed and are only recycled once every reader
+   that was inside such a region when they were retired has left it.
+
+   reader_idx is the reader's slot (see fd_funk_reader_init).  A reader
+   slot should be used by at most one thread at a time and regions
+   don't nest.  Readers that never enter a region are not protected
+   but don't slow down reclamation either.  A reader that stays inside
+   a region indefinitely holds back reclamation (retired records
+   accumulate until it leaves, publishes keep going), so regions
+   should be short (e.g. the execution of a single transaction).
+   fd_funk_txn_reclaim logs a warning for a reader that stayed inside
+   a region for FD_FUNK_READER_STUCK_EPOCH_CNT epochs. */
+
+static inline void
+fd_funk_reader_enter( fd_funk_t * funk,
+                      ulong       reader_idx ) {
+  fd_funk_shmem_t * shmem = funk->shmem;
+  ulong epoch = FD_VOLATILE_CONST( shmem->retire_epoch );
+  /* The xchg is a full fence so the publisher either sees us active
+     or we see the map after it retired the records it will free */
+  (void)FD_ATOMIC_XCHG( &shmem->reader_epoch[ reader_idx ], (epoch<<1) | 1UL );
+}
+
+static inline void
+fd_funk_reader_leave( fd_funk_t * funk,
+                      ulong       reader_idx ) {
+  FD_COMPILER_MFENCE();
+  FD_VOLATILE( funk->shmem->reader_epoch[ reader_idx ] ) = 0UL;
+}
+
+/* fd_funk_retire_cnt returns the number of records currently waiting
+   for readers before they can be freed. */
+
+FD_FN_PURE static inline ulong
+fd_funk_retire_cnt( fd_funk_t const * funk ) {
+  return FD_VOLATILE_CONST( funk->shmem->retire_cnt );
+}
+
 /* Misc */
 
 /* fd_funk_verify verifies the integrity of funk.  Returns
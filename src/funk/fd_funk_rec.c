@@ -1,4 +1,7 @@
 #include "fd_funk.h"
+#if FD_HAS_AVX512
+#include "../util/simd/fd_avx512.h"
+#endif
 
 /* Provide the actual record map implementation */
 
@@ -101,31 +104,23 @@ fd_funk_rec_modify_publish( fd_funk_rec_query_t * query ) {
   fd_funk_rec_map_modify_test( query );
 }
 
-fd_funk_rec_t const *
-fd_funk_rec_query_try_global( fd_funk_t const *         funk,
-                              fd_funk_txn_t const *     txn,
-                              fd_funk_rec_key_t const * key,
-                              fd_funk_txn_t const **    txn_out,
-                              fd_funk_rec_query_t *     query ) {
-#ifdef FD_FUNK_HANDHOLDING
-  if( FD_UNLIKELY( funk==NULL || key==NULL || query==NULL ) ) {
-    return NULL;
-  }
-  if( FD_UNLIKELY( txn && !fd_funk_txn_valid( funk, txn ) ) ) {
-    return NULL;
-  }
-#endif
+/* fd_funk_rec_query_global_private is fd_funk_rec_query_try_global
+   for a key whose hash is already known. */
+
+static inline fd_funk_rec_t const *
+fd_funk_rec_query_global_private( fd_funk_t const *         funk,
+                                  fd_funk_txn_t const *     txn,
+                                  fd_funk_rec_key_t const * key,
+                                  ulong                     hash,
+                                  fd_funk_txn_t const **    txn_out,
+                                  fd_funk_rec_query_t *     query ) {
 
   /* Look for the first element in the hash chain with the right
      record key. This takes advantage of the fact that elements with
      the same record key appear on the same hash chain in order of
      newest to oldest. */
 
-  fd_funk_xid_key_pair_t pair[1];
-  fd_funk_rec_key_set_pair( pair, txn, key );
-
   fd_funk_rec_map_shmem_t * rec_map = funk->rec_map->map;
-  ulong hash = fd_funk_rec_map_key_hash( pair, rec_map->seed );
   ulong chain_idx = (hash & (rec_map->chain_cnt-1UL) );
 
   fd_funk_rec_map_shmem_private_chain_t * chain = fd_funk_rec_map_shmem_private_chain( rec_map, hash );
@@ -164,6 +159,151 @@ fd_funk_rec_query_try_global( fd_funk_t const *         funk,
   return NULL;
 }
 
+fd_funk_rec_t const *
+fd_funk_rec_query_try_global( fd_funk_t const *         funk,
+                              fd_funk_txn_t const *     txn,
+                              fd_funk_rec_key_t const * key,
+                              fd_funk_txn_t const **    txn_out,
+                              fd_funk_rec_query_t *     query ) {
+#ifdef FD_FUNK_HANDHOLDING
+  if( FD_UNLIKELY( funk==NULL || key==NULL || query==NULL ) ) {
+    return NULL;
+  }
+  if( FD_UNLIKELY( txn && !fd_funk_txn_valid( funk, txn ) ) ) {
+    return NULL;
+  }
+#endif
+
+  ulong hash = fd_funk_rec_key_hash( key, funk->rec_map->map->seed );
+  return fd_funk_rec_query_global_private( funk, txn, key, hash, txn_out, query );
+}
+
+void
+fd_funk_rec_key_hash_batch( fd_funk_rec_key_t const * key,
+                            ulong                     cnt,
+                            ulong                     seed,
+                            ulong *                   hash ) {
+  ulong i = 0UL;
+
+# if FD_HAS_AVX512
+  /* Lane j hashes key[i+j].  Keys are 5 ulongs, so word w of the 8
+     keys is a stride 5 gather.  This is fd_funk_rec_key_hash with
+     fd_ulong_hash done 8 keys at a time. */
+
+  wwv_t const idx = wwv( 0UL, 5UL, 10UL, 15UL, 20UL, 25UL, 30UL, 35UL );
+  wwv_t const m0  = wwv_bcast( 0xff51afd7ed558ccdUL );
+  wwv_t const m1  = wwv_bcast( 0xc4ceb9fe1a85ec53UL );
+  wwv_t const s   = wwv_bcast( seed );
+
+# define FMIX64(x) do {                          \
+    x = wwv_xor( x, wwv_shr( x, 33 ) ); x = wwv_mul( x, m0 ); \
+    x = wwv_xor( x, wwv_shr( x, 33 ) ); x = wwv_mul( x, m1 ); \
+    x = wwv_xor( x, wwv_shr( x, 33 ) );          \
+  } while(0)
+
+  for( ; i+8UL<=cnt; i+=8UL ) {
+    ulong const * base = key[ i ].ul;
+    wwv_t k0 = _mm512_i64gather_epi64( idx, base+0, 8 );
+    wwv_t k1 = _mm512_i64gather_epi64( idx, base+1, 8 );
+    wwv_t k2 = _mm512_i64gather_epi64( idx, base+2, 8 );
+    wwv_t k3 = _mm512_i64gather_epi64( idx, base+3, 8 );
+    wwv_t k4 = _mm512_i64gather_epi64( idx, base+4, 8 );
+    wwv_t t  = wwv_xor( s, k4 );
+    wwv_t x0 = wwv_xor( wwv_xor( t, wwv_bcast( 1UL<<0 ) ), k0 ); FMIX64( x0 );
+    wwv_t x1 = wwv_xor( wwv_xor( t, wwv_bcast( 1UL<<1 ) ), k1 ); FMIX64( x1 );
+    wwv_t x2 = wwv_xor( wwv_xor( t, wwv_bcast( 1UL<<2 ) ), k2 ); FMIX64( x2 );
+    wwv_t x3 = wwv_xor( wwv_xor( t, wwv_bcast( 1UL<<3 ) ), k3 ); FMIX64( x3 );
+    wwv_stu( hash+i, wwv_xor( wwv_xor( x0, x1 ), wwv_xor( x2, x3 ) ) );
+  }
+
+# undef FMIX64
+# endif
+
+  for( ; i<cnt; i++ ) hash[ i ] = fd_funk_rec_key_hash( key+i, seed );
+}
+
+ulong
+fd_funk_rec_query_batch( fd_funk_t const *             funk,
+                         fd_funk_txn_t const * const * txn,
+                         fd_funk_rec_key_t const *     key,
+                         ulong                         cnt,
+                         fd_funk_rec_t const **        rec_out,
+                         fd_funk_rec_query_t *         query ) {
+  fd_funk_rec_map_shmem_t const * rec_map = funk->rec_map->map;
+  fd_funk_rec_t const *           ele0    = funk->rec_map->ele;
+  ulong                           ele_max = funk->rec_map->ele_max;
+  ulong                           seed    = rec_map->seed;
+
+  ulong hash[ FD_FUNK_REC_QUERY_BATCH_MAX ];
+  ulong found_cnt = 0UL;
+
+  for( ulong off=0UL; off<cnt; off+=FD_FUNK_REC_QUERY_BATCH_MAX ) {
+    ulong                     batch_cnt = fd_ulong_min( cnt-off, FD_FUNK_REC_QUERY_BATCH_MAX );
+    fd_funk_rec_key_t const * batch_key = key + off;
+
+    /* Each stage only depends on lines requested by the previous stage
+       for all the keys of the batch, so the cache misses of the batch
+       overlap instead of being taken one key at a time. */
+
+    fd_funk_rec_key_hash_batch( batch_key, batch_cnt, seed, hash );
+
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      __builtin_prefetch( fd_funk_rec_map_shmem_private_chain_const( rec_map, hash[ i ] ) );
+    }
+
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      ulong ele_idx = (ulong)FD_VOLATILE_CONST( fd_funk_rec_map_shmem_private_chain_const( rec_map, hash[ i ] )->head_cidx );
+      if( FD_LIKELY( ele_idx<ele_max ) ) __builtin_prefetch( ele0 + ele_idx );
+    }
+
+    for( ulong i=0UL; i<batch_cnt; i++ ) {
+      fd_funk_rec_t const * rec = fd_funk_rec_query_global_private( funk, txn ? txn[ off+i ] : NULL, batch_key+i, hash[ i ], NULL, query+off+i );
+      rec_out[ off+i ] = rec;
+      found_cnt += !!rec;
+    }
+  }
+
+  return found_cnt;
+}
+
+ulong
+fd_funk_rec_prefetch_chain( fd_funk_t const *         funk,
+                            fd_funk_rec_key_t const * key ) {
+  fd_funk_rec_map_shmem_t const * rec_map = funk->rec_map->map;
+  ulong hash = fd_funk_rec_key_hash( key, rec_map->seed );
+  __builtin_prefetch( fd_funk_rec_map_shmem_private_chain_const( rec_map, hash ) );
+  return hash;
+}
+
+void
+fd_funk_rec_prefetch_ele( fd_funk_t const * funk,
+                          ulong             hash ) {
+  fd_funk_rec_map_shmem_private_chain_t const * chain = fd_funk_rec_map_shmem_private_chain_const( funk->rec_map->map, hash );
+  ulong ele_idx = (ulong)FD_VOLATILE_CONST( chain->head_cidx );
+  if( FD_LIKELY( ele_idx<funk->rec_map->ele_max ) ) __builtin_prefetch( funk->rec_map->ele + ele_idx );
+}
+
+void
+fd_funk_rec_prefetch_val( fd_funk_t const * funk,
+                          ulong             hash,
+                          ulong             sz ) {
+  fd_funk_rec_map_shmem_private_chain_t const * chain = fd_funk_rec_map_shmem_private_chain_const( funk->rec_map->map, hash );
+  ulong ele_idx = (ulong)FD_VOLATILE_CONST( chain->head_cidx );
+  if( FD_UNLIKELY( ele_idx>=funk->rec_map->ele_max ) ) return;
+
+  fd_funk_rec_t const * rec = funk->rec_map->ele + ele_idx;
+  if( FD_UNLIKELY( rec->map_hash!=hash ) ) return;
+  ulong val_gaddr = rec->val_gaddr;
+  ulong val_sz    = fd_ulong_min( sz, (ulong)rec->val_sz );
+  if( FD_UNLIKELY( !val_gaddr || !val_sz ) ) return;
+
+  /* Values have no alignment guarantee */
+  uchar const * val  = fd_wksp_laddr_fast( fd_funk_wksp( funk ), val_gaddr );
+  ulong         line = (ulong)val & ~63UL;
+  ulong         end  = (ulong)val + val_sz;
+  for( ; line<end; line+=64UL ) __builtin_prefetch( (void const *)line );
+}
+
 fd_funk_rec_t const *
 fd_funk_rec_query_copy( fd_funk_t *               funk,
                         fd_funk_txn_t const *     txn,
@@ -712,6 +852,20 @@ fd_funk_rec_purify( fd_funk_t * funk ) {
   fd_funk_rec_pool_t * rec_pool = funk->rec_pool;
   ulong rec_max = fd_funk_rec_pool_ele_max( rec_pool );
 
+  /* Retired records are no longer in the map but still look like live
+     records.  Free their values and mark them so they get recycled. */
+
+  ulong retire_cnt = funk->shmem->retire_cnt;
+  uint  retire_idx = funk->shmem->retire_head_idx;
+  for( ulong i=0UL; i<retire_cnt && retire_idx<rec_max; i++ ) {
+    fd_funk_rec_t * rec = rec_pool->ele + retire_idx;
+    retire_idx = rec->next_idx;
+    if( fd_funk_rec_pool_is_in_pool( rec ) ) continue;
+    fd_funk_val_flush( rec, funk->alloc, funk->wksp );
+    rec->flags |= FD_FUNK_REC_FLAG_ERASE;
+  }
+  funk->shmem->retire_cnt = 0UL;
+
   fd_funk_rec_map_reset( rec_map );
   rec_pool->pool->ver_top = fd_funk_rec_pool_idx_null();;
 
@@ -253,6 +253,80 @@ fd_funk_rec_query_try_global( fd_funk_t const *         funk,
                               fd_funk_txn_t const **    txn_out,
                               fd_funk_rec_query_t *     query );
 
+/* fd_funk_rec_key_hash_batch computes hash[i] = fd_funk_rec_key_hash(
+   key+i, seed ) for i in [0,cnt).  Uses AVX-512 when available. */
+
+void
+fd_funk_rec_key_hash_batch( fd_funk_rec_key_t const * key,
+                            ulong                     cnt,
+                            ulong                     seed,
+                            ulong *                   hash );
+
+/* fd_funk_rec_query_batch does fd_funk_rec_query_try_global for cnt
+   (txn,key) pairs in one call: rec_out[i] is set to the record
+   fd_funk_rec_query_try_global( funk, txn[i], key+i, NULL, query+i )
+   would return for the same funk state (NULL if not found or erased).
+   txn==NULL queries all the keys at the last published transaction.
+   Returns the number of records found.
+
+   Keys are processed in groups of FD_FUNK_REC_QUERY_BATCH_MAX.  Within
+   a group, the keys are hashed together (8 at a time with AVX-512),
+   then the hash chain headers and chain heads of all the keys are
+   prefetched before any chain is walked, so the cache misses of the
+   group overlap.  This is much faster than querying one key at a time
+   for keys that are not in cache (e.g. the accounts of a batch of
+   transactions on a large funk).
+
+   Each query[i] is valid as for fd_funk_rec_query_try_global, i.e. the
+   caller should fd_funk_rec_query_test( query+i ) after reading
+   rec_out[i] if records can be modified concurrently. */
+
+#define FD_FUNK_REC_QUERY_BATCH_MAX (32UL)
+
+ulong
+fd_funk_rec_query_batch( fd_funk_t const *             funk,
+                         fd_funk_txn_t const * const * txn,
+                         fd_funk_rec_key_t const *     key,
+                         ulong                         cnt,
+                         fd_funk_rec_t const **        rec_out,
+                         fd_funk_rec_query_t *         query );
+
+/* fd_funk_rec_prefetch_{chain,ele,val} are the stages of a software
+   pipeline that makes a later query of key (and the record value it
+   finds) hit in cache.  Each stage issues prefetches that depend on
+   the lines brought in by the previous one, so a caller looking up
+   many keys should run each stage over all the keys before starting
+   the next one:
+
+     for( i ) hash[i] = fd_funk_rec_prefetch_chain( funk, key+i );
+     for( i ) fd_funk_rec_prefetch_ele( funk, hash[i] );
+     for( i ) fd_funk_rec_prefetch_val( funk, hash[i], sz );
+     ... fd_funk_rec_query_try[_global] for each key ...
+
+   fd_funk_rec_prefetch_chain returns the hash of key and prefetches
+   the hash chain header key maps to.  fd_funk_rec_prefetch_ele
+   prefetches the newest record on that chain, which is the record a
+   query for key returns at typical chain lengths.
+   fd_funk_rec_prefetch_val prefetches up to the first sz bytes of the
+   value of that record if its hash matches.
+
+   These are hints: they never block, do not validate what they read
+   and do not modify funk, so they are safe to call concurrently with
+   any other funk operation. */
+
+ulong
+fd_funk_rec_prefetch_chain( fd_funk_t const *         funk,
+                            fd_funk_rec_key_t const * key );
+
+void
+fd_funk_rec_prefetch_ele( fd_funk_t const * funk,
+                          ulong             hash );
+
+void
+fd_funk_rec_prefetch_val( fd_funk_t const * funk,
+                          ulong             hash,
+                          ulong             sz );
+
 /* fd_funk_rec_query_copy queries the in-preparation transaction pointed to
    by txn for the record whose key matches the key pointed to by key.
 
@@ -450,6 +450,74 @@ fd_funk_txn_cancel_all( fd_funk_t *     funk,
   return fd_funk_txn_cancel_children( funk, NULL, verbose );
 }
 
+/* fd_funk_txn_retire puts rec, a record that was just removed from the
+   record map, on the funk's retire list.  Its value and pool slot are
+   recycled by fd_funk_txn_reclaim once no reader can still
+   be looking at it. */
+
+static void
+fd_funk_txn_retire( fd_funk_t *     funk,
+                    fd_funk_rec_t * rec ) {
+  fd_funk_shmem_t * shmem   = funk->shmem;
+  uint              rec_idx = (uint)( rec - funk->rec_pool->ele );
+
+  rec->txn_cidx = (uint)shmem->retire_epoch; /* Stash the retire epoch */
+  rec->prev_idx = FD_FUNK_REC_IDX_NULL;
+  rec->next_idx = FD_FUNK_REC_IDX_NULL;
+  if( !shmem->retire_cnt ) shmem->retire_head_idx = rec_idx;
+  else                     funk->rec_pool->ele[ shmem->retire_tail_idx ].next_idx = rec_idx;
+  shmem->retire_tail_idx = rec_idx;
+  shmem->retire_cnt++;
+}
+
+ulong
+fd_funk_txn_reclaim( fd_funk_t * funk ) {
+  fd_funk_shmem_t *    shmem    = funk->shmem;
+  fd_funk_rec_pool_t * rec_pool = funk->rec_pool;
+
+  ulong retire_cnt = shmem->retire_cnt;
+  if( FD_LIKELY( !retire_cnt ) ) return 0UL;
+
+  /* Start a new epoch.  Records retired before this were already
+     removed from the map, so a reader that enters from now on can't
+     find them.  The xchg fences the epoch advance against the reader
+     slot scan below (see fd_funk_reader_enter). */
+
+  ulong epoch = shmem->retire_epoch;
+  (void)FD_ATOMIC_XCHG( &shmem->retire_epoch, epoch+1UL );
+
+  ulong safe = epoch+1UL; /* Records retired in epochs before safe can be freed */
+  for( ulong reader_idx=0UL; reader_idx<FD_FUNK_READER_MAX; reader_idx++ ) {
+    ulong reader_epoch = FD_VOLATILE_CONST( shmem->reader_epoch[ reader_idx ] );
+    if( !(reader_epoch & 1UL) ) continue; /* Only readers inside a region */
+    safe = fd_ulong_min( safe, reader_epoch>>1 );
+
+    /* A reader that doesn't leave only holds back reclamation, report
+       it once when it crosses the threshold (each call gets here with
+       a new epoch as long as there is something to reclaim) */
+
+    if( FD_UNLIKELY( epoch-(reader_epoch>>1)==FD_FUNK_READER_STUCK_EPOCH_CNT ) )
+      FD_LOG_WARNING(( "funk reader %lu has been inside a region for %lu epochs, %lu retired records are held back",
+                       reader_idx, FD_FUNK_READER_STUCK_EPOCH_CNT, retire_cnt ));
+  }
+
+  ulong free_cnt = 0UL;
+  uint  rec_idx  = shmem->retire_head_idx;
+  while( free_cnt<retire_cnt ) {
+    fd_funk_rec_t * rec = rec_pool->ele + rec_idx;
+    if( (int)( (uint)safe - rec->txn_cidx )<=0 ) break;
+    uint next_idx = rec->next_idx;
+    fd_funk_val_flush( rec, funk->alloc, funk->wksp );
+    rec->txn_cidx = fd_funk_txn_cidx( FD_FUNK_TXN_IDX_NULL );
+    fd_funk_rec_pool_release( rec_pool, rec, 1 );
+    free_cnt++;
+    rec_idx = next_idx;
+  }
+  shmem->retire_head_idx = rec_idx;
+  shmem->retire_cnt      = retire_cnt - free_cnt;
+  return free_cnt;
+}
+
 /* fd_funk_txn_update applies the record updates in transaction txn_idx
    to another transaction or the parent transaction.  Callers have
    already validated our input arguments.
@@ -460,10 +528,12 @@ fd_funk_txn_cancel_all( fd_funk_t *     funk,
    is the record list the last published transaction or txn_idx's
    in-prep parent transaction.
 
-   On exit, the head/tail of the updated records is at
-   *_dst_rec_head_idx / *_dst_rec_tail_idx.  As before, all transactions
-   on this list will have transaction id dst_xid and vice versa.
-   Transaction txn_idx will have an _empty_ record list.
+   At most batch_max records are moved (the oldest ones).  On exit, the
+   head/tail of the updated records is at *_dst_rec_head_idx /
+   *_dst_rec_tail_idx.  As before, all transactions on this list will
+   have transaction id dst_xid and vice versa.  Transaction txn_idx
+   holds the records that were not moved yet (an _empty_ record list if
+   all were).  Returns the number of records moved.
 
    Updates in the transaction txn_idx are processed from oldest to
    youngest.  If an update erases an existing record in dest, the record
@@ -475,17 +545,22 @@ fd_funk_txn_cancel_all( fd_funk_t *     funk,
    existing values as youngest without changing the order of existing
    values.  If an update erases a record in an in-prep parent, the
    erasure will be moved into the parent as the youngest without
-   changing the order of existing values. */
+   changing the order of existing values.
 
-static void
-fd_funk_txn_update( fd_funk_t *                  funk,
-                       uint *                   _dst_rec_head_idx, /* Pointer to the dst list head */
-                       uint *                   _dst_rec_tail_idx, /* Pointer to the dst list tail */
-                       ulong                     dst_txn_idx,       /* Transaction index of the merge destination */
-                       fd_funk_txn_xid_t const * dst_xid,        /* dst xid */
-                       ulong                     txn_idx ) {        /* Transaction index of the records to merge */
-  fd_wksp_t *          wksp     = funk->wksp;
-  fd_alloc_t *         alloc    = funk->alloc;
+   Each record is moved with one map transaction on its chain, so
+   concurrent readers never block on this and readers that validate
+   their query with fd_funk_rec_query_test see either the old or the
+   new version of a record.  Replaced destination records are retired
+   rather than freed (see fd_funk_txn_retire). */
+
+static ulong
+fd_funk_txn_update( fd_funk_t *               funk,
+                    uint *                    _dst_rec_head_idx, /* Pointer to the dst list head */
+                    uint *                    _dst_rec_tail_idx, /* Pointer to the dst list tail */
+                    ulong                     dst_txn_idx,       /* Transaction index of the merge destination */
+                    fd_funk_txn_xid_t const * dst_xid,           /* dst xid */
+                    ulong                     txn_idx,           /* Transaction index of the records to merge */
+                    ulong                     batch_max ) {      /* Max number of records to merge */
   fd_funk_rec_map_t *  rec_map  = funk->rec_map;
   fd_funk_rec_pool_t * rec_pool = funk->rec_pool;
   fd_funk_txn_pool_t * txn_pool = funk->txn_pool;
@@ -497,21 +572,33 @@ fd_funk_txn_update( fd_funk_t *                  funk,
     fd_begin_crit(funk);
   }
 
+  uchar map_txn_mem[ fd_funk_rec_map_txn_footprint( 1UL ) ] __attribute__((aligned(alignof(fd_funk_rec_map_txn_t))));
+
   fd_funk_txn_t * txn = &txn_pool->ele[ txn_idx ];
-  uint rec_idx = txn->rec_head_idx;
-  while( !fd_funk_rec_idx_is_null( rec_idx ) ) {
+  uint  rec_idx    = txn->rec_head_idx;
+  ulong update_cnt = 0UL;
+  while( !fd_funk_rec_idx_is_null( rec_idx ) && update_cnt<batch_max ) {
     fd_funk_rec_t * rec = &rec_pool->ele[ rec_idx ];
     uint next_rec_idx = rec->next_idx;
 
-    /* See if (dst_xid,key) already exists.  */
+    /* Replace the (dst_xid,key) version (if any) with rec in a single
+       map transaction.  All versions of a key live on the same hash
+       chain, so this only locks one chain, and a concurrent reader
+       either sees the old version or rec but never neither. */
+
+    fd_funk_rec_map_txn_t * map_txn = fd_funk_rec_map_txn_init( map_txn_mem, rec_map, 1UL );
+    fd_funk_rec_map_txn_add( map_txn, &rec->pair, 1 );
+    int err = fd_funk_rec_map_txn_try( map_txn, FD_MAP_FLAG_BLOCKING );
+    if( FD_UNLIKELY( err!=FD_MAP_SUCCESS ) ) FD_LOG_CRIT(( "fd_funk_rec_map_txn_try returned err %d", err ));
+
+    /* See if (dst_xid,key) already exists.  rec is still tagged with
+       the source xid so this can't match it. */
+
     fd_funk_xid_key_pair_t pair[1];
     fd_funk_xid_key_pair_init( pair, dst_xid, rec->pair.key );
-    for(;;) {
-      fd_funk_rec_map_query_t rec_query[1];
-      int err = fd_funk_rec_map_remove( rec_map, pair, NULL, rec_query, FD_MAP_FLAG_BLOCKING );
-      if( FD_UNLIKELY( err == FD_MAP_ERR_AGAIN ) ) continue;
-      if( err == FD_MAP_ERR_KEY ) break;
-      if( FD_UNLIKELY( err != FD_MAP_SUCCESS ) ) FD_LOG_CRIT(( "map corruption" ));
+    fd_funk_rec_map_query_t rec_query[1];
+    err = fd_funk_rec_map_txn_remove( rec_map, pair, NULL, rec_query, FD_MAP_FLAG_BLOCKING );
+    if( err==FD_MAP_SUCCESS ) {
 
       /* Remove from the transaction */
       fd_funk_rec_t * rec2 = fd_funk_rec_map_query_ele( rec_query );
@@ -527,11 +614,10 @@ fd_funk_txn_update( fd_funk_t *                  funk,
       } else {
         rec_pool->ele[ next_idx ].prev_idx = prev_idx;
       }
-      /* Clean up value */
-      fd_funk_val_flush( rec2, alloc, wksp );
-      rec2->txn_cidx = fd_funk_txn_cidx( FD_FUNK_TXN_IDX_NULL );
-      fd_funk_rec_pool_release( rec_pool, rec2, 1 );
-      break;
+      /* Readers might still hold it, defer the clean up */
+      fd_funk_txn_retire( funk, rec2 );
+    } else if( FD_UNLIKELY( err!=FD_MAP_ERR_KEY ) ) {
+      FD_LOG_CRIT(( "map corruption" ));
     }
 
     /* Add the new record to the transaction. We can update the xid in
@@ -544,6 +630,10 @@ fd_funk_txn_update( fd_funk_t *                  funk,
     rec->pair.xid[0] = *dst_xid;
     rec->txn_cidx = fd_funk_txn_cidx( dst_txn_idx );
 
+    err = fd_funk_rec_map_txn_test( map_txn );
+    if( FD_UNLIKELY( err!=FD_MAP_SUCCESS ) ) FD_LOG_CRIT(( "fd_funk_rec_map_txn_test returned err %d", err ));
+    fd_funk_rec_map_txn_fini( map_txn );
+
     if( fd_funk_rec_idx_is_null( *_dst_rec_head_idx ) ) {
       *_dst_rec_head_idx = rec_idx;
       rec->prev_idx = FD_FUNK_REC_IDX_NULL;
@@ -555,14 +645,18 @@ fd_funk_txn_update( fd_funk_t *                  funk,
     rec->next_idx = FD_FUNK_REC_IDX_NULL;
 
     rec_idx = next_rec_idx;
+    update_cnt++;
   }
 
-  txn_pool->ele[ txn_idx ].rec_head_idx = FD_FUNK_REC_IDX_NULL;
-  txn_pool->ele[ txn_idx ].rec_tail_idx = FD_FUNK_REC_IDX_NULL;
+  txn->rec_head_idx = rec_idx;
+  if( fd_funk_rec_idx_is_null( rec_idx ) ) txn->rec_tail_idx = FD_FUNK_REC_IDX_NULL;
+  else                                     rec_pool->ele[ rec_idx ].prev_idx = FD_FUNK_REC_IDX_NULL;
 
   if (critical) {
     fd_end_crit(funk);
   }
+
+  return update_cnt;
 }
 
 /* fd_funk_txn_publish_funk_child publishes a transaction that is known
@@ -578,7 +672,7 @@ fd_funk_txn_publish_funk_child( fd_funk_t * const funk,
 
   /* Apply the updates in txn to the last published transactions */
 
-  fd_funk_txn_update( funk, &funk->shmem->rec_head_idx, &funk->shmem->rec_tail_idx, FD_FUNK_TXN_IDX_NULL, fd_funk_root( funk ), txn_idx );
+  fd_funk_txn_update( funk, &funk->shmem->rec_head_idx, &funk->shmem->rec_tail_idx, FD_FUNK_TXN_IDX_NULL, fd_funk_root( funk ), txn_idx, ULONG_MAX );
 
   /* Cancel all competing transaction histories */
 
@@ -676,6 +770,8 @@ fd_funk_txn_publish( fd_funk_t *     funk,
     publish_stack_idx = fd_funk_txn_idx( funk->txn_pool->ele[ txn_idx ].stack_cidx );
   }
 
+  fd_funk_txn_reclaim( funk );
+
   return publish_cnt;
 }
 
@@ -706,13 +802,13 @@ fd_funk_txn_publish_into_parent( fd_funk_t *     funk,
   ulong parent_idx = fd_funk_txn_idx( txn->parent_cidx );
   if( fd_funk_txn_idx_is_null( parent_idx ) ) {
     /* Publish to root */
-    fd_funk_txn_update( funk, &funk->shmem->rec_head_idx, &funk->shmem->rec_tail_idx, FD_FUNK_TXN_IDX_NULL, fd_funk_root( funk ), txn_idx );
+    fd_funk_txn_update( funk, &funk->shmem->rec_head_idx, &funk->shmem->rec_tail_idx, FD_FUNK_TXN_IDX_NULL, fd_funk_root( funk ), txn_idx, ULONG_MAX );
     /* Inherit the children */
     funk->shmem->child_head_cidx = txn->child_head_cidx;
     funk->shmem->child_tail_cidx = txn->child_tail_cidx;
   } else {
     fd_funk_txn_t * parent_txn = &txn_pool->ele[ parent_idx ];
-    fd_funk_txn_update( funk, &parent_txn->rec_head_idx, &parent_txn->rec_tail_idx, parent_idx, &parent_txn->xid, txn_idx );
+    fd_funk_txn_update( funk, &parent_txn->rec_head_idx, &parent_txn->rec_tail_idx, parent_idx, &parent_txn->xid, txn_idx, ULONG_MAX );
     /* Inherit the children */
     parent_txn->child_head_cidx = txn->child_head_cidx;
     parent_txn->child_tail_cidx = txn->child_tail_cidx;
@@ -730,9 +826,78 @@ fd_funk_txn_publish_into_parent( fd_funk_t *     funk,
     fd_funk_txn_pool_release( txn_pool, txn, 1 );
   }
 
+  fd_funk_txn_reclaim( funk );
+
   return FD_FUNK_SUCCESS;
 }
 
+int
+fd_funk_txn_publish_step( fd_funk_t *     funk,
+                          fd_funk_txn_t * txn,
+                          ulong           batch_max,
+                          int             verbose ) {
+#ifdef FD_FUNK_HANDHOLDING
+  if( FD_UNLIKELY( !funk ) ) {
+    if( FD_UNLIKELY( verbose ) ) FD_LOG_WARNING(( "NULL funk" ));
+    return FD_FUNK_ERR_INVAL;
+  }
+  if( FD_UNLIKELY( !fd_funk_txn_valid( funk, txn ) ) ) {
+    if( FD_UNLIKELY( verbose ) ) FD_LOG_WARNING(( "bad txn" ));
+    return FD_FUNK_ERR_INVAL;
+  }
+#else
+  (void)verbose;
+#endif
+
+  fd_funk_txn_pool_t * txn_pool = funk->txn_pool;
+  ulong txn_idx = (ulong)(txn - txn_pool->ele);
+
+  /* Find the oldest unpublished ancestor of txn (the publish stack of
+     fd_funk_txn_publish is not persisted between steps, chains are
+     short in practice). */
+
+  ulong pub_idx = txn_idx;
+  for(;;) {
+    ulong parent_idx = fd_funk_txn_idx( txn_pool->ele[ pub_idx ].parent_cidx );
+    if( FD_LIKELY( fd_funk_txn_idx_is_null( parent_idx ) ) ) break;
+    pub_idx = parent_idx;
+  }
+
+  /* Cancel the competing histories of that ancestor before any of its
+     records move.  They are based on the last published transaction
+     too, so they would otherwise see the records migrating into it
+     step by step.  This only happens on the first step of publishing
+     each transaction, later steps find it without siblings. */
+
+  fd_funk_txn_t * pub        = &txn_pool->ele[ pub_idx ];
+  ulong           oldest_idx = fd_funk_txn_oldest_sibling( funk, pub_idx );
+  if( FD_UNLIKELY( (oldest_idx!=pub_idx) | !fd_funk_txn_idx_is_null( fd_funk_txn_idx( pub->sibling_next_cidx ) ) ) ) {
+    fd_funk_txn_start_write( funk );
+    fd_funk_txn_cancel_sibling_list( funk, funk->shmem->cycle_tag++, oldest_idx, pub_idx );
+    fd_funk_txn_end_write( funk );
+  }
+
+  /* Move a batch of its records into the last published transaction.
+     This is the O(records) part of the publish and does not need the
+     transaction write lock. */
+
+  fd_funk_txn_update( funk, &funk->shmem->rec_head_idx, &funk->shmem->rec_tail_idx, FD_FUNK_TXN_IDX_NULL, fd_funk_root( funk ),
+                      pub_idx, fd_ulong_max( batch_max, 1UL ) );
+  fd_funk_txn_reclaim( funk );
+  if( !fd_funk_rec_idx_is_null( pub->rec_head_idx ) ) return 1;
+
+  /* All its records moved.  Finish publishing it (adopt its children),
+     which only takes time proportional to the number of transactions
+     affected. */
+
+  fd_funk_txn_start_write( funk );
+  fd_funk_txn_publish_funk_child( funk, funk->shmem->cycle_tag++, pub_idx );
+  fd_funk_txn_end_write( funk );
+  fd_funk_txn_reclaim( funk );
+
+  return pub_idx!=txn_idx;
+}
+
 /* Return the first record in a transaction. Returns NULL if the
    transaction has no records yet. */
 
@@ -105,6 +105,11 @@ fd_funk_txn_xid_t fd_funk_generate_xid(void);
    - fd_funk_txn_cancel_siblings
    - fd_funk_txn_cancel_children
 
+   fd_funk_txn_publish_step takes the write lock itself (only to cancel
+   competing histories in the first step and for the brief final step
+   of publishing each transaction) and must not be called with it
+   held.
+
    The following APIs need the read lock:
    - fd_funk_txn_ancestor
    - fd_funk_txn_descendant
@@ -437,8 +442,11 @@ fd_funk_txn_cancel_all( fd_funk_t *     funk,
    O(number of cancelled transactions) time (theoretical minimum),
    reasonably small O(1) space (theoretical minimum), does no allocation
    does no system calls, and produces no garbage to collect (at this
-   layer at least).  That is, we can scalably track forks until we run
-   out of resources allocated to the funk. */
+   layer at least) beyond replaced records that concurrent readers
+   might still be using (see fd_funk_txn_reclaim).  That is, we can
+   scalably track forks until we run out of resources allocated to the
+   funk.  See fd_funk_txn_publish_step for publishing large
+   transactions without stalling concurrent users. */
 
 ulong
 fd_funk_txn_publish( fd_funk_t *     funk,
@@ -455,6 +463,51 @@ fd_funk_txn_publish_into_parent( fd_funk_t *     funk,
                                  fd_funk_txn_t * txn,
                                  int             verbose );
 
+/* fd_funk_txn_publish_step does a bounded amount of the work of
+   fd_funk_txn_publish( funk, txn, verbose ).  Each call moves at most
+   batch_max records of the oldest unpublished ancestor of txn (or of
+   txn itself) into the last published transaction, and once all the
+   records of that transaction were moved, finishes publishing it under
+   the transaction write lock.  Competing histories of a transaction
+   are cancelled (also under the write lock) before any of its records
+   move.  Returns FD_FUNK_SUCCESS (0) once txn itself is published (txn
+   is no longer valid then), 1 if more steps are needed (call again
+   with the same txn) and a negative FD_FUNK_ERR_* code on failure
+   (e.g. NULL funk or bad txn, logs details if verbose).
+
+   Unlike fd_funk_txn_publish under the write lock, the record moves
+   don't stall anyone: the caller can interleave steps with other work
+   (e.g. one step per run loop iteration) and concurrent readers keep
+   querying the funk while records migrate.  During a publish, queries
+   against descendants of txn see the same values as before and
+   queries against the last published transaction see each record
+   either before or after its update (fd_funk_rec_query_test will
+   detect an update in between).  Readers that might hold records of
+   the last published transaction across a step should bracket that
+   with fd_funk_reader_{enter,leave} so the records replaced by the
+   publish are not recycled under them.
+
+   The caller should be the only one changing the transaction tree
+   while the publish is in progress and the transactions being
+   published should not get any more record updates (e.g. they are
+   frozen). */
+
+int
+fd_funk_txn_publish_step( fd_funk_t *     funk,
+                          fd_funk_txn_t * txn,
+                          ulong           batch_max,
+                          int             verbose );
+
+/* fd_funk_txn_reclaim frees the records retired by previous publishes
+   that no reader can be using anymore (see
+   fd_funk_reader_enter).  Publishes do this automatically; this is
+   useful to release records that were held back by a slow reader
+   without waiting for the next publish.  Should be called by the
+   thread doing the publishes.  Returns the number of records freed. */
+
+ulong
+fd_funk_txn_reclaim( fd_funk_t * funk );
+
 /* fd_funk_txn_all_iter_t iterators over all funk transaction objects.
    Usage is:
 
@@ -0,0 +1,384 @@
+/* test_funk_publish_concur publishes large transactions while reader
+   threads hammer the funk and records how long the readers stall.  It
+   runs the same workload with a blocking fd_funk_txn_publish under the
+   transaction write lock and with fd_funk_txn_publish_step and checks
+   that readers always see consistent values, including while records
+   they hold are being replaced (deferred reclamation). */
+
+#include "fd_funk.h"
+
+#if FD_HAS_HOSTED
+
+#include <pthread.h>
+
+#define WKSP_TAG   (1234UL)
+#define KEY_CNT    (1UL<<16)
+#define REC_MAX    (4UL*KEY_CNT)
+#define READER_CNT (2UL)
+#define ROUND_CNT  (8UL)
+#define BATCH_MAX  (1024UL)
+#define HIST_CNT   (40UL)
+
+/* Record values are { key, gen } so readers can tell a value that was
+   recycled for another record apart from a stale one */
+
+struct val {
+  ulong key;
+  ulong gen;
+};
+
+typedef struct val val_t;
+
+static fd_funk_t *       funk;
+static volatile int      done;
+static volatile ulong    round;     /* Records updated in round r have gen r */
+static fd_funk_txn_xid_t child_xid; /* Descendant of the txn being published, valid while round is odd */
+
+struct reader {
+  ulong idx;
+  ulong hist[ HIST_CNT ]; /* Reader op latencies, log2 ns buckets */
+  ulong max_ns;
+  ulong op_cnt;
+};
+
+typedef struct reader reader_t;
+
+static reader_t readers[ READER_CNT ];
+
+static fd_funk_rec_key_t
+rec_key( ulong i ) {
+  fd_funk_rec_key_t key = {0};
+  key.ul[ 0 ] = i;
+  key.ul[ 1 ] = fd_ulong_hash( i );
+  return key;
+}
+
+/* updated returns 1 if key i is updated in round r */
+
+static inline int
+updated( ulong i,
+         ulong r ) {
+  return (int)((fd_ulong_hash( i ^ (r<<32) ) & 3UL)!=0UL);
+}
+
+/* expected_gen returns the gen of key i as of round r.  Keys are
+   updated in odd rounds starting at 3, before that all keys have gen 0
+   except key 0 (gen 1). */
+
+static ulong
+expected_gen( ulong i,
+              ulong r ) {
+  for( ; r>=3UL; r-- ) if( (r & 1UL) && updated( i, r ) ) return r;
+  return (ulong)!i;
+}
+
+static void
+upsert( fd_funk_txn_t * txn,
+        ulong           i,
+        ulong           gen ) {
+  fd_funk_rec_key_t     key = rec_key( i );
+  fd_funk_rec_prepare_t prepare[1];
+  fd_funk_rec_t * rec = fd_funk_rec_prepare( funk, txn, &key, prepare, NULL );
+  FD_TEST( rec );
+  val_t * val = fd_funk_val_truncate( rec, fd_funk_alloc( funk ), fd_funk_wksp( funk ), alignof(val_t), sizeof(val_t), NULL );
+  FD_TEST( val );
+  val->key = i;
+  val->gen = gen;
+  fd_funk_rec_publish( funk, prepare );
+}
+
+/* read_val queries key i in txn and returns its gen */
+
+static ulong
+read_val( fd_funk_txn_t const * txn,
+          ulong                 i ) {
+  fd_funk_rec_key_t key = rec_key( i );
+  for(;;) {
+    fd_funk_rec_query_t   query[1];
+    fd_funk_rec_t const * rec = fd_funk_rec_query_try_global( funk, txn, &key, NULL, query );
+    if( FD_UNLIKELY( !rec ) ) {
+      if( fd_funk_rec_query_test( query ) ) continue;
+      FD_LOG_ERR(( "key %lu not found", i ));
+    }
+    val_t const * val = fd_funk_val_const( rec, fd_funk_wksp( funk ) );
+    ulong vkey = val ? FD_VOLATILE_CONST( val->key ) : ULONG_MAX;
+    ulong vgen = val ? FD_VOLATILE_CONST( val->gen ) : ULONG_MAX;
+    if( FD_UNLIKELY( fd_funk_rec_query_test( query ) ) ) continue;
+    /* Even when the record changed after the query, a retired value
+       must still be intact */
+    if( FD_UNLIKELY( vkey!=i ) ) FD_LOG_ERR(( "key %lu: value of key %lu", i, vkey ));
+    return vgen;
+  }
+}
+
+static void *
+reader_main( void * _reader ) {
+  reader_t * reader = (reader_t *)_reader;
+  fd_rng_t   _rng[1];
+  fd_rng_t * rng = fd_rng_join( fd_rng_new( _rng, (uint)reader->idx, 0UL ) );
+
+  while( !FD_VOLATILE_CONST( done ) ) {
+    ulong i = fd_rng_ulong_roll( rng, KEY_CNT );
+
+    long dt = -fd_log_wallclock();
+    fd_funk_reader_enter( funk, reader->idx );
+
+    /* Query through the descendant of the txn being published like an
+       exec tile would ... */
+
+    ulong r = FD_VOLATILE_CONST( round );
+    fd_funk_txn_start_read( funk );
+    if( (r & 1UL) && FD_VOLATILE_CONST( round )==r ) {
+      fd_funk_txn_t const * child = fd_funk_txn_query( &child_xid, funk->txn_map );
+      FD_TEST( child );
+      ulong gen = read_val( child, i );
+      ulong exp = expected_gen( i, r );
+      if( FD_UNLIKELY( gen!=exp ) ) FD_LOG_ERR(( "round %lu key %lu: gen %lu, expected %lu", r, i, gen, exp ));
+    }
+    fd_funk_txn_end_read( funk );
+
+    /* ... and through the last published transaction, which sees each
+       record either before or after the publish */
+
+    ulong gen = read_val( NULL, i );
+    ulong r2  = FD_VOLATILE_CONST( round );
+    if( FD_UNLIKELY( gen<expected_gen( i, r-1UL ) || gen>r2 ) ) FD_LOG_ERR(( "rounds [%lu,%lu] key %lu: unexpected gen %lu", r, r2, i, gen ));
+
+    fd_funk_reader_leave( funk, reader->idx );
+    dt += fd_log_wallclock();
+
+    reader->hist[ fd_ulong_min( (ulong)fd_ulong_find_msb( (ulong)dt|1UL ), HIST_CNT-1UL ) ]++;
+    reader->max_ns = fd_ulong_max( reader->max_ns, (ulong)dt );
+    reader->op_cnt++;
+  }
+
+  fd_rng_delete( fd_rng_leave( rng ) );
+  return NULL;
+}
+
+/* run_rounds does ROUND_CNT rounds of: prepare a txn updating most of
+   the keys and a child of it, publish the txn (while readers query the
+   child and the root), then cancel the child.  Rounds are numbered so
+   that round is odd while a publish is in progress. */
+
+static void
+run_rounds( int incremental ) {
+  for( ulong k=0UL; k<ROUND_CNT; k++ ) {
+    ulong r = FD_VOLATILE_CONST( round ) + 1UL;
+
+    fd_funk_txn_xid_t xid = { .ul = { r, 1UL } };
+    fd_funk_txn_start_write( funk );
+    fd_funk_txn_t * txn = fd_funk_txn_prepare( funk, NULL, &xid, 1 );
+    FD_TEST( txn );
+    fd_funk_txn_end_write( funk );
+    for( ulong i=0UL; i<KEY_CNT; i++ ) if( updated( i, r ) ) upsert( txn, i, r );
+
+    child_xid = (fd_funk_txn_xid_t){ .ul = { r, 2UL } };
+    fd_funk_txn_start_write( funk );
+    FD_TEST( fd_funk_txn_prepare( funk, txn, &child_xid, 1 ) );
+    fd_funk_txn_end_write( funk );
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( round ) = r;
+    FD_COMPILER_MFENCE();
+
+    long dt = -fd_log_wallclock();
+    ulong step_cnt = 0UL;
+    if( incremental ) {
+      for(;;) {
+        int err = fd_funk_txn_publish_step( funk, txn, BATCH_MAX, 1 );
+        step_cnt++;
+        if( !err ) break;
+        FD_TEST( err>0 );
+        FD_YIELD(); /* Other work of the publishing thread would go here */
+      }
+    } else {
+      fd_funk_txn_start_write( funk );
+      FD_TEST( fd_funk_txn_publish( funk, txn, 1 )==1UL );
+      fd_funk_txn_end_write( funk );
+      step_cnt++;
+    }
+    dt += fd_log_wallclock();
+    FD_LOG_INFO(( "round %lu published in %.3f ms (%lu steps, %lu retired)", r, (double)dt/1e6, step_cnt, fd_funk_retire_cnt( funk ) ));
+    FD_TEST( fd_funk_txn_xid_eq( fd_funk_last_publish( funk ), &xid ) );
+
+    FD_COMPILER_MFENCE();
+    FD_VOLATILE( round ) = r+1UL;
+    FD_COMPILER_MFENCE();
+
+    fd_funk_txn_start_write( funk );
+    FD_TEST( fd_funk_txn_cancel_all( funk, 1 )==1UL );
+    fd_funk_txn_end_write( funk );
+  }
+}
+
+static void
+report( char const * mode ) {
+  ulong hist[ HIST_CNT ] = {0};
+  ulong op_cnt = 0UL;
+  ulong max_ns = 0UL;
+  for( ulong j=0UL; j<READER_CNT; j++ ) {
+    for( ulong b=0UL; b<HIST_CNT; b++ ) hist[ b ] += readers[ j ].hist[ b ];
+    op_cnt += readers[ j ].op_cnt;
+    max_ns  = fd_ulong_max( max_ns, readers[ j ].max_ns );
+  }
+  FD_TEST( op_cnt );
+
+  ulong p50 = 0UL; ulong p99 = 0UL; ulong p999 = 0UL;
+  ulong cum = 0UL;
+  for( ulong b=0UL; b<HIST_CNT; b++ ) {
+    cum += hist[ b ];
+    if( !p50  && 2UL   *cum>=op_cnt       ) p50  = 2UL<<b;
+    if( !p99  && 100UL *cum>=99UL  *op_cnt ) p99  = 2UL<<b;
+    if( !p999 && 1000UL*cum>=999UL *op_cnt ) p999 = 2UL<<b;
+  }
+  FD_LOG_NOTICE(( "%-11s reader ops %9lu  p50 <%8lu ns  p99 <%8lu ns  p99.9 <%8lu ns  max %9lu ns",
+                  mode, op_cnt, p50, p99, p999, max_ns ));
+  for( ulong b=0UL; b<HIST_CNT; b++ ) {
+    if( hist[ b ] ) FD_LOG_INFO(( "  [%9lu,%9lu) ns: %lu", 1UL<<b, 2UL<<b, hist[ b ] ));
+  }
+}
+
+static void
+run( int incremental ) {
+  fd_memset( readers, 0, sizeof(readers) );
+  FD_VOLATILE( done ) = 0;
+  pthread_t thread[ READER_CNT ];
+  for( ulong j=0UL; j<READER_CNT; j++ ) {
+    readers[ j ].idx = 1UL+j;
+    fd_funk_reader_init( funk, readers[ j ].idx );
+    FD_TEST( !pthread_create( thread+j, NULL, reader_main, readers+j ) );
+  }
+  run_rounds( incremental );
+  FD_VOLATILE( done ) = 1;
+  for( ulong j=0UL; j<READER_CNT; j++ ) FD_TEST( !pthread_join( thread[ j ], NULL ) );
+
+  report( incremental ? "incremental" : "blocking" );
+
+  /* With the readers gone, everything retired can be reclaimed */
+
+  fd_funk_txn_reclaim( funk );
+  FD_TEST( !fd_funk_retire_cnt( funk ) );
+  static fd_funk_rec_t * free_rec[ REC_MAX ];
+  ulong free_cnt = 0UL;
+  while( !fd_funk_rec_pool_is_empty( funk->rec_pool ) ) free_rec[ free_cnt++ ] = fd_funk_rec_pool_acquire( funk->rec_pool, NULL, 1, NULL );
+  FD_TEST( free_cnt==fd_funk_rec_max( funk )-KEY_CNT );
+  while( free_cnt ) FD_TEST( !fd_funk_rec_pool_release( funk->rec_pool, free_rec[ --free_cnt ], 1 ) );
+  FD_TEST( !fd_funk_verify( funk ) );
+}
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+
+  char const * _page_sz = fd_env_strip_cmdline_cstr ( &argc, &argv, "--page-sz",  NULL,      "gigantic" );
+  ulong        page_cnt = fd_env_strip_cmdline_ulong( &argc, &argv, "--page-cnt", NULL,             1UL );
+  ulong        near_cpu = fd_env_strip_cmdline_ulong( &argc, &argv, "--near-cpu", NULL, fd_log_cpu_id() );
+
+  fd_wksp_t * wksp = fd_wksp_new_anonymous( fd_cstr_to_shmem_page_sz( _page_sz ), page_cnt, near_cpu, "wksp", 0UL );
+  FD_TEST( wksp );
+
+  ulong txn_max = 4UL;
+  ulong rec_max = REC_MAX;
+  void * shfunk = fd_funk_new( fd_wksp_alloc_laddr( wksp, fd_funk_align(), fd_funk_footprint( txn_max, rec_max ), WKSP_TAG ),
+                               WKSP_TAG, 5678UL, txn_max, rec_max );
+  fd_funk_t funk_[1];
+  funk = fd_funk_join( funk_, shfunk );
+  FD_TEST( funk );
+  for( ulong i=0UL; i<KEY_CNT; i++ ) upsert( NULL, i, 0UL );
+
+  /* Reclamation waits for readers that entered before a retire */
+
+  fd_funk_txn_xid_t xid = { .ul = { 1UL, 1UL } };
+  fd_funk_txn_t * txn = fd_funk_txn_prepare( funk, NULL, &xid, 1 );
+  FD_TEST( txn );
+  upsert( txn, 0UL, 1UL );
+  fd_funk_rec_query_t   query[1];
+  fd_funk_rec_key_t     key = rec_key( 0UL );
+  ulong reader_idx = 0UL;
+  fd_funk_reader_init( funk, reader_idx );
+  fd_funk_reader_enter( funk, reader_idx );
+  fd_funk_rec_t const * old = fd_funk_rec_query_try( funk, NULL, &key, query );
+  FD_TEST( old );
+  FD_TEST( fd_funk_txn_publish( funk, txn, 1 )==1UL );
+  FD_TEST( fd_funk_retire_cnt( funk )==1UL );
+  FD_TEST( fd_funk_rec_query_test( query ) ); /* The reader can tell the record changed ... */
+  FD_TEST( ((val_t const *)fd_funk_val_const( old, fd_funk_wksp( funk ) ))->gen==0UL ); /* ... but it is still intact */
+  FD_TEST( !fd_funk_txn_reclaim( funk ) );
+  fd_funk_reader_leave( funk, reader_idx );
+  FD_TEST( fd_funk_txn_reclaim( funk )==1UL );
+  FD_TEST( !fd_funk_retire_cnt( funk ) );
+  FD_TEST( read_val( NULL, 0UL )==1UL );
+
+  /* A reader outside a region doesn't hold anything back */
+
+  xid = (fd_funk_txn_xid_t){ .ul = { 2UL, 2UL } };
+  txn = fd_funk_txn_prepare( funk, NULL, &xid, 1 );
+  FD_TEST( txn );
+  upsert( txn, 0UL, 1UL );
+  FD_TEST( fd_funk_txn_publish( funk, txn, 1 )==1UL );
+  FD_TEST( !fd_funk_retire_cnt( funk ) );
+  FD_TEST( read_val( NULL, 0UL )==1UL );
+
+  /* Competing histories are gone before the first record moves */
+
+  xid = (fd_funk_txn_xid_t){ .ul = { 3UL, 1UL } };
+  fd_funk_txn_xid_t fork_xid = { .ul = { 3UL, 2UL } };
+  txn = fd_funk_txn_prepare( funk, NULL, &xid, 1 );
+  FD_TEST( txn );
+  FD_TEST( fd_funk_txn_prepare( funk, NULL, &fork_xid, 1 ) );
+  for( ulong i=0UL; i<3UL; i++ ) upsert( txn, i, 2UL );
+  FD_TEST( fd_funk_txn_publish_step( funk, txn, 1UL, 1 )==1 );
+  FD_TEST( !fd_funk_txn_query( &fork_xid, funk->txn_map ) );
+  FD_TEST( read_val( NULL, 0UL )==2UL && read_val( NULL, 1UL )==0UL );
+  while( fd_funk_txn_publish_step( funk, txn, 1UL, 1 ) ) {}
+  FD_TEST( read_val( NULL, 1UL )==2UL && read_val( NULL, 2UL )==2UL );
+  xid = (fd_funk_txn_xid_t){ .ul = { 4UL, 1UL } }; /* Restore the gens the rounds below expect */
+  txn = fd_funk_txn_prepare( funk, NULL, &xid, 1 );
+  FD_TEST( txn );
+  for( ulong i=0UL; i<3UL; i++ ) upsert( txn, i, (ulong)!i );
+  FD_TEST( fd_funk_txn_publish( funk, txn, 1 )==1UL );
+  FD_TEST( !fd_funk_retire_cnt( funk ) );
+
+  /* A reader that never leaves (e.g. it crashed) only holds back
+     reclamation until its slot is initialized again */
+
+  xid = (fd_funk_txn_xid_t){ .ul = { 5UL, 1UL } };
+  txn = fd_funk_txn_prepare( funk, NULL, &xid, 1 );
+  FD_TEST( txn );
+  upsert( txn, 0UL, 1UL );
+  fd_funk_reader_enter( funk, reader_idx );
+  FD_TEST( fd_funk_txn_publish( funk, txn, 1 )==1UL );
+  FD_TEST( fd_funk_retire_cnt( funk )==1UL );
+  for( ulong i=0UL; i<8UL; i++ ) FD_TEST( !fd_funk_txn_reclaim( funk ) );
+  fd_funk_reader_init( funk, reader_idx );
+  FD_TEST( fd_funk_txn_reclaim( funk )==1UL );
+  FD_TEST( !fd_funk_retire_cnt( funk ) );
+
+  FD_VOLATILE( round ) = 2UL;
+
+  run( 0 );
+  run( 1 );
+
+  fd_funk_leave( funk, NULL );
+  fd_wksp_free_laddr( fd_funk_delete( shfunk ) );
+  fd_wksp_delete_anonymous( wksp );
+
+  FD_LOG_NOTICE(( "pass" ));
+  fd_halt();
+  return 0;
+}
+
+#else
+
+int
+main( int     argc,
+      char ** argv ) {
+  fd_boot( &argc, &argv );
+  FD_LOG_WARNING(( "skip: unit test requires FD_HAS_HOSTED" ));
+  fd_halt();
+  return 0;
+}
+
+#endif
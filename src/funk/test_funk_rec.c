@@ -263,9 +263,15 @@ main( int     argc,
       key_set( tkey, rkey );
 
       fd_funk_txn_t const * ttxn = rxid ? fd_funk_txn_query( txid, txn_map ) : NULL;
+
+      ulong thash = fd_funk_rec_prefetch_chain( tst, tkey );
+      fd_funk_rec_prefetch_ele( tst, thash );
+      fd_funk_rec_prefetch_val( tst, thash, ULONG_MAX );
+
       fd_funk_rec_query_t rec_query[1];
       fd_funk_rec_t const * trec = fd_funk_rec_query_try( tst, ttxn, tkey, rec_query );
       FD_TEST( trec && xid_eq( fd_funk_rec_xid( trec ), rxid ) && key_eq( fd_funk_rec_key( trec ), rkey ) );
+      FD_TEST( trec->map_hash==thash );
       FD_TEST( !fd_funk_rec_query_test( rec_query ) );
 
 #     define TEST_RELATIVE(rel) do {                                             \
@@ -288,6 +294,54 @@ main( int     argc,
 
     FD_TEST( cnt==ref->rec_cnt );
 
+    /* Batched queries of random keys in random txns (or the last
+       published txn) give the same results as one at a time queries.
+       The count straddles batch groups. */
+
+    if( !(iter & 255UL) ) {
+#     define QUERY_CNT (FD_FUNK_REC_QUERY_BATCH_MAX+9UL)
+      fd_funk_txn_t const * qtxn [ QUERY_CNT ];
+      fd_funk_rec_key_t     qkey [ QUERY_CNT ];
+      ulong                 qhash[ QUERY_CNT ];
+      fd_funk_rec_t const * qrec [ QUERY_CNT ];
+      fd_funk_rec_query_t   query[ QUERY_CNT ];
+      for( ulong i=0UL; i<QUERY_CNT; i++ ) {
+        qtxn[ i ] = NULL;
+        ulong idx = fd_rng_ulong_roll( rng, ref->txn_cnt+1UL );
+        for( txn_t * rtxn=ref->txn_map_head; rtxn; rtxn=rtxn->map_next ) {
+          if( !idx-- ) {
+            xid_set( txid, rtxn->xid );
+            qtxn[ i ] = fd_funk_txn_query( txid, txn_map );
+            FD_TEST( qtxn[ i ] );
+            break;
+          }
+        }
+        key_set( qkey+i, fd_rng_ulong_roll( rng, 64UL ) );
+      }
+
+      ulong qseed = tst->rec_map->map->seed;
+      fd_funk_rec_key_hash_batch( qkey, QUERY_CNT, qseed, qhash );
+      for( ulong i=0UL; i<QUERY_CNT; i++ ) FD_TEST( qhash[ i ]==fd_funk_rec_key_hash( qkey+i, qseed ) );
+
+      ulong found_cnt = fd_funk_rec_query_batch( tst, qtxn, qkey, QUERY_CNT, qrec, query );
+      ulong found_exp = 0UL;
+      for( ulong i=0UL; i<QUERY_CNT; i++ ) {
+        fd_funk_rec_query_t   rec_query[1];
+        fd_funk_rec_t const * trec = fd_funk_rec_query_try_global( tst, qtxn[ i ], qkey+i, NULL, rec_query );
+        FD_TEST( qrec[ i ]==trec );
+        FD_TEST( !fd_funk_rec_query_test( query+i ) );
+        found_exp += !!trec;
+      }
+      FD_TEST( found_cnt==found_exp );
+
+      FD_TEST( fd_funk_rec_query_batch( tst, NULL, qkey, QUERY_CNT, qrec, query )<=QUERY_CNT );
+      for( ulong i=0UL; i<QUERY_CNT; i++ ) {
+        fd_funk_rec_query_t rec_query[1];
+        FD_TEST( qrec[ i ]==fd_funk_rec_query_try_global( tst, NULL, qkey+i, NULL, rec_query ) );
+      }
+#     undef QUERY_CNT
+    }
+
     uint r = fd_rng_uint( rng );
 
     uint op = fd_rng_uint_roll( rng, 1U+1U+16U+128U+128U );
@@ -9,10 +9,13 @@
 FD_STATIC_ASSERT( FD_CHUNK_SZ==64UL, unit_test );
 
 #define RX_MAX (128UL) /* Max _reliable_ (arb unreliable) */
+#define BATCH_MAX (64UL) /* Max --batch */
 
 static uchar  fctl_mem[ FD_FCTL_FOOTPRINT( RX_MAX ) ] __attribute__((aligned(FD_FCTL_ALIGN)));
 static char * _fseq[ RX_MAX ];
 
+static fd_frag_meta_t batch_meta[ BATCH_MAX ];
+
 #define FD_CNC_DIAG_IN_BACKP   (0UL)
 #define FD_CNC_DIAG_BACKP_CNT  (1UL)
 
@@ -37,11 +40,13 @@ main( int     argc,
   ulong        tx_idx  = fd_env_strip_cmdline_ulong( &argc, &argv, "--tx-idx", NULL, 0UL                  ); /* (opt) origin */
   uint         seed    = fd_env_strip_cmdline_uint ( &argc, &argv, "--seed",   NULL, (uint)fd_tickcount() ); /* (opt) rng seed */
   int          lazy    = fd_env_strip_cmdline_int  ( &argc, &argv, "--lazy",   NULL, 7                    ); /* (opt) lazyiness */
+  ulong        batch   = fd_env_strip_cmdline_ulong( &argc, &argv, "--batch",  NULL, 1UL                  ); /* (opt) frags per publish */
 
   if( FD_UNLIKELY( !_cnc                         ) ) FD_LOG_ERR(( "--cnc not specified" ));
   if( FD_UNLIKELY( !_mcache                      ) ) FD_LOG_ERR(( "--mcache not specified" ));
   if( FD_UNLIKELY( !_dcache                      ) ) FD_LOG_ERR(( "--dcache not specified" ));
   if( FD_UNLIKELY( tx_idx>=FD_FRAG_META_ORIG_MAX ) ) FD_LOG_ERR(( "--tx-idx too large" ));
+  if( FD_UNLIKELY( !batch || batch>BATCH_MAX     ) ) FD_LOG_ERR(( "--batch should be in [1,%lu]", BATCH_MAX ));
 
   ulong rx_cnt = fd_cstr_tokenize( _fseq, RX_MAX, (char *)_fseqs, ',' ); /* Note: argv isn't const to okay to cast away const */
   if( FD_UNLIKELY( rx_cnt>RX_MAX ) ) FD_LOG_ERR(( "--rx-cnt too large for this unit-test" ));
@@ -150,7 +155,14 @@ main( int     argc,
 
   ulong cr_avail = 0UL;
 
-  FD_LOG_NOTICE(( "Running --tx-idx %lu --init %lu (%s) --lazy %i", tx_idx, seq, _init ? "manual" : "auto", lazy ));
+  FD_LOG_NOTICE(( "Running --tx-idx %lu --init %lu (%s) --lazy %i --batch %lu", tx_idx, seq, _init ? "manual" : "auto", lazy, batch ));
+
+  /* With --batch >1, frags are staged in batch_meta and published
+     batch at a time with fd_mcache_publish_batch.  Staged frags are
+     also published before housekeeping and before waiting for credits
+     (otherwise the consumers could never return them). */
+
+  ulong batch_cnt = 0UL;
 
   ulong async_min = 1UL << lazy;
   ulong async_rem = 1UL; /* Do housekeeping on the first iteration */
@@ -174,6 +186,12 @@ main( int     argc,
     /* Do housekeeping in the background */
     if( FD_UNLIKELY( !async_rem ) ) {
 
+      /* Publish any staged frags */
+      if( FD_UNLIKELY( batch_cnt ) ) {
+        fd_mcache_publish_batch( mcache, depth, batch_meta, batch_cnt );
+        batch_cnt = 0UL;
+      }
+
       /* Send synchronization info */
       fd_mcache_seq_update( sync, seq );
 
@@ -222,6 +240,10 @@ main( int     argc,
 
     /* Check if we are backpressured */
     if( FD_UNLIKELY( !cr_avail ) ) {
+      if( FD_UNLIKELY( batch_cnt ) ) {
+        fd_mcache_publish_batch( mcache, depth, batch_meta, batch_cnt );
+        batch_cnt = 0UL;
+      }
       if( FD_UNLIKELY( !in_backp ) ) {
         FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_IN_BACKP  ] ) = 0UL;
         FD_VOLATILE( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ) = FD_VOLATILE_CONST( cnc_diag[ FD_CNC_DIAG_BACKP_CNT ] ) + 1UL;
@@ -274,7 +296,22 @@ main( int     argc,
 
 #   if PUBLISH_STYLE==0 /* Incompatible with WAIT_STYLE==2 */
 
-    fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tsorig, tspub );
+    if( FD_UNLIKELY( batch>1UL ) ) {
+      fd_frag_meta_t * meta = batch_meta + batch_cnt;
+      meta->seq    =         seq;
+      meta->sig    =         sig;
+      meta->chunk  = (uint  )chunk;
+      meta->sz     = (ushort)sz;
+      meta->ctl    = (ushort)ctl;
+      meta->tsorig = (uint  )tsorig;
+      meta->tspub  = (uint  )tspub;
+      if( FD_UNLIKELY( ++batch_cnt==batch ) ) {
+        fd_mcache_publish_batch( mcache, depth, batch_meta, batch_cnt );
+        batch_cnt = 0UL;
+      }
+    } else {
+      fd_mcache_publish( mcache, depth, seq, sig, chunk, sz, ctl, tsorig, tspub );
+    }
 
 #   elif PUBLISH_STYLE==1 /* Incompatible with WAIT_STYLE==2 */
 
@@ -302,6 +339,8 @@ main( int     argc,
     ctl_som = ctl_eom;
   }
 
+  if( batch_cnt ) fd_mcache_publish_batch( mcache, depth, batch_meta, batch_cnt );
+
   FD_LOG_NOTICE(( "Cleaning up" ));
 
   while( rx_cnt ) fd_wksp_unmap( fd_fctl_rx_seq_laddr( fctl, --rx_cnt ) );
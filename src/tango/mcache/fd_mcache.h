@@ -381,6 +381,55 @@ fd_mcache_publish_avx( fd_frag_meta_t * mcache,   /* Assumed a current local joi
 
 #endif
 
+/* fd_mcache_publish_batch publishes the cnt frags whose metadata is
+   given by meta[i] for i in [0,cnt) (meta[i].seq is the sequence number
+   to publish the frag at).  It is equivalent to calling
+   fd_mcache_publish( mcache, depth, meta[i].seq, meta[i].sig, ... ) for
+   i in increasing order and is compatible with the same waits.  But
+   instead of fencing around every store of every frag, it does the
+   stores for the whole batch in three passes (invalidate all lines,
+   write the metadata of all lines, then mark all lines as published)
+   with a compiler fence between passes.  This lets the compiler
+   schedule the stores within a pass freely (the metadata is written
+   with vector stores on targets with SSE) and amortizes the fencing
+   over the batch.
+
+   The frags must map to distinct lines (e.g. at most depth consecutive
+   sequence numbers).  No frag of the batch is visible to consumers
+   until the last pass, so batches should be small (e.g. the frags
+   published while handling a burst of input).  This does no error
+   checking.  This operation implies a compiler mfence to the caller. */
+
+static inline void
+fd_mcache_publish_batch( fd_frag_meta_t *       mcache,   /* Assumed a current local join */
+                         ulong                  depth,    /* Assumed an integer power-of-2 >= BLOCK */
+                         fd_frag_meta_t const * meta,     /* Indexed [0,cnt) */
+                         ulong                  cnt ) {
+  FD_COMPILER_MFENCE();
+  for( ulong i=0UL; i<cnt; i++ ) {
+    mcache[ fd_mcache_line_idx( meta[ i ].seq, depth ) ].seq = fd_seq_dec( meta[ i ].seq, 1UL );
+  }
+  FD_COMPILER_MFENCE();
+  for( ulong i=0UL; i<cnt; i++ ) {
+    fd_frag_meta_t * line = mcache + fd_mcache_line_idx( meta[ i ].seq, depth );
+    line->sig  = meta[ i ].sig;
+#   if FD_HAS_SSE
+    line->sse1 = meta[ i ].sse1;
+#   else
+    line->chunk  = meta[ i ].chunk;
+    line->sz     = meta[ i ].sz;
+    line->ctl    = meta[ i ].ctl;
+    line->tsorig = meta[ i ].tsorig;
+    line->tspub  = meta[ i ].tspub;
+#   endif
+  }
+  FD_COMPILER_MFENCE();
+  for( ulong i=0UL; i<cnt; i++ ) {
+    mcache[ fd_mcache_line_idx( meta[ i ].seq, depth ) ].seq = meta[ i ].seq;
+  }
+  FD_COMPILER_MFENCE();
+}
+
 /* FD_MCACHE_WAIT does a bounded wait for a producer to transmit a
    particular frag.
 
@@ -749,6 +798,32 @@ fd_mcache_query( fd_frag_meta_t const * mcache,
   return fd_frag_meta_seq_query( mcache + fd_mcache_line_idx( seq_query, depth ) );
 }
 
+/* fd_mcache_seq_run returns the number of frags starting at seq that
+   are ready to be consumed in order, i.e. the largest run_cnt in
+   [0,max] such that frags seq, seq+1, ... seq+run_cnt-1 were all found
+   published in the mcache.  max is assumed at most depth.  This lets a
+   consumer that found frag seq check the rest of a burst once, instead
+   of polling each sequence number in turn.  As with FD_MCACHE_WAIT, a
+   frag in the run can still be overrun by the time it is read, so the
+   consumer must still check each frag's seq after reading it.  This
+   acts as a compiler memory fence. */
+
+static inline ulong
+fd_mcache_seq_run( fd_frag_meta_t const * mcache,
+                   ulong                  depth,
+                   ulong                  seq,
+                   ulong                  max ) {
+  ulong run_cnt = 0UL;
+  FD_COMPILER_MFENCE();
+  while( run_cnt<max ) {
+    ulong seq_expected = fd_seq_inc( seq, run_cnt );
+    if( mcache[ fd_mcache_line_idx( seq_expected, depth ) ].seq!=seq_expected ) break;
+    run_cnt++;
+  }
+  FD_COMPILER_MFENCE();
+  return run_cnt;
+}
+
 FD_PROTOTYPES_END
 
 #endif /* HEADER_fd_src_tango_mcache_fd_mcache_h */
@@ -190,6 +190,46 @@ main( int     argc,
     fd_mcache_seq_update( _seq, fd_seq_inc( next, 1UL ) );
   }
 
+  /* Test batched publish and seq runs */
+
+  for( ulong iter=0UL; iter<1024UL; iter++ ) {
+    ulong next = fd_mcache_seq_query( _seq );
+    ulong cnt  = 1UL + (ulong)fd_rng_uint_roll( rng, 16U );
+
+    fd_frag_meta_t meta[ 16 ];
+    for( ulong i=0UL; i<cnt; i++ ) {
+      ulong seq = fd_seq_inc( next, i );
+      meta[ i ].seq    = seq;
+      meta[ i ].sig    = seq*3UL;
+      meta[ i ].chunk  = (uint  )(seq+1UL);
+      meta[ i ].sz     = (ushort)(seq+2UL);
+      meta[ i ].ctl    = (ushort)(seq+3UL);
+      meta[ i ].tsorig = (uint  )(seq+4UL);
+      meta[ i ].tspub  = (uint  )(seq+5UL);
+    }
+
+    FD_TEST( !fd_mcache_seq_run( mcache, depth, next, cnt ) );
+    fd_mcache_publish_batch( mcache, depth, meta, cnt );
+    FD_TEST( fd_mcache_seq_run( mcache, depth, next, 16UL    )==cnt     );
+    FD_TEST( fd_mcache_seq_run( mcache, depth, next, cnt-1UL )==cnt-1UL );
+
+    for( ulong i=0UL; i<cnt; i++ ) {
+      ulong                  seq  = fd_seq_inc( next, i );
+      fd_frag_meta_t const * line = mcache + fd_mcache_line_idx( seq, depth );
+      FD_TEST( line->seq   ==seq                 );
+      FD_TEST( line->sig   ==seq*3UL             );
+      FD_TEST( line->chunk ==(uint  )(seq+1UL)   );
+      FD_TEST( line->sz    ==(ushort)(seq+2UL)   );
+      FD_TEST( line->ctl   ==(ushort)(seq+3UL)   );
+      FD_TEST( line->tsorig==(uint  )(seq+4UL)   );
+      FD_TEST( line->tspub ==(uint  )(seq+5UL)   );
+      ulong evict = fd_seq_dec( seq, depth );
+      FD_TEST( fd_seq_lt( evict, fd_mcache_query( mcache, depth, evict ) ) );
+    }
+
+    fd_mcache_seq_update( _seq, fd_seq_inc( next, cnt ) );
+  }
+
   /* Test mcache for corruption */
 
   FD_TEST( fd_mcache_depth          ( mcache )==depth      );
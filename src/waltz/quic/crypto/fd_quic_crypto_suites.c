@@ -128,6 +128,45 @@ fd_quic_gen_keys(
       FD_QUIC_CRYPTO_LABEL_QUIC_IV_LEN );
 }
 
+/* fd_quic_crypto_cache_{gcm,hp} return the expanded packet protection
+   and header protection key schedules for keys, expanding them into
+   the next round robin slot of cache on a miss.  The IV of the returned
+   fd_aes_gcm_t is unspecified, callers set it before use. */
+
+static fd_aes_gcm_t *
+fd_quic_crypto_cache_gcm( fd_quic_crypto_cache_t *      cache,
+                          fd_quic_crypto_keys_t const * keys ) {
+  for( ulong j=0UL; j<FD_QUIC_CRYPTO_CACHE_CNT; j++ ) {
+    if( FD_LIKELY( fd_uint_extract_bit( cache->gcm_valid, (int)j ) &&
+                   0==memcmp( cache->gcm_key[ j ], keys->pkt_key, FD_AES_128_KEY_SZ ) ) ) {
+      return &cache->gcm[ j ];
+    }
+  }
+  ulong j = cache->gcm_next;
+  cache->gcm_next   = (uint)( (j+1UL) % FD_QUIC_CRYPTO_CACHE_CNT );
+  cache->gcm_valid |= 1U<<j;
+  memcpy( cache->gcm_key[ j ], keys->pkt_key, FD_AES_128_KEY_SZ );
+  fd_aes_128_gcm_init( &cache->gcm[ j ], keys->pkt_key, keys->iv );
+  return &cache->gcm[ j ];
+}
+
+static fd_aes_key_t *
+fd_quic_crypto_cache_hp( fd_quic_crypto_cache_t *      cache,
+                         fd_quic_crypto_keys_t const * keys ) {
+  for( ulong j=0UL; j<FD_QUIC_CRYPTO_CACHE_CNT; j++ ) {
+    if( FD_LIKELY( fd_uint_extract_bit( cache->hp_valid, (int)j ) &&
+                   0==memcmp( cache->hp_key[ j ], keys->hp_key, FD_AES_128_KEY_SZ ) ) ) {
+      return &cache->hp[ j ];
+    }
+  }
+  ulong j = cache->hp_next;
+  cache->hp_next   = (uint)( (j+1UL) % FD_QUIC_CRYPTO_CACHE_CNT );
+  cache->hp_valid |= 1U<<j;
+  memcpy( cache->hp_key[ j ], keys->hp_key, FD_AES_128_KEY_SZ );
+  fd_aes_set_encrypt_key( keys->hp_key, 128, &cache->hp[ j ] );
+  return &cache->hp[ j ];
+}
+
 /* encrypt a packet
 
    uses the keys in keys to encrypt the packet "pkt" with header "hdr"
@@ -155,8 +194,10 @@ fd_quic_gen_keys(
      pkt_number_sz     the size of the packet number in bytes
      */
 
-int
-fd_quic_crypto_encrypt(
+static int
+fd_quic_crypto_encrypt_impl(
+    fd_aes_gcm_t *                 const pkt_cipher,
+    fd_aes_key_t *                 const hp_cipher_key,
     uchar *                        const out,
     ulong *                        const out_sz,
     uchar const *                  const hdr,
@@ -164,7 +205,6 @@ fd_quic_crypto_encrypt(
     uchar const *                  const pkt,
     ulong                          const pkt_sz,
     fd_quic_crypto_keys_t const *  const pkt_keys,
-    fd_quic_crypto_keys_t const *  const hp_keys,
     ulong                          const pkt_number ) {
 
 
@@ -201,10 +241,7 @@ fd_quic_crypto_encrypt(
   uchar nonce[FD_QUIC_NONCE_SZ] = {0};
   fd_quic_get_nonce( nonce, pkt_keys->iv, pkt_number );
 
-  // Initial packets cipher uses AEAD_AES_128_GCM with keys derived from the Destination Connection ID field of the
-  // first Initial packet sent by the client; see rfc9001 Section 5.2.
-  fd_aes_gcm_t pkt_cipher[1];
-  fd_aes_128_gcm_init( pkt_cipher, pkt_keys->pkt_key, nonce );
+  fd_aes_gcm_set_iv( pkt_cipher, nonce );
 
   /* cipher_text is start of encrypted packet bytes, which starts after the header */
   uchar * cipher_text = out + hdr_sz;
@@ -221,10 +258,8 @@ fd_quic_crypto_encrypt(
      so shorter packet numbers means sample starts later in the cipher text */
   uchar const * sample = pkt_number_ptr + 4;
 
-  fd_aes_key_t ecb[1];
-  fd_aes_set_encrypt_key( hp_keys->hp_key, 128, ecb );
   uchar hp_cipher[16];
-  fd_aes_encrypt( sample, hp_cipher, ecb );
+  fd_aes_encrypt( sample, hp_cipher, hp_cipher_key );
 
   /* hp_cipher is mask */
   uchar const * mask = hp_cipher;
@@ -242,7 +277,49 @@ fd_quic_crypto_encrypt(
 }
 
 int
-fd_quic_crypto_decrypt(
+fd_quic_crypto_encrypt(
+    uchar *                        const out,
+    ulong *                        const out_sz,
+    uchar const *                  const hdr,
+    ulong                          const hdr_sz,
+    uchar const *                  const pkt,
+    ulong                          const pkt_sz,
+    fd_quic_crypto_keys_t const *  const pkt_keys,
+    fd_quic_crypto_keys_t const *  const hp_keys,
+    ulong                          const pkt_number ) {
+
+  // Initial packets cipher uses AEAD_AES_128_GCM with keys derived from the Destination Connection ID field of the
+  // first Initial packet sent by the client; see rfc9001 Section 5.2.
+  /* The IV is replaced with the packet nonce in the impl */
+  fd_aes_gcm_t pkt_cipher[1];
+  fd_aes_128_gcm_init( pkt_cipher, pkt_keys->pkt_key, pkt_keys->iv );
+
+  fd_aes_key_t ecb[1];
+  fd_aes_set_encrypt_key( hp_keys->hp_key, 128, ecb );
+
+  return fd_quic_crypto_encrypt_impl( pkt_cipher, ecb, out, out_sz, hdr, hdr_sz, pkt, pkt_sz, pkt_keys, pkt_number );
+}
+
+int
+fd_quic_crypto_encrypt_cached(
+    fd_quic_crypto_cache_t *       const cache,
+    uchar *                        const out,
+    ulong *                        const out_sz,
+    uchar const *                  const hdr,
+    ulong                          const hdr_sz,
+    uchar const *                  const pkt,
+    ulong                          const pkt_sz,
+    fd_quic_crypto_keys_t const *  const pkt_keys,
+    fd_quic_crypto_keys_t const *  const hp_keys,
+    ulong                          const pkt_number ) {
+  return fd_quic_crypto_encrypt_impl( fd_quic_crypto_cache_gcm( cache, pkt_keys ),
+                                      fd_quic_crypto_cache_hp ( cache, hp_keys  ),
+                                      out, out_sz, hdr, hdr_sz, pkt, pkt_sz, pkt_keys, pkt_number );
+}
+
+static int
+fd_quic_crypto_decrypt_impl(
+    fd_aes_gcm_t *                pkt_cipher,
     uchar *                       buf,
     ulong                         buf_sz,
     ulong                         pkt_number_off,
@@ -286,8 +363,7 @@ fd_quic_crypto_decrypt(
   uchar * const gcm_tag = buf_end - FD_QUIC_CRYPTO_TAG_SZ;
   ulong   const gcm_sz  = (ulong)( gcm_tag - out );
 
-  fd_aes_gcm_t pkt_cipher[1];
-  fd_aes_128_gcm_init( pkt_cipher, keys->pkt_key, nonce );
+  fd_aes_gcm_set_iv( pkt_cipher, nonce );
 
   int decrypt_ok =
    fd_aes_gcm_decrypt( pkt_cipher,
@@ -303,13 +379,37 @@ fd_quic_crypto_decrypt(
   return FD_QUIC_SUCCESS;
 }
 
+int
+fd_quic_crypto_decrypt(
+    uchar *                       buf,
+    ulong                         buf_sz,
+    ulong                         pkt_number_off,
+    ulong                         pkt_number,
+    fd_quic_crypto_keys_t const * keys ) {
+  fd_aes_gcm_t pkt_cipher[1];
+  fd_aes_128_gcm_init( pkt_cipher, keys->pkt_key, keys->iv );
+  return fd_quic_crypto_decrypt_impl( pkt_cipher, buf, buf_sz, pkt_number_off, pkt_number, keys );
+}
 
 int
-fd_quic_crypto_decrypt_hdr(
+fd_quic_crypto_decrypt_cached(
+    fd_quic_crypto_cache_t *      cache,
+    uchar *                       buf,
+    ulong                         buf_sz,
+    ulong                         pkt_number_off,
+    ulong                         pkt_number,
+    fd_quic_crypto_keys_t const * keys ) {
+  return fd_quic_crypto_decrypt_impl( fd_quic_crypto_cache_gcm( cache, keys ),
+                                      buf, buf_sz, pkt_number_off, pkt_number, keys );
+}
+
+
+static int
+fd_quic_crypto_decrypt_hdr_impl(
+    fd_aes_key_t *                 hp_cipher_key,
     uchar *                        buf,
     ulong                          buf_sz,
-    ulong                          pkt_number_off,
-    fd_quic_crypto_keys_t const *  keys ) {
+    ulong                          pkt_number_off ) {
 
   /* bounds checks */
   if( FD_UNLIKELY( ( buf_sz < FD_QUIC_CRYPTO_TAG_SZ ) |
@@ -331,9 +431,7 @@ fd_quic_crypto_decrypt_hdr(
 
   /* TODO this is hardcoded to AES-128 */
   uchar hp_cipher[16];
-  fd_aes_key_t ecb[1];
-  fd_aes_set_encrypt_key( keys->hp_key, 128, ecb );
-  fd_aes_encrypt( sample, hp_cipher, ecb );
+  fd_aes_encrypt( sample, hp_cipher, hp_cipher_key );
 
   /* hp_cipher is mask */
   uchar const * mask = hp_cipher;
@@ -356,3 +454,24 @@ fd_quic_crypto_decrypt_hdr(
 
   return FD_QUIC_SUCCESS;
 }
+
+int
+fd_quic_crypto_decrypt_hdr(
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    fd_quic_crypto_keys_t const *  keys ) {
+  fd_aes_key_t ecb[1];
+  fd_aes_set_encrypt_key( keys->hp_key, 128, ecb );
+  return fd_quic_crypto_decrypt_hdr_impl( ecb, buf, buf_sz, pkt_number_off );
+}
+
+int
+fd_quic_crypto_decrypt_hdr_cached(
+    fd_quic_crypto_cache_t *       cache,
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    fd_quic_crypto_keys_t const *  keys ) {
+  return fd_quic_crypto_decrypt_hdr_impl( fd_quic_crypto_cache_hp( cache, keys ), buf, buf_sz, pkt_number_off );
+}
@@ -2,6 +2,7 @@
 #define HEADER_fd_src_waltz_quic_crypto_fd_quic_crypto_suites_h
 
 #include "../fd_quic_enum.h"
+#include "../../../ballet/aes/fd_aes_base.h"
 #include "../../../ballet/aes/fd_aes_gcm.h"
 
 /* Defines the crypto suites used by QUIC v1.
@@ -30,6 +31,7 @@
 
 typedef struct fd_quic_crypto_keys    fd_quic_crypto_keys_t;
 typedef struct fd_quic_crypto_secrets fd_quic_crypto_secrets_t;
+typedef struct fd_quic_crypto_cache   fd_quic_crypto_cache_t;
 
 #define FD_QUIC_CRYPTO_TAG_SZ    16
 #define FD_QUIC_CRYPTO_SAMPLE_SZ 16
@@ -42,6 +44,33 @@ struct fd_quic_crypto_keys {
   uchar hp_key [FD_AES_128_KEY_SZ];
 };
 
+/* fd_quic_crypto_cache_t holds expanded AES key schedules for recently
+   used packet protection and header protection keys.
+
+   Expanding an AES-128-GCM key (round keys and GHASH key powers) costs
+   about as much as protecting a small packet.  Packets arriving in one
+   burst from the network or leaving in one service pass mostly belong
+   to a handful of connections, so the packets of a burst share keys.
+   The cache lets consecutive packets skip the key expansion and only
+   set the per-packet nonce.
+
+   Entries are looked up by the raw key bytes and replaced round robin.
+   A zero initialized cache is empty.  A cache may only be used by one
+   thread at a time. */
+
+#define FD_QUIC_CRYPTO_CACHE_CNT (4UL)
+
+struct __attribute__((aligned(FD_AES_GCM_ALIGN))) fd_quic_crypto_cache {
+  fd_aes_gcm_t gcm    [ FD_QUIC_CRYPTO_CACHE_CNT ];
+  fd_aes_key_t hp     [ FD_QUIC_CRYPTO_CACHE_CNT ];
+  uchar        gcm_key[ FD_QUIC_CRYPTO_CACHE_CNT ][ FD_AES_128_KEY_SZ ];
+  uchar        hp_key [ FD_QUIC_CRYPTO_CACHE_CNT ][ FD_AES_128_KEY_SZ ];
+  uint         gcm_valid; /* bit i set if gcm[i] is initialized */
+  uint         hp_valid;  /* bit i set if hp [i] is initialized */
+  uint         gcm_next;  /* next gcm entry to replace */
+  uint         hp_next;   /* next hp  entry to replace */
+};
+
 /* define enums for encryption levels */
 #define fd_quic_enc_level_initial_id    0
 #define fd_quic_enc_level_early_data_id 1
@@ -235,6 +264,41 @@ fd_quic_crypto_decrypt_hdr(
     ulong                          pkt_number_off,
     fd_quic_crypto_keys_t const *  keys );
 
+/* fd_quic_crypto_{encrypt,decrypt,decrypt_hdr}_cached behave like
+   their uncached counterparts above but take the expanded key schedules
+   from cache, expanding and inserting them on a miss.  cache must be a
+   valid local join. */
+
+int
+fd_quic_crypto_encrypt_cached(
+    fd_quic_crypto_cache_t *       const cache,
+    uchar *                        const out,
+    ulong *                        const out_sz,
+    uchar const *                  const hdr,
+    ulong                          const hdr_sz,
+    uchar const *                  const pkt,
+    ulong                          const pkt_sz,
+    fd_quic_crypto_keys_t const *  const pkt_keys,
+    fd_quic_crypto_keys_t const *  const hp_keys,
+    ulong                          const pkt_number );
+
+int
+fd_quic_crypto_decrypt_cached(
+    fd_quic_crypto_cache_t *       cache,
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    ulong                          pkt_number,
+    fd_quic_crypto_keys_t const *  keys );
+
+int
+fd_quic_crypto_decrypt_hdr_cached(
+    fd_quic_crypto_cache_t *       cache,
+    uchar *                        buf,
+    ulong                          buf_sz,
+    ulong                          pkt_number_off,
+    fd_quic_crypto_keys_t const *  keys );
+
 /* nonce is quic-iv XORed with 62-bits of byte-order packet-number */
 static inline void
 fd_quic_get_nonce(
@@ -402,6 +402,14 @@ fd_quic_init( fd_quic_t * quic ) {
   if( FD_UNLIKELY( !config->retry_ttl     ) ) { FD_LOG_WARNING(( "zero cfg.retry_ttl"    )); return NULL; }
   if( FD_UNLIKELY( !quic->cb.now          ) ) { FD_LOG_WARNING(( "NULL cb.now"           )); return NULL; }
   if( FD_UNLIKELY( config->tick_per_us==0 ) ) { FD_LOG_WARNING(( "zero cfg.tick_per_us"  )); return NULL; }
+  if( FD_UNLIKELY( config->shard_cnt>FD_QUIC_CONN_ID_SHARD_MAX ) ) {
+    FD_LOG_WARNING(( "cfg.shard_cnt %lu exceeds max %lu", config->shard_cnt, FD_QUIC_CONN_ID_SHARD_MAX ));
+    return NULL;
+  }
+  if( FD_UNLIKELY( config->shard_cnt>1UL && config->shard_idx>=config->shard_cnt ) ) {
+    FD_LOG_WARNING(( "cfg.shard_idx %lu out of bounds (shard_cnt %lu)", config->shard_idx, config->shard_cnt ));
+    return NULL;
+  }
 
   do {
     ulong x = 0U;
@@ -1545,12 +1553,12 @@ fd_quic_handle_v1_initial( fd_quic_t *               quic,
         - No retry token, retry request:  generate new random ID
         - Retry token, accepted:          reuse SCID from retry token */
     if( !quic->config.retry ) {
-      scid = fd_rng_ulong( state->_rng );
+      scid = fd_quic_conn_id_gen( quic, state->_rng );
     } else { /* retry configured */
 
       /* Need to send retry? Do so before more work */
       if( initial->token_len == 0 ) {
-        ulong new_conn_id_u64 = fd_rng_ulong( state->_rng );
+        ulong new_conn_id_u64 = fd_quic_conn_id_gen( quic, state->_rng );
         if( FD_UNLIKELY( fd_quic_send_retry(
               quic, pkt,
               dcid, peer_scid, new_conn_id_u64 ) ) ) {
@@ -1611,9 +1619,10 @@ fd_quic_handle_v1_initial( fd_quic_t *               quic,
 # if !FD_QUIC_DISABLE_CRYPTO
   /* this decrypts the header */
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt_hdr( cur_ptr, cur_sz,
-                                    pn_offset,
-                                    rx_keys ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_decrypt_hdr_cached( &state->crypto_cache,
+                                           cur_ptr, cur_sz,
+                                           pn_offset,
+                                           rx_keys ) != FD_QUIC_SUCCESS ) ) {
     /* As this is an INITIAL packet, change the status to DEAD, and allow
         it to be reaped */
     FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_crypto_decrypt_hdr failed" )) );
@@ -1633,10 +1642,11 @@ fd_quic_handle_v1_initial( fd_quic_t *               quic,
       It is permitted for some packet numbers to never be used, leaving intentional gaps. */
   /* this decrypts the header and payload */
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt( cur_ptr, tot_sz,
-                                pn_offset,
-                                pkt_number,
-                                rx_keys ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_decrypt_cached( &state->crypto_cache,
+                                       cur_ptr, tot_sz,
+                                       pn_offset,
+                                       pkt_number,
+                                       rx_keys ) != FD_QUIC_SUCCESS ) ) {
     FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_crypto_decrypt failed" )) );
     FD_DTRACE_PROBE_2( quic_err_decrypt_initial_pkt, pkt->ip4, pkt->pkt_number );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_initial_id ]++;
@@ -1911,11 +1921,13 @@ fd_quic_handle_v1_handshake(
                                                /* length of payload + num packet bytes */
 
 # if !FD_QUIC_DISABLE_CRYPTO
+  fd_quic_crypto_cache_t * crypto_cache = &fd_quic_get_state( quic )->crypto_cache;
   /* this decrypts the header */
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt_hdr( cur_ptr, cur_sz,
-                                    pn_offset,
-                                    &conn->keys[2][0] ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_decrypt_hdr_cached( crypto_cache,
+                                           cur_ptr, cur_sz,
+                                           pn_offset,
+                                           &conn->keys[2][0] ) != FD_QUIC_SUCCESS ) ) {
     FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_crypto_decrypt_hdr failed" )) );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_handshake_id ]++;
     return FD_QUIC_PARSE_FAIL;
@@ -1938,10 +1950,11 @@ fd_quic_handle_v1_handshake(
 # if !FD_QUIC_DISABLE_CRYPTO
   /* this decrypts the header and payload */
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt( cur_ptr, tot_sz,
-                                pn_offset,
-                                pkt_number,
-                                &conn->keys[2][0] ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_decrypt_cached( crypto_cache,
+                                       cur_ptr, tot_sz,
+                                       pn_offset,
+                                       pkt_number,
+                                       &conn->keys[2][0] ) != FD_QUIC_SUCCESS ) ) {
     /* remove connection from map, and insert into free list */
     FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_crypto_decrypt failed" )) );
     FD_DTRACE_PROBE_3( quic_err_decrypt_handshake_pkt, pkt->ip4, conn->our_conn_id, pkt->pkt_number );
@@ -2166,10 +2179,12 @@ fd_quic_handle_v1_one_rtt( fd_quic_t *      quic,
   pkt->enc_level = fd_quic_enc_level_appdata_id;
 
 # if !FD_QUIC_DISABLE_CRYPTO
+  fd_quic_crypto_cache_t * crypto_cache = &fd_quic_get_state( quic )->crypto_cache;
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt_hdr( cur_ptr, tot_sz,
-                                    pn_offset,
-                                    &conn->keys[3][0] ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_decrypt_hdr_cached( crypto_cache,
+                                           cur_ptr, tot_sz,
+                                           pn_offset,
+                                           &conn->keys[3][0] ) != FD_QUIC_SUCCESS ) ) {
     FD_DEBUG( FD_LOG_DEBUG(( "fd_quic_crypto_decrypt_hdr failed" )) );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]++;
     return FD_QUIC_PARSE_FAIL;
@@ -2196,10 +2211,11 @@ fd_quic_handle_v1_one_rtt( fd_quic_t *      quic,
 
   /* this decrypts the header and payload */
   if( FD_UNLIKELY(
-        fd_quic_crypto_decrypt( cur_ptr, tot_sz,
-                                pn_offset,
-                                pkt_number,
-                                keys ) != FD_QUIC_SUCCESS ) ) {
+        fd_quic_crypto_decrypt_cached( crypto_cache,
+                                       cur_ptr, tot_sz,
+                                       pn_offset,
+                                       pkt_number,
+                                       keys ) != FD_QUIC_SUCCESS ) ) {
     /* remove connection from map, and insert into free list */
     FD_DTRACE_PROBE_3( quic_err_decrypt_1rtt_pkt, pkt->ip4, conn->our_conn_id, pkt->pkt_number );
     quic->metrics.pkt_decrypt_fail_cnt[ fd_quic_enc_level_appdata_id ]++;
@@ -3922,7 +3938,7 @@ fd_quic_conn_tx( fd_quic_t      * quic,
     fd_quic_crypto_keys_t * hp_keys  = &conn->keys[enc_level][1];
     fd_quic_crypto_keys_t * pkt_keys = key_phase_upd ? &conn->new_keys[1] : &conn->keys[enc_level][1];
 
-    if( FD_UNLIKELY( fd_quic_crypto_encrypt( conn->tx_ptr, &cipher_text_sz, hdr_ptr, hdr_sz,
+    if( FD_UNLIKELY( fd_quic_crypto_encrypt_cached( &state->crypto_cache, conn->tx_ptr, &cipher_text_sz, hdr_ptr, hdr_sz,
           frame_start, frames_sz, pkt_keys, hp_keys, pkt_number ) != FD_QUIC_SUCCESS ) ) {
       FD_LOG_WARNING(( "fd_quic_crypto_encrypt failed" ));
 
@@ -4196,7 +4212,7 @@ fd_quic_connect( fd_quic_t *  quic,
 
   /* create conn ids for us and them
      client creates connection id for the peer, peer immediately replaces it */
-  ulong our_conn_id_u64 = fd_rng_ulong( rng );
+  ulong our_conn_id_u64 = fd_quic_conn_id_gen( quic, rng );
   fd_quic_conn_id_t peer_conn_id;  fd_quic_conn_id_rand( &peer_conn_id, rng );
 
   fd_quic_conn_t * conn = fd_quic_conn_create(
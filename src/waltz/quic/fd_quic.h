@@ -171,7 +171,9 @@ struct __attribute__((aligned(16UL))) fd_quic_config {
   X( sign_ctx,                    "%p",     ptr,   "",             __VA_ARGS__ ) \
   X( keylog_file,                 "%s",     value, "",             __VA_ARGS__ ) \
   X( initial_rx_max_stream_data,  "%lu",    units, "bytes",        __VA_ARGS__ ) \
-  X( net.dscp,                    "0x%02x", value, "",             __VA_ARGS__ )
+  X( net.dscp,                    "0x%02x", value, "",             __VA_ARGS__ ) \
+  X( shard_cnt,                   "%lu",    value, "",             __VA_ARGS__ ) \
+  X( shard_idx,                   "%lu",    value, "",             __VA_ARGS__ )
 
   /* Protocol config ***************************************/
 
@@ -236,6 +238,18 @@ struct __attribute__((aligned(16UL))) fd_quic_config {
        Set on all outgoing IPv4 packets. */
     uchar dscp;
   } net;
+
+  /* Sharding config ***************************************/
+
+  /* shard_{cnt,idx}: When a server is split across shard_cnt fd_quic
+     instances, shard_idx in [0,shard_cnt) identifies this instance.
+     Connection IDs chosen by this instance then carry shard_idx, so
+     that packets can be steered to the owner with
+     fd_quic_pkt_dst_shard.  shard_cnt in [0,FD_QUIC_CONN_ID_SHARD_MAX].
+     0 or 1 disables sharding, in which case connection IDs are fully
+     random. */
+  ulong shard_cnt;
+  ulong shard_idx;
 };
 
 /* Callback API *******************************************************/
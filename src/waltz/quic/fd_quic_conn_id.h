@@ -51,7 +51,7 @@ fd_quic_conn_id_rand( fd_quic_conn_id_t * conn_id,
        the endpoint upon receipt. */
   /* this means we can generate a connection id with the property that it can
      be delivered to the same endpoint by flow control */
-  /* TODO load balancing / flow steering */
+  /* See fd_quic_conn_id_shard_set for flow steering */
 
   /* padding must be set to zero also */
   *conn_id = (fd_quic_conn_id_t){ .sz = 8u, .conn_id = {0u}, .pad = {0u} };
@@ -59,6 +59,66 @@ fd_quic_conn_id_rand( fd_quic_conn_id_t * conn_id,
   return conn_id;
 }
 
+/* Connection ID sharding *********************************************
+
+   A QUIC server may be split across multiple fd_quic instances (e.g.
+   one per quic tile) that each own a disjoint set of connections.
+   Steering packets by a hash of the UDP/IP 4-tuple breaks as soon as a
+   peer's address or port changes mid-connection (NAT rebinding,
+   migration).  Instead, each instance encodes its shard index into the
+   connection IDs it chooses for itself, so that the owner of a packet
+   can be derived from its destination connection ID alone.
+
+   Our connection IDs are FD_QUIC_CONN_ID_SZ bytes, handled as ulongs
+   and stored in little endian order.  The shard index is the low byte,
+   i.e. the first connection ID byte on the wire.  The remaining bytes
+   stay random. */
+
+#define FD_QUIC_CONN_ID_SHARD_MAX (256UL)
+
+/* fd_quic_conn_id_shard_set returns conn_id with its shard index
+   replaced by shard_idx.  shard_idx in [0,FD_QUIC_CONN_ID_SHARD_MAX). */
+
+FD_FN_CONST static inline ulong
+fd_quic_conn_id_shard_set( ulong conn_id,
+                           ulong shard_idx ) {
+  return (conn_id & ~0xffUL) | (shard_idx & 0xffUL);
+}
+
+/* fd_quic_conn_id_shard returns the shard index encoded in conn_id. */
+
+FD_FN_CONST static inline ulong
+fd_quic_conn_id_shard( ulong conn_id ) {
+  return conn_id & 0xffUL;
+}
+
+/* fd_quic_pkt_dst_shard returns the shard index encoded in the
+   destination connection ID of the first QUIC packet in the UDP
+   payload [data,data+data_sz).  Returns ULONG_MAX if that packet is not
+   addressed to a connection ID we chose: Initial and 0-RTT packets
+   carry a destination connection ID picked by the client, version
+   negotiation packets are not addressed to a connection, and anything
+   too short to hold a connection ID is malformed.  Such packets must
+   be steered by some other means (e.g. a flow hash).  Only reads the
+   packet header, does not validate the rest of the packet. */
+
+static inline ulong
+fd_quic_pkt_dst_shard( uchar const * data,
+                       ulong         data_sz ) {
+  if( FD_UNLIKELY( data_sz<1UL+FD_QUIC_CONN_ID_SZ ) ) return ULONG_MAX;
+  uint first = data[0];
+
+  /* Short header: first byte, followed by the destination conn ID */
+  if( FD_LIKELY( !(first & 0x80u) ) ) return data[1];
+
+  /* Long header: first byte, version, dst conn ID sz, dst conn ID */
+  if( FD_UNLIKELY( data_sz<6UL+FD_QUIC_CONN_ID_SZ ) ) return ULONG_MAX;
+  uint version  = FD_LOAD( uint, data+1 );
+  uint pkt_type = (first>>4) & 0x3u; /* 0 Initial, 1 0-RTT, 2 Handshake, 3 Retry */
+  if( FD_UNLIKELY( (!version) | (pkt_type<2u) | (data[5]!=FD_QUIC_CONN_ID_SZ) ) ) return ULONG_MAX;
+  return data[6];
+}
+
 FD_PROTOTYPES_END
 
 /* Defines a NULL connection id
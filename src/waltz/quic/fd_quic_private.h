@@ -118,6 +118,9 @@ struct __attribute__((aligned(16UL))) fd_quic_state_private {
 
   /* Scratch space for packet protection */
   uchar                   crypt_scratch[FD_QUIC_MTU];
+
+  /* Expanded AES key schedules of recently used connection keys */
+  fd_quic_crypto_cache_t  crypto_cache;
 };
 
 /* FD_QUIC_STATE_OFF is the offset of fd_quic_state_t within fd_quic_t. */
@@ -182,6 +185,18 @@ fd_quic_conn_query( fd_quic_conn_map_t * map,
   return entry->conn;
 }
 
+/* fd_quic_conn_id_gen returns a new random connection ID for this
+   endpoint.  If the server is sharded (config.shard_cnt>1), the ID
+   carries config.shard_idx (see fd_quic_conn_id_shard_set). */
+
+static inline ulong
+fd_quic_conn_id_gen( fd_quic_t const * quic,
+                     fd_rng_t *        rng ) {
+  ulong conn_id = fd_rng_ulong( rng );
+  if( quic->config.shard_cnt>1UL ) conn_id = fd_quic_conn_id_shard_set( conn_id, quic->config.shard_idx );
+  return conn_id;
+}
+
 /* fd_quic_conn_service is called periodically to perform pending
    operations and time based operations.
 
@@ -140,6 +140,52 @@ test_quic_nonce( void ) {
   FD_TEST( 0==memcmp( nonce, expected_nonce, sizeof( expected_nonce ) ) );
 }
 
+/* tests that the cached crypto paths produce the same packets as the
+   uncached ones, including when keys get evicted from the cache */
+static void
+test_quic_crypto_cached( fd_rng_t * rng ) {
+  static fd_quic_crypto_cache_t cache[1];
+  memset( cache, 0, sizeof(fd_quic_crypto_cache_t) );
+
+# define KEY_CNT (FD_QUIC_CRYPTO_CACHE_CNT+2UL)
+  fd_quic_crypto_keys_t keys[ KEY_CNT ];
+  for( ulong j=0UL; j<KEY_CNT; j++ ) {
+    for( ulong b=0UL; b<sizeof(fd_quic_crypto_keys_t); b++ ) ((uchar *)&keys[ j ])[ b ] = fd_rng_uchar( rng );
+  }
+
+  uchar hdr[ sizeof(packet_header_short_pn) ];
+  fd_memcpy( hdr, packet_header_short_pn, sizeof(hdr) );
+  ulong const hdr_sz    = sizeof(hdr);
+  ulong const pn_offset = 18;
+
+  for( ulong iter=0UL; iter<1024UL; iter++ ) {
+    fd_quic_crypto_keys_t const * pkt_keys = &keys[ fd_rng_ulong_roll( rng, KEY_CNT ) ];
+    fd_quic_crypto_keys_t const * hp_keys  = &keys[ fd_rng_ulong_roll( rng, KEY_CNT ) ];
+    ulong pkt_number = 2UL + (fd_rng_ulong( rng )<<8);
+    ulong pkt_sz     = 32UL + fd_rng_ulong_roll( rng, test_client_initial_sz-32UL );
+
+    uchar ct0[ 4096 ];  ulong ct0_sz = sizeof(ct0);
+    uchar ct1[ 4096 ];  ulong ct1_sz = sizeof(ct1);
+    FD_TEST( fd_quic_crypto_encrypt( ct0, &ct0_sz, hdr, hdr_sz, test_client_initial, pkt_sz,
+                                     pkt_keys, hp_keys, pkt_number )==FD_QUIC_SUCCESS );
+    FD_TEST( fd_quic_crypto_encrypt_cached( cache, ct1, &ct1_sz, hdr, hdr_sz, test_client_initial, pkt_sz,
+                                            pkt_keys, hp_keys, pkt_number )==FD_QUIC_SUCCESS );
+    FD_TEST( ct0_sz==ct1_sz );
+    FD_TEST( 0==memcmp( ct0, ct1, ct0_sz ) );
+
+    FD_TEST( fd_quic_crypto_decrypt_hdr_cached( cache, ct1, ct1_sz, pn_offset, hp_keys )==FD_QUIC_SUCCESS );
+    FD_TEST( 0==memcmp( ct1, hdr, hdr_sz ) );
+    FD_TEST( fd_quic_crypto_decrypt_cached( cache, ct1, ct1_sz, pn_offset, pkt_number, pkt_keys )==FD_QUIC_SUCCESS );
+    FD_TEST( 0==memcmp( ct1+hdr_sz, test_client_initial, pkt_sz ) );
+
+    /* Wrong key must fail authentication */
+    fd_quic_crypto_keys_t const * bad_keys = &keys[ (ulong)( pkt_keys-keys+1L ) % KEY_CNT ];
+    FD_TEST( fd_quic_crypto_decrypt_hdr_cached( cache, ct0, ct0_sz, pn_offset, hp_keys )==FD_QUIC_SUCCESS );
+    FD_TEST( fd_quic_crypto_decrypt_cached( cache, ct0, ct0_sz, pn_offset, pkt_number, bad_keys )==FD_QUIC_FAILED );
+  }
+# undef KEY_CNT
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -387,8 +433,59 @@ main( int     argc,
     FD_LOG_NOTICE(( "~%6.3f Gbps Ethernet equiv throughput / core (sz %4lu)", (double)gbps, out_sz ));
   } while(0);
 
+  static fd_quic_crypto_cache_t cache[1];
+
+  FD_LOG_NOTICE(( "Benchmarking header+payload decrypt (cached keys)" ));
+  for( ulong idx=0U; idx<2UL; idx++ ) {
+    ulong sz = bench_sz[ idx ];
+
+    /* warmup */
+    for( ulong rem=10UL; rem; rem-- ) {
+      fd_quic_crypto_decrypt_hdr_cached( cache, buf2, sz, 0,       &client_keys );
+      fd_quic_crypto_decrypt_cached    ( cache, buf2, sz, 0, 1234, &client_keys );
+    }
+
+    /* for real */
+    ulong iter = 1000000UL;
+    long  dt   = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      fd_quic_crypto_decrypt_hdr_cached( cache, buf2, sz, 0,       &client_keys );
+      fd_quic_crypto_decrypt_cached    ( cache, buf2, sz, 0, 1234, &client_keys );
+    }
+    dt += fd_log_wallclock();
+    float gbps = ((float)(8UL*(70UL+sz)*iter)) / ((float)dt);
+    float mpps = ((float)iter) / ((float)dt) * 1e3f;
+    FD_LOG_NOTICE(( "~%6.3f Gbps Ethernet equiv throughput / core (sz %4lu, %6.3f Mpps)", (double)gbps, sz, (double)mpps ));
+  } while(0);
+
+  FD_LOG_NOTICE(( "Benchmarking header+payload encrypt (cached keys)" ));
+  for( ulong idx=0U; idx<2UL; idx++ ) {
+    ulong const out_sz = bench_sz[ idx ];
+    ulong const hdr_sz = 22UL;
+    ulong const sz     = out_sz - FD_QUIC_CRYPTO_TAG_SZ - hdr_sz;
+
+    /* warmup */
+    for( ulong rem=10UL; rem; rem-- ) {
+      ulong out_sz_ = out_sz;
+      fd_quic_crypto_encrypt_cached( cache, buf2, &out_sz_, hdr, hdr_sz, buf1, sz, &client_keys, &client_keys, 1234 );
+    }
+
+    /* for real */
+    ulong iter = 1000000UL;
+    long  dt   = -fd_log_wallclock();
+    for( ulong rem=iter; rem; rem-- ) {
+      ulong out_sz_ = out_sz;
+      fd_quic_crypto_encrypt_cached( cache, buf2, &out_sz_, hdr, hdr_sz, buf1, sz, &client_keys, &client_keys, 1234 );
+    }
+    dt += fd_log_wallclock();
+    float gbps = ((float)(8UL*(70UL+out_sz)*iter)) / ((float)dt);
+    float mpps = ((float)iter) / ((float)dt) * 1e3f;
+    FD_LOG_NOTICE(( "~%6.3f Gbps Ethernet equiv throughput / core (sz %4lu, %6.3f Mpps)", (double)gbps, out_sz, (double)mpps ));
+  } while(0);
+
   test_quic_short_pn();
   test_quic_nonce();
+  test_quic_crypto_cached( rng );
   fd_rng_delete( fd_rng_leave( rng ) );
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();
@@ -135,6 +135,10 @@ main( int argc, char ** argv ) {
   server_quic->config.initial_rx_max_stream_data = 1<<16;
   client_quic->config.initial_rx_max_stream_data = 1<<16;
 
+  /* Pretend the server is one of several shards */
+  server_quic->config.shard_cnt = 4UL;
+  server_quic->config.shard_idx = 3UL;
+
   FD_LOG_NOTICE(( "Creating virtual pair" ));
   fd_quic_virtual_pair_t vp;
   fd_quic_virtual_pair_init( &vp, server_quic, client_quic );
@@ -165,6 +169,11 @@ main( int argc, char ** argv ) {
 
   FD_TEST( server_complete && client_complete );
 
+  /* The conn IDs the server chose must steer packets back to it */
+  FD_TEST( fd_quic_conn_id_shard( server_conn->our_conn_id )==3UL );
+  FD_TEST( client_conn->peer_cids[0].sz==FD_QUIC_CONN_ID_SZ );
+  FD_TEST( client_conn->peer_cids[0].conn_id[0]==3 );
+
   /* TODO detect missing QUIC transport params */
 
   /* TODO we get callback before the call to fd_quic_conn_new_stream can complete
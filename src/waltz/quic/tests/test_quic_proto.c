@@ -1,5 +1,6 @@
 #include "../../../util/fd_util.h"
 #include "../fd_quic_common.h"
+#include "../fd_quic_conn_id.h"
 #include "../fd_quic_proto.h"
 #include "../fd_quic_proto.c"
 #include "../templ/fd_quic_parse_util.h"
@@ -375,6 +376,45 @@ test_path_response( void ) {
   FD_TEST( frame->data==0x0102030405060708UL );
 }
 
+void
+test_conn_id_shard( void ) {
+  FD_TEST( fd_quic_conn_id_shard( fd_quic_conn_id_shard_set( 0x0123456789abcdefUL,  0UL ) )== 0UL );
+  FD_TEST( fd_quic_conn_id_shard( fd_quic_conn_id_shard_set( 0x0123456789abcdefUL, 42UL ) )==42UL );
+  FD_TEST( fd_quic_conn_id_shard_set( 0x0123456789abcdefUL, 42UL )==0x0123456789abcd2aUL );
+
+  ulong conn_id = fd_quic_conn_id_shard_set( 0x0123456789abcdefUL, 7UL );
+  uchar pkt[ 64 ] = {0};
+
+  /* Short header: DCID follows the first byte */
+  pkt[0] = 0x41;
+  FD_STORE( ulong, pkt+1, conn_id );
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, sizeof(pkt) )==7UL );
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, 1UL+FD_QUIC_CONN_ID_SZ )==7UL );
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, FD_QUIC_CONN_ID_SZ     )==ULONG_MAX );
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, 0UL                    )==ULONG_MAX );
+
+  /* Long header: version and DCID length precede the DCID */
+  memset( pkt, 0, sizeof(pkt) );
+  FD_STORE( uint, pkt+1, fd_uint_bswap( 1U ) ); /* QUIC v1 */
+  pkt[5] = FD_QUIC_CONN_ID_SZ;
+  FD_STORE( ulong, pkt+6, conn_id );
+  pkt[0] = 0xe0; /* Handshake */
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, sizeof(pkt) )==7UL );
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, 5UL+FD_QUIC_CONN_ID_SZ )==ULONG_MAX );
+  pkt[0] = 0xf0; /* Retry */
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, sizeof(pkt) )==7UL );
+  pkt[0] = 0xc0; /* Initial: DCID chosen by the client */
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, sizeof(pkt) )==ULONG_MAX );
+  pkt[0] = 0xd0; /* 0-RTT: DCID chosen by the client */
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, sizeof(pkt) )==ULONG_MAX );
+  pkt[0] = 0xe0;
+  pkt[5] = 20;   /* DCID of a different size was not chosen by us */
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, sizeof(pkt) )==ULONG_MAX );
+  pkt[5] = FD_QUIC_CONN_ID_SZ;
+  FD_STORE( uint, pkt+1, 0U ); /* version negotiation */
+  FD_TEST( fd_quic_pkt_dst_shard( pkt, sizeof(pkt) )==ULONG_MAX );
+}
+
 int
 main( int     argc,
       char ** argv ) {
@@ -387,6 +427,7 @@ main( int     argc,
   test_crypto_frame();
   test_stream_encode();
   test_path_response();
+  test_conn_id_shard();
 
   FD_LOG_NOTICE(( "pass" ));
   fd_halt();